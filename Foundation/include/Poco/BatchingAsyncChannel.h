@@ -0,0 +1,264 @@
+//
+// BatchingAsyncChannel.h
+//
+// Library: Foundation
+// Package: Logging
+// Module:  BatchingAsyncChannel
+//
+// Definition of the BatchingAsyncChannel class.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_BatchingAsyncChannel_INCLUDED
+#define Foundation_BatchingAsyncChannel_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Channel.h"
+#include "Poco/Message.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
+#include "Poco/Event.h"
+#include "Poco/Runnable.h"
+#include "Poco/AutoPtr.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+
+
+namespace Poco {
+
+
+class Foundation_API BatchingAsyncChannel: public Channel, public Runnable
+	/// A channel that uses a separate thread for logging, like
+	/// AsyncChannel, but is designed for very high message rates.
+	///
+	/// Messages are copied into the preallocated slots of a bounded
+	/// ring buffer, which any number of threads can log to without
+	/// taking a lock. Since the slots are reused, logging a message
+	/// does not allocate memory once the slots' strings have grown
+	/// to the size of the messages.
+	///
+	/// The background thread passes the queued messages to the target
+	/// channel in batches, using Channel::logBatch(). FormattingChannel
+	/// and SplitterChannel pass batches on, and FileChannel writes
+	/// a batch to its log file with a single write operation.
+	///
+	/// If the ring buffer is full, the overflow policy determines
+	/// what happens to a new message:
+	///   * block:  the logging thread waits until a slot is free
+	///             (the default). Messages logged by the background
+	///             thread itself (e.g., by the target channel) are
+	///             dropped instead, to prevent a deadlock.
+	///   * drop:   the message is dropped.
+	///   * sample: the message is dropped. In addition, once the
+	///             ring buffer is three quarters full, only one of
+	///             every sampleRate messages is queued, so that a
+	///             burst leaves a sample of its messages in the log,
+	///             rather than only its first messages.
+	///
+	/// The number of dropped messages is reported to the target
+	/// channel with a warning message after the next batch.
+{
+public:
+	typedef AutoPtr<BatchingAsyncChannel> Ptr;
+
+	enum OverflowPolicy
+	{
+		OVERFLOW_BLOCK,  /// Wait for a free slot.
+		OVERFLOW_DROP,   /// Drop the message.
+		OVERFLOW_SAMPLE  /// Sample messages when nearly full, drop when full.
+	};
+
+	enum
+	{
+		DEFAULT_CAPACITY    = 8192,
+		DEFAULT_BATCH_SIZE  = 512,
+		DEFAULT_SAMPLE_RATE = 10
+	};
+
+	BatchingAsyncChannel(Channel::Ptr pChannel = 0, Thread::Priority prio = Thread::PRIO_NORMAL);
+		/// Creates the BatchingAsyncChannel and connects it to
+		/// the given channel.
+
+	void setChannel(Channel::Ptr pChannel);
+		/// Connects the BatchingAsyncChannel to the given target channel.
+		/// All messages will be forwarded to this channel.
+
+	Channel::Ptr getChannel() const;
+		/// Returns the target channel.
+
+	void open();
+		/// Opens the channel, allocates the ring buffer
+		/// and creates the background logging thread.
+
+	void close();
+		/// Closes the channel, after passing all queued messages
+		/// to the target channel, and stops the background
+		/// logging thread.
+
+	void log(const Message& msg);
+		/// Queues the message for processing by the
+		/// background thread.
+
+	void setCapacity(std::size_t capacity);
+		/// Sets the number of slots in the ring buffer, which is
+		/// rounded up to the next power of two. The default is
+		/// DEFAULT_CAPACITY.
+		///
+		/// Throws an IllegalStateException if the channel is open.
+
+	std::size_t getCapacity() const;
+		/// Returns the number of slots in the ring buffer.
+
+	void setOverflowPolicy(OverflowPolicy policy);
+		/// Sets the overflow policy.
+
+	OverflowPolicy getOverflowPolicy() const;
+		/// Returns the overflow policy.
+
+	void setSampleRate(int rate);
+		/// Sets the sample rate for OVERFLOW_SAMPLE. The default
+		/// is DEFAULT_SAMPLE_RATE.
+
+	int getSampleRate() const;
+		/// Returns the sample rate.
+
+	void setBatchSize(std::size_t size);
+		/// Sets the maximum number of messages passed to the
+		/// target channel at once. The default is DEFAULT_BATCH_SIZE.
+
+	std::size_t getBatchSize() const;
+		/// Returns the maximum number of messages passed to the
+		/// target channel at once.
+
+	Poco::UInt64 droppedMessages() const;
+		/// Returns the number of messages that have been dropped
+		/// since the channel was created.
+
+	void setProperty(const std::string& name, const std::string& value);
+		/// Sets or changes a configuration property.
+		///
+		/// The "channel" property allows setting the target
+		/// channel via the LoggingRegistry.
+		/// The "channel" property is set-only.
+		///
+		/// The "priority" property allows setting the thread
+		/// priority. The following values are supported:
+		///    * lowest
+		///    * low
+		///    * normal (default)
+		///    * high
+		///    * highest
+		///
+		/// The "priority" property is set-only.
+		///
+		/// The "capacity" property sets the number of slots
+		/// in the ring buffer (see setCapacity()).
+		///
+		/// The "overflow" property sets the overflow policy:
+		///    * block (default)
+		///    * drop
+		///    * sample
+		///
+		/// The "sampleRate" property sets the sample rate
+		/// for the sample overflow policy.
+		///
+		/// The "batchSize" property sets the maximum number of
+		/// messages passed to the target channel at once.
+
+	std::string getProperty(const std::string& name) const;
+		/// Returns the value of the given property, except
+		/// for the set-only properties.
+
+	static const std::string PROP_CAPACITY;
+	static const std::string PROP_OVERFLOW;
+	static const std::string PROP_SAMPLERATE;
+	static const std::string PROP_BATCHSIZE;
+
+protected:
+	~BatchingAsyncChannel();
+	void run();
+	void setPriority(const std::string& value);
+
+private:
+	enum
+	{
+		CACHE_LINE_SIZE = 64
+	};
+
+	void allocate();
+	bool claim(std::size_t& pos);
+	void waitForSpace();
+	std::size_t deliver();
+	void reportDropped();
+
+	Channel::Ptr                 _pChannel;
+	Thread                       _thread;
+	FastMutex                    _threadMutex;
+	FastMutex                    _channelMutex;
+	std::size_t                  _capacity;
+	std::size_t                  _mask;
+	std::size_t                  _batchSize;
+	OverflowPolicy               _policy;
+	int                          _sampleRate;
+	std::vector<Message>         _messages;
+	std::unique_ptr<std::atomic<std::size_t>[]> _sequences;
+	std::atomic<bool>            _running;
+	std::atomic<bool>            _stop;
+	Event                        _messagesAvailable;
+	Event                        _spaceAvailable;
+	std::atomic<bool>            _consumerWaiting;
+	std::atomic<int>             _producersWaiting;
+	std::atomic<Poco::UInt32>    _sampleCounter;
+	std::atomic<Poco::UInt64>    _dropped;
+	Poco::UInt64                 _droppedReported;
+	char                         _pad1[CACHE_LINE_SIZE];
+	std::atomic<std::size_t>     _enqueuePos;
+	char                         _pad2[CACHE_LINE_SIZE];
+	std::atomic<std::size_t>     _dequeuePos;
+};
+
+
+//
+// inlines
+//
+inline std::size_t BatchingAsyncChannel::getCapacity() const
+{
+	return _capacity;
+}
+
+
+inline BatchingAsyncChannel::OverflowPolicy BatchingAsyncChannel::getOverflowPolicy() const
+{
+	return _policy;
+}
+
+
+inline int BatchingAsyncChannel::getSampleRate() const
+{
+	return _sampleRate;
+}
+
+
+inline std::size_t BatchingAsyncChannel::getBatchSize() const
+{
+	return _batchSize;
+}
+
+
+inline Poco::UInt64 BatchingAsyncChannel::droppedMessages() const
+{
+	return _dropped.load(std::memory_order_relaxed);
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_BatchingAsyncChannel_INCLUDED
@@ -23,6 +23,7 @@
 #include "Poco/Mutex.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/AutoPtr.h"
+#include <cstddef>
 
 
 namespace Poco {
@@ -59,6 +60,15 @@ public:
 		///
 		/// If the channel has not been opened yet, the log()
 		/// method will open it.
+
+	virtual void logBatch(const Message* pMessages, std::size_t count);
+		/// Logs the given messages, in order, to the channel.
+		///
+		/// Used by BatchingAsyncChannel to deliver many messages
+		/// at once. Channels that can write a batch more efficiently
+		/// than message by message (e.g., FileChannel, with a single
+		/// write) override this method. The default implementation
+		/// calls log() for every message.
 		
 	void setProperty(const std::string& name, const std::string& value);
 		/// Throws a PropertyNotSupportedException.
@@ -0,0 +1,139 @@
+//
+// CompiledPatternFormatter.h
+//
+// Library: Foundation
+// Package: Logging
+// Module:  CompiledPatternFormatter
+//
+// Definition of the CompiledPatternFormatter class.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_CompiledPatternFormatter_INCLUDED
+#define Foundation_CompiledPatternFormatter_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/PatternFormatter.h"
+#include "Poco/DateTime.h"
+#include "Poco/Timestamp.h"
+#include <vector>
+
+
+namespace Poco {
+
+
+class Foundation_API CompiledPatternFormatter: public PatternFormatter
+	/// A PatternFormatter for high message rates.
+	///
+	/// CompiledPatternFormatter supports the same format patterns and
+	/// properties as PatternFormatter, and produces the same output.
+	/// However, when the pattern is set, it is compiled into a flat
+	/// list of rendering steps:
+	///
+	///   * Adjacent literal text is merged into a single step.
+	///   * The node name (%N) is looked up once and becomes literal text.
+	///   * Date/time specifiers with a resolution of one second (everything
+	///     except %i, %c and %F), together with the literal text between
+	///     them, are combined into a time block.
+	///
+	/// Time blocks are rendered at most once per second in every thread.
+	/// Each thread keeps the rendered time blocks of the current second
+	/// in a small cache, so most messages are formatted without any
+	/// date/time calculation, time zone lookup or number conversion
+	/// for the date and time.
+	///
+	/// As a consequence, the local time zone is also only determined
+	/// once per second.
+{
+public:
+	typedef AutoPtr<CompiledPatternFormatter> Ptr;
+
+	CompiledPatternFormatter();
+		/// Creates a CompiledPatternFormatter.
+		/// The format pattern must be specified with
+		/// a call to setProperty.
+
+	CompiledPatternFormatter(const std::string& format);
+		/// Creates a CompiledPatternFormatter that uses the
+		/// given format pattern.
+
+	~CompiledPatternFormatter();
+		/// Destroys the CompiledPatternFormatter.
+
+	void format(const Message& msg, std::string& text);
+		/// Formats the message according to the specified
+		/// format pattern and appends the result to text.
+
+	void setProperty(const std::string& name, const std::string& value);
+		/// Sets the property with the given name to the given value.
+		///
+		/// See PatternFormatter::setProperty() for the supported
+		/// properties.
+
+private:
+	enum StepType
+	{
+		STEP_LITERAL,
+		STEP_TIME,
+		STEP_SOURCE,
+		STEP_SOURCE_WIDTH,
+		STEP_TEXT,
+		STEP_PRIORITY_LEVEL,
+		STEP_PRIORITY_NAME,
+		STEP_PRIORITY_ABBREV,
+		STEP_PID,
+		STEP_TID,
+		STEP_OS_TID,
+		STEP_THREAD,
+		STEP_SOURCE_FILE,
+		STEP_SOURCE_LINE,
+		STEP_MILLISECOND,
+		STEP_CENTISECOND,
+		STEP_MICROSECOND,
+		STEP_PARAMETER
+	};
+
+	struct TimeField
+		/// A date/time specifier, or literal text if key is 0.
+	{
+		char key;
+		bool localTime;
+		std::string text;
+	};
+
+	struct Step
+	{
+		StepType type;
+		std::string text;
+		std::size_t index;
+	};
+
+	CompiledPatternFormatter(const CompiledPatternFormatter&);
+	CompiledPatternFormatter& operator = (const CompiledPatternFormatter&);
+
+	void compile();
+	void appendLiteral(const std::string& text);
+	void appendTimeField(char key, bool localTime);
+	void appendStep(StepType type, const std::string& text = std::string(), std::size_t index = 0);
+	void renderTimeBlock(std::size_t block, Timestamp::TimeVal second, std::string& text) const;
+	static bool isTimeKey(char key);
+	static void appendTime(char key, const DateTime& dateTime, int tzd, Timestamp::TimeVal second, std::string& text);
+
+	std::vector<Step> _steps;
+	std::vector<std::vector<TimeField>> _timeBlocks;
+	std::string _priorityNames[9];
+	std::size_t _literalSize;
+	Poco::UInt64 _id;
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_CompiledPatternFormatter_INCLUDED
@@ -0,0 +1,242 @@
+//
+// DeferredFormat.h
+//
+// Library: Foundation
+// Package: Logging
+// Module:  DeferredFormat
+//
+// Definition of the DeferredFormat class.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_DeferredFormat_INCLUDED
+#define Foundation_DeferredFormat_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Format.h"
+#include "Poco/Any.h"
+#include <string>
+#include <vector>
+#include <cstring>
+
+
+namespace Poco {
+
+
+class Foundation_API DeferredFormat
+	/// DeferredFormat captures a format string and the arguments
+	/// for Poco::format(), so that the formatting can be done later,
+	/// e.g., only when a log message is actually written to
+	/// a log file, possibly by another thread.
+	///
+	/// The arguments are copied into a fixed-size buffer inside the
+	/// DeferredFormat object, so capturing them does not allocate
+	/// memory. Supported argument types are bool, the character,
+	/// integer and floating-point types (except long double),
+	/// std::string and C strings. C strings are copied and passed
+	/// to format() as std::string, so they can be formatted with %s.
+	///
+	/// capture() fails if an argument has an unsupported type,
+	/// or if there are more than MAX_ARGUMENTS arguments or the
+	/// arguments do not fit into the buffer. In this case, the
+	/// caller must format the text immediately.
+	///
+	/// The format string is not copied. It must be a static string,
+	/// such as a string literal, with a lifetime that's at least the
+	/// lifetime of the DeferredFormat object and all its copies.
+{
+public:
+	enum
+	{
+		BUFFER_SIZE   = 96,
+		MAX_ARGUMENTS = 8
+	};
+
+	DeferredFormat();
+		/// Creates an empty DeferredFormat.
+
+	DeferredFormat(const DeferredFormat& other);
+		/// Creates a DeferredFormat by copying another one.
+
+	~DeferredFormat();
+		/// Destroys the DeferredFormat.
+
+	DeferredFormat& operator = (const DeferredFormat& other);
+		/// Assignment operator.
+
+	template <typename... Args>
+	bool capture(const char* fmt, const Args&... args)
+		/// Captures the given format string and arguments.
+		///
+		/// Returns true if successful, otherwise false,
+		/// in which case the DeferredFormat is empty.
+	{
+		clear();
+		if (!captureArguments(args...))
+		{
+			clear();
+			return false;
+		}
+		_pFormat = fmt;
+		return true;
+	}
+
+	bool empty() const;
+		/// Returns true if no format string has been captured.
+
+	void clear();
+		/// Discards the format string and the arguments.
+
+	void format(std::string& result) const;
+		/// Formats the captured arguments according to the
+		/// captured format string, using Poco::format(), and
+		/// appends the result to the given string.
+
+	template <typename... Args>
+	static void formatNow(std::string& result, const char* fmt, const Args&... args)
+		/// Formats the given arguments according to the given
+		/// format string and appends the result to the given string,
+		/// converting the arguments in the same way as capture()
+		/// followed by format().
+		///
+		/// Can be used if the arguments cannot be captured.
+	{
+		std::vector<Any> values;
+		values.reserve(sizeof...(Args));
+		appendValues(values, args...);
+		Poco::format(result, fmt, values);
+	}
+
+private:
+	enum ArgumentType
+	{
+		ARG_BOOL,
+		ARG_CHAR,
+		ARG_SIGNED_CHAR,
+		ARG_UNSIGNED_CHAR,
+		ARG_SHORT,
+		ARG_UNSIGNED_SHORT,
+		ARG_INT,
+		ARG_UNSIGNED_INT,
+		ARG_LONG,
+		ARG_UNSIGNED_LONG,
+		ARG_LONG_LONG,
+		ARG_UNSIGNED_LONG_LONG,
+		ARG_FLOAT,
+		ARG_DOUBLE,
+		ARG_STRING
+	};
+
+	bool captureArguments()
+	{
+		return true;
+	}
+
+	template <typename T, typename... Args>
+	bool captureArguments(const T& arg, const Args&... args)
+	{
+		return add(arg) && captureArguments(args...);
+	}
+
+	bool add(bool value)               { return addValue(ARG_BOOL, value); }
+	bool add(char value)               { return addValue(ARG_CHAR, value); }
+	bool add(signed char value)        { return addValue(ARG_SIGNED_CHAR, value); }
+	bool add(unsigned char value)      { return addValue(ARG_UNSIGNED_CHAR, value); }
+	bool add(short value)              { return addValue(ARG_SHORT, value); }
+	bool add(unsigned short value)     { return addValue(ARG_UNSIGNED_SHORT, value); }
+	bool add(int value)                { return addValue(ARG_INT, value); }
+	bool add(unsigned int value)       { return addValue(ARG_UNSIGNED_INT, value); }
+	bool add(long value)               { return addValue(ARG_LONG, value); }
+	bool add(unsigned long value)      { return addValue(ARG_UNSIGNED_LONG, value); }
+	bool add(long long value)          { return addValue(ARG_LONG_LONG, value); }
+	bool add(unsigned long long value) { return addValue(ARG_UNSIGNED_LONG_LONG, value); }
+	bool add(float value)              { return addValue(ARG_FLOAT, value); }
+	bool add(double value)             { return addValue(ARG_DOUBLE, value); }
+	bool add(const std::string& value) { return addString(value.data(), value.size()); }
+	bool add(const char* value)        { return value && addString(value, std::strlen(value)); }
+	bool add(char* value)              { return value && addString(value, std::strlen(value)); }
+
+	template <typename T>
+	bool add(const T&)
+		/// Arguments of any other type cannot be captured.
+	{
+		return false;
+	}
+
+	static void appendValues(std::vector<Any>&)
+	{
+	}
+
+	template <typename T, typename... Args>
+	static void appendValues(std::vector<Any>& values, const T& arg, const Args&... args)
+	{
+		appendValue(values, arg);
+		appendValues(values, args...);
+	}
+
+	template <typename T>
+	static void appendValue(std::vector<Any>& values, const T& value)
+	{
+		values.push_back(value);
+	}
+
+	static void appendValue(std::vector<Any>& values, const char* value)
+	{
+		if (value)
+			values.push_back(std::string(value));
+		else
+			values.push_back(value);
+	}
+
+	static void appendValue(std::vector<Any>& values, char* value)
+	{
+		appendValue(values, const_cast<const char*>(value));
+	}
+
+	template <typename T>
+	bool addValue(ArgumentType type, T value)
+	{
+		if (_count == MAX_ARGUMENTS || _size + sizeof(T) > BUFFER_SIZE) return false;
+		std::memcpy(_buffer + _size, &value, sizeof(T));
+		_size += sizeof(T);
+		_types[_count++] = static_cast<unsigned char>(type);
+		return true;
+	}
+
+	bool addString(const char* value, std::size_t length);
+
+	const char*   _pFormat;
+	std::size_t   _size;
+	int           _count;
+	unsigned char _types[MAX_ARGUMENTS];
+	char          _buffer[BUFFER_SIZE];
+};
+
+
+//
+// inlines
+//
+inline bool DeferredFormat::empty() const
+{
+	return _pFormat == 0;
+}
+
+
+inline void DeferredFormat::clear()
+{
+	_pFormat = 0;
+	_size    = 0;
+	_count   = 0;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_DeferredFormat_INCLUDED
@@ -23,12 +23,14 @@
 #include "Poco/Timestamp.h"
 #include "Poco/Timespan.h"
 #include "Poco/Mutex.h"
+#include <atomic>
 
 
 namespace Poco {
 
 
 class LogFile;
+class MappedLogFile;
 class RotateStrategy;
 class ArchiveStrategy;
 class PurgeStrategy;
@@ -162,6 +164,29 @@ class Foundation_API FileChannel: public Channel
 	///            if it exists (unless other conditions for a rotation are met).
 	///            This is the default.
 	///
+	/// Batches of messages delivered with logBatch() (e.g., by a
+	/// BatchingAsyncChannel) are written to the file with a single
+	/// write operation. The rotation criteria are checked once per
+	/// batch, so the log file may exceed its size limit by up to
+	/// one batch.
+	///
+	/// For high message rates, the log file can be written through a
+	/// memory mapping, by setting the "mapped" property to true.
+	/// The log file is then extended by a segment of "segmentSize" bytes
+	/// (default 1 M), which is mapped into memory. Each message reserves
+	/// its space in the segment with an atomic operation, so messages
+	/// from multiple threads are written concurrently, without locking.
+	/// When the segment is full, the file is truncated to the text
+	/// actually written, the rotation criteria are checked (and the file
+	/// is rotated and archived, if necessary), and a new segment is
+	/// mapped. The rotation criteria are also checked once per second.
+	/// Therefore, when rotating by size, the log file may exceed its
+	/// size limit by up to one segment. In mapped mode, the "flush"
+	/// property is ignored; the text is written to the operating
+	/// system's page cache and survives a crash of the application,
+	/// but not of the system. Until the file is closed, readers
+	/// of the log file may see NUL bytes at its end.
+	///
 	/// For a more lightweight file channel class, see SimpleFileChannel.
 {
 public:
@@ -181,6 +206,10 @@ public:
 
 	void log(const Message& msg);
 		/// Logs the given message to the file.
+
+	void logBatch(const Message* pMessages, std::size_t count);
+		/// Logs the given messages to the file, with a single
+		/// write operation.
 		
 	void setProperty(const std::string& name, const std::string& value);
 		/// Sets the property with the given name.
@@ -207,6 +236,12 @@ public:
 		///                   for details.
 		///   * rotateOnOpen: Specifies whether an existing log file should be
 		///                   rotated and archived when the channel is opened.
+		///   * mapped:       Specifies whether the log file is written
+		///                   through a memory mapping. See the FileChannel
+		///                   class for details.
+		///   * segmentSize:  The size of the segments mapped in mapped mode,
+		///                   in bytes (<n>), Kilobytes (<n> K) or
+		///                   Megabytes (<n> M).
 
 	std::string getProperty(const std::string& name) const;
 		/// Returns the value of the property with the given name.
@@ -231,6 +266,13 @@ public:
 	static const std::string PROP_PURGECOUNT;
 	static const std::string PROP_FLUSH;
 	static const std::string PROP_ROTATEONOPEN;
+	static const std::string PROP_MAPPED;
+	static const std::string PROP_SEGMENTSIZE;
+
+	enum
+	{
+		DEFAULT_SEGMENT_SIZE = 1024*1024
+	};
 
 protected:
 	~FileChannel();
@@ -241,28 +283,40 @@ protected:
 	void setPurgeCount(const std::string& count);
 	void setFlush(const std::string& flush);
 	void setRotateOnOpen(const std::string& rotateOnOpen);
+	void setMapped(const std::string& mapped);
+	void setSegmentSize(const std::string& size);
 	void purge();
+	void rotateIfNecessary();
+	void logMapped(const Message& msg);
+	void switchSegment(std::size_t minSize);
+	void mapSegment(std::size_t minSize);
 
 private:
+	void unsafeOpen();
+	void unsafeClose();
 	bool setNoPurge(const std::string& value);
 	int extractDigit(const std::string& value, std::string::const_iterator* nextToDigit = NULL) const;
 	void setPurgeStrategy(PurgeStrategy* strategy);
 	Timespan::TimeDiff extractFactor(const std::string& value, std::string::const_iterator start) const;
 
-	std::string      _path;
-	std::string      _times;
-	std::string      _rotation;
-	std::string      _archive;
-	bool             _compress;
-	std::string      _purgeAge;
-	std::string      _purgeCount;
-	bool             _flush;
-	bool             _rotateOnOpen;
-	LogFile*         _pFile;
-	RotateStrategy*  _pRotateStrategy;
-	ArchiveStrategy* _pArchiveStrategy;
-	PurgeStrategy*   _pPurgeStrategy;
-	FastMutex        _mutex;
+	std::string                     _path;
+	std::string                     _times;
+	std::string                     _rotation;
+	std::string                     _archive;
+	bool                            _compress;
+	std::string                     _purgeAge;
+	std::string                     _purgeCount;
+	bool                            _flush;
+	bool                            _rotateOnOpen;
+	std::atomic<bool>               _mapped;
+	std::size_t                     _segmentSize;
+	LogFile*                        _pFile;
+	std::atomic<MappedLogFile*>     _pMappedFile;
+	std::atomic<Timestamp::TimeVal> _nextRotateCheck;
+	RotateStrategy*                 _pRotateStrategy;
+	ArchiveStrategy*                _pArchiveStrategy;
+	PurgeStrategy*                  _pPurgeStrategy;
+	FastMutex                       _mutex;
 };
 
 
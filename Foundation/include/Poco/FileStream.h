@@ -68,6 +68,15 @@ public:
 	FileStreamBuf* rdbuf();
 		/// Returns a pointer to the underlying streambuf.
 
+	FileStreamBuf::NativeHandle nativeHandle() const;
+		/// Returns the native file handle (file descriptor
+		/// on POSIX platforms) of the open file.
+		///
+		/// The handle is owned by the stream and must not be closed.
+		/// Note that reading or writing through the stream is
+		/// buffered, so the current position of the native handle
+		/// is not necessarily the stream's position.
+
 protected:
 	FileStreamBuf _buf;
 	std::ios::openmode _defaultMode;
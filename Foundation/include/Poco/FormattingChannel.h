@@ -70,6 +70,10 @@ public:
 		/// passes the formatted message on to the destination
 		/// Channel.
 
+	void logBatch(const Message* pMessages, std::size_t count);
+		/// Formats the given messages using the Formatter and
+		/// passes them on to the destination Channel as a batch.
+
 	void setProperty(const std::string& name, const std::string& value);
 		/// Sets or changes a configuration property.
 		///
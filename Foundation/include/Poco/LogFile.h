@@ -47,6 +47,17 @@ public:
 		/// If flush is true, the text will be immediately
 		/// flushed to the file.
 
+	void appendLine(const std::string& text);
+		/// Appends the given text, followed by a line separator,
+		/// to the buffer written by writeLines().
+
+	void writeLines(bool flush = true);
+		/// Writes the lines collected by appendLine() to the
+		/// log file with a single write operation, and clears
+		/// the buffer. Does nothing if no lines have been appended.
+		/// If flush is true, the text will be immediately
+		/// flushed to the file.
+
 	UInt64 size() const;
 		/// Returns the current size in bytes of the log file.
 
@@ -67,6 +78,18 @@ inline void LogFile::write(const std::string& text, bool flush)
 }
 
 
+inline void LogFile::appendLine(const std::string& text)
+{
+	appendLineImpl(text);
+}
+
+
+inline void LogFile::writeLines(bool flush)
+{
+	writeLinesImpl(flush);
+}
+
+
 inline UInt64 LogFile::size() const
 {
 	return sizeImpl();
@@ -35,6 +35,8 @@ public:
 	LogFileImpl(const std::string& path);
 	~LogFileImpl();
 	void writeImpl(const std::string& text, bool flush);
+	void appendLineImpl(const std::string& text);
+	void writeLinesImpl(bool flush);
 	UInt64 sizeImpl() const;
 	Timestamp creationDateImpl() const;
 	const std::string& pathImpl() const;
@@ -44,6 +46,7 @@ private:
 	mutable Poco::FileOutputStream _str;
 	Timestamp _creationDate;
 	UInt64 _size;
+	std::string _lines;
 };
 
 
@@ -35,6 +35,8 @@ public:
 	LogFileImpl(const std::string& path);
 	~LogFileImpl();
 	void writeImpl(const std::string& text, bool flush);
+	void appendLineImpl(const std::string& text);
+	void writeLinesImpl(bool flush);
 	UInt64 sizeImpl() const;
 	Timestamp creationDateImpl() const;
 	const std::string& pathImpl() const;
@@ -45,6 +47,7 @@ private:
 	std::string _path;
 	HANDLE      _hFile;
 	Timestamp   _creationDate;
+	std::string _lines;
 };
 
 
@@ -27,6 +27,7 @@
 #include <vector>
 #include <cstddef>
 #include <memory>
+#include <atomic>
 
 
 namespace Poco {
@@ -156,7 +157,8 @@ public:
 	template <typename T, typename... Args>
 	void fatal(const std::string &fmt, T arg1, Args&&... args)
 	{
-		log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_FATAL);
+		if (is(Message::PRIO_FATAL) && _pChannel)
+			log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_FATAL);
 	}
 
 	void critical(const std::string& msg);
@@ -178,7 +180,8 @@ public:
 	template <typename T, typename... Args>
 	void critical(const std::string &fmt, T arg1, Args&&... args)
 	{
-		log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_CRITICAL);
+		if (is(Message::PRIO_CRITICAL) && _pChannel)
+			log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_CRITICAL);
 	}
 
 	void error(const std::string& msg);
@@ -200,7 +203,8 @@ public:
 	template <typename T, typename... Args>
 	void error(const std::string &fmt, T arg1, Args&&... args)
 	{
-		log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_ERROR);
+		if (is(Message::PRIO_ERROR) && _pChannel)
+			log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_ERROR);
 	}
 
 	void warning(const std::string& msg);
@@ -222,7 +226,8 @@ public:
 	template <typename T, typename... Args>
 	void warning(const std::string &fmt, T arg1, Args&&... args)
 	{
-		log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_WARNING);
+		if (is(Message::PRIO_WARNING) && _pChannel)
+			log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_WARNING);
 	}
 
 	void notice(const std::string& msg);
@@ -244,7 +249,8 @@ public:
 	template <typename T, typename... Args>
 	void notice(const std::string &fmt, T arg1, Args&&... args)
 	{
-		log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_NOTICE);
+		if (is(Message::PRIO_NOTICE) && _pChannel)
+			log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_NOTICE);
 	}
 
 	void information(const std::string& msg);
@@ -266,7 +272,8 @@ public:
 	template <typename T, typename... Args>
 	void information(const std::string &fmt, T arg1, Args&&... args)
 	{
-		log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_INFORMATION);
+		if (is(Message::PRIO_INFORMATION) && _pChannel)
+			log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_INFORMATION);
 	}
 
 	void debug(const std::string& msg);
@@ -288,7 +295,8 @@ public:
 	template <typename T, typename... Args>
 	void debug(const std::string &fmt, T arg1, Args&&... args)
 	{
-		log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_DEBUG);
+		if (is(Message::PRIO_DEBUG) && _pChannel)
+			log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_DEBUG);
 	}
 
 	void trace(const std::string& msg);
@@ -310,7 +318,37 @@ public:
 	template <typename T, typename... Args>
 	void trace(const std::string &fmt, T arg1, Args&&... args)
 	{
-		log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_TRACE);
+		if (is(Message::PRIO_TRACE) && _pChannel)
+			log(Poco::format(fmt, arg1, std::forward<Args>(args)...), Message::PRIO_TRACE);
+	}
+
+	template <typename T, typename... Args>
+	void logDeferred(Message::Priority prio, const char* fmt, const T& arg1, const Args&... args)
+		/// If the Logger's log level is at least prio, creates a
+		/// Message with the given priority and a deferred text
+		/// (see Message::deferText()) and sends it to the
+		/// attached channel.
+		///
+		/// The text is only formatted with Poco::format() when
+		/// the message is written, e.g. by the background thread
+		/// of an AsyncChannel. If the Logger's log level is
+		/// below prio, the cost of the call is a comparison.
+		///
+		/// The format string is not copied and must be a static
+		/// string, such as a string literal. Arguments that cannot
+		/// be deferred (see DeferredFormat) are formatted immediately.
+	{
+		if (is(prio) && _pChannel)
+		{
+			Message msg(_name, std::string(), prio);
+			if (!msg.deferText(fmt, arg1, args...))
+			{
+				std::string text;
+				DeferredFormat::formatNow(text, fmt, arg1, args...);
+				msg.setText(text);
+			}
+			_pChannel->log(msg);
+		}
 	}
 
 	void dump(const std::string& msg, const void* buffer, std::size_t length, Message::Priority prio = Message::PRIO_DEBUG);
@@ -389,6 +427,10 @@ public:
 		/// Returns a reference to the Logger with the given name.
 		/// If the Logger does not yet exist, it is created, based
 		/// on its parent logger.
+		///
+		/// Existing loggers are found without locking, so get()
+		/// can be called frequently from many threads. To avoid
+		/// even the lookup, use a LoggerHandle.
 
 	static Logger& unsafeGet(const std::string& name);
 		/// Returns a reference to the Logger with the given name.
@@ -417,12 +459,19 @@ public:
 		/// Destroys the logger with the specified name. Does nothing
 		/// if the logger is not found.
 		///
-		/// After a logger has been destroyed, all references to it
-		/// become invalid.	
+		/// The Logger object is released once no concurrent lookup
+		/// can still see it. References to the Logger obtained
+		/// from get() become invalid, while a Ptr obtained from has()
+		/// or a LoggerHandle keeps the Logger, including its Channel,
+		/// alive.
 		
 	static void shutdown();
 		/// Shuts down the logging framework and releases all
 		/// Loggers.
+		///
+		/// After shutdown(), all references to Loggers
+		/// become invalid. Must not be called while other
+		/// threads are still using Loggers.
 		
 	static void names(std::vector<std::string>& names);
 		/// Fills the given vector with the names
@@ -464,17 +513,20 @@ protected:
 private:
 	typedef std::unique_ptr<LoggerMap> LoggerMapPtr;
 
+	class LoggerIndex;
+
 	Logger();
 	Logger(const Logger&);
 	Logger& operator = (const Logger&);
 
-	std::string  _name;
-	Channel::Ptr _pChannel;
-	int          _level;
+	std::string      _name;
+	Channel::Ptr     _pChannel;
+	std::atomic<int> _level;
 
 	// definitions in Foundation.cpp
-	static LoggerMapPtr _pLoggerMap;
-	static Mutex        _mapMtx;
+	static LoggerMapPtr               _pLoggerMap;
+	static std::atomic<LoggerIndex*>  _pLoggerIndex;
+	static Mutex                      _mapMtx;
 };
 
 
@@ -625,13 +677,13 @@ inline const std::string& Logger::name() const
 
 inline int Logger::getLevel() const
 {
-	return _level;
+	return _level.load(std::memory_order_relaxed);
 }
 
 
 inline void Logger::log(const std::string& text, Message::Priority prio)
 {
-	if (_level >= prio && _pChannel)
+	if (is(prio) && _pChannel)
 	{
 		_pChannel->log(Message(_name, text, prio));
 	}
@@ -640,7 +692,7 @@ inline void Logger::log(const std::string& text, Message::Priority prio)
 
 inline void Logger::log(const std::string& text, Message::Priority prio, const char* file, int line)
 {
-	if (_level >= prio && _pChannel)
+	if (is(prio) && _pChannel)
 	{
 		_pChannel->log(Message(_name, text, prio, file, line));
 	}
@@ -746,55 +798,55 @@ inline void Logger::trace(const std::string& msg, const char* file, int line)
 
 inline bool Logger::is(int level) const
 {
-	return _level >= level;
+	return _level.load(std::memory_order_relaxed) >= level;
 }
 
 
 inline bool Logger::fatal() const
 {
-	return _level >= Message::PRIO_FATAL;
+	return is(Message::PRIO_FATAL);
 }
 
 
 inline bool Logger::critical() const
 {
-	return _level >= Message::PRIO_CRITICAL;
+	return is(Message::PRIO_CRITICAL);
 }
 
 
 inline bool Logger::error() const
 {
-	return _level >= Message::PRIO_ERROR;
+	return is(Message::PRIO_ERROR);
 }
 
 
 inline bool Logger::warning() const
 {
-	return _level >= Message::PRIO_WARNING;
+	return is(Message::PRIO_WARNING);
 }
 
 
 inline bool Logger::notice() const
 {
-	return _level >= Message::PRIO_NOTICE;
+	return is(Message::PRIO_NOTICE);
 }
 
 
 inline bool Logger::information() const
 {
-	return _level >= Message::PRIO_INFORMATION;
+	return is(Message::PRIO_INFORMATION);
 }
 
 
 inline bool Logger::debug() const
 {
-	return _level >= Message::PRIO_DEBUG;
+	return is(Message::PRIO_DEBUG);
 }
 
 
 inline bool Logger::trace() const
 {
-	return _level >= Message::PRIO_TRACE;
+	return is(Message::PRIO_TRACE);
 }
 
 
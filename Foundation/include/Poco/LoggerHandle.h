@@ -0,0 +1,118 @@
+//
+// LoggerHandle.h
+//
+// Library: Foundation
+// Package: Logging
+// Module:  LoggerHandle
+//
+// Definition of the LoggerHandle class.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_LoggerHandle_INCLUDED
+#define Foundation_LoggerHandle_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Logger.h"
+
+
+namespace Poco {
+
+
+class Foundation_API LoggerHandle
+	/// A LoggerHandle looks up a Logger once, when the handle
+	/// is created, and keeps a reference to it, so that code
+	/// that logs frequently does not have to call Logger::get()
+	/// every time.
+	///
+	/// Level changes, including those made with
+	/// Logger::setLevel(name, level) for a whole hierarchy,
+	/// are immediately visible through the handle, and checking
+	/// the level with is() (or Logger::information(), etc.) is a
+	/// single atomic load.
+	///
+	/// The handle keeps the Logger object alive. However, after
+	/// Logger::destroy() or Logger::shutdown(), the Logger is no
+	/// longer part of the logger hierarchy.
+	///
+	/// Example:
+	///     static LoggerHandle logger("MyApp.Network");
+	///
+	///     if (logger.is(Message::PRIO_DEBUG)) ...
+	///     poco_information(*logger, "connected");
+{
+public:
+	explicit LoggerHandle(const std::string& name);
+		/// Creates the LoggerHandle for the Logger with the given name.
+		/// The Logger is created, if necessary, by calling Logger::get().
+
+	explicit LoggerHandle(Logger& logger);
+		/// Creates the LoggerHandle for the given Logger.
+
+	LoggerHandle(const LoggerHandle& handle);
+		/// Creates a LoggerHandle referring to the same Logger
+		/// as the given handle.
+
+	~LoggerHandle();
+		/// Destroys the LoggerHandle.
+
+	LoggerHandle& operator = (const LoggerHandle& handle);
+		/// Assignment operator.
+
+	Logger& logger() const;
+		/// Returns a reference to the Logger.
+
+	Logger& operator * () const;
+		/// Returns a reference to the Logger.
+
+	Logger* operator -> () const;
+		/// Returns a pointer to the Logger.
+
+	bool is(int level) const;
+		/// Returns true if the Logger's log level is at least
+		/// the given level.
+
+private:
+	LoggerHandle();
+
+	Logger* _pLogger;
+};
+
+
+//
+// inlines
+//
+inline Logger& LoggerHandle::logger() const
+{
+	return *_pLogger;
+}
+
+
+inline Logger& LoggerHandle::operator * () const
+{
+	return *_pLogger;
+}
+
+
+inline Logger* LoggerHandle::operator -> () const
+{
+	return _pLogger;
+}
+
+
+inline bool LoggerHandle::is(int level) const
+{
+	return _pLogger->is(level);
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_LoggerHandle_INCLUDED
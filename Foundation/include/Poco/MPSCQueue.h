@@ -0,0 +1,124 @@
+//
+// MPSCQueue.h
+//
+// Library: Foundation
+// Package: Notifications
+// Module:  MPSCQueue
+//
+// Definition of the MPSCQueue class template.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_MPSCQueue_INCLUDED
+#define Foundation_MPSCQueue_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include <atomic>
+#include <utility>
+
+
+namespace Poco {
+
+
+template <class T>
+class MPSCQueue
+	/// An unbounded, lock-free queue for passing values from
+	/// multiple producer threads to a single consumer thread.
+	///
+	/// The implementation is the intrusive node-based queue described
+	/// by Dmitry Vyukov: push() links a new node with a single atomic
+	/// exchange and never waits for other producers or the consumer;
+	/// pop() does not use any atomic read-modify-write operations.
+	///
+	/// Values pushed by the same thread are popped in the order
+	/// they have been pushed.
+	///
+	/// push() can be called from any thread, while pop() and
+	/// empty() must only be called from the consumer thread.
+	///
+	/// T must be default constructible and copyable.
+{
+public:
+	MPSCQueue():
+		_pHead(&_stub),
+		_pTail(&_stub)
+		/// Creates the MPSCQueue.
+	{
+	}
+
+	~MPSCQueue()
+		/// Destroys the MPSCQueue, together with all values still in it.
+	{
+		T value;
+		while (pop(value))
+		{
+		}
+		if (_pTail != &_stub) delete _pTail;
+	}
+
+	void push(const T& value)
+		/// Appends a copy of the given value to the queue.
+	{
+		Node* pNode = new Node(value);
+		Node* pPrev = _pHead.exchange(pNode, std::memory_order_acq_rel);
+		pPrev->pNext.store(pNode, std::memory_order_release);
+	}
+
+	bool pop(T& value)
+		/// Removes the oldest value from the queue and assigns
+		/// it to value. Returns false if the queue is empty.
+		///
+		/// A value whose push() has not completed yet (as well
+		/// as values pushed after it) may not be seen.
+	{
+		Node* pTail = _pTail;
+		Node* pNext = pTail->pNext.load(std::memory_order_acquire);
+		if (!pNext) return false;
+
+		value = std::move(pNext->value);
+		pNext->value = T();
+		_pTail = pNext;
+		if (pTail != &_stub) delete pTail;
+		return true;
+	}
+
+	bool empty() const
+		/// Returns true iff the queue is empty.
+	{
+		return _pTail->pNext.load(std::memory_order_acquire) == 0;
+	}
+
+private:
+	MPSCQueue(const MPSCQueue&);
+	MPSCQueue& operator = (const MPSCQueue&);
+
+	struct Node
+	{
+		Node(): pNext(0)
+		{
+		}
+
+		explicit Node(const T& v): value(v), pNext(0)
+		{
+		}
+
+		T value;
+		std::atomic<Node*> pNext;
+	};
+
+	Node _stub;
+	std::atomic<Node*> _pHead;
+	Node* _pTail;
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_MPSCQueue_INCLUDED
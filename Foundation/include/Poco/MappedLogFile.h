@@ -0,0 +1,121 @@
+//
+// MappedLogFile.h
+//
+// Library: Foundation
+// Package: Logging
+// Module:  MappedLogFile
+//
+// Definition of the MappedLogFile class.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_MappedLogFile_INCLUDED
+#define Foundation_MappedLogFile_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/SharedMemory.h"
+#include <atomic>
+
+
+namespace Poco {
+
+
+class Foundation_API MappedLogFile
+	/// This class is used by FileChannel to write to a log
+	/// file through a memory mapping, if the FileChannel's
+	/// "mapped" property is set.
+	///
+	/// When the file is opened, it is extended by a segment of
+	/// the given size, and the whole file is mapped into memory.
+	/// Lines are appended by atomically reserving space in the
+	/// segment and copying the text into the mapping, so that
+	/// multiple threads can write concurrently without locking.
+	/// When the segment is full, write() fails and the file must
+	/// be closed and opened again, which maps a new segment.
+	///
+	/// close() truncates the file to the size of the text that
+	/// has actually been written. If a process terminates without
+	/// closing the file, the rest of the segment remains filled
+	/// with NUL bytes. These are ignored, and overwritten, when
+	/// the file is opened again.
+{
+public:
+	MappedLogFile();
+		/// Creates a closed MappedLogFile.
+
+	~MappedLogFile();
+		/// Closes and destroys the MappedLogFile.
+
+	void open(const std::string& path, std::size_t segmentSize);
+		/// Opens the file with the given path, creating it if
+		/// necessary, and maps it so that at least segmentSize
+		/// bytes can be appended.
+		///
+		/// Must not be called concurrently with open() or close().
+
+	void close();
+		/// Waits until all writes in progress have completed,
+		/// unmaps the file and truncates it to the size of the
+		/// text written. Does nothing if the file is not open.
+		///
+		/// Must not be called concurrently with open() or close().
+
+	bool write(const std::string& text);
+		/// Appends the given text, followed by a newline,
+		/// to the file.
+		///
+		/// Returns false if the file is not open or if there
+		/// is not enough space left in the current segment.
+		///
+		/// Can be called concurrently from multiple threads,
+		/// and concurrently with open() and close().
+
+	bool isOpen() const;
+		/// Returns true if the file is open.
+
+	UInt64 size() const;
+		/// Returns the number of bytes written to the file.
+
+	const std::string& path() const;
+		/// Returns the path of the file.
+
+private:
+	MappedLogFile(const MappedLogFile&);
+	MappedLogFile& operator = (const MappedLogFile&);
+
+	std::string         _path;
+	SharedMemory        _memory;
+	char*               _pData;
+	UInt64              _capacity;
+	std::atomic<UInt64> _writePos;
+	std::atomic<UInt64> _endPos;
+	std::atomic<int>    _writers;
+	std::atomic<bool>   _open;
+};
+
+
+//
+// inlines
+//
+inline bool MappedLogFile::isOpen() const
+{
+	return _open.load(std::memory_order_acquire);
+}
+
+
+inline const std::string& MappedLogFile::path() const
+{
+	return _path;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_MappedLogFile_INCLUDED
@@ -20,6 +20,7 @@
 
 #include "Poco/Foundation.h"
 #include "Poco/Timestamp.h"
+#include "Poco/DeferredFormat.h"
 #include <map>
 
 
@@ -41,6 +42,16 @@ class Foundation_API Message
 	/// A Message can also contain any number of named parameters
 	/// that contain additional information about the event that
 	/// caused the message.
+	///
+	/// The text of a Message can be deferred (see deferText()).
+	/// In this case, the message only stores the format string and
+	/// the arguments, and the text is formatted the first time it is
+	/// requested with getText(), usually by the channel that writes
+	/// the message. Since getText() then modifies the Message, the
+	/// first call to getText() of a Message with a deferred text
+	/// must not be made concurrently with any other call to the
+	/// same Message. Messages passed to another thread (e.g., by
+	/// AsyncChannel) are copies, which is safe.
 {
 public:
 	enum Priority
@@ -105,8 +116,33 @@ public:
 	void setText(const std::string& text);
 		/// Sets the text of the message.
 
+	template <typename... Args>
+	bool deferText(const char* fmt, const Args&... args)
+		/// Sets the text of the message to the result of
+		/// Poco::format(fmt, args...), which is computed the
+		/// first time getText() is called.
+		///
+		/// The format string is not copied and must be a static
+		/// string, such as a string literal. The arguments are
+		/// copied into the Message, without allocating memory.
+		///
+		/// Returns false if the arguments cannot be captured
+		/// (see DeferredFormat). In this case, the text of the
+		/// message is empty and the caller should set it with
+		/// setText().
+	{
+		_text.clear();
+		return _deferred.capture(fmt, args...);
+	}
+
+	bool isDeferred() const;
+		/// Returns true if the message has a deferred text
+		/// that has not been formatted yet.
+
 	const std::string& getText() const;
 		/// Returns the text of the message.
+		///
+		/// Formats a deferred text first.
 
 	void setPriority(Priority prio);
 		/// Sets the priority of the message.
@@ -195,11 +231,13 @@ public:
 
 protected:
 	void init();
+	void formatText() const;
 	typedef std::map<std::string, std::string> StringMap;
 
 private:
 	std::string _source;
-	std::string _text;
+	mutable std::string _text;
+	mutable DeferredFormat _deferred;
 	Priority    _prio;
 	Timestamp   _time;
 	long        _tid;
@@ -221,8 +259,15 @@ inline const std::string& Message::getSource() const
 }
 
 
+inline bool Message::isDeferred() const
+{
+	return !_deferred.empty();
+}
+
+
 inline const std::string& Message::getText() const
 {
+	if (!_deferred.empty()) formatText();
 	return _text;
 }
 
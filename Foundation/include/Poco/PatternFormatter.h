@@ -121,10 +121,6 @@ public:
 	static const std::string PROP_PRIORITY_NAMES;
 
 protected:
-	const std::string& getPriorityName(int);
-		/// Returns a string for the given priority value.
-	
-private:
 	struct PatternAction
 	{
 		PatternAction(): key(0), length(0)
@@ -137,6 +133,16 @@ private:
 		std::string prepend;
 	};
 
+	const std::string& getPriorityName(int);
+		/// Returns a string for the given priority value.
+
+	const std::vector<PatternAction>& patternActions() const;
+		/// Returns the parsed format pattern.
+
+	bool localTime() const;
+		/// Returns true if times are adjusted for local time.
+	
+private:
 	void parsePattern();
 		/// Will parse the _pattern string into the vector of PatternActions,
 		/// which contains the message key, any text that needs to be written first
@@ -152,6 +158,21 @@ private:
 };
 
 
+//
+// inlines
+//
+inline const std::vector<PatternFormatter::PatternAction>& PatternFormatter::patternActions() const
+{
+	return _patternActions;
+}
+
+
+inline bool PatternFormatter::localTime() const
+{
+	return _localTime;
+}
+
+
 } // namespace Poco
 
 
@@ -0,0 +1,235 @@
+//
+// LoggingBenchmark.cpp
+//
+// This sample shows a benchmark of formatters and logging channels.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/PatternFormatter.h"
+#include "Poco/CompiledPatternFormatter.h"
+#include "Poco/FormattingChannel.h"
+#include "Poco/FileChannel.h"
+#include "Poco/AsyncChannel.h"
+#include "Poco/BatchingAsyncChannel.h"
+#include "Poco/Logger.h"
+#include "Poco/Message.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/AutoPtr.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+
+
+using Poco::Formatter;
+using Poco::PatternFormatter;
+using Poco::CompiledPatternFormatter;
+using Poco::Channel;
+using Poco::FormattingChannel;
+using Poco::FileChannel;
+using Poco::AsyncChannel;
+using Poco::BatchingAsyncChannel;
+using Poco::Logger;
+using Poco::Message;
+using Poco::TemporaryFile;
+using Poco::Stopwatch;
+using Poco::Thread;
+using Poco::Runnable;
+using Poco::AutoPtr;
+
+
+const std::string PATTERN("%Y-%m-%d %H:%M:%S.%i [%p] %s<%I>: %t");
+const int LOOP_COUNT = 1000000;
+
+
+void report(const std::string& label, const Stopwatch& sw, int count = LOOP_COUNT)
+{
+	std::cout << std::left << std::setw(44) << label << ' '
+		<< std::right << std::setw(10) << sw.elapsed() << " [us] "
+		<< std::setw(10) << (sw.elapsed() > 0 ? Poco::Int64(count)*1000000/sw.elapsed() : 0) << " [msg/s]"
+		<< std::endl;
+}
+
+
+void benchmarkFormatter(Formatter& formatter, const std::string& label)
+{
+	Message msg("LoggingBenchmark", "The quick brown fox jumps over the lazy dog.", Message::PRIO_INFORMATION);
+	std::string text;
+
+	Stopwatch sw;
+	sw.start();
+
+	for (int i = 0; i < LOOP_COUNT; ++i)
+	{
+		msg.setTime(Poco::Timestamp());
+		text.clear();
+		formatter.format(msg, text);
+	}
+
+	sw.stop();
+
+	report(label, sw);
+}
+
+
+void benchmarkChannel(Channel& channel, const std::string& label)
+{
+	Stopwatch sw;
+	sw.start();
+
+	for (int i = 0; i < LOOP_COUNT; ++i)
+	{
+		channel.log(Message("LoggingBenchmark", "The quick brown fox jumps over the lazy dog.", Message::PRIO_INFORMATION));
+	}
+	channel.close();
+
+	sw.stop();
+
+	report(label, sw);
+}
+
+
+void benchmarkLogger(Logger& logger, bool deferred, const std::string& label)
+{
+	std::string what("fox");
+
+	Stopwatch sw;
+	sw.start();
+
+	for (int i = 0; i < LOOP_COUNT; ++i)
+	{
+		if (deferred)
+			logger.logDeferred(Message::PRIO_INFORMATION, "The quick brown %s jumps over the lazy dog %d times.", what, i);
+		else
+			logger.information("The quick brown %s jumps over the lazy dog %d times.", what, i);
+	}
+	logger.getChannel()->close();
+
+	sw.stop();
+
+	report(label, sw);
+}
+
+
+class LoggerGetRunnable: public Runnable
+{
+public:
+	LoggerGetRunnable(const std::string& name): _name(name), _enabled(0)
+	{
+	}
+
+	void run()
+	{
+		int enabled = 0;
+		for (int i = 0; i < LOOP_COUNT; ++i)
+		{
+			if (Logger::get(_name).information()) ++enabled;
+		}
+		_enabled += enabled;
+	}
+
+private:
+	std::string _name;
+	std::atomic<int> _enabled;
+};
+
+
+void benchmarkLoggerGet(int threads, const std::string& label)
+{
+	for (int i = 0; i < 100; ++i)
+	{
+		Logger::get("LoggingBenchmark.Logger" + std::to_string(i));
+	}
+	LoggerGetRunnable runnable("LoggingBenchmark.Logger42");
+	std::vector<Thread*> threadList;
+
+	Stopwatch sw;
+	sw.start();
+
+	for (int i = 0; i < threads; ++i)
+	{
+		threadList.push_back(new Thread);
+		threadList.back()->start(runnable);
+	}
+	for (std::vector<Thread*>::iterator it = threadList.begin(); it != threadList.end(); ++it)
+	{
+		(*it)->join();
+		delete *it;
+	}
+
+	sw.stop();
+
+	report(label, sw, threads*LOOP_COUNT);
+}
+
+
+int main(int argc, char** argv)
+{
+	{
+		PatternFormatter formatter(PATTERN);
+		benchmarkFormatter(formatter, "PatternFormatter");
+	}
+
+	{
+		CompiledPatternFormatter formatter(PATTERN);
+		benchmarkFormatter(formatter, "CompiledPatternFormatter");
+	}
+
+	{
+		TemporaryFile file;
+		AutoPtr<Channel> pChannel = new FormattingChannel(new PatternFormatter(PATTERN), new FileChannel(file.path()));
+		benchmarkChannel(*pChannel, "PatternFormatter, FileChannel");
+	}
+
+	{
+		TemporaryFile file;
+		AutoPtr<Channel> pChannel = new FormattingChannel(new CompiledPatternFormatter(PATTERN), new FileChannel(file.path()));
+		benchmarkChannel(*pChannel, "CompiledPatternFormatter, FileChannel");
+	}
+
+	{
+		TemporaryFile file;
+		AutoPtr<FileChannel> pFileChannel = new FileChannel(file.path());
+		pFileChannel->setProperty(FileChannel::PROP_MAPPED, "true");
+		AutoPtr<Channel> pChannel = new FormattingChannel(new CompiledPatternFormatter(PATTERN), pFileChannel);
+		benchmarkChannel(*pChannel, "CompiledPatternFormatter, mapped FileChannel");
+	}
+
+	{
+		TemporaryFile file;
+		AutoPtr<Channel> pChannel = new AsyncChannel(new FormattingChannel(new CompiledPatternFormatter(PATTERN), new FileChannel(file.path())));
+		benchmarkChannel(*pChannel, "AsyncChannel, FileChannel");
+	}
+
+	{
+		TemporaryFile file;
+		AutoPtr<Channel> pChannel = new BatchingAsyncChannel(new FormattingChannel(new CompiledPatternFormatter(PATTERN), new FileChannel(file.path())));
+		benchmarkChannel(*pChannel, "BatchingAsyncChannel, FileChannel");
+	}
+
+	{
+		TemporaryFile file;
+		Logger& logger = Logger::get("LoggingBenchmark");
+		logger.setChannel(new BatchingAsyncChannel(new FormattingChannel(new CompiledPatternFormatter(PATTERN), new FileChannel(file.path()))));
+		logger.setLevel(Message::PRIO_WARNING);
+		benchmarkLogger(logger, false, "Logger::information() (disabled)");
+		benchmarkLogger(logger, true, "Logger::logDeferred() (disabled)");
+		logger.setLevel(Message::PRIO_INFORMATION);
+		benchmarkLogger(logger, false, "Logger::information(), BatchingAsyncChannel");
+		benchmarkLogger(logger, true, "Logger::logDeferred(), BatchingAsyncChannel");
+		logger.setChannel(0);
+	}
+
+	benchmarkLoggerGet(1, "Logger::get(), 1 thread");
+	benchmarkLoggerGet(4, "Logger::get(), 4 threads");
+
+	return 0;
+}
@@ -0,0 +1,423 @@
+//
+// BatchingAsyncChannel.cpp
+//
+// Library: Foundation
+// Package: Logging
+// Module:  BatchingAsyncChannel
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/BatchingAsyncChannel.h"
+#include "Poco/LoggingRegistry.h"
+#include "Poco/NumberParser.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+
+
+const std::string BatchingAsyncChannel::PROP_CAPACITY   = "capacity";
+const std::string BatchingAsyncChannel::PROP_OVERFLOW   = "overflow";
+const std::string BatchingAsyncChannel::PROP_SAMPLERATE = "sampleRate";
+const std::string BatchingAsyncChannel::PROP_BATCHSIZE  = "batchSize";
+
+
+BatchingAsyncChannel::BatchingAsyncChannel(Channel::Ptr pChannel, Thread::Priority prio):
+	_pChannel(pChannel),
+	_thread("BatchingAsyncChannel"),
+	_capacity(DEFAULT_CAPACITY),
+	_mask(DEFAULT_CAPACITY - 1),
+	_batchSize(DEFAULT_BATCH_SIZE),
+	_policy(OVERFLOW_BLOCK),
+	_sampleRate(DEFAULT_SAMPLE_RATE),
+	_running(false),
+	_stop(false),
+	_consumerWaiting(false),
+	_producersWaiting(0),
+	_sampleCounter(0),
+	_dropped(0),
+	_droppedReported(0),
+	_enqueuePos(0),
+	_dequeuePos(0)
+{
+	_thread.setPriority(prio);
+}
+
+
+BatchingAsyncChannel::~BatchingAsyncChannel()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void BatchingAsyncChannel::setChannel(Channel::Ptr pChannel)
+{
+	FastMutex::ScopedLock lock(_channelMutex);
+
+	_pChannel = pChannel;
+}
+
+
+Channel::Ptr BatchingAsyncChannel::getChannel() const
+{
+	return _pChannel;
+}
+
+
+void BatchingAsyncChannel::open()
+{
+	if (_running.load(std::memory_order_acquire)) return;
+
+	FastMutex::ScopedLock lock(_threadMutex);
+
+	if (!_running.load(std::memory_order_relaxed))
+	{
+		if (!_sequences) allocate();
+		_stop = false;
+		_thread.start(*this);
+		_running.store(true, std::memory_order_release);
+	}
+}
+
+
+void BatchingAsyncChannel::close()
+{
+	FastMutex::ScopedLock lock(_threadMutex);
+
+	if (_running.load(std::memory_order_relaxed))
+	{
+		_stop = true;
+		_messagesAvailable.set();
+		_thread.join();
+		_running = false;
+	}
+}
+
+
+void BatchingAsyncChannel::log(const Message& msg)
+{
+	open();
+
+	if (_policy == OVERFLOW_SAMPLE)
+	{
+		std::size_t used = _enqueuePos.load(std::memory_order_relaxed) - _dequeuePos.load(std::memory_order_relaxed);
+		if (used >= _capacity - _capacity/4 && _sampleCounter.fetch_add(1, std::memory_order_relaxed) % static_cast<Poco::UInt32>(_sampleRate) != 0)
+		{
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	std::size_t pos;
+	while (!claim(pos))
+	{
+		if (_policy != OVERFLOW_BLOCK || Thread::current() == &_thread)
+		{
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		waitForSpace();
+	}
+
+	std::size_t index = pos & _mask;
+	try
+	{
+		_messages[index] = msg;
+	}
+	catch (...)
+	{
+		// The slot must be published anyway, as the
+		// background thread would wait for it forever.
+		_sequences[index].store(pos + 1, std::memory_order_seq_cst);
+		throw;
+	}
+	_sequences[index].store(pos + 1, std::memory_order_seq_cst);
+	if (_consumerWaiting.load(std::memory_order_seq_cst))
+	{
+		_messagesAvailable.set();
+	}
+}
+
+
+void BatchingAsyncChannel::setCapacity(std::size_t capacity)
+{
+	FastMutex::ScopedLock lock(_threadMutex);
+
+	if (_running) throw IllegalStateException("Cannot change the capacity of an open BatchingAsyncChannel");
+	if (capacity < 2) capacity = 2;
+
+	std::size_t n = 2;
+	while (n < capacity) n <<= 1;
+	if (n != _capacity)
+	{
+		// messages logged while the channel was being closed are discarded
+		_capacity = n;
+		_mask = n - 1;
+		_messages.clear();
+		_sequences.reset();
+		_enqueuePos = 0;
+		_dequeuePos = 0;
+	}
+}
+
+
+void BatchingAsyncChannel::setOverflowPolicy(OverflowPolicy policy)
+{
+	_policy = policy;
+}
+
+
+void BatchingAsyncChannel::setSampleRate(int rate)
+{
+	if (rate < 1) throw InvalidArgumentException("sample rate must be at least 1");
+	_sampleRate = rate;
+}
+
+
+void BatchingAsyncChannel::setBatchSize(std::size_t size)
+{
+	if (size < 1) throw InvalidArgumentException("batch size must be at least 1");
+	_batchSize = size;
+}
+
+
+void BatchingAsyncChannel::setProperty(const std::string& name, const std::string& value)
+{
+	if (name == "channel")
+		setChannel(LoggingRegistry::defaultRegistry().channelForName(value));
+	else if (name == "priority")
+		setPriority(value);
+	else if (name == PROP_CAPACITY)
+		setCapacity(NumberParser::parseUnsigned(value));
+	else if (name == PROP_OVERFLOW)
+	{
+		if (value == "block")
+			setOverflowPolicy(OVERFLOW_BLOCK);
+		else if (value == "drop")
+			setOverflowPolicy(OVERFLOW_DROP);
+		else if (value == "sample")
+			setOverflowPolicy(OVERFLOW_SAMPLE);
+		else
+			throw InvalidArgumentException("overflow policy", value);
+	}
+	else if (name == PROP_SAMPLERATE)
+		setSampleRate(NumberParser::parse(value));
+	else if (name == PROP_BATCHSIZE)
+		setBatchSize(NumberParser::parseUnsigned(value));
+	else
+		Channel::setProperty(name, value);
+}
+
+
+std::string BatchingAsyncChannel::getProperty(const std::string& name) const
+{
+	if (name == PROP_CAPACITY)
+		return NumberFormatter::format(_capacity);
+	else if (name == PROP_OVERFLOW)
+	{
+		switch (_policy)
+		{
+		case OVERFLOW_DROP:
+			return "drop";
+		case OVERFLOW_SAMPLE:
+			return "sample";
+		default:
+			return "block";
+		}
+	}
+	else if (name == PROP_SAMPLERATE)
+		return NumberFormatter::format(_sampleRate);
+	else if (name == PROP_BATCHSIZE)
+		return NumberFormatter::format(_batchSize);
+	else
+		return Channel::getProperty(name);
+}
+
+
+void BatchingAsyncChannel::run()
+{
+	for (;;)
+	{
+		if (deliver() > 0) continue;
+
+		if (_stop)
+		{
+			// messages logged while stopping
+			if (deliver() > 0) continue;
+			break;
+		}
+
+		_consumerWaiting.store(true, std::memory_order_seq_cst);
+		std::size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+		if (_sequences[pos & _mask].load(std::memory_order_seq_cst) != pos + 1 && !_stop)
+		{
+			// The timeout is a safety net only; producers
+			// wake us up when we are waiting.
+			_messagesAvailable.tryWait(1000);
+		}
+		_consumerWaiting.store(false, std::memory_order_relaxed);
+	}
+}
+
+
+void BatchingAsyncChannel::setPriority(const std::string& value)
+{
+	Thread::Priority prio = Thread::PRIO_NORMAL;
+
+	if (value == "lowest")
+		prio = Thread::PRIO_LOWEST;
+	else if (value == "low")
+		prio = Thread::PRIO_LOW;
+	else if (value == "normal")
+		prio = Thread::PRIO_NORMAL;
+	else if (value == "high")
+		prio = Thread::PRIO_HIGH;
+	else if (value == "highest")
+		prio = Thread::PRIO_HIGHEST;
+	else
+		throw InvalidArgumentException("thread priority", value);
+
+	_thread.setPriority(prio);
+}
+
+
+void BatchingAsyncChannel::allocate()
+{
+	_messages.resize(_capacity);
+	_sequences.reset(new std::atomic<std::size_t>[_capacity]);
+	for (std::size_t i = 0; i < _capacity; ++i)
+	{
+		_sequences[i].store(i, std::memory_order_relaxed);
+	}
+	_enqueuePos = 0;
+	_dequeuePos = 0;
+}
+
+
+bool BatchingAsyncChannel::claim(std::size_t& pos)
+{
+	// A slot is free for position pos if its sequence number is pos.
+	// It is published by setting the sequence number to pos + 1,
+	// and freed for the next round by setting it to pos + capacity.
+	pos = _enqueuePos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		std::size_t seq = _sequences[pos & _mask].load(std::memory_order_acquire);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+		if (diff == 0)
+		{
+			if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				return true;
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else
+		{
+			pos = _enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+
+void BatchingAsyncChannel::waitForSpace()
+{
+	_producersWaiting.fetch_add(1, std::memory_order_seq_cst);
+	_messagesAvailable.set();
+	_spaceAvailable.tryWait(10);
+	_producersWaiting.fetch_sub(1, std::memory_order_relaxed);
+}
+
+
+std::size_t BatchingAsyncChannel::deliver()
+{
+	// Collect the published messages, up to the end of the
+	// ring buffer, so that they can be passed on in place.
+	std::size_t start = _dequeuePos.load(std::memory_order_relaxed);
+	std::size_t index = start & _mask;
+	std::size_t n = 0;
+	while (n < _batchSize && index + n < _capacity && _sequences[index + n].load(std::memory_order_acquire) == start + n + 1)
+	{
+		++n;
+	}
+	if (n == 0) return 0;
+
+	{
+		FastMutex::ScopedLock lock(_channelMutex);
+
+		if (_pChannel)
+		{
+			try
+			{
+				_pChannel->logBatch(&_messages[index], n);
+			}
+			catch (Exception& exc)
+			{
+				ErrorHandler::handle(exc);
+			}
+			catch (std::exception& exc)
+			{
+				ErrorHandler::handle(exc);
+			}
+			catch (...)
+			{
+				ErrorHandler::handle();
+			}
+		}
+	}
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		_sequences[index + i].store(start + i + _capacity, std::memory_order_release);
+	}
+	_dequeuePos.store(start + n, std::memory_order_relaxed);
+	if (_producersWaiting.load(std::memory_order_seq_cst) > 0)
+	{
+		_spaceAvailable.set();
+	}
+	reportDropped();
+	return n;
+}
+
+
+void BatchingAsyncChannel::reportDropped()
+{
+	Poco::UInt64 dropped = _dropped.load(std::memory_order_relaxed);
+	if (dropped != _droppedReported)
+	{
+		std::string text(NumberFormatter::format(dropped - _droppedReported));
+		text.append(" log messages have been dropped");
+		_droppedReported = dropped;
+
+		FastMutex::ScopedLock lock(_channelMutex);
+
+		if (_pChannel)
+		{
+			try
+			{
+				_pChannel->log(Message("BatchingAsyncChannel", text, Message::PRIO_WARNING));
+			}
+			catch (...)
+			{
+			}
+		}
+	}
+}
+
+
+} // namespace Poco
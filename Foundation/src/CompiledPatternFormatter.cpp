@@ -0,0 +1,366 @@
+//
+// CompiledPatternFormatter.cpp
+//
+// Library: Foundation
+// Package: Logging
+// Module:  CompiledPatternFormatter
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/CompiledPatternFormatter.h"
+#include "Poco/Message.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/DateTimeFormat.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/Timezone.h"
+#include "Poco/Environment.h"
+#include <atomic>
+
+
+namespace Poco {
+
+
+namespace
+{
+	struct TimeBlockCache
+		/// The rendered time blocks of a formatter for one second.
+	{
+		TimeBlockCache(): id(0), second(0)
+		{
+		}
+
+		Poco::UInt64 id;
+		Timestamp::TimeVal second;
+		std::vector<std::string> blocks;
+	};
+
+	enum
+	{
+		TIME_BLOCK_CACHE_SIZE = 4
+	};
+
+	thread_local TimeBlockCache timeBlockCache[TIME_BLOCK_CACHE_SIZE];
+	thread_local unsigned nextTimeBlockCache = 0;
+
+	std::atomic<Poco::UInt64> nextFormatterId(0);
+}
+
+
+CompiledPatternFormatter::CompiledPatternFormatter():
+	_literalSize(0),
+	_id(0)
+{
+	compile();
+}
+
+
+CompiledPatternFormatter::CompiledPatternFormatter(const std::string& rFormat):
+	PatternFormatter(rFormat),
+	_literalSize(0),
+	_id(0)
+{
+	compile();
+}
+
+
+CompiledPatternFormatter::~CompiledPatternFormatter()
+{
+}
+
+
+void CompiledPatternFormatter::format(const Message& msg, std::string& text)
+{
+	Timestamp::TimeVal epochMicroseconds = msg.getTime().epochMicroseconds();
+	Timestamp::TimeVal second = epochMicroseconds/Timestamp::resolution();
+	Timestamp::TimeVal fraction = epochMicroseconds % Timestamp::resolution();
+	if (fraction < 0)
+	{
+		fraction += Timestamp::resolution();
+		--second;
+	}
+
+	TimeBlockCache* pCache = 0;
+	if (!_timeBlocks.empty())
+	{
+		for (int i = 0; i < TIME_BLOCK_CACHE_SIZE; ++i)
+		{
+			if (timeBlockCache[i].id == _id)
+			{
+				pCache = &timeBlockCache[i];
+				break;
+			}
+		}
+		if (!pCache)
+		{
+			pCache = &timeBlockCache[nextTimeBlockCache++ % TIME_BLOCK_CACHE_SIZE];
+			pCache->id = _id;
+			pCache->blocks.resize(_timeBlocks.size());
+			pCache->second = second + 1;
+		}
+		if (pCache->second != second)
+		{
+			for (std::size_t i = 0; i < _timeBlocks.size(); ++i)
+			{
+				pCache->blocks[i].clear();
+				renderTimeBlock(i, second, pCache->blocks[i]);
+			}
+			pCache->second = second;
+		}
+	}
+
+	text.reserve(text.size() + _literalSize + msg.getText().size() + 64);
+	for (std::vector<Step>::const_iterator it = _steps.begin(); it != _steps.end(); ++it)
+	{
+		switch (it->type)
+		{
+		case STEP_LITERAL:
+			text.append(it->text);
+			break;
+		case STEP_TIME:
+			text.append(pCache->blocks[it->index]);
+			break;
+		case STEP_SOURCE:
+			text.append(msg.getSource());
+			break;
+		case STEP_SOURCE_WIDTH:
+			if (it->index > msg.getSource().length()) // append spaces
+				text.append(msg.getSource()).append(it->index - msg.getSource().length(), ' ');
+			else if (it->index && it->index < msg.getSource().length()) // crop
+				text.append(msg.getSource(), msg.getSource().length() - it->index, it->index);
+			else
+				text.append(msg.getSource());
+			break;
+		case STEP_TEXT:
+			text.append(msg.getText());
+			break;
+		case STEP_PRIORITY_LEVEL:
+			NumberFormatter::append(text, (int) msg.getPriority());
+			break;
+		case STEP_PRIORITY_NAME:
+			text.append(_priorityNames[msg.getPriority()]);
+			break;
+		case STEP_PRIORITY_ABBREV:
+			text += _priorityNames[msg.getPriority()].at(0);
+			break;
+		case STEP_PID:
+			NumberFormatter::append(text, static_cast<Poco::Int64>(msg.getPid()));
+			break;
+		case STEP_TID:
+			NumberFormatter::append(text, static_cast<Poco::Int64>(msg.getTid()));
+			break;
+		case STEP_OS_TID:
+			NumberFormatter::append(text, msg.getOsTid());
+			break;
+		case STEP_THREAD:
+			text.append(msg.getThread());
+			break;
+		case STEP_SOURCE_FILE:
+			if (msg.getSourceFile()) text.append(msg.getSourceFile());
+			break;
+		case STEP_SOURCE_LINE:
+			NumberFormatter::append(text, msg.getSourceLine());
+			break;
+		case STEP_MILLISECOND:
+			NumberFormatter::append0(text, static_cast<int>(fraction/1000), 3);
+			break;
+		case STEP_CENTISECOND:
+			NumberFormatter::append(text, static_cast<int>(fraction/100000));
+			break;
+		case STEP_MICROSECOND:
+			NumberFormatter::append0(text, static_cast<int>(fraction), 6);
+			break;
+		case STEP_PARAMETER:
+			try
+			{
+				text.append(msg[it->text]);
+			}
+			catch (...)
+			{
+			}
+			break;
+		}
+	}
+}
+
+
+void CompiledPatternFormatter::setProperty(const std::string& name, const std::string& value)
+{
+	PatternFormatter::setProperty(name, value);
+	compile();
+}
+
+
+void CompiledPatternFormatter::compile()
+{
+	_steps.clear();
+	_timeBlocks.clear();
+	_literalSize = 0;
+	_id = ++nextFormatterId;
+
+	for (int i = 1; i <= 8; i++)
+	{
+		_priorityNames[i] = getPriorityName(i);
+	}
+
+	bool local = localTime();
+	const std::vector<PatternAction>& actions = patternActions();
+	for (std::vector<PatternAction>::const_iterator it = actions.begin(); it != actions.end(); ++it)
+	{
+		appendLiteral(it->prepend);
+		if (isTimeKey(it->key))
+		{
+			appendTimeField(it->key, local);
+			continue;
+		}
+		switch (it->key)
+		{
+		case 's': appendStep(STEP_SOURCE); break;
+		case 'v': appendStep(STEP_SOURCE_WIDTH, std::string(), it->length > 0 ? it->length : 0); break;
+		case 't': appendStep(STEP_TEXT); break;
+		case 'l': appendStep(STEP_PRIORITY_LEVEL); break;
+		case 'p': appendStep(STEP_PRIORITY_NAME); break;
+		case 'q': appendStep(STEP_PRIORITY_ABBREV); break;
+		case 'P': appendStep(STEP_PID); break;
+		case 'I': appendStep(STEP_TID); break;
+		case 'O': appendStep(STEP_OS_TID); break;
+		case 'T': appendStep(STEP_THREAD); break;
+		case 'U': appendStep(STEP_SOURCE_FILE); break;
+		case 'u': appendStep(STEP_SOURCE_LINE); break;
+		case 'i': appendStep(STEP_MILLISECOND); break;
+		case 'c': appendStep(STEP_CENTISECOND); break;
+		case 'F': appendStep(STEP_MICROSECOND); break;
+		case 'x': appendStep(STEP_PARAMETER, it->property); break;
+		case 'N': appendLiteral(Environment::nodeName()); break;
+		case 'L': local = true; break;
+		}
+	}
+}
+
+
+void CompiledPatternFormatter::appendLiteral(const std::string& text)
+{
+	if (text.empty()) return;
+
+	_literalSize += text.size();
+	if (!_steps.empty() && _steps.back().type == STEP_TIME)
+	{
+		TimeField field = {0, false, text};
+		_timeBlocks.back().push_back(field);
+	}
+	else if (!_steps.empty() && _steps.back().type == STEP_LITERAL)
+	{
+		_steps.back().text.append(text);
+	}
+	else
+	{
+		appendStep(STEP_LITERAL, text);
+	}
+}
+
+
+void CompiledPatternFormatter::appendTimeField(char key, bool localTime)
+{
+	if (_steps.empty() || _steps.back().type != STEP_TIME)
+	{
+		// Literal text preceding the time block becomes part of it.
+		_timeBlocks.push_back(std::vector<TimeField>());
+		if (!_steps.empty() && _steps.back().type == STEP_LITERAL)
+		{
+			TimeField field = {0, false, _steps.back().text};
+			_timeBlocks.back().push_back(field);
+			_steps.pop_back();
+		}
+		appendStep(STEP_TIME, std::string(), _timeBlocks.size() - 1);
+	}
+	TimeField field = {key, localTime, std::string()};
+	_timeBlocks.back().push_back(field);
+}
+
+
+void CompiledPatternFormatter::appendStep(StepType type, const std::string& text, std::size_t index)
+{
+	Step step = {type, text, index};
+	_steps.push_back(step);
+}
+
+
+void CompiledPatternFormatter::renderTimeBlock(std::size_t block, Timestamp::TimeVal second, std::string& text) const
+{
+	DateTime utcDateTime(Timestamp(second*Timestamp::resolution()));
+	DateTime localDateTime;
+	int tzd = 0;
+	bool haveLocal = false;
+	const std::vector<TimeField>& fields = _timeBlocks[block];
+	for (std::vector<TimeField>::const_iterator it = fields.begin(); it != fields.end(); ++it)
+	{
+		if (it->key == 0)
+		{
+			text.append(it->text);
+		}
+		else if (it->localTime)
+		{
+			if (!haveLocal)
+			{
+				tzd = Timezone::tzd();
+				localDateTime = Timestamp((second + tzd)*Timestamp::resolution());
+				haveLocal = true;
+			}
+			appendTime(it->key, localDateTime, tzd, second, text);
+		}
+		else
+		{
+			appendTime(it->key, utcDateTime, DateTimeFormatter::UTC, second, text);
+		}
+	}
+}
+
+
+bool CompiledPatternFormatter::isTimeKey(char key)
+{
+	switch (key)
+	{
+	case 'w': case 'W': case 'b': case 'B': case 'd': case 'e': case 'f':
+	case 'm': case 'n': case 'o': case 'y': case 'Y': case 'H': case 'h':
+	case 'a': case 'A': case 'M': case 'S': case 'z': case 'Z': case 'E':
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+void CompiledPatternFormatter::appendTime(char key, const DateTime& dateTime, int tzd, Timestamp::TimeVal second, std::string& text)
+{
+	switch (key)
+	{
+	case 'w': text.append(DateTimeFormat::WEEKDAY_NAMES[dateTime.dayOfWeek()], 0, 3); break;
+	case 'W': text.append(DateTimeFormat::WEEKDAY_NAMES[dateTime.dayOfWeek()]); break;
+	case 'b': text.append(DateTimeFormat::MONTH_NAMES[dateTime.month() - 1], 0, 3); break;
+	case 'B': text.append(DateTimeFormat::MONTH_NAMES[dateTime.month() - 1]); break;
+	case 'd': NumberFormatter::append0(text, dateTime.day(), 2); break;
+	case 'e': NumberFormatter::append(text, dateTime.day()); break;
+	case 'f': NumberFormatter::append(text, dateTime.day(), 2); break;
+	case 'm': NumberFormatter::append0(text, dateTime.month(), 2); break;
+	case 'n': NumberFormatter::append(text, dateTime.month()); break;
+	case 'o': NumberFormatter::append(text, dateTime.month(), 2); break;
+	case 'y': NumberFormatter::append0(text, dateTime.year() % 100, 2); break;
+	case 'Y': NumberFormatter::append0(text, dateTime.year(), 4); break;
+	case 'H': NumberFormatter::append0(text, dateTime.hour(), 2); break;
+	case 'h': NumberFormatter::append0(text, dateTime.hourAMPM(), 2); break;
+	case 'a': text.append(dateTime.isAM() ? "am" : "pm"); break;
+	case 'A': text.append(dateTime.isAM() ? "AM" : "PM"); break;
+	case 'M': NumberFormatter::append0(text, dateTime.minute(), 2); break;
+	case 'S': NumberFormatter::append0(text, dateTime.second(), 2); break;
+	case 'z': DateTimeFormatter::tzdISO(text, tzd); break;
+	case 'Z': DateTimeFormatter::tzdRFC(text, tzd); break;
+	case 'E': NumberFormatter::append(text, static_cast<Poco::Int64>(second)); break;
+	}
+}
+
+
+} // namespace Poco
@@ -0,0 +1,151 @@
+//
+// DeferredFormat.cpp
+//
+// Library: Foundation
+// Package: Logging
+// Module:  DeferredFormat
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/DeferredFormat.h"
+
+
+namespace Poco {
+
+
+namespace
+{
+	template <typename T>
+	void extractValue(std::vector<Any>& values, const char*& pData)
+	{
+		T value;
+		std::memcpy(&value, pData, sizeof(T));
+		pData += sizeof(T);
+		values.push_back(value);
+	}
+}
+
+
+DeferredFormat::DeferredFormat():
+	_pFormat(0),
+	_size(0),
+	_count(0)
+{
+}
+
+
+DeferredFormat::DeferredFormat(const DeferredFormat& other):
+	_pFormat(other._pFormat),
+	_size(other._size),
+	_count(other._count)
+{
+	std::memcpy(_types, other._types, _count);
+	std::memcpy(_buffer, other._buffer, _size);
+}
+
+
+DeferredFormat::~DeferredFormat()
+{
+}
+
+
+DeferredFormat& DeferredFormat::operator = (const DeferredFormat& other)
+{
+	if (&other != this)
+	{
+		_pFormat = other._pFormat;
+		_size    = other._size;
+		_count   = other._count;
+		std::memcpy(_types, other._types, _count);
+		std::memcpy(_buffer, other._buffer, _size);
+	}
+	return *this;
+}
+
+
+void DeferredFormat::format(std::string& result) const
+{
+	if (!_pFormat) return;
+
+	std::vector<Any> values;
+	values.reserve(_count);
+	const char* pData = _buffer;
+	for (int i = 0; i < _count; ++i)
+	{
+		switch (_types[i])
+		{
+		case ARG_BOOL:
+			extractValue<bool>(values, pData);
+			break;
+		case ARG_CHAR:
+			extractValue<char>(values, pData);
+			break;
+		case ARG_SIGNED_CHAR:
+			extractValue<signed char>(values, pData);
+			break;
+		case ARG_UNSIGNED_CHAR:
+			extractValue<unsigned char>(values, pData);
+			break;
+		case ARG_SHORT:
+			extractValue<short>(values, pData);
+			break;
+		case ARG_UNSIGNED_SHORT:
+			extractValue<unsigned short>(values, pData);
+			break;
+		case ARG_INT:
+			extractValue<int>(values, pData);
+			break;
+		case ARG_UNSIGNED_INT:
+			extractValue<unsigned int>(values, pData);
+			break;
+		case ARG_LONG:
+			extractValue<long>(values, pData);
+			break;
+		case ARG_UNSIGNED_LONG:
+			extractValue<unsigned long>(values, pData);
+			break;
+		case ARG_LONG_LONG:
+			extractValue<long long>(values, pData);
+			break;
+		case ARG_UNSIGNED_LONG_LONG:
+			extractValue<unsigned long long>(values, pData);
+			break;
+		case ARG_FLOAT:
+			extractValue<float>(values, pData);
+			break;
+		case ARG_DOUBLE:
+			extractValue<double>(values, pData);
+			break;
+		case ARG_STRING:
+			{
+				std::size_t length;
+				std::memcpy(&length, pData, sizeof(length));
+				pData += sizeof(length);
+				values.push_back(std::string(pData, length));
+				pData += length;
+			}
+			break;
+		}
+	}
+	Poco::format(result, _pFormat, values);
+}
+
+
+bool DeferredFormat::addString(const char* value, std::size_t length)
+{
+	if (_count == MAX_ARGUMENTS || _size + sizeof(length) + length > BUFFER_SIZE) return false;
+	std::memcpy(_buffer + _size, &length, sizeof(length));
+	_size += sizeof(length);
+	std::memcpy(_buffer + _size, value, length);
+	_size += length;
+	_types[_count++] = ARG_STRING;
+	return true;
+}
+
+
+} // namespace Poco
@@ -16,14 +16,18 @@
 #include "Poco/ArchiveStrategy.h"
 #include "Poco/RotateStrategy.h"
 #include "Poco/PurgeStrategy.h"
+#include "Poco/MappedLogFile.h"
+#include "Poco/File.h"
 #include "Poco/Message.h"
 #include "Poco/NumberParser.h"
+#include "Poco/NumberFormatter.h"
 #include "Poco/DateTimeFormatter.h"
 #include "Poco/DateTime.h"
 #include "Poco/LocalDateTime.h"
 #include "Poco/String.h"
 #include "Poco/Exception.h"
 #include "Poco/Ascii.h"
+#include <algorithm>
 
 
 namespace Poco {
@@ -38,13 +42,19 @@ const std::string FileChannel::PROP_PURGEAGE     = "purgeAge";
 const std::string FileChannel::PROP_PURGECOUNT   = "purgeCount";
 const std::string FileChannel::PROP_FLUSH        = "flush";
 const std::string FileChannel::PROP_ROTATEONOPEN = "rotateOnOpen";
+const std::string FileChannel::PROP_MAPPED       = "mapped";
+const std::string FileChannel::PROP_SEGMENTSIZE  = "segmentSize";
 
 FileChannel::FileChannel():
 	_times("utc"),
 	_compress(false),
 	_flush(true),
 	_rotateOnOpen(false),
+	_mapped(false),
+	_segmentSize(DEFAULT_SEGMENT_SIZE),
 	_pFile(0),
+	_pMappedFile(0),
+	_nextRotateCheck(Timestamp::TIMEVAL_MAX),
 	_pRotateStrategy(0),
 	_pArchiveStrategy(new ArchiveByNumberStrategy),
 	_pPurgeStrategy(0)
@@ -58,7 +68,11 @@ FileChannel::FileChannel(const std::string& rPath):
 	_compress(false),
 	_flush(true),
 	_rotateOnOpen(false),
+	_mapped(false),
+	_segmentSize(DEFAULT_SEGMENT_SIZE),
 	_pFile(0),
+	_pMappedFile(0),
+	_nextRotateCheck(Timestamp::TIMEVAL_MAX),
 	_pRotateStrategy(0),
 	_pArchiveStrategy(new ArchiveByNumberStrategy),
 	_pPurgeStrategy(0)
@@ -71,6 +85,7 @@ FileChannel::~FileChannel()
 	try
 	{
 		close();
+		delete _pMappedFile.load(std::memory_order_relaxed);
 		delete _pRotateStrategy;
 		delete _pArchiveStrategy;
 		delete _pPurgeStrategy;
@@ -85,23 +100,8 @@ FileChannel::~FileChannel()
 void FileChannel::open()
 {
 	FastMutex::ScopedLock lock(_mutex);
-	
-	if (!_pFile)
-	{
-		_pFile = new LogFile(_path);
-		if (_rotateOnOpen && _pFile->size() > 0)
-		{
-			try
-			{
-				_pFile = _pArchiveStrategy->archive(_pFile);
-				purge();
-			}
-			catch (...)
-			{
-				_pFile = new LogFile(_path);
-			}
-		}
-	}
+
+	unsafeOpen();
 }
 
 
@@ -109,34 +109,50 @@ void FileChannel::close()
 {
 	FastMutex::ScopedLock lock(_mutex);
 
-	delete _pFile;
-	_pFile = 0;
+	unsafeClose();
 }
 
 
 void FileChannel::log(const Message& msg)
 {
+	if (_mapped.load(std::memory_order_relaxed))
+	{
+		logMapped(msg);
+		return;
+	}
+
 	open();
 
 	FastMutex::ScopedLock lock(_mutex);
 
-	if (_pRotateStrategy && _pArchiveStrategy && _pRotateStrategy->mustRotate(_pFile))
+	rotateIfNecessary();
+	_pFile->write(msg.getText(), _flush);
+}
+
+
+void FileChannel::logBatch(const Message* pMessages, std::size_t count)
+{
+	if (count == 0) return;
+
+	if (_mapped.load(std::memory_order_relaxed))
 	{
-		try
+		for (std::size_t i = 0; i < count; ++i)
 		{
-			_pFile = _pArchiveStrategy->archive(_pFile);
-			purge();
-		}
-		catch (...)
-		{
-			_pFile = new LogFile(_path);
+			logMapped(pMessages[i]);
 		}
-		// we must call mustRotate() again to give the
-		// RotateByIntervalStrategy a chance to write its timestamp
-		// to the new file.
-		_pRotateStrategy->mustRotate(_pFile);
+		return;
 	}
-	_pFile->write(msg.getText(), _flush);
+
+	open();
+
+	FastMutex::ScopedLock lock(_mutex);
+
+	rotateIfNecessary();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		_pFile->appendLine(pMessages[i].getText());
+	}
+	_pFile->writeLines(_flush);
 }
 
 	
@@ -170,6 +186,10 @@ void FileChannel::setProperty(const std::string& name, const std::string& value)
 		setFlush(value);
 	else if (name == PROP_ROTATEONOPEN)
 		setRotateOnOpen(value);
+	else if (name == PROP_MAPPED)
+		setMapped(value);
+	else if (name == PROP_SEGMENTSIZE)
+		setSegmentSize(value);
 	else
 		Channel::setProperty(name, value);
 }
@@ -195,6 +215,10 @@ std::string FileChannel::getProperty(const std::string& name) const
 		return std::string(_flush ? "true" : "false");
 	else if (name == PROP_ROTATEONOPEN)
 		return std::string(_rotateOnOpen ? "true" : "false");
+	else if (name == PROP_MAPPED)
+		return std::string(_mapped ? "true" : "false");
+	else if (name == PROP_SEGMENTSIZE)
+		return NumberFormatter::format(_segmentSize);
 	else
 		return Channel::getProperty(name);
 }
@@ -202,8 +226,11 @@ std::string FileChannel::getProperty(const std::string& name) const
 
 Timestamp FileChannel::creationDate() const
 {
+	MappedLogFile* pMappedFile = _pMappedFile.load(std::memory_order_acquire);
 	if (_pFile)
 		return _pFile->creationDate();
+	else if (pMappedFile && pMappedFile->isOpen())
+		return File(_path).created();
 	else
 		return 0;
 }
@@ -211,8 +238,11 @@ Timestamp FileChannel::creationDate() const
 	
 UInt64 FileChannel::size() const
 {
+	MappedLogFile* pMappedFile = _pMappedFile.load(std::memory_order_acquire);
 	if (_pFile)
 		return _pFile->size();
+	else if (pMappedFile && pMappedFile->isOpen())
+		return pMappedFile->size();
 	else
 		return 0;
 }
@@ -343,6 +373,120 @@ void FileChannel::setRotateOnOpen(const std::string& rotateOnOpen)
 }
 
 
+void FileChannel::setMapped(const std::string& mapped)
+{
+	bool flag = icompare(mapped, "true") == 0;
+	if (flag != _mapped)
+	{
+		unsafeClose();
+		_mapped = flag;
+	}
+}
+
+
+void FileChannel::setSegmentSize(const std::string& size)
+{
+	std::string::const_iterator it  = size.begin();
+	std::string::const_iterator end = size.end();
+	std::size_t n = 0;
+	while (it != end && Ascii::isSpace(*it)) ++it;
+	while (it != end && Ascii::isDigit(*it)) { n *= 10; n += *it++ - '0'; }
+	while (it != end && Ascii::isSpace(*it)) ++it;
+	std::string unit;
+	while (it != end && Ascii::isAlpha(*it)) unit += *it++;
+
+	if (unit == "K")
+		n *= 1024;
+	else if (unit == "M")
+		n *= 1024*1024;
+	else if (!unit.empty())
+		throw InvalidArgumentException("segmentSize", size);
+	if (n == 0) throw InvalidArgumentException("segmentSize", size);
+	_segmentSize = n;
+}
+
+
+void FileChannel::rotateIfNecessary()
+{
+	if (_pRotateStrategy && _pArchiveStrategy && _pRotateStrategy->mustRotate(_pFile))
+	{
+		try
+		{
+			_pFile = _pArchiveStrategy->archive(_pFile);
+			purge();
+		}
+		catch (...)
+		{
+			_pFile = new LogFile(_path);
+		}
+		// we must call mustRotate() again to give the
+		// RotateByIntervalStrategy a chance to write its timestamp
+		// to the new file.
+		_pRotateStrategy->mustRotate(_pFile);
+	}
+}
+
+
+void FileChannel::logMapped(const Message& msg)
+{
+	MappedLogFile* pMappedFile = _pMappedFile.load(std::memory_order_acquire);
+	if (pMappedFile && msg.getTime().epochMicroseconds() < _nextRotateCheck.load(std::memory_order_relaxed))
+	{
+		if (pMappedFile->write(msg.getText())) return;
+	}
+
+	FastMutex::ScopedLock lock(_mutex);
+
+	unsafeOpen();
+	if (!_mapped)
+	{
+		rotateIfNecessary();
+		_pFile->write(msg.getText(), _flush);
+		return;
+	}
+	if (msg.getTime().epochMicroseconds() >= _nextRotateCheck.load(std::memory_order_relaxed))
+	{
+		switchSegment(0);
+	}
+	while (!_pMappedFile.load(std::memory_order_relaxed)->write(msg.getText()))
+	{
+		switchSegment(msg.getText().size() + 1);
+	}
+}
+
+
+void FileChannel::switchSegment(std::size_t minSize)
+{
+	// The mapped file is closed, which truncates it to the text
+	// written, so that the rotation strategy can work on it
+	// like on any other log file.
+	_pMappedFile.load(std::memory_order_relaxed)->close();
+	_pFile = new LogFile(_path);
+	rotateIfNecessary();
+	mapSegment(minSize);
+}
+
+
+void FileChannel::mapSegment(std::size_t minSize)
+{
+	delete _pFile;
+	_pFile = 0;
+
+	MappedLogFile* pMappedFile = _pMappedFile.load(std::memory_order_relaxed);
+	if (!pMappedFile)
+	{
+		pMappedFile = new MappedLogFile;
+		_pMappedFile.store(pMappedFile, std::memory_order_release);
+	}
+	pMappedFile->open(_path, std::max(_segmentSize, minSize));
+
+	if (_pRotateStrategy)
+		_nextRotateCheck.store(Timestamp().epochMicroseconds() + Timestamp::resolution(), std::memory_order_relaxed);
+	else
+		_nextRotateCheck.store(Timestamp::TIMEVAL_MAX, std::memory_order_relaxed);
+}
+
+
 void FileChannel::purge()
 {
 	if (_pPurgeStrategy)
@@ -358,6 +502,39 @@ void FileChannel::purge()
 }
 
 
+void FileChannel::unsafeOpen()
+{
+	MappedLogFile* pMappedFile = _pMappedFile.load(std::memory_order_relaxed);
+	if (!_pFile && !(pMappedFile && pMappedFile->isOpen()))
+	{
+		_pFile = new LogFile(_path);
+		if (_rotateOnOpen && _pFile->size() > 0)
+		{
+			try
+			{
+				_pFile = _pArchiveStrategy->archive(_pFile);
+				purge();
+			}
+			catch (...)
+			{
+				_pFile = new LogFile(_path);
+			}
+		}
+		if (_mapped) mapSegment(0);
+	}
+}
+
+
+void FileChannel::unsafeClose()
+{
+	delete _pFile;
+	_pFile = 0;
+
+	MappedLogFile* pMappedFile = _pMappedFile.load(std::memory_order_relaxed);
+	if (pMappedFile) pMappedFile->close();
+}
+
+
 bool FileChannel::setNoPurge(const std::string& value)
 {
 	if (value.empty() || 0 == icompare(value, "none"))
@@ -15,6 +15,7 @@
 #include "Poco/FormattingChannel.h"
 #include "Poco/Message.h"
 #include "Poco/LoggingRegistry.h"
+#include <vector>
 
 
 namespace Poco {
@@ -88,6 +89,31 @@ void FormattingChannel::log(const Message& msg)
 }
 
 
+void FormattingChannel::logBatch(const Message* pMessages, std::size_t count)
+{
+	if (_pChannel)
+	{
+		if (_pFormatter)
+		{
+			std::vector<Message> formatted;
+			formatted.reserve(count);
+			std::string text;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				text.clear();
+				_pFormatter->format(pMessages[i], text);
+				formatted.push_back(Message(pMessages[i], text));
+			}
+			_pChannel->logBatch(formatted.data(), formatted.size());
+		}
+		else
+		{
+			_pChannel->logBatch(pMessages, count);
+		}
+	}
+}
+
+
 void FormattingChannel::setProperty(const std::string& name, const std::string& value)
 {
 	if (name == "channel")
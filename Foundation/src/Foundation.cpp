@@ -89,9 +89,10 @@ RefCountDiagnosticContext& RefCountDiagnosticContext::get()
 //
 
 // static Logger members
-Logger::LoggerMapPtr Logger::_pLoggerMap;
-Mutex                Logger::_mapMtx;
-const std::string    Logger::ROOT;
+Logger::LoggerMapPtr              Logger::_pLoggerMap;
+std::atomic<Logger::LoggerIndex*> Logger::_pLoggerIndex(0);
+Mutex                             Logger::_mapMtx;
+const std::string                 Logger::ROOT;
 
 
 class AutoLoggerShutdown
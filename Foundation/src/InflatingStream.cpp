@@ -238,15 +238,20 @@ int InflatingStreamBuf::writeToDevice(const char* buffer, std::streamsize length
 			if (!_pOstr->good()) throw IOException(zError(rc));
 			break;
 		}
+		// No progress possible after the output buffer has been
+		// flushed, and all input has been consumed.
+		if (rc == Z_BUF_ERROR && _zstr.avail_in == 0) break;
 		if (rc != Z_OK) throw IOException(zError(rc));
 		if (_zstr.avail_out == 0)
 		{
+			// There may be more output pending, even if all
+			// input has been consumed, so call inflate() again.
 			_pOstr->write(_buffer, INFLATE_BUFFER_SIZE);
 			if (!_pOstr->good()) throw IOException(zError(rc));
 			_zstr.next_out  = (unsigned char*) _buffer;
 			_zstr.avail_out = INFLATE_BUFFER_SIZE;
 		}
-		if (_zstr.avail_in == 0)
+		else if (_zstr.avail_in == 0)
 		{
 			_pOstr->write(_buffer, INFLATE_BUFFER_SIZE - _zstr.avail_out);
 			if (!_pOstr->good()) throw IOException(zError(rc));
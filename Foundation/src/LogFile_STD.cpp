@@ -15,6 +15,8 @@
 #include "Poco/LogFile_STD.h"
 #include "Poco/File.h"
 #include "Poco/Exception.h"
+#include <unistd.h>
+#include <errno.h>
 
 
 namespace Poco {
@@ -55,6 +57,50 @@ void LogFileImpl::writeImpl(const std::string& text, bool flush)
 }
 
 
+void LogFileImpl::appendLineImpl(const std::string& text)
+{
+	_lines.append(text);
+	_lines.append(1, '\n');
+}
+
+
+void LogFileImpl::writeLinesImpl(bool /*flush*/)
+{
+	if (_lines.empty()) return;
+
+	if (!_str.good())
+	{
+		_str.close();
+		_str.open(_path, std::ios::app);
+	}
+	_str.flush();
+	if (!_str.good()) throw WriteFileException(_path);
+
+	// The file is opened with O_APPEND, so the lines can be
+	// written to the file descriptor directly, bypassing the
+	// stream buffer, which would split them into many writes.
+	// As with write(), the text is handed to the operating
+	// system, so there is nothing left to flush.
+	int fd = _str.nativeHandle();
+	const char* data = _lines.data();
+	std::size_t remaining = _lines.size();
+	while (remaining > 0)
+	{
+		ssize_t n = ::write(fd, data, remaining);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			_lines.clear();
+			throw WriteFileException(_path);
+		}
+		data += n;
+		remaining -= n;
+		_size += n;
+	}
+	_lines.clear();
+}
+
+
 UInt64 LogFileImpl::sizeImpl() const
 {
 	return _size;
@@ -57,6 +57,31 @@ void LogFileImpl::writeImpl(const std::string& text, bool flush)
 }
 
 
+void LogFileImpl::appendLineImpl(const std::string& text)
+{
+	_lines.append(text);
+	_lines.append("\r\n", 2);
+}
+
+
+void LogFileImpl::writeLinesImpl(bool flush)
+{
+	if (_lines.empty()) return;
+
+	if (INVALID_HANDLE_VALUE == _hFile)	createFile();
+
+	DWORD bytesWritten;
+	BOOL res = WriteFile(_hFile, _lines.data(), (DWORD) _lines.size(), &bytesWritten, NULL);
+	_lines.clear();
+	if (!res) throw WriteFileException(_path);
+	if (flush)
+	{
+		res = FlushFileBuffers(_hFile);
+		if (!res) throw WriteFileException(_path);
+	}
+}
+
+
 UInt64 LogFileImpl::sizeImpl() const
 {
 	if (INVALID_HANDLE_VALUE == _hFile)
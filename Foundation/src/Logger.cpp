@@ -19,11 +19,213 @@
 #include "Poco/NumberFormatter.h"
 #include "Poco/NumberParser.h"
 #include "Poco/String.h"
+#include <functional>
 
 
 namespace Poco {
 
 
+class Logger::LoggerIndex
+	/// An open-addressing hash table of Loggers that can be
+	/// searched without locking.
+	///
+	/// Loggers are added and removed in place by threads holding
+	/// _mapMtx. Removed Loggers leave a tombstone in their slot,
+	/// so that the probe sequences of other Loggers are not broken.
+	/// When the table becomes half full, it is replaced by a larger one.
+	///
+	/// Lock-free searches must be made within a ScopedLookup.
+	/// Removed Loggers and replaced tables are retired and only
+	/// released after a grace period, once all lookups that
+	/// may still see them have finished. Lookups are counted
+	/// separately for two alternating epochs. Objects retired in
+	/// one epoch are released when the next epoch has begun and
+	/// no lookup that started in the old epoch is in progress.
+{
+public:
+	class ScopedLookup
+		/// Marks a lock-free search of the current LoggerIndex.
+		/// Loggers found are valid until the ScopedLookup is destroyed.
+	{
+	public:
+		ScopedLookup()
+		{
+			for (;;)
+			{
+				_epoch = _currentEpoch.load();
+				++_lookups[_epoch];
+				if (_currentEpoch.load() == _epoch) break;
+				--_lookups[_epoch];
+			}
+		}
+
+		~ScopedLookup()
+		{
+			--_lookups[_epoch];
+		}
+
+		Logger* find(const std::string& name) const
+		{
+			LoggerIndex* pIndex = _pLoggerIndex.load();
+			if (pIndex)
+				return pIndex->find(name);
+			else
+				return 0;
+		}
+
+	private:
+		ScopedLookup(const ScopedLookup&);
+		ScopedLookup& operator = (const ScopedLookup&);
+
+		int _epoch;
+	};
+
+	LoggerIndex(std::size_t minCapacity, LoggerIndex* pPrevious):
+		_capacity(MIN_CAPACITY),
+		_used(0)
+	{
+		while (_capacity < minCapacity) _capacity *= 2;
+		_pSlots = new std::atomic<Logger*>[_capacity];
+		for (std::size_t i = 0; i < _capacity; ++i)
+		{
+			_pSlots[i].store(0, std::memory_order_relaxed);
+		}
+		if (pPrevious)
+		{
+			for (int epoch = 0; epoch < 2; ++epoch)
+			{
+				_retiredLoggers[epoch].swap(pPrevious->_retiredLoggers[epoch]);
+				_retiredIndexes[epoch].swap(pPrevious->_retiredIndexes[epoch]);
+			}
+			_retiredIndexes[_currentEpoch.load()].push_back(pPrevious);
+		}
+	}
+
+	~LoggerIndex()
+	{
+		delete [] _pSlots;
+		for (int epoch = 0; epoch < 2; ++epoch)
+		{
+			release(epoch);
+		}
+	}
+
+	Logger* find(const std::string& name) const
+	{
+		std::size_t i = hash(name);
+		for (;;)
+		{
+			Logger* pLogger = _pSlots[i].load(std::memory_order_acquire);
+			if (!pLogger) return 0;
+			if (pLogger != tombstone() && pLogger->_name == name) return pLogger;
+			i = (i + 1) & (_capacity - 1);
+		}
+	}
+
+	bool add(Logger* pLogger)
+		/// Adds the Logger, unless it would make the table more
+		/// than half full. Returns false in this case.
+	{
+		std::size_t i = hash(pLogger->_name);
+		for (;;)
+		{
+			Logger* pSlot = _pSlots[i].load(std::memory_order_relaxed);
+			if (pSlot == tombstone()) break;
+			if (!pSlot)
+			{
+				if (2*(_used + 1) > _capacity) return false;
+				++_used;
+				break;
+			}
+			i = (i + 1) & (_capacity - 1);
+		}
+		_pSlots[i].store(pLogger, std::memory_order_release);
+		return true;
+	}
+
+	void remove(Ptr pLogger)
+		/// Removes the Logger and retires it.
+	{
+		std::size_t i = hash(pLogger->_name);
+		for (;;)
+		{
+			Logger* pSlot = _pSlots[i].load(std::memory_order_relaxed);
+			if (!pSlot) return;
+			if (pSlot == pLogger)
+			{
+				_pSlots[i].store(tombstone());
+				_retiredLoggers[_currentEpoch.load()].push_back(pLogger);
+				return;
+			}
+			i = (i + 1) & (_capacity - 1);
+		}
+	}
+
+	void reclaim()
+		/// Releases the objects retired in the previous epoch if no
+		/// lookup started in that epoch is still in progress, and
+		/// begins a new epoch if objects have been retired in the
+		/// current one.
+		///
+		/// Must be called after the index has been published.
+	{
+		int epoch = _currentEpoch.load();
+		int previous = 1 - epoch;
+		if (_lookups[previous].load() == 0)
+		{
+			release(previous);
+			if (!_retiredLoggers[epoch].empty() || !_retiredIndexes[epoch].empty())
+			{
+				_currentEpoch.store(previous);
+			}
+		}
+	}
+
+private:
+	typedef std::vector<Ptr> LoggerVec;
+	typedef std::vector<LoggerIndex*> IndexVec;
+
+	enum
+	{
+		MIN_CAPACITY = 64
+	};
+
+	std::size_t hash(const std::string& name) const
+	{
+		return std::hash<std::string>()(name) & (_capacity - 1);
+	}
+
+	void release(int epoch)
+	{
+		_retiredLoggers[epoch].clear();
+		for (IndexVec::iterator it = _retiredIndexes[epoch].begin(); it != _retiredIndexes[epoch].end(); ++it)
+		{
+			delete *it;
+		}
+		_retiredIndexes[epoch].clear();
+	}
+
+	static Logger* tombstone()
+	{
+		static char marker;
+		return reinterpret_cast<Logger*>(&marker);
+	}
+
+	std::size_t           _capacity;
+	std::size_t           _used;
+	std::atomic<Logger*>* _pSlots;
+	LoggerVec             _retiredLoggers[2];
+	IndexVec              _retiredIndexes[2];
+
+	static std::atomic<int> _currentEpoch;
+	static std::atomic<int> _lookups[2];
+};
+
+
+std::atomic<int> Logger::LoggerIndex::_currentEpoch(0);
+std::atomic<int> Logger::LoggerIndex::_lookups[2] = {{0}, {0}};
+
+
 Logger::Logger(const std::string& name, Channel::Ptr pChannel, int level): _name(name), _pChannel(pChannel), _level(level)
 {
 }
@@ -48,7 +250,7 @@ Channel::Ptr Logger::getChannel() const
 
 void Logger::setLevel(int level)
 {
-	_level = level;
+	_level.store(level, std::memory_order_relaxed);
 }
 
 
@@ -71,7 +273,7 @@ void Logger::setProperty(const std::string& rName, const std::string& rValue)
 
 void Logger::log(const Message& msg)
 {
-	if (_level >= msg.getPriority() && _pChannel)
+	if (is(msg.getPriority()) && _pChannel)
 	{
 		_pChannel->log(msg);
 	}
@@ -92,7 +294,7 @@ void Logger::log(const Exception& exc, const char* file, int line)
 
 void Logger::dump(const std::string& msg, const void* buffer, std::size_t length, Message::Priority prio)
 {
-	if (_level >= prio && _pChannel)
+	if (is(prio) && _pChannel)
 	{
 		std::string text(msg);
 		formatDump(text, buffer, length);
@@ -273,6 +475,12 @@ void Logger::formatDump(std::string& message, const void* buffer, std::size_t le
 
 Logger& Logger::get(const std::string& name)
 {
+	{
+		LoggerIndex::ScopedLookup lookup;
+		Logger* pLogger = lookup.find(name);
+		if (pLogger) return *pLogger;
+	}
+
 	Mutex::ScopedLock lock(_mapMtx);
 
 	return unsafeGet(name);
@@ -312,6 +520,12 @@ Logger& Logger::create(const std::string& name, Channel::Ptr pChannel, int level
 
 Logger& Logger::root()
 {
+	{
+		LoggerIndex::ScopedLookup lookup;
+		Logger* pLogger = lookup.find(ROOT);
+		if (pLogger) return *pLogger;
+	}
+
 	Mutex::ScopedLock lock(_mapMtx);
 
 	return unsafeGet(ROOT);
@@ -320,6 +534,12 @@ Logger& Logger::root()
 
 Logger::Ptr Logger::has(const std::string& name)
 {
+	{
+		LoggerIndex::ScopedLookup lookup;
+		Logger* pLogger = lookup.find(name);
+		if (pLogger) return Ptr(pLogger, true);
+	}
+
 	Mutex::ScopedLock lock(_mapMtx);
 
 	return find(name);
@@ -330,6 +550,7 @@ void Logger::shutdown()
 {
 	Mutex::ScopedLock lock(_mapMtx);
 
+	delete _pLoggerIndex.exchange(0);
 	_pLoggerMap.reset();
 }
 
@@ -352,7 +573,13 @@ void Logger::destroy(const std::string& name)
 	if (_pLoggerMap)
 	{
 		LoggerMap::iterator it = _pLoggerMap->find(name);
-		if (it != _pLoggerMap->end()) _pLoggerMap->erase(it);
+		if (it != _pLoggerMap->end())
+		{
+			LoggerIndex* pIndex = _pLoggerIndex.load(std::memory_order_relaxed);
+			pIndex->remove(it->second);
+			_pLoggerMap->erase(it);
+			pIndex->reclaim();
+		}
 	}
 }
 
@@ -428,6 +655,18 @@ void Logger::add(Ptr pLogger)
 {
 	if (!_pLoggerMap) _pLoggerMap.reset(new LoggerMap);
 	_pLoggerMap->insert(LoggerMap::value_type(pLogger->name(), pLogger));
+
+	LoggerIndex* pIndex = _pLoggerIndex.load(std::memory_order_relaxed);
+	if (!pIndex || !pIndex->add(pLogger))
+	{
+		pIndex = new LoggerIndex(4*_pLoggerMap->size(), pIndex);
+		for (LoggerMap::iterator it = _pLoggerMap->begin(); it != _pLoggerMap->end(); ++it)
+		{
+			pIndex->add(it->second);
+		}
+		_pLoggerIndex.store(pIndex);
+	}
+	pIndex->reclaim();
 }
 
 
@@ -0,0 +1,60 @@
+//
+// LoggerHandle.cpp
+//
+// Library: Foundation
+// Package: Logging
+// Module:  LoggerHandle
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/LoggerHandle.h"
+
+
+namespace Poco {
+
+
+LoggerHandle::LoggerHandle(const std::string& name):
+	_pLogger(&Logger::get(name))
+{
+	_pLogger->duplicate();
+}
+
+
+LoggerHandle::LoggerHandle(Logger& logger):
+	_pLogger(&logger)
+{
+	_pLogger->duplicate();
+}
+
+
+LoggerHandle::LoggerHandle(const LoggerHandle& handle):
+	_pLogger(handle._pLogger)
+{
+	_pLogger->duplicate();
+}
+
+
+LoggerHandle::~LoggerHandle()
+{
+	_pLogger->release();
+}
+
+
+LoggerHandle& LoggerHandle::operator = (const LoggerHandle& handle)
+{
+	if (handle._pLogger != _pLogger)
+	{
+		handle._pLogger->duplicate();
+		_pLogger->release();
+		_pLogger = handle._pLogger;
+	}
+	return *this;
+}
+
+
+} // namespace Poco
@@ -15,6 +15,7 @@
 #include "Poco/LoggingFactory.h"
 #include "Poco/SingletonHolder.h"
 #include "Poco/AsyncChannel.h"
+#include "Poco/BatchingAsyncChannel.h"
 #include "Poco/ConsoleChannel.h"
 #include "Poco/FileChannel.h"
 #include "Poco/SimpleFileChannel.h"
@@ -30,6 +31,7 @@
 #include "Poco/WindowsConsoleChannel.h"
 #endif
 #include "Poco/PatternFormatter.h"
+#include "Poco/CompiledPatternFormatter.h"
 
 
 namespace Poco {
@@ -85,6 +87,7 @@ LoggingFactory& LoggingFactory::defaultFactory()
 void LoggingFactory::registerBuiltins()
 {
 	_channelFactory.registerClass("AsyncChannel", new Instantiator<AsyncChannel, Channel>);
+	_channelFactory.registerClass("BatchingAsyncChannel", new Instantiator<BatchingAsyncChannel, Channel>);
 #if defined(POCO_OS_FAMILY_WINDOWS) && !defined(_WIN32_WCE)
 	_channelFactory.registerClass("ConsoleChannel", new Instantiator<WindowsConsoleChannel, Channel>);
 	_channelFactory.registerClass("ColorConsoleChannel", new Instantiator<WindowsColorConsoleChannel, Channel>);
@@ -115,6 +118,7 @@ void LoggingFactory::registerBuiltins()
 #endif
 
 	_formatterFactory.registerClass("PatternFormatter", new Instantiator<PatternFormatter, Formatter>);
+	_formatterFactory.registerClass("CompiledPatternFormatter", new Instantiator<CompiledPatternFormatter, Formatter>);
 }
 
 
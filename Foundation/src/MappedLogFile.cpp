@@ -0,0 +1,128 @@
+//
+// MappedLogFile.cpp
+//
+// Library: Foundation
+// Package: Logging
+// Module:  MappedLogFile
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/MappedLogFile.h"
+#include "Poco/File.h"
+#include "Poco/Thread.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace Poco {
+
+
+MappedLogFile::MappedLogFile():
+	_pData(0),
+	_capacity(0),
+	_writePos(0),
+	_endPos(0),
+	_writers(0),
+	_open(false)
+{
+}
+
+
+MappedLogFile::~MappedLogFile()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void MappedLogFile::open(const std::string& path, std::size_t segmentSize)
+{
+	poco_assert (!_open.load(std::memory_order_relaxed));
+	poco_assert (segmentSize > 0);
+
+	File file(path);
+	file.createFile();
+	UInt64 size = file.getSize();
+	file.setSize(size + segmentSize);
+	SharedMemory memory(file, SharedMemory::AM_WRITE);
+
+	// Skip NUL bytes at the end of the file, which were left
+	// by a process that did not close the file properly.
+	char* pData = memory.begin();
+	while (size > 0 && pData[size - 1] == 0) --size;
+
+	_path     = path;
+	_pData    = pData;
+	_capacity = size + segmentSize;
+	_memory.swap(memory);
+	_writePos.store(size, std::memory_order_relaxed);
+	_endPos.store(_capacity, std::memory_order_relaxed);
+	_open.store(true, std::memory_order_seq_cst);
+}
+
+
+void MappedLogFile::close()
+{
+	if (!_open.load(std::memory_order_relaxed)) return;
+
+	// Writers announce themselves in _writers before checking
+	// _open, so after this loop no writer can access the mapping.
+	_open.store(false, std::memory_order_seq_cst);
+	while (_writers.load(std::memory_order_seq_cst) > 0)
+	{
+		Thread::yield();
+	}
+
+	UInt64 size = std::min(_writePos.load(std::memory_order_relaxed), _endPos.load(std::memory_order_relaxed));
+	_writePos.store(size, std::memory_order_relaxed);
+	_pData = 0;
+	_capacity = 0;
+	SharedMemory().swap(_memory);
+	File(_path).setSize(size);
+}
+
+
+bool MappedLogFile::write(const std::string& text)
+{
+	bool written = false;
+	_writers.fetch_add(1, std::memory_order_seq_cst);
+	if (_open.load(std::memory_order_seq_cst))
+	{
+		UInt64 length = text.size() + 1;
+		UInt64 pos = _writePos.fetch_add(length, std::memory_order_relaxed);
+		if (pos + length <= _capacity)
+		{
+			std::memcpy(_pData + pos, text.data(), text.size());
+			_pData[pos + text.size()] = '\n';
+			written = true;
+		}
+		else if (pos < _capacity)
+		{
+			// This is the only reservation that crosses the end
+			// of the segment. The text written ends here.
+			_endPos.store(pos, std::memory_order_relaxed);
+		}
+	}
+	_writers.fetch_sub(1, std::memory_order_release);
+	return written;
+}
+
+
+UInt64 MappedLogFile::size() const
+{
+	return std::min(_writePos.load(std::memory_order_relaxed), _endPos.load(std::memory_order_relaxed));
+}
+
+
+} // namespace Poco
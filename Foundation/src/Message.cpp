@@ -70,6 +70,7 @@ Message::Message(const std::string& source, const std::string& text, Priority pr
 Message::Message(const Message& msg):
 	_source(msg._source),
 	_text(msg._text),
+	_deferred(msg._deferred),
 	_prio(msg._prio),
 	_time(msg._time),
 	_tid(msg._tid),
@@ -89,6 +90,7 @@ Message::Message(const Message& msg):
 Message::Message(Message&& msg) :
 	_source(std::move(msg._source)),
 	_text(std::move(msg._text)),
+	_deferred(msg._deferred),
 	_prio(std::move(msg._prio)),
 	_time(std::move(msg._time)),
 	_tid(std::move(msg._tid)),
@@ -142,12 +144,43 @@ void Message::init()
 }
 
 
+void Message::formatText() const
+{
+	_deferred.format(_text);
+	_deferred.clear();
+}
+
+
 Message& Message::operator = (const Message& msg)
 {
 	if (&msg != this)
 	{
-		Message tmp(msg);
-		swap(tmp);
+		// Assign member-wise, so that the strings can reuse their
+		// storage (e.g., for the preallocated messages of
+		// BatchingAsyncChannel).
+		_source = msg._source;
+		_text   = msg._text;
+		_deferred = msg._deferred;
+		_prio   = msg._prio;
+		_time   = msg._time;
+		_tid    = msg._tid;
+		_ostid  = msg._ostid;
+		_thread = msg._thread;
+		_pid    = msg._pid;
+		_file   = msg._file;
+		_line   = msg._line;
+		if (msg._pMap)
+		{
+			if (_pMap)
+				*_pMap = *msg._pMap;
+			else
+				_pMap = new StringMap(*msg._pMap);
+		}
+		else
+		{
+			delete _pMap;
+			_pMap = 0;
+		}
 	}
 	return *this;
 }
@@ -159,6 +192,7 @@ Message& Message::operator = (Message&& msg)
 	{
 		_source = std::move(msg._source);
 		_text = std::move(msg._text);
+		_deferred = msg._deferred;
 		_prio = std::move(msg._prio);
 		_time = std::move(msg._time);
 		_tid = std::move(msg._tid);
@@ -179,6 +213,7 @@ void Message::swap(Message& msg)
 	using std::swap;
 	swap(_source, msg._source);
 	swap(_text, msg._text);
+	swap(_deferred, msg._deferred);
 	swap(_prio, msg._prio);
 	swap(_time, msg._time);
 	swap(_tid, msg._tid);
@@ -199,6 +234,7 @@ void Message::setSource(const std::string& src)
 void Message::setText(const std::string& text)
 {
 	_text = text;
+	_deferred.clear();
 }
 
 
@@ -13,24 +13,36 @@
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/SplitterChannel.h"
 #include "Poco/AsyncChannel.h"
+#include "Poco/BatchingAsyncChannel.h"
 #include "Poco/AutoPtr.h"
 #include "Poco/Message.h"
 #include "Poco/Formatter.h"
 #include "Poco/FormattingChannel.h"
 #include "Poco/ConsoleChannel.h"
 #include "Poco/StreamChannel.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
 #include "TestChannel.h"
 #include <sstream>
+#include <vector>
 
 
 using Poco::SplitterChannel;
 using Poco::AsyncChannel;
+using Poco::BatchingAsyncChannel;
 using Poco::FormattingChannel;
 using Poco::ConsoleChannel;
 using Poco::StreamChannel;
 using Poco::Formatter;
 using Poco::Message;
 using Poco::AutoPtr;
+using Poco::Thread;
+using Poco::Event;
+using Poco::NumberFormatter;
+using Poco::NumberParser;
 
 
 class SimpleFormatter: public Formatter
@@ -45,6 +57,75 @@ public:
 };
 
 
+namespace
+{
+	class BatchChannel: public Poco::Channel
+		/// Records the messages and the sizes of the batches
+		/// it receives. Can be made to block in logBatch().
+	{
+	public:
+		typedef AutoPtr<BatchChannel> Ptr;
+
+		BatchChannel(bool block = false):
+			_block(block)
+		{
+		}
+
+		void log(const Message& msg)
+		{
+			logBatch(&msg, 1);
+		}
+
+		void logBatch(const Message* pMessages, std::size_t count)
+		{
+			_batches.push_back(count);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				_messages.push_back(pMessages[i]);
+			}
+			if (_block)
+			{
+				_block = false;
+				_entered.set();
+				_release.wait();
+			}
+		}
+
+		void waitEntered()
+		{
+			_entered.wait();
+		}
+
+		void unblock()
+		{
+			_release.set();
+		}
+
+		const std::vector<Message>& messages() const
+		{
+			return _messages;
+		}
+
+		const std::vector<std::size_t>& batches() const
+		{
+			return _batches;
+		}
+
+	protected:
+		~BatchChannel()
+		{
+		}
+
+	private:
+		bool _block;
+		Event _entered;
+		Event _release;
+		std::vector<Message> _messages;
+		std::vector<std::size_t> _batches;
+	};
+}
+
+
 ChannelTest::ChannelTest(const std::string& rName): CppUnit::TestCase(rName)
 {
 }
@@ -80,6 +161,174 @@ void ChannelTest::testAsync()
 }
 
 
+void ChannelTest::testBatchingAsync()
+{
+	BatchChannel::Ptr pChannel = new BatchChannel;
+	AutoPtr<BatchingAsyncChannel> pAsync = new BatchingAsyncChannel(pChannel);
+	pAsync->setCapacity(64);
+	pAsync->setBatchSize(16);
+	pAsync->open();
+	for (int i = 0; i < 1000; ++i)
+	{
+		pAsync->log(Message("Source", NumberFormatter::format(i), Message::PRIO_INFORMATION));
+	}
+	pAsync->close();
+	assertTrue (pChannel->messages().size() == 1000);
+	for (int i = 0; i < 1000; ++i)
+	{
+		assertTrue (pChannel->messages()[i].getText() == NumberFormatter::format(i));
+	}
+	for (std::vector<std::size_t>::const_iterator it = pChannel->batches().begin(); it != pChannel->batches().end(); ++it)
+	{
+		assertTrue (*it >= 1 && *it <= 16);
+	}
+	assertTrue (pAsync->droppedMessages() == 0);
+
+	// the channel is reopened by log()
+	pAsync->log(Message("Source", "1000", Message::PRIO_INFORMATION));
+	pAsync->close();
+	assertTrue (pChannel->messages().size() == 1001);
+	assertTrue (pChannel->messages().back().getText() == "1000");
+}
+
+
+void ChannelTest::testBatchingAsyncMultiThreaded()
+{
+	const int threadCount = 4;
+	const int messageCount = 5000;
+
+	BatchChannel::Ptr pChannel = new BatchChannel;
+	AutoPtr<BatchingAsyncChannel> pAsync = new BatchingAsyncChannel(pChannel);
+	pAsync->setCapacity(16);
+	pAsync->open();
+
+	BatchingAsyncChannel* pAsyncChannel = pAsync.get();
+	Thread threads[threadCount];
+	for (int t = 0; t < threadCount; ++t)
+	{
+		std::string source = NumberFormatter::format(t);
+		threads[t].startFunc([pAsyncChannel, source, messageCount]()
+		{
+			for (int i = 0; i < messageCount; ++i)
+			{
+				pAsyncChannel->log(Message(source, NumberFormatter::format(i), Message::PRIO_INFORMATION));
+			}
+		});
+	}
+	for (int t = 0; t < threadCount; ++t)
+	{
+		threads[t].join();
+	}
+	pAsync->close();
+
+	assertTrue (pAsync->droppedMessages() == 0);
+	assertTrue (pChannel->messages().size() == threadCount*messageCount);
+	std::vector<int> next(threadCount, 0);
+	for (std::vector<Message>::const_iterator it = pChannel->messages().begin(); it != pChannel->messages().end(); ++it)
+	{
+		int t = NumberParser::parse(it->getSource());
+		assertTrue (NumberParser::parse(it->getText()) == next[t]);
+		++next[t];
+	}
+}
+
+
+void ChannelTest::testBatchingAsyncOverflow()
+{
+	BatchChannel::Ptr pChannel = new BatchChannel(true);
+	AutoPtr<BatchingAsyncChannel> pAsync = new BatchingAsyncChannel(pChannel);
+	pAsync->setCapacity(4);
+	pAsync->setOverflowPolicy(BatchingAsyncChannel::OVERFLOW_DROP);
+	pAsync->open();
+	pAsync->log(Message("Source", "0", Message::PRIO_INFORMATION));
+	pChannel->waitEntered();
+
+	// The first message still occupies its slot while
+	// it is being logged, so there is room for three more.
+	for (int i = 1; i <= 10; ++i)
+	{
+		pAsync->log(Message("Source", NumberFormatter::format(i), Message::PRIO_INFORMATION));
+	}
+	assertTrue (pAsync->droppedMessages() == 7);
+	pChannel->unblock();
+	pAsync->close();
+
+	// the drops are reported after the first batch
+	assertTrue (pChannel->messages().size() == 5);
+	assertTrue (pChannel->messages()[0].getText() == "0");
+	assertTrue (pChannel->messages()[1].getPriority() == Message::PRIO_WARNING);
+	assertTrue (pChannel->messages()[1].getText() == "7 log messages have been dropped");
+	for (int i = 1; i < 4; ++i)
+	{
+		assertTrue (pChannel->messages()[i + 1].getText() == NumberFormatter::format(i));
+	}
+
+	pChannel = new BatchChannel(true);
+	pAsync = new BatchingAsyncChannel(pChannel);
+	pAsync->setCapacity(64);
+	pAsync->setOverflowPolicy(BatchingAsyncChannel::OVERFLOW_SAMPLE);
+	pAsync->setSampleRate(4);
+	pAsync->open();
+	pAsync->log(Message("Source", "0", Message::PRIO_INFORMATION));
+	pChannel->waitEntered();
+
+	// Until 48 slots are used all messages are queued,
+	// then one out of four.
+	for (int i = 1; i < 100; ++i)
+	{
+		pAsync->log(Message("Source", NumberFormatter::format(i), Message::PRIO_INFORMATION));
+	}
+	assertTrue (pAsync->droppedMessages() == 39);
+	pChannel->unblock();
+	pAsync->close();
+
+	assertTrue (pChannel->messages().size() == 62);
+	assertTrue (pChannel->messages()[1].getText() == "39 log messages have been dropped");
+	assertTrue (pChannel->messages()[48].getText() == "47");
+	assertTrue (pChannel->messages()[49].getText() == "48");
+	assertTrue (pChannel->messages()[50].getText() == "52");
+	assertTrue (pChannel->messages().back().getText() == "96");
+}
+
+
+void ChannelTest::testBatchingAsyncProperties()
+{
+	AutoPtr<BatchingAsyncChannel> pAsync = new BatchingAsyncChannel;
+	assertTrue (pAsync->getProperty(BatchingAsyncChannel::PROP_CAPACITY) == "8192");
+	assertTrue (pAsync->getProperty(BatchingAsyncChannel::PROP_OVERFLOW) == "block");
+	assertTrue (pAsync->getProperty(BatchingAsyncChannel::PROP_BATCHSIZE) == "512");
+
+	pAsync->setProperty(BatchingAsyncChannel::PROP_CAPACITY, "1000");
+	assertTrue (pAsync->getCapacity() == 1024);
+	pAsync->setProperty(BatchingAsyncChannel::PROP_OVERFLOW, "sample");
+	assertTrue (pAsync->getOverflowPolicy() == BatchingAsyncChannel::OVERFLOW_SAMPLE);
+	pAsync->setProperty(BatchingAsyncChannel::PROP_SAMPLERATE, "100");
+	assertTrue (pAsync->getProperty(BatchingAsyncChannel::PROP_SAMPLERATE) == "100");
+	pAsync->setProperty(BatchingAsyncChannel::PROP_BATCHSIZE, "64");
+	assertTrue (pAsync->getBatchSize() == 64);
+
+	try
+	{
+		pAsync->setProperty(BatchingAsyncChannel::PROP_OVERFLOW, "wait");
+		fail("invalid overflow policy - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	pAsync->open();
+	try
+	{
+		pAsync->setCapacity(16);
+		fail("channel is open - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+	pAsync->close();
+}
+
+
 void ChannelTest::testFormatting()
 {
 	AutoPtr<TestChannel> pChannel = new TestChannel;
@@ -92,6 +341,23 @@ void ChannelTest::testFormatting()
 }
 
 
+void ChannelTest::testFormattingBatch()
+{
+	BatchChannel::Ptr pChannel = new BatchChannel;
+	AutoPtr<Formatter> pFormatter = new SimpleFormatter;
+	AutoPtr<FormattingChannel> pFormatterChannel = new FormattingChannel(pFormatter, pChannel);
+	std::vector<Message> messages;
+	messages.push_back(Message("Source1", "Text1", Message::PRIO_INFORMATION));
+	messages.push_back(Message("Source2", "Text2", Message::PRIO_WARNING));
+	pFormatterChannel->logBatch(&messages[0], messages.size());
+	assertTrue (pChannel->batches().size() == 1);
+	assertTrue (pChannel->batches()[0] == 2);
+	assertTrue (pChannel->messages()[0].getText() == "Source1: Text1");
+	assertTrue (pChannel->messages()[1].getText() == "Source2: Text2");
+	assertTrue (pChannel->messages()[1].getPriority() == Message::PRIO_WARNING);
+}
+
+
 void ChannelTest::testConsole()
 {
 	AutoPtr<ConsoleChannel> pChannel = new ConsoleChannel;
@@ -130,7 +396,12 @@ CppUnit::Test* ChannelTest::suite()
 
 	CppUnit_addTest(pSuite, ChannelTest, testSplitter);
 	CppUnit_addTest(pSuite, ChannelTest, testAsync);
+	CppUnit_addTest(pSuite, ChannelTest, testBatchingAsync);
+	CppUnit_addTest(pSuite, ChannelTest, testBatchingAsyncMultiThreaded);
+	CppUnit_addTest(pSuite, ChannelTest, testBatchingAsyncOverflow);
+	CppUnit_addTest(pSuite, ChannelTest, testBatchingAsyncProperties);
 	CppUnit_addTest(pSuite, ChannelTest, testFormatting);
+	CppUnit_addTest(pSuite, ChannelTest, testFormattingBatch);
 	CppUnit_addTest(pSuite, ChannelTest, testConsole);
 	CppUnit_addTest(pSuite, ChannelTest, testStream);
 
@@ -26,6 +26,11 @@ public:
 
 	void testSplitter();
 	void testAsync();
+	void testBatchingAsync();
+	void testBatchingAsyncMultiThreaded();
+	void testBatchingAsyncOverflow();
+	void testBatchingAsyncProperties();
+	void testFormattingBatch();
 	void testFormatting();
 	void testConsole();
 	void testStream();
@@ -26,7 +26,10 @@
 #include "Poco/NumberFormatter.h"
 #include "Poco/DirectoryIterator.h"
 #include "Poco/Exception.h"
+#include "Poco/FileStream.h"
+#include "Poco/Runnable.h"
 #include <vector>
+#include <set>
 
 
 using Poco::FileChannel;
@@ -44,6 +47,36 @@ using Poco::DateTimeFormatter;
 using Poco::DateTimeFormat;
 using Poco::DirectoryIterator;
 using Poco::InvalidArgumentException;
+using Poco::FileInputStream;
+using Poco::FileOutputStream;
+
+
+namespace
+{
+	class MappedLogRunnable: public Poco::Runnable
+	{
+	public:
+		MappedLogRunnable(FileChannel& channel, int id, int count):
+			_channel(channel),
+			_id(id),
+			_count(count)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < _count; ++i)
+			{
+				_channel.log(Message("source", NumberFormatter::format(_id) + ":" + NumberFormatter::format0(i, 5), Message::PRIO_INFORMATION));
+			}
+		}
+
+	private:
+		FileChannel& _channel;
+		int _id;
+		int _count;
+	};
+}
 
 
 FileChannelTest::FileChannelTest(const std::string& rName): CppUnit::TestCase(rName)
@@ -544,6 +577,190 @@ void FileChannelTest::testWrongPurgeOption()
 }
 
 
+void FileChannelTest::testLogBatch()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<FileChannel> pChannel = new FileChannel(name);
+		pChannel->setProperty(FileChannel::PROP_ROTATION, "2 K");
+		pChannel->open();
+		std::vector<Message> messages;
+		for (int i = 0; i < 100; ++i)
+		{
+			messages.push_back(Message("source", "This is log file entry " + NumberFormatter::format0(i, 2), Message::PRIO_INFORMATION));
+		}
+		pChannel->logBatch(&messages[0], messages.size());
+		pChannel->close();
+
+		// rotation is only checked before a batch
+		File f(name + ".0");
+		assertTrue (!f.exists());
+
+		FileInputStream istr(name);
+		std::string line;
+		int n = 0;
+		while (std::getline(istr, line))
+		{
+			assertTrue (line == "This is log file entry " + NumberFormatter::format0(n, 2));
+			++n;
+		}
+		assertTrue (n == 100);
+		istr.close();
+
+		pChannel->open();
+		pChannel->logBatch(&messages[0], 1);
+		pChannel->close();
+		assertTrue (f.exists());
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void FileChannelTest::testMapped()
+{
+	std::string name = filename();
+	try
+	{
+		{
+			// simulate a log file left by a process that did not close it
+			FileOutputStream ostr(name);
+			ostr << "previous entry\n" << std::string(100, '\0');
+		}
+		AutoPtr<FileChannel> pChannel = new FileChannel(name);
+		pChannel->setProperty(FileChannel::PROP_MAPPED, "true");
+		pChannel->setProperty(FileChannel::PROP_SEGMENTSIZE, "1 K");
+		assertTrue (pChannel->getProperty(FileChannel::PROP_SEGMENTSIZE) == "1024");
+		pChannel->open();
+		for (int i = 0; i < 100; ++i)
+		{
+			pChannel->log(Message("source", "This is log file entry " + NumberFormatter::format0(i, 2), Message::PRIO_INFORMATION));
+		}
+		assertTrue (pChannel->size() == 15 + 100*26);
+		pChannel->close();
+		assertTrue (File(name).getSize() == 15 + 100*26);
+
+		FileInputStream istr(name);
+		std::string line;
+		std::getline(istr, line);
+		assertTrue (line == "previous entry");
+		int n = 0;
+		while (std::getline(istr, line))
+		{
+			assertTrue (line == "This is log file entry " + NumberFormatter::format0(n, 2));
+			++n;
+		}
+		assertTrue (n == 100);
+
+		try
+		{
+			pChannel->setProperty(FileChannel::PROP_SEGMENTSIZE, "0");
+			fail("must throw");
+		}
+		catch (InvalidArgumentException&)
+		{
+		}
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void FileChannelTest::testMappedMultiThreaded()
+{
+	const int THREADS = 4;
+	const int COUNT = 2000;
+
+	std::string name = filename();
+	try
+	{
+		AutoPtr<FileChannel> pChannel = new FileChannel(name);
+		pChannel->setProperty(FileChannel::PROP_MAPPED, "true");
+		pChannel->setProperty(FileChannel::PROP_SEGMENTSIZE, "4 K");
+		pChannel->open();
+		std::vector<MappedLogRunnable*> runnables;
+		std::vector<Thread*> threads;
+		for (int i = 0; i < THREADS; ++i)
+		{
+			runnables.push_back(new MappedLogRunnable(*pChannel, i, COUNT));
+			threads.push_back(new Thread);
+			threads.back()->start(*runnables.back());
+		}
+		for (int i = 0; i < THREADS; ++i)
+		{
+			threads[i]->join();
+			delete threads[i];
+			delete runnables[i];
+		}
+		pChannel->close();
+
+		FileInputStream istr(name);
+		std::set<std::string> lines;
+		std::string line;
+		while (std::getline(istr, line))
+		{
+			lines.insert(line);
+		}
+		assertTrue (lines.size() == THREADS*COUNT);
+		for (int i = 0; i < THREADS; ++i)
+		{
+			assertTrue (lines.count(NumberFormatter::format(i) + ":" + NumberFormatter::format0(0, 5)) == 1);
+			assertTrue (lines.count(NumberFormatter::format(i) + ":" + NumberFormatter::format0(COUNT - 1, 5)) == 1);
+		}
+		assertTrue (File(name).getSize() == THREADS*COUNT*8);
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void FileChannelTest::testMappedRotate()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<FileChannel> pChannel = new FileChannel(name);
+		pChannel->setProperty(FileChannel::PROP_MAPPED, "true");
+		pChannel->setProperty(FileChannel::PROP_SEGMENTSIZE, "1 K");
+		pChannel->setProperty(FileChannel::PROP_ROTATION, "2 K");
+		pChannel->setProperty(FileChannel::PROP_ARCHIVE, "number");
+		pChannel->setProperty(FileChannel::PROP_COMPRESS, "true");
+		pChannel->open();
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 400; ++i)
+		{
+			pChannel->log(msg);
+		}
+		pChannel->close();
+		Thread::sleep(3000); // allow time for background compression
+		File f0(name + ".0.gz");
+		assertTrue (f0.exists());
+		File f1(name + ".1.gz");
+		assertTrue (f1.exists());
+		assertTrue (File(name).getSize() <= 3*1024);
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
 void FileChannelTest::setUp()
 {
 }
@@ -647,6 +864,10 @@ CppUnit::Test* FileChannelTest::suite()
 	CppUnit_addTest(pSuite, FileChannelTest, testPurgeAge);
 	CppUnit_addTest(pSuite, FileChannelTest, testPurgeCount);
 	CppUnit_addTest(pSuite, FileChannelTest, testWrongPurgeOption);
+	CppUnit_addTest(pSuite, FileChannelTest, testLogBatch);
+	CppUnit_addTest(pSuite, FileChannelTest, testMapped);
+	CppUnit_addTest(pSuite, FileChannelTest, testMappedMultiThreaded);
+	CppUnit_addTest(pSuite, FileChannelTest, testMappedRotate);
 
 	return pSuite;
 }
@@ -44,6 +44,10 @@ public:
 	void testPurgeAge();
 	void testPurgeCount();
 	void testWrongPurgeOption();
+	void testLogBatch();
+	void testMapped();
+	void testMappedMultiThreaded();
+	void testMappedRotate();
 
 	void setUp();
 	void tearDown();
@@ -13,10 +13,12 @@
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/Any.h"
 #include "Poco/Format.h"
+#include "Poco/DeferredFormat.h"
 #include "Poco/Exception.h"
 
 
 using Poco::format;
+using Poco::DeferredFormat;
 using Poco::BadCastException;
 using Poco::Int64;
 using Poco::UInt64;
@@ -450,6 +452,54 @@ void FormatTest::testIndex()
 }
 
 
+void FormatTest::testDeferred()
+{
+	DeferredFormat df;
+	assertTrue (df.empty());
+	std::string s;
+	df.format(s);
+	assertTrue (s.empty());
+
+	assertTrue (df.capture("%d %u %ld %lu %Ld %hd %c %b", -1, 2u, -3L, 4UL, Int64(-5), short(6), 'x', true));
+	assertTrue (!df.empty());
+	df.format(s);
+	assertTrue (s == format("%d %u %ld %lu %Ld %hd %c %b", -1, 2u, -3L, 4UL, Int64(-5), short(6), 'x', true));
+	assertTrue (s == "-1 2 -3 4 -5 6 x 1");
+
+	std::string str("foo");
+	const char* cstr = "bar";
+	assertTrue (df.capture("%s %s %s %.2f %.1hf %?d", str, cstr, "baz", 1.5, 2.5f, UInt64(7)));
+	DeferredFormat copy(df);
+	df.clear();
+	assertTrue (df.empty());
+	s.clear();
+	copy.format(s);
+	assertTrue (s == "foo bar baz 1.50 2.5 7");
+
+	df = copy;
+	s.clear();
+	df.format(s);
+	assertTrue (s == "foo bar baz 1.50 2.5 7");
+
+	// too many arguments
+	assertTrue (!df.capture("%d%d%d%d%d%d%d%d%d", 1, 2, 3, 4, 5, 6, 7, 8, 9));
+	assertTrue (df.empty());
+
+	// unsupported argument type
+	assertTrue (!df.capture("%s", Poco::Any(1)));
+	assertTrue (df.empty());
+
+	// arguments do not fit into the buffer
+	std::string longStr(DeferredFormat::BUFFER_SIZE, 'x');
+	assertTrue (!df.capture("%s", longStr));
+	assertTrue (df.empty());
+
+	s.clear();
+	DeferredFormat::formatNow(s, "%s %s %d", longStr, "bar", 42);
+	assertTrue (s == longStr + " bar 42");
+}
+
+
 void FormatTest::setUp()
 {
 }
@@ -473,6 +523,7 @@ CppUnit::Test* FormatTest::suite()
 	CppUnit_addTest(pSuite, FormatTest, testString);
 	CppUnit_addTest(pSuite, FormatTest, testMultiple);
 	CppUnit_addTest(pSuite, FormatTest, testIndex);
+	CppUnit_addTest(pSuite, FormatTest, testDeferred);
 
 	return pSuite;
 }
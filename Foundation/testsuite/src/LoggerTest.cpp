@@ -13,13 +13,59 @@
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/Logger.h"
 #include "Poco/AutoPtr.h"
+#include "Poco/AsyncChannel.h"
+#include "Poco/LoggerHandle.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
 #include "TestChannel.h"
+#include <atomic>
 
 
 using Poco::Logger;
+using Poco::LoggerHandle;
 using Poco::Channel;
 using Poco::Message;
 using Poco::AutoPtr;
+using Poco::AsyncChannel;
+using Poco::Thread;
+using Poco::Runnable;
+
+
+namespace
+{
+	class LoggerGetRunnable: public Runnable
+	{
+	public:
+		LoggerGetRunnable(int id): _id(id), _failed(false)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < 1000; ++i)
+			{
+				std::string name("LoggerTest.Logger");
+				name += std::to_string(i % 100);
+				Logger& logger = Logger::get(name);
+				if (logger.name() != name) _failed = true;
+				if (&Logger::get(name) != &logger) _failed = true;
+
+				name += '.';
+				name += std::to_string(_id);
+				if (Logger::get(name).name() != name) _failed = true;
+			}
+		}
+
+		bool failed() const
+		{
+			return _failed;
+		}
+
+	private:
+		int _id;
+		std::atomic<bool> _failed;
+	};
+}
 
 
 LoggerTest::LoggerTest(const std::string& rName): CppUnit::TestCase(rName)
@@ -249,6 +295,156 @@ void LoggerTest::testFormatAny()
 }
 
 
+void LoggerTest::testLogDeferred()
+{
+	AutoPtr<TestChannel> pChannel = new TestChannel;
+	Logger& root = Logger::root();
+	root.setChannel(pChannel);
+	root.setLevel(Message::PRIO_INFORMATION);
+
+	root.logDeferred(Message::PRIO_DEBUG, "%s: %d", std::string("foo"), 42);
+	assertTrue (pChannel->list().empty());
+
+	root.logDeferred(Message::PRIO_ERROR, "%s: %d", std::string("foo"), 42);
+	assertTrue (pChannel->list().size() == 1);
+	Message& msg = pChannel->list().back();
+	assertTrue (msg.isDeferred());
+	assertTrue (msg.getPriority() == Message::PRIO_ERROR);
+	assertTrue (msg.getText() == "foo: 42");
+	assertTrue (!msg.isDeferred());
+	assertTrue (msg.getText() == "foo: 42");
+
+	std::string longText(1000, 'x');
+	root.logDeferred(Message::PRIO_ERROR, "%s %s", longText, "bar");
+	assertTrue (pChannel->list().size() == 2);
+	assertTrue (!pChannel->list().back().isDeferred());
+	assertTrue (pChannel->list().back().getText() == longText + " bar");
+
+	Message copy;
+	assertTrue (copy.deferText("%d-%d", 1, 2));
+	copy.setText("text");
+	assertTrue (!copy.isDeferred());
+	assertTrue (copy.getText() == "text");
+
+	pChannel->clear();
+	AutoPtr<AsyncChannel> pAsync = new AsyncChannel(pChannel);
+	root.setChannel(pAsync);
+	for (int i = 0; i < 10; ++i)
+	{
+		root.logDeferred(Message::PRIO_INFORMATION, "message %d from %s", i, "test");
+	}
+	pAsync->close();
+	assertTrue (pChannel->list().size() == 10);
+	assertTrue (pChannel->list().front().getText() == "message 0 from test");
+	assertTrue (pChannel->list().back().getText() == "message 9 from test");
+	root.setChannel(pChannel);
+}
+
+
+void LoggerTest::testLoggerHandle()
+{
+	AutoPtr<TestChannel> pChannel = new TestChannel;
+	Logger& root = Logger::root();
+	root.setChannel(pChannel);
+	root.setLevel(Message::PRIO_INFORMATION);
+
+	LoggerHandle handle("Handle.Logger");
+	assertTrue (&handle.logger() == &Logger::get("Handle.Logger"));
+	assertTrue (handle->name() == "Handle.Logger");
+	assertTrue (handle.is(Message::PRIO_INFORMATION));
+	assertTrue (!handle.is(Message::PRIO_DEBUG));
+
+	Logger::setLevel("Handle", Message::PRIO_DEBUG);
+	assertTrue (handle.is(Message::PRIO_DEBUG));
+	Logger::setLevel("", Message::PRIO_ERROR);
+	assertTrue (!handle.is(Message::PRIO_WARNING));
+
+	(*handle).error("error");
+	assertTrue (pChannel->list().size() == 1);
+	assertTrue (pChannel->list().back().getSource() == "Handle.Logger");
+
+	LoggerHandle copy(handle);
+	assertTrue (&copy.logger() == &handle.logger());
+	LoggerHandle other(root);
+	other = handle;
+	assertTrue (&other.logger() == &handle.logger());
+
+	Logger::destroy("Handle.Logger");
+	assertTrue (Logger::has("Handle.Logger").isNull());
+	assertTrue (handle->getChannel().get() == pChannel.get());
+	(*handle).error("error");
+	assertTrue (pChannel->list().size() == 2);
+	Logger& logger = Logger::get("Handle.Logger");
+	assertTrue (&logger != &handle.logger());
+	assertTrue (logger.getChannel().get() == pChannel.get());
+	assertTrue (logger.getLevel() == Message::PRIO_ERROR);
+}
+
+
+void LoggerTest::testDestroy()
+{
+	AutoPtr<TestChannel> pChannel = new TestChannel;
+	int rc = pChannel->referenceCount();
+	for (int i = 0; i < 1000; ++i)
+	{
+		std::string name("LoggerTest.Destroy");
+		name += std::to_string(i);
+		Logger::create(name, pChannel);
+		Logger::destroy(name);
+		assertTrue (!Logger::has(name));
+	}
+	assertTrue (pChannel->referenceCount() <= rc + 1);
+}
+
+
+void LoggerTest::testGetConcurrent()
+{
+	for (int i = 0; i < 200; ++i)
+	{
+		std::string name("LoggerTest.Logger");
+		name += std::to_string(i);
+		Logger::get(name).setLevel(Message::PRIO_DEBUG);
+		assertTrue (Logger::has(name));
+	}
+	for (int i = 100; i < 200; ++i)
+	{
+		std::string name("LoggerTest.Logger");
+		name += std::to_string(i);
+		Logger::destroy(name);
+		assertTrue (!Logger::has(name));
+		assertTrue (Logger::has("LoggerTest.Logger" + std::to_string(i - 100)));
+	}
+
+	LoggerGetRunnable r1(1);
+	LoggerGetRunnable r2(2);
+	LoggerGetRunnable r3(3);
+	LoggerGetRunnable r4(4);
+	Thread t1;
+	Thread t2;
+	Thread t3;
+	Thread t4;
+	t1.start(r1);
+	t2.start(r2);
+	t3.start(r3);
+	t4.start(r4);
+	t1.join();
+	t2.join();
+	t3.join();
+	t4.join();
+	assertTrue (!r1.failed());
+	assertTrue (!r2.failed());
+	assertTrue (!r3.failed());
+	assertTrue (!r4.failed());
+
+	std::vector<std::string> names;
+	Logger::names(names);
+	assertTrue (names.size() == 1 + 100 + 400);
+	assertTrue (Logger::get("LoggerTest.Logger42").getLevel() == Message::PRIO_DEBUG);
+	assertTrue (Logger::get("LoggerTest.Logger42.3").getLevel() == Message::PRIO_DEBUG);
+	assertTrue (Logger::get("LoggerTest.Logger142").getLevel() == Message::PRIO_INFORMATION);
+}
+
+
 void LoggerTest::testDump()
 {
 	AutoPtr<TestChannel> pChannel = new TestChannel;
@@ -307,6 +503,10 @@ CppUnit::Test* LoggerTest::suite()
 	CppUnit_addTest(pSuite, LoggerTest, testLogger);
 	CppUnit_addTest(pSuite, LoggerTest, testFormat);
 	CppUnit_addTest(pSuite, LoggerTest, testFormatAny);
+	CppUnit_addTest(pSuite, LoggerTest, testLogDeferred);
+	CppUnit_addTest(pSuite, LoggerTest, testLoggerHandle);
+	CppUnit_addTest(pSuite, LoggerTest, testDestroy);
+	CppUnit_addTest(pSuite, LoggerTest, testGetConcurrent);
 	CppUnit_addTest(pSuite, LoggerTest, testDump);
 
 	return pSuite;
@@ -27,6 +27,10 @@ public:
 	void testLogger();
 	void testFormat();
 	void testFormatAny();
+	void testLogDeferred();
+	void testLoggerHandle();
+	void testDestroy();
+	void testGetConcurrent();
 	void testDump();
 
 	void setUp();
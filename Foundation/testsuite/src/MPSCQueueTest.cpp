@@ -0,0 +1,151 @@
+//
+// MPSCQueueTest.cpp
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "MPSCQueueTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Thread.h"
+#include "Poco/RunnableAdapter.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/AtomicCounter.h"
+#include <vector>
+
+
+using Poco::MPSCQueue;
+using Poco::Thread;
+using Poco::RunnableAdapter;
+using Poco::SharedPtr;
+
+
+namespace
+{
+	const int PRODUCERS = 4;
+	const int VALUES_PER_PRODUCER = 20000;
+
+	Poco::AtomicCounter producerId;
+}
+
+
+MPSCQueueTest::MPSCQueueTest(const std::string& rName): CppUnit::TestCase(rName)
+{
+}
+
+
+MPSCQueueTest::~MPSCQueueTest()
+{
+}
+
+
+void MPSCQueueTest::testPushPop()
+{
+	MPSCQueue<std::string> queue;
+	std::string value;
+	assertTrue (queue.empty());
+	assertTrue (!queue.pop(value));
+
+	queue.push("one");
+	queue.push("two");
+	assertTrue (!queue.empty());
+	assertTrue (queue.pop(value));
+	assertTrue (value == "one");
+	queue.push("three");
+	assertTrue (queue.pop(value));
+	assertTrue (value == "two");
+	assertTrue (queue.pop(value));
+	assertTrue (value == "three");
+	assertTrue (queue.empty());
+	assertTrue (!queue.pop(value));
+}
+
+
+void MPSCQueueTest::testDestroy()
+{
+	SharedPtr<int> pValue(new int(42));
+	{
+		MPSCQueue<SharedPtr<int> > queue;
+		queue.push(pValue);
+		queue.push(pValue);
+		SharedPtr<int> p;
+		assertTrue (queue.pop(p));
+		assertTrue (pValue.referenceCount() == 3);
+		p.reset();
+		// popped values are not kept alive by the queue
+		assertTrue (pValue.referenceCount() == 2);
+	}
+	assertTrue (pValue.referenceCount() == 1);
+}
+
+
+void MPSCQueueTest::testThreads()
+{
+	producerId = 0;
+	std::vector<SharedPtr<Thread> > threads;
+	RunnableAdapter<MPSCQueueTest> ra(*this, &MPSCQueueTest::work);
+	for (int i = 0; i < PRODUCERS; i++)
+	{
+		threads.push_back(new Thread);
+		threads.back()->start(ra);
+	}
+
+	std::vector<int> next(PRODUCERS, 0);
+	int count = 0;
+	while (count < PRODUCERS*VALUES_PER_PRODUCER)
+	{
+		int value;
+		if (_queue.pop(value))
+		{
+			int producer = value / VALUES_PER_PRODUCER;
+			assertTrue (producer >= 0 && producer < PRODUCERS);
+			// values of a producer are received in order
+			assertTrue (value % VALUES_PER_PRODUCER == next[producer]);
+			++next[producer];
+			++count;
+		}
+		else Thread::yield();
+	}
+	for (int i = 0; i < PRODUCERS; i++)
+	{
+		threads[i]->join();
+		assertTrue (next[i] == VALUES_PER_PRODUCER);
+	}
+	assertTrue (_queue.empty());
+}
+
+
+void MPSCQueueTest::setUp()
+{
+}
+
+
+void MPSCQueueTest::tearDown()
+{
+}
+
+
+void MPSCQueueTest::work()
+{
+	int id = producerId++;
+	for (int i = 0; i < VALUES_PER_PRODUCER; i++)
+	{
+		_queue.push(id*VALUES_PER_PRODUCER + i);
+	}
+}
+
+
+CppUnit::Test* MPSCQueueTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("MPSCQueueTest");
+
+	CppUnit_addTest(pSuite, MPSCQueueTest, testPushPop);
+	CppUnit_addTest(pSuite, MPSCQueueTest, testDestroy);
+	CppUnit_addTest(pSuite, MPSCQueueTest, testThreads);
+
+	return pSuite;
+}
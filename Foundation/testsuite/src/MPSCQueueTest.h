@@ -0,0 +1,45 @@
+//
+// MPSCQueueTest.h
+//
+// Definition of the MPSCQueueTest class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef MPSCQueueTest_INCLUDED
+#define MPSCQueueTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/CppUnit/TestCase.h"
+#include "Poco/MPSCQueue.h"
+
+
+class MPSCQueueTest: public CppUnit::TestCase
+{
+public:
+	MPSCQueueTest(const std::string& name);
+	~MPSCQueueTest();
+
+	void testPushPop();
+	void testDestroy();
+	void testThreads();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+protected:
+	void work();
+
+private:
+	Poco::MPSCQueue<int> _queue;
+};
+
+
+#endif // MPSCQueueTest_INCLUDED
@@ -13,6 +13,7 @@
 #include "NotificationQueueTest.h"
 #include "PriorityNotificationQueueTest.h"
 #include "TimedNotificationQueueTest.h"
+#include "MPSCQueueTest.h"
 
 
 CppUnit::Test* NotificationsTestSuite::suite()
@@ -23,6 +24,7 @@ CppUnit::Test* NotificationsTestSuite::suite()
 	pSuite->addTest(NotificationQueueTest::suite());
 	pSuite->addTest(PriorityNotificationQueueTest::suite());
 	pSuite->addTest(TimedNotificationQueueTest::suite());
+	pSuite->addTest(MPSCQueueTest::suite());
 
 	return pSuite;
 }
@@ -12,14 +12,18 @@
 #include "Poco/CppUnit/TestCaller.h"
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/PatternFormatter.h"
+#include "Poco/CompiledPatternFormatter.h"
 #include "Poco/Message.h"
 #include "Poco/DateTime.h"
+#include "Poco/Timestamp.h"
 #include "Poco/Exception.h"
 
 
 using Poco::PatternFormatter;
+using Poco::CompiledPatternFormatter;
 using Poco::Message;
 using Poco::DateTime;
+using Poco::Timestamp;
 
 
 PatternFormatterTest::PatternFormatterTest(const std::string& rName): CppUnit::TestCase(rName)
@@ -110,6 +114,102 @@ void PatternFormatterTest::testPatternFormatter()
 }
 
 
+void PatternFormatterTest::testCompiledPatternFormatter()
+{
+	Message msg;
+	CompiledPatternFormatter fmt;
+	msg.setSource("TestSource");
+	msg.setText("Test message text");
+	msg.setPid(1234);
+	msg.setTid(1);
+	msg.setThread("TestThread");
+	msg.setPriority(Message::PRIO_ERROR);
+	msg.setTime(DateTime(2005, 1, 1, 14, 30, 15, 500).timestamp());
+	msg["testParam"] = "Test Parameter";
+
+	std::string result;
+	fmt.format(msg, result);
+	assertTrue (result.empty());
+
+	fmt.setProperty("pattern", "%Y-%m-%dT%H:%M:%S [%s] %p: %t");
+	fmt.format(msg, result);
+	assertTrue (result == "2005-01-01T14:30:15 [TestSource] Error: Test message text");
+
+	result.clear();
+	fmt.setProperty("pattern", "%w, %e %b %y %H:%M:%S.%i [%s:%I:%T] %q: %t");
+	fmt.format(msg, result);
+	assertTrue (result == "Sat, 1 Jan 05 14:30:15.500 [TestSource:1:TestThread] E: Test message text");
+
+	result.clear();
+	fmt.setProperty("pattern", "%Y-%m-%d %H:%M:%S [%N:%P:%s]%l-%t");
+	fmt.format(msg, result);
+	assertTrue (result.find("2005-01-01 14:30:15 [") == 0);
+	assertTrue (result.find(":1234:TestSource]3-Test message text") != std::string::npos);
+
+	result.clear();
+	fmt.setProperty("pattern", "%[testParam] %p %[unknown]%v[12]|%v[8]");
+	fmt.format(msg, result);
+	assertTrue (result == "Test Parameter Error TestSource  |stSource");
+
+	result.clear();
+	fmt.setProperty("pattern", "%p");
+	fmt.setProperty("priorityNames", "FAT, CRI, ERR, WRN, NTC, INF, DBG, TRC");
+	fmt.format(msg, result);
+	assertTrue (result == "ERR");
+
+	Poco::AutoPtr<Poco::Formatter> pFormatter = new CompiledPatternFormatter("%t");
+	result.clear();
+	pFormatter->format(msg, result);
+	assertTrue (result == "Test message text");
+}
+
+
+void PatternFormatterTest::testCompiledPatternFormatterTimes()
+{
+	static const char* patterns[] =
+	{
+		"%Y-%m-%d %H:%M:%S.%i %z %Z [%p] %s: %t",
+		"%w %W %b %B %d %e %f %m %n %o %y %Y %H %h %a %A %M %S %i %c %F %E",
+		"%H:%M:%S %L%H:%M:%S %z %Z",
+		"%s %t %Y",
+		"%Y%H%t%M%S%F",
+		"100%% %Y-%m-%d"
+	};
+
+	Message msg("TestSource", "Test message text", Message::PRIO_INFORMATION);
+	Timestamp::TimeVal start = DateTime(2020, 2, 28, 23, 59, 58, 123, 456).timestamp().epochMicroseconds();
+	for (int local = 0; local < 2; ++local)
+	{
+		for (std::size_t p = 0; p < sizeof(patterns)/sizeof(patterns[0]); ++p)
+		{
+			PatternFormatter fmt(patterns[p]);
+			CompiledPatternFormatter compiledFmt(patterns[p]);
+			CompiledPatternFormatter otherFmt("%H:%M:%S");
+			if (local)
+			{
+				fmt.setProperty("times", "local");
+				compiledFmt.setProperty("times", "local");
+				assertTrue (compiledFmt.getProperty("times") == "local");
+			}
+			// advance by 0.25 seconds, to cross second, minute, hour
+			// and day boundaries, and use another formatter in between
+			for (int i = 0; i < 16; ++i)
+			{
+				msg.setTime(Timestamp::fromEpochTime(0) + (start + i*250000));
+				std::string expected;
+				fmt.format(msg, expected);
+				std::string result;
+				compiledFmt.format(msg, result);
+				assertEqual (expected, result);
+				result.clear();
+				otherFmt.format(msg, result);
+				assertTrue (result.size() == 8);
+			}
+		}
+	}
+}
+
+
 void PatternFormatterTest::setUp()
 {
 }
@@ -125,6 +225,8 @@ CppUnit::Test* PatternFormatterTest::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("PatternFormatterTest");
 
 	CppUnit_addTest(pSuite, PatternFormatterTest, testPatternFormatter);
+	CppUnit_addTest(pSuite, PatternFormatterTest, testCompiledPatternFormatter);
+	CppUnit_addTest(pSuite, PatternFormatterTest, testCompiledPatternFormatterTimes);
 
 	return pSuite;
 }
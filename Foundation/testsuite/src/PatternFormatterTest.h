@@ -25,6 +25,8 @@ public:
 	~PatternFormatterTest();
 
 	void testPatternFormatter();
+	void testCompiledPatternFormatter();
+	void testCompiledPatternFormatterTimes();
 
 	void setUp();
 	void tearDown();
@@ -0,0 +1,213 @@
+//
+// DNSCache.h
+//
+// Library: Net
+// Package: NetCore
+// Module:  DNSCache
+//
+// Definition of the DNSCache class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_DNSCache_INCLUDED
+#define Net_DNSCache_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HostEntry.h"
+#include "Poco/Net/HostResolver.h"
+#include "Poco/ActiveResult.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/NotificationQueue.h"
+#include "Poco/Mutex.h"
+#include "Poco/Clock.h"
+#include "Poco/Timespan.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Exception.h"
+#include <functional>
+#include <vector>
+#include <map>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API DNSCache: private Poco::Runnable
+	/// A DNSCache resolves host names, using a HostResolver,
+	/// and keeps the results for a limited time.
+	///
+	/// Successful lookups are kept for the positive TTL, failed
+	/// lookups (the exception thrown by the HostResolver) for the
+	/// negative TTL. As the name service of the operating system
+	/// does not report the TTLs of the DNS records, the TTLs
+	/// are configured for the whole cache. A TTL of zero
+	/// disables caching of the respective results.
+	///
+	/// Host names can be resolved synchronously with resolve(),
+	/// or asynchronously with resolveAsync(), which performs
+	/// the lookup in one of the DNSCache's own resolver threads
+	/// and either returns an ActiveResult, or invokes a callback
+	/// when the lookup has completed. Concurrent asynchronous
+	/// lookups of the same host name are combined into one.
+	/// The resolver threads are started with the first
+	/// asynchronous lookup.
+	///
+	/// Caching is opt-in: SocketAddress, and thus HTTPClientSession,
+	/// always resolve host names with DNS::hostByName(). Only code
+	/// that uses a DNSCache explicitly, such as a SocketConnector
+	/// created for a host name, which uses the default DNSCache
+	/// returned by defaultCache(), sees cached results.
+	/// Tests can make host names resolve to local addresses by setting
+	/// a StubResolver as the default DNSCache's resolver.
+{
+public:
+	typedef Poco::ActiveResult<HostEntry> Result;
+	typedef std::function<void(const Result&)> Callback;
+
+	enum
+	{
+		DEFAULT_POSITIVE_TTL = 60,
+			/// Default positive TTL in seconds.
+		DEFAULT_NEGATIVE_TTL = 5,
+			/// Default negative TTL in seconds.
+		DEFAULT_MAX_ENTRIES = 4096,
+			/// Default maximum number of cached host names.
+		DEFAULT_THREADS = 2
+			/// Default number of resolver threads.
+	};
+
+	DNSCache();
+		/// Creates a DNSCache using the system's name service,
+		/// with default settings.
+
+	explicit DNSCache(HostResolver::Ptr pResolver, int threads = DEFAULT_THREADS);
+		/// Creates a DNSCache using the given HostResolver, and
+		/// the given number of threads for asynchronous lookups.
+
+	~DNSCache();
+		/// Destroys the DNSCache, after stopping the resolver threads.
+		///
+		/// Asynchronous lookups still pending fail with an
+		/// IllegalStateException.
+
+	HostEntry resolve(const std::string& hostname);
+		/// Returns the HostEntry for the given host name, from the
+		/// cache if possible. Otherwise, the host name is resolved
+		/// in the calling thread, and the result is cached.
+		///
+		/// Throws the exception thrown by the HostResolver
+		/// (also if it has been cached) if the lookup fails.
+
+	Result resolveAsync(const std::string& hostname);
+		/// Starts an asynchronous lookup of the given host name,
+		/// and returns the result, which is already available
+		/// if the host name was in the cache.
+
+	void resolveAsync(const std::string& hostname, const Callback& callback);
+		/// Starts an asynchronous lookup of the given host name,
+		/// and invokes the given callback with the result when the
+		/// lookup has completed, from a resolver thread.
+		///
+		/// If the host name was in the cache, the callback is
+		/// invoked immediately, from the calling thread.
+		///
+		/// Exceptions thrown by the callback are passed to the
+		/// ErrorHandler.
+
+	void setResolver(HostResolver::Ptr pResolver);
+		/// Sets the HostResolver used for subsequent lookups,
+		/// and clears the cache.
+
+	HostResolver::Ptr getResolver() const;
+		/// Returns the HostResolver.
+
+	void setPositiveTTL(const Poco::Timespan& ttl);
+		/// Sets the time for which successful lookups are cached.
+
+	Poco::Timespan getPositiveTTL() const;
+		/// Returns the time for which successful lookups are cached.
+
+	void setNegativeTTL(const Poco::Timespan& ttl);
+		/// Sets the time for which failed lookups are cached.
+
+	Poco::Timespan getNegativeTTL() const;
+		/// Returns the time for which failed lookups are cached.
+
+	void setMaxEntries(std::size_t maxEntries);
+		/// Sets the maximum number of cached host names.
+
+	std::size_t getMaxEntries() const;
+		/// Returns the maximum number of cached host names.
+
+	void remove(const std::string& hostname);
+		/// Removes the given host name from the cache.
+
+	void clear();
+		/// Removes all host names from the cache.
+
+	std::size_t size() const;
+		/// Returns the number of cached host names,
+		/// including expired ones not removed yet.
+
+	static DNSCache& defaultCache();
+		/// Returns the default DNSCache.
+
+private:
+	DNSCache(const DNSCache&);
+	DNSCache& operator = (const DNSCache&);
+
+	enum
+	{
+		WAITTIME_MILLISEC = 1000
+	};
+
+	struct Entry
+	{
+		HostEntry hostEntry;
+		Poco::SharedPtr<Poco::Exception> pException;
+		Poco::Clock expires;
+	};
+
+	struct Pending
+	{
+		Pending();
+		Result result;
+		std::vector<Callback> callbacks;
+	};
+
+	typedef std::map<std::string, Entry> EntryMap;
+	typedef std::map<std::string, Pending> PendingMap;
+
+	void run();
+	EntryMap::iterator findEntry(const std::string& key);
+	void insert(const std::string& key, const HostEntry& hostEntry, Poco::Exception* pException);
+	void purge();
+	Result start(const std::string& hostname, const Callback* pCallback);
+	void complete(const std::string& key, const HostEntry& hostEntry, Poco::Exception* pException);
+	static void invoke(const Callback& callback, const Result& result);
+
+	HostResolver::Ptr _pResolver;
+	Poco::Timespan _positiveTTL;
+	Poco::Timespan _negativeTTL;
+	std::size_t _maxEntries;
+	int _threadCount;
+	EntryMap _entries;
+	PendingMap _pending;
+	Poco::NotificationQueue _queue;
+	std::vector<Poco::Thread*> _threads;
+	bool _stopped;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_DNSCache_INCLUDED
@@ -0,0 +1,221 @@
+//
+// DatagramBatch.h
+//
+// Library: Net
+// Package: Sockets
+// Module:  DatagramBatch
+//
+// Definition of the DatagramBatch class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_DatagramBatch_INCLUDED
+#define Net_DatagramBatch_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/SocketDefs.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Buffer.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API DatagramBatch
+	/// A DatagramBatch holds a number of datagrams, together
+	/// with their lengths and peer addresses, for sending or
+	/// receiving them with a single system call using
+	/// DatagramSocket::sendBatch() and DatagramSocket::receiveBatch().
+	///
+	/// All memory is allocated when the DatagramBatch is created,
+	/// so a DatagramBatch should be reused for subsequent calls.
+	/// Every datagram has a slot of datagramSize() bytes.
+{
+public:
+	DatagramBatch(std::size_t capacity, std::size_t datagramSize);
+		/// Creates a DatagramBatch that can hold up to capacity
+		/// datagrams of up to datagramSize bytes each.
+
+	~DatagramBatch();
+		/// Destroys the DatagramBatch.
+
+	std::size_t capacity() const;
+		/// Returns the maximum number of datagrams in the batch.
+
+	std::size_t datagramSize() const;
+		/// Returns the maximum size of a datagram in the batch.
+
+	std::size_t size() const;
+		/// Returns the number of datagrams in the batch.
+
+	bool empty() const;
+		/// Returns true iff the batch contains no datagrams.
+
+	bool full() const;
+		/// Returns true iff the batch contains capacity() datagrams.
+
+	void clear();
+		/// Removes all datagrams from the batch.
+
+	void add(const void* data, std::size_t length);
+		/// Appends a copy of the given datagram, to be sent to
+		/// the address the socket is connected to.
+		///
+		/// Throws an IllegalStateException if the batch is full, or an
+		/// InvalidArgumentException if length exceeds datagramSize().
+
+	void add(const void* data, std::size_t length, const SocketAddress& address);
+		/// Appends a copy of the given datagram, to be sent to
+		/// the given address.
+		///
+		/// Throws an IllegalStateException if the batch is full, or an
+		/// InvalidArgumentException if length exceeds datagramSize().
+
+	char* data(std::size_t index);
+		/// Returns a pointer to the slot of the datagram with the given index.
+
+	const char* data(std::size_t index) const;
+		/// Returns a pointer to the slot of the datagram with the given index.
+
+	std::size_t length(std::size_t index) const;
+		/// Returns the length of the datagram with the given index.
+
+	SocketAddress address(std::size_t index) const;
+		/// Returns the peer address of the datagram with the given index,
+		/// or a wildcard address if the datagram has no address.
+
+private:
+	DatagramBatch();
+	DatagramBatch(const DatagramBatch&);
+	DatagramBatch& operator = (const DatagramBatch&);
+
+	enum
+	{
+		ADDRESS_SLOT_SIZE = ((SocketAddress::MAX_ADDRESS_LENGTH + 7)/8)*8
+			/// Keeps the address slots aligned.
+	};
+
+	struct sockaddr* addressBuffer(std::size_t index);
+	const struct sockaddr* addressBuffer(std::size_t index) const;
+	poco_socklen_t addressLength(std::size_t index) const;
+	void setDatagram(std::size_t index, std::size_t length, poco_socklen_t addressLength);
+	void setSize(std::size_t size);
+
+	std::size_t _capacity;
+	std::size_t _datagramSize;
+	std::size_t _size;
+	Poco::Buffer<char> _data;
+	Poco::Buffer<char> _addresses;
+	std::vector<std::size_t> _lengths;
+	std::vector<poco_socklen_t> _addressLengths;
+
+	friend class SocketImpl;
+};
+
+
+//
+// inlines
+//
+inline std::size_t DatagramBatch::capacity() const
+{
+	return _capacity;
+}
+
+
+inline std::size_t DatagramBatch::datagramSize() const
+{
+	return _datagramSize;
+}
+
+
+inline std::size_t DatagramBatch::size() const
+{
+	return _size;
+}
+
+
+inline bool DatagramBatch::empty() const
+{
+	return _size == 0;
+}
+
+
+inline bool DatagramBatch::full() const
+{
+	return _size == _capacity;
+}
+
+
+inline void DatagramBatch::clear()
+{
+	_size = 0;
+}
+
+
+inline char* DatagramBatch::data(std::size_t index)
+{
+	poco_assert_dbg (index < _capacity);
+
+	return _data.begin() + index*_datagramSize;
+}
+
+
+inline const char* DatagramBatch::data(std::size_t index) const
+{
+	poco_assert_dbg (index < _capacity);
+
+	return _data.begin() + index*_datagramSize;
+}
+
+
+inline std::size_t DatagramBatch::length(std::size_t index) const
+{
+	poco_assert_dbg (index < _size);
+
+	return _lengths[index];
+}
+
+
+inline struct sockaddr* DatagramBatch::addressBuffer(std::size_t index)
+{
+	return reinterpret_cast<struct sockaddr*>(_addresses.begin() + index*ADDRESS_SLOT_SIZE);
+}
+
+
+inline const struct sockaddr* DatagramBatch::addressBuffer(std::size_t index) const
+{
+	return reinterpret_cast<const struct sockaddr*>(_addresses.begin() + index*ADDRESS_SLOT_SIZE);
+}
+
+
+inline poco_socklen_t DatagramBatch::addressLength(std::size_t index) const
+{
+	return _addressLengths[index];
+}
+
+
+inline void DatagramBatch::setDatagram(std::size_t index, std::size_t length, poco_socklen_t addressLength)
+{
+	_lengths[index] = length;
+	_addressLengths[index] = addressLength;
+}
+
+
+inline void DatagramBatch::setSize(std::size_t size)
+{
+	_size = size;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_DatagramBatch_INCLUDED
@@ -20,6 +20,7 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/Socket.h"
+#include "Poco/Net/DatagramBatch.h"
 
 
 namespace Poco {
@@ -108,12 +109,25 @@ public:
 		/// Returns the number of bytes sent, which may be
 		/// less than the number of bytes specified.
 
+	int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers as a single
+		/// datagram through the socket, without copying them
+		/// into a single buffer first. See Socket::makeBuffer().
+		///
+		/// Returns the number of bytes sent.
+
 	int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
 		///
 		/// Returns the number of bytes received.
 
+	int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives a datagram from the socket and stores it
+		/// in the given buffers, filling one after the other.
+		///
+		/// Returns the number of bytes received.
+
 	int sendTo(const void* buffer, int length, const SocketAddress& address, int flags = 0);
 		/// Sends the contents of the given buffer through
 		/// the socket to the given address.
@@ -128,6 +142,27 @@ public:
 		///
 		/// Returns the number of bytes received.
 
+	int sendBatch(const DatagramBatch& batch, int flags = 0);
+		/// Sends all datagrams in the given batch, each to its
+		/// own address, with as few system calls as possible
+		/// (sendmmsg() on Linux, which also uses UDP segmentation
+		/// offload where possible).
+		///
+		/// Returns the number of datagrams sent, which, for a
+		/// non-blocking socket, may be less than batch.size().
+
+	int receiveBatch(DatagramBatch& batch, int flags = 0);
+		/// Receives up to batch.capacity() datagrams with as few
+		/// system calls as possible (recvmmsg() on Linux), and
+		/// stores them, together with the addresses of their
+		/// senders, in batch, replacing its previous contents.
+		///
+		/// Only waits for the first datagram; further datagrams
+		/// are only received if they are already available.
+		/// Datagrams longer than batch.datagramSize() are truncated.
+		///
+		/// Returns the number of datagrams received.
+
 	void setBroadcast(bool flag);
 		/// Sets the value of the SO_BROADCAST socket option.
 		///
@@ -0,0 +1,134 @@
+//
+// FilePartHandler.h
+//
+// Library: Net
+// Package: Messages
+// Module:  FilePartHandler
+//
+// Definition of the FilePartHandler class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_FilePartHandler_INCLUDED
+#define Net_FilePartHandler_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/PartHandler.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API FilePartHandler: public PartHandler
+	/// A PartHandler that streams every part directly into
+	/// a file, without keeping the part in memory.
+	///
+	/// This is intended for large file uploads via HTML forms.
+	/// The part data is copied in large blocks from the
+	/// part stream to a FileOutputStream.
+	///
+	/// The files are given unique names, generated by
+	/// TemporaryFile::tempName(). The file name sent by the
+	/// client is never used for naming the file, but is
+	/// available, along with the other properties of the
+	/// part, from parts().
+{
+public:
+	struct Part
+		/// Describes a part that has been written to a file.
+	{
+		std::string name;
+			/// The name of the form field (from the Content-Disposition header).
+		std::string filename;
+			/// The file name sent by the client (from the Content-Disposition header).
+		std::string contentType;
+			/// The content type of the part.
+		std::string path;
+			/// The path of the file containing the part's data.
+		Poco::UInt64 size;
+			/// The size of the part's data in bytes.
+	};
+
+	typedef std::vector<Part> PartVec;
+
+	enum
+	{
+		BUFFER_SIZE = 65536
+	};
+
+	FilePartHandler();
+		/// Creates the FilePartHandler, which writes the parts
+		/// to temporary files in the system's temporary directory.
+		///
+		/// The files are deleted when the FilePartHandler
+		/// is destroyed.
+
+	explicit FilePartHandler(const std::string& directory);
+		/// Creates the FilePartHandler, which writes the parts
+		/// to files in the given directory.
+		///
+		/// The files are not deleted by the FilePartHandler.
+
+	~FilePartHandler();
+		/// Destroys the FilePartHandler.
+
+	void handlePart(const MessageHeader& header, std::istream& stream);
+		/// Writes the data of the part to a new file.
+		///
+		/// If the data cannot be written, the file is deleted
+		/// and the exception is propagated.
+
+	const PartVec& parts() const;
+		/// Returns the parts that have been written to files,
+		/// in the order in which they have been received.
+
+	void setMaxPartSize(Poco::UInt64 maxSize);
+		/// Sets the maximum size of a part. If a part exceeds
+		/// this size, handlePart() throws a DataFormatException.
+		///
+		/// The default is 0, meaning no limit.
+
+	Poco::UInt64 getMaxPartSize() const;
+		/// Returns the maximum size of a part.
+
+private:
+	std::string _directory;
+	bool _temporary;
+	Poco::UInt64 _maxPartSize;
+	PartVec _parts;
+};
+
+
+//
+// inlines
+//
+inline const FilePartHandler::PartVec& FilePartHandler::parts() const
+{
+	return _parts;
+}
+
+
+inline void FilePartHandler::setMaxPartSize(Poco::UInt64 maxSize)
+{
+	_maxPartSize = maxSize;
+}
+
+
+inline Poco::UInt64 FilePartHandler::getMaxPartSize() const
+{
+	return _maxPartSize;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_FilePartHandler_INCLUDED
@@ -0,0 +1,94 @@
+//
+// HPACKDecoder.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HPACKDecoder
+//
+// Definition of the HPACKDecoder class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HPACKDecoder_INCLUDED
+#define Net_HPACKDecoder_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HPACKTable.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HPACKDecoder
+	/// Decodes HPACK header blocks (RFC 7541) into header lists.
+	///
+	/// All errors are reported by throwing a HTTP2Exception with
+	/// code HTTP2_COMPRESSION_ERROR, after which the decoder's state
+	/// is undefined, so that the connection must be closed.
+{
+public:
+	explicit HPACKDecoder(std::size_t maxTableSize = 4096);
+		/// Creates the HPACKDecoder. The maximum size of the dynamic
+		/// table is the value sent with SETTINGS_HEADER_TABLE_SIZE
+		/// to the peer.
+
+	~HPACKDecoder();
+		/// Destroys the HPACKDecoder.
+
+	void decode(const char* data, std::size_t length, HPACKTable::HeaderList& headers);
+		/// Decodes the given header block and appends the
+		/// header fields to headers.
+		///
+		/// Throws a HTTP2Exception if the block is invalid, or if
+		/// the size of the decoded header list (as defined for
+		/// SETTINGS_MAX_HEADER_LIST_SIZE) exceeds the limit.
+
+	void setMaxTableSize(std::size_t size);
+		/// Sets the upper limit for the size of the dynamic table,
+		/// which the encoder may signal with a table size update.
+
+	void setMaxHeaderListSize(std::size_t size);
+		/// Sets the maximum size of a decoded header list.
+		/// The default is 65536.
+
+	const HPACKTable& table() const;
+		/// Returns the decoder's table.
+
+	static Poco::UInt64 decodeInteger(const char*& data, const char* end, int prefixBits);
+		/// Decodes an integer with an N-bit prefix (RFC 7541,
+		/// section 5.1) and advances data past it.
+
+	static void decodeString(const char*& data, const char* end, std::string& str);
+		/// Decodes a string literal (RFC 7541, section 5.2)
+		/// and advances data past it.
+
+private:
+	HPACKDecoder(const HPACKDecoder&);
+	HPACKDecoder& operator = (const HPACKDecoder&);
+
+	HPACKTable _table;
+	std::size_t _maxTableSize;
+	std::size_t _maxHeaderListSize;
+};
+
+
+//
+// inlines
+//
+inline const HPACKTable& HPACKDecoder::table() const
+{
+	return _table;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HPACKDecoder_INCLUDED
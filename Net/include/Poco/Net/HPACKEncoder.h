@@ -0,0 +1,93 @@
+//
+// HPACKEncoder.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HPACKEncoder
+//
+// Definition of the HPACKEncoder class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HPACKEncoder_INCLUDED
+#define Net_HPACKEncoder_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HPACKTable.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HPACKEncoder
+	/// Encodes header lists into HPACK header blocks (RFC 7541).
+	///
+	/// Header fields found in the static or dynamic table are
+	/// sent as index. Other fields are added to the dynamic table,
+	/// except for credentials, which are sent as never-indexed
+	/// literals, and fields too large to be kept in the table.
+	/// String literals are Huffman-encoded if this makes them
+	/// shorter.
+	///
+	/// Header names must be lowercase.
+{
+public:
+	explicit HPACKEncoder(std::size_t maxTableSize = 4096);
+		/// Creates the HPACKEncoder with the given
+		/// maximum size of the dynamic table.
+
+	~HPACKEncoder();
+		/// Destroys the HPACKEncoder.
+
+	void encode(const HPACKTable::HeaderList& headers, std::string& block);
+		/// Appends the encoding of the given header list to block.
+
+	void setMaxTableSize(std::size_t size);
+		/// Sets the maximum size of the dynamic table, as
+		/// received with SETTINGS_HEADER_TABLE_SIZE from the peer.
+		/// The change is signaled at the start of the next
+		/// header block.
+
+	const HPACKTable& table() const;
+		/// Returns the encoder's table.
+
+	static void encodeInteger(Poco::UInt64 value, int prefixBits, unsigned char flags, std::string& block);
+		/// Appends the given integer, encoded with an N-bit
+		/// prefix (RFC 7541, section 5.1), to block. The flags
+		/// are stored in the bits of the first byte that are not
+		/// part of the prefix.
+
+	static void encodeString(const std::string& str, std::string& block);
+		/// Appends the given string literal (RFC 7541, section 5.2)
+		/// to block, Huffman-encoded if this makes it shorter.
+
+private:
+	HPACKEncoder(const HPACKEncoder&);
+	HPACKEncoder& operator = (const HPACKEncoder&);
+
+	HPACKTable _table;
+	std::size_t _minTableSize;
+	bool _tableSizeChanged;
+};
+
+
+//
+// inlines
+//
+inline const HPACKTable& HPACKEncoder::table() const
+{
+	return _table;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HPACKEncoder_INCLUDED
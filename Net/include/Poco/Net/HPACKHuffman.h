@@ -0,0 +1,55 @@
+//
+// HPACKHuffman.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HPACKHuffman
+//
+// Definition of the HPACKHuffman class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HPACKHuffman_INCLUDED
+#define Net_HPACKHuffman_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include <string>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HPACKHuffman
+	/// The static Huffman code used for string literals
+	/// in HPACK (RFC 7541, Appendix B).
+{
+public:
+	static std::size_t encodedLength(const std::string& str);
+		/// Returns the number of bytes the Huffman encoding
+		/// of the given string takes.
+
+	static void encode(const std::string& str, std::string& encoded);
+		/// Appends the Huffman encoding of str to encoded.
+
+	static void decode(const char* data, std::size_t length, std::string& decoded);
+		/// Appends the decoded data to decoded.
+		///
+		/// Throws a HTTP2Exception (with code HTTP2_COMPRESSION_ERROR)
+		/// if the data is not a valid encoding.
+
+private:
+	HPACKHuffman();
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HPACKHuffman_INCLUDED
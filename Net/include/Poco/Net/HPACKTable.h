@@ -0,0 +1,130 @@
+//
+// HPACKTable.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HPACKTable
+//
+// Definition of the HPACKTable class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HPACKTable_INCLUDED
+#define Net_HPACKTable_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include <deque>
+#include <string>
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HPACKTable
+	/// The HPACK index address space (RFC 7541, section 2.3),
+	/// consisting of the static table and a dynamic table.
+	///
+	/// Entries are addressed with 1-based indexes. Indexes 1 to
+	/// STATIC_TABLE_SIZE address the static table, higher indexes
+	/// the dynamic table, starting with the most recently added entry.
+{
+public:
+	typedef std::pair<std::string, std::string> Header;
+	typedef std::vector<Header> HeaderList;
+
+	enum
+	{
+		STATIC_TABLE_SIZE = 61,
+		ENTRY_OVERHEAD    = 32
+	};
+
+	explicit HPACKTable(std::size_t maxSize = 4096);
+		/// Creates the HPACKTable with the given maximum
+		/// size of the dynamic table.
+
+	~HPACKTable();
+		/// Destroys the HPACKTable.
+
+	const Header& get(std::size_t index) const;
+		/// Returns the entry with the given index.
+		///
+		/// Throws a HTTP2Exception (with code HTTP2_COMPRESSION_ERROR)
+		/// if there is no such entry.
+
+	std::size_t find(const std::string& name, const std::string& value, bool& exact) const;
+		/// Returns the index of an entry with the given name and value,
+		/// and sets exact to true. If there is no such entry, returns
+		/// the index of an entry with the given name and sets exact to
+		/// false. Returns 0 if no entry has the given name.
+
+	void add(const std::string& name, const std::string& value);
+		/// Adds an entry to the dynamic table, evicting the oldest
+		/// entries as necessary. If the entry is larger than the
+		/// maximum size, the dynamic table is emptied.
+
+	void setMaxSize(std::size_t maxSize);
+		/// Sets the maximum size of the dynamic table,
+		/// evicting the oldest entries as necessary.
+
+	std::size_t maxSize() const;
+		/// Returns the maximum size of the dynamic table.
+
+	std::size_t size() const;
+		/// Returns the size of the dynamic table, which is the sum
+		/// of the sizes of names and values of all entries, plus
+		/// ENTRY_OVERHEAD for each entry.
+
+	std::size_t count() const;
+		/// Returns the number of entries in the dynamic table.
+
+	static std::size_t entrySize(const std::string& name, const std::string& value);
+		/// Returns the size of an entry.
+
+private:
+	void evict(std::size_t maxSize);
+
+	std::deque<Header> _entries;
+	std::size_t _size;
+	std::size_t _maxSize;
+};
+
+
+//
+// inlines
+//
+inline std::size_t HPACKTable::maxSize() const
+{
+	return _maxSize;
+}
+
+
+inline std::size_t HPACKTable::size() const
+{
+	return _size;
+}
+
+
+inline std::size_t HPACKTable::count() const
+{
+	return _entries.size();
+}
+
+
+inline std::size_t HPACKTable::entrySize(const std::string& name, const std::string& value)
+{
+	return name.size() + value.size() + ENTRY_OVERHEAD;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HPACKTable_INCLUDED
@@ -0,0 +1,112 @@
+//
+// HTTP2ClientSession.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2ClientSession
+//
+// Definition of the HTTP2ClientSession class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTP2ClientSession_INCLUDED
+#define Net_HTTP2ClientSession_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTP2Connection.h"
+#include "Poco/Net/HTTPSession.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class HTTPRequest;
+class HTTPResponse;
+
+
+class Net_API HTTP2ClientSession: public HTTP2Connection
+	/// This class implements the client side of a HTTP/2
+	/// connection, which can carry many concurrent requests.
+	///
+	/// Requests are sent with sendRequest(), which returns the
+	/// identifier of the stream carrying the request. Any number
+	/// of requests can be sent before their responses are received
+	/// with receiveResponse(). Responses can be received in any
+	/// order; the data of the other streams is buffered meanwhile,
+	/// bounded by their flow control windows.
+	///
+	/// Server push is disabled.
+	///
+	/// A HTTP2ClientSession must not be used by multiple
+	/// threads at the same time.
+	///
+	/// Usage example:
+	///     HTTP2ClientSession session("www.example.com", 80);
+	///     HTTPRequest request1(HTTPRequest::HTTP_GET, "/a");
+	///     HTTPRequest request2(HTTPRequest::HTTP_GET, "/b");
+	///     Poco::UInt32 id1 = session.sendRequest(request1);
+	///     Poco::UInt32 id2 = session.sendRequest(request2);
+	///     HTTPResponse response;
+	///     std::string body;
+	///     session.receiveResponse(id2, response, body);
+	///     session.receiveResponse(id1, response, body);
+{
+public:
+	explicit HTTP2ClientSession(const StreamSocket& socket);
+		/// Creates a HTTP2ClientSession using the given connected
+		/// socket. For a SecureStreamSocket, the "h2" protocol must
+		/// have been negotiated with ALPN.
+
+	HTTP2ClientSession(const std::string& host, Poco::UInt16 port = HTTPSession::HTTP_PORT);
+		/// Creates a HTTP2ClientSession connected to the given host
+		/// over plain TCP, using HTTP/2 with prior knowledge (h2c).
+
+	~HTTP2ClientSession();
+		/// Closes and destroys the HTTP2ClientSession.
+
+	Poco::UInt32 sendRequest(HTTPRequest& request, const std::string& body = std::string());
+		/// Sends the given request with the given body on a new
+		/// stream, and returns the identifier of the stream.
+		///
+		/// As much of the body is sent as flow control permits.
+		/// The rest is sent while frames are received, e.g. in
+		/// receiveResponse().
+		///
+		/// If the number of concurrent streams allowed by the server
+		/// has been reached, frames are received until a stream
+		/// has been closed.
+
+	void receiveResponse(Poco::UInt32 streamId, HTTPResponse& response, std::string& body);
+		/// Receives the response for the request sent on the given
+		/// stream, and stores its body in body. Interim (1xx)
+		/// responses are skipped.
+		///
+		/// Throws a HTTP2Exception if the server has reset the
+		/// stream, or a TimeoutException if the response is not
+		/// received within the timeout.
+
+	void close();
+		/// Sends a GOAWAY frame and closes the connection.
+
+protected:
+	void onHeaders(Stream* pStream, Poco::UInt32 streamId, HPACKTable::HeaderList& headers, bool endStream);
+	void start();
+
+private:
+	std::string  _host;
+	bool         _started;
+	Poco::UInt32 _nextStreamId;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTP2ClientSession_INCLUDED
@@ -0,0 +1,354 @@
+//
+// HTTP2Connection.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2Connection
+//
+// Definition of the HTTP2Connection class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTP2Connection_INCLUDED
+#define Net_HTTP2Connection_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/HTTP2Frame.h"
+#include "Poco/Net/HPACKEncoder.h"
+#include "Poco/Net/HPACKDecoder.h"
+#include "Poco/Timespan.h"
+#include <map>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HTTP2Connection
+	/// The base class for HTTP2ServerConnection and HTTP2ClientSession,
+	/// implementing the connection state shared by server and client:
+	/// framing, header compression, the stream states, flow control
+	/// and prioritization of the response data (RFC 9113).
+	///
+	/// A HTTP2Connection is driven by a single thread. Frames are
+	/// received by calling receiveFrame(), either directly, or
+	/// indirectly while waiting for the data of a stream in
+	/// readData(), or for flow control credit in writeData().
+	/// Frames to be sent are collected in a buffer, which is
+	/// written to the socket with a single send by flush().
+	///
+	/// Data frames are scheduled by priority. The stream with
+	/// the lowest urgency (RFC 9218), and among streams with equal
+	/// urgency the one with the lowest identifier, is served first,
+	/// as far as flow control permits.
+	///
+	/// Connection errors are reported by throwing a HTTP2Exception,
+	/// with the error code as exception code. The GOAWAY frame has
+	/// been sent when the exception is thrown, and the connection
+	/// must be closed. Once a connection error or a network error
+	/// has occurred, failed() returns true.
+{
+public:
+	enum
+	{
+		DEFAULT_URGENCY = 3,
+			/// The urgency of a stream without priority signal (RFC 9218).
+		MAX_URGENCY = 7,
+		CONNECTION_WINDOW_SIZE = 1048576,
+			/// The receive window of the connection. The receive
+			/// window of a stream is DEFAULT_WINDOW_SIZE.
+		MAX_PENDING_OUTPUT = 65536
+			/// The amount of data a stream can have queued before
+			/// writeData() waits for flow control credit.
+	};
+
+	struct Stream
+		/// The state of a stream.
+	{
+		Stream();
+
+		Poco::UInt32 id;
+		HPACKTable::HeaderList headers;
+		std::string input;
+		std::size_t inputPos;
+		std::string output;
+		std::size_t outputPos;
+		Poco::Int64 sendWindow;
+		Poco::Int64 recvWindow;
+		Poco::Int64 consumed;
+		int urgency;
+		int resetCode;
+		bool headersReceived;
+		bool endReceived;
+		bool endQueued;
+		bool endSent;
+		bool reset;
+		bool dispatched;
+		bool done;
+	};
+
+	virtual ~HTTP2Connection();
+		/// Destroys the HTTP2Connection.
+
+	StreamSocket& socket();
+		/// Returns the connection's socket.
+
+	void setTimeout(const Poco::Timespan& timeout);
+		/// Sets the timeout for waiting for data from the peer
+		/// in readData() and writeData().
+
+	Poco::Timespan getTimeout() const;
+		/// Returns the timeout for waiting for data from the peer.
+
+	bool receiveFrame(const Poco::Timespan& timeout);
+		/// Waits up to the given time for a frame and processes it.
+		/// Returns true if a frame has been processed, or false if
+		/// no complete frame has been received within the timeout,
+		/// or the peer has closed the connection (see closed()).
+
+	int readData(Poco::UInt32 streamId, char* buffer, std::size_t length);
+		/// Reads up to length bytes of the data received for
+		/// the given stream, waiting for data if necessary.
+		/// Returns 0 at the end of the stream.
+		///
+		/// Throws a HTTP2Exception if the stream has been reset,
+		/// and a TimeoutException if no data is received within
+		/// the timeout.
+
+	void queueData(Poco::UInt32 streamId, const char* buffer, std::size_t length, bool endStream);
+		/// Queues the given data for the stream, without waiting
+		/// for flow control credit. The data is sent by flush(),
+		/// as far as flow control permits, which is called
+		/// whenever frames are received.
+		///
+		/// Throws a HTTP2Exception if the stream has been reset.
+
+	void writeData(Poco::UInt32 streamId, const char* buffer, std::size_t length, bool endStream);
+		/// Queues the given data for the stream. If endStream
+		/// is true, the stream is ended after the data.
+		///
+		/// If more than MAX_PENDING_OUTPUT bytes are waiting for
+		/// flow control credit, frames are received until the
+		/// peer has granted enough credit.
+		///
+		/// Throws a HTTP2Exception if the stream has been reset,
+		/// and a TimeoutException if no credit is granted within
+		/// the timeout.
+
+	void sendHeaders(Poco::UInt32 streamId, const HPACKTable::HeaderList& headers, bool endStream);
+		/// Sends a HEADERS frame, followed by CONTINUATION frames
+		/// if the header block does not fit into a single frame.
+		/// Header names must be lowercase.
+
+	void resetStream(Poco::UInt32 streamId, int errorCode);
+		/// Sends a RST_STREAM frame for the stream, and discards
+		/// its pending output.
+
+	void sendGoAway(int errorCode);
+		/// Sends a GOAWAY frame with the given error code,
+		/// and flushes it.
+
+	void flush();
+		/// Schedules the pending output of the streams as far as
+		/// flow control permits, and sends all queued frames.
+
+	Stream* findStream(Poco::UInt32 streamId);
+		/// Returns the stream with the given identifier,
+		/// or null if the stream does not exist.
+
+	void setReceived(const char* data, std::size_t length);
+		/// Sets data received from the peer before the connection
+		/// has been created (e.g., the client connection preface
+		/// after a protocol upgrade).
+
+	bool closed() const;
+		/// Returns true if the peer has closed the connection.
+
+	bool failed() const;
+		/// Returns true if a connection error or a network
+		/// error has occurred.
+
+	bool goAwayReceived() const;
+		/// Returns true if the peer has sent a GOAWAY frame.
+
+	static void parsePriority(const std::string& priority, int& urgency);
+		/// Sets urgency to the value of the u parameter of the given
+		/// Priority header field value (RFC 9218), if present and valid.
+
+protected:
+	typedef std::map<Poco::UInt32, Stream> StreamMap;
+
+	HTTP2Connection(const StreamSocket& socket, bool server);
+		/// Creates the HTTP2Connection.
+
+	void sendPreface();
+		/// Queues the client connection preface.
+
+	void sendSettings(Poco::UInt32 maxConcurrentStreams);
+		/// Queues the SETTINGS frame starting the connection,
+		/// and a WINDOW_UPDATE frame enlarging the connection's
+		/// receive window to CONNECTION_WINDOW_SIZE.
+
+	void applySettings(const char* payload, std::size_t length);
+		/// Applies the peer's settings in the given SETTINGS payload.
+
+	void receivePreface();
+		/// Receives and checks the client connection preface.
+
+	Stream& addStream(Poco::UInt32 streamId);
+		/// Creates a stream with the given identifier.
+
+	void removeStream(Poco::UInt32 streamId);
+		/// Removes the stream.
+
+	void removeDoneStreams();
+		/// Removes the streams whose application processing is
+		/// done, once their output has been sent. If the peer has not
+		/// ended such a stream, it is reset with HTTP2_NO_ERROR.
+
+	std::size_t activeStreams() const;
+		/// Returns the number of streams that have not been closed
+		/// in both directions, as counted for the concurrent
+		/// streams limit.
+
+	virtual void onHeaders(Stream* pStream, Poco::UInt32 streamId, HPACKTable::HeaderList& headers, bool endStream) = 0;
+		/// Called when a complete header block has been received.
+		/// pStream is null if the stream does not exist yet.
+
+	StreamMap& streams();
+	Poco::UInt32 lastStreamId() const;
+	void setLastStreamId(Poco::UInt32 streamId);
+	Poco::UInt32 peerMaxConcurrentStreams() const;
+	Poco::UInt32 localMaxConcurrentStreams() const;
+
+private:
+	HTTP2Connection(const HTTP2Connection&);
+	HTTP2Connection& operator = (const HTTP2Connection&);
+
+	bool receive(const Poco::Timespan& timeout);
+	void processFrame(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processData(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processHeaders(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processPriority(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processRstStream(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processSettings(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processPing(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processGoAway(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processWindowUpdate(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processContinuation(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processPriorityUpdate(const HTTP2Frame& frame, const char* payload, std::size_t length);
+	void processHeaderBlock();
+	void consumed(Stream& stream, std::size_t length);
+	void schedule();
+	void queueFrame(int type, int flags, Poco::UInt32 streamId, const char* payload, std::size_t length);
+	void sendBuffered();
+	Stream& checkStream(Poco::UInt32 streamId);
+	static std::size_t stripPadding(const HTTP2Frame& frame, const char*& payload, std::size_t length);
+
+	StreamSocket   _socket;
+	bool           _server;
+	Poco::Timespan _timeout;
+	std::string    _inBuffer;
+	std::size_t    _inPos;
+	std::string    _outBuffer;
+	HPACKEncoder   _encoder;
+	HPACKDecoder   _decoder;
+	StreamMap      _streams;
+	Poco::Int64    _sendWindow;
+	Poco::Int64    _recvWindow;
+	Poco::Int64    _peerInitialWindow;
+	Poco::UInt32   _peerMaxFrameSize;
+	Poco::UInt32   _peerMaxConcurrentStreams;
+	Poco::UInt32   _localMaxConcurrentStreams;
+	Poco::UInt32   _lastStreamId;
+	Poco::UInt32   _headerStreamId;
+	int            _headerFlags;
+	int            _headerUrgency;
+	std::string    _headerBlock;
+	bool           _closed;
+	bool           _failed;
+	bool           _goAwayReceived;
+	bool           _goAwaySent;
+};
+
+
+//
+// inlines
+//
+inline StreamSocket& HTTP2Connection::socket()
+{
+	return _socket;
+}
+
+
+inline void HTTP2Connection::setTimeout(const Poco::Timespan& timeout)
+{
+	_timeout = timeout;
+}
+
+
+inline Poco::Timespan HTTP2Connection::getTimeout() const
+{
+	return _timeout;
+}
+
+
+inline bool HTTP2Connection::closed() const
+{
+	return _closed;
+}
+
+
+inline bool HTTP2Connection::failed() const
+{
+	return _failed;
+}
+
+
+inline bool HTTP2Connection::goAwayReceived() const
+{
+	return _goAwayReceived;
+}
+
+
+inline HTTP2Connection::StreamMap& HTTP2Connection::streams()
+{
+	return _streams;
+}
+
+
+inline Poco::UInt32 HTTP2Connection::lastStreamId() const
+{
+	return _lastStreamId;
+}
+
+
+inline void HTTP2Connection::setLastStreamId(Poco::UInt32 streamId)
+{
+	_lastStreamId = streamId;
+}
+
+
+inline Poco::UInt32 HTTP2Connection::peerMaxConcurrentStreams() const
+{
+	return _peerMaxConcurrentStreams;
+}
+
+
+inline Poco::UInt32 HTTP2Connection::localMaxConcurrentStreams() const
+{
+	return _localMaxConcurrentStreams;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTP2Connection_INCLUDED
@@ -0,0 +1,208 @@
+//
+// HTTP2Frame.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2Frame
+//
+// Definition of the HTTP2Frame class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTP2Frame_INCLUDED
+#define Net_HTTP2Frame_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include <string>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HTTP2Frame
+	/// A HTTP/2 frame (RFC 9113, section 4), consisting of
+	/// the 9 byte frame header and the payload.
+	///
+	/// The class also defines the frame types, flags,
+	/// error codes and settings of the protocol.
+{
+public:
+	enum Type
+	{
+		FRAME_DATA          = 0x0,
+		FRAME_HEADERS       = 0x1,
+		FRAME_PRIORITY      = 0x2,
+		FRAME_RST_STREAM    = 0x3,
+		FRAME_SETTINGS      = 0x4,
+		FRAME_PUSH_PROMISE  = 0x5,
+		FRAME_PING          = 0x6,
+		FRAME_GOAWAY        = 0x7,
+		FRAME_WINDOW_UPDATE = 0x8,
+		FRAME_CONTINUATION  = 0x9,
+		FRAME_PRIORITY_UPDATE = 0x10
+	};
+
+	enum Flag
+	{
+		FLAG_END_STREAM  = 0x01,
+		FLAG_ACK         = 0x01,
+		FLAG_END_HEADERS = 0x04,
+		FLAG_PADDED      = 0x08,
+		FLAG_PRIORITY    = 0x20
+	};
+
+	enum ErrorCode
+		/// The error codes sent in RST_STREAM and GOAWAY frames,
+		/// and used as code of a HTTP2Exception.
+	{
+		HTTP2_NO_ERROR            = 0x0,
+		HTTP2_PROTOCOL_ERROR      = 0x1,
+		HTTP2_INTERNAL_ERROR      = 0x2,
+		HTTP2_FLOW_CONTROL_ERROR  = 0x3,
+		HTTP2_SETTINGS_TIMEOUT    = 0x4,
+		HTTP2_STREAM_CLOSED       = 0x5,
+		HTTP2_FRAME_SIZE_ERROR    = 0x6,
+		HTTP2_REFUSED_STREAM      = 0x7,
+		HTTP2_CANCEL              = 0x8,
+		HTTP2_COMPRESSION_ERROR   = 0x9,
+		HTTP2_CONNECT_ERROR       = 0xa,
+		HTTP2_ENHANCE_YOUR_CALM   = 0xb,
+		HTTP2_INADEQUATE_SECURITY = 0xc,
+		HTTP2_HTTP_1_1_REQUIRED   = 0xd
+	};
+
+	enum Setting
+	{
+		SETTINGS_HEADER_TABLE_SIZE      = 0x1,
+		SETTINGS_ENABLE_PUSH            = 0x2,
+		SETTINGS_MAX_CONCURRENT_STREAMS = 0x3,
+		SETTINGS_INITIAL_WINDOW_SIZE    = 0x4,
+		SETTINGS_MAX_FRAME_SIZE         = 0x5,
+		SETTINGS_MAX_HEADER_LIST_SIZE   = 0x6
+	};
+
+	enum
+	{
+		HEADER_SIZE            = 9,
+		DEFAULT_MAX_FRAME_SIZE = 16384,
+		MAX_FRAME_SIZE         = 16777215,
+		DEFAULT_WINDOW_SIZE    = 65535,
+		MAX_WINDOW_SIZE        = 0x7fffffff,
+		DEFAULT_TABLE_SIZE     = 4096
+	};
+
+	static const std::string PREFACE;
+		/// The client connection preface
+		/// ("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n").
+
+	HTTP2Frame();
+		/// Creates an empty DATA frame for stream 0.
+
+	HTTP2Frame(Type type, int flags, Poco::UInt32 streamId);
+		/// Creates a frame with the given type, flags
+		/// and stream identifier, and an empty payload.
+
+	~HTTP2Frame();
+		/// Destroys the HTTP2Frame.
+
+	Type type() const;
+		/// Returns the frame type. This may be a value
+		/// not defined in Type for an extension frame.
+
+	int flags() const;
+		/// Returns the flags.
+
+	bool hasFlag(int flag) const;
+		/// Returns true iff the given flag is set.
+
+	Poco::UInt32 streamId() const;
+		/// Returns the stream identifier.
+
+	std::string& payload();
+		/// Returns the payload.
+
+	const std::string& payload() const;
+		/// Returns the payload.
+
+	std::size_t parseHeader(const char* pHeader);
+		/// Sets type, flags and stream identifier from the given
+		/// HEADER_SIZE bytes, and returns the payload length.
+
+	void formatHeader(char* pHeader) const;
+		/// Writes the frame header (HEADER_SIZE bytes), with the
+		/// length of the current payload, to pHeader.
+
+	static void formatHeader(char* pHeader, std::size_t length, int type, int flags, Poco::UInt32 streamId);
+		/// Writes the given frame header (HEADER_SIZE bytes) to pHeader.
+
+	static void appendUInt32(std::string& buffer, Poco::UInt32 value);
+		/// Appends the given value in network byte order.
+
+	static Poco::UInt32 parseUInt32(const char* p);
+		/// Returns the value in network byte order at p.
+
+private:
+	Type _type;
+	int _flags;
+	Poco::UInt32 _streamId;
+	std::string _payload;
+};
+
+
+//
+// inlines
+//
+inline HTTP2Frame::Type HTTP2Frame::type() const
+{
+	return _type;
+}
+
+
+inline int HTTP2Frame::flags() const
+{
+	return _flags;
+}
+
+
+inline bool HTTP2Frame::hasFlag(int flag) const
+{
+	return (_flags & flag) != 0;
+}
+
+
+inline Poco::UInt32 HTTP2Frame::streamId() const
+{
+	return _streamId;
+}
+
+
+inline std::string& HTTP2Frame::payload()
+{
+	return _payload;
+}
+
+
+inline const std::string& HTTP2Frame::payload() const
+{
+	return _payload;
+}
+
+
+inline Poco::UInt32 HTTP2Frame::parseUInt32(const char* p)
+{
+	const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+	return (Poco::UInt32(u[0]) << 24) | (Poco::UInt32(u[1]) << 16) | (Poco::UInt32(u[2]) << 8) | Poco::UInt32(u[3]);
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTP2Frame_INCLUDED
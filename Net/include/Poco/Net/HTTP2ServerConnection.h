@@ -0,0 +1,105 @@
+//
+// HTTP2ServerConnection.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2ServerConnection
+//
+// Definition of the HTTP2ServerConnection class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTP2ServerConnection_INCLUDED
+#define Net_HTTP2ServerConnection_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTP2Connection.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/SocketAddress.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class HTTPRequest;
+
+
+class Net_API HTTP2ServerConnection: public HTTP2Connection
+	/// The server side of a HTTP/2 connection.
+	///
+	/// HTTPServerConnection hands a connection over to a
+	/// HTTP2ServerConnection if HTTP/2 is enabled in the
+	/// HTTPServerParams, and the client either starts the connection
+	/// with the HTTP/2 connection preface, upgrades it with a
+	/// "Upgrade: h2c" request, or has negotiated the "h2" protocol
+	/// with ALPN on a secure connection.
+	///
+	/// Every request is passed to a HTTPRequestHandler created by
+	/// the HTTPRequestHandlerFactory, exactly like for HTTP/1.x, with
+	/// a HTTP2ServerRequest and a HTTP2ServerResponse.
+	///
+	/// The handlers of a connection are run one after another in the
+	/// connection's thread. Among the requests received, the one with
+	/// the lowest urgency is handled first (see HTTP2Connection).
+	/// While a handler waits for request data or flow control credit,
+	/// frames for all streams are processed, and the responses of
+	/// earlier requests, which are still waiting for credit, are sent
+	/// in order of priority together with the handler's output.
+{
+public:
+	HTTP2ServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory);
+		/// Creates the HTTP2ServerConnection.
+
+	~HTTP2ServerConnection();
+		/// Destroys the HTTP2ServerConnection.
+
+	bool upgrade(const HTTPRequest& request);
+		/// Prepares the connection for an upgrade from HTTP/1.1
+		/// (RFC 7540, section 3.2). The settings in the request's
+		/// HTTP2-Settings header are applied, and the request becomes
+		/// stream 1, which is handled first by run().
+		///
+		/// Returns false if the HTTP2-Settings header is invalid,
+		/// in which case the upgrade must not take place.
+
+	void run();
+		/// Handles the requests received on the connection,
+		/// until the client closes the connection, or the
+		/// connection is idle for longer than the keep-alive
+		/// timeout.
+
+	static bool isPreface(const HTTPRequest& request);
+		/// Returns true if the given request is the start
+		/// of the HTTP/2 connection preface ("PRI * HTTP/2.0").
+
+	static bool isUpgrade(const HTTPRequest& request);
+		/// Returns true if the given request asks for an
+		/// upgrade to HTTP/2 over plain TCP ("h2c").
+
+protected:
+	void onHeaders(Stream* pStream, Poco::UInt32 streamId, HPACKTable::HeaderList& headers, bool endStream);
+	Stream* nextRequest();
+	void handleRequest(Stream& stream);
+	void sendErrorResponse(Poco::UInt32 streamId, HTTPResponse::HTTPStatus status);
+
+private:
+	HTTPServerParams::Ptr          _pParams;
+	HTTPRequestHandlerFactory::Ptr _pFactory;
+	SocketAddress                  _clientAddress;
+	SocketAddress                  _serverAddress;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTP2ServerConnection_INCLUDED
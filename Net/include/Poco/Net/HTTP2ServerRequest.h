@@ -0,0 +1,137 @@
+//
+// HTTP2ServerRequest.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2ServerRequest
+//
+// Definition of the HTTP2ServerRequest class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTP2ServerRequest_INCLUDED
+#define Net_HTTP2ServerRequest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTP2Stream.h"
+#include "Poco/Net/HPACKTable.h"
+#include "Poco/Net/SocketAddress.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class HTTP2Connection;
+class HTTP2ServerResponse;
+
+
+class Net_API HTTP2ServerRequest: public HTTPServerRequest
+	/// This subclass of HTTPServerRequest is used for
+	/// representing requests received over HTTP/2.
+	///
+	/// The request method, URI and host are taken from the
+	/// :method, :path and :authority pseudo-header fields.
+	/// The version is "HTTP/2.0".
+{
+public:
+	HTTP2ServerRequest(HTTP2Connection& connection, Poco::UInt32 streamId, const HPACKTable::HeaderList& headers, HTTP2ServerResponse& response, HTTPServerParams* pParams, const SocketAddress& clientAddress, const SocketAddress& serverAddress);
+		/// Creates the HTTP2ServerRequest from the header
+		/// fields received for the given stream.
+		///
+		/// Throws a HTTP2Exception with code HTTP2_PROTOCOL_ERROR
+		/// if the header fields do not form a valid request
+		/// (RFC 9113, section 8.3).
+
+	~HTTP2ServerRequest();
+		/// Destroys the HTTP2ServerRequest.
+
+	std::istream& stream();
+		/// Returns the input stream for reading
+		/// the request body.
+
+	const SocketAddress& clientAddress() const;
+		/// Returns the client's address.
+
+	const SocketAddress& serverAddress() const;
+		/// Returns the server's address.
+
+	const HTTPServerParams& serverParams() const;
+		/// Returns a reference to the server parameters.
+
+	HTTPServerResponse& response() const;
+		/// Returns a reference to the associated response.
+
+	bool secure() const;
+		/// Returns true if the request is using a secure
+		/// connection.
+
+	Poco::UInt32 streamId() const;
+		/// Returns the HTTP/2 stream identifier.
+
+	static bool isConnectionHeader(const std::string& name);
+		/// Returns true if the given (lowercase) header field is
+		/// connection-specific and thus not allowed in HTTP/2.
+
+private:
+	HTTP2ServerResponse&            _response;
+	HTTP2InputStream                _stream;
+	Poco::UInt32                    _streamId;
+	Poco::AutoPtr<HTTPServerParams> _pParams;
+	SocketAddress                   _clientAddress;
+	SocketAddress                   _serverAddress;
+	bool                            _secure;
+};
+
+
+//
+// inlines
+//
+inline std::istream& HTTP2ServerRequest::stream()
+{
+	return _stream;
+}
+
+
+inline const SocketAddress& HTTP2ServerRequest::clientAddress() const
+{
+	return _clientAddress;
+}
+
+
+inline const SocketAddress& HTTP2ServerRequest::serverAddress() const
+{
+	return _serverAddress;
+}
+
+
+inline const HTTPServerParams& HTTP2ServerRequest::serverParams() const
+{
+	return *_pParams;
+}
+
+
+inline bool HTTP2ServerRequest::secure() const
+{
+	return _secure;
+}
+
+
+inline Poco::UInt32 HTTP2ServerRequest::streamId() const
+{
+	return _streamId;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTP2ServerRequest_INCLUDED
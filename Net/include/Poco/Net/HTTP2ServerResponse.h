@@ -0,0 +1,148 @@
+//
+// HTTP2ServerResponse.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2ServerResponse
+//
+// Definition of the HTTP2ServerResponse class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTP2ServerResponse_INCLUDED
+#define Net_HTTP2ServerResponse_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTPServerResponse.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class HTTP2Connection;
+class HTTP2ServerRequest;
+class HTTP2OutputStream;
+
+
+class Net_API HTTP2ServerResponse: public HTTPServerResponse
+	/// This subclass of HTTPServerResponse is used for
+	/// representing responses sent over HTTP/2.
+	///
+	/// Header field names are sent in lowercase. Connection-specific
+	/// header fields, like Connection or Transfer-Encoding, are not
+	/// sent, as HTTP/2 has its own framing.
+	///
+	/// The response is completed by finish(), which is called
+	/// by HTTP2ServerConnection after the request handler
+	/// has returned.
+{
+public:
+	HTTP2ServerResponse(HTTP2Connection& connection, Poco::UInt32 streamId);
+		/// Creates the HTTP2ServerResponse for the given stream.
+
+	~HTTP2ServerResponse();
+		/// Destroys the HTTP2ServerResponse.
+
+	void sendContinue();
+		/// Sends a 100 Continue response to the
+		/// client.
+
+	std::ostream& send();
+		/// Sends the response header to the client and
+		/// returns an output stream for sending the
+		/// response body.
+		///
+		/// The returned stream is valid until the response
+		/// object is destroyed.
+		///
+		/// Must not be called after sendFile(), sendBuffer()
+		/// or redirect() has been called.
+
+	void sendFile(const std::string& path, const std::string& mediaType);
+		/// Sends the response header to the client, followed
+		/// by the content of the given file.
+		///
+		/// In contrast to HTTPServerResponseImpl, Range
+		/// requests are not supported, so the complete
+		/// file is always sent.
+		///
+		/// Must not be called after send(), sendBuffer()
+		/// or redirect() has been called.
+		///
+		/// Throws a FileNotFoundException if the file
+		/// cannot be found, or an OpenFileException if
+		/// the file cannot be opened.
+
+	void sendBuffer(const void* pBuffer, std::size_t length);
+		/// Sends the response header to the client, followed
+		/// by the contents of the given buffer.
+		///
+		/// Must not be called after send(), sendFile()
+		/// or redirect() has been called.
+
+	void redirect(const std::string& uri, HTTPStatus status = HTTP_FOUND);
+		/// Sets the status code, which must be one of
+		/// HTTP_MOVED_PERMANENTLY (301), HTTP_FOUND (302),
+		/// or HTTP_SEE_OTHER (303),
+		/// and sets the "Location" header field
+		/// to the given URI, which according to
+		/// the HTTP specification, must be absolute.
+		///
+		/// Must not be called after send() has been called.
+
+	void requireAuthentication(const std::string& realm);
+		/// Sets the status code to 401 (Unauthorized)
+		/// and sets the "WWW-Authenticate" header field
+		/// according to the given realm.
+
+	bool sent() const;
+		/// Returns true if the response (header) has been sent.
+
+	void finish();
+		/// Ends the response. If the response header has not
+		/// been sent yet, it is sent without a body. Otherwise,
+		/// the response body stream is flushed and ended.
+
+protected:
+	void attachRequest(HTTP2ServerRequest* pRequest);
+	void sendHeader(bool endStream);
+	bool isHead() const;
+
+private:
+	HTTP2Connection&    _connection;
+	Poco::UInt32        _streamId;
+	HTTP2ServerRequest* _pRequest;
+	std::ostream*       _pStream;
+	HTTP2OutputStream*  _pOutputStream;
+	bool                _sent;
+
+	friend class HTTP2ServerRequest;
+};
+
+
+//
+// inlines
+//
+inline bool HTTP2ServerResponse::sent() const
+{
+	return _sent;
+}
+
+
+inline void HTTP2ServerResponse::attachRequest(HTTP2ServerRequest* pRequest)
+{
+	_pRequest = pRequest;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTP2ServerResponse_INCLUDED
@@ -0,0 +1,95 @@
+//
+// HTTP2Stream.h
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2Stream
+//
+// Definition of the HTTP2Stream class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTP2Stream_INCLUDED
+#define Net_HTTP2Stream_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTPBasicStreamBuf.h"
+#include <istream>
+#include <ostream>
+
+
+namespace Poco {
+namespace Net {
+
+
+class HTTP2Connection;
+
+
+class Net_API HTTP2StreamBuf: public HTTPBasicStreamBuf
+	/// This is the streambuf class used for reading and writing
+	/// the message body of a HTTP/2 stream.
+{
+public:
+	typedef HTTPBasicStreamBuf::openmode openmode;
+
+	HTTP2StreamBuf(HTTP2Connection& connection, Poco::UInt32 streamId, openmode mode);
+	~HTTP2StreamBuf();
+	void close();
+
+protected:
+	int readFromDevice(char* buffer, std::streamsize length);
+	int writeToDevice(const char* buffer, std::streamsize length);
+
+private:
+	HTTP2Connection& _connection;
+	Poco::UInt32 _streamId;
+	bool _closed;
+};
+
+
+class Net_API HTTP2IOS: public virtual std::ios
+	/// The base class for HTTP2InputStream and HTTP2OutputStream.
+{
+public:
+	HTTP2IOS(HTTP2Connection& connection, Poco::UInt32 streamId, HTTP2StreamBuf::openmode mode);
+	~HTTP2IOS();
+	HTTP2StreamBuf* rdbuf();
+
+protected:
+	HTTP2StreamBuf _buf;
+};
+
+
+class Net_API HTTP2InputStream: public HTTP2IOS, public std::istream
+	/// This class is for internal use by HTTP2Connection only.
+{
+public:
+	HTTP2InputStream(HTTP2Connection& connection, Poco::UInt32 streamId);
+	~HTTP2InputStream();
+};
+
+
+class Net_API HTTP2OutputStream: public HTTP2IOS, public std::ostream
+	/// This class is for internal use by HTTP2Connection only.
+	///
+	/// The stream is ended when close() is called.
+{
+public:
+	HTTP2OutputStream(HTTP2Connection& connection, Poco::UInt32 streamId);
+	~HTTP2OutputStream();
+
+	void close();
+		/// Flushes the stream and ends the HTTP/2 stream.
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTP2Stream_INCLUDED
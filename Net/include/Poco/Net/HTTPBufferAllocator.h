@@ -29,18 +29,40 @@ namespace Net {
 
 class Net_API HTTPBufferAllocator
 	/// A BufferAllocator for HTTP streams.
+	///
+	/// Buffers are allocated in three size classes (4, 16
+	/// and 64 KB); the size requested is rounded up to the
+	/// next size class. Buffers larger than 64 KB are
+	/// allocated directly with new[].
+	///
+	/// Every thread keeps a small cache of free buffers for
+	/// every size class, so that most allocations and
+	/// deallocations do not need any synchronization. Only if
+	/// the cache of a thread is empty (or full), buffers are
+	/// taken from (or returned to) a MemoryPool shared by all
+	/// threads. A buffer can be deallocated by a different
+	/// thread than the one that allocated it.
 {
 public:
 	static char* allocate(std::streamsize size);
+		/// Allocates a buffer of at least the given size.
+
 	static void deallocate(char* ptr, std::streamsize size);
+		/// Releases a buffer. The given size must be the
+		/// size that has been passed to allocate().
+
+	static std::streamsize capacity(std::streamsize size);
+		/// Returns the actual size of a buffer allocated
+		/// for the given size.
 
 	enum
 	{
-		BUFFER_SIZE = 4096
+		BUFFER_SIZE = 4096,
+			/// The default buffer size for HTTP sessions and streams.
+		SMALL_BUFFER_SIZE = 4096,
+		MEDIUM_BUFFER_SIZE = 16384,
+		LARGE_BUFFER_SIZE = 65536
 	};
-
-private:
-	static Poco::MemoryPool _pool;
 };
 
 
@@ -304,6 +304,9 @@ protected:
 
 	int write(const char* buffer, std::streamsize length);
 		/// Tries to re-connect if keep-alive is on.
+
+	int write(const SocketBufVec& buffers);
+		/// Tries to re-connect if keep-alive is on.
 	
 	virtual std::string proxyRequestPrefix() const;
 		/// Returns the prefix prepended to the URI for proxy requests
@@ -350,6 +353,7 @@ private:
 	HTTPClientSession& operator = (const HTTPClientSession&);
 
 	friend class WebSocket;
+	friend class HTTPClientSessionPool;
 };
 
 
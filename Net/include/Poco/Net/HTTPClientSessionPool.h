@@ -0,0 +1,246 @@
+//
+// HTTPClientSessionPool.h
+//
+// Library: Net
+// Package: HTTPClient
+// Module:  HTTPClientSessionPool
+//
+// Definition of the HTTPClientSessionPool class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPClientSessionPool_INCLUDED
+#define Net_HTTPClientSessionPool_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include <vector>
+#include <map>
+
+
+namespace Poco {
+
+
+class URI;
+
+
+namespace Net {
+
+
+class Net_API HTTPClientSessionPool
+	/// A pool of persistent HTTPClientSession objects.
+	///
+	/// Sessions are leased with acquire() and given back with
+	/// release() once the response has been read completely.
+	/// Released sessions that are still connected are kept
+	/// as idle sessions, keyed by scheme, host, port and proxy,
+	/// and handed out again by the next acquire() for the same
+	/// server, saving the cost of setting up a new connection.
+	///
+	/// Before an idle session is handed out, it is validated:
+	/// sessions that have been idle for longer than the idle
+	/// timeout, whose keep-alive timeout has expired, or whose
+	/// connection has been closed by the server are discarded.
+	///
+	/// The number of sessions (leased and idle) per server can
+	/// be limited. If the limit is reached, acquire() waits for
+	/// a session to be released, up to the wait timeout.
+	///
+	/// Sessions for schemes other than http are created with
+	/// the default HTTPSessionFactory, so, e.g., https requires
+	/// HTTPSSessionInstantiator to be registered.
+	///
+	/// All sessions must be released (or discarded) before
+	/// the pool is destroyed. Holding the pool in a Ptr
+	/// (as HTTPStreamFactory does) takes care of that.
+{
+public:
+	typedef Poco::SharedPtr<HTTPClientSessionPool> Ptr;
+
+	enum
+	{
+		DEFAULT_MAX_SESSIONS_PER_HOST = 16,
+		DEFAULT_IDLE_TIMEOUT          = 30, /// seconds
+		DEFAULT_WAIT_TIMEOUT          = 10  /// seconds
+	};
+
+	HTTPClientSessionPool(int maxSessionsPerHost = DEFAULT_MAX_SESSIONS_PER_HOST,
+		const Poco::Timespan& idleTimeout = Poco::Timespan(DEFAULT_IDLE_TIMEOUT, 0),
+		const Poco::Timespan& waitTimeout = Poco::Timespan(DEFAULT_WAIT_TIMEOUT, 0));
+		/// Creates the HTTPClientSessionPool.
+		///
+		/// Sessions use the global proxy configuration
+		/// (see HTTPClientSession::setGlobalProxyConfig())
+		/// unless a different one is set with setProxyConfig().
+
+	~HTTPClientSessionPool();
+		/// Destroys the HTTPClientSessionPool and all idle sessions.
+
+	HTTPClientSession* acquire(const Poco::URI& uri);
+		/// Returns a session for the scheme, host and port of
+		/// the given URI. See acquire(scheme, host, port).
+
+	HTTPClientSession* acquire(const std::string& scheme, const std::string& host, Poco::UInt16 port);
+		/// Returns an idle session for the given server, or
+		/// a new, not yet connected session if there is none.
+		///
+		/// The session must be given back with release() or
+		/// discard(), and must not be deleted by the caller.
+		///
+		/// Throws a TimeoutException if the maximum number of
+		/// sessions for the server is in use and none has been
+		/// released within the wait timeout.
+
+	void release(HTTPClientSession* pSession);
+		/// Gives back a session obtained from acquire().
+		///
+		/// The response (if any) must have been read completely.
+		/// If the session is still connected and keep-alive
+		/// is enabled, it is kept for reuse. Otherwise, it
+		/// is deleted.
+
+	void discard(HTTPClientSession* pSession);
+		/// Gives back a session obtained from acquire()
+		/// and deletes it, e.g. because the response has
+		/// not been read completely, or an error occurred.
+
+	bool owns(HTTPClientSession* pSession) const;
+		/// Returns true if the given session has been
+		/// leased from this pool and not yet given back.
+
+	void purge();
+		/// Deletes all idle sessions whose idle timeout has expired.
+		///
+		/// Expired sessions are also removed whenever a session
+		/// for the same server is acquired or released.
+
+	void setProxyConfig(const HTTPClientSession::ProxyConfig& config);
+		/// Sets the proxy configuration for new sessions.
+
+	HTTPClientSession::ProxyConfig getProxyConfig() const;
+		/// Returns the proxy configuration for new sessions.
+
+	int maxSessionsPerHost() const;
+		/// Returns the maximum number of sessions per server.
+
+	const Poco::Timespan& idleTimeout() const;
+		/// Returns the time after which an idle session is discarded.
+
+	const Poco::Timespan& waitTimeout() const;
+		/// Returns the maximum time acquire() waits for a session.
+
+	int idle() const;
+		/// Returns the number of idle sessions.
+
+	int leased() const;
+		/// Returns the number of leased sessions.
+
+	int hits() const;
+		/// Returns the number of acquire() calls that
+		/// returned an idle session.
+
+	int misses() const;
+		/// Returns the number of acquire() calls that
+		/// created a new session.
+
+	int waits() const;
+		/// Returns the number of acquire() calls that had
+		/// to wait for a session to be released.
+
+	int timeouts() const;
+		/// Returns the number of acquire() calls that timed
+		/// out waiting for a session to be released.
+
+protected:
+	struct IdleSession
+	{
+		HTTPClientSession* pSession;
+		Poco::Timestamp idleSince;
+	};
+
+	struct Host
+	{
+		Host(): leased(0)
+		{
+		}
+
+		std::vector<IdleSession> idle;
+		int leased;
+	};
+
+	typedef std::map<std::string, Host> HostMap;
+	typedef std::map<HTTPClientSession*, std::string> LeaseMap;
+
+	std::string key(const std::string& scheme, const std::string& host, Poco::UInt16 port) const;
+		/// Returns the key identifying a server.
+		/// Must be called with _mutex locked.
+
+	HTTPClientSession* createSession(const std::string& scheme, const std::string& host, Poco::UInt16 port);
+		/// Creates a new session for the given server.
+		/// Must be called with _mutex locked.
+
+	bool isReusable(const IdleSession& idle, const Poco::Timestamp& now) const;
+		/// Returns true if the given idle session can be handed out again.
+
+	void purge(Host& host, const Poco::Timestamp& now);
+		/// Deletes all expired idle sessions of the given server.
+
+	void giveBack(HTTPClientSession* pSession, bool keep);
+		/// Implements release() and discard().
+
+private:
+	HTTPClientSessionPool(const HTTPClientSessionPool&);
+	HTTPClientSessionPool& operator = (const HTTPClientSessionPool&);
+
+	int _maxSessionsPerHost;
+	Poco::Timespan _idleTimeout;
+	Poco::Timespan _waitTimeout;
+	HTTPClientSession::ProxyConfig _proxyConfig;
+	HostMap _hosts;
+	LeaseMap _leases;
+	int _idle;
+	int _hits;
+	int _misses;
+	int _waits;
+	int _timeouts;
+	mutable Poco::FastMutex _mutex;
+	Poco::Condition _released;
+};
+
+
+//
+// inlines
+//
+inline int HTTPClientSessionPool::maxSessionsPerHost() const
+{
+	return _maxSessionsPerHost;
+}
+
+
+inline const Poco::Timespan& HTTPClientSessionPool::idleTimeout() const
+{
+	return _idleTimeout;
+}
+
+
+inline const Poco::Timespan& HTTPClientSessionPool::waitTimeout() const
+{
+	return _waitTimeout;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPClientSessionPool_INCLUDED
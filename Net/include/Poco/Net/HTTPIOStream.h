@@ -21,6 +21,7 @@
 #include "Poco/Net/Net.h"
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/UnbufferedStreamBuf.h"
+#include "Poco/SharedPtr.h"
 
 
 namespace Poco {
@@ -28,6 +29,7 @@ namespace Net {
 
 
 class HTTPClientSession;
+class HTTPClientSessionPool;
 
 
 class Net_API HTTPResponseStreamBuf: public Poco::UnbufferedStreamBuf
@@ -74,11 +76,20 @@ class Net_API HTTPResponseStream: public HTTPResponseIOS, public std::istream
 {
 public:
 	HTTPResponseStream(std::istream& istr, HTTPClientSession* pSession);
+		/// Creates the HTTPResponseStream, which takes ownership
+		/// of the session.
+
+	HTTPResponseStream(std::istream& istr, HTTPClientSession* pSession, Poco::SharedPtr<HTTPClientSessionPool> pPool);
+		/// Creates the HTTPResponseStream for a session leased
+		/// from the given pool. When the stream is destroyed, the
+		/// session is released to the pool if the response has been
+		/// read completely, or discarded otherwise.
 		
 	~HTTPResponseStream();
 	
 private:
 	HTTPClientSession* _pSession;
+	Poco::SharedPtr<HTTPClientSessionPool> _pPool;
 };
 
 
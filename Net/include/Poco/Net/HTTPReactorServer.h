@@ -0,0 +1,236 @@
+//
+// HTTPReactorServer.h
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPReactorServer
+//
+// Definition of the HTTPReactorServer class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPReactorServer_INCLUDED
+#define Net_HTTPReactorServer_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/NotificationQueue.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Thread.h"
+#include "Poco/RunnableAdapter.h"
+#include "Poco/Environment.h"
+#include "Poco/AtomicCounter.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HTTPReactorServer
+	/// A HTTP server that uses non-blocking sockets and a small
+	/// number of SocketReactor threads to wait for requests, and
+	/// a pool of worker threads to handle them.
+	///
+	/// In contrast to HTTPServer, which dedicates a thread to each
+	/// connection for as long as the connection is open, a worker
+	/// thread is only needed while a request is being handled.
+	/// This allows the server to keep a large number of idle
+	/// persistent connections open with a small number of threads.
+	///
+	/// Connections are accepted by a SocketReactor running in its
+	/// own thread, and distributed in round-robin fashion over the
+	/// connection reactors. A connection reactor receives the request
+	/// header without blocking. Once the header is complete, the
+	/// connection is queued for the next available worker thread,
+	/// which handles the request, as well as any further requests
+	/// the client has pipelined, in blocking mode, exactly like
+	/// HTTPServer does. Therefore, the same HTTPRequestHandler and
+	/// HTTPRequestHandlerFactory classes can be used. Afterwards, the
+	/// connection is handed back to its reactor to wait for the next
+	/// request.
+	///
+	/// The following HTTPServerParams settings are used:
+	///   - maxThreads: the number of worker threads (default 16 if 0).
+	///   - maxQueued: the maximum number of connections with a
+	///     complete request waiting for a worker thread. Connections
+	///     exceeding this limit are closed.
+	///   - timeout: the maximum time for receiving a request header.
+	///   - keepAlive, keepAliveTimeout and maxKeepAliveRequests:
+	///     control persistent connections, as with HTTPServer.
+	///   - threadPriority, softwareVersion: as with HTTPServer.
+	///
+	/// A handler that detaches the socket from the request (e.g.,
+	/// to upgrade the connection to a WebSocket) takes over the
+	/// connection, which is then no longer managed by the server.
+{
+public:
+	HTTPReactorServer(HTTPRequestHandlerFactory::Ptr pFactory, const ServerSocket& socket, HTTPServerParams::Ptr pParams, unsigned reactors = Poco::Environment::processorCount());
+		/// Creates the HTTPReactorServer, using the given ServerSocket,
+		/// which must be bound and in listening state, and the given
+		/// number of connection reactor threads.
+		///
+		/// The server takes ownership of the HTTPRequestHandlerFactory
+		/// and of the HTTPServerParams object.
+
+	~HTTPReactorServer();
+		/// Stops the server, if necessary, and destroys it.
+
+	void start();
+		/// Starts the server. Connection and worker threads
+		/// are started, and the server begins to accept
+		/// connections.
+
+	void stop();
+		/// Stops the server. No new connections are accepted,
+		/// requests currently being handled are completed, and
+		/// all connections are closed.
+
+	Poco::UInt16 port() const;
+		/// Returns the number of the port the server is listening on.
+
+	const HTTPServerParams& params() const;
+		/// Returns a const reference to the HTTPServerParams object
+		/// used by the server.
+
+	int totalConnections() const;
+		/// Returns the total number of connections accepted
+		/// since the server was started.
+
+	int currentConnections() const;
+		/// Returns the number of currently open connections.
+
+	int idleConnections() const;
+		/// Returns the number of connections currently
+		/// waiting for a request in a reactor.
+
+	int queuedConnections() const;
+		/// Returns the number of connections with a complete
+		/// request waiting for a worker thread.
+
+	int refusedConnections() const;
+		/// Returns the number of connections that have been
+		/// closed because too many requests were queued.
+
+	int totalRequests() const;
+		/// Returns the total number of requests handled.
+
+protected:
+	class Connection;
+	class Reactor;
+	class Acceptor;
+	class ConnectionNotification;
+
+	void enqueue(Connection* pConnection);
+		/// Queues a connection with a complete request for the
+		/// next available worker thread, or closes the connection
+		/// if the queue is full.
+
+	Connection* dequeue();
+		/// Returns the next queued connection, or null if none
+		/// has become available within a short time.
+
+	void work();
+		/// The worker thread's main loop. Handles the requests of
+		/// queued connections until the server is stopped.
+
+	bool stopped() const;
+		/// Returns true if the server has been stopped.
+
+private:
+	HTTPReactorServer();
+	HTTPReactorServer(const HTTPReactorServer&);
+	HTTPReactorServer& operator = (const HTTPReactorServer&);
+
+	HTTPRequestHandlerFactory::Ptr _pFactory;
+	HTTPServerParams::Ptr _pParams;
+	ServerSocket _socket;
+	unsigned _reactors;
+	int _workers;
+	SocketReactor _acceptReactor;
+	Poco::Thread _acceptThread;
+	Acceptor* _pAcceptor;
+	Poco::ThreadPool _threadPool;
+	Poco::RunnableAdapter<HTTPReactorServer> _worker;
+	Poco::NotificationQueue _queue;
+	bool _stopped;
+	Poco::AtomicCounter _totalConnections;
+	Poco::AtomicCounter _currentConnections;
+	Poco::AtomicCounter _idleConnections;
+	Poco::AtomicCounter _refusedConnections;
+	Poco::AtomicCounter _totalRequests;
+
+	friend class Connection;
+	friend class Reactor;
+};
+
+
+//
+// inlines
+//
+inline Poco::UInt16 HTTPReactorServer::port() const
+{
+	return _socket.address().port();
+}
+
+
+inline const HTTPServerParams& HTTPReactorServer::params() const
+{
+	return *_pParams;
+}
+
+
+inline int HTTPReactorServer::totalConnections() const
+{
+	return _totalConnections.value();
+}
+
+
+inline int HTTPReactorServer::currentConnections() const
+{
+	return _currentConnections.value();
+}
+
+
+inline int HTTPReactorServer::idleConnections() const
+{
+	return _idleConnections.value();
+}
+
+
+inline int HTTPReactorServer::queuedConnections() const
+{
+	return _queue.size();
+}
+
+
+inline int HTTPReactorServer::refusedConnections() const
+{
+	return _refusedConnections.value();
+}
+
+
+inline int HTTPReactorServer::totalRequests() const
+{
+	return _totalRequests.value();
+}
+
+
+inline bool HTTPReactorServer::stopped() const
+{
+	return _stopped;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPReactorServer_INCLUDED
@@ -0,0 +1,366 @@
+//
+// HTTPRequestParser.h
+//
+// Library: Net
+// Package: HTTP
+// Module:  HTTPRequestParser
+//
+// Definition of the HTTPRequestParser class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPRequestParser_INCLUDED
+#define Net_HTTPRequestParser_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+
+namespace Poco {
+namespace Net {
+
+
+class HTTPRequest;
+
+
+class Net_API HTTPRequestParser
+	/// An incremental parser for the request line and header
+	/// fields of a HTTP request.
+	///
+	/// The parser works directly on the bytes received from the
+	/// network and does not copy them. Instead, it records the
+	/// positions of the method, URI, version and of the names and
+	/// values of all header fields, which can be obtained as Slice
+	/// objects. A HTTPRequest (and its NameValueCollection) is only
+	/// built from these slices when apply() is called.
+	///
+	/// Parsing can be resumed if the request header is not yet
+	/// complete. In this case, parse() must be called again with
+	/// a buffer that contains all bytes passed in the previous
+	/// call, followed by the newly received bytes. The buffer may
+	/// have been moved in the meantime, as the parser only stores
+	/// offsets. Alternatively, feed() can be used to let the parser
+	/// accumulate the bytes in an internal buffer.
+	///
+	/// The same limits as for HTTPRequest::read() apply. Header fields
+	/// are parsed the same way as by MessageHeader::read(), including
+	/// support for folded values.
+{
+public:
+	class Net_API Slice
+		/// A reference to a sequence of characters in the
+		/// buffer passed to the parser, similar to std::string_view.
+		///
+		/// A Slice is only valid as long as the buffer it refers
+		/// to is valid and unchanged.
+	{
+	public:
+		Slice();
+			/// Creates an empty Slice.
+
+		Slice(const char* data, std::size_t size);
+			/// Creates a Slice referring to the given characters.
+
+		const char* data() const;
+			/// Returns a pointer to the first character.
+
+		std::size_t size() const;
+			/// Returns the number of characters.
+
+		bool empty() const;
+			/// Returns true if the Slice is empty.
+
+		std::string toString() const;
+			/// Returns a copy of the characters as std::string.
+
+		bool equals(const char* str) const;
+			/// Returns true if the Slice contains the same
+			/// characters as the given string.
+
+		bool equalsIgnoreCase(const char* str) const;
+			/// Returns true if the Slice contains the same
+			/// characters as the given string, ignoring case.
+
+	private:
+		const char* _data;
+		std::size_t _size;
+	};
+
+	enum Status
+	{
+		PARSE_INCOMPLETE, /// more data is needed
+		PARSE_COMPLETE    /// the request header has been parsed completely
+	};
+
+	HTTPRequestParser();
+		/// Creates the HTTPRequestParser.
+
+	~HTTPRequestParser();
+		/// Destroys the HTTPRequestParser.
+
+	Status parse(const char* buffer, std::size_t length);
+		/// Parses the request header contained in the given buffer,
+		/// which must start with the first byte of the request.
+		///
+		/// If the header is complete, returns PARSE_COMPLETE, and
+		/// consumed() returns the size of the header. Any remaining
+		/// bytes in the buffer belong to the request body or to the
+		/// next request.
+		///
+		/// Otherwise, returns PARSE_INCOMPLETE. Parsing continues
+		/// where it stopped with the next call to parse().
+		///
+		/// Throws a NoMessageException if the buffer is empty, and
+		/// a MessageException if the request header is invalid.
+
+	Status feed(const char* buffer, std::size_t length);
+		/// Appends the given bytes to the internal buffer
+		/// and parses them. See parse().
+		///
+		/// After the header is complete, the bytes following
+		/// it can be obtained with remaining().
+
+	void reset();
+		/// Resets the parser for a new request. Internal
+		/// buffers are kept to avoid memory allocations.
+
+	Status status() const;
+		/// Returns the status of the last call to parse().
+
+	std::size_t consumed() const;
+		/// Returns the number of bytes of the request header,
+		/// including the terminating empty line.
+		///
+		/// Only valid if the header is complete.
+
+	Slice remaining() const;
+		/// Returns the bytes following the request header in the
+		/// buffer last passed to parse(), or in the internal buffer
+		/// if feed() has been used.
+
+	Slice method() const;
+		/// Returns the request method.
+
+	Slice uri() const;
+		/// Returns the request URI.
+
+	Slice version() const;
+		/// Returns the HTTP version string.
+
+	std::size_t fields() const;
+		/// Returns the number of header fields parsed so far.
+
+	Slice name(std::size_t index) const;
+		/// Returns the name of the header field with the given index.
+
+	Slice value(std::size_t index) const;
+		/// Returns the value of the header field with the given index.
+		///
+		/// The value of a folded header field still
+		/// contains the line breaks.
+
+	Slice find(const char* name) const;
+		/// Returns the value of the first header field with
+		/// the given name (ignoring case), or an empty
+		/// Slice if there is no such field.
+
+	bool has(const char* name) const;
+		/// Returns true if there is a header field
+		/// with the given name (ignoring case).
+
+	void setFieldLimit(int limit);
+		/// Sets the maximum number of header fields.
+		/// A value of 0 means no limit.
+
+	int getFieldLimit() const;
+		/// Returns the maximum number of header fields.
+
+	void apply(HTTPRequest& request) const;
+		/// Sets method, URI, version and header fields of the given
+		/// HTTPRequest. RFC 2047 encoded words in field values are
+		/// decoded, and folded values are unfolded, as by
+		/// MessageHeader::read().
+		///
+		/// The header must be complete.
+
+private:
+	HTTPRequestParser(const HTTPRequestParser&);
+	HTTPRequestParser& operator = (const HTTPRequestParser&);
+
+	enum Limits
+	{
+		MAX_METHOD_LENGTH  = 32,
+		MAX_URI_LENGTH     = 16384,
+		MAX_VERSION_LENGTH = 8,
+		MAX_NAME_LENGTH    = 256,
+		MAX_VALUE_LENGTH   = 8192,
+		DFL_FIELD_LIMIT    = 100
+	};
+
+	enum State
+	{
+		STATE_REQUEST_LINE,
+		STATE_FIELDS,
+		STATE_DONE
+	};
+
+	struct Range
+	{
+		std::size_t offset;
+		std::size_t length;
+	};
+
+	struct Field
+	{
+		Range name;
+		Range value;
+		bool folded;
+	};
+
+	void parseRequestLine(std::size_t begin, std::size_t end);
+	void parseField(std::size_t begin, std::size_t end);
+	Slice slice(const Range& range) const;
+
+	const char* _pBuffer;
+	std::size_t _length;
+	std::size_t _pos;
+	std::size_t _scanned;
+	State _state;
+	Range _method;
+	Range _uri;
+	Range _version;
+	std::vector<Field> _fields;
+	int _fieldLimit;
+	std::vector<char> _buffer;
+};
+
+
+//
+// inlines
+//
+inline HTTPRequestParser::Slice::Slice():
+	_data(0),
+	_size(0)
+{
+}
+
+
+inline HTTPRequestParser::Slice::Slice(const char* data, std::size_t size):
+	_data(data),
+	_size(size)
+{
+}
+
+
+inline const char* HTTPRequestParser::Slice::data() const
+{
+	return _data;
+}
+
+
+inline std::size_t HTTPRequestParser::Slice::size() const
+{
+	return _size;
+}
+
+
+inline bool HTTPRequestParser::Slice::empty() const
+{
+	return _size == 0;
+}
+
+
+inline std::string HTTPRequestParser::Slice::toString() const
+{
+	return std::string(_data, _size);
+}
+
+
+inline HTTPRequestParser::Status HTTPRequestParser::status() const
+{
+	return _state == STATE_DONE ? PARSE_COMPLETE : PARSE_INCOMPLETE;
+}
+
+
+inline std::size_t HTTPRequestParser::consumed() const
+{
+	return _pos;
+}
+
+
+inline HTTPRequestParser::Slice HTTPRequestParser::method() const
+{
+	return slice(_method);
+}
+
+
+inline HTTPRequestParser::Slice HTTPRequestParser::uri() const
+{
+	return slice(_uri);
+}
+
+
+inline HTTPRequestParser::Slice HTTPRequestParser::version() const
+{
+	return slice(_version);
+}
+
+
+inline std::size_t HTTPRequestParser::fields() const
+{
+	return _fields.size();
+}
+
+
+inline HTTPRequestParser::Slice HTTPRequestParser::name(std::size_t index) const
+{
+	return slice(_fields[index].name);
+}
+
+
+inline HTTPRequestParser::Slice HTTPRequestParser::value(std::size_t index) const
+{
+	return slice(_fields[index].value);
+}
+
+
+inline bool HTTPRequestParser::has(const char* name) const
+{
+	for (std::vector<Field>::const_iterator it = _fields.begin(); it != _fields.end(); ++it)
+	{
+		if (slice(it->name).equalsIgnoreCase(name)) return true;
+	}
+	return false;
+}
+
+
+inline void HTTPRequestParser::setFieldLimit(int limit)
+{
+	_fieldLimit = limit;
+}
+
+
+inline int HTTPRequestParser::getFieldLimit() const
+{
+	return _fieldLimit;
+}
+
+
+inline HTTPRequestParser::Slice HTTPRequestParser::slice(const Range& range) const
+{
+	return Slice(_pBuffer + range.offset, range.length);
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPRequestParser_INCLUDED
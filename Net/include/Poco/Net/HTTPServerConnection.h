@@ -24,6 +24,7 @@
 #include "Poco/Net/HTTPRequestHandlerFactory.h"
 #include "Poco/Net/HTTPServerParams.h"
 #include "Poco/Mutex.h"
+#include <memory>
 
 
 namespace Poco {
@@ -31,11 +32,24 @@ namespace Net {
 
 
 class HTTPServerSession;
+class HTTPServerRequestImpl;
+class HTTPServerResponseImpl;
+class HTTP2ServerConnection;
 
 
 class Net_API HTTPServerConnection: public TCPServerConnection
 	/// This subclass of TCPServerConnection handles HTTP
 	/// connections.
+	///
+	/// Pipelined requests are supported. If further requests
+	/// have already been received when a request without a body
+	/// is handled, its response is held back and sent together with
+	/// the responses to the following requests, with a single write.
+	///
+	/// If HTTP/2 is enabled in the HTTPServerParams, a connection
+	/// is handed over to a HTTP2ServerConnection if the client sends
+	/// the HTTP/2 connection preface, or upgrades its first request
+	/// to "h2c", or has negotiated "h2" with ALPN.
 {
 public:
 	HTTPServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory);
@@ -49,7 +63,9 @@ public:
 
 protected:
 	void sendErrorResponse(HTTPServerSession& session, HTTPResponse::HTTPStatus status);
+	static bool hasBody(const HTTPServerRequest& request);
 	void onServerStopped(const bool& abortCurrent);
+	std::unique_ptr<HTTP2ServerConnection> switchToHTTP2(HTTPServerSession& session, HTTPServerRequestImpl& request, HTTPServerResponseImpl& response);
 
 private:
 	HTTPServerParams::Ptr          _pParams;
@@ -95,6 +95,43 @@ public:
 		/// during a persistent connection, or 0 if
 		/// unlimited connections are allowed.
 
+	void setBufferSize(int size);
+		/// Sets the size of the buffers used for receiving
+		/// requests and for sending and receiving message
+		/// bodies (see HTTPSession::setBufferSize()).
+		///
+		/// The default is HTTPBufferAllocator::BUFFER_SIZE (4 KB).
+		/// Servers transferring large message bodies may want
+		/// to use 16 or 64 KB.
+
+	int getBufferSize() const;
+		/// Returns the size of the buffers used for
+		/// HTTP connections.
+
+	void setHTTP2Enabled(bool enabled);
+		/// Enables (enabled == true) or disables (enabled == false)
+		/// HTTP/2 for connections accepted by HTTPServer.
+		///
+		/// If enabled, clients can use HTTP/2 over plain TCP
+		/// connections, either with prior knowledge, by starting
+		/// the connection with the HTTP/2 connection preface,
+		/// or by upgrading a HTTP/1.1 request (h2c). For secure
+		/// connections, HTTP/2 must be negotiated with ALPN, and
+		/// the connection handled by HTTP2ServerConnection.
+		///
+		/// HTTP/2 is disabled by default.
+
+	bool getHTTP2Enabled() const;
+		/// Returns true iff HTTP/2 is enabled.
+
+	void setHTTP2MaxConcurrentStreams(int maxStreams);
+		/// Sets the maximum number of concurrent streams a client
+		/// can open on a HTTP/2 connection. The default is 100.
+
+	int getHTTP2MaxConcurrentStreams() const;
+		/// Returns the maximum number of concurrent streams
+		/// on a HTTP/2 connection.
+
 protected:
 	virtual ~HTTPServerParams();
 		/// Destroys the HTTPServerParams.
@@ -106,6 +143,9 @@ private:
 	bool           _keepAlive;
 	int            _maxKeepAliveRequests;
 	Poco::Timespan _keepAliveTimeout;
+	int            _bufferSize;
+	bool           _http2Enabled;
+	int            _http2MaxConcurrentStreams;
 };
 
 
@@ -142,12 +182,30 @@ inline int HTTPServerParams::getMaxKeepAliveRequests() const
 }
 
 
+inline int HTTPServerParams::getBufferSize() const
+{
+	return _bufferSize;
+}
+
+
 inline const Poco::Timespan& HTTPServerParams::getKeepAliveTimeout() const
 {
 	return _keepAliveTimeout;
 }
 
 
+inline bool HTTPServerParams::getHTTP2Enabled() const
+{
+	return _http2Enabled;
+}
+
+
+inline int HTTPServerParams::getHTTP2MaxConcurrentStreams() const
+{
+	return _http2MaxConcurrentStreams;
+}
+
+
 } } // namespace Poco::Net
 
 
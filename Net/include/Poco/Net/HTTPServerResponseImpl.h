@@ -67,6 +67,16 @@ public:
 		/// Sends the response header to the client, followed
 		/// by the content of the given file.
 		///
+		/// If the request contains a Range header with a single
+		/// byte range, and the response status is 200 (OK), only
+		/// the requested part of the file is sent with status
+		/// 206 (Partial Content), or status 416 (Requested Range
+		/// Not Satisfiable) is sent if the range lies outside
+		/// the file.
+		///
+		/// Where supported, the file content is transferred by
+		/// the kernel (see StreamSocket::sendFile()).
+		///
 		/// Must not be called after send(), sendBuffer()
 		/// or redirect() has been called.
 		///
@@ -23,7 +23,9 @@
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/Net/HTTPServerSession.h"
 #include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestParser.h"
 #include "Poco/Timespan.h"
+#include "Poco/Clock.h"
 
 
 namespace Poco {
@@ -47,6 +49,45 @@ public:
 	
 	bool canKeepAlive() const;
 		/// Returns true if the session can be kept alive.
+
+	using HTTPSession::buffered;
+		/// Returns the number of bytes received, but not yet read.
+		/// After a request without a body has been received,
+		/// these bytes belong to a pipelined request.
+
+	const HTTPRequestParser& receiveRequest(int fieldLimit);
+		/// Receives and parses the request line and header
+		/// fields of the next request.
+		///
+		/// The header is parsed in place in the session's
+		/// receive buffer, unless it does not fit into the buffer.
+		/// The returned parser's slices are only valid until
+		/// more data is read from the session.
+		///
+		/// Throws a NoMessageException if the client has closed
+		/// the connection, and a MessageException if the request
+		/// header is invalid or incomplete.
+
+	const Poco::Clock& requestStarted() const;
+		/// Returns the time at which the first bytes of the
+		/// request most recently received with receiveRequest()
+		/// were available.
+
+	int receiveAvailable();
+		/// Receives the data available on the session's socket,
+		/// which must be in non-blocking mode, and appends it
+		/// to the receive buffer. Used by HTTPReactorServer.
+		///
+		/// Returns the number of bytes received, 0 if the client
+		/// has closed the connection, or -1 if no data was available.
+
+	bool requestBuffered();
+		/// Returns true if the receive buffer contains a complete
+		/// request header, so that receiveRequest() will not block.
+		///
+		/// Also returns true if the header received so far is invalid,
+		/// or does not fit into the receive buffer, as in these cases
+		/// receiveRequest() must be called to deal with it.
 	
 	SocketAddress clientAddress();
 		/// Returns the client's address.
@@ -55,9 +96,11 @@ public:
 		/// Returns the server's address.
 		
 private:
-	bool           _firstRequest;
-	Poco::Timespan _keepAliveTimeout;
-	int            _maxKeepAliveRequests;
+	bool              _firstRequest;
+	Poco::Timespan    _keepAliveTimeout;
+	int               _maxKeepAliveRequests;
+	HTTPRequestParser _parser;
+	Poco::Clock       _requestStarted;
 };
 
 
@@ -70,6 +113,12 @@ inline bool HTTPServerSession::canKeepAlive() const
 }
 
 
+inline const Poco::Clock& HTTPServerSession::requestStarted() const
+{
+	return _requestStarted;
+}
+
+
 } } // namespace Poco::Net
 
 
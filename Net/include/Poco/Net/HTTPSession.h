@@ -111,6 +111,62 @@ public:
 		/// obtain any data already read from the socket, but not
 		/// yet processed.
 
+	void setWriteCoalescing(bool coalesce);
+		/// Enables or disables write coalescing.
+		///
+		/// While write coalescing is enabled, data written to
+		/// the session is collected in a buffer (up to a limit)
+		/// instead of being sent immediately. The collected data
+		/// is sent with the next write after coalescing has been
+		/// disabled, or when flush() is called.
+		///
+		/// Any collected data is also sent before the session
+		/// reads from the socket, before the socket is detached,
+		/// and when the session is destroyed.
+
+	bool getWriteCoalescing() const;
+		/// Returns true if write coalescing is enabled.
+
+	void flush();
+		/// Sends all data collected while write coalescing
+		/// was enabled.
+
+	int pending() const;
+		/// Returns the number of bytes collected while write
+		/// coalescing was enabled, but not yet sent.
+
+	void setBufferSize(int size);
+		/// Sets the size of the session's receive buffer, and of
+		/// the buffers of the streams used for sending and receiving
+		/// message bodies. The default is HTTPBufferAllocator::BUFFER_SIZE.
+		///
+		/// Larger buffers reduce the number of system calls for
+		/// transfers of large message bodies. Buffers are allocated
+		/// in size classes of 4, 16 and 64 KB, so these sizes
+		/// are recommended.
+		///
+		/// The new size applies to streams created afterwards.
+		/// Data already received is retained; throws an
+		/// IllegalStateException if it does not fit into a
+		/// buffer of the given size.
+
+	int getBufferSize() const;
+		/// Returns the size of the session's buffers.
+
+	std::streamsize sendFile(Poco::FileInputStream& fileInputStream, std::streamoff offset, std::streamsize count);
+		/// Sends any collected data, followed by count bytes
+		/// of the given file, starting at the given offset.
+		///
+		/// See StreamSocket::sendFile() for details.
+
+	Poco::UInt64 bytesReceived() const;
+		/// Returns the number of bytes received from
+		/// the socket by this session.
+
+	Poco::UInt64 bytesSent() const;
+		/// Returns the number of bytes sent over
+		/// the socket by this session.
+
 protected:
 	HTTPSession();
 		/// Creates a HTTP session using an
@@ -152,6 +208,10 @@ protected:
 	virtual int write(const char* buffer, std::streamsize length);
 		/// Writes data to the socket.
 
+	virtual int write(const SocketBufVec& buffers);
+		/// Writes the contents of the given buffers to the
+		/// socket, using a single gather write if possible.
+
 	int receive(char* buffer, int length);
 		/// Reads up to length bytes.
 		
@@ -184,10 +244,14 @@ protected:
 		/// Clears the stored exception.
 
 private:
+	int write(const SocketBuf* pBuffers, std::size_t count);
+		/// Implements the write() overloads.
+
 	enum
 	{
 		HTTP_DEFAULT_TIMEOUT = 60000000,
-		HTTP_DEFAULT_CONNECTION_TIMEOUT = 30000000
+		HTTP_DEFAULT_CONNECTION_TIMEOUT = 30000000,
+		MAX_WRITE_BUFFER_SIZE = 65536
 	};
 	
 	HTTPSession(const HTTPSession&);
@@ -197,17 +261,23 @@ private:
 	char*            _pBuffer;
 	char*            _pCurrent;
 	char*            _pEnd;
+	int              _bufferSize;
 	bool             _keepAlive;
 	Poco::Timespan   _connectionTimeout;
 	Poco::Timespan   _receiveTimeout;
 	Poco::Timespan   _sendTimeout;
 	Poco::Exception* _pException;
 	Poco::Any        _data;
+	std::string      _writeBuffer;
+	bool             _coalesce;
+	Poco::UInt64     _bytesReceived;
+	Poco::UInt64     _bytesSent;
 	
 	friend class HTTPStreamBuf;
 	friend class HTTPHeaderStreamBuf;
 	friend class HTTPFixedLengthStreamBuf;
 	friend class HTTPChunkedStreamBuf;
+	friend class HTTPServerSession;
 };
 
 
@@ -238,6 +308,36 @@ inline const Poco::Exception* HTTPSession::networkException() const
 }
 
 
+inline bool HTTPSession::getWriteCoalescing() const
+{
+	return _coalesce;
+}
+
+
+inline int HTTPSession::pending() const
+{
+	return static_cast<int>(_writeBuffer.size());
+}
+
+
+inline int HTTPSession::getBufferSize() const
+{
+	return _bufferSize;
+}
+
+
+inline Poco::UInt64 HTTPSession::bytesReceived() const
+{
+	return _bytesReceived;
+}
+
+
+inline Poco::UInt64 HTTPSession::bytesSent() const
+{
+	return _bytesSent;
+}
+
+
 inline int HTTPSession::buffered() const
 {
 	return static_cast<int>(_pEnd - _pCurrent);
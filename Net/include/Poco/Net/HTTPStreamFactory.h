@@ -20,6 +20,7 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/HTTPSession.h"
+#include "Poco/Net/HTTPClientSessionPool.h"
 #include "Poco/URIStreamFactory.h"
 
 
@@ -47,6 +48,16 @@ public:
 		/// will be authorized against the proxy using Basic authentication
 		/// with the given proxyUsername and proxyPassword.
 
+	explicit HTTPStreamFactory(HTTPClientSessionPool::Ptr pPool);
+		/// Creates the HTTPStreamFactory.
+		///
+		/// HTTP connections are taken from the given pool, and
+		/// given back to it when the stream returned by open()
+		/// is destroyed. Streams should therefore be read to the
+		/// end, so that their connection can be reused.
+		/// Proxy settings are taken from the pool
+		/// (see HTTPClientSessionPool::setProxyConfig()).
+
 	virtual ~HTTPStreamFactory();
 		/// Destroys the HTTPStreamFactory.
 		
@@ -69,6 +80,11 @@ public:
 		/// Registers the HTTPStreamFactory with the
 		/// default URIStreamOpener instance.	
 
+	static void registerFactory(HTTPClientSessionPool::Ptr pPool);
+		/// Registers a HTTPStreamFactory using the given
+		/// HTTPClientSessionPool with the default
+		/// URIStreamOpener instance.
+
 	static void unregisterFactory();
 		/// Unregisters the HTTPStreamFactory with the
 		/// default URIStreamOpener instance.	
@@ -78,7 +94,11 @@ private:
 	{
 		MAX_REDIRECTS = 10
 	};
+
+	HTTPClientSession* createSession(const Poco::URI& uri, const Poco::URI& proxyUri);
+	void deleteSession(HTTPClientSession* pSession);
 	
+	HTTPClientSessionPool::Ptr _pPool;
 	std::string  _proxyHost;
 	Poco::UInt16 _proxyPort;
 	std::string  _proxyUsername;
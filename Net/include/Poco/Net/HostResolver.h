@@ -0,0 +1,67 @@
+//
+// HostResolver.h
+//
+// Library: Net
+// Package: NetCore
+// Module:  HostResolver
+//
+// Definition of the HostResolver class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HostResolver_INCLUDED
+#define Net_HostResolver_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HostEntry.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HostResolver: public Poco::RefCountedObject
+	/// A HostResolver looks up host names on behalf of a DNSCache.
+	///
+	/// The default implementation uses DNS::hostByName(), and thus
+	/// the name service of the operating system. Subclasses can provide
+	/// other name services, e.g. StubResolver for testing.
+{
+public:
+	typedef Poco::AutoPtr<HostResolver> Ptr;
+
+	HostResolver();
+		/// Creates the HostResolver.
+
+	virtual HostEntry resolve(const std::string& hostname);
+		/// Returns the HostEntry for the given host name.
+		///
+		/// Throws a HostNotFoundException if the host cannot be
+		/// found, a NoAddressFoundException if no address is
+		/// available for the host, or a DNSException for any
+		/// other error.
+		///
+		/// Will be called concurrently from multiple threads.
+
+protected:
+	virtual ~HostResolver();
+		/// Destroys the HostResolver.
+
+private:
+	HostResolver(const HostResolver&);
+	HostResolver& operator = (const HostResolver&);
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HostResolver_INCLUDED
@@ -0,0 +1,237 @@
+//
+// IOUring.h
+//
+// Library: Net
+// Package: Sockets
+// Module:  IOUring
+//
+// Definition of the IOUring class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_IOUring_INCLUDED
+#define Net_IOUring_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/Socket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Timespan.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class ServerSocket;
+
+
+class Net_API IOUring
+	/// IOUring is a thin wrapper for the Linux io_uring
+	/// asynchronous I/O interface.
+	///
+	/// Operations (receive, send, accept, poll) are prepared
+	/// in the submission queue and handed to the kernel as a batch
+	/// with a single call to submit() or submitAndWait(). Their
+	/// results are collected from the completion queue with
+	/// completions(), which does not require a system call.
+	/// Each operation carries a 64-bit user data value, which is
+	/// reported back with its completion.
+	///
+	/// Buffers can be registered with the kernel with registerBuffers(),
+	/// to avoid mapping them for every operation, and then used
+	/// with prepareReceiveFixed() and prepareSendFixed().
+	///
+	/// Support for io_uring is detected at build time (CMake defines
+	/// POCO_HAVE_IO_URING if <linux/io_uring.h> is available; with
+	/// the GNU make based build, POCO_HAVE_IO_URING must be defined
+	/// manually). Whether the running kernel supports io_uring can
+	/// be checked with available(); if it does not, or if support
+	/// has not been compiled in, the constructor throws a
+	/// Poco::NotImplementedException.
+	///
+	/// Memory given to the prepare*() methods must remain valid
+	/// until the corresponding completion has been received.
+	///
+	/// StreamSocket, ServerSocket and SocketReactor do not use
+	/// IOUring for receiving, sending or accepting; they still make
+	/// one system call per operation. Only PollSet uses io_uring
+	/// internally, for waiting for socket events. Applications that
+	/// want to batch socket I/O must use IOUring directly.
+	///
+	/// IOUring is not thread-safe.
+{
+public:
+	struct Completion
+		/// The result of a completed operation.
+	{
+		Poco::UInt64 userData;
+			/// The user data given when the operation was prepared.
+		int result;
+			/// The number of bytes transferred, the socket descriptor of an
+			/// accepted connection, the poll event mask, or a negative error code.
+		unsigned flags;
+			/// The completion flags (IORING_CQE_F_*).
+	};
+
+	enum CompletionFlags
+	{
+		COMPLETION_MORE = 0x02
+			/// Set for completions of multi-shot operations
+			/// that remain active (IORING_CQE_F_MORE).
+	};
+
+	struct Buffer
+		/// A buffer for registerBuffers().
+	{
+		void*       pData;
+		std::size_t length;
+	};
+
+	typedef std::vector<Buffer> BufferVec;
+
+	enum
+	{
+		DEFAULT_ENTRIES = 256
+	};
+
+	explicit IOUring(unsigned entries = DEFAULT_ENTRIES);
+		/// Creates an IOUring with a submission queue of (at least)
+		/// the given number of entries.
+		///
+		/// Throws a Poco::NotImplementedException if io_uring is not
+		/// supported by the system.
+
+	~IOUring();
+		/// Destroys the IOUring.
+
+	static bool available();
+		/// Returns true if io_uring support has been compiled in
+		/// and the running kernel supports all features required
+		/// by this class.
+
+	void registerBuffers(const BufferVec& buffers);
+		/// Registers the given buffers with the kernel, so that they
+		/// can be used with prepareReceiveFixed() and prepareSendFixed().
+		/// Any previously registered buffers are unregistered first.
+
+	void unregisterBuffers();
+		/// Unregisters all registered buffers.
+
+	void prepareReceive(const Socket& socket, void* buffer, int length, Poco::UInt64 userData, int flags = 0);
+		/// Prepares a receive operation, equivalent to recv().
+
+	void prepareSend(const Socket& socket, const void* buffer, int length, Poco::UInt64 userData, int flags = 0);
+		/// Prepares a send operation, equivalent to send().
+
+	void prepareReceiveFixed(const Socket& socket, int bufferIndex, std::size_t offset, int length, Poco::UInt64 userData);
+		/// Prepares a receive operation into the registered buffer
+		/// with the given index, starting at the given offset.
+
+	void prepareSendFixed(const Socket& socket, int bufferIndex, std::size_t offset, int length, Poco::UInt64 userData);
+		/// Prepares a send operation from the registered buffer
+		/// with the given index, starting at the given offset.
+
+	void prepareAccept(const ServerSocket& socket, Poco::UInt64 userData);
+		/// Prepares an accept operation. The result of the completion
+		/// is the descriptor of the accepted socket, which can be turned
+		/// into a StreamSocket with acceptedSocket().
+
+	void preparePoll(poco_socket_t fd, int mode, Poco::UInt64 userData, bool multiShot = false);
+		/// Prepares a poll operation for the given socket descriptor.
+		/// The mode is an OR'd combination of Socket::SELECT_READ,
+		/// Socket::SELECT_WRITE and Socket::SELECT_ERROR.
+		///
+		/// A multi-shot poll keeps reporting events until it is
+		/// removed; its completions have the IORING_CQE_F_MORE flag
+		/// set as long as it is active.
+
+	void prepareRemovePoll(Poco::UInt64 pollUserData, Poco::UInt64 userData);
+		/// Prepares the removal of the poll operation with the given user data.
+
+	int submit();
+		/// Submits all prepared operations to the kernel and
+		/// returns the number of operations submitted.
+
+	int submitAndWait(int minCompletions, const Poco::Timespan& timeout);
+		/// Submits all prepared operations to the kernel and waits
+		/// until at least minCompletions completions are available,
+		/// or the timeout expires.
+		///
+		/// Returns the number of operations submitted.
+
+	int wait(int minCompletions, const Poco::Timespan& timeout);
+		/// Waits until at least minCompletions completions are available,
+		/// or the timeout expires, without submitting prepared operations.
+		///
+		/// Since wait() does not access the submission queue, it
+		/// may be called while another thread prepares and submits
+		/// operations, provided that these are serialized by the caller.
+		/// Returns 0 if the timeout expired or the wait was
+		/// interrupted, a positive value otherwise.
+
+	int completions(Completion* pCompletions, int maxCompletions);
+		/// Stores up to maxCompletions completions in the given array
+		/// and removes them from the completion queue. Returns the
+		/// number of completions stored.
+
+	int pending() const;
+		/// Returns the number of prepared, but not yet submitted operations.
+
+	static StreamSocket acceptedSocket(const Completion& completion);
+		/// Returns a StreamSocket for the socket accepted by a
+		/// completed accept operation. Throws a NetException if
+		/// the operation failed.
+
+	static int pollMode(int pollEvents);
+		/// Converts the event mask in the result of a poll completion
+		/// to an OR'd combination of Socket::SELECT_READ,
+		/// Socket::SELECT_WRITE and Socket::SELECT_ERROR.
+
+private:
+	IOUring(const IOUring&);
+	IOUring& operator = (const IOUring&);
+
+	void* nextEntry();
+	int enter(unsigned toSubmit, unsigned minComplete, unsigned flags, const Poco::Timespan* pTimeout);
+
+	int         _fd;
+	void*       _pRing;
+	std::size_t _ringSize;
+	void*       _pEntries;
+	std::size_t _entriesSize;
+	unsigned*   _pSQHead;
+	unsigned*   _pSQTail;
+	unsigned*   _pSQMask;
+	unsigned*   _pSQArray;
+	unsigned*   _pCQHead;
+	unsigned*   _pCQTail;
+	unsigned*   _pCQMask;
+	void*       _pCQEntries;
+	unsigned    _sqEntries;
+	unsigned    _sqLocalTail;
+	unsigned    _sqSubmitted;
+	BufferVec   _buffers;
+	bool        _buffersRegistered;
+};
+
+
+//
+// inlines
+//
+inline int IOUring::pending() const
+{
+	return static_cast<int>(_sqLocalTail - _sqSubmitted);
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_IOUring_INCLUDED
@@ -0,0 +1,93 @@
+//
+// MetricsCounter.h
+//
+// Library: Net
+// Package: TCPServer
+// Module:  MetricsCounter
+//
+// Definition of the MetricsCounter class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_MetricsCounter_INCLUDED
+#define Net_MetricsCounter_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include <atomic>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API MetricsCounter
+	/// A monotonic counter (e.g., of requests or bytes) that
+	/// can be incremented by many threads concurrently, without
+	/// locking and without contending for a single cache line.
+	///
+	/// The counter consists of STRIPES cells, each on its own
+	/// cache line. Every thread is assigned one of the cells
+	/// (see stripe()), and adds to that cell only. The cells
+	/// are summed up when the value of the counter is read.
+{
+public:
+	enum
+	{
+		STRIPES = 16
+	};
+
+	MetricsCounter();
+		/// Creates the MetricsCounter with a value of zero.
+
+	~MetricsCounter();
+		/// Destroys the MetricsCounter.
+
+	void add(Poco::UInt64 n = 1);
+		/// Adds n to the counter.
+
+	Poco::UInt64 value() const;
+		/// Returns the value of the counter, which is the sum of
+		/// all cells. As the cells are read one after the other,
+		/// concurrent updates may or may not be included.
+
+	void reset();
+		/// Resets the counter to zero.
+
+	static unsigned stripe();
+		/// Returns the index of the cell assigned to the calling
+		/// thread. Cells are assigned to threads round-robin,
+		/// when a thread first updates a metric.
+
+private:
+	MetricsCounter(const MetricsCounter&);
+	MetricsCounter& operator = (const MetricsCounter&);
+
+	struct Cell
+	{
+		std::atomic<Poco::UInt64> value;
+		char padding[64 - sizeof(std::atomic<Poco::UInt64>)];
+	};
+
+	Cell _cells[STRIPES];
+};
+
+
+//
+// inlines
+//
+inline void MetricsCounter::add(Poco::UInt64 n)
+{
+	_cells[stripe()].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_MetricsCounter_INCLUDED
@@ -0,0 +1,178 @@
+//
+// MetricsHistogram.h
+//
+// Library: Net
+// Package: TCPServer
+// Module:  MetricsHistogram
+//
+// Definition of the MetricsHistogram class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_MetricsHistogram_INCLUDED
+#define Net_MetricsHistogram_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include <atomic>
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API MetricsHistogram
+	/// A histogram of non-negative integer values (typically
+	/// latencies in microseconds), which can be updated by
+	/// many threads concurrently without locking.
+	///
+	/// As in an HDR histogram, the range of values is divided into
+	/// power-of-two buckets, each of which is subdivided into
+	/// 2^SUB_BUCKET_BITS linear sub-buckets. Values below
+	/// 2^SUB_BUCKET_BITS are recorded exactly, larger values
+	/// with a relative error of less than 2^-SUB_BUCKET_BITS
+	/// (6.25%), which is retained for percentiles.
+	/// Values of 2^MAX_VALUE_BITS (about 12.7 days, if
+	/// microseconds are recorded) and above are recorded in
+	/// the highest bucket.
+	///
+	/// Like a MetricsCounter, the histogram consists of several
+	/// stripes, each one updated by a subset of the threads only.
+	/// The stripes are merged by snapshot().
+{
+public:
+	enum
+	{
+		SUB_BUCKET_BITS = 4,
+		SUB_BUCKETS     = 1 << SUB_BUCKET_BITS,
+		MAX_VALUE_BITS  = 40,
+		BUCKETS         = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1)*SUB_BUCKETS,
+		STRIPES         = 4
+	};
+
+	class Net_API Snapshot
+		/// The merged state of a MetricsHistogram
+		/// at the time snapshot() was called.
+	{
+	public:
+		Snapshot();
+			/// Creates an empty Snapshot.
+
+		~Snapshot();
+			/// Destroys the Snapshot.
+
+		Poco::UInt64 count() const;
+			/// Returns the number of recorded values.
+
+		Poco::UInt64 sum() const;
+			/// Returns the sum of all recorded values.
+
+		Poco::UInt64 min() const;
+			/// Returns the smallest recorded value,
+			/// or 0 if no value has been recorded.
+
+		Poco::UInt64 max() const;
+			/// Returns the largest recorded value,
+			/// or 0 if no value has been recorded.
+
+		double mean() const;
+			/// Returns the arithmetic mean of all recorded
+			/// values, or 0 if no value has been recorded.
+
+		Poco::UInt64 percentile(double percent) const;
+			/// Returns the value below or at which the given percentage
+			/// (0 - 100) of all recorded values lie. The result is the
+			/// highest value of the sub-bucket containing the value,
+			/// but not larger than max().
+			///
+			/// Returns 0 if no value has been recorded.
+
+	private:
+		std::vector<Poco::UInt64> _buckets;
+		Poco::UInt64 _count;
+		Poco::UInt64 _sum;
+		Poco::UInt64 _min;
+		Poco::UInt64 _max;
+
+		friend class MetricsHistogram;
+	};
+
+	MetricsHistogram();
+		/// Creates an empty MetricsHistogram.
+
+	~MetricsHistogram();
+		/// Destroys the MetricsHistogram.
+
+	void record(Poco::UInt64 value);
+		/// Records the given value.
+
+	Snapshot snapshot() const;
+		/// Returns the merged state of all stripes. As the stripes
+		/// are read one after the other, concurrent updates may
+		/// or may not be included.
+
+	void reset();
+		/// Removes all recorded values.
+
+	static int bucketIndex(Poco::UInt64 value);
+		/// Returns the index of the sub-bucket the given value
+		/// is recorded in.
+
+	static Poco::UInt64 bucketLimit(int index);
+		/// Returns the highest value recorded in the sub-bucket
+		/// with the given index.
+
+private:
+	MetricsHistogram(const MetricsHistogram&);
+	MetricsHistogram& operator = (const MetricsHistogram&);
+
+	struct Stripe
+	{
+		std::atomic<Poco::UInt64> sum;
+		std::atomic<Poco::UInt64> buckets[BUCKETS];
+		char padding[64];
+	};
+
+	Stripe _stripes[STRIPES];
+	std::atomic<Poco::UInt64> _min;
+	std::atomic<Poco::UInt64> _max;
+};
+
+
+//
+// inlines
+//
+inline Poco::UInt64 MetricsHistogram::Snapshot::count() const
+{
+	return _count;
+}
+
+
+inline Poco::UInt64 MetricsHistogram::Snapshot::sum() const
+{
+	return _sum;
+}
+
+
+inline Poco::UInt64 MetricsHistogram::Snapshot::min() const
+{
+	return _count > 0 ? _min : 0;
+}
+
+
+inline Poco::UInt64 MetricsHistogram::Snapshot::max() const
+{
+	return _max;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_MetricsHistogram_INCLUDED
@@ -0,0 +1,115 @@
+//
+// MetricsRegistry.h
+//
+// Library: Net
+// Package: TCPServer
+// Module:  MetricsRegistry
+//
+// Definition of the MetricsRegistry class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_MetricsRegistry_INCLUDED
+#define Net_MetricsRegistry_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/MetricsCounter.h"
+#include "Poco/Net/MetricsHistogram.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
+#include <ostream>
+#include <memory>
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API MetricsRegistry: public Poco::RefCountedObject
+	/// A named collection of MetricsCounter and MetricsHistogram
+	/// objects, which can be written in the Prometheus text
+	/// exposition format, e.g. by a HTTPRequestHandler:
+	///
+	///     response.setContentType(MetricsRegistry::CONTENT_TYPE);
+	///     pMetrics->write(response.send());
+	///
+	/// Metrics are registered once and are never removed, so
+	/// that references to them stay valid for the lifetime of
+	/// the registry. Only registering and writing metrics
+	/// acquires the registry's mutex; updating them does not.
+{
+public:
+	typedef Poco::AutoPtr<MetricsRegistry> Ptr;
+
+	static const std::string CONTENT_TYPE;
+		/// The content type of the exposition format
+		/// ("text/plain; version=0.0.4").
+
+	MetricsRegistry();
+		/// Creates an empty MetricsRegistry.
+
+	MetricsCounter& counter(const std::string& name, const std::string& help = "");
+		/// Returns the counter with the given name,
+		/// registering it if it does not exist yet.
+		///
+		/// Throws an InvalidArgumentException if the name is not
+		/// a valid metric name, or if a histogram with the
+		/// same name exists.
+
+	MetricsHistogram& histogram(const std::string& name, const std::string& help = "");
+		/// Returns the histogram with the given name,
+		/// registering it if it does not exist yet.
+		///
+		/// Throws an InvalidArgumentException if the name is not
+		/// a valid metric name, or if a counter with the
+		/// same name exists.
+
+	void write(std::ostream& ostr) const;
+		/// Writes all metrics, in the order in which they have been
+		/// registered, in the Prometheus text exposition format.
+		///
+		/// Counters are written as counter, histograms as summary
+		/// with the 0.5, 0.9, 0.99 and 0.999 quantiles.
+
+	std::string toString() const;
+		/// Returns all metrics in the text exposition format.
+
+	void reset();
+		/// Resets all metrics.
+
+protected:
+	~MetricsRegistry();
+		/// Destroys the MetricsRegistry.
+
+private:
+	MetricsRegistry(const MetricsRegistry&);
+	MetricsRegistry& operator = (const MetricsRegistry&);
+
+	struct Metric
+	{
+		std::string name;
+		std::string help;
+		std::unique_ptr<MetricsCounter> pCounter;
+		std::unique_ptr<MetricsHistogram> pHistogram;
+	};
+
+	Metric& find(const std::string& name, const std::string& help);
+	static void writeHeader(std::ostream& ostr, const Metric& metric, const char* type);
+
+	std::vector<std::unique_ptr<Metric>> _metrics;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_MetricsRegistry_INCLUDED
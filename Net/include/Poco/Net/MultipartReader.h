@@ -20,6 +20,7 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/BufferedStreamBuf.h"
+#include "Poco/Buffer.h"
 #include <istream>
 
 
@@ -30,25 +31,107 @@ namespace Net {
 class MessageHeader;
 
 
+class Net_API MultipartSourceBuf: public std::streambuf
+	/// This streambuf reads ahead from a multipart message stream
+	/// into a large buffer, which the MultipartStreamBuf searches
+	/// for encapsulation boundaries, and from which the
+	/// MultipartReader reads the part headers.
+	///
+	/// As data is read ahead, the underlying stream must not be
+	/// used by anyone else while the MultipartSourceBuf is in use.
+{
+public:
+	enum
+	{
+		BUFFER_SIZE = 65536
+	};
+
+	explicit MultipartSourceBuf(std::istream& istr, std::size_t bufferSize = BUFFER_SIZE);
+		/// Creates the MultipartSourceBuf for the given stream.
+
+	~MultipartSourceBuf();
+		/// Destroys the MultipartSourceBuf.
+
+	const char* data() const;
+		/// Returns a pointer to the buffered data not consumed yet.
+
+	std::size_t available() const;
+		/// Returns the number of buffered bytes not consumed yet.
+
+	void consume(std::size_t n);
+		/// Marks the first n available bytes as consumed.
+
+	std::size_t fill();
+		/// Moves the available data to the beginning of the buffer
+		/// and reads as much data as fits into the remaining
+		/// space from the underlying stream.
+		///
+		/// Returns the number of bytes read, which is 0
+		/// at the end of the underlying stream.
+
+	bool eof() const;
+		/// Returns true iff the end of the underlying stream
+		/// has been reached. Data may still be available.
+
+	std::size_t capacity() const;
+		/// Returns the size of the buffer.
+
+protected:
+	int_type underflow();
+
+private:
+	MultipartSourceBuf(const MultipartSourceBuf&);
+	MultipartSourceBuf& operator = (const MultipartSourceBuf&);
+
+	std::istream& _istr;
+	Poco::Buffer<char> _buffer;
+	bool _eof;
+};
+
+
 class Net_API MultipartStreamBuf: public Poco::BufferedStreamBuf
 	/// This is the streambuf class used for reading from a multipart message stream.
+	///
+	/// The encapsulation boundaries are found with a Boyer-Moore-Horspool
+	/// search over the read-ahead buffer of a MultipartSourceBuf, so the
+	/// data of a part is copied in large blocks rather than byte by byte.
 {
 public:
+	MultipartStreamBuf(MultipartSourceBuf& source, const std::string& boundary);
+		/// Creates the MultipartStreamBuf, reading from the given source.
+
 	MultipartStreamBuf(std::istream& istr, const std::string& boundary);
+		/// Creates the MultipartStreamBuf, reading from the given stream.
+		///
+		/// If the stream reads from a MultipartSourceBuf, the
+		/// MultipartStreamBuf reads from it directly. Otherwise,
+		/// the MultipartStreamBuf reads ahead from the stream
+		/// using its own MultipartSourceBuf, so the data
+		/// following the part may not be available from the
+		/// stream anymore.
+
 	~MultipartStreamBuf();
 	bool lastPart() const;
 	
 protected:
 	int readFromDevice(char* buffer, std::streamsize length);
+	std::streamsize xsgetn(char* buffer, std::streamsize length);
 
 private:
 	enum
 	{
-		STREAM_BUFFER_SIZE = 1024
+		STREAM_BUFFER_SIZE = 8192
 	};
 
-	std::istream& _istr;
+	void init();
+	std::size_t find(const char* data, std::size_t begin, std::size_t end) const;
+
+	MultipartSourceBuf* _pSource;
+	bool          _ownSource;
 	std::string   _boundary;
+	std::string   _pattern;
+	std::size_t   _skip[256];
+	bool          _endOfPart;
 	bool          _lastPart;
 };
 
@@ -94,6 +177,11 @@ class Net_API MultipartReader
 	/// Always ensure that you read all data from the part
 	/// stream, otherwise the MultipartReader will fail to
 	/// find the next part.
+	///
+	/// The MultipartReader reads ahead from the input stream
+	/// in large blocks, so after the last part has been read,
+	/// the data following the message (the epilogue) may no
+	/// longer be available from the input stream.
 {
 public:
 	explicit MultipartReader(std::istream& istr);
@@ -148,12 +236,48 @@ private:
 	MultipartReader(const MultipartReader&);
 	MultipartReader& operator = (const MultipartReader&);
 
-	std::istream&         _istr;
+	MultipartSourceBuf    _source;
+	std::istream          _input;
 	std::string           _boundary;
 	MultipartInputStream* _pMPI;
 };
 
 
+//
+// inlines
+//
+inline const char* MultipartSourceBuf::data() const
+{
+	return gptr();
+}
+
+
+inline std::size_t MultipartSourceBuf::available() const
+{
+	return static_cast<std::size_t>(egptr() - gptr());
+}
+
+
+inline void MultipartSourceBuf::consume(std::size_t n)
+{
+	poco_assert_dbg (n <= available());
+
+	setg(eback(), gptr() + n, egptr());
+}
+
+
+inline bool MultipartSourceBuf::eof() const
+{
+	return _eof;
+}
+
+
+inline std::size_t MultipartSourceBuf::capacity() const
+{
+	return _buffer.capacity();
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -35,13 +35,46 @@ class Net_API PollSet
 	/// If supported, PollSet is implemented using epoll (Linux) or
 	/// poll (BSD) APIs. A fallback implementation using select()
 	/// is also provided.
+	///
+	/// On Linux, an implementation based on io_uring can be requested
+	/// with PS_IO_URING. Changes to the set are then handed to the kernel
+	/// in batches, together with the re-arming of sockets that have
+	/// been reported as ready. If io_uring support has not been compiled
+	/// in (see IOUring) or is not supported by the running kernel,
+	/// the epoll implementation is used instead.
 {
 public:
+	enum Implementation
+	{
+		PS_DEFAULT,
+			/// epoll, poll or select, depending on the platform.
+		PS_IO_URING
+			/// io_uring, if available, otherwise PS_DEFAULT.
+	};
+
 	enum Mode
 	{
-		POLL_READ  = 0x01,
-		POLL_WRITE = 0x02,
-		POLL_ERROR = 0x04
+		POLL_READ    = 0x01,
+		POLL_WRITE   = 0x02,
+		POLL_ERROR   = 0x04,
+		POLL_EDGE    = 0x08,
+			/// Report state changes only once (edge-triggered) instead
+			/// of as long as the condition persists. Only supported by
+			/// the epoll implementation; ignored otherwise.
+		POLL_ONESHOT = 0x10
+			/// Disable the socket after an event has been reported for it,
+			/// until it is re-armed with update(). Only supported by
+			/// the epoll implementation; ignored otherwise.
+	};
+
+	struct Event
+		/// A ready socket, as reported by poll(const Poco::Timespan&, Event*, int).
+	{
+		void* pData;
+			/// The user data given to add() for the socket, or
+			/// the socket's SocketImpl if no user data was given.
+		int mode;
+			/// An OR'd combination of POLL_READ, POLL_WRITE and POLL_ERROR.
 	};
 
 	typedef std::map<Poco::Net::Socket, int> SocketModeMap;
@@ -49,6 +82,10 @@ public:
 	PollSet();
 		/// Creates an empty PollSet.
 
+	explicit PollSet(Implementation impl);
+		/// Creates an empty PollSet, using the given implementation
+		/// if available.
+
 	~PollSet();
 		/// Destroys the PollSet.
 
@@ -57,11 +94,26 @@ public:
 		/// the given mode, which can be an OR'd combination of
 		/// POLL_READ, POLL_WRITE and POLL_ERROR.
 
+	void add(const Poco::Net::Socket& socket, int mode, void* pData);
+		/// Adds the given socket to the set, for polling with
+		/// the given mode, and associates the given user data with it.
+		///
+		/// The user data is reported back for the socket by
+		/// poll(const Poco::Timespan&, Event*, int). With epoll, it
+		/// is stored directly in the kernel's event structure, so
+		/// no lookup is necessary to map a ready event to its handler.
+		/// The caller is responsible for keeping the object pointed
+		/// to by pData alive as long as events for the socket can
+		/// be reported.
+
 	void remove(const Poco::Net::Socket& socket);
 		/// Removes the given socket from the set.
 
 	void update(const Poco::Net::Socket& socket, int mode);
 		/// Updates the mode of the given socket.
+		///
+		/// Any user data associated with the socket is retained.
+		/// For sockets polled with POLL_ONESHOT, this re-arms the socket.
 
 	bool has(const Socket& socket) const;
 		/// Returns true if socket is registered for polling.
@@ -78,14 +130,49 @@ public:
 		/// Returns a PollMap containing the sockets that have had
 		/// their state changed.
 
+	int poll(const Poco::Timespan& timeout, Event* pEvents, int maxEvents);
+		/// Waits until the state of at least one of the PollSet's sockets
+		/// changes accordingly to its mode, or the timeout expires.
+		///
+		/// Stores up to maxEvents ready sockets, together with their
+		/// user data, in the array given by pEvents and returns the
+		/// number of entries stored (0 in case of a timeout).
+		///
+		/// With epoll, this does not allocate any memory and does not
+		/// need to search the set for the ready sockets. The other
+		/// implementations fall back to poll(const Poco::Timespan&).
+
+	void wakeUp();
+		/// Wakes up a thread waiting in poll(), which then returns
+		/// before the timeout expires, possibly without any ready sockets.
+		/// Can be called from any thread. If no thread is waiting, the
+		/// next call to poll() returns immediately.
+		///
+		/// Only supported by the epoll and io_uring implementations,
+		/// which poll an eventfd together with the sockets. With the
+		/// other implementations, this method does nothing.
+
+	Implementation implementation() const;
+		/// Returns the implementation actually in use.
+
 private:
-	PollSetImpl* _pImpl;
+	PollSetImpl*   _pImpl;
+	Implementation _implementation;
 
 	PollSet(const PollSet&);
 	PollSet& operator = (const PollSet&);
 };
 
 
+//
+// inlines
+//
+inline PollSet::Implementation PollSet::implementation() const
+{
+	return _implementation;
+}
+
+
 } } // namespace Poco::Net
 
 
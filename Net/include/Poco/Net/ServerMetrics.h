@@ -0,0 +1,172 @@
+//
+// ServerMetrics.h
+//
+// Library: Net
+// Package: TCPServer
+// Module:  ServerMetrics
+//
+// Definition of the ServerMetrics class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_ServerMetrics_INCLUDED
+#define Net_ServerMetrics_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/MetricsRegistry.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API ServerMetrics: public MetricsRegistry
+	/// The metrics maintained by a TCPServer and, if the server
+	/// is a HTTPServer, by its HTTPServerConnection objects.
+	///
+	/// To enable metrics, pass a ServerMetrics object to
+	/// TCPServerParams::setMetrics() (or HTTPServerParams::setMetrics())
+	/// before creating the server. The same ServerMetrics object can
+	/// be shared by several servers, or each server can have its
+	/// own one with a distinct prefix. Further, application-defined
+	/// metrics can be registered with counter() and histogram().
+	///
+	/// All times are in microseconds. The following metrics are
+	/// registered, with names starting with the given prefix:
+	///   - <prefix>_connections_total: number of connections handled.
+	///   - <prefix>_queue_time_microseconds: time between accepting
+	///     a connection and a thread starting to handle it.
+	///   - <prefix>_requests_total: number of HTTP requests handled.
+	///   - <prefix>_keepalive_requests_total: number of HTTP requests
+	///     received on a persistent connection after the first one.
+	///   - <prefix>_received_bytes_total: number of bytes received
+	///     by HTTP connections.
+	///   - <prefix>_sent_bytes_total: number of bytes sent by HTTP
+	///     connections.
+	///   - <prefix>_parse_time_microseconds: time for reading and
+	///     parsing a HTTP request header, starting when the first
+	///     byte of the request is available.
+	///   - <prefix>_handler_time_microseconds: time spent in
+	///     HTTPRequestHandler::handleRequest().
+	///   - <prefix>_write_time_microseconds: time between the request
+	///     handler returning and the response being completely sent.
+{
+public:
+	typedef Poco::AutoPtr<ServerMetrics> Ptr;
+
+	explicit ServerMetrics(const std::string& prefix = "poco_server");
+		/// Creates the ServerMetrics, with the given prefix
+		/// for the names of all metrics.
+
+	MetricsCounter& connections();
+		/// Returns the counter of connections handled.
+
+	MetricsHistogram& queueTime();
+		/// Returns the histogram of accept-to-dispatch times.
+
+	MetricsCounter& requests();
+		/// Returns the counter of HTTP requests.
+
+	MetricsCounter& keepAliveRequests();
+		/// Returns the counter of HTTP requests received on
+		/// a persistent connection after the first one.
+
+	MetricsCounter& bytesReceived();
+		/// Returns the counter of bytes received.
+
+	MetricsCounter& bytesSent();
+		/// Returns the counter of bytes sent.
+
+	MetricsHistogram& parseTime();
+		/// Returns the histogram of request parsing times.
+
+	MetricsHistogram& handlerTime();
+		/// Returns the histogram of request handler times.
+
+	MetricsHistogram& writeTime();
+		/// Returns the histogram of response write times.
+
+protected:
+	~ServerMetrics();
+		/// Destroys the ServerMetrics.
+
+private:
+	MetricsCounter& _connections;
+	MetricsHistogram& _queueTime;
+	MetricsCounter& _requests;
+	MetricsCounter& _keepAliveRequests;
+	MetricsCounter& _bytesReceived;
+	MetricsCounter& _bytesSent;
+	MetricsHistogram& _parseTime;
+	MetricsHistogram& _handlerTime;
+	MetricsHistogram& _writeTime;
+};
+
+
+//
+// inlines
+//
+inline MetricsCounter& ServerMetrics::connections()
+{
+	return _connections;
+}
+
+
+inline MetricsHistogram& ServerMetrics::queueTime()
+{
+	return _queueTime;
+}
+
+
+inline MetricsCounter& ServerMetrics::requests()
+{
+	return _requests;
+}
+
+
+inline MetricsCounter& ServerMetrics::keepAliveRequests()
+{
+	return _keepAliveRequests;
+}
+
+
+inline MetricsCounter& ServerMetrics::bytesReceived()
+{
+	return _bytesReceived;
+}
+
+
+inline MetricsCounter& ServerMetrics::bytesSent()
+{
+	return _bytesSent;
+}
+
+
+inline MetricsHistogram& ServerMetrics::parseTime()
+{
+	return _parseTime;
+}
+
+
+inline MetricsHistogram& ServerMetrics::handlerTime()
+{
+	return _handlerTime;
+}
+
+
+inline MetricsHistogram& ServerMetrics::writeTime()
+{
+	return _writeTime;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_ServerMetrics_INCLUDED
@@ -284,6 +284,23 @@ public:
 	static bool supportsIPv6();
 		/// Returns true if the system supports IPv6.
 
+	static SocketBuf makeBuffer(const void* buffer, std::size_t length);
+		/// Returns a SocketBuf referring to the given memory, for
+		/// use with the vectored sendBytes() and receiveBytes()
+		/// overloads of StreamSocket and DatagramSocket.
+		///
+		/// The memory is not copied, and it is not modified
+		/// when the buffer is used for sending.
+
+	static char* bufferData(const SocketBuf& buffer);
+		/// Returns a pointer to the memory a SocketBuf refers to.
+
+	static std::size_t bufferSize(const SocketBuf& buffer);
+		/// Returns the size of the memory a SocketBuf refers to.
+
+	static std::size_t bufferSize(const SocketBufVec& buffers);
+		/// Returns the total size of all buffers.
+
 	void init(int af);
 		/// Creates the underlying system socket for the given
 		/// address family.
@@ -619,6 +636,51 @@ inline bool Socket::supportsIPv6()
 }
 
 
+inline SocketBuf Socket::makeBuffer(const void* buffer, std::size_t length)
+{
+	SocketBuf buf;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	buf.buf = reinterpret_cast<char*>(const_cast<void*>(buffer));
+	buf.len = static_cast<ULONG>(length);
+#else
+	buf.iov_base = const_cast<void*>(buffer);
+	buf.iov_len = length;
+#endif
+	return buf;
+}
+
+
+inline char* Socket::bufferData(const SocketBuf& buffer)
+{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	return buffer.buf;
+#else
+	return reinterpret_cast<char*>(buffer.iov_base);
+#endif
+}
+
+
+inline std::size_t Socket::bufferSize(const SocketBuf& buffer)
+{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	return buffer.len;
+#else
+	return buffer.iov_len;
+#endif
+}
+
+
+inline std::size_t Socket::bufferSize(const SocketBufVec& buffers)
+{
+	std::size_t size = 0;
+	for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+	{
+		size += bufferSize(*it);
+	}
+	return size;
+}
+
+
 inline void Socket::init(int af)
 {
 	_pImpl->init(af);
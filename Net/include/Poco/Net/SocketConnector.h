@@ -24,7 +24,12 @@
 #include "Poco/Net/ParallelSocketAcceptor.h"
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/DNSCache.h"
+#include "Poco/Net/NetException.h"
 #include "Poco/Observer.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
 
 
 namespace Poco {
@@ -71,6 +76,11 @@ class SocketConnector
 	///
 	/// Subclasses can override the createServiceHandler() factory method
 	/// if special steps are necessary to create a ServiceHandler object.
+	///
+	/// A SocketConnector can also be created for a host name, which
+	/// is resolved asynchronously using DNSCache::defaultCache(), so
+	/// that the thread creating the SocketConnector (typically the
+	/// reactor thread) is not blocked by the lookup.
 {
 public:
 	explicit SocketConnector(SocketAddress& address):
@@ -92,11 +102,33 @@ public:
 		if (doRegister) registerConnector(reactor);
 	}
 
+	SocketConnector(const std::string& hostname, Poco::UInt16 port, SocketReactor& reactor, bool doResolve = true):
+		_pReactor(0),
+		_pResolveState(new ResolveState(this, hostname, port, reactor))
+		/// Creates a SocketConnector for the given host name and port.
+		///
+		/// The host name is resolved asynchronously. When the lookup
+		/// has completed, the non-blocking connect operation is initiated
+		/// and the SocketConnector registers itself with the given SocketReactor.
+		/// If the host name cannot be resolved, onResolveError() is called.
+		///
+		/// This happens in a resolver thread of the DNSCache or, if the
+		/// host name is cached, before the constructor returns.
+		/// Therefore, for implementations overriding onResolveError(),
+		/// doResolve should be false, and resolve() called explicitly
+		/// at the end of the implementation's constructor. Likewise,
+		/// such implementations must call cancel() at the beginning
+		/// of their destructor.
+	{
+		if (doResolve) resolve();
+	}
+
 	virtual ~SocketConnector()
 		/// Destroys the SocketConnector.
 	{
 		try
 		{
+			cancel();
 			unregisterConnector();
 		}
 		catch (...)
@@ -105,6 +137,43 @@ public:
 		}
 	}
 
+	void resolve()
+		/// Starts the asynchronous lookup of the host name given
+		/// to the constructor. Must only be called once, and only
+		/// if the SocketConnector has been created for a host name
+		/// with doResolve set to false.
+	{
+		poco_check_ptr (_pResolveState);
+
+		Poco::AutoPtr<ResolveState> pState(_pResolveState);
+		DNSCache::defaultCache().resolveAsync(pState->hostname, [pState](const DNSCache::Result& result) mutable
+		{
+			Poco::Mutex::ScopedLock lock(pState->mutex);
+			if (pState->pConnector) pState->pConnector->onResolved(result, pState->port, *pState->pReactor);
+		});
+	}
+
+	void cancel()
+		/// Cancels a pending lookup of the host name given to the
+		/// constructor. If the lookup is just completing in a resolver
+		/// thread, waits until its completion has been handled.
+		/// After cancel() returns, the SocketConnector is no longer
+		/// called by the lookup.
+		///
+		/// Subclasses overriding onResolveError(), onError() or
+		/// registerConnector() must call cancel() in their destructor,
+		/// before their part of the object is destroyed.
+		///
+		/// Does nothing if the SocketConnector has not been
+		/// created for a host name.
+	{
+		if (_pResolveState)
+		{
+			Poco::Mutex::ScopedLock lock(_pResolveState->mutex);
+			_pResolveState->pConnector = 0;
+		}
+	}
+
 	virtual void registerConnector(SocketReactor& reactor)
 		/// Registers the SocketConnector with a SocketReactor.
 		///
@@ -186,6 +255,16 @@ protected:
 	{
 	}
 
+	virtual void onResolveError(const Poco::Exception& exc)
+		/// Called when the host name given to the constructor
+		/// cannot be resolved.
+		///
+		/// The default implementation calls onError() with
+		/// POCO_EHOSTUNREACH. Subclasses can override this method.
+	{
+		onError(POCO_EHOSTUNREACH);
+	}
+
 	SocketReactor* reactor()
 		/// Returns a pointer to the SocketReactor where
 		/// this SocketConnector is registered.
@@ -206,8 +285,54 @@ private:
 	SocketConnector(const SocketConnector&);
 	SocketConnector& operator = (const SocketConnector&);
 
-	StreamSocket           _socket;
-	SocketReactor*         _pReactor;
+	struct ResolveState: public Poco::RefCountedObject
+		/// Shared between the SocketConnector and a pending
+		/// lookup, which must not use the SocketConnector
+		/// after it has been destroyed.
+	{
+		ResolveState(SocketConnector* pConn, const std::string& host, Poco::UInt16 p, SocketReactor& reactor):
+			pConnector(pConn),
+			hostname(host),
+			port(p),
+			pReactor(&reactor)
+		{
+		}
+
+		SocketConnector* pConnector;
+		std::string hostname;
+		Poco::UInt16 port;
+		SocketReactor* pReactor;
+		Poco::Mutex mutex;
+	};
+
+	void onResolved(const DNSCache::Result& result, Poco::UInt16 port, SocketReactor& reactor)
+	{
+		if (result.failed())
+		{
+			onResolveError(*result.exception());
+		}
+		else if (result.data().addresses().empty())
+		{
+			onResolveError(NoAddressFoundException(result.data().name()));
+		}
+		else
+		{
+			try
+			{
+				_socket.connectNB(SocketAddress(result.data().addresses()[0], port));
+			}
+			catch (Poco::Exception& exc)
+			{
+				onError(exc.code());
+				return;
+			}
+			registerConnector(reactor);
+		}
+	}
+
+	StreamSocket                 _socket;
+	SocketReactor*               _pReactor;
+	Poco::AutoPtr<ResolveState>  _pResolveState;
 };
 
 
@@ -132,6 +132,7 @@
 	#include <errno.h>
 	#include <sys/types.h>
 	#include <sys/socket.h>
+	#include <sys/uio.h>
 	#include <sys/un.h>
 	#include <fcntl.h>
 	#if POCO_OS != POCO_OS_HPUX
@@ -240,6 +241,11 @@
 #endif
 
 
+#if (POCO_OS == POCO_OS_LINUX) && !defined(POCO_NET_NO_MMSG)
+	#define POCO_HAVE_MMSG 1
+#endif
+
+
 #if defined(POCO_HAVE_ADDRINFO)
 	#ifndef AI_PASSIVE
 		#define AI_PASSIVE 0
@@ -347,10 +353,24 @@
 #endif
 
 
+#include <vector>
+
+
 namespace Poco {
 namespace Net {
 
 
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	typedef WSABUF SocketBuf;
+#else
+	typedef struct iovec SocketBuf;
+#endif
+
+typedef std::vector<SocketBuf> SocketBufVec;
+	/// A list of buffers for vectored (scatter/gather) I/O.
+	/// See Socket::makeBuffer().
+
+
 struct AddressFamily
 	/// AddressFamily::Family replaces the previously used IPAddress::Family
 	/// enumeration and is now used for IPAddress::Family and SocketAddress::Family.
@@ -23,12 +23,21 @@
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/Timespan.h"
+#include <ios>
 
 
 namespace Poco {
+
+
+class FileInputStream;
+
+
 namespace Net {
 
 
+class DatagramBatch;
+
+
 class Net_API SocketImpl: public Poco::RefCountedObject
 	/// This class encapsulates the Berkeley sockets API.
 	///
@@ -176,6 +185,43 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 
+	virtual int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket with a single system call (sendmsg()
+		/// or WSASend()).
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+		///
+		/// Certain socket implementations may also return a negative
+		/// value denoting a certain condition.
+
+	virtual int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives data from the socket and stores it in the
+		/// given buffers, filling one after the other, with a
+		/// single system call (recvmsg() or WSARecv()).
+		///
+		/// Returns the number of bytes received.
+		///
+		/// Certain socket implementations may also return a negative
+		/// value denoting a certain condition.
+
+	virtual std::streamsize sendFile(FileInputStream& fileInputStream, std::streamoff offset = 0, std::streamsize count = 0);
+		/// Sends count bytes of the given file, starting at
+		/// offset, through the socket. If count is 0, the
+		/// file is sent up to its end.
+		///
+		/// On Linux, the data is transferred by the kernel,
+		/// without copying it to user space, using sendfile()
+		/// for regular files and splice() for pipes (FIFOs),
+		/// which cannot be positioned, so offset must be 0 in that case.
+		/// On other platforms, or if the kernel does not
+		/// support the transfer, the file is read and sent
+		/// with sendBytes().
+		///
+		/// Returns the number of bytes sent. For a non-blocking
+		/// socket, this may be less than count.
+
 	virtual int sendTo(const void* buffer, int length, const SocketAddress& address, int flags = 0);
 		/// Sends the contents of the given buffer through
 		/// the socket to the given address.
@@ -190,6 +236,37 @@ public:
 		///
 		/// Returns the number of bytes received.
 
+	virtual int sendBatch(const DatagramBatch& batch, int flags = 0);
+		/// Sends the datagrams in the given batch, each to its
+		/// own address, or to the address the socket is connected
+		/// to if the datagram has no address.
+		///
+		/// On Linux, the datagrams are sent with as few sendmmsg()
+		/// calls as possible. If all datagrams go to the same address
+		/// and have the same size (except for the last one, which may
+		/// be shorter), they are handed to the kernel as a single
+		/// buffer to be split into datagrams (UDP generic segmentation
+		/// offload), where supported. On other platforms, every
+		/// datagram is sent with a separate sendto() call.
+		///
+		/// Returns the number of datagrams sent, which, for a
+		/// non-blocking socket, may be less than batch.size().
+
+	virtual int receiveBatch(DatagramBatch& batch, int flags = 0);
+		/// Receives up to batch.capacity() datagrams, replacing the
+		/// contents of the given batch, and returns the number of
+		/// datagrams received.
+		///
+		/// Waits (subject to the socket's receive timeout) for the
+		/// first datagram only; any further datagrams are only
+		/// received if they are already queued. On Linux, this is
+		/// done with recvmmsg(). On other platforms, every
+		/// datagram is received with a separate recvfrom() call.
+		///
+		/// Datagrams longer than batch.datagramSize() are truncated.
+		/// For a non-blocking socket, returns -1 if no datagram
+		/// is available.
+
 	virtual void sendUrgent(unsigned char data);
 		/// Sends one byte of urgent data through
 		/// the socket.
@@ -370,6 +447,14 @@ public:
 		/// Returns true iff the socket's connection is secure
 		/// (using SSL or TLS).
 
+	virtual std::string getALPNProtocol();
+		/// Returns the application protocol negotiated with
+		/// ALPN (RFC 7301) during the TLS handshake, completing
+		/// the handshake first if necessary.
+		///
+		/// Returns an empty string if no protocol has been
+		/// negotiated, or if the socket is not secure.
+
 	int socketError();
 		/// Returns the value of the SO_ERROR socket option.
 
@@ -437,6 +522,23 @@ protected:
 	void reset(poco_socket_t fd = POCO_INVALID_SOCKET);
 		/// Allows subclasses to set the socket manually, iff no valid socket is set yet.
 
+	std::streamsize sendFileCopy(FileInputStream& fileInputStream, std::streamoff offset, std::streamsize count);
+		/// Implements sendFile() by reading the file and sending
+		/// its contents with sendBytes(). Used by socket implementations
+		/// that must process the data they send, e.g. for encryption.
+		/// The socket must be in blocking mode.
+
+	int sendBytesCopy(const SocketBufVec& buffers, int flags);
+		/// Implements the vectored sendBytes() by copying the buffers
+		/// into a single buffer, which is sent with sendBytes().
+		/// Used by socket implementations that must process the
+		/// data they send, e.g. for encryption.
+
+	int receiveBytesCopy(SocketBufVec& buffers, int flags);
+		/// Implements the vectored receiveBytes() by receiving
+		/// into a single buffer with receiveBytes(), and copying
+		/// the data into the given buffers.
+
 	static int lastError();
 		/// Returns the last error code.
 
@@ -465,6 +567,7 @@ private:
 	friend class Socket;
 	friend class SecureSocketImpl;
 	friend class PollSetImpl;
+	friend class IOUring;
 };
 
 
@@ -106,6 +106,20 @@ public:
 };
 
 
+class Net_API DeadlineNotification: public SocketNotification
+	/// This notification is sent to the event handlers of a socket
+	/// if a deadline scheduled with SocketReactor::scheduleDeadline()
+	/// for the socket expires.
+{
+public:
+	DeadlineNotification(SocketReactor* pReactor);
+		/// Creates the DeadlineNotification for the given SocketReactor.
+
+	~DeadlineNotification();
+		/// Destroys the DeadlineNotification.
+};
+
+
 class Net_API IdleNotification: public SocketNotification
 	/// This notification is sent when the SocketReactor does
 	/// not have any sockets to react to.
@@ -20,6 +20,7 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/Socket.h"
+#include "Poco/Net/TimerWheel.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/NotificationCenter.h"
 #include "Poco/Observer.h"
@@ -64,6 +65,15 @@ public:
 	std::size_t countObservers() const;
 		/// Returns the number of subscribers;
 
+	const Socket& socket() const;
+		/// Returns the socket.
+
+	TimerWheel::Timer& timer();
+		/// Returns the timer for the socket's deadline.
+
+	const TimerWheel::Timer& timer() const;
+		/// Returns the timer for the socket's deadline.
+
 protected:
 	~SocketNotifier();
 		/// Destroys the SocketNotifier.
@@ -74,6 +84,7 @@ private:
 	EventSet                 _events;
 	Poco::NotificationCenter _nc;
 	Socket                   _socket;
+	TimerWheel::Timer        _timer;
 };
 
 
@@ -104,6 +115,24 @@ inline std::size_t SocketNotifier::countObservers() const
 }
 
 
+inline const Socket& SocketNotifier::socket() const
+{
+	return _socket;
+}
+
+
+inline TimerWheel::Timer& SocketNotifier::timer()
+{
+	return _timer;
+}
+
+
+inline const TimerWheel::Timer& SocketNotifier::timer() const
+{
+	return _timer;
+}
+
+
 } } // namespace Poco::Net
 
 
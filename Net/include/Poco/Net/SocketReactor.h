@@ -21,11 +21,15 @@
 #include "Poco/Net/Net.h"
 #include "Poco/Net/Socket.h"
 #include "Poco/Net/PollSet.h"
+#include "Poco/Net/TimerWheel.h"
 #include "Poco/Runnable.h"
 #include "Poco/Timespan.h"
 #include "Poco/Observer.h"
 #include "Poco/AutoPtr.h"
+#include "Poco/MPSCQueue.h"
+#include <functional>
 #include <map>
+#include <vector>
 
 
 namespace Poco {
@@ -96,6 +100,22 @@ class Net_API SocketReactor: public Poco::Runnable
 	/// called repeatedly in a loop, it is recommended to do a
 	/// short sleep or yield in the event handler.
 	///
+	/// In addition to the reactor-wide timeout, a deadline can be
+	/// scheduled for each socket with scheduleDeadline(), e.g. to
+	/// implement idle or read timeouts for connections. Deadlines
+	/// are managed in a hierarchical timer wheel (see TimerWheel),
+	/// so scheduling and cancelling a deadline takes constant time.
+	/// The reactor waits for socket events at most until the nearest
+	/// deadline, and dispatches a DeadlineNotification to the event
+	/// handlers of every socket whose deadline has expired. Waking
+	/// up for a deadline does not dispatch a TimeoutNotification.
+	///
+	/// Other threads can have work done on the reactor thread by
+	/// posting tasks with post(), e.g. to send a response on a
+	/// connection served by the reactor. Tasks are passed to the
+	/// reactor through a lock-free queue, and the reactor is woken up
+	/// immediately, without waiting for the timeout to expire.
+	///
 	/// Finally, when the SocketReactor is about to shut down (as a result
 	/// of stop() being called), it dispatches a ShutdownNotification
 	/// to all event handlers. This is done in the onShutdown() method
@@ -111,14 +131,52 @@ class Net_API SocketReactor: public Poco::Runnable
 	/// from another thread while the SocketReactor is running. Also,
 	/// it is safe to call addEventHandler() and removeEventHandler()
 	/// from event handlers.
+	///
+	/// If created with OPT_FAST_DISPATCH, the SocketReactor uses an
+	/// event loop that does not allocate memory or search the handler
+	/// map: each socket's SocketNotifier is registered as user data with
+	/// the PollSet (and, with epoll, stored in the kernel's event
+	/// structure), and ready events are delivered into a fixed-size
+	/// array that is reused across iterations. This mode can be combined
+	/// with edge-triggered (OPT_EDGE_TRIGGERED) or one-shot (OPT_ONESHOT)
+	/// polling, which are only supported with epoll.
 {
 public:
+	typedef std::function<void()> Task;
+		/// A task that can be posted to the reactor thread.
+
+	enum Options
+	{
+		OPT_DEFAULT        = 0x00,
+			/// Use the classic event loop.
+		OPT_FAST_DISPATCH  = 0x01,
+			/// Use the allocation-free event loop.
+		OPT_EDGE_TRIGGERED = 0x02,
+			/// Poll sockets edge-triggered. Event handlers must
+			/// read (or write) until the operation would block,
+			/// otherwise no further notification will be dispatched.
+			/// Implies OPT_FAST_DISPATCH.
+		OPT_ONESHOT        = 0x04,
+			/// Poll sockets one-shot. A socket is disabled after an event
+			/// has been reported for it and re-armed by the reactor after
+			/// its event handlers have been dispatched.
+			/// Implies OPT_FAST_DISPATCH.
+		OPT_IO_URING       = 0x08
+			/// Use the io_uring based PollSet implementation, if
+			/// available (see PollSet::PS_IO_URING).
+	};
+
 	SocketReactor();
 		/// Creates the SocketReactor.
 
 	explicit SocketReactor(const Poco::Timespan& timeout);
 		/// Creates the SocketReactor, using the given timeout.
 
+	SocketReactor(const Poco::Timespan& timeout, int options);
+		/// Creates the SocketReactor, using the given timeout and
+		/// options, which can be an OR'd combination of the values
+		/// in the Options enumeration.
+
 	virtual ~SocketReactor();
 		/// Destroys the SocketReactor.
 
@@ -130,10 +188,31 @@ public:
 		/// Stops the SocketReactor.
 		///
 		/// The reactor will be stopped when the next event
-		/// (including a timeout event) occurs.
+		/// (including a timeout event) occurs. If the PollSet
+		/// supports it (see PollSet::wakeUp()), a reactor waiting
+		/// for socket events is woken up immediately.
 
 	void wakeUp();
-		/// Wakes up idle reactor.
+		/// Wakes up the reactor, if it is idle or waiting
+		/// for socket events.
+		///
+		/// Waiting for socket events can only be interrupted if
+		/// the PollSet supports it (see PollSet::wakeUp()).
+
+	void post(const Task& task);
+		/// Posts the given task for execution on the reactor thread,
+		/// and wakes up the reactor. Can be called from any thread.
+		///
+		/// Tasks are executed after the socket events and deadlines of
+		/// the current iteration of the event loop have been dispatched.
+		/// Tasks posted from the same thread are executed in the order
+		/// they have been posted. Exceptions thrown by a task are passed
+		/// to the ErrorHandler.
+		///
+		/// Tasks still pending when the reactor stops are executed before
+		/// the ShutdownNotification is dispatched. Tasks posted after the
+		/// reactor has stopped are executed when it is run again, or
+		/// discarded when it is destroyed.
 
 	void setTimeout(const Poco::Timespan& timeout);
 		/// Sets the timeout.
@@ -149,6 +228,12 @@ public:
 	const Poco::Timespan& getTimeout() const;
 		/// Returns the timeout.
 
+	int getOptions() const;
+		/// Returns the options given to the constructor.
+
+	PollSet::Implementation getPollSetImplementation() const;
+		/// Returns the PollSet implementation in use.
+
 	void addEventHandler(const Socket& socket, const Poco::AbstractObserver& observer);
 		/// Registers an event handler with the SocketReactor.
 		///
@@ -169,6 +254,29 @@ public:
 	bool has(const Socket& socket) const;
 		/// Returns true if socket is registered with this rector.
 
+	void scheduleDeadline(const Socket& socket, const Poco::Timespan& timeout);
+		/// Schedules a deadline for the given socket, which expires
+		/// after the given timeout (with a resolution of one millisecond).
+		/// When the deadline expires, a DeadlineNotification is dispatched
+		/// to the event handlers of the socket, from the reactor thread.
+		///
+		/// A socket has at most one deadline. Scheduling a deadline
+		/// replaces the previous one. The deadline is cancelled when the
+		/// last event handler for the socket is removed.
+		///
+		/// If called from another thread, the reactor is woken up
+		/// (see wakeUp()), so that it takes the new deadline into
+		/// account for its wait for socket events.
+		///
+		/// Throws a NotFoundException if no event handler
+		/// is registered for the socket.
+
+	void cancelDeadline(const Socket& socket);
+		/// Cancels the deadline for the given socket, if there is one.
+
+	bool hasDeadline(const Socket& socket) const;
+		/// Returns true if a deadline is scheduled for the given socket.
+
 protected:
 	virtual void onTimeout();
 		/// Called if the timeout expires and no other events are available.
@@ -212,17 +320,32 @@ private:
 	typedef Poco::FastMutex MutexType;
 	typedef MutexType::ScopedLock ScopedLock;
 
+	typedef std::vector<NotifierPtr>          NotifierVec;
+	typedef std::vector<PollSet::Event>       EventVec;
+
 	bool hasSocketHandlers();
+	Poco::Timespan pollTimeout(bool& deadline);
+	void dispatchDeadlines();
+	bool runTasks();
+	void runFast();
+	void rearm(SocketNotifier* pNotifier);
+	int pollMode(SocketNotifier* pNotifier);
 	void dispatch(NotifierPtr& pNotifier, SocketNotification* pNotification);
+	void dispatch(SocketNotifier* pNotifier, SocketNotification* pNotification);
 
 	enum
 	{
-		DEFAULT_TIMEOUT = 250000
+		DEFAULT_TIMEOUT = 250000,
+		MAX_EVENTS      = 1024
 	};
 
 	bool            _stop;
 	Poco::Timespan  _timeout;
+	int             _options;
+	int             _pollFlags;
 	EventHandlerMap _handlers;
+	NotifierVec     _removed;
+	EventVec        _events;
 	PollSet         _pollSet;
 	NotificationPtr _pReadableNotification;
 	NotificationPtr _pWritableNotification;
@@ -230,13 +353,33 @@ private:
 	NotificationPtr _pTimeoutNotification;
 	NotificationPtr _pIdleNotification;
 	NotificationPtr _pShutdownNotification;
-	MutexType       _mutex;
+	NotificationPtr _pDeadlineNotification;
+	TimerWheel      _deadlines;
+	TimerWheel::TimerVec _expiredTimers;
+	NotifierVec     _expired;
+	Poco::MPSCQueue<Task> _tasks;
+	mutable MutexType _mutex;
 	Poco::Thread*   _pThread;
 	
 	friend class SocketNotifier;
 };
 
 
+//
+// inlines
+//
+inline int SocketReactor::getOptions() const
+{
+	return _options;
+}
+
+
+inline PollSet::Implementation SocketReactor::getPollSetImplementation() const
+{
+	return _pollSet.implementation();
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -21,9 +21,15 @@
 #include "Poco/Net/Net.h"
 #include "Poco/Net/Socket.h"
 #include "Poco/FIFOBuffer.h"
+#include <ios>
 
 
 namespace Poco {
+
+
+class FileInputStream;
+
+
 namespace Net {
 
 
@@ -130,6 +136,19 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 
+	int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through the
+		/// socket with a single system call (a "gather write"),
+		/// e.g. a message header and body stored in different places,
+		/// without copying them into a single buffer first.
+		/// See Socket::makeBuffer().
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+		///
+		/// Certain socket implementations may also return a negative
+		/// value denoting a certain condition.
+
 	int sendBytes(Poco::FIFOBuffer& buffer);
 		/// Sends the contents of the given buffer through
 		/// the socket. FIFOBuffer has writable/readable transition
@@ -155,6 +174,18 @@ public:
 		/// been set and nothing is received within that interval.
 		/// Throws a NetException (or a subclass) in case of other errors.
 
+	int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives data from the socket and stores it in the given
+		/// buffers, filling one after the other (a "scatter read").
+		///
+		/// Returns the number of bytes received.
+		/// A return value of 0 means a graceful shutdown
+		/// of the connection from the peer.
+		///
+		/// Throws a TimeoutException if a receive timeout has
+		/// been set and nothing is received within that interval.
+		/// Throws a NetException (or a subclass) in case of other errors.
+
 	int receiveBytes(Poco::FIFOBuffer& buffer);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received. FIFOBuffer has
@@ -170,6 +201,32 @@ public:
 		/// been set and nothing is received within that interval.
 		/// Throws a NetException (or a subclass) in case of other errors.
 
+	std::streamsize sendFile(FileInputStream& fileInputStream, std::streamoff offset = 0, std::streamsize count = 0);
+		/// Sends count bytes of the given file, starting at offset,
+		/// through the socket. If count is 0, the file is sent
+		/// up to its end.
+		///
+		/// Where supported (Linux), the data is transferred by the
+		/// kernel without being copied into user space, using
+		/// sendfile() for regular files and splice() for pipes.
+		/// Otherwise, and for sockets that must process the data
+		/// they send (e.g., SecureStreamSocket), the file is read
+		/// and its contents are sent with sendBytes().
+		///
+		/// The current position of the stream is not used,
+		/// and may or may not be changed.
+		///
+		/// Returns the number of bytes sent, which, for a
+		/// non-blocking socket, may be less than count.
+		/// Throws a TimeoutException if a send timeout has
+		/// been set and expires before the data could be sent.
+
+	std::string getALPNProtocol();
+		/// Returns the application protocol negotiated with
+		/// ALPN (RFC 7301) for a secure socket, or an empty
+		/// string if no protocol has been negotiated, or if
+		/// the socket is not secure.
+
 	void sendUrgent(unsigned char data);
 		/// Sends one byte of urgent data through
 		/// the socket.
@@ -0,0 +1,126 @@
+//
+// StubResolver.h
+//
+// Library: Net
+// Package: NetCore
+// Module:  StubResolver
+//
+// Definition of the StubResolver class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_StubResolver_INCLUDED
+#define Net_StubResolver_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HostResolver.h"
+#include "Poco/Net/IPAddress.h"
+#include "Poco/Mutex.h"
+#include "Poco/AtomicCounter.h"
+#include <istream>
+#include <map>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API StubResolver: public HostResolver
+	/// A HostResolver that looks up host names in a table kept
+	/// in memory, which can be filled programmatically, or
+	/// from a file in the format of /etc/hosts.
+	///
+	/// Host names not found in the table are passed on to
+	/// a fallback HostResolver, if one has been given.
+	/// Otherwise, a HostNotFoundException is thrown.
+	///
+	/// A StubResolver is mainly useful for testing code that
+	/// connects to servers by name, without depending on
+	/// the DNS. See DNSCache::setResolver().
+{
+public:
+	typedef Poco::AutoPtr<StubResolver> Ptr;
+
+	StubResolver();
+		/// Creates an empty StubResolver without fallback.
+
+	explicit StubResolver(HostResolver::Ptr pFallback);
+		/// Creates an empty StubResolver that passes
+		/// unknown host names on to pFallback.
+
+	void addHost(const std::string& hostname, const IPAddress& address);
+		/// Adds the given address to the host with the
+		/// given name, which is created if necessary.
+
+	void addHost(const std::string& hostname, const IPAddress& address, const HostEntry::AliasList& aliases);
+		/// Adds the given address to the host with the given
+		/// name, which is created if necessary, and makes
+		/// the host also known under the given aliases.
+
+	void removeHost(const std::string& hostname);
+		/// Removes the host with the given name or alias.
+
+	void clear();
+		/// Removes all hosts.
+
+	void load(std::istream& istr);
+		/// Adds the hosts read from the given stream, which
+		/// must be in the format of /etc/hosts: an IP address
+		/// followed by the host name and optional aliases on
+		/// each line, with comments starting with '#'.
+		/// Lines that do not start with a valid IP address
+		/// are ignored.
+
+	void load(const std::string& path);
+		/// Adds the hosts read from the file with the given path,
+		/// which must be in the format of /etc/hosts.
+
+	HostEntry resolve(const std::string& hostname);
+		/// Returns the HostEntry for the given host name or alias,
+		/// which is compared case-insensitively.
+		///
+		/// IP addresses are returned as they are.
+
+	int lookups() const;
+		/// Returns the number of calls to resolve() so far,
+		/// which allows tests to verify the effect of a DNSCache.
+
+protected:
+	~StubResolver();
+		/// Destroys the StubResolver.
+
+private:
+	struct Host
+	{
+		std::string name;
+		HostEntry::AliasList aliases;
+		HostEntry::AddressList addresses;
+	};
+	typedef std::map<std::string, Host> HostMap;
+
+	HostResolver::Ptr _pFallback;
+	HostMap _hosts;
+	Poco::AtomicCounter _lookups;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline int StubResolver::lookups() const
+{
+	return _lookups.value();
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_StubResolver_INCLUDED
@@ -27,6 +27,7 @@
 #include "Poco/Runnable.h"
 #include "Poco/Thread.h"
 #include "Poco/ThreadPool.h"
+#include <vector>
 
 
 namespace Poco {
@@ -100,6 +101,15 @@ class Net_API TCPServer: public Poco::Runnable
 	/// Thus, the call to start() returns immediately, and the server
 	/// continues to run in the background.
 	///
+	/// If TCPServerParams::setAcceptors() specifies more than one
+	/// acceptor, the server opens additional listening sockets bound
+	/// to the same address with SO_REUSEPORT. Every listening socket
+	/// has its own acceptor thread and its own set of connection
+	/// threads, so the kernel distributes incoming connections
+	/// without any queue shared between acceptors. The statistics
+	/// functions (currentThreads(), totalConnections(), etc.) report
+	/// totals over all acceptors.
+	///
 	/// To stop the server from accepting new connections, call stop().
 	///
 	/// After calling stop(), no new connections will be accepted and
@@ -189,6 +199,14 @@ public:
 	int refusedConnections() const;
 		/// Returns the number of refused connections.
 
+	int stolenConnections() const;
+		/// Returns the number of connections taken by a thread from
+		/// another thread's queue (DISPATCH_WORK_STEALING only).
+
+	std::vector<int> queueDepths() const;
+		/// Returns the number of connections queued in each
+		/// per-thread queue (DISPATCH_WORK_STEALING only).
+
 	const ServerSocket& socket() const;
 		/// Returns the underlying server socket.
 
@@ -218,16 +236,42 @@ protected:
 	static std::string threadName(const ServerSocket& socket);
 		/// Returns a thread name for the server thread.
 
+	void init(TCPServerConnectionFactory::Ptr pFactory, Poco::ThreadPool& threadPool, TCPServerParams::Ptr pParams);
+		/// Creates the dispatchers and, if more than one acceptor
+		/// has been requested, the additional listening sockets.
+
+	void accept(ServerSocket& socket, TCPServerDispatcher* pDispatcher);
+		/// Accepts connections on the given socket and passes them
+		/// to the given dispatcher until the server is stopped.
+
+	static ServerSocket createSocket(Poco::UInt16 portNumber, TCPServerParams::Ptr pParams);
+		/// Creates the listening socket for the given port,
+		/// with SO_REUSEPORT if more than one acceptor is used.
+
+	ServerSocket createReusePortSocket() const;
+		/// Creates an additional listening socket bound
+		/// to the address of the server socket.
+
+	int total(int (TCPServerDispatcher::*pMethod)() const) const;
+		/// Returns the sum of the given statistics value
+		/// over the dispatchers of all acceptors.
+
 private:
 	TCPServer();
 	TCPServer(const TCPServer&);
 	TCPServer& operator = (const TCPServer&);
+
+	class Acceptor;
+	typedef std::vector<Acceptor*> AcceptorVec;
+	typedef std::vector<Poco::ThreadPool*> ThreadPoolVec;
 	
 	ServerSocket _socket;
 	TCPServerDispatcher* _pDispatcher;
 	TCPServerConnectionFilter::Ptr _pConnectionFilter;
 	Poco::Thread _thread;
 	bool _stopped;
+	AcceptorVec _acceptors;
+	ThreadPoolVec _threadPools;
 };
 
 
@@ -26,6 +26,10 @@
 #include "Poco/NotificationQueue.h"
 #include "Poco/ThreadPool.h"
 #include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include "Poco/Clock.h"
+#include <vector>
+#include <memory>
 
 
 namespace Poco {
@@ -35,6 +39,11 @@ namespace Net {
 class Net_API TCPServerDispatcher: public Poco::Runnable
 	/// A helper class for TCPServer that dispatches
 	/// connections to server connection threads.
+	///
+	/// Depending on the DispatchMode set in the TCPServerParams,
+	/// connections are either passed through a single shared
+	/// NotificationQueue, or distributed over per-thread
+	/// lock-free queues from which idle threads steal work.
 {
 public:
 	TCPServerDispatcher(TCPServerConnectionFactory::Ptr pFactory, Poco::ThreadPool& threadPool, TCPServerParams::Ptr pParams);
@@ -82,9 +91,33 @@ public:
 	int refusedConnections() const;
 		/// Returns the number of refused connections.
 
+	int stolenConnections() const;
+		/// Returns the number of connections a thread has taken
+		/// from another thread's queue.
+		///
+		/// Always 0 unless the dispatch mode is DISPATCH_WORK_STEALING.
+
+	std::vector<int> queueDepths() const;
+		/// Returns the number of connections currently queued
+		/// in each per-thread queue.
+		///
+		/// Returns an empty vector unless the dispatch mode
+		/// is DISPATCH_WORK_STEALING.
+
 	const TCPServerParams& params() const;
 		/// Returns a const reference to the TCPServerParam object.
 
+	void setAffinity(int cpu);
+		/// Sets the CPU that connection threads started from now
+		/// on are bound to. The thread pool must have been created
+		/// with the TAP_CUSTOM affinity policy for this to take effect.
+		///
+		/// The default is -1 (no affinity).
+
+	int getAffinity() const;
+		/// Returns the CPU connection threads are bound to,
+		/// or -1 if no affinity has been set.
+
 protected:
 	~TCPServerDispatcher();
 		/// Destroys the TCPServerDispatcher.
@@ -95,11 +128,43 @@ protected:
 	void endConnection();
 		/// Updates the performance counters.
 
+	void runQueue();
+		/// Runs a connection thread taking connections from
+		/// the shared queue.
+
+	void runWorkStealing();
+		/// Runs a connection thread taking connections from its
+		/// own queue, or from other threads' queues if its own
+		/// queue is empty.
+
+	void enqueueWorkStealing(const StreamSocket& socket);
+		/// Puts the given socket into one of the per-thread queues.
+
+	void handleConnection(const StreamSocket& socket, const Poco::Clock& queued);
+		/// Creates and runs the TCPServerConnection for the socket,
+		/// which has been queued at the given time.
+
+	void startThread();
+		/// Starts a new connection thread, if possible.
+
 private:
+	class WorkQueue;
+	typedef std::vector<WorkQueue*> WorkQueueVec;
+	typedef std::unique_ptr<std::atomic<int>[]> QueueIndexArray;
+
 	TCPServerDispatcher();
 	TCPServerDispatcher(const TCPServerDispatcher&);
 	TCPServerDispatcher& operator = (const TCPServerDispatcher&);
 
+	void activateWorkQueue(int queue);
+		/// Adds the queue to the queues producers put connections into.
+		/// Must be called with _mutex locked.
+
+	void deactivateWorkQueue(int queue);
+		/// Removes the queue from the queues producers put connections
+		/// into and makes it available to a new thread.
+		/// Must be called with _mutex locked.
+
 	class ThreadCountWatcher
 	{
 	public:
@@ -126,6 +191,7 @@ private:
 
 	std::atomic<int> _rc;
 	TCPServerParams::Ptr _pParams;
+	ServerMetrics::Ptr _pMetrics;
 	std::atomic<int>  _currentThreads;
 	std::atomic<int>  _totalConnections;
 	std::atomic<int>  _currentConnections;
@@ -136,6 +202,18 @@ private:
 	TCPServerConnectionFactory::Ptr _pConnectionFactory;
 	Poco::ThreadPool&               _threadPool;
 	mutable Poco::FastMutex         _mutex;
+	WorkQueueVec                    _workQueues;
+	std::vector<int>                _freeQueues;
+	std::vector<int>                _startingQueues;
+	QueueIndexArray                 _activeQueues;
+	std::atomic<int>                _activeQueueCount;
+	std::atomic<unsigned>           _nextQueue;
+	std::atomic<int>                _queued;
+	std::atomic<int>                _idleThreads;
+	std::atomic<int>                _stolenConnections;
+	int                             _cpu;
+	Poco::FastMutex                 _idleMutex;
+	Poco::Condition                 _idleCondition;
 };
 
 
@@ -148,6 +226,18 @@ inline const TCPServerParams& TCPServerDispatcher::params() const
 }
 
 
+inline void TCPServerDispatcher::setAffinity(int cpu)
+{
+	_cpu = cpu;
+}
+
+
+inline int TCPServerDispatcher::getAffinity() const
+{
+	return _cpu;
+}
+
+
 } } // namespace Poco::Net
 
 
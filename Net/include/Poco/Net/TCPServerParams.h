@@ -19,6 +19,7 @@
 
 
 #include "Poco/Net/Net.h"
+#include "Poco/Net/ServerMetrics.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/Timespan.h"
 #include "Poco/Thread.h"
@@ -37,6 +38,21 @@ class Net_API TCPServerParams: public Poco::RefCountedObject
 {
 public:
 	typedef Poco::AutoPtr<TCPServerParams> Ptr;
+
+	enum DispatchMode
+		/// Determines how the TCPServerDispatcher hands
+		/// accepted connections to its worker threads.
+	{
+		DISPATCH_QUEUE,
+			/// All connections go through a single, shared
+			/// NotificationQueue (default).
+
+		DISPATCH_WORK_STEALING
+			/// Every worker thread has its own lock-free queue.
+			/// Connections are distributed round-robin over these
+			/// queues, and idle workers steal connections from the
+			/// queues of busy workers.
+	};
 	
 	TCPServerParams();
 		/// Creates the TCPServerParams.
@@ -45,6 +61,10 @@ public:
 		///   - threadIdleTime:       10 seconds
 		///   - maxThreads:           0
 		///   - maxQueued:            64
+		///   - dispatchMode:         DISPATCH_QUEUE
+		///   - acceptors:            1
+		///   - threadAffinity:       false
+		///   - metrics:              none
 
 	void setThreadIdleTime(const Poco::Timespan& idleTime);
 		/// Sets the maximum idle time for a thread before
@@ -92,6 +112,61 @@ public:
 		/// Returns the priority of TCP server threads
 		/// created by TCPServer.
 
+	void setDispatchMode(DispatchMode mode);
+		/// Sets the strategy the TCPServerDispatcher uses
+		/// to distribute connections to its threads.
+		///
+		/// DISPATCH_WORK_STEALING avoids the single queue mutex
+		/// becoming a point of contention when many connections
+		/// are accepted in a short time.
+
+	DispatchMode getDispatchMode() const;
+		/// Returns the dispatch mode.
+
+	void setAcceptors(int count);
+		/// Sets the number of listening sockets and acceptor
+		/// threads the TCPServer uses. Must be greater than 0.
+		///
+		/// If greater than 1, the TCPServer opens that many
+		/// listening sockets bound to the same address with
+		/// SO_REUSEPORT, each with its own acceptor thread and
+		/// its own TCPServerDispatcher, and lets the kernel spread
+		/// incoming connections over them. The maxThreads and
+		/// maxQueued parameters then apply to each acceptor
+		/// separately.
+		///
+		/// A ServerSocket passed to the TCPServer must have been
+		/// bound with reusePort set to true in this case.
+		///
+		/// The default is 1.
+
+	int getAcceptors() const;
+		/// Returns the number of acceptors.
+
+	void setThreadAffinity(bool flag);
+		/// If true, the TCPServer creates a separate thread pool for
+		/// each acceptor, and pins the acceptor thread and its
+		/// connection threads to one CPU, assigning CPUs to acceptors
+		/// in round-robin fashion. The thread pool given to the
+		/// TCPServer, or the default thread pool, is not used then.
+		///
+		/// The default is false.
+
+	bool getThreadAffinity() const;
+		/// Returns true if acceptors and their connection threads
+		/// are pinned to CPUs.
+
+	void setMetrics(ServerMetrics::Ptr pMetrics);
+		/// Sets the ServerMetrics object in which the server
+		/// records connection and request metrics.
+		///
+		/// The default is none, in which case no metrics are
+		/// recorded.
+
+	ServerMetrics::Ptr getMetrics() const;
+		/// Returns the ServerMetrics object, or a null pointer
+		/// if none has been set.
+
 protected:
 	virtual ~TCPServerParams();
 		/// Destroys the TCPServerParams.
@@ -101,6 +176,10 @@ private:
 	int _maxThreads;
 	int _maxQueued;
 	Poco::Thread::Priority _threadPriority;
+	DispatchMode _dispatchMode;
+	int _acceptors;
+	bool _threadAffinity;
+	ServerMetrics::Ptr _pMetrics;
 };
 
 
@@ -131,6 +210,30 @@ inline Poco::Thread::Priority TCPServerParams::getThreadPriority() const
 }
 
 
+inline TCPServerParams::DispatchMode TCPServerParams::getDispatchMode() const
+{
+	return _dispatchMode;
+}
+
+
+inline int TCPServerParams::getAcceptors() const
+{
+	return _acceptors;
+}
+
+
+inline bool TCPServerParams::getThreadAffinity() const
+{
+	return _threadAffinity;
+}
+
+
+inline ServerMetrics::Ptr TCPServerParams::getMetrics() const
+{
+	return _pMetrics;
+}
+
+
 } } // namespace Poco::Net
 
 
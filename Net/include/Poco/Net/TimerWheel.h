@@ -0,0 +1,183 @@
+//
+// TimerWheel.h
+//
+// Library: Net
+// Package: Reactor
+// Module:  TimerWheel
+//
+// Definition of the TimerWheel class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_TimerWheel_INCLUDED
+#define Net_TimerWheel_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Clock.h"
+#include "Poco/Timespan.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API TimerWheel
+	/// A hierarchical timer wheel (as described by George Varghese
+	/// and Tony Lauck), used by the SocketReactor to manage
+	/// per-socket deadlines.
+	///
+	/// The wheel has LEVELS levels of SLOTS slots each. A slot in
+	/// level 0 covers one tick, a slot in level n covers SLOTS^n ticks.
+	/// As the wheel advances, the timers in the slots of the higher
+	/// levels are moved down (cascaded) to the lower levels. Timers
+	/// beyond the range of the wheel are kept in the highest level
+	/// and rescheduled until they are within range.
+	///
+	/// Timers are intrusive: a Timer is part of the object it
+	/// belongs to, and is linked into the list of its slot, so
+	/// that scheduling and cancelling a timer take constant time
+	/// and do not allocate memory.
+	///
+	/// This class is not thread-safe.
+{
+public:
+	class Net_API Timer
+		/// A timer that can be scheduled with a TimerWheel.
+	{
+	public:
+		explicit Timer(void* pOwner = 0);
+			/// Creates the Timer for the given owner.
+
+		~Timer();
+			/// Destroys the Timer, which must not be scheduled.
+
+		bool scheduled() const;
+			/// Returns true iff the Timer is scheduled.
+
+		void* owner() const;
+			/// Returns the owner given to the constructor.
+
+	private:
+		Timer(const Timer&);
+		Timer& operator = (const Timer&);
+
+		void* _pOwner;
+		Timer* _pPrev;
+		Timer* _pNext;
+		Poco::UInt64 _expires;
+
+		friend class TimerWheel;
+	};
+
+	typedef std::vector<Timer*> TimerVec;
+
+	enum
+	{
+		LEVELS     = 4,
+		SLOT_BITS  = 6,
+		SLOTS      = 1 << SLOT_BITS,
+		DEFAULT_RESOLUTION = 1000
+			/// Default tick in microseconds.
+	};
+
+	explicit TimerWheel(const Poco::Timespan& resolution = Poco::Timespan(DEFAULT_RESOLUTION));
+		/// Creates the TimerWheel with the given resolution (tick).
+
+	~TimerWheel();
+		/// Destroys the TimerWheel, after cancelling all timers.
+
+	void schedule(Timer& timer, const Poco::Timespan& timeout);
+		/// Schedules the given timer to expire after the given timeout,
+		/// rounded up to the resolution of the wheel.
+		///
+		/// If the timer is already scheduled, it is rescheduled.
+
+	void cancel(Timer& timer);
+		/// Cancels the given timer, if it is scheduled.
+
+	void clear();
+		/// Cancels all timers.
+
+	void advance(TimerVec& expired);
+		/// Advances the wheel to the current time, and appends
+		/// all timers that have expired to expired. Expired
+		/// timers are no longer scheduled.
+
+	Poco::Timespan nextTimeout() const;
+		/// Returns the time until the wheel must be advanced next,
+		/// which is the time until the next timer expires, or until
+		/// timers must be cascaded, whatever comes first.
+		///
+		/// Returns a negative Timespan if no timer is scheduled.
+
+	std::size_t size() const;
+		/// Returns the number of scheduled timers.
+
+	bool empty() const;
+		/// Returns true iff no timer is scheduled.
+
+	const Poco::Timespan& resolution() const;
+		/// Returns the resolution of the wheel.
+
+private:
+	TimerWheel(const TimerWheel&);
+	TimerWheel& operator = (const TimerWheel&);
+
+	Poco::UInt64 ticks() const;
+	void insert(Timer& timer, Poco::UInt64 earliest);
+	void cascade(int level);
+	static void link(Timer& head, Timer& timer);
+	static void unlink(Timer& timer);
+
+	Poco::Timespan _resolution;
+	Poco::Clock _start;
+	Poco::UInt64 _now;
+	std::size_t _size;
+	Timer _slots[LEVELS][SLOTS];
+};
+
+
+//
+// inlines
+//
+inline bool TimerWheel::Timer::scheduled() const
+{
+	return _pNext != 0;
+}
+
+
+inline void* TimerWheel::Timer::owner() const
+{
+	return _pOwner;
+}
+
+
+inline std::size_t TimerWheel::size() const
+{
+	return _size;
+}
+
+
+inline bool TimerWheel::empty() const
+{
+	return _size == 0;
+}
+
+
+inline const Poco::Timespan& TimerWheel::resolution() const
+{
+	return _resolution;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_TimerWheel_INCLUDED
@@ -21,6 +21,7 @@
 #include "Poco/Net/Net.h"
 #include "Poco/Net/StreamSocket.h"
 #include "Poco/Net/HTTPCredentials.h"
+#include "Poco/Net/WebSocketDeflate.h"
 #include "Poco/Buffer.h"
 
 
@@ -32,6 +33,7 @@ class WebSocketImpl;
 class HTTPServerRequest;
 class HTTPServerResponse;
 class HTTPClientSession;
+class MessageHeader;
 
 
 class Net_API WebSocket: public StreamSocket
@@ -49,6 +51,12 @@ class Net_API WebSocket: public StreamSocket
 	/// Note that special frames like PING must be handled at
 	/// application level. In the case of a PING, a PONG message
 	/// must be returned.
+	///
+	/// The permessage-deflate extension (RFC 7692) is supported.
+	/// It is enabled by passing WebSocketDeflate::Params to the
+	/// constructor. If the other endpoint agrees, text and binary
+	/// messages are then transparently compressed and decompressed
+	/// by sendFrame() and receiveFrame().
 {
 public:
 	enum Mode
@@ -61,7 +69,7 @@ public:
 		/// Frame header flags.
 	{
 		FRAME_FLAG_FIN  = 0x80, /// FIN bit: final fragment of a multi-fragment message.
-		FRAME_FLAG_RSV1 = 0x40, /// Reserved for future use. Must be zero.
+		FRAME_FLAG_RSV1 = 0x40, /// Set in the first frame of a compressed message (permessage-deflate extension), otherwise zero.
 		FRAME_FLAG_RSV2 = 0x20, /// Reserved for future use. Must be zero.
 		FRAME_FLAG_RSV3 = 0x10  /// Reserved for future use. Must be zero.
 	};
@@ -122,10 +130,14 @@ public:
 			/// No Sec-WebSocket-Accept header or wrong value.
 		WS_ERR_UNAUTHORIZED                   = 6,
 			/// The server rejected the username or password for authentication.
+		WS_ERR_HANDSHAKE_EXTENSION            = 7,
+			/// Invalid Sec-WebSocket-Extensions header in handshake response.
 		WS_ERR_PAYLOAD_TOO_BIG                = 10,
 			/// Payload too big for supplied buffer.
-		WS_ERR_INCOMPLETE_FRAME               = 11
+		WS_ERR_INCOMPLETE_FRAME               = 11,
 			/// Incomplete frame received.
+		WS_ERR_COMPRESSION                    = 12
+			/// Invalid compressed payload received.
 	};
 	
 	WebSocket(HTTPServerRequest& request, HTTPServerResponse& response);
@@ -138,6 +150,14 @@ public:
 		///
 		/// Throws an exception if the request is not a proper WebSocket
 		/// upgrade request.
+
+	WebSocket(HTTPServerRequest& request, HTTPServerResponse& response, const WebSocketDeflate::Params& deflateParams);
+		/// Creates a server-side WebSocket from within a
+		/// HTTPRequestHandler, like the constructor above.
+		///
+		/// If the client offers the permessage-deflate extension
+		/// with acceptable parameters, the extension is enabled,
+		/// using the given parameters as server preferences.
 		
 	WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response);
 		/// Creates a client-side WebSocket, using the given
@@ -165,6 +185,19 @@ public:
 		///
 		/// The result of the handshake can be obtained from the response
 		/// object.
+
+	WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, const WebSocketDeflate::Params& deflateParams);
+		/// Creates a client-side WebSocket, like the constructor
+		/// above, and offers the permessage-deflate extension with
+		/// the given parameters in the handshake request.
+		///
+		/// Whether the server has accepted the extension can be
+		/// determined with deflateEnabled().
+
+	WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials, const WebSocketDeflate::Params& deflateParams);
+		/// Creates a client-side WebSocket, like the constructor
+		/// above, and offers the permessage-deflate extension with
+		/// the given parameters in the handshake request.
 	
 	WebSocket(const Socket& socket);
 		/// Creates a WebSocket from another Socket, which must be a WebSocket,
@@ -201,6 +234,21 @@ public:
 		///
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
+		///
+		/// If permessage-deflate is enabled, the payload of text and
+		/// binary frames is compressed, unless it is smaller than
+		/// WebSocketDeflate::Params::minimumSize. The returned value
+		/// is the uncompressed size.
+
+	int sendFrame(const SocketBufVec& buffers, int flags = FRAME_TEXT);
+		/// Sends the contents of the given buffers through
+		/// the socket as a single frame.
+		///
+		/// Unless the payload must be masked (client-side WebSocket)
+		/// or compressed, it is sent directly from the given buffers,
+		/// together with the frame header, without copying it.
+		///
+		/// Otherwise the same as sendFrame() above.
 
 	int receiveFrame(void* buffer, int length, int& flags);
 		/// Receives a frame from the socket and stores it
@@ -224,6 +272,11 @@ public:
 		/// Receives a frame from the socket and stores it
 		/// after any previous content in buffer.
 		///
+		/// If the payload of a compressed frame decompresses to more
+		/// than WebSocketDeflate::Params::maxPayloadSize bytes,
+		/// a WebSocketException is thrown and the WebSocket
+		/// connection must be terminated.
+		///
 		/// Returns the number of bytes received.
 		/// A return value of 0 means that the peer has
 		/// shut down or closed the connection.
@@ -235,18 +288,41 @@ public:
 		/// The frame flags and opcode (FrameFlags and FrameOpcodes)
 		/// is stored in flags.
 
+	int receiveFrame(SocketBufVec& buffers, int& flags);
+		/// Receives a frame from the socket and stores its
+		/// payload in the given buffers, which are filled in order.
+		///
+		/// The payload of an uncompressed frame is received directly
+		/// into the given buffers. If the payload is larger than the
+		/// buffers, a WebSocketException is thrown and the WebSocket
+		/// connection must be terminated.
+		///
+		/// Otherwise the same as receiveFrame() above.
+
 	Mode mode() const;
 		/// Returns WS_SERVER if the WebSocket is a server-side
 		/// WebSocket, or WS_CLIENT otherwise.
 
+	bool deflateEnabled() const;
+		/// Returns true if the permessage-deflate extension
+		/// has been negotiated in the handshake.
+
+	const WebSocketDeflate::Params& deflateParams() const;
+		/// Returns the parameters of the permessage-deflate
+		/// extension agreed upon in the handshake.
+		///
+		/// Throws an IllegalStateException if the extension
+		/// is not enabled.
+
 	static const std::string WEBSOCKET_VERSION;
 		/// The WebSocket protocol version supported (13).
 	
 protected:
-	static WebSocketImpl* accept(HTTPServerRequest& request, HTTPServerResponse& response);
-	static WebSocketImpl* connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials);
-	static WebSocketImpl* completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key);
+	static WebSocketImpl* accept(HTTPServerRequest& request, HTTPServerResponse& response, const WebSocketDeflate::Params* pDeflateParams = 0);
+	static WebSocketImpl* connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials, const WebSocketDeflate::Params* pDeflateParams = 0);
+	static WebSocketImpl* completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key, const WebSocketDeflate::Params* pDeflateParams = 0);
 	static std::string computeAccept(const std::string& key);
+	static std::string extensions(const MessageHeader& header);
 	static std::string createKey();
 	
 private:
@@ -0,0 +1,243 @@
+//
+// WebSocketDeflate.h
+//
+// Library: Net
+// Package: WebSocket
+// Module:  WebSocketDeflate
+//
+// Definition of the WebSocketDeflate class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_WebSocketDeflate_INCLUDED
+#define Net_WebSocketDeflate_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/SocketDefs.h"
+#include "Poco/Buffer.h"
+#include <ostream>
+#include <string>
+
+
+namespace Poco {
+
+
+class DeflatingOutputStream;
+class InflatingOutputStream;
+
+
+namespace Net {
+
+
+class Net_API WebSocketDeflate
+	/// This class implements the permessage-deflate WebSocket
+	/// extension specified in RFC 7692.
+	///
+	/// It provides the negotiation of the extension parameters
+	/// in the WebSocket opening handshake, and the compression and
+	/// decompression of message payloads, for use by WebSocket and
+	/// WebSocketImpl.
+	///
+	/// Payloads are compressed with a DeflatingOutputStream and
+	/// decompressed with an InflatingOutputStream, using raw deflate
+	/// streams. Unless context takeover has been disabled, the
+	/// compression context is kept between messages, which improves
+	/// the compression ratio for similar messages, at the cost
+	/// of keeping the zlib state (up to a few hundred KB) for the
+	/// lifetime of the WebSocket.
+{
+public:
+	struct Net_API Params
+		/// The parameters of the permessage-deflate extension.
+		///
+		/// When passed to a WebSocket constructor, the parameters
+		/// specify what the local endpoint wants to use. After the
+		/// handshake, WebSocket::deflateParams() returns the
+		/// parameters that have been agreed upon.
+	{
+		Params();
+			/// Creates Params with default values (context takeover
+			/// enabled, 15 bit windows, default compression level,
+			/// minimumSize 64, maxPayloadSize DEFAULT_MAX_PAYLOAD_SIZE).
+
+		bool serverNoContextTakeover;
+			/// If true, the server resets its compression
+			/// context after every message.
+
+		bool clientNoContextTakeover;
+			/// If true, the client resets its compression
+			/// context after every message.
+
+		int serverMaxWindowBits;
+			/// The base-2 logarithm of the LZ77 window size used
+			/// by the server for compression (9 - 15).
+
+		int clientMaxWindowBits;
+			/// The base-2 logarithm of the LZ77 window size used
+			/// by the client for compression (9 - 15).
+
+		int compressionLevel;
+			/// The zlib compression level (0 - 9, or -1 for
+			/// the default level). Not negotiated.
+
+		std::size_t minimumSize;
+			/// Messages whose payload is smaller than the given
+			/// number of bytes are sent uncompressed. Not negotiated.
+
+		std::size_t maxPayloadSize;
+			/// The maximum size of the decompressed payload of a
+			/// received frame. If a frame decompresses to more than
+			/// the given number of bytes, decompression is stopped and
+			/// a WebSocketException with WS_ERR_PAYLOAD_TOO_BIG is
+			/// thrown. Not negotiated.
+	};
+
+	enum
+	{
+		DEFAULT_MAX_PAYLOAD_SIZE = 16*1024*1024
+			/// The default maximum size of a decompressed frame payload.
+	};
+
+	WebSocketDeflate(const Params& params, bool server);
+		/// Creates the WebSocketDeflate, using the given agreed
+		/// upon parameters. If server is true, the object is
+		/// used by the server endpoint, otherwise by the client.
+
+	~WebSocketDeflate();
+		/// Destroys the WebSocketDeflate.
+
+	const Params& params() const;
+		/// Returns the agreed upon parameters.
+
+	void compress(const SocketBuf* pBuffers, std::size_t count, bool fin, Poco::Buffer<char>& compressed);
+		/// Compresses the contents of the given buffers, which
+		/// form a message, or a fragment of a message, and stores
+		/// the compressed data in compressed, replacing its previous
+		/// content.
+		///
+		/// Fin must be true for the last fragment of a message.
+
+	void decompress(const char* data, std::size_t length, bool fin, Poco::Buffer<char>& buffer);
+		/// Decompresses the given payload of a compressed message,
+		/// or a fragment of it, and appends the decompressed data
+		/// to buffer.
+		///
+		/// Fin must be true for the last fragment of a message.
+		///
+		/// Throws a WebSocketException if the decompressed data
+		/// is larger than Params::maxPayloadSize, or if the data
+		/// cannot be decompressed.
+
+	std::size_t decompress(const char* data, std::size_t length, bool fin, char* buffer, std::size_t size);
+		/// Decompresses the given payload of a compressed message,
+		/// or a fragment of it, into the given buffer, and returns
+		/// the number of bytes stored in buffer.
+		///
+		/// Throws a WebSocketException if the decompressed data
+		/// does not fit into buffer, or if the data cannot be
+		/// decompressed.
+
+	std::size_t decompress(const char* data, std::size_t length, bool fin, const SocketBuf* pBuffers, std::size_t count);
+		/// Decompresses the given payload of a compressed message,
+		/// or a fragment of it, into the given buffers, which are
+		/// filled in order, and returns the number of bytes stored.
+		///
+		/// Throws a WebSocketException if the decompressed data
+		/// does not fit into the buffers, or if the data cannot be
+		/// decompressed.
+
+	static std::string offer(const Params& params);
+		/// Returns a Sec-WebSocket-Extensions header value
+		/// requesting the extension with the given parameters,
+		/// for use by a client.
+
+	static bool accept(const std::string& extensions, const Params& params, Params& agreed, std::string& response);
+		/// Looks for an acceptable permessage-deflate offer in the
+		/// given Sec-WebSocket-Extensions header value sent by a client.
+		///
+		/// If one is found, stores the parameters agreed upon, based
+		/// on the offer and the server's preferences given in params,
+		/// in agreed, stores the Sec-WebSocket-Extensions header value
+		/// for the response in response, and returns true.
+		/// Otherwise, returns false.
+
+	static bool confirm(const std::string& extensions, const Params& params, Params& agreed);
+		/// Checks the given Sec-WebSocket-Extensions header value sent
+		/// by a server in response to an offer created from params.
+		///
+		/// If the server has accepted the offer, stores the agreed
+		/// upon parameters in agreed and returns true. If the
+		/// server has not accepted the offer, returns false.
+		///
+		/// Throws a WebSocketException if the response
+		/// contains invalid parameters.
+
+	static const std::string EXTENSION_NAME;
+		/// The name of the extension ("permessage-deflate").
+
+private:
+	WebSocketDeflate(const WebSocketDeflate&);
+	WebSocketDeflate& operator = (const WebSocketDeflate&);
+
+	class SinkBuf: public std::streambuf
+		/// A stream buffer that appends up to a given number of
+		/// bytes to a Poco::Buffer<char>, or writes to a sequence
+		/// of fixed-size memory areas. Writing data that does
+		/// not fit fails.
+	{
+	public:
+		SinkBuf();
+		void setTarget(Poco::Buffer<char>& buffer, std::size_t limit);
+		void setTarget(const SocketBuf* pBuffers, std::size_t count);
+		std::size_t written() const;
+		bool overflowed() const;
+
+	protected:
+		int_type overflow(int_type c);
+		std::streamsize xsputn(const char* s, std::streamsize n);
+
+	private:
+		Poco::Buffer<char>* _pBuffer;
+		const SocketBuf* _pBuffers;
+		std::size_t _count;
+		std::size_t _index;
+		std::size_t _offset;
+		std::size_t _limit;
+		std::size_t _written;
+		bool _overflowed;
+	};
+
+	static void validate(const Params& params);
+	void inflate(const char* data, std::size_t length, bool fin);
+
+	Params _params;
+	int _deflateWindowBits;
+	bool _deflateNoContextTakeover;
+	SinkBuf _deflateBuf;
+	std::ostream _deflateSink;
+	Poco::DeflatingOutputStream* _pDeflater;
+	SinkBuf _inflateBuf;
+	std::ostream _inflateSink;
+	Poco::InflatingOutputStream* _pInflater;
+};
+
+
+//
+// inlines
+//
+inline const WebSocketDeflate::Params& WebSocketDeflate::params() const
+{
+	return _params;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_WebSocketDeflate_INCLUDED
@@ -19,9 +19,9 @@
 
 
 #include "Poco/Net/StreamSocketImpl.h"
+#include "Poco/Net/WebSocketDeflate.h"
 #include "Poco/Buffer.h"
 #include "Poco/Random.h"
-#include "Poco/Buffer.h"
 
 
 namespace Poco {
@@ -38,10 +38,18 @@ class Net_API WebSocketImpl: public StreamSocketImpl
 public:
 	WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, HTTPSession& session, bool mustMaskPayload);
 		/// Creates a WebSocketImpl.
+
+	WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, HTTPSession& session, bool mustMaskPayload, const WebSocketDeflate::Params& deflateParams);
+		/// Creates a WebSocketImpl using the permessage-deflate
+		/// extension with the given agreed upon parameters.
 	
 	// StreamSocketImpl
 	virtual int sendBytes(const void* buffer, int length, int flags);
 		/// Sends a WebSocket protocol frame.
+
+	virtual int sendBytes(const SocketBufVec& buffers, int flags);
+		/// Sends a WebSocket protocol frame containing
+		/// the contents of all buffers as payload.
 		
 	virtual int receiveBytes(void* buffer, int length, int flags);
 		/// Receives a WebSocket protocol frame.
@@ -49,6 +57,11 @@ public:
 	virtual int receiveBytes(Poco::Buffer<char>& buffer, int flags);
 		/// Receives a WebSocket protocol frame.
 
+	virtual int receiveBytes(SocketBufVec& buffers, int flags);
+		/// Receives a WebSocket protocol frame and stores
+		/// its payload in the given buffers.
+
+	virtual std::streamsize sendFile(FileInputStream& fileInputStream, std::streamoff offset = 0, std::streamsize count = 0);
 	virtual SocketImpl* acceptConnection(SocketAddress& clientAddr);
 	virtual void connect(const SocketAddress& address);
 	virtual void connect(const SocketAddress& address, const Poco::Timespan& timeout);
@@ -79,6 +92,10 @@ public:
 	bool mustMaskPayload() const;
 		/// Returns true if the payload must be masked.
 
+	const WebSocketDeflate* deflate() const;
+		/// Returns the WebSocketDeflate object if the permessage-deflate
+		/// extension is enabled, or null otherwise.
+
 protected:
 	enum
 	{
@@ -86,8 +103,13 @@ protected:
 		MAX_HEADER_LENGTH = 14
 	};
 	
+	int sendFrame(const SocketBuf* pPayload, std::size_t count, int flags);
+	void writeFrame(const SocketBuf* pPayload, std::size_t count, int flags);
 	int receiveHeader(char mask[4], bool& useMask);
 	int receivePayload(char *buffer, int payloadLength, char mask[4], bool useMask);
+	int receivePayload(const SocketBufVec& buffers, int payloadLength, char mask[4], bool useMask);
+	bool receiveCompressed();
+	void receiveCompressedPayload(int payloadLength, char mask[4], bool useMask);
 	int receiveNBytes(void* buffer, int bytes);
 	int receiveSomeBytes(char* buffer, int bytes);
 	virtual ~WebSocketImpl();
@@ -101,6 +123,11 @@ private:
 	int _frameFlags;
 	bool _mustMaskPayload;
 	Poco::Random _rnd;
+	WebSocketDeflate* _pDeflate;
+	Poco::Buffer<char> _deflateBuffer;
+	Poco::Buffer<char> _inflateBuffer;
+	bool _deflateMessage;
+	bool _inflateMessage;
 };
 
 
@@ -119,6 +146,12 @@ inline bool WebSocketImpl::mustMaskPayload() const
 }
 
 
+inline const WebSocketDeflate* WebSocketImpl::deflate() const
+{
+	return _pDeflate;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -0,0 +1,245 @@
+//
+// DispatcherBenchmark.cpp
+//
+// This sample compares the dispatch modes of TCPServerDispatcher
+// under a connection storm generated by the HTTPLoadTest sample.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Util/ServerApplication.h"
+#include "Poco/Util/Option.h"
+#include "Poco/Util/OptionSet.h"
+#include "Poco/Util/HelpFormatter.h"
+#include <iostream>
+
+
+using Poco::Net::ServerSocket;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPServer;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::TCPServerParams;
+using Poco::Stopwatch;
+using Poco::ThreadPool;
+using Poco::NumberParser;
+using Poco::Util::ServerApplication;
+using Poco::Util::Application;
+using Poco::Util::Option;
+using Poco::Util::OptionSet;
+using Poco::Util::HelpFormatter;
+
+
+class HelloRequestHandler: public HTTPRequestHandler
+{
+public:
+	void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+	{
+		static const std::string body("Hello, world!\n");
+
+		response.setContentType("text/plain");
+		response.setContentLength(static_cast<int>(body.size()));
+		response.send() << body;
+	}
+};
+
+
+class HelloRequestHandlerFactory: public HTTPRequestHandlerFactory
+{
+public:
+	HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+	{
+		return new HelloRequestHandler;
+	}
+};
+
+
+class DispatcherBenchmark: public Poco::Util::ServerApplication
+	/// The main application class.
+	///
+	/// Starts a HTTPServer that answers every request with
+	/// a short text and uses the dispatch mode given on the
+	/// command line. HTTPLoadTest opens a new connection for
+	/// every request, so it makes a good accept storm generator:
+	///
+	///     DispatcherBenchmark --dispatch=queue --port=9980
+	///     HTTPLoadTest --uri=http://localhost:9980/ --threads=64 --repetitions=1000
+	///
+	/// Repeat with --dispatch=stealing, or with --acceptors=4 (and
+	/// optionally --affinity) to spread accepting over several
+	/// SO_REUSEPORT sockets, and compare the request rates reported
+	/// by HTTPLoadTest. When stopped with CTRL-C, DispatcherBenchmark
+	/// prints the dispatcher statistics.
+{
+public:
+	DispatcherBenchmark():
+		_helpRequested(false),
+		_port(9980),
+		_maxThreads(16),
+		_maxQueued(1000),
+		_mode(TCPServerParams::DISPATCH_QUEUE),
+		_acceptors(1),
+		_affinity(false)
+	{
+	}
+
+	~DispatcherBenchmark()
+	{
+	}
+
+protected:
+	void defineOptions(OptionSet& options)
+	{
+		ServerApplication::defineOptions(options);
+
+		options.addOption(
+			Option("help", "h", "display help information on command line arguments")
+				.required(false)
+				.repeatable(false));
+
+		options.addOption(
+			Option("port", "p", "port to listen on (default 9980)")
+				.required(false)
+				.repeatable(false)
+				.argument("port"));
+
+		options.addOption(
+			Option("threads", "t", "maximum number of connection threads (default 16)")
+				.required(false)
+				.repeatable(false)
+				.argument("threads"));
+
+		options.addOption(
+			Option("queued", "q", "maximum number of queued connections (default 1000)")
+				.required(false)
+				.repeatable(false)
+				.argument("queued"));
+
+		options.addOption(
+			Option("dispatch", "d", "dispatch mode, queue (default) or stealing")
+				.required(false)
+				.repeatable(false)
+				.argument("mode"));
+
+		options.addOption(
+			Option("acceptors", "a", "number of SO_REUSEPORT acceptors (default 1)")
+				.required(false)
+				.repeatable(false)
+				.argument("acceptors"));
+
+		options.addOption(
+			Option("affinity", "f", "pin each acceptor and its threads to a CPU")
+				.required(false)
+				.repeatable(false));
+	}
+
+	void handleOption(const std::string& name, const std::string& value)
+	{
+		ServerApplication::handleOption(name, value);
+
+		if (name == "help")
+			_helpRequested = true;
+		else if (name == "port")
+			_port = static_cast<Poco::UInt16>(NumberParser::parseUnsigned(value));
+		else if (name == "threads")
+			_maxThreads = NumberParser::parse(value);
+		else if (name == "queued")
+			_maxQueued = NumberParser::parse(value);
+		else if (name == "dispatch")
+			_mode = value == "stealing" ? TCPServerParams::DISPATCH_WORK_STEALING : TCPServerParams::DISPATCH_QUEUE;
+		else if (name == "acceptors")
+			_acceptors = NumberParser::parse(value);
+		else if (name == "affinity")
+			_affinity = true;
+	}
+
+	void displayHelp()
+	{
+		HelpFormatter helpFormatter(options());
+		helpFormatter.setCommand(commandName());
+		helpFormatter.setUsage("OPTIONS");
+		helpFormatter.setHeader("A minimal web server for benchmarking TCPServerDispatcher with HTTPLoadTest.");
+		helpFormatter.format(std::cout);
+	}
+
+	int main(const std::vector<std::string>& args)
+	{
+		if (_helpRequested)
+		{
+			displayHelp();
+			return Application::EXIT_OK;
+		}
+
+		ThreadPool::defaultPool().addCapacity(_maxThreads);
+
+		HTTPServerParams* pParams = new HTTPServerParams;
+		pParams->setMaxQueued(_maxQueued);
+		pParams->setMaxThreads(_maxThreads);
+		pParams->setKeepAlive(false);
+		pParams->setDispatchMode(_mode);
+		pParams->setAcceptors(_acceptors);
+		pParams->setThreadAffinity(_affinity);
+
+		ServerSocket svs;
+		svs.bind(_port, true, _acceptors > 1);
+		svs.listen(1024);
+		HTTPServer srv(new HelloRequestHandlerFactory, svs, pParams);
+		srv.start();
+		std::cout << "Listening on port " << _port << " using "
+			<< (_mode == TCPServerParams::DISPATCH_WORK_STEALING ? "work stealing" : "queue")
+			<< " dispatch with " << _acceptors << " acceptor(s) and "
+			<< _maxThreads << " threads per acceptor." << std::endl;
+
+		Stopwatch sw;
+		sw.start();
+		waitForTerminationRequest();
+		sw.stop();
+
+		std::cout << "Connections:        " << srv.totalConnections() << std::endl;
+		std::cout << "Connections/s:      " << srv.totalConnections()/(sw.elapsed()/1000000.0) << std::endl;
+		std::cout << "Max. concurrent:    " << srv.maxConcurrentConnections() << std::endl;
+		std::cout << "Refused:            " << srv.refusedConnections() << std::endl;
+		std::cout << "Stolen:             " << srv.stolenConnections() << std::endl;
+		std::vector<int> depths = srv.queueDepths();
+		if (!depths.empty())
+		{
+			std::cout << "Queue depths:      ";
+			for (std::vector<int>::const_iterator it = depths.begin(); it != depths.end(); ++it)
+			{
+				std::cout << ' ' << *it;
+			}
+			std::cout << std::endl;
+		}
+
+		srv.stop();
+		return Application::EXIT_OK;
+	}
+
+private:
+	bool _helpRequested;
+	Poco::UInt16 _port;
+	int _maxThreads;
+	int _maxQueued;
+	TCPServerParams::DispatchMode _mode;
+	int _acceptors;
+	bool _affinity;
+};
+
+
+POCO_SERVER_MAIN(DispatcherBenchmark)
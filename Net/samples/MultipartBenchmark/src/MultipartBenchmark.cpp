@@ -0,0 +1,207 @@
+//
+// MultipartBenchmark.cpp
+//
+// This sample measures the throughput of MultipartReader and
+// HTMLForm when reading a large (by default 1 GB) multipart
+// message body, optionally storing the uploaded file with
+// a FilePartHandler.
+//
+// Usage: MultipartBenchmark [<megabytes> [<directory>]]
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/MultipartReader.h"
+#include "Poco/Net/MessageHeader.h"
+#include "Poco/Net/HTMLForm.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/NullPartHandler.h"
+#include "Poco/Net/FilePartHandler.h"
+#include "Poco/Buffer.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include <iostream>
+#include <streambuf>
+#include <istream>
+
+
+using Poco::Net::MultipartReader;
+using Poco::Net::MessageHeader;
+using Poco::Net::HTMLForm;
+using Poco::Net::HTTPRequest;
+using Poco::Net::NullPartHandler;
+using Poco::Net::FilePartHandler;
+using Poco::Stopwatch;
+
+
+namespace
+{
+	const std::string BOUNDARY("MIME_boundary_0123456789abcdef");
+
+	class MultipartBodyBuf: public std::streambuf
+		/// Generates a multipart/form-data body with a single
+		/// file part of the given size, without keeping the
+		/// body in memory.
+	{
+	public:
+		MultipartBodyBuf(Poco::UInt64 size):
+			_head("--" + BOUNDARY + "\r\n"
+				"Content-Disposition: form-data; name=\"upload\"; filename=\"data.bin\"\r\n"
+				"Content-Type: application/octet-stream\r\n"
+				"\r\n"),
+			_tail("\r\n--" + BOUNDARY + "--\r\n"),
+			_chunk(CHUNK_SIZE),
+			_remaining(size),
+			_state(0)
+		{
+			// Binary data, with line breaks and dashes
+			// to make the boundary search a bit harder.
+			Poco::UInt32 x = 12345;
+			for (std::size_t i = 0; i < _chunk.size(); i++)
+			{
+				x = x*1103515245 + 12345;
+				_chunk[i] = static_cast<char>(x >> 24);
+				if (i % 997 == 0) _chunk[i] = '\n';
+				else if (i % 997 < 3) _chunk[i] = '-';
+			}
+		}
+
+	protected:
+		int_type underflow()
+		{
+			if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+			switch (_state)
+			{
+			case 0:
+				setg(&_head[0], &_head[0], &_head[0] + _head.size());
+				_state = 1;
+				break;
+			case 1:
+				if (_remaining > 0)
+				{
+					std::size_t n = _remaining < _chunk.size() ? static_cast<std::size_t>(_remaining) : _chunk.size();
+					setg(_chunk.begin(), _chunk.begin(), _chunk.begin() + n);
+					_remaining -= n;
+					break;
+				}
+				_state = 2;
+				// fallthrough
+			case 2:
+				setg(&_tail[0], &_tail[0], &_tail[0] + _tail.size());
+				_state = 3;
+				break;
+			default:
+				return traits_type::eof();
+			}
+			return traits_type::to_int_type(*gptr());
+		}
+
+	private:
+		enum
+		{
+			CHUNK_SIZE = 1024*1024
+		};
+
+		std::string _head;
+		std::string _tail;
+		Poco::Buffer<char> _chunk;
+		Poco::UInt64 _remaining;
+		int _state;
+	};
+
+	void report(const std::string& label, Stopwatch& sw, Poco::UInt64 bytes)
+	{
+		double seconds = static_cast<double>(sw.elapsed())/1000000;
+		std::cout << label << ' ' << sw.elapsed()/1000 << " [ms], "
+			<< static_cast<double>(bytes)/(1024*1024)/seconds << " [MB/s]" << std::endl;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	Poco::UInt64 megabytes = 1024;
+	if (argc > 1) megabytes = Poco::NumberParser::parseUnsigned64(argv[1]);
+	std::string directory;
+	if (argc > 2) directory = argv[2];
+
+	Poco::UInt64 size = megabytes*1024*1024;
+	Poco::UInt64 total = 0;
+
+	{
+		MultipartBodyBuf buf(size);
+		std::istream istr(&buf);
+		Stopwatch sw;
+		sw.start();
+		MultipartReader reader(istr, BOUNDARY);
+		Poco::Buffer<char> buffer(65536);
+		while (reader.hasNextPart())
+		{
+			MessageHeader header;
+			reader.nextPart(header);
+			std::istream& part = reader.stream();
+			while (part.read(buffer.begin(), buffer.size()) || part.gcount() > 0)
+			{
+				total += part.gcount();
+			}
+		}
+		sw.stop();
+		report("MultipartReader (read)           ", sw, size);
+	}
+
+	{
+		MultipartBodyBuf buf(size);
+		std::istream istr(&buf);
+		Stopwatch sw;
+		sw.start();
+		MultipartReader reader(istr, BOUNDARY);
+		MessageHeader header;
+		reader.nextPart(header);
+		std::istream& part = reader.stream();
+		int ch = part.get();
+		while (ch != std::char_traits<char>::eof())
+		{
+			++total;
+			ch = part.get();
+		}
+		sw.stop();
+		report("MultipartReader (get)            ", sw, size);
+	}
+
+	HTTPRequest request(HTTPRequest::HTTP_POST, "/upload");
+	request.setContentType(HTMLForm::ENCODING_MULTIPART + "; boundary=\"" + BOUNDARY + "\"");
+
+	{
+		MultipartBodyBuf buf(size);
+		std::istream istr(&buf);
+		Stopwatch sw;
+		sw.start();
+		NullPartHandler handler;
+		HTMLForm form(request, istr, handler);
+		sw.stop();
+		report("HTMLForm (NullPartHandler)       ", sw, size);
+	}
+
+	if (!directory.empty())
+	{
+		MultipartBodyBuf buf(size);
+		std::istream istr(&buf);
+		Stopwatch sw;
+		sw.start();
+		FilePartHandler handler(directory);
+		HTMLForm form(request, istr, handler);
+		sw.stop();
+		report("HTMLForm (FilePartHandler)       ", sw, size);
+		for (FilePartHandler::PartVec::const_iterator it = handler.parts().begin(); it != handler.parts().end(); ++it)
+		{
+			std::cout << "  " << it->path << ": " << it->size << " bytes" << std::endl;
+		}
+	}
+
+	return total > 0 ? 0 : 1;
+}
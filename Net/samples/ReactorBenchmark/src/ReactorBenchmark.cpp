@@ -0,0 +1,167 @@
+//
+// ReactorBenchmark.cpp
+//
+// This sample compares the classic SocketReactor event loop
+// with the allocation-free (OPT_FAST_DISPATCH) event loop.
+//
+// A number of loopback connections is registered with the reactor,
+// then single bytes are written to a rotating subset of them and
+// the time needed by the reactor to dispatch all resulting
+// ReadableNotifications is measured.
+//
+// Usage: ReactorBenchmark [<sockets> ...]
+//
+// The default socket counts are 1000, 10000 and 50000. Each connection
+// needs two file descriptors, so the open file limit (ulimit -n)
+// may have to be raised.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Observer.h"
+#include "Poco/Thread.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+
+using Poco::Net::SocketReactor;
+using Poco::Net::ReadableNotification;
+using Poco::Net::StreamSocket;
+using Poco::Net::ServerSocket;
+using Poco::Net::SocketAddress;
+using Poco::Observer;
+using Poco::Thread;
+using Poco::Stopwatch;
+
+
+class CountingHandler
+{
+public:
+	CountingHandler(const StreamSocket& socket, SocketReactor& reactor, int& count, int target):
+		_socket(socket),
+		_reactor(reactor),
+		_count(count),
+		_target(target)
+	{
+		_reactor.addEventHandler(_socket, Observer<CountingHandler, ReadableNotification>(*this, &CountingHandler::onReadable));
+	}
+
+	~CountingHandler()
+	{
+		_reactor.removeEventHandler(_socket, Observer<CountingHandler, ReadableNotification>(*this, &CountingHandler::onReadable));
+	}
+
+	void onReadable(ReadableNotification* pNf)
+	{
+		pNf->release();
+		char buffer[64];
+		int n = _socket.receiveBytes(buffer, sizeof(buffer));
+		if (n > 0)
+		{
+			_count += n;
+			if (_count >= _target) _reactor.stop();
+		}
+	}
+
+private:
+	StreamSocket   _socket;
+	SocketReactor& _reactor;
+	int&           _count;
+	int            _target;
+};
+
+
+void benchmark(int sockets, int options, const std::string& label)
+{
+	const int ACTIVE = 1000;
+	const int ROUNDS = 100;
+	int active = sockets < ACTIVE ? sockets : ACTIVE;
+	int target = active*ROUNDS;
+
+	ServerSocket server(SocketAddress("127.0.0.1", 0), 1024);
+	SocketAddress address("127.0.0.1", server.address().port());
+	std::vector<StreamSocket> clients;
+	clients.reserve(sockets);
+
+	SocketReactor reactor(Poco::Timespan(250000), options);
+	std::vector<CountingHandler*> handlers;
+	handlers.reserve(sockets);
+	int count = 0;
+	for (int i = 0; i < sockets; i++)
+	{
+		clients.push_back(StreamSocket(address));
+		handlers.push_back(new CountingHandler(server.acceptConnection(), reactor, count, target));
+	}
+
+	Thread thread;
+	Stopwatch sw;
+	sw.start();
+	thread.start(reactor);
+	int next = 0;
+	for (int round = 0; round < ROUNDS; round++)
+	{
+		for (int i = 0; i < active; i++)
+		{
+			clients[next].sendBytes("x", 1);
+			next = (next + 1) % sockets;
+		}
+	}
+	thread.join();
+	sw.stop();
+
+	std::cout << std::setw(8) << sockets << " sockets, " << std::setw(16) << label << ": "
+		<< std::setw(10) << sw.elapsed() << " [us], "
+		<< std::setw(10) << static_cast<Poco::UInt64>(target)*Poco::Timestamp::resolution()/(sw.elapsed() ? sw.elapsed() : 1)
+		<< " [events/s]" << std::endl;
+
+	for (std::vector<CountingHandler*>::iterator it = handlers.begin(); it != handlers.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	std::vector<int> counts;
+	for (int i = 1; i < argc; i++)
+	{
+		counts.push_back(Poco::NumberParser::parse(argv[i]));
+	}
+	if (counts.empty())
+	{
+		counts.push_back(1000);
+		counts.push_back(10000);
+		counts.push_back(50000);
+	}
+
+	try
+	{
+		for (std::vector<int>::const_iterator it = counts.begin(); it != counts.end(); ++it)
+		{
+			benchmark(*it, SocketReactor::OPT_DEFAULT, "classic");
+			benchmark(*it, SocketReactor::OPT_FAST_DISPATCH, "fast dispatch");
+			benchmark(*it, SocketReactor::OPT_ONESHOT, "fast one-shot");
+			benchmark(*it, SocketReactor::OPT_FAST_DISPATCH | SocketReactor::OPT_IO_URING, "io_uring");
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		std::cerr << exc.displayText() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,430 @@
+//
+// DNSCache.cpp
+//
+// Library: Net
+// Package: NetCore
+// Module:  DNSCache
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/DNSCache.h"
+#include "Poco/Notification.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/ScopedUnlock.h"
+#include "Poco/SingletonHolder.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/String.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	class ResolveNotification: public Poco::Notification
+	{
+	public:
+		ResolveNotification(const std::string& hostname, const std::string& key):
+			_hostname(hostname),
+			_key(key)
+		{
+		}
+
+		const std::string& hostname() const
+		{
+			return _hostname;
+		}
+
+		const std::string& key() const
+		{
+			return _key;
+		}
+
+	private:
+		std::string _hostname;
+		std::string _key;
+	};
+}
+
+
+DNSCache::Pending::Pending():
+	result(new Result::ActiveResultHolderType)
+{
+}
+
+
+DNSCache::DNSCache():
+	_pResolver(new HostResolver),
+	_positiveTTL(DEFAULT_POSITIVE_TTL, 0),
+	_negativeTTL(DEFAULT_NEGATIVE_TTL, 0),
+	_maxEntries(DEFAULT_MAX_ENTRIES),
+	_threadCount(DEFAULT_THREADS),
+	_stopped(false)
+{
+}
+
+
+DNSCache::DNSCache(HostResolver::Ptr pResolver, int threads):
+	_pResolver(pResolver),
+	_positiveTTL(DEFAULT_POSITIVE_TTL, 0),
+	_negativeTTL(DEFAULT_NEGATIVE_TTL, 0),
+	_maxEntries(DEFAULT_MAX_ENTRIES),
+	_threadCount(threads),
+	_stopped(false)
+{
+	poco_check_ptr (pResolver);
+	poco_assert (threads > 0);
+}
+
+
+DNSCache::~DNSCache()
+{
+	try
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_stopped = true;
+		}
+		_queue.wakeUpAll();
+		for (std::vector<Poco::Thread*>::iterator it = _threads.begin(); it != _threads.end(); ++it)
+		{
+			(*it)->join();
+			delete *it;
+		}
+		_queue.clear();
+
+		PendingMap pending;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			pending.swap(_pending);
+		}
+		Poco::IllegalStateException exc("DNSCache has been destroyed");
+		for (PendingMap::iterator it = pending.begin(); it != pending.end(); ++it)
+		{
+			it->second.result.error(exc);
+			it->second.result.notify();
+			for (std::vector<Callback>::const_iterator itCb = it->second.callbacks.begin(); itCb != it->second.callbacks.end(); ++itCb)
+			{
+				invoke(*itCb, it->second.result);
+			}
+		}
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+HostEntry DNSCache::resolve(const std::string& hostname)
+{
+	std::string key = Poco::toLower(hostname);
+	HostResolver::Ptr pResolver;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		EntryMap::iterator it = findEntry(key);
+		if (it != _entries.end())
+		{
+			if (it->second.pException) it->second.pException->rethrow();
+			return it->second.hostEntry;
+		}
+		pResolver = _pResolver;
+	}
+	try
+	{
+		HostEntry hostEntry = pResolver->resolve(hostname);
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		insert(key, hostEntry, 0);
+		return hostEntry;
+	}
+	catch (Poco::Exception& exc)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		insert(key, HostEntry(), exc.clone());
+		throw;
+	}
+}
+
+
+DNSCache::Result DNSCache::resolveAsync(const std::string& hostname)
+{
+	return start(hostname, 0);
+}
+
+
+void DNSCache::resolveAsync(const std::string& hostname, const Callback& callback)
+{
+	start(hostname, &callback);
+}
+
+
+void DNSCache::setResolver(HostResolver::Ptr pResolver)
+{
+	poco_check_ptr (pResolver);
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_pResolver = pResolver;
+	_entries.clear();
+}
+
+
+HostResolver::Ptr DNSCache::getResolver() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _pResolver;
+}
+
+
+void DNSCache::setPositiveTTL(const Poco::Timespan& ttl)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_positiveTTL = ttl;
+}
+
+
+Poco::Timespan DNSCache::getPositiveTTL() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _positiveTTL;
+}
+
+
+void DNSCache::setNegativeTTL(const Poco::Timespan& ttl)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_negativeTTL = ttl;
+}
+
+
+Poco::Timespan DNSCache::getNegativeTTL() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _negativeTTL;
+}
+
+
+void DNSCache::setMaxEntries(std::size_t maxEntries)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_maxEntries = maxEntries;
+	while (_entries.size() > _maxEntries) purge();
+}
+
+
+std::size_t DNSCache::getMaxEntries() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _maxEntries;
+}
+
+
+void DNSCache::remove(const std::string& hostname)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_entries.erase(Poco::toLower(hostname));
+}
+
+
+void DNSCache::clear()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_entries.clear();
+}
+
+
+std::size_t DNSCache::size() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _entries.size();
+}
+
+
+namespace
+{
+	static Poco::SingletonHolder<DNSCache> singleton;
+}
+
+
+DNSCache& DNSCache::defaultCache()
+{
+	return *singleton.get();
+}
+
+
+void DNSCache::run()
+{
+	for (;;)
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_stopped) break;
+		}
+		Poco::AutoPtr<Poco::Notification> pNf(_queue.waitDequeueNotification(WAITTIME_MILLISEC));
+		ResolveNotification* pResolveNf = dynamic_cast<ResolveNotification*>(pNf.get());
+		if (pResolveNf)
+		{
+			HostResolver::Ptr pResolver = getResolver();
+			HostEntry hostEntry;
+			Poco::Exception* pException = 0;
+			try
+			{
+				hostEntry = pResolver->resolve(pResolveNf->hostname());
+			}
+			catch (Poco::Exception& exc)
+			{
+				pException = exc.clone();
+			}
+			catch (std::exception& exc)
+			{
+				pException = new Poco::SystemException(exc.what());
+			}
+			complete(pResolveNf->key(), hostEntry, pException);
+		}
+	}
+}
+
+
+DNSCache::EntryMap::iterator DNSCache::findEntry(const std::string& key)
+{
+	EntryMap::iterator it = _entries.find(key);
+	if (it != _entries.end() && it->second.expires.isElapsed(0))
+	{
+		_entries.erase(it);
+		return _entries.end();
+	}
+	return it;
+}
+
+
+void DNSCache::insert(const std::string& key, const HostEntry& hostEntry, Poco::Exception* pException)
+{
+	Poco::SharedPtr<Poco::Exception> pExc(pException);
+	Poco::Timespan ttl = pExc ? _negativeTTL : _positiveTTL;
+	if (ttl.totalMicroseconds() <= 0 || _maxEntries == 0) return;
+
+	if (_entries.size() >= _maxEntries && _entries.find(key) == _entries.end()) purge();
+
+	Entry& entry = _entries[key];
+	entry.hostEntry = hostEntry;
+	entry.pException = pExc;
+	entry.expires.update();
+	entry.expires += ttl.totalMicroseconds();
+}
+
+
+void DNSCache::purge()
+{
+	EntryMap::iterator it = _entries.begin();
+	while (it != _entries.end())
+	{
+		if (it->second.expires.isElapsed(0))
+			_entries.erase(it++);
+		else
+			++it;
+	}
+	if (!_entries.empty() && _entries.size() >= _maxEntries)
+	{
+		_entries.erase(_entries.begin());
+	}
+}
+
+
+DNSCache::Result DNSCache::start(const std::string& hostname, const Callback* pCallback)
+{
+	std::string key = Poco::toLower(hostname);
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	EntryMap::iterator it = findEntry(key);
+	if (it != _entries.end())
+	{
+		Result result(new Result::ActiveResultHolderType);
+		if (it->second.pException)
+			result.error(*it->second.pException);
+		else
+			result.data(new HostEntry(it->second.hostEntry));
+		result.notify();
+		if (pCallback)
+		{
+			Poco::ScopedUnlock<Poco::FastMutex> unlock(_mutex);
+			invoke(*pCallback, result);
+		}
+		return result;
+	}
+
+	if (_stopped) throw Poco::IllegalStateException("DNSCache has been destroyed");
+
+	PendingMap::iterator itPending = _pending.find(key);
+	if (itPending == _pending.end())
+	{
+		itPending = _pending.insert(PendingMap::value_type(key, Pending())).first;
+		if (_threads.empty())
+		{
+			for (int i = 0; i < _threadCount; i++)
+			{
+				Poco::Thread* pThread = new Poco::Thread("DNSCache");
+				_threads.push_back(pThread);
+				pThread->start(*this);
+			}
+		}
+		_queue.enqueueNotification(new ResolveNotification(hostname, key));
+	}
+	if (pCallback) itPending->second.callbacks.push_back(*pCallback);
+	return itPending->second.result;
+}
+
+
+void DNSCache::complete(const std::string& key, const HostEntry& hostEntry, Poco::Exception* pException)
+{
+	Poco::SharedPtr<Poco::Exception> pExc(pException);
+	Pending pending;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		insert(key, hostEntry, pExc ? pExc->clone() : 0);
+		PendingMap::iterator it = _pending.find(key);
+		if (it == _pending.end()) return;
+		pending = it->second;
+		_pending.erase(it);
+	}
+	if (pExc)
+		pending.result.error(*pExc);
+	else
+		pending.result.data(new HostEntry(hostEntry));
+	pending.result.notify();
+	for (std::vector<Callback>::const_iterator it = pending.callbacks.begin(); it != pending.callbacks.end(); ++it)
+	{
+		invoke(*it, pending.result);
+	}
+}
+
+
+void DNSCache::invoke(const Callback& callback, const Result& result)
+{
+	try
+	{
+		callback(result);
+	}
+	catch (Poco::Exception& exc)
+	{
+		Poco::ErrorHandler::handle(exc);
+	}
+	catch (std::exception& exc)
+	{
+		Poco::ErrorHandler::handle(exc);
+	}
+	catch (...)
+	{
+		Poco::ErrorHandler::handle();
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,76 @@
+//
+// DatagramBatch.cpp
+//
+// Library: Net
+// Package: Sockets
+// Module:  DatagramBatch
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/DatagramBatch.h"
+#include "Poco/Exception.h"
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+DatagramBatch::DatagramBatch(std::size_t capacity, std::size_t datagramSize):
+	_capacity(capacity),
+	_datagramSize(datagramSize),
+	_size(0),
+	_data(capacity*datagramSize),
+	_addresses(capacity*ADDRESS_SLOT_SIZE),
+	_lengths(capacity),
+	_addressLengths(capacity)
+{
+	poco_assert (capacity > 0 && datagramSize > 0);
+}
+
+
+DatagramBatch::~DatagramBatch()
+{
+}
+
+
+void DatagramBatch::add(const void* data, std::size_t length)
+{
+	if (full()) throw Poco::IllegalStateException("DatagramBatch is full");
+	if (length > _datagramSize) throw Poco::InvalidArgumentException("Datagram too large for DatagramBatch");
+
+	if (length > 0) std::memcpy(this->data(_size), data, length);
+	setDatagram(_size, length, 0);
+	++_size;
+}
+
+
+void DatagramBatch::add(const void* data, std::size_t length, const SocketAddress& address)
+{
+	if (full()) throw Poco::IllegalStateException("DatagramBatch is full");
+	if (length > _datagramSize) throw Poco::InvalidArgumentException("Datagram too large for DatagramBatch");
+
+	if (length > 0) std::memcpy(this->data(_size), data, length);
+	std::memcpy(addressBuffer(_size), address.addr(), address.length());
+	setDatagram(_size, length, address.length());
+	++_size;
+}
+
+
+SocketAddress DatagramBatch::address(std::size_t index) const
+{
+	poco_assert (index < _size);
+
+	if (_addressLengths[index] > 0)
+		return SocketAddress(addressBuffer(index), _addressLengths[index]);
+	else
+		return SocketAddress();
+}
+
+
+} } // namespace Poco::Net
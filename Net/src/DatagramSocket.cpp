@@ -93,12 +93,24 @@ int DatagramSocket::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+int DatagramSocket::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	return impl()->sendBytes(buffers, flags);
+}
+
+
 int DatagramSocket::receiveBytes(void* buffer, int length, int flags)
 {
 	return impl()->receiveBytes(buffer, length, flags);
 }
 
 
+int DatagramSocket::receiveBytes(SocketBufVec& buffers, int flags)
+{
+	return impl()->receiveBytes(buffers, flags);
+}
+
+
 int DatagramSocket::sendTo(const void* buffer, int length, const SocketAddress& address, int flags)
 {
 	return impl()->sendTo(buffer, length, address, flags);
@@ -111,4 +123,16 @@ int DatagramSocket::receiveFrom(void* buffer, int length, SocketAddress& address
 }
 
 
+int DatagramSocket::sendBatch(const DatagramBatch& batch, int flags)
+{
+	return impl()->sendBatch(batch, flags);
+}
+
+
+int DatagramSocket::receiveBatch(DatagramBatch& batch, int flags)
+{
+	return impl()->receiveBatch(batch, flags);
+}
+
+
 } } // namespace Poco::Net
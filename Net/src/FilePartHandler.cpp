@@ -0,0 +1,110 @@
+//
+// FilePartHandler.cpp
+//
+// Library: Net
+// Package: Messages
+// Module:  FilePartHandler
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/FilePartHandler.h"
+#include "Poco/Net/MessageHeader.h"
+#include "Poco/Net/NameValueCollection.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/Buffer.h"
+#include "Poco/File.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+FilePartHandler::FilePartHandler():
+	_temporary(true),
+	_maxPartSize(0)
+{
+}
+
+
+FilePartHandler::FilePartHandler(const std::string& directory):
+	_directory(directory),
+	_temporary(false),
+	_maxPartSize(0)
+{
+}
+
+
+FilePartHandler::~FilePartHandler()
+{
+	if (_temporary)
+	{
+		for (PartVec::const_iterator it = _parts.begin(); it != _parts.end(); ++it)
+		{
+			try
+			{
+				Poco::File(it->path).remove();
+			}
+			catch (...)
+			{
+			}
+		}
+	}
+}
+
+
+void FilePartHandler::handlePart(const MessageHeader& header, std::istream& stream)
+{
+	Part part;
+	part.size = 0;
+	if (header.has("Content-Disposition"))
+	{
+		std::string disp;
+		NameValueCollection params;
+		MessageHeader::splitParameters(header.get("Content-Disposition"), disp, params);
+		part.name = params.get("name", "");
+		part.filename = params.get("filename", "");
+	}
+	part.contentType = header.get("Content-Type", "application/octet-stream");
+	part.path = Poco::TemporaryFile::tempName(_directory);
+
+	try
+	{
+		Poco::FileOutputStream ostr(part.path);
+		Poco::Buffer<char> buffer(BUFFER_SIZE);
+		while (stream.good())
+		{
+			stream.read(buffer.begin(), BUFFER_SIZE);
+			std::streamsize n = stream.gcount();
+			if (n <= 0) break;
+			part.size += static_cast<Poco::UInt64>(n);
+			if (_maxPartSize > 0 && part.size > _maxPartSize)
+				throw Poco::DataFormatException("Part too large", part.filename);
+			ostr.write(buffer.begin(), n);
+			if (!ostr.good()) throw Poco::WriteFileException(part.path);
+		}
+		ostr.close();
+		if (!ostr.good()) throw Poco::WriteFileException(part.path);
+	}
+	catch (...)
+	{
+		try
+		{
+			Poco::File(part.path).remove();
+		}
+		catch (...)
+		{
+		}
+		throw;
+	}
+	_parts.push_back(part);
+}
+
+
+} } // namespace Poco::Net
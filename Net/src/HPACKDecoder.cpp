@@ -0,0 +1,136 @@
+//
+// HPACKDecoder.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HPACKDecoder
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HPACKDecoder.h"
+#include "Poco/Net/HPACKHuffman.h"
+#include "Poco/Net/HTTP2Frame.h"
+#include "Poco/Net/NetException.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+HPACKDecoder::HPACKDecoder(std::size_t maxTableSize):
+	_table(maxTableSize),
+	_maxTableSize(maxTableSize),
+	_maxHeaderListSize(65536)
+{
+}
+
+
+HPACKDecoder::~HPACKDecoder()
+{
+}
+
+
+void HPACKDecoder::decode(const char* data, std::size_t length, HPACKTable::HeaderList& headers)
+{
+	const char* end = data + length;
+	std::size_t listSize = 0;
+	bool fieldSeen = false;
+	while (data < end)
+	{
+		unsigned char byte = static_cast<unsigned char>(*data);
+		if (byte & 0x80)
+		{
+			// indexed header field
+			std::size_t index = static_cast<std::size_t>(decodeInteger(data, end, 7));
+			if (index == 0) throw HTTP2Exception("Invalid header table index", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+			headers.push_back(_table.get(index));
+		}
+		else if ((byte & 0xe0) == 0x20)
+		{
+			// dynamic table size update, only allowed at the start of a block
+			if (fieldSeen) throw HTTP2Exception("Misplaced table size update", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+			Poco::UInt64 size = decodeInteger(data, end, 5);
+			if (size > _maxTableSize) throw HTTP2Exception("Table size exceeds limit", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+			_table.setMaxSize(static_cast<std::size_t>(size));
+			continue;
+		}
+		else
+		{
+			// literal header field, with incremental indexing (01),
+			// without indexing (0000) or never indexed (0001)
+			bool indexing = (byte & 0xc0) == 0x40;
+			std::size_t index = static_cast<std::size_t>(decodeInteger(data, end, indexing ? 6 : 4));
+			HPACKTable::Header header;
+			if (index != 0)
+				header.first = _table.get(index).first;
+			else
+				decodeString(data, end, header.first);
+			decodeString(data, end, header.second);
+			if (indexing) _table.add(header.first, header.second);
+			headers.push_back(header);
+		}
+		fieldSeen = true;
+		listSize += HPACKTable::entrySize(headers.back().first, headers.back().second);
+		if (listSize > _maxHeaderListSize)
+			throw HTTP2Exception("Header list too large", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+	}
+}
+
+
+void HPACKDecoder::setMaxTableSize(std::size_t size)
+{
+	_maxTableSize = size;
+	if (_table.maxSize() > size) _table.setMaxSize(size);
+}
+
+
+void HPACKDecoder::setMaxHeaderListSize(std::size_t size)
+{
+	_maxHeaderListSize = size;
+}
+
+
+Poco::UInt64 HPACKDecoder::decodeInteger(const char*& data, const char* end, int prefixBits)
+{
+	if (data >= end) throw HTTP2Exception("Truncated integer", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+
+	const Poco::UInt64 max = (Poco::UInt64(1) << prefixBits) - 1;
+	Poco::UInt64 value = static_cast<unsigned char>(*data++) & max;
+	if (value < max) return value;
+
+	int shift = 0;
+	for (;;)
+	{
+		if (data >= end) throw HTTP2Exception("Truncated integer", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+		if (shift > 56) throw HTTP2Exception("Integer overflow", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+		unsigned char byte = static_cast<unsigned char>(*data++);
+		value += Poco::UInt64(byte & 0x7f) << shift;
+		shift += 7;
+		if ((byte & 0x80) == 0) return value;
+	}
+}
+
+
+void HPACKDecoder::decodeString(const char*& data, const char* end, std::string& str)
+{
+	if (data >= end) throw HTTP2Exception("Truncated string", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+
+	bool huffman = (static_cast<unsigned char>(*data) & 0x80) != 0;
+	Poco::UInt64 length = decodeInteger(data, end, 7);
+	if (length > static_cast<Poco::UInt64>(end - data)) throw HTTP2Exception("Truncated string", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+
+	std::size_t n = static_cast<std::size_t>(length);
+	if (huffman)
+		HPACKHuffman::decode(data, n, str);
+	else
+		str.append(data, n);
+	data += n;
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,140 @@
+//
+// HPACKEncoder.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HPACKEncoder
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HPACKEncoder.h"
+#include "Poco/Net/HPACKHuffman.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	bool isSensitive(const std::string& name)
+	{
+		return name == "authorization" || name == "proxy-authorization";
+	}
+}
+
+
+HPACKEncoder::HPACKEncoder(std::size_t maxTableSize):
+	_table(maxTableSize),
+	_minTableSize(maxTableSize),
+	_tableSizeChanged(false)
+{
+}
+
+
+HPACKEncoder::~HPACKEncoder()
+{
+}
+
+
+void HPACKEncoder::encode(const HPACKTable::HeaderList& headers, std::string& block)
+{
+	if (_tableSizeChanged)
+	{
+		// If the size has been reduced and increased again, the
+		// decoder must see the minimum first, so that it evicts
+		// the same entries as the encoder (RFC 7541, section 4.2).
+		if (_minTableSize < _table.maxSize())
+			encodeInteger(_minTableSize, 5, 0x20, block);
+		encodeInteger(_table.maxSize(), 5, 0x20, block);
+		_minTableSize = _table.maxSize();
+		_tableSizeChanged = false;
+	}
+
+	for (HPACKTable::HeaderList::const_iterator it = headers.begin(); it != headers.end(); ++it)
+	{
+		const std::string& name = it->first;
+		const std::string& value = it->second;
+		bool exact;
+		std::size_t index = _table.find(name, value, exact);
+		if (exact)
+		{
+			encodeInteger(index, 7, 0x80, block);
+		}
+		else if (isSensitive(name))
+		{
+			encodeInteger(index, 4, 0x10, block);
+			if (index == 0) encodeString(name, block);
+			encodeString(value, block);
+		}
+		else if (HPACKTable::entrySize(name, value) > _table.maxSize()/2)
+		{
+			encodeInteger(index, 4, 0x00, block);
+			if (index == 0) encodeString(name, block);
+			encodeString(value, block);
+		}
+		else
+		{
+			encodeInteger(index, 6, 0x40, block);
+			if (index == 0) encodeString(name, block);
+			encodeString(value, block);
+			_table.add(name, value);
+		}
+	}
+}
+
+
+void HPACKEncoder::setMaxTableSize(std::size_t size)
+{
+	if (size != _table.maxSize())
+	{
+		if (!_tableSizeChanged || size < _minTableSize) _minTableSize = size;
+		_table.setMaxSize(size);
+		_tableSizeChanged = true;
+	}
+}
+
+
+void HPACKEncoder::encodeInteger(Poco::UInt64 value, int prefixBits, unsigned char flags, std::string& block)
+{
+	const Poco::UInt64 max = (Poco::UInt64(1) << prefixBits) - 1;
+	if (value < max)
+	{
+		block += static_cast<char>(flags | static_cast<unsigned char>(value));
+	}
+	else
+	{
+		block += static_cast<char>(flags | static_cast<unsigned char>(max));
+		value -= max;
+		while (value >= 128)
+		{
+			block += static_cast<char>((value & 0x7f) | 0x80);
+			value >>= 7;
+		}
+		block += static_cast<char>(value);
+	}
+}
+
+
+void HPACKEncoder::encodeString(const std::string& str, std::string& block)
+{
+	std::size_t huffmanLength = HPACKHuffman::encodedLength(str);
+	if (huffmanLength < str.size())
+	{
+		encodeInteger(huffmanLength, 7, 0x80, block);
+		HPACKHuffman::encode(str, block);
+	}
+	else
+	{
+		encodeInteger(str.size(), 7, 0x00, block);
+		block += str;
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,214 @@
+//
+// HPACKHuffman.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HPACKHuffman
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HPACKHuffman.h"
+#include "Poco/Net/HTTP2Frame.h"
+#include "Poco/Net/NetException.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	struct Code
+	{
+		Poco::UInt32 bits;
+		int length;
+	};
+
+	const Code CODES[257] =
+		// code and length of each symbol, 256 is EOS
+	{
+		{0x00001ff8, 13}, {0x007fffd8, 23}, {0x0fffffe2, 28}, {0x0fffffe3, 28},
+		{0x0fffffe4, 28}, {0x0fffffe5, 28}, {0x0fffffe6, 28}, {0x0fffffe7, 28},
+		{0x0fffffe8, 28}, {0x00ffffea, 24}, {0x3ffffffc, 30}, {0x0fffffe9, 28},
+		{0x0fffffea, 28}, {0x3ffffffd, 30}, {0x0fffffeb, 28}, {0x0fffffec, 28},
+		{0x0fffffed, 28}, {0x0fffffee, 28}, {0x0fffffef, 28}, {0x0ffffff0, 28},
+		{0x0ffffff1, 28}, {0x0ffffff2, 28}, {0x3ffffffe, 30}, {0x0ffffff3, 28},
+		{0x0ffffff4, 28}, {0x0ffffff5, 28}, {0x0ffffff6, 28}, {0x0ffffff7, 28},
+		{0x0ffffff8, 28}, {0x0ffffff9, 28}, {0x0ffffffa, 28}, {0x0ffffffb, 28},
+		{0x00000014,  6}, {0x000003f8, 10}, {0x000003f9, 10}, {0x00000ffa, 12},
+		{0x00001ff9, 13}, {0x00000015,  6}, {0x000000f8,  8}, {0x000007fa, 11},
+		{0x000003fa, 10}, {0x000003fb, 10}, {0x000000f9,  8}, {0x000007fb, 11},
+		{0x000000fa,  8}, {0x00000016,  6}, {0x00000017,  6}, {0x00000018,  6},
+		{0x00000000,  5}, {0x00000001,  5}, {0x00000002,  5}, {0x00000019,  6},
+		{0x0000001a,  6}, {0x0000001b,  6}, {0x0000001c,  6}, {0x0000001d,  6},
+		{0x0000001e,  6}, {0x0000001f,  6}, {0x0000005c,  7}, {0x000000fb,  8},
+		{0x00007ffc, 15}, {0x00000020,  6}, {0x00000ffb, 12}, {0x000003fc, 10},
+		{0x00001ffa, 13}, {0x00000021,  6}, {0x0000005d,  7}, {0x0000005e,  7},
+		{0x0000005f,  7}, {0x00000060,  7}, {0x00000061,  7}, {0x00000062,  7},
+		{0x00000063,  7}, {0x00000064,  7}, {0x00000065,  7}, {0x00000066,  7},
+		{0x00000067,  7}, {0x00000068,  7}, {0x00000069,  7}, {0x0000006a,  7},
+		{0x0000006b,  7}, {0x0000006c,  7}, {0x0000006d,  7}, {0x0000006e,  7},
+		{0x0000006f,  7}, {0x00000070,  7}, {0x00000071,  7}, {0x00000072,  7},
+		{0x000000fc,  8}, {0x00000073,  7}, {0x000000fd,  8}, {0x00001ffb, 13},
+		{0x0007fff0, 19}, {0x00001ffc, 13}, {0x00003ffc, 14}, {0x00000022,  6},
+		{0x00007ffd, 15}, {0x00000003,  5}, {0x00000023,  6}, {0x00000004,  5},
+		{0x00000024,  6}, {0x00000005,  5}, {0x00000025,  6}, {0x00000026,  6},
+		{0x00000027,  6}, {0x00000006,  5}, {0x00000074,  7}, {0x00000075,  7},
+		{0x00000028,  6}, {0x00000029,  6}, {0x0000002a,  6}, {0x00000007,  5},
+		{0x0000002b,  6}, {0x00000076,  7}, {0x0000002c,  6}, {0x00000008,  5},
+		{0x00000009,  5}, {0x0000002d,  6}, {0x00000077,  7}, {0x00000078,  7},
+		{0x00000079,  7}, {0x0000007a,  7}, {0x0000007b,  7}, {0x00007ffe, 15},
+		{0x000007fc, 11}, {0x00003ffd, 14}, {0x00001ffd, 13}, {0x0ffffffc, 28},
+		{0x000fffe6, 20}, {0x003fffd2, 22}, {0x000fffe7, 20}, {0x000fffe8, 20},
+		{0x003fffd3, 22}, {0x003fffd4, 22}, {0x003fffd5, 22}, {0x007fffd9, 23},
+		{0x003fffd6, 22}, {0x007fffda, 23}, {0x007fffdb, 23}, {0x007fffdc, 23},
+		{0x007fffdd, 23}, {0x007fffde, 23}, {0x00ffffeb, 24}, {0x007fffdf, 23},
+		{0x00ffffec, 24}, {0x00ffffed, 24}, {0x003fffd7, 22}, {0x007fffe0, 23},
+		{0x00ffffee, 24}, {0x007fffe1, 23}, {0x007fffe2, 23}, {0x007fffe3, 23},
+		{0x007fffe4, 23}, {0x001fffdc, 21}, {0x003fffd8, 22}, {0x007fffe5, 23},
+		{0x003fffd9, 22}, {0x007fffe6, 23}, {0x007fffe7, 23}, {0x00ffffef, 24},
+		{0x003fffda, 22}, {0x001fffdd, 21}, {0x000fffe9, 20}, {0x003fffdb, 22},
+		{0x003fffdc, 22}, {0x007fffe8, 23}, {0x007fffe9, 23}, {0x001fffde, 21},
+		{0x007fffea, 23}, {0x003fffdd, 22}, {0x003fffde, 22}, {0x00fffff0, 24},
+		{0x001fffdf, 21}, {0x003fffdf, 22}, {0x007fffeb, 23}, {0x007fffec, 23},
+		{0x001fffe0, 21}, {0x001fffe1, 21}, {0x003fffe0, 22}, {0x001fffe2, 21},
+		{0x007fffed, 23}, {0x003fffe1, 22}, {0x007fffee, 23}, {0x007fffef, 23},
+		{0x000fffea, 20}, {0x003fffe2, 22}, {0x003fffe3, 22}, {0x003fffe4, 22},
+		{0x007ffff0, 23}, {0x003fffe5, 22}, {0x003fffe6, 22}, {0x007ffff1, 23},
+		{0x03ffffe0, 26}, {0x03ffffe1, 26}, {0x000fffeb, 20}, {0x0007fff1, 19},
+		{0x003fffe7, 22}, {0x007ffff2, 23}, {0x003fffe8, 22}, {0x01ffffec, 25},
+		{0x03ffffe2, 26}, {0x03ffffe3, 26}, {0x03ffffe4, 26}, {0x07ffffde, 27},
+		{0x07ffffdf, 27}, {0x03ffffe5, 26}, {0x00fffff1, 24}, {0x01ffffed, 25},
+		{0x0007fff2, 19}, {0x001fffe3, 21}, {0x03ffffe6, 26}, {0x07ffffe0, 27},
+		{0x07ffffe1, 27}, {0x03ffffe7, 26}, {0x07ffffe2, 27}, {0x00fffff2, 24},
+		{0x001fffe4, 21}, {0x001fffe5, 21}, {0x03ffffe8, 26}, {0x03ffffe9, 26},
+		{0x0ffffffd, 28}, {0x07ffffe3, 27}, {0x07ffffe4, 27}, {0x07ffffe5, 27},
+		{0x000fffec, 20}, {0x00fffff3, 24}, {0x000fffed, 20}, {0x001fffe6, 21},
+		{0x003fffe9, 22}, {0x001fffe7, 21}, {0x001fffe8, 21}, {0x007ffff3, 23},
+		{0x003fffea, 22}, {0x003fffeb, 22}, {0x01ffffee, 25}, {0x01ffffef, 25},
+		{0x00fffff4, 24}, {0x00fffff5, 24}, {0x03ffffea, 26}, {0x007ffff4, 23},
+		{0x03ffffeb, 26}, {0x07ffffe6, 27}, {0x03ffffec, 26}, {0x03ffffed, 26},
+		{0x07ffffe7, 27}, {0x07ffffe8, 27}, {0x07ffffe9, 27}, {0x07ffffea, 27},
+		{0x07ffffeb, 27}, {0x0ffffffe, 28}, {0x07ffffec, 27}, {0x07ffffed, 27},
+		{0x07ffffee, 27}, {0x07ffffef, 27}, {0x07fffff0, 27}, {0x03ffffee, 26},
+		{0x3fffffff, 30}
+	};
+
+	// The code is canonical: the codes of each length are consecutive
+	// numbers, assigned to the symbols in ascending order. For decoding,
+	// SYMBOLS lists the symbols ordered by code, and FIRST_CODE, CODE_COUNT
+	// and SYMBOL_OFFSET give the first code, the number of codes and the
+	// index of the first symbol in SYMBOLS for each code length.
+
+	const Poco::UInt16 SYMBOLS[257] =
+	{
+		 48,  49,  50,  97,  99, 101, 105, 111, 115, 116,  32,  37,  45,  46,  47,  51,
+		 52,  53,  54,  55,  56,  57,  61,  65,  95,  98, 100, 102, 103, 104, 108, 109,
+		110, 112, 114, 117,  58,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  76,
+		 77,  78,  79,  80,  81,  82,  83,  84,  85,  86,  87,  89, 106, 107, 113, 118,
+		119, 120, 121, 122,  38,  42,  44,  59,  88,  90,  33,  34,  40,  41,  63,  39,
+		 43, 124,  35,  62,   0,  36,  64,  91,  93, 126,  94, 125,  60,  96, 123,  92,
+		195, 208, 128, 130, 131, 162, 184, 194, 224, 226, 153, 161, 167, 172, 176, 177,
+		179, 209, 216, 217, 227, 229, 230, 129, 132, 133, 134, 136, 146, 154, 156, 160,
+		163, 164, 169, 170, 173, 178, 181, 185, 186, 187, 189, 190, 196, 198, 228, 232,
+		233,   1, 135, 137, 138, 139, 140, 141, 143, 147, 149, 150, 151, 152, 155, 157,
+		158, 165, 166, 168, 174, 175, 180, 182, 183, 188, 191, 197, 231, 239,   9, 142,
+		144, 145, 148, 159, 171, 206, 215, 225, 236, 237, 199, 207, 234, 235, 192, 193,
+		200, 201, 202, 205, 210, 213, 218, 219, 238, 240, 242, 243, 255, 203, 204, 211,
+		212, 214, 221, 222, 223, 241, 244, 245, 246, 247, 248, 250, 251, 252, 253, 254,
+		  2,   3,   4,   5,   6,   7,   8,  11,  12,  14,  15,  16,  17,  18,  19,  20,
+		 21,  23,  24,  25,  26,  27,  28,  29,  30,  31, 127, 220, 249,  10,  13,  22,
+		256
+	};
+
+	const int MAX_CODE_LENGTH = 30;
+
+	const Poco::UInt32 FIRST_CODE[MAX_CODE_LENGTH + 1] =
+	{
+		0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x14, 0x5c, 0xf8, 0x0, 0x3f8, 0x7fa, 0xffa, 0x1ff8, 0x3ffc, 0x7ffc, 0x0, 0x0, 0x0, 0x7fff0, 0xfffe6, 0x1fffdc, 0x3fffd2, 0x7fffd8, 0xffffea, 0x1ffffec, 0x3ffffe0, 0x7ffffde, 0xfffffe2, 0x0, 0x3ffffffc
+	};
+
+	const Poco::UInt16 CODE_COUNT[MAX_CODE_LENGTH + 1] =
+	{
+		0, 0, 0, 0, 0, 10, 26, 32, 6, 0, 5, 3, 2, 6, 2, 3, 0, 0, 0, 3, 8, 13, 26, 29, 12, 4, 15, 19, 29, 0, 4
+	};
+
+	const Poco::UInt16 SYMBOL_OFFSET[MAX_CODE_LENGTH + 1] =
+	{
+		0, 0, 0, 0, 0, 0, 10, 36, 68, 0, 74, 79, 82, 84, 90, 92, 0, 0, 0, 95, 98, 106, 119, 145, 174, 186, 190, 205, 224, 0, 253
+	};
+}
+
+
+std::size_t HPACKHuffman::encodedLength(const std::string& str)
+{
+	std::size_t bits = 0;
+	for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+	{
+		bits += CODES[static_cast<unsigned char>(*it)].length;
+	}
+	return (bits + 7)/8;
+}
+
+
+void HPACKHuffman::encode(const std::string& str, std::string& encoded)
+{
+	Poco::UInt64 acc = 0;
+	int bits = 0;
+	for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+	{
+		const Code& code = CODES[static_cast<unsigned char>(*it)];
+		acc = (acc << code.length) | code.bits;
+		bits += code.length;
+		while (bits >= 8)
+		{
+			bits -= 8;
+			encoded += static_cast<char>((acc >> bits) & 0xff);
+		}
+	}
+	if (bits > 0)
+	{
+		// pad with the most significant bits of EOS (all ones)
+		acc = (acc << (8 - bits)) | ((1 << (8 - bits)) - 1);
+		encoded += static_cast<char>(acc & 0xff);
+	}
+}
+
+
+void HPACKHuffman::decode(const char* data, std::size_t length, std::string& decoded)
+{
+	Poco::UInt32 code = 0;
+	int codeLength = 0;
+	for (std::size_t i = 0; i < length; i++)
+	{
+		unsigned char byte = static_cast<unsigned char>(data[i]);
+		for (int bit = 7; bit >= 0; bit--)
+		{
+			code = (code << 1) | ((byte >> bit) & 1);
+			++codeLength;
+			if (code >= FIRST_CODE[codeLength] && code - FIRST_CODE[codeLength] < CODE_COUNT[codeLength])
+			{
+				Poco::UInt16 symbol = SYMBOLS[SYMBOL_OFFSET[codeLength] + code - FIRST_CODE[codeLength]];
+				if (symbol == 256) throw HTTP2Exception("EOS in Huffman-encoded string", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+				decoded += static_cast<char>(symbol);
+				code = 0;
+				codeLength = 0;
+			}
+			else if (codeLength == MAX_CODE_LENGTH)
+			{
+				throw HTTP2Exception("Invalid Huffman code", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+			}
+		}
+	}
+	// padding must be shorter than 8 bits, and consist of ones
+	if (codeLength > 7 || code != (Poco::UInt32(1) << codeLength) - 1)
+		throw HTTP2Exception("Invalid Huffman padding", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,188 @@
+//
+// HPACKTable.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HPACKTable
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HPACKTable.h"
+#include "Poco/Net/HTTP2Frame.h"
+#include "Poco/Net/NetException.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	const HPACKTable::Header STATIC_TABLE[HPACKTable::STATIC_TABLE_SIZE] =
+	{
+		HPACKTable::Header(":authority", ""),
+		HPACKTable::Header(":method", "GET"),
+		HPACKTable::Header(":method", "POST"),
+		HPACKTable::Header(":path", "/"),
+		HPACKTable::Header(":path", "/index.html"),
+		HPACKTable::Header(":scheme", "http"),
+		HPACKTable::Header(":scheme", "https"),
+		HPACKTable::Header(":status", "200"),
+		HPACKTable::Header(":status", "204"),
+		HPACKTable::Header(":status", "206"),
+		HPACKTable::Header(":status", "304"),
+		HPACKTable::Header(":status", "400"),
+		HPACKTable::Header(":status", "404"),
+		HPACKTable::Header(":status", "500"),
+		HPACKTable::Header("accept-charset", ""),
+		HPACKTable::Header("accept-encoding", "gzip, deflate"),
+		HPACKTable::Header("accept-language", ""),
+		HPACKTable::Header("accept-ranges", ""),
+		HPACKTable::Header("accept", ""),
+		HPACKTable::Header("access-control-allow-origin", ""),
+		HPACKTable::Header("age", ""),
+		HPACKTable::Header("allow", ""),
+		HPACKTable::Header("authorization", ""),
+		HPACKTable::Header("cache-control", ""),
+		HPACKTable::Header("content-disposition", ""),
+		HPACKTable::Header("content-encoding", ""),
+		HPACKTable::Header("content-language", ""),
+		HPACKTable::Header("content-length", ""),
+		HPACKTable::Header("content-location", ""),
+		HPACKTable::Header("content-range", ""),
+		HPACKTable::Header("content-type", ""),
+		HPACKTable::Header("cookie", ""),
+		HPACKTable::Header("date", ""),
+		HPACKTable::Header("etag", ""),
+		HPACKTable::Header("expect", ""),
+		HPACKTable::Header("expires", ""),
+		HPACKTable::Header("from", ""),
+		HPACKTable::Header("host", ""),
+		HPACKTable::Header("if-match", ""),
+		HPACKTable::Header("if-modified-since", ""),
+		HPACKTable::Header("if-none-match", ""),
+		HPACKTable::Header("if-range", ""),
+		HPACKTable::Header("if-unmodified-since", ""),
+		HPACKTable::Header("last-modified", ""),
+		HPACKTable::Header("link", ""),
+		HPACKTable::Header("location", ""),
+		HPACKTable::Header("max-forwards", ""),
+		HPACKTable::Header("proxy-authenticate", ""),
+		HPACKTable::Header("proxy-authorization", ""),
+		HPACKTable::Header("range", ""),
+		HPACKTable::Header("referer", ""),
+		HPACKTable::Header("refresh", ""),
+		HPACKTable::Header("retry-after", ""),
+		HPACKTable::Header("server", ""),
+		HPACKTable::Header("set-cookie", ""),
+		HPACKTable::Header("strict-transport-security", ""),
+		HPACKTable::Header("transfer-encoding", ""),
+		HPACKTable::Header("user-agent", ""),
+		HPACKTable::Header("vary", ""),
+		HPACKTable::Header("via", ""),
+		HPACKTable::Header("www-authenticate", "")
+	};
+}
+
+
+HPACKTable::HPACKTable(std::size_t maxSize):
+	_size(0),
+	_maxSize(maxSize)
+{
+}
+
+
+HPACKTable::~HPACKTable()
+{
+}
+
+
+const HPACKTable::Header& HPACKTable::get(std::size_t index) const
+{
+	if (index >= 1 && index <= STATIC_TABLE_SIZE)
+		return STATIC_TABLE[index - 1];
+	else if (index > STATIC_TABLE_SIZE && index - STATIC_TABLE_SIZE <= _entries.size())
+		return _entries[index - STATIC_TABLE_SIZE - 1];
+	else
+		throw HTTP2Exception("Invalid header table index", HTTP2Frame::HTTP2_COMPRESSION_ERROR);
+}
+
+
+std::size_t HPACKTable::find(const std::string& name, const std::string& value, bool& exact) const
+{
+	std::size_t nameIndex = 0;
+	exact = false;
+	for (std::size_t i = 0; i < STATIC_TABLE_SIZE; i++)
+	{
+		if (STATIC_TABLE[i].first == name)
+		{
+			if (STATIC_TABLE[i].second == value)
+			{
+				exact = true;
+				return i + 1;
+			}
+			if (nameIndex == 0) nameIndex = i + 1;
+		}
+		else if (nameIndex != 0)
+		{
+			// entries with the same name are adjacent
+			break;
+		}
+	}
+	for (std::size_t i = 0; i < _entries.size(); i++)
+	{
+		if (_entries[i].first == name)
+		{
+			if (_entries[i].second == value)
+			{
+				exact = true;
+				return i + STATIC_TABLE_SIZE + 1;
+			}
+			if (nameIndex == 0) nameIndex = i + STATIC_TABLE_SIZE + 1;
+		}
+	}
+	return nameIndex;
+}
+
+
+void HPACKTable::add(const std::string& name, const std::string& value)
+{
+	// name may refer to an entry that is about to be evicted
+	Header header(name, value);
+	std::size_t size = entrySize(name, value);
+	if (size > _maxSize)
+	{
+		evict(0);
+	}
+	else
+	{
+		evict(_maxSize - size);
+		_entries.push_front(header);
+		_size += size;
+	}
+}
+
+
+void HPACKTable::setMaxSize(std::size_t maxSize)
+{
+	_maxSize = maxSize;
+	evict(maxSize);
+}
+
+
+void HPACKTable::evict(std::size_t maxSize)
+{
+	while (_size > maxSize && !_entries.empty())
+	{
+		_size -= entrySize(_entries.back().first, _entries.back().second);
+		_entries.pop_back();
+	}
+}
+
+
+} } // namespace Poco::Net
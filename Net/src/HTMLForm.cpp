@@ -371,14 +371,14 @@ void HTMLForm::readMultipart(std::istream& istr, PartHandler& handler)
 		{
 			handler.handlePart(header, reader.stream());
 			// Ensure that the complete part has been read.
-			while (reader.stream().good()) reader.stream().get();
+			while (reader.stream().good()) reader.stream().ignore(MultipartSourceBuf::BUFFER_SIZE);
 		}
 		else
 		{
 			std::string name = params["name"];
 			std::string value;
 			std::istream& input = reader.stream();
-			int ch = istr.get();
+			int ch = input.get();
 			while (ch != eof)
 			{
 				if (value.size() < _valueLengthLimit)
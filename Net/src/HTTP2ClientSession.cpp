@@ -0,0 +1,223 @@
+//
+// HTTP2ClientSession.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2ClientSession
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTP2ClientSession.h"
+#include "Poco/Net/HTTP2ServerRequest.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/String.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+HTTP2ClientSession::HTTP2ClientSession(const StreamSocket& socket):
+	HTTP2Connection(socket, false),
+	_started(false),
+	_nextStreamId(1)
+{
+}
+
+
+HTTP2ClientSession::HTTP2ClientSession(const std::string& host, Poco::UInt16 port):
+	HTTP2Connection(StreamSocket(SocketAddress(host, port)), false),
+	_host(host),
+	_started(false),
+	_nextStreamId(1)
+{
+	if (port != HTTPSession::HTTP_PORT)
+	{
+		_host.append(":");
+		_host.append(Poco::NumberFormatter::format(port));
+	}
+}
+
+
+HTTP2ClientSession::~HTTP2ClientSession()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+Poco::UInt32 HTTP2ClientSession::sendRequest(HTTPRequest& request, const std::string& body)
+{
+	start();
+	if (goAwayReceived()) throw HTTP2Exception("Server is closing the connection", HTTP2Frame::HTTP2_REFUSED_STREAM);
+	while (activeStreams() >= peerMaxConcurrentStreams())
+	{
+		flush();
+		if (!receiveFrame(getTimeout()))
+		{
+			if (closed()) throw ConnectionResetException("HTTP/2 connection closed by peer");
+			else throw Poco::TimeoutException("Timeout waiting for HTTP/2 stream to close");
+		}
+	}
+
+	Poco::UInt32 streamId = _nextStreamId;
+	_nextStreamId += 2;
+	addStream(streamId);
+
+	std::string authority = request.get(HTTPRequest::HOST, _host);
+	HPACKTable::HeaderList headers;
+	headers.push_back(HPACKTable::Header(":method", request.getMethod()));
+	headers.push_back(HPACKTable::Header(":scheme", socket().secure() ? "https" : "http"));
+	headers.push_back(HPACKTable::Header(":authority", authority));
+	headers.push_back(HPACKTable::Header(":path", request.getURI()));
+	bool hasContentLength = false;
+	for (HTTPRequest::ConstIterator it = request.begin(); it != request.end(); ++it)
+	{
+		std::string name = Poco::toLower(it->first);
+		if (HTTP2ServerRequest::isConnectionHeader(name) || name == "host") continue;
+		if (name == "content-length") hasContentLength = true;
+		headers.push_back(HPACKTable::Header(name, it->second));
+	}
+	if (!body.empty() && !hasContentLength)
+		headers.push_back(HPACKTable::Header("content-length", Poco::NumberFormatter::format(body.size())));
+
+	sendHeaders(streamId, headers, body.empty());
+	// The body is sent while frames are received, so that
+	// the server can respond before it has received all of it.
+	if (!body.empty()) queueData(streamId, body.data(), body.size(), true);
+	flush();
+	return streamId;
+}
+
+
+void HTTP2ClientSession::receiveResponse(Poco::UInt32 streamId, HTTPResponse& response, std::string& body)
+{
+	Stream* pStream = findStream(streamId);
+	if (!pStream) throw Poco::InvalidArgumentException("Unknown HTTP/2 stream");
+	while (!pStream->headersReceived && !pStream->reset)
+	{
+		flush();
+		if (!receiveFrame(getTimeout()))
+		{
+			if (closed()) throw ConnectionResetException("HTTP/2 connection closed by peer");
+			else throw Poco::TimeoutException("Timeout waiting for HTTP/2 response");
+		}
+		pStream = findStream(streamId);
+	}
+	if (pStream->reset)
+	{
+		int code = pStream->resetCode;
+		removeStream(streamId);
+		throw HTTP2Exception("Stream has been reset", code);
+	}
+
+	response.clear();
+	response.setVersion(HTTPMessage::HTTP_2_0);
+	for (HPACKTable::HeaderList::const_iterator it = pStream->headers.begin(); it != pStream->headers.end(); ++it)
+	{
+		if (it->first == ":status")
+			response.setStatusAndReason(static_cast<HTTPResponse::HTTPStatus>(Poco::NumberParser::parse(it->second)));
+		else if (it->first[0] != ':')
+			response.add(it->first, it->second);
+	}
+
+	body.clear();
+	try
+	{
+		char buffer[HTTP2Frame::DEFAULT_MAX_FRAME_SIZE];
+		int n;
+		while ((n = readData(streamId, buffer, sizeof(buffer))) > 0)
+		{
+			body.append(buffer, n);
+		}
+	}
+	catch (...)
+	{
+		removeStream(streamId);
+		throw;
+	}
+	removeStream(streamId);
+}
+
+
+void HTTP2ClientSession::close()
+{
+	if (socket().impl()->initialized())
+	{
+		if (_started && !failed() && !closed())
+		{
+			try
+			{
+				sendGoAway(HTTP2Frame::HTTP2_NO_ERROR);
+			}
+			catch (...)
+			{
+			}
+		}
+		socket().close();
+	}
+}
+
+
+void HTTP2ClientSession::onHeaders(Stream* pStream, Poco::UInt32 streamId, HPACKTable::HeaderList& headers, bool endStream)
+{
+	if (!pStream) throw HTTP2Exception("HEADERS frame for stream not opened by client", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+
+	if (!pStream->headersReceived)
+	{
+		const std::string* pStatus = 0;
+		for (HPACKTable::HeaderList::const_iterator it = headers.begin(); it != headers.end(); ++it)
+		{
+			if (it->first == ":status") pStatus = &it->second;
+		}
+		if (!pStatus || pStatus->empty())
+		{
+			resetStream(streamId, HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+		}
+		else if ((*pStatus)[0] != '1')
+		{
+			pStream->headers.swap(headers);
+			pStream->headersReceived = true;
+			pStream->endReceived = endStream;
+		}
+		// interim responses are skipped
+	}
+	else if (endStream && !pStream->endReceived)
+	{
+		// trailer fields are not passed to the application
+		pStream->endReceived = true;
+	}
+	else resetStream(streamId, HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+}
+
+
+void HTTP2ClientSession::start()
+{
+	if (!_started)
+	{
+		_started = true;
+		sendPreface();
+		sendSettings(0);
+		flush();
+	}
+}
+
+
+} } // namespace Poco::Net
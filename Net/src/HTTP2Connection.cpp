@@ -0,0 +1,875 @@
+//
+// HTTP2Connection.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2Connection
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTP2Connection.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/StringTokenizer.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	const std::size_t MAX_HEADER_BLOCK_SIZE = 262144;
+	const std::size_t MAX_HEADER_LIST_SIZE = 65536;
+
+	void appendSetting(std::string& payload, int id, Poco::UInt32 value)
+	{
+		payload += static_cast<char>((id >> 8) & 0xff);
+		payload += static_cast<char>(id & 0xff);
+		HTTP2Frame::appendUInt32(payload, value);
+	}
+
+	int urgencyFromWeight(int weight)
+		/// Maps a RFC 7540 stream weight (1 - 256) to an urgency,
+		/// so that the default weight 16 maps to the default urgency.
+	{
+		int log = 0;
+		while (weight > 1)
+		{
+			weight >>= 1;
+			++log;
+		}
+		return std::max(0, HTTP2Connection::MAX_URGENCY - log);
+	}
+}
+
+
+//
+// HTTP2Connection::Stream
+//
+
+
+HTTP2Connection::Stream::Stream():
+	id(0),
+	inputPos(0),
+	outputPos(0),
+	sendWindow(0),
+	recvWindow(0),
+	consumed(0),
+	urgency(DEFAULT_URGENCY),
+	resetCode(HTTP2Frame::HTTP2_NO_ERROR),
+	headersReceived(false),
+	endReceived(false),
+	endQueued(false),
+	endSent(false),
+	reset(false),
+	dispatched(false),
+	done(false)
+{
+}
+
+
+//
+// HTTP2Connection
+//
+
+
+HTTP2Connection::HTTP2Connection(const StreamSocket& socket, bool server):
+	_socket(socket),
+	_server(server),
+	_timeout(60, 0),
+	_inPos(0),
+	_sendWindow(HTTP2Frame::DEFAULT_WINDOW_SIZE),
+	_recvWindow(HTTP2Frame::DEFAULT_WINDOW_SIZE),
+	_peerInitialWindow(HTTP2Frame::DEFAULT_WINDOW_SIZE),
+	_peerMaxFrameSize(HTTP2Frame::DEFAULT_MAX_FRAME_SIZE),
+	_peerMaxConcurrentStreams(UINT_MAX),
+	_localMaxConcurrentStreams(UINT_MAX),
+	_lastStreamId(0),
+	_headerStreamId(0),
+	_headerFlags(0),
+	_headerUrgency(-1),
+	_closed(false),
+	_failed(false),
+	_goAwayReceived(false),
+	_goAwaySent(false)
+{
+	_decoder.setMaxHeaderListSize(MAX_HEADER_LIST_SIZE);
+}
+
+
+HTTP2Connection::~HTTP2Connection()
+{
+}
+
+
+bool HTTP2Connection::receiveFrame(const Poco::Timespan& timeout)
+{
+	try
+	{
+		for (;;)
+		{
+			std::size_t available = _inBuffer.size() - _inPos;
+			if (available >= HTTP2Frame::HEADER_SIZE)
+			{
+				HTTP2Frame frame;
+				std::size_t length = frame.parseHeader(_inBuffer.data() + _inPos);
+				if (length > HTTP2Frame::DEFAULT_MAX_FRAME_SIZE)
+					throw HTTP2Exception("Frame exceeds maximum frame size", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+				if (available >= HTTP2Frame::HEADER_SIZE + length)
+				{
+					const char* payload = _inBuffer.data() + _inPos + HTTP2Frame::HEADER_SIZE;
+					_inPos += HTTP2Frame::HEADER_SIZE + length;
+					processFrame(frame, payload, length);
+					return true;
+				}
+			}
+			if (_closed || !receive(timeout)) return false;
+		}
+	}
+	catch (HTTP2Exception& exc)
+	{
+		if (!_failed)
+		{
+			_failed = true;
+			try
+			{
+				sendGoAway(exc.code());
+			}
+			catch (...)
+			{
+			}
+		}
+		throw;
+	}
+	catch (...)
+	{
+		_failed = true;
+		throw;
+	}
+}
+
+
+int HTTP2Connection::readData(Poco::UInt32 streamId, char* buffer, std::size_t length)
+{
+	for (;;)
+	{
+		Stream& stream = checkStream(streamId);
+		std::size_t available = stream.input.size() - stream.inputPos;
+		if (available > 0)
+		{
+			std::size_t n = std::min(available, length);
+			std::memcpy(buffer, stream.input.data() + stream.inputPos, n);
+			stream.inputPos += n;
+			if (stream.inputPos == stream.input.size())
+			{
+				stream.input.clear();
+				stream.inputPos = 0;
+			}
+			consumed(stream, n);
+			return static_cast<int>(n);
+		}
+		if (stream.reset) throw HTTP2Exception("Stream has been reset", stream.resetCode);
+		if (stream.endReceived) return 0;
+
+		flush();
+		if (!receiveFrame(_timeout))
+		{
+			if (_closed) throw ConnectionResetException("HTTP/2 connection closed by peer");
+			else throw Poco::TimeoutException("Timeout waiting for HTTP/2 stream data");
+		}
+	}
+}
+
+
+void HTTP2Connection::queueData(Poco::UInt32 streamId, const char* buffer, std::size_t length, bool endStream)
+{
+	Stream& stream = checkStream(streamId);
+	if (stream.reset) throw HTTP2Exception("Stream has been reset", stream.resetCode);
+	if (stream.endQueued) throw Poco::IllegalStateException("HTTP/2 stream has already been ended");
+
+	stream.output.append(buffer, length);
+	if (endStream) stream.endQueued = true;
+}
+
+
+void HTTP2Connection::writeData(Poco::UInt32 streamId, const char* buffer, std::size_t length, bool endStream)
+{
+	queueData(streamId, buffer, length, endStream);
+	flush();
+	for (;;)
+	{
+		Stream& current = checkStream(streamId);
+		if (current.reset) throw HTTP2Exception("Stream has been reset", current.resetCode);
+		if (current.output.size() - current.outputPos <= MAX_PENDING_OUTPUT) break;
+		if (!receiveFrame(_timeout))
+		{
+			if (_closed) throw ConnectionResetException("HTTP/2 connection closed by peer");
+			else throw Poco::TimeoutException("Timeout waiting for HTTP/2 flow control credit");
+		}
+		flush();
+	}
+}
+
+
+void HTTP2Connection::sendHeaders(Poco::UInt32 streamId, const HPACKTable::HeaderList& headers, bool endStream)
+{
+	std::string block;
+	_encoder.encode(headers, block);
+
+	std::size_t pos = 0;
+	do
+	{
+		std::size_t n = std::min<std::size_t>(block.size() - pos, _peerMaxFrameSize);
+		int flags = 0;
+		if (pos == 0 && endStream) flags |= HTTP2Frame::FLAG_END_STREAM;
+		if (pos + n == block.size()) flags |= HTTP2Frame::FLAG_END_HEADERS;
+		queueFrame(pos == 0 ? HTTP2Frame::FRAME_HEADERS : HTTP2Frame::FRAME_CONTINUATION, flags, streamId, block.data() + pos, n);
+		pos += n;
+	}
+	while (pos < block.size());
+
+	if (endStream)
+	{
+		Stream* pStream = findStream(streamId);
+		if (pStream)
+		{
+			pStream->endQueued = true;
+			pStream->endSent = true;
+		}
+	}
+}
+
+
+void HTTP2Connection::resetStream(Poco::UInt32 streamId, int errorCode)
+{
+	std::string payload;
+	HTTP2Frame::appendUInt32(payload, static_cast<Poco::UInt32>(errorCode));
+	queueFrame(HTTP2Frame::FRAME_RST_STREAM, 0, streamId, payload.data(), payload.size());
+
+	Stream* pStream = findStream(streamId);
+	if (pStream && !pStream->reset)
+	{
+		pStream->reset = true;
+		pStream->resetCode = errorCode;
+		pStream->output.clear();
+		pStream->outputPos = 0;
+	}
+}
+
+
+void HTTP2Connection::sendGoAway(int errorCode)
+{
+	if (!_goAwaySent)
+	{
+		_goAwaySent = true;
+		std::string payload;
+		HTTP2Frame::appendUInt32(payload, _server ? _lastStreamId : 0);
+		HTTP2Frame::appendUInt32(payload, static_cast<Poco::UInt32>(errorCode));
+		queueFrame(HTTP2Frame::FRAME_GOAWAY, 0, 0, payload.data(), payload.size());
+		sendBuffered();
+	}
+}
+
+
+void HTTP2Connection::flush()
+{
+	try
+	{
+		schedule();
+		sendBuffered();
+	}
+	catch (...)
+	{
+		_failed = true;
+		throw;
+	}
+}
+
+
+HTTP2Connection::Stream* HTTP2Connection::findStream(Poco::UInt32 streamId)
+{
+	StreamMap::iterator it = _streams.find(streamId);
+	if (it != _streams.end())
+		return &it->second;
+	else
+		return 0;
+}
+
+
+void HTTP2Connection::parsePriority(const std::string& priority, int& urgency)
+{
+	Poco::StringTokenizer tok(priority, ",", Poco::StringTokenizer::TOK_TRIM | Poco::StringTokenizer::TOK_IGNORE_EMPTY);
+	for (Poco::StringTokenizer::Iterator it = tok.begin(); it != tok.end(); ++it)
+	{
+		const std::string& param = *it;
+		if (param.size() == 3 && param[0] == 'u' && param[1] == '=' && param[2] >= '0' && param[2] <= '0' + MAX_URGENCY)
+		{
+			urgency = param[2] - '0';
+		}
+	}
+}
+
+
+void HTTP2Connection::sendPreface()
+{
+	_outBuffer.append(HTTP2Frame::PREFACE);
+}
+
+
+void HTTP2Connection::sendSettings(Poco::UInt32 maxConcurrentStreams)
+{
+	std::string payload;
+	if (!_server) appendSetting(payload, HTTP2Frame::SETTINGS_ENABLE_PUSH, 0);
+	if (maxConcurrentStreams > 0) appendSetting(payload, HTTP2Frame::SETTINGS_MAX_CONCURRENT_STREAMS, maxConcurrentStreams);
+	appendSetting(payload, HTTP2Frame::SETTINGS_MAX_HEADER_LIST_SIZE, static_cast<Poco::UInt32>(MAX_HEADER_LIST_SIZE));
+	queueFrame(HTTP2Frame::FRAME_SETTINGS, 0, 0, payload.data(), payload.size());
+	if (maxConcurrentStreams > 0) _localMaxConcurrentStreams = maxConcurrentStreams;
+
+	payload.clear();
+	HTTP2Frame::appendUInt32(payload, CONNECTION_WINDOW_SIZE - HTTP2Frame::DEFAULT_WINDOW_SIZE);
+	queueFrame(HTTP2Frame::FRAME_WINDOW_UPDATE, 0, 0, payload.data(), payload.size());
+	_recvWindow = CONNECTION_WINDOW_SIZE;
+}
+
+
+void HTTP2Connection::applySettings(const char* payload, std::size_t length)
+{
+	if (length % 6 != 0) throw HTTP2Exception("Invalid SETTINGS frame length", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+
+	for (std::size_t pos = 0; pos < length; pos += 6)
+	{
+		int id = (static_cast<unsigned char>(payload[pos]) << 8) | static_cast<unsigned char>(payload[pos + 1]);
+		Poco::UInt32 value = HTTP2Frame::parseUInt32(payload + pos + 2);
+		switch (id)
+		{
+		case HTTP2Frame::SETTINGS_HEADER_TABLE_SIZE:
+			_encoder.setMaxTableSize(std::min<Poco::UInt32>(value, HTTP2Frame::DEFAULT_TABLE_SIZE));
+			break;
+		case HTTP2Frame::SETTINGS_ENABLE_PUSH:
+			if (value > 1) throw HTTP2Exception("Invalid SETTINGS_ENABLE_PUSH value", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+			break;
+		case HTTP2Frame::SETTINGS_MAX_CONCURRENT_STREAMS:
+			_peerMaxConcurrentStreams = value;
+			break;
+		case HTTP2Frame::SETTINGS_INITIAL_WINDOW_SIZE:
+			{
+				if (value > HTTP2Frame::MAX_WINDOW_SIZE) throw HTTP2Exception("Invalid SETTINGS_INITIAL_WINDOW_SIZE value", HTTP2Frame::HTTP2_FLOW_CONTROL_ERROR);
+				Poco::Int64 delta = static_cast<Poco::Int64>(value) - _peerInitialWindow;
+				for (StreamMap::iterator it = _streams.begin(); it != _streams.end(); ++it)
+				{
+					it->second.sendWindow += delta;
+					if (it->second.sendWindow > HTTP2Frame::MAX_WINDOW_SIZE)
+						throw HTTP2Exception("Stream flow control window overflow", HTTP2Frame::HTTP2_FLOW_CONTROL_ERROR);
+				}
+				_peerInitialWindow = value;
+			}
+			break;
+		case HTTP2Frame::SETTINGS_MAX_FRAME_SIZE:
+			if (value < HTTP2Frame::DEFAULT_MAX_FRAME_SIZE || value > HTTP2Frame::MAX_FRAME_SIZE)
+				throw HTTP2Exception("Invalid SETTINGS_MAX_FRAME_SIZE value", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+			_peerMaxFrameSize = value;
+			break;
+		default:
+			// SETTINGS_MAX_HEADER_LIST_SIZE is advisory,
+			// unknown settings must be ignored.
+			break;
+		}
+	}
+}
+
+
+void HTTP2Connection::setReceived(const char* data, std::size_t length)
+{
+	_inBuffer.assign(data, length);
+	_inPos = 0;
+}
+
+
+void HTTP2Connection::receivePreface()
+{
+	const std::size_t length = HTTP2Frame::PREFACE.size();
+	try
+	{
+		while (_inBuffer.size() - _inPos < length)
+		{
+			if (!receive(_timeout))
+			{
+				if (_closed) throw ConnectionResetException("HTTP/2 connection closed by peer");
+				else throw Poco::TimeoutException("Timeout waiting for HTTP/2 connection preface");
+			}
+		}
+		if (_inBuffer.compare(_inPos, length, HTTP2Frame::PREFACE) != 0)
+			throw HTTP2Exception("Invalid HTTP/2 connection preface", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+		_inPos += length;
+	}
+	catch (HTTP2Exception& exc)
+	{
+		_failed = true;
+		try
+		{
+			sendGoAway(exc.code());
+		}
+		catch (...)
+		{
+		}
+		throw;
+	}
+	catch (...)
+	{
+		_failed = true;
+		throw;
+	}
+}
+
+
+HTTP2Connection::Stream& HTTP2Connection::addStream(Poco::UInt32 streamId)
+{
+	Stream& stream = _streams[streamId];
+	stream.id = streamId;
+	stream.sendWindow = _peerInitialWindow;
+	stream.recvWindow = HTTP2Frame::DEFAULT_WINDOW_SIZE;
+	if (streamId > _lastStreamId) _lastStreamId = streamId;
+	return stream;
+}
+
+
+void HTTP2Connection::removeStream(Poco::UInt32 streamId)
+{
+	_streams.erase(streamId);
+}
+
+
+void HTTP2Connection::removeDoneStreams()
+{
+	StreamMap::iterator it = _streams.begin();
+	while (it != _streams.end())
+	{
+		Stream& stream = it->second;
+		if (stream.done && (stream.endSent || stream.reset))
+		{
+			// The peer is not interested in the rest of
+			// a request body the application has not read.
+			if (!stream.endReceived && !stream.reset)
+				resetStream(stream.id, HTTP2Frame::HTTP2_NO_ERROR);
+			_streams.erase(it++);
+		}
+		else ++it;
+	}
+}
+
+
+std::size_t HTTP2Connection::activeStreams() const
+{
+	std::size_t count = 0;
+	for (StreamMap::const_iterator it = _streams.begin(); it != _streams.end(); ++it)
+	{
+		const Stream& stream = it->second;
+		if (!stream.reset && !(stream.endSent && stream.endReceived)) ++count;
+	}
+	return count;
+}
+
+
+bool HTTP2Connection::receive(const Poco::Timespan& timeout)
+{
+	if (_inPos > 0)
+	{
+		_inBuffer.erase(0, _inPos);
+		_inPos = 0;
+	}
+	if (_socket.available() == 0 && !_socket.poll(timeout, Socket::SELECT_READ)) return false;
+
+	const std::size_t size = _inBuffer.size();
+	_inBuffer.resize(size + HTTP2Frame::DEFAULT_MAX_FRAME_SIZE);
+	int n = _socket.receiveBytes(&_inBuffer[size], HTTP2Frame::DEFAULT_MAX_FRAME_SIZE);
+	_inBuffer.resize(size + (n > 0 ? n : 0));
+	if (n <= 0)
+	{
+		_closed = true;
+		return false;
+	}
+	return true;
+}
+
+
+void HTTP2Connection::processFrame(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	if (_headerStreamId != 0 && frame.type() != HTTP2Frame::FRAME_CONTINUATION)
+		throw HTTP2Exception("CONTINUATION frame expected", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+
+	switch (frame.type())
+	{
+	case HTTP2Frame::FRAME_DATA:
+		processData(frame, payload, length);
+		break;
+	case HTTP2Frame::FRAME_HEADERS:
+		processHeaders(frame, payload, length);
+		break;
+	case HTTP2Frame::FRAME_PRIORITY:
+		processPriority(frame, payload, length);
+		break;
+	case HTTP2Frame::FRAME_RST_STREAM:
+		processRstStream(frame, payload, length);
+		break;
+	case HTTP2Frame::FRAME_SETTINGS:
+		processSettings(frame, payload, length);
+		break;
+	case HTTP2Frame::FRAME_PUSH_PROMISE:
+		// server push is never enabled
+		throw HTTP2Exception("Unexpected PUSH_PROMISE frame", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+	case HTTP2Frame::FRAME_PING:
+		processPing(frame, payload, length);
+		break;
+	case HTTP2Frame::FRAME_GOAWAY:
+		processGoAway(frame, payload, length);
+		break;
+	case HTTP2Frame::FRAME_WINDOW_UPDATE:
+		processWindowUpdate(frame, payload, length);
+		break;
+	case HTTP2Frame::FRAME_CONTINUATION:
+		processContinuation(frame, payload, length);
+		break;
+	case HTTP2Frame::FRAME_PRIORITY_UPDATE:
+		processPriorityUpdate(frame, payload, length);
+		break;
+	default:
+		// unknown frame types must be ignored
+		break;
+	}
+}
+
+
+void HTTP2Connection::processData(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	Poco::UInt32 streamId = frame.streamId();
+	if (streamId == 0) throw HTTP2Exception("DATA frame on stream 0", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+	if (streamId > _lastStreamId) throw HTTP2Exception("DATA frame on idle stream", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+
+	// The connection window is replenished as soon as data has been
+	// received, so only the stream windows limit the data buffered.
+	Poco::Int64 size = static_cast<Poco::Int64>(length);
+	if (size > _recvWindow) throw HTTP2Exception("Connection flow control window exceeded", HTTP2Frame::HTTP2_FLOW_CONTROL_ERROR);
+	_recvWindow -= size;
+	if (_recvWindow < CONNECTION_WINDOW_SIZE/2)
+	{
+		std::string update;
+		HTTP2Frame::appendUInt32(update, static_cast<Poco::UInt32>(CONNECTION_WINDOW_SIZE - _recvWindow));
+		queueFrame(HTTP2Frame::FRAME_WINDOW_UPDATE, 0, 0, update.data(), update.size());
+		_recvWindow = CONNECTION_WINDOW_SIZE;
+	}
+
+	const char* data = payload;
+	std::size_t dataLength = stripPadding(frame, data, length);
+
+	Stream* pStream = findStream(streamId);
+	if (!pStream || pStream->reset) return; // closed stream, frames may still be in flight
+	if (pStream->endReceived || !pStream->headersReceived)
+	{
+		resetStream(streamId, HTTP2Frame::HTTP2_STREAM_CLOSED);
+		return;
+	}
+	if (size > pStream->recvWindow)
+	{
+		resetStream(streamId, HTTP2Frame::HTTP2_FLOW_CONTROL_ERROR);
+		return;
+	}
+	pStream->recvWindow -= size;
+	pStream->input.append(data, dataLength);
+	if (frame.hasFlag(HTTP2Frame::FLAG_END_STREAM)) pStream->endReceived = true;
+	consumed(*pStream, length - dataLength);
+}
+
+
+void HTTP2Connection::processHeaders(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	Poco::UInt32 streamId = frame.streamId();
+	if (streamId == 0) throw HTTP2Exception("HEADERS frame on stream 0", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+
+	const char* block = payload;
+	std::size_t blockLength = stripPadding(frame, block, length);
+	_headerUrgency = -1;
+	if (frame.hasFlag(HTTP2Frame::FLAG_PRIORITY))
+	{
+		if (blockLength < 5) throw HTTP2Exception("Invalid HEADERS frame length", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+		_headerUrgency = urgencyFromWeight(static_cast<unsigned char>(block[4]) + 1);
+		block += 5;
+		blockLength -= 5;
+	}
+	_headerStreamId = streamId;
+	_headerFlags = frame.flags();
+	_headerBlock.assign(block, blockLength);
+	if (frame.hasFlag(HTTP2Frame::FLAG_END_HEADERS)) processHeaderBlock();
+}
+
+
+void HTTP2Connection::processPriority(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	if (frame.streamId() == 0) throw HTTP2Exception("PRIORITY frame on stream 0", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+	if (length != 5) throw HTTP2Exception("Invalid PRIORITY frame length", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+
+	Stream* pStream = findStream(frame.streamId());
+	if (pStream) pStream->urgency = urgencyFromWeight(static_cast<unsigned char>(payload[4]) + 1);
+}
+
+
+void HTTP2Connection::processPriorityUpdate(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	if (frame.streamId() != 0) throw HTTP2Exception("PRIORITY_UPDATE frame not on stream 0", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+	if (length < 4) throw HTTP2Exception("Invalid PRIORITY_UPDATE frame length", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+
+	if (_server)
+	{
+		Stream* pStream = findStream(HTTP2Frame::parseUInt32(payload) & 0x7fffffff);
+		if (pStream) parsePriority(std::string(payload + 4, length - 4), pStream->urgency);
+	}
+}
+
+
+void HTTP2Connection::processRstStream(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	Poco::UInt32 streamId = frame.streamId();
+	if (streamId == 0) throw HTTP2Exception("RST_STREAM frame on stream 0", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+	if (length != 4) throw HTTP2Exception("Invalid RST_STREAM frame length", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+	if (streamId > _lastStreamId) throw HTTP2Exception("RST_STREAM frame on idle stream", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+
+	Stream* pStream = findStream(streamId);
+	if (pStream && !pStream->reset)
+	{
+		pStream->reset = true;
+		pStream->resetCode = static_cast<int>(HTTP2Frame::parseUInt32(payload));
+		pStream->output.clear();
+		pStream->outputPos = 0;
+	}
+}
+
+
+void HTTP2Connection::processSettings(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	if (frame.streamId() != 0) throw HTTP2Exception("SETTINGS frame not on stream 0", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+
+	if (frame.hasFlag(HTTP2Frame::FLAG_ACK))
+	{
+		if (length != 0) throw HTTP2Exception("Invalid SETTINGS acknowledgement", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+	}
+	else
+	{
+		applySettings(payload, length);
+		queueFrame(HTTP2Frame::FRAME_SETTINGS, HTTP2Frame::FLAG_ACK, 0, 0, 0);
+	}
+}
+
+
+void HTTP2Connection::processPing(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	if (frame.streamId() != 0) throw HTTP2Exception("PING frame not on stream 0", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+	if (length != 8) throw HTTP2Exception("Invalid PING frame length", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+
+	if (!frame.hasFlag(HTTP2Frame::FLAG_ACK))
+		queueFrame(HTTP2Frame::FRAME_PING, HTTP2Frame::FLAG_ACK, 0, payload, length);
+}
+
+
+void HTTP2Connection::processGoAway(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	if (frame.streamId() != 0) throw HTTP2Exception("GOAWAY frame not on stream 0", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+	if (length < 8) throw HTTP2Exception("Invalid GOAWAY frame length", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+
+	_goAwayReceived = true;
+	if (!_server)
+	{
+		// Streams above the last stream identifier
+		// have not been processed by the server.
+		Poco::UInt32 lastStreamId = HTTP2Frame::parseUInt32(payload) & 0x7fffffff;
+		for (StreamMap::iterator it = _streams.upper_bound(lastStreamId); it != _streams.end(); ++it)
+		{
+			it->second.reset = true;
+			it->second.resetCode = HTTP2Frame::HTTP2_REFUSED_STREAM;
+		}
+	}
+}
+
+
+void HTTP2Connection::processWindowUpdate(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	if (length != 4) throw HTTP2Exception("Invalid WINDOW_UPDATE frame length", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+
+	Poco::UInt32 streamId = frame.streamId();
+	Poco::Int64 increment = HTTP2Frame::parseUInt32(payload) & 0x7fffffff;
+	if (streamId == 0)
+	{
+		if (increment == 0) throw HTTP2Exception("Invalid WINDOW_UPDATE increment", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+		_sendWindow += increment;
+		if (_sendWindow > HTTP2Frame::MAX_WINDOW_SIZE) throw HTTP2Exception("Connection flow control window overflow", HTTP2Frame::HTTP2_FLOW_CONTROL_ERROR);
+	}
+	else
+	{
+		if (streamId > _lastStreamId) throw HTTP2Exception("WINDOW_UPDATE frame on idle stream", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+		Stream* pStream = findStream(streamId);
+		if (pStream && !pStream->reset)
+		{
+			pStream->sendWindow += increment;
+			if (increment == 0)
+				resetStream(streamId, HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+			else if (pStream->sendWindow > HTTP2Frame::MAX_WINDOW_SIZE)
+				resetStream(streamId, HTTP2Frame::HTTP2_FLOW_CONTROL_ERROR);
+		}
+	}
+}
+
+
+void HTTP2Connection::processContinuation(const HTTP2Frame& frame, const char* payload, std::size_t length)
+{
+	if (_headerStreamId == 0 || frame.streamId() != _headerStreamId)
+		throw HTTP2Exception("Unexpected CONTINUATION frame", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+	if (_headerBlock.size() + length > MAX_HEADER_BLOCK_SIZE)
+		throw HTTP2Exception("Header block too large", HTTP2Frame::HTTP2_ENHANCE_YOUR_CALM);
+
+	_headerBlock.append(payload, length);
+	if (frame.hasFlag(HTTP2Frame::FLAG_END_HEADERS)) processHeaderBlock();
+}
+
+
+void HTTP2Connection::processHeaderBlock()
+{
+	Poco::UInt32 streamId = _headerStreamId;
+	bool endStream = (_headerFlags & HTTP2Frame::FLAG_END_STREAM) != 0;
+	_headerStreamId = 0;
+
+	// The block must be decoded in any case, to keep
+	// the decoder's dynamic table in sync.
+	HPACKTable::HeaderList headers;
+	_decoder.decode(_headerBlock.data(), _headerBlock.size(), headers);
+	_headerBlock.clear();
+
+	int urgency = _headerUrgency;
+	for (HPACKTable::HeaderList::const_iterator it = headers.begin(); it != headers.end(); ++it)
+	{
+		if (it->first == "priority")
+		{
+			if (urgency < 0) urgency = DEFAULT_URGENCY;
+			parsePriority(it->second, urgency);
+		}
+	}
+
+	Stream* pStream = findStream(streamId);
+	if (!pStream && streamId <= _lastStreamId) return; // closed stream, frames may still be in flight
+	if (pStream && pStream->reset) return;
+
+	onHeaders(pStream, streamId, headers, endStream);
+
+	pStream = findStream(streamId);
+	if (pStream && urgency >= 0) pStream->urgency = urgency;
+}
+
+
+void HTTP2Connection::consumed(Stream& stream, std::size_t length)
+{
+	stream.consumed += static_cast<Poco::Int64>(length);
+	if (!stream.endReceived && !stream.reset && stream.consumed >= HTTP2Frame::DEFAULT_WINDOW_SIZE/2)
+	{
+		std::string update;
+		HTTP2Frame::appendUInt32(update, static_cast<Poco::UInt32>(stream.consumed));
+		queueFrame(HTTP2Frame::FRAME_WINDOW_UPDATE, 0, stream.id, update.data(), update.size());
+		stream.recvWindow += stream.consumed;
+		stream.consumed = 0;
+	}
+}
+
+
+void HTTP2Connection::schedule()
+{
+	for (;;)
+	{
+		Stream* pNext = 0;
+		for (StreamMap::iterator it = _streams.begin(); it != _streams.end(); ++it)
+		{
+			Stream& stream = it->second;
+			if (stream.reset || stream.endSent) continue;
+			std::size_t pending = stream.output.size() - stream.outputPos;
+			bool ready = pending > 0 ? stream.sendWindow > 0 && _sendWindow > 0 : stream.endQueued;
+			if (ready && (!pNext || stream.urgency < pNext->urgency)) pNext = &stream;
+		}
+		if (!pNext) break;
+
+		std::size_t pending = pNext->output.size() - pNext->outputPos;
+		std::size_t n = pending;
+		if (n > _peerMaxFrameSize) n = _peerMaxFrameSize;
+		if (static_cast<Poco::Int64>(n) > pNext->sendWindow) n = static_cast<std::size_t>(pNext->sendWindow);
+		if (static_cast<Poco::Int64>(n) > _sendWindow) n = static_cast<std::size_t>(_sendWindow);
+		bool end = pNext->endQueued && n == pending;
+		queueFrame(HTTP2Frame::FRAME_DATA, end ? HTTP2Frame::FLAG_END_STREAM : 0, pNext->id, pNext->output.data() + pNext->outputPos, n);
+		pNext->outputPos += n;
+		pNext->sendWindow -= n;
+		_sendWindow -= n;
+		if (pNext->outputPos == pNext->output.size())
+		{
+			pNext->output.clear();
+			pNext->outputPos = 0;
+		}
+		else if (pNext->outputPos > pNext->output.size()/2)
+		{
+			pNext->output.erase(0, pNext->outputPos);
+			pNext->outputPos = 0;
+		}
+		if (end) pNext->endSent = true;
+		if (_outBuffer.size() >= MAX_PENDING_OUTPUT) sendBuffered();
+	}
+}
+
+
+void HTTP2Connection::queueFrame(int type, int flags, Poco::UInt32 streamId, const char* payload, std::size_t length)
+{
+	char header[HTTP2Frame::HEADER_SIZE];
+	HTTP2Frame::formatHeader(header, length, type, flags, streamId);
+	_outBuffer.append(header, HTTP2Frame::HEADER_SIZE);
+	if (length > 0) _outBuffer.append(payload, length);
+}
+
+
+void HTTP2Connection::sendBuffered()
+{
+	const char* p = _outBuffer.data();
+	std::size_t remaining = _outBuffer.size();
+	while (remaining > 0)
+	{
+		int n = _socket.sendBytes(p, static_cast<int>(std::min<std::size_t>(remaining, INT_MAX)));
+		if (n <= 0) throw ConnectionResetException("HTTP/2 connection closed by peer");
+		p += n;
+		remaining -= n;
+	}
+	_outBuffer.clear();
+}
+
+
+HTTP2Connection::Stream& HTTP2Connection::checkStream(Poco::UInt32 streamId)
+{
+	Stream* pStream = findStream(streamId);
+	if (!pStream) throw HTTP2Exception("Stream does not exist", HTTP2Frame::HTTP2_STREAM_CLOSED);
+	return *pStream;
+}
+
+
+std::size_t HTTP2Connection::stripPadding(const HTTP2Frame& frame, const char*& payload, std::size_t length)
+{
+	if (frame.hasFlag(HTTP2Frame::FLAG_PADDED))
+	{
+		if (length < 1) throw HTTP2Exception("Invalid padded frame length", HTTP2Frame::HTTP2_FRAME_SIZE_ERROR);
+		std::size_t padding = static_cast<unsigned char>(payload[0]);
+		if (padding >= length) throw HTTP2Exception("Padding exceeds frame payload", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+		++payload;
+		return length - 1 - padding;
+	}
+	return length;
+}
+
+
+} } // namespace Poco::Net
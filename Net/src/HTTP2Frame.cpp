@@ -0,0 +1,90 @@
+//
+// HTTP2Frame.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2Frame
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTP2Frame.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+const std::string HTTP2Frame::PREFACE("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n");
+
+
+HTTP2Frame::HTTP2Frame():
+	_type(FRAME_DATA),
+	_flags(0),
+	_streamId(0)
+{
+}
+
+
+HTTP2Frame::HTTP2Frame(Type type, int flags, Poco::UInt32 streamId):
+	_type(type),
+	_flags(flags),
+	_streamId(streamId)
+{
+}
+
+
+HTTP2Frame::~HTTP2Frame()
+{
+}
+
+
+std::size_t HTTP2Frame::parseHeader(const char* pHeader)
+{
+	const unsigned char* u = reinterpret_cast<const unsigned char*>(pHeader);
+	std::size_t length = (std::size_t(u[0]) << 16) | (std::size_t(u[1]) << 8) | std::size_t(u[2]);
+	_type = static_cast<Type>(u[3]);
+	_flags = u[4];
+	_streamId = parseUInt32(pHeader + 5) & 0x7fffffff;
+	return length;
+}
+
+
+void HTTP2Frame::formatHeader(char* pHeader) const
+{
+	formatHeader(pHeader, _payload.size(), _type, _flags, _streamId);
+}
+
+
+void HTTP2Frame::formatHeader(char* pHeader, std::size_t length, int type, int flags, Poco::UInt32 streamId)
+{
+	poco_assert_dbg (length <= MAX_FRAME_SIZE);
+
+	pHeader[0] = static_cast<char>((length >> 16) & 0xff);
+	pHeader[1] = static_cast<char>((length >> 8) & 0xff);
+	pHeader[2] = static_cast<char>(length & 0xff);
+	pHeader[3] = static_cast<char>(type);
+	pHeader[4] = static_cast<char>(flags);
+	pHeader[5] = static_cast<char>((streamId >> 24) & 0x7f);
+	pHeader[6] = static_cast<char>((streamId >> 16) & 0xff);
+	pHeader[7] = static_cast<char>((streamId >> 8) & 0xff);
+	pHeader[8] = static_cast<char>(streamId & 0xff);
+}
+
+
+void HTTP2Frame::appendUInt32(std::string& buffer, Poco::UInt32 value)
+{
+	char bytes[4];
+	bytes[0] = static_cast<char>((value >> 24) & 0xff);
+	bytes[1] = static_cast<char>((value >> 16) & 0xff);
+	bytes[2] = static_cast<char>((value >> 8) & 0xff);
+	bytes[3] = static_cast<char>(value & 0xff);
+	buffer.append(bytes, 4);
+}
+
+
+} } // namespace Poco::Net
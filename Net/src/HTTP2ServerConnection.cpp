@@ -0,0 +1,267 @@
+//
+// HTTP2ServerConnection.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2ServerConnection
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTP2ServerConnection.h"
+#include "Poco/Net/HTTP2ServerRequest.h"
+#include "Poco/Net/HTTP2ServerResponse.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Net/ServerMetrics.h"
+#include "Poco/Base64Encoder.h"
+#include "Poco/Base64Decoder.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/Timestamp.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Clock.h"
+#include "Poco/String.h"
+#include <sstream>
+#include <memory>
+
+
+namespace Poco {
+namespace Net {
+
+
+HTTP2ServerConnection::HTTP2ServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory):
+	HTTP2Connection(socket, true),
+	_pParams(pParams),
+	_pFactory(pFactory)
+{
+	poco_check_ptr (pFactory);
+
+	setTimeout(_pParams->getTimeout());
+	try
+	{
+		_clientAddress = this->socket().peerAddress();
+		_serverAddress = this->socket().address();
+	}
+	catch (...)
+	{
+	}
+}
+
+
+HTTP2ServerConnection::~HTTP2ServerConnection()
+{
+}
+
+
+bool HTTP2ServerConnection::upgrade(const HTTPRequest& request)
+{
+	std::string settings;
+	try
+	{
+		std::istringstream istr(request.get("HTTP2-Settings"));
+		Poco::Base64Decoder decoder(istr, Poco::BASE64_URL_ENCODING | Poco::BASE64_NO_PADDING);
+		char buffer[256];
+		while (decoder.read(buffer, sizeof(buffer)) || decoder.gcount() > 0)
+		{
+			settings.append(buffer, static_cast<std::size_t>(decoder.gcount()));
+		}
+		applySettings(settings.data(), settings.size());
+	}
+	catch (Poco::Exception&)
+	{
+		return false;
+	}
+
+	Stream& stream = addStream(1);
+	HPACKTable::HeaderList& headers = stream.headers;
+	headers.push_back(HPACKTable::Header(":method", request.getMethod()));
+	headers.push_back(HPACKTable::Header(":scheme", "http"));
+	headers.push_back(HPACKTable::Header(":authority", request.getHost()));
+	headers.push_back(HPACKTable::Header(":path", request.getURI()));
+	for (HTTPRequest::ConstIterator it = request.begin(); it != request.end(); ++it)
+	{
+		std::string name = Poco::toLower(it->first);
+		if (HTTP2ServerRequest::isConnectionHeader(name) || name == "host" || name == "http2-settings" || name == "te") continue;
+		if (name == "priority") parsePriority(it->second, stream.urgency);
+		headers.push_back(HPACKTable::Header(name, it->second));
+	}
+	stream.headersReceived = true;
+	stream.endReceived = true;
+	return true;
+}
+
+
+void HTTP2ServerConnection::run()
+{
+	try
+	{
+		sendSettings(static_cast<Poco::UInt32>(_pParams->getHTTP2MaxConcurrentStreams()));
+		flush();
+		receivePreface();
+		while (!closed())
+		{
+			// Process everything the client has sent so far, so that
+			// all requests received are considered for prioritization.
+			while (receiveFrame(Poco::Timespan(0)))
+			{
+			}
+			if (closed()) break;
+
+			Stream* pStream = nextRequest();
+			if (pStream)
+			{
+				handleRequest(*pStream);
+				removeDoneStreams();
+				flush();
+			}
+			else
+			{
+				removeDoneStreams();
+				flush();
+				if (goAwayReceived() && streams().empty()) break;
+				if (!receiveFrame(_pParams->getKeepAliveTimeout()) && !closed())
+				{
+					sendGoAway(HTTP2Frame::HTTP2_NO_ERROR);
+					break;
+				}
+			}
+		}
+	}
+	catch (HTTP2Exception&)
+	{
+		// GOAWAY has been sent
+	}
+}
+
+
+bool HTTP2ServerConnection::isPreface(const HTTPRequest& request)
+{
+	return request.getMethod() == "PRI" && request.getURI() == "*" && request.getVersion() == HTTPMessage::HTTP_2_0;
+}
+
+
+bool HTTP2ServerConnection::isUpgrade(const HTTPRequest& request)
+{
+	return Poco::icompare(request.get("Upgrade", ""), "h2c") == 0 && request.has("HTTP2-Settings");
+}
+
+
+void HTTP2ServerConnection::onHeaders(Stream* pStream, Poco::UInt32 streamId, HPACKTable::HeaderList& headers, bool endStream)
+{
+	if (pStream)
+	{
+		// trailer fields are not passed to the application
+		if (endStream && !pStream->endReceived)
+			pStream->endReceived = true;
+		else
+			resetStream(streamId, HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+	}
+	else
+	{
+		if ((streamId & 1) == 0) throw HTTP2Exception("Invalid client stream identifier", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+		if (activeStreams() >= localMaxConcurrentStreams())
+		{
+			setLastStreamId(streamId);
+			resetStream(streamId, HTTP2Frame::HTTP2_REFUSED_STREAM);
+		}
+		else
+		{
+			Stream& stream = addStream(streamId);
+			stream.headers.swap(headers);
+			stream.headersReceived = true;
+			stream.endReceived = endStream;
+		}
+	}
+}
+
+
+HTTP2Connection::Stream* HTTP2ServerConnection::nextRequest()
+{
+	Stream* pNext = 0;
+	for (StreamMap::iterator it = streams().begin(); it != streams().end(); ++it)
+	{
+		Stream& stream = it->second;
+		if (stream.headersReceived && !stream.dispatched && !stream.reset)
+		{
+			if (!pNext || stream.urgency < pNext->urgency) pNext = &stream;
+		}
+	}
+	return pNext;
+}
+
+
+void HTTP2ServerConnection::handleRequest(Stream& stream)
+{
+	Poco::UInt32 streamId = stream.id;
+	stream.dispatched = true;
+	HPACKTable::HeaderList headers;
+	headers.swap(stream.headers);
+
+	ServerMetrics::Ptr pMetrics = _pParams->getMetrics();
+	HTTP2ServerResponse response(*this, streamId);
+	try
+	{
+		HTTP2ServerRequest request(*this, streamId, headers, response, _pParams, _clientAddress, _serverAddress);
+		if (pMetrics) pMetrics->requests().add();
+
+		response.setDate(Poco::Timestamp());
+		const std::string& server = _pParams->getSoftwareVersion();
+		if (!server.empty()) response.set("Server", server);
+
+		std::unique_ptr<HTTPRequestHandler> pHandler(_pFactory->createRequestHandler(request));
+		if (pHandler.get())
+		{
+			if (request.getExpectContinue() && response.getStatus() == HTTPResponse::HTTP_OK)
+				response.sendContinue();
+
+			Poco::Clock handlerStart;
+			pHandler->handleRequest(request, response);
+			if (pMetrics) pMetrics->handlerTime().record(static_cast<Poco::UInt64>(handlerStart.elapsed()));
+			response.finish();
+		}
+		else sendErrorResponse(streamId, HTTPResponse::HTTP_NOT_IMPLEMENTED);
+	}
+	catch (HTTP2Exception& exc)
+	{
+		// An invalid request, or the client has reset the stream.
+		if (failed()) throw;
+		Stream* pStream = findStream(streamId);
+		if (pStream && !pStream->reset) resetStream(streamId, exc.code());
+	}
+	catch (Poco::Exception& exc)
+	{
+		if (failed()) throw;
+		Stream* pStream = findStream(streamId);
+		if (pStream && !pStream->reset)
+		{
+			if (!response.sent())
+				sendErrorResponse(streamId, HTTPResponse::HTTP_INTERNAL_SERVER_ERROR);
+			else
+				resetStream(streamId, HTTP2Frame::HTTP2_INTERNAL_ERROR);
+		}
+		Poco::ErrorHandler::handle(exc);
+	}
+
+	Stream* pStream = findStream(streamId);
+	if (pStream) pStream->done = true;
+}
+
+
+void HTTP2ServerConnection::sendErrorResponse(Poco::UInt32 streamId, HTTPResponse::HTTPStatus status)
+{
+	Stream* pStream = findStream(streamId);
+	if (pStream && !pStream->endQueued)
+	{
+		HPACKTable::HeaderList headers;
+		headers.push_back(HPACKTable::Header(":status", Poco::NumberFormatter::format(static_cast<int>(status))));
+		headers.push_back(HPACKTable::Header("content-length", "0"));
+		sendHeaders(streamId, headers, true);
+	}
+}
+
+
+} } // namespace Poco::Net
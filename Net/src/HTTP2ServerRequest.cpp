@@ -0,0 +1,108 @@
+//
+// HTTP2ServerRequest.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2ServerRequest
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTP2ServerRequest.h"
+#include "Poco/Net/HTTP2ServerResponse.h"
+#include "Poco/Net/HTTP2Connection.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Ascii.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+HTTP2ServerRequest::HTTP2ServerRequest(HTTP2Connection& connection, Poco::UInt32 streamId, const HPACKTable::HeaderList& headers, HTTP2ServerResponse& response, HTTPServerParams* pParams, const SocketAddress& clientAddress, const SocketAddress& serverAddress):
+	_response(response),
+	_stream(connection, streamId),
+	_streamId(streamId),
+	_pParams(pParams, true),
+	_clientAddress(clientAddress),
+	_serverAddress(serverAddress),
+	_secure(connection.socket().secure())
+{
+	response.attachRequest(this);
+
+	std::string method;
+	std::string path;
+	std::string authority;
+	std::string cookie;
+	bool regularSeen = false;
+	for (HPACKTable::HeaderList::const_iterator it = headers.begin(); it != headers.end(); ++it)
+	{
+		const std::string& name = it->first;
+		const std::string& value = it->second;
+		if (name.empty()) throw HTTP2Exception("Empty header field name", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+		if (name[0] == ':')
+		{
+			if (regularSeen) throw HTTP2Exception("Pseudo-header field after regular field", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+			if (name == ":method")
+				method = value;
+			else if (name == ":path")
+				path = value;
+			else if (name == ":authority")
+				authority = value;
+			else if (name != ":scheme")
+				throw HTTP2Exception("Invalid pseudo-header field", name, HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+		}
+		else
+		{
+			regularSeen = true;
+			for (std::string::const_iterator itc = name.begin(); itc != name.end(); ++itc)
+			{
+				if (Poco::Ascii::isUpper(*itc)) throw HTTP2Exception("Uppercase header field name", name, HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+			}
+			if (isConnectionHeader(name) || (name == "te" && value != "trailers"))
+				throw HTTP2Exception("Connection-specific header field", name, HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+			if (name == "cookie")
+			{
+				// cookie crumbs are joined again (RFC 9113, section 8.2.3)
+				if (!cookie.empty()) cookie.append("; ");
+				cookie.append(value);
+			}
+			else add(name, value);
+		}
+	}
+	if (method.empty() || path.empty()) throw HTTP2Exception("Missing pseudo-header field", HTTP2Frame::HTTP2_PROTOCOL_ERROR);
+
+	setMethod(method);
+	setURI(path);
+	setVersion(HTTPMessage::HTTP_2_0);
+	if (!authority.empty() && !has(HTTPRequest::HOST)) setHost(authority);
+	if (!cookie.empty()) set("Cookie", cookie);
+}
+
+
+HTTP2ServerRequest::~HTTP2ServerRequest()
+{
+}
+
+
+HTTPServerResponse& HTTP2ServerRequest::response() const
+{
+	return _response;
+}
+
+
+bool HTTP2ServerRequest::isConnectionHeader(const std::string& name)
+{
+	return name == "connection"
+		|| name == "keep-alive"
+		|| name == "proxy-connection"
+		|| name == "transfer-encoding"
+		|| name == "upgrade";
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,210 @@
+//
+// HTTP2ServerResponse.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2ServerResponse
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTP2ServerResponse.h"
+#include "Poco/Net/HTTP2ServerRequest.h"
+#include "Poco/Net/HTTP2Connection.h"
+#include "Poco/Net/HTTP2Stream.h"
+#include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/NullStream.h"
+#include "Poco/Timestamp.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/DateTimeFormat.h"
+#include "Poco/String.h"
+#include "Poco/Buffer.h"
+#include "Poco/Exception.h"
+
+
+using Poco::File;
+using Poco::Timestamp;
+using Poco::NumberFormatter;
+using Poco::DateTimeFormatter;
+using Poco::DateTimeFormat;
+using Poco::OpenFileException;
+
+
+namespace Poco {
+namespace Net {
+
+
+HTTP2ServerResponse::HTTP2ServerResponse(HTTP2Connection& connection, Poco::UInt32 streamId):
+	_connection(connection),
+	_streamId(streamId),
+	_pRequest(0),
+	_pStream(0),
+	_pOutputStream(0),
+	_sent(false)
+{
+}
+
+
+HTTP2ServerResponse::~HTTP2ServerResponse()
+{
+	delete _pStream;
+}
+
+
+void HTTP2ServerResponse::sendContinue()
+{
+	HPACKTable::HeaderList headers;
+	headers.push_back(HPACKTable::Header(":status", "100"));
+	_connection.sendHeaders(_streamId, headers, false);
+	_connection.flush();
+}
+
+
+std::ostream& HTTP2ServerResponse::send()
+{
+	poco_assert (!_pStream);
+
+	if (isHead() ||
+		getStatus() < 200 ||
+		getStatus() == HTTPResponse::HTTP_NO_CONTENT ||
+		getStatus() == HTTPResponse::HTTP_NOT_MODIFIED)
+	{
+		sendHeader(true);
+		_pStream = new Poco::NullOutputStream;
+	}
+	else
+	{
+		sendHeader(false);
+		_pOutputStream = new HTTP2OutputStream(_connection, _streamId);
+		_pStream = _pOutputStream;
+	}
+	return *_pStream;
+}
+
+
+void HTTP2ServerResponse::sendFile(const std::string& path, const std::string& mediaType)
+{
+	poco_assert (!_pStream);
+
+	File f(path);
+	Timestamp dateTime    = f.getLastModified();
+	File::FileSize length = f.getSize();
+	set("Last-Modified", DateTimeFormatter::format(dateTime, DateTimeFormat::HTTP_FORMAT));
+	setContentType(mediaType);
+	setChunkedTransferEncoding(false);
+#if defined(POCO_HAVE_INT64)
+	setContentLength64(length);
+#else
+	setContentLength(static_cast<int>(length));
+#endif
+
+	Poco::FileInputStream istr(path);
+	if (istr.good())
+	{
+		_pStream = new Poco::NullOutputStream;
+		bool endStream = isHead() || length == 0;
+		sendHeader(endStream);
+		if (!endStream)
+		{
+			Poco::Buffer<char> buffer(HTTP2Frame::DEFAULT_MAX_FRAME_SIZE);
+			File::FileSize remaining = length;
+			while (remaining > 0)
+			{
+				std::streamsize n = static_cast<std::streamsize>(remaining < buffer.size() ? remaining : buffer.size());
+				istr.read(buffer.begin(), n);
+				if (istr.gcount() != n) throw Poco::ReadFileException(path);
+				remaining -= static_cast<File::FileSize>(n);
+				_connection.writeData(_streamId, buffer.begin(), static_cast<std::size_t>(n), remaining == 0);
+			}
+		}
+	}
+	else throw OpenFileException(path);
+}
+
+
+void HTTP2ServerResponse::sendBuffer(const void* pBuffer, std::size_t length)
+{
+	poco_assert (!_pStream);
+
+	setContentLength(static_cast<int>(length));
+	setChunkedTransferEncoding(false);
+
+	_pStream = new Poco::NullOutputStream;
+	bool endStream = isHead() || length == 0;
+	sendHeader(endStream);
+	if (!endStream)
+	{
+		_connection.writeData(_streamId, static_cast<const char*>(pBuffer), length, true);
+	}
+}
+
+
+void HTTP2ServerResponse::redirect(const std::string& uri, HTTPStatus status)
+{
+	poco_assert (!_pStream);
+
+	setContentLength(0);
+	setChunkedTransferEncoding(false);
+
+	setStatusAndReason(status);
+	set("Location", uri);
+
+	_pStream = new Poco::NullOutputStream;
+	sendHeader(true);
+}
+
+
+void HTTP2ServerResponse::requireAuthentication(const std::string& realm)
+{
+	poco_assert (!_pStream);
+
+	setStatusAndReason(HTTPResponse::HTTP_UNAUTHORIZED);
+	std::string auth("Basic realm=\"");
+	auth.append(realm);
+	auth.append("\"");
+	set("WWW-Authenticate", auth);
+}
+
+
+void HTTP2ServerResponse::finish()
+{
+	if (!_sent)
+	{
+		sendHeader(true);
+	}
+	else if (_pOutputStream)
+	{
+		_pOutputStream->close();
+	}
+	_connection.flush();
+}
+
+
+void HTTP2ServerResponse::sendHeader(bool endStream)
+{
+	HPACKTable::HeaderList headers;
+	headers.push_back(HPACKTable::Header(":status", NumberFormatter::format(static_cast<int>(getStatus()))));
+	for (ConstIterator it = begin(); it != end(); ++it)
+	{
+		std::string name = Poco::toLower(it->first);
+		if (!HTTP2ServerRequest::isConnectionHeader(name))
+			headers.push_back(HPACKTable::Header(name, it->second));
+	}
+	_connection.sendHeaders(_streamId, headers, endStream);
+	_sent = true;
+}
+
+
+bool HTTP2ServerResponse::isHead() const
+{
+	return _pRequest && _pRequest->getMethod() == HTTPRequest::HTTP_HEAD;
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,129 @@
+//
+// HTTP2Stream.cpp
+//
+// Library: Net
+// Package: HTTP2
+// Module:  HTTP2Stream
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTP2Stream.h"
+#include "Poco/Net/HTTP2Connection.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+//
+// HTTP2StreamBuf
+//
+
+
+HTTP2StreamBuf::HTTP2StreamBuf(HTTP2Connection& connection, Poco::UInt32 streamId, openmode mode):
+	HTTPBasicStreamBuf(HTTP2Frame::DEFAULT_MAX_FRAME_SIZE, mode),
+	_connection(connection),
+	_streamId(streamId),
+	_closed(false)
+{
+}
+
+
+HTTP2StreamBuf::~HTTP2StreamBuf()
+{
+}
+
+
+void HTTP2StreamBuf::close()
+{
+	if (!_closed && (getMode() & std::ios::out))
+	{
+		_closed = true;
+		sync();
+		_connection.writeData(_streamId, 0, 0, true);
+	}
+}
+
+
+int HTTP2StreamBuf::readFromDevice(char* buffer, std::streamsize length)
+{
+	return _connection.readData(_streamId, buffer, static_cast<std::size_t>(length));
+}
+
+
+int HTTP2StreamBuf::writeToDevice(const char* buffer, std::streamsize length)
+{
+	_connection.writeData(_streamId, buffer, static_cast<std::size_t>(length), false);
+	return static_cast<int>(length);
+}
+
+
+//
+// HTTP2IOS
+//
+
+
+HTTP2IOS::HTTP2IOS(HTTP2Connection& connection, Poco::UInt32 streamId, HTTP2StreamBuf::openmode mode):
+	_buf(connection, streamId, mode)
+{
+	poco_ios_init(&_buf);
+}
+
+
+HTTP2IOS::~HTTP2IOS()
+{
+}
+
+
+HTTP2StreamBuf* HTTP2IOS::rdbuf()
+{
+	return &_buf;
+}
+
+
+//
+// HTTP2InputStream
+//
+
+
+HTTP2InputStream::HTTP2InputStream(HTTP2Connection& connection, Poco::UInt32 streamId):
+	HTTP2IOS(connection, streamId, std::ios::in),
+	std::istream(&_buf)
+{
+}
+
+
+HTTP2InputStream::~HTTP2InputStream()
+{
+}
+
+
+//
+// HTTP2OutputStream
+//
+
+
+HTTP2OutputStream::HTTP2OutputStream(HTTP2Connection& connection, Poco::UInt32 streamId):
+	HTTP2IOS(connection, streamId, std::ios::out),
+	std::ostream(&_buf)
+{
+}
+
+
+HTTP2OutputStream::~HTTP2OutputStream()
+{
+}
+
+
+void HTTP2OutputStream::close()
+{
+	_buf.close();
+}
+
+
+} } // namespace Poco::Net
@@ -13,6 +13,7 @@
 
 
 #include "Poco/Net/HTTPBufferAllocator.h"
+#include "Poco/MemoryPool.h"
 
 
 using Poco::MemoryPool;
@@ -22,22 +23,148 @@ namespace Poco {
 namespace Net {
 
 
-MemoryPool HTTPBufferAllocator::_pool(HTTPBufferAllocator::BUFFER_SIZE, 16);
+namespace
+{
+	enum
+	{
+		SIZE_CLASSES = 3,
+		MAX_CACHED = 16
+	};
+
+	const int cacheLimits[SIZE_CLASSES] = { 16, 8, 4 };
+		// maximum number of free buffers kept by a thread
+
+	int sizeClass(std::streamsize size)
+	{
+		if (size <= HTTPBufferAllocator::SMALL_BUFFER_SIZE)
+			return 0;
+		else if (size <= HTTPBufferAllocator::MEDIUM_BUFFER_SIZE)
+			return 1;
+		else if (size <= HTTPBufferAllocator::LARGE_BUFFER_SIZE)
+			return 2;
+		else
+			return -1;
+	}
+
+	class Pools
+	{
+	public:
+		Pools():
+			_small(HTTPBufferAllocator::SMALL_BUFFER_SIZE, 16),
+			_medium(HTTPBufferAllocator::MEDIUM_BUFFER_SIZE),
+			_large(HTTPBufferAllocator::LARGE_BUFFER_SIZE)
+		{
+		}
+
+		MemoryPool& pool(int sc)
+		{
+			switch (sc)
+			{
+			case 0:  return _small;
+			case 1:  return _medium;
+			default: return _large;
+			}
+		}
+
+	private:
+		MemoryPool _small;
+		MemoryPool _medium;
+		MemoryPool _large;
+	};
+
+	Pools& pools()
+	{
+		// Never destroyed, as threads still running at exit
+		// return their cached buffers when they terminate.
+		static Pools* pPools = new Pools;
+		return *pPools;
+	}
+
+	class ThreadCache
+		// The free buffers of a thread. When the thread
+		// terminates, its buffers are returned to the pools.
+	{
+	public:
+		ThreadCache()
+		{
+			for (int sc = 0; sc < SIZE_CLASSES; sc++) _count[sc] = 0;
+		}
+
+		~ThreadCache()
+		{
+			try
+			{
+				for (int sc = 0; sc < SIZE_CLASSES; sc++)
+				{
+					while (_count[sc] > 0) pools().pool(sc).release(_buffers[sc][--_count[sc]]);
+				}
+			}
+			catch (...)
+			{
+			}
+		}
+
+		char* get(int sc)
+		{
+			if (_count[sc] > 0)
+				return _buffers[sc][--_count[sc]];
+			else
+				return 0;
+		}
+
+		bool put(int sc, char* pBuffer)
+		{
+			if (_count[sc] < cacheLimits[sc])
+			{
+				_buffers[sc][_count[sc]++] = pBuffer;
+				return true;
+			}
+			return false;
+		}
+
+	private:
+		char* _buffers[SIZE_CLASSES][MAX_CACHED];
+		int _count[SIZE_CLASSES];
+	};
+
+	thread_local ThreadCache threadCache;
+}
 
 
 char* HTTPBufferAllocator::allocate(std::streamsize size)
 {
-	poco_assert_dbg (size == BUFFER_SIZE);
+	int sc = sizeClass(size);
+	if (sc < 0) return new char[static_cast<std::size_t>(size)];
 
-	return reinterpret_cast<char*>(_pool.get());
+	char* pBuffer = threadCache.get(sc);
+	if (!pBuffer) pBuffer = reinterpret_cast<char*>(pools().pool(sc).get());
+	return pBuffer;
 }
 
 
 void HTTPBufferAllocator::deallocate(char* ptr, std::streamsize size)
 {
-	poco_assert_dbg (size == BUFFER_SIZE);
+	int sc = sizeClass(size);
+	if (sc < 0)
+	{
+		delete [] ptr;
+	}
+	else if (!threadCache.put(sc, ptr))
+	{
+		pools().pool(sc).release(ptr);
+	}
+}
 
-	_pool.release(ptr);
+
+std::streamsize HTTPBufferAllocator::capacity(std::streamsize size)
+{
+	switch (sizeClass(size))
+	{
+	case 0:  return SMALL_BUFFER_SIZE;
+	case 1:  return MEDIUM_BUFFER_SIZE;
+	case 2:  return LARGE_BUFFER_SIZE;
+	default: return size;
+	}
 }
 
 
@@ -14,6 +14,7 @@
 
 #include "Poco/Net/HTTPChunkedStream.h"
 #include "Poco/Net/HTTPSession.h"
+#include "Poco/Net/Socket.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/NumberParser.h"
 #include "Poco/Ascii.h"
@@ -33,7 +34,7 @@ namespace Net {
 
 
 HTTPChunkedStreamBuf::HTTPChunkedStreamBuf(HTTPSession& session, openmode mode):
-	HTTPBasicStreamBuf(HTTPBufferAllocator::BUFFER_SIZE, mode),
+	HTTPBasicStreamBuf(session.getBufferSize(), mode),
 	_session(session),
 	_mode(mode),
 	_chunk(0)
@@ -92,12 +93,18 @@ int HTTPChunkedStreamBuf::readFromDevice(char* buffer, std::streamsize length)
 
 int HTTPChunkedStreamBuf::writeToDevice(const char* buffer, std::streamsize length)
 {
+	static const char CRLF[] = "\r\n";
+
+	// The chunk size line, data and trailing CRLF are sent
+	// with a single gather write, without copying the data.
 	_chunkBuffer.clear();
 	NumberFormatter::appendHex(_chunkBuffer, static_cast<Poco::UInt64>(length));
-	_chunkBuffer.append("\r\n", 2);
-	_chunkBuffer.append(buffer, static_cast<std::string::size_type>(length));
-	_chunkBuffer.append("\r\n", 2);
-	_session.write(_chunkBuffer.data(), static_cast<std::streamsize>(_chunkBuffer.size()));
+	_chunkBuffer.append(CRLF, 2);
+	SocketBufVec buffers(3);
+	buffers[0] = Socket::makeBuffer(_chunkBuffer.data(), _chunkBuffer.size());
+	buffers[1] = Socket::makeBuffer(buffer, static_cast<std::size_t>(length));
+	buffers[2] = Socket::makeBuffer(CRLF, 2);
+	_session.write(buffers);
 	return static_cast<int>(length);
 }
 
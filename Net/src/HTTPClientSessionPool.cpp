@@ -0,0 +1,331 @@
+//
+// HTTPClientSessionPool.cpp
+//
+// Library: Net
+// Package: HTTPClient
+// Module:  HTTPClientSessionPool
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPClientSessionPool.h"
+#include "Poco/Net/HTTPSessionFactory.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/URI.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Exception.h"
+
+
+using Poco::FastMutex;
+using Poco::Timestamp;
+using Poco::Timespan;
+
+
+namespace Poco {
+namespace Net {
+
+
+HTTPClientSessionPool::HTTPClientSessionPool(int maxSessionsPerHost, const Poco::Timespan& idleTimeout, const Poco::Timespan& waitTimeout):
+	_maxSessionsPerHost(maxSessionsPerHost),
+	_idleTimeout(idleTimeout),
+	_waitTimeout(waitTimeout),
+	_proxyConfig(HTTPClientSession::getGlobalProxyConfig()),
+	_idle(0),
+	_hits(0),
+	_misses(0),
+	_waits(0),
+	_timeouts(0)
+{
+	poco_assert (maxSessionsPerHost > 0);
+}
+
+
+HTTPClientSessionPool::~HTTPClientSessionPool()
+{
+	poco_assert_dbg (_leases.empty());
+
+	for (HostMap::iterator it = _hosts.begin(); it != _hosts.end(); ++it)
+	{
+		for (std::vector<IdleSession>::iterator itIdle = it->second.idle.begin(); itIdle != it->second.idle.end(); ++itIdle)
+		{
+			delete itIdle->pSession;
+		}
+	}
+}
+
+
+HTTPClientSession* HTTPClientSessionPool::acquire(const Poco::URI& uri)
+{
+	return acquire(uri.getScheme(), uri.getHost(), uri.getPort());
+}
+
+
+HTTPClientSession* HTTPClientSessionPool::acquire(const std::string& scheme, const std::string& host, Poco::UInt16 port)
+{
+	Timestamp start;
+
+	FastMutex::ScopedLock lock(_mutex);
+
+	std::string hostKey = key(scheme, host, port);
+	Host& h = _hosts[hostKey];
+	bool waited = false;
+	for (;;)
+	{
+		Timestamp now;
+		// most recently used sessions are at the back, and most likely still alive
+		while (!h.idle.empty())
+		{
+			IdleSession idle = h.idle.back();
+			h.idle.pop_back();
+			--_idle;
+			if (isReusable(idle, now))
+			{
+				++h.leased;
+				++_hits;
+				_leases[idle.pSession] = hostKey;
+				return idle.pSession;
+			}
+			delete idle.pSession;
+		}
+		if (h.leased < _maxSessionsPerHost) break;
+
+		if (!waited)
+		{
+			++_waits;
+			waited = true;
+		}
+		Timespan remaining = _waitTimeout - (now - start);
+		if (remaining <= 0 || !_released.tryWait(_mutex, static_cast<long>(remaining.totalMilliseconds())))
+		{
+			if (h.leased < _maxSessionsPerHost || !h.idle.empty()) continue;
+			++_timeouts;
+			throw Poco::TimeoutException("No HTTP session available for " + hostKey);
+		}
+	}
+
+	HTTPClientSession* pSession = createSession(scheme, host, port);
+	++h.leased;
+	++_misses;
+	try
+	{
+		_leases[pSession] = hostKey;
+	}
+	catch (...)
+	{
+		--h.leased;
+		delete pSession;
+		throw;
+	}
+	return pSession;
+}
+
+
+void HTTPClientSessionPool::release(HTTPClientSession* pSession)
+{
+	giveBack(pSession, pSession->connected() && pSession->getKeepAlive() && !pSession->networkException());
+}
+
+
+void HTTPClientSessionPool::discard(HTTPClientSession* pSession)
+{
+	giveBack(pSession, false);
+}
+
+
+void HTTPClientSessionPool::giveBack(HTTPClientSession* pSession, bool keep)
+{
+	poco_check_ptr (pSession);
+
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		LeaseMap::iterator it = _leases.find(pSession);
+		if (it == _leases.end()) throw Poco::InvalidArgumentException("HTTPClientSession does not belong to this pool");
+		Host& h = _hosts[it->second];
+		_leases.erase(it);
+		--h.leased;
+
+		Timestamp now;
+		purge(h, now);
+		if (keep)
+		{
+			IdleSession idle;
+			idle.pSession = pSession;
+			idle.idleSince = now;
+			h.idle.push_back(idle);
+			++_idle;
+			pSession = 0;
+		}
+		_released.broadcast();
+	}
+	delete pSession;
+}
+
+
+bool HTTPClientSessionPool::owns(HTTPClientSession* pSession) const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _leases.find(pSession) != _leases.end();
+}
+
+
+void HTTPClientSessionPool::purge()
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	Timestamp now;
+	HostMap::iterator it = _hosts.begin();
+	while (it != _hosts.end())
+	{
+		purge(it->second, now);
+		if (it->second.idle.empty() && it->second.leased == 0)
+			_hosts.erase(it++);
+		else
+			++it;
+	}
+}
+
+
+void HTTPClientSessionPool::purge(Host& host, const Poco::Timestamp& now)
+{
+	// idle sessions are ordered by the time they were released,
+	// so expired sessions are at the front
+	std::vector<IdleSession>::iterator it = host.idle.begin();
+	while (it != host.idle.end() && Timespan(now - it->idleSince) >= _idleTimeout)
+	{
+		delete it->pSession;
+		--_idle;
+		++it;
+	}
+	host.idle.erase(host.idle.begin(), it);
+}
+
+
+void HTTPClientSessionPool::setProxyConfig(const HTTPClientSession::ProxyConfig& config)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	_proxyConfig = config;
+}
+
+
+HTTPClientSession::ProxyConfig HTTPClientSessionPool::getProxyConfig() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _proxyConfig;
+}
+
+
+int HTTPClientSessionPool::idle() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _idle;
+}
+
+
+int HTTPClientSessionPool::leased() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return static_cast<int>(_leases.size());
+}
+
+
+int HTTPClientSessionPool::hits() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _hits;
+}
+
+
+int HTTPClientSessionPool::misses() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _misses;
+}
+
+
+int HTTPClientSessionPool::waits() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _waits;
+}
+
+
+int HTTPClientSessionPool::timeouts() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _timeouts;
+}
+
+
+std::string HTTPClientSessionPool::key(const std::string& scheme, const std::string& host, Poco::UInt16 port) const
+{
+	std::string result(scheme);
+	result += "://";
+	result += host;
+	result += ':';
+	NumberFormatter::append(result, port);
+	if (!_proxyConfig.host.empty())
+	{
+		result += " via ";
+		result += _proxyConfig.host;
+		result += ':';
+		NumberFormatter::append(result, _proxyConfig.port);
+	}
+	return result;
+}
+
+
+HTTPClientSession* HTTPClientSessionPool::createSession(const std::string& scheme, const std::string& host, Poco::UInt16 port)
+{
+	HTTPClientSession* pSession;
+	if (scheme == "http" && !HTTPSessionFactory::defaultFactory().supportsProtocol(scheme))
+	{
+		pSession = new HTTPClientSession(host, port);
+	}
+	else
+	{
+		Poco::URI uri;
+		uri.setScheme(scheme);
+		uri.setHost(host);
+		uri.setPort(port);
+		pSession = HTTPSessionFactory::defaultFactory().createClientSession(uri);
+	}
+	pSession->setProxyConfig(_proxyConfig);
+	pSession->setKeepAlive(true);
+	return pSession;
+}
+
+
+bool HTTPClientSessionPool::isReusable(const IdleSession& idle, const Poco::Timestamp& now) const
+{
+	if (Timespan(now - idle.idleSince) >= _idleTimeout) return false;
+	if (idle.pSession->mustReconnect()) return false;
+	if (!idle.pSession->connected()) return false;
+	try
+	{
+		// An idle connection must not have anything to read.
+		// If it has, the server has closed the connection,
+		// or sent data we cannot make sense of.
+		return !idle.pSession->socket().poll(Timespan(0), Socket::SELECT_READ | Socket::SELECT_ERROR);
+	}
+	catch (Poco::Exception&)
+	{
+		return false;
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -14,6 +14,7 @@
 
 #include "Poco/Net/HTTPIOStream.h"
 #include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPClientSessionPool.h"
 
 
 using Poco::UnbufferedStreamBuf;
@@ -56,9 +57,42 @@ HTTPResponseStream::HTTPResponseStream(std::istream& istr, HTTPClientSession* pS
 }
 
 
+HTTPResponseStream::HTTPResponseStream(std::istream& istr, HTTPClientSession* pSession, Poco::SharedPtr<HTTPClientSessionPool> pPool):
+	HTTPResponseIOS(istr),
+	std::istream(&_buf),
+	_pSession(pSession),
+	_pPool(pPool)
+{
+}
+
+
 HTTPResponseStream::~HTTPResponseStream()
 {
-	delete _pSession;
+	if (_pPool)
+	{
+		bool complete = false;
+		try
+		{
+			// The connection can only be reused if nothing
+			// of the response is left to be read.
+			complete = !_pSession->networkException() && _buf.sgetc() == std::char_traits<char>::eof();
+		}
+		catch (...)
+		{
+		}
+		try
+		{
+			if (complete)
+				_pPool->release(_pSession);
+			else
+				_pPool->discard(_pSession);
+		}
+		catch (...)
+		{
+			poco_unexpected();
+		}
+	}
+	else delete _pSession;
 }
 
 
@@ -0,0 +1,531 @@
+//
+// HTTPReactorServer.cpp
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPReactorServer
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPReactorServer.h"
+#include "Poco/Net/HTTPServerSession.h"
+#include "Poco/Net/HTTPServerRequestImpl.h"
+#include "Poco/Net/HTTPServerResponseImpl.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/ParallelSocketAcceptor.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Observer.h"
+#include "Poco/Notification.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Mutex.h"
+#include <memory>
+#include <set>
+#include <vector>
+
+
+using Poco::FastMutex;
+using Poco::Timestamp;
+using Poco::Timespan;
+
+
+namespace Poco {
+namespace Net {
+
+
+//
+// HTTPReactorServer::Reactor
+//
+
+
+class HTTPReactorServer::Reactor: public SocketReactor
+	/// A SocketReactor that waits for requests on idle connections
+	/// and closes connections whose timeout has expired.
+{
+public:
+	Reactor():
+		_pServer(0)
+	{
+	}
+
+	void setServer(HTTPReactorServer* pServer)
+	{
+		_pServer = pServer;
+	}
+
+	HTTPReactorServer& server()
+	{
+		poco_check_ptr (_pServer);
+
+		return *_pServer;
+	}
+
+	void add(Connection* pConnection);
+		/// Registers the connection's event handler and
+		/// starts watching its timeout.
+
+	void remove(Connection* pConnection);
+		/// Unregisters the connection's event handler.
+
+protected:
+	void onTimeout()
+	{
+		SocketReactor::onTimeout();
+		sweep();
+	}
+
+	void onBusy()
+	{
+		SocketReactor::onBusy();
+		sweep();
+	}
+
+	void onShutdown();
+
+	void sweep();
+		/// Closes all connections whose timeout has expired.
+		/// Done at most once per second.
+
+private:
+	typedef std::set<Connection*> ConnectionSet;
+
+	HTTPReactorServer* _pServer;
+	ConnectionSet _connections;
+	Timestamp _lastSweep;
+	FastMutex _mutex;
+};
+
+
+//
+// HTTPReactorServer::Connection
+//
+
+
+class HTTPReactorServer::Connection
+	/// A connection to a client. Owned by its reactor while
+	/// waiting for a request, and by a worker thread while
+	/// the request is handled.
+{
+public:
+	Connection(StreamSocket& socket, SocketReactor& reactor):
+		_reactor(static_cast<Reactor&>(reactor)),
+		_server(_reactor.server()),
+		_session(socket, _server._pParams),
+		_registered(false),
+		_firstRequest(true)
+	{
+		_session.socket().setNoDelay(true);
+		_session.socket().setBlocking(false);
+		++_server._totalConnections;
+		++_server._currentConnections;
+		_reactor.add(this);
+	}
+
+	~Connection()
+	{
+		try
+		{
+			if (_registered) _reactor.remove(this);
+		}
+		catch (...)
+		{
+			poco_unexpected();
+		}
+		--_server._currentConnections;
+	}
+
+	void onReadable(ReadableNotification* pNf)
+	{
+		pNf->release();
+		try
+		{
+			int n = _session.receiveAvailable();
+			if (n == 0)
+			{
+				delete this;
+				return;
+			}
+			if (n > 0) _idleSince.update();
+			if (_session.requestBuffered())
+			{
+				_reactor.remove(this);
+				_server.enqueue(this);
+			}
+		}
+		catch (Poco::Exception&)
+		{
+			delete this;
+		}
+	}
+
+	void process()
+		/// Handles the buffered request, and all further
+		/// buffered requests, in blocking mode. Afterwards, gives
+		/// the connection back to the reactor, or deletes it.
+	{
+		bool keepAlive = false;
+		try
+		{
+			_session.socket().setBlocking(true);
+			do
+			{
+				keepAlive = handleRequest();
+			}
+			while (keepAlive && !_server.stopped() && _session.requestBuffered());
+		}
+		catch (NoMessageException&)
+		{
+			keepAlive = false;
+		}
+		catch (Poco::Exception& exc)
+		{
+			keepAlive = false;
+			if (_session.networkException())
+				ErrorHandler::handle(*_session.networkException());
+			else
+				ErrorHandler::handle(exc);
+		}
+		if (keepAlive && !_server.stopped())
+		{
+			try
+			{
+				_session.socket().setBlocking(false);
+				_reactor.add(this);
+				return;
+			}
+			catch (Poco::Exception&)
+			{
+			}
+		}
+		delete this;
+	}
+
+	bool expired(const Timestamp& now) const
+	{
+		return Timespan(now - _idleSince) >= (_firstRequest || _session.buffered() > 0 ? _server._pParams->getTimeout() : _server._pParams->getKeepAliveTimeout());
+	}
+
+	StreamSocket& socket()
+	{
+		return _session.socket();
+	}
+
+	void setRegistered(bool registered)
+	{
+		_registered = registered;
+		if (registered) _idleSince.update();
+	}
+
+private:
+	bool handleRequest()
+		/// Handles a single request, the same way as HTTPServerConnection.
+		/// Returns true if the connection can be kept open.
+	{
+		if (!_session.hasMoreRequests()) return false;
+		_firstRequest = false;
+
+		HTTPServerParams::Ptr pParams = _server._pParams;
+		try
+		{
+			HTTPServerResponseImpl response(_session);
+			HTTPServerRequestImpl request(response, _session, pParams);
+			++_server._totalRequests;
+
+			Poco::Timestamp now;
+			response.setDate(now);
+			response.setVersion(request.getVersion());
+			response.setKeepAlive(pParams->getKeepAlive() && request.getKeepAlive() && _session.canKeepAlive());
+			const std::string& server = pParams->getSoftwareVersion();
+			if (!server.empty())
+				response.set("Server", server);
+			try
+			{
+				std::unique_ptr<HTTPRequestHandler> pHandler(_server._pFactory->createRequestHandler(request));
+				if (pHandler.get())
+				{
+					if (request.getExpectContinue() && response.getStatus() == HTTPResponse::HTTP_OK)
+						response.sendContinue();
+
+					_session.setWriteCoalescing(_session.buffered() > 0 && !hasBody(request));
+					pHandler->handleRequest(request, response);
+					_session.setKeepAlive(pParams->getKeepAlive() && response.getKeepAlive() && _session.canKeepAlive());
+					_session.setWriteCoalescing(false);
+					if (!_session.connected()) return false;
+					if (_session.buffered() == 0 || !_session.getKeepAlive()) _session.flush();
+				}
+				else sendErrorResponse(HTTPResponse::HTTP_NOT_IMPLEMENTED);
+			}
+			catch (Poco::Exception&)
+			{
+				if (!response.sent())
+				{
+					try
+					{
+						sendErrorResponse(HTTPResponse::HTTP_INTERNAL_SERVER_ERROR);
+					}
+					catch (...)
+					{
+					}
+				}
+				throw;
+			}
+		}
+		catch (NoMessageException&)
+		{
+			throw;
+		}
+		catch (MessageException&)
+		{
+			sendErrorResponse(HTTPResponse::HTTP_BAD_REQUEST);
+		}
+		return _session.getKeepAlive();
+	}
+
+	void sendErrorResponse(HTTPResponse::HTTPStatus status)
+	{
+		_session.setWriteCoalescing(false);
+		HTTPServerResponseImpl response(_session);
+		response.setVersion(HTTPMessage::HTTP_1_1);
+		response.setStatusAndReason(status);
+		response.setKeepAlive(false);
+		response.send();
+		_session.setKeepAlive(false);
+	}
+
+	static bool hasBody(const HTTPServerRequest& request)
+	{
+		return request.getChunkedTransferEncoding() || request.getContentLength() > 0;
+	}
+
+	Reactor& _reactor;
+	HTTPReactorServer& _server;
+	HTTPServerSession _session;
+	Timestamp _idleSince;
+	bool _registered;
+	bool _firstRequest;
+};
+
+
+//
+// HTTPReactorServer::Reactor
+//
+
+
+void HTTPReactorServer::Reactor::add(Connection* pConnection)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	_connections.insert(pConnection);
+	pConnection->setRegistered(true);
+	++_pServer->_idleConnections;
+	addEventHandler(pConnection->socket(), Poco::Observer<Connection, ReadableNotification>(*pConnection, &Connection::onReadable));
+	wakeUp();
+}
+
+
+void HTTPReactorServer::Reactor::remove(Connection* pConnection)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (_connections.erase(pConnection))
+	{
+		pConnection->setRegistered(false);
+		--_pServer->_idleConnections;
+		removeEventHandler(pConnection->socket(), Poco::Observer<Connection, ReadableNotification>(*pConnection, &Connection::onReadable));
+	}
+}
+
+
+void HTTPReactorServer::Reactor::sweep()
+{
+	Timestamp now;
+	if (Timespan(now - _lastSweep) < Timespan(1, 0)) return;
+	_lastSweep = now;
+
+	std::vector<Connection*> expired;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		for (ConnectionSet::iterator it = _connections.begin(); it != _connections.end(); ++it)
+		{
+			if ((*it)->expired(now)) expired.push_back(*it);
+		}
+	}
+	// Connections can only be taken away from the reactor by an event
+	// handler running in this thread, so the expired ones are still here.
+	for (std::vector<Connection*>::iterator it = expired.begin(); it != expired.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+
+void HTTPReactorServer::Reactor::onShutdown()
+{
+	SocketReactor::onShutdown();
+
+	std::vector<Connection*> connections;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		connections.assign(_connections.begin(), _connections.end());
+	}
+	for (std::vector<Connection*>::iterator it = connections.begin(); it != connections.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+
+//
+// HTTPReactorServer::Acceptor
+//
+
+
+class HTTPReactorServer::Acceptor: public ParallelSocketAcceptor<Connection, Reactor>
+	/// Accepts connections and distributes them over the reactors.
+{
+public:
+	Acceptor(HTTPReactorServer& server, ServerSocket& socket, SocketReactor& reactor, unsigned threads):
+		ParallelSocketAcceptor<Connection, Reactor>(socket, threads)
+	{
+		for (ReactorVec::iterator it = reactors().begin(); it != reactors().end(); ++it)
+		{
+			(*it)->setServer(&server);
+		}
+		registerAcceptor(reactor);
+	}
+};
+
+
+//
+// HTTPReactorServer::ConnectionNotification
+//
+
+
+class HTTPReactorServer::ConnectionNotification: public Poco::Notification
+{
+public:
+	explicit ConnectionNotification(Connection* pConnection):
+		_pConnection(pConnection)
+	{
+	}
+
+	Connection* connection() const
+	{
+		return _pConnection;
+	}
+
+private:
+	Connection* _pConnection;
+};
+
+
+//
+// HTTPReactorServer
+//
+
+
+HTTPReactorServer::HTTPReactorServer(HTTPRequestHandlerFactory::Ptr pFactory, const ServerSocket& socket, HTTPServerParams::Ptr pParams, unsigned reactors):
+	_pFactory(pFactory),
+	_pParams(pParams),
+	_socket(socket),
+	_reactors(reactors),
+	_workers(pParams->getMaxThreads() > 0 ? pParams->getMaxThreads() : 16),
+	_pAcceptor(0),
+	_threadPool("HTTPReactorServer", _workers, _workers),
+	_worker(*this, &HTTPReactorServer::work),
+	_stopped(true)
+{
+	poco_check_ptr (pFactory);
+	poco_check_ptr (pParams);
+	poco_assert (reactors > 0);
+}
+
+
+HTTPReactorServer::~HTTPReactorServer()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void HTTPReactorServer::start()
+{
+	poco_assert (_stopped);
+
+	_stopped = false;
+	_pAcceptor = new Acceptor(*this, _socket, _acceptReactor, _reactors);
+	for (int i = 0; i < _workers; ++i)
+	{
+		_threadPool.startWithPriority(_pParams->getThreadPriority(), _worker);
+	}
+	_acceptThread.start(_acceptReactor);
+}
+
+
+void HTTPReactorServer::stop()
+{
+	if (_stopped) return;
+
+	_stopped = true;
+	_acceptReactor.stop();
+	_acceptReactor.wakeUp();
+	_acceptThread.join();
+
+	_queue.wakeUpAll();
+	_threadPool.joinAll();
+
+	// stops the reactors, which close all idle connections
+	delete _pAcceptor;
+	_pAcceptor = 0;
+
+	while (Connection* pConnection = dequeue())
+	{
+		delete pConnection;
+	}
+}
+
+
+void HTTPReactorServer::enqueue(Connection* pConnection)
+{
+	if (_queue.size() >= _pParams->getMaxQueued())
+	{
+		++_refusedConnections;
+		delete pConnection;
+	}
+	else _queue.enqueueNotification(new ConnectionNotification(pConnection));
+}
+
+
+HTTPReactorServer::Connection* HTTPReactorServer::dequeue()
+{
+	Poco::AutoPtr<Poco::Notification> pNf(_stopped ? _queue.dequeueNotification() : _queue.waitDequeueNotification(250));
+	ConnectionNotification* pCNf = dynamic_cast<ConnectionNotification*>(pNf.get());
+	return pCNf ? pCNf->connection() : 0;
+}
+
+
+void HTTPReactorServer::work()
+{
+	while (!_stopped)
+	{
+		Connection* pConnection = dequeue();
+		if (pConnection) pConnection->process();
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,261 @@
+//
+// HTTPRequestParser.cpp
+//
+// Library: Net
+// Package: HTTP
+// Module:  HTTPRequestParser
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPRequestParser.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/MessageHeader.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Ascii.h"
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+//
+// HTTPRequestParser::Slice
+//
+
+
+bool HTTPRequestParser::Slice::equals(const char* str) const
+{
+	return std::strlen(str) == _size && std::memcmp(_data, str, _size) == 0;
+}
+
+
+bool HTTPRequestParser::Slice::equalsIgnoreCase(const char* str) const
+{
+	std::size_t i = 0;
+	for (; i < _size && str[i]; ++i)
+	{
+		if (Poco::Ascii::toLower(_data[i]) != Poco::Ascii::toLower(str[i])) return false;
+	}
+	return i == _size && str[i] == 0;
+}
+
+
+//
+// HTTPRequestParser
+//
+
+
+HTTPRequestParser::HTTPRequestParser():
+	_fieldLimit(DFL_FIELD_LIMIT)
+{
+	_fields.reserve(16);
+	reset();
+}
+
+
+HTTPRequestParser::~HTTPRequestParser()
+{
+}
+
+
+void HTTPRequestParser::reset()
+{
+	static const Range empty = {0, 0};
+
+	_pBuffer = 0;
+	_length  = 0;
+	_pos     = 0;
+	_scanned = 0;
+	_state   = STATE_REQUEST_LINE;
+	_method  = empty;
+	_uri     = empty;
+	_version = empty;
+	_fields.clear();
+	_buffer.clear();
+}
+
+
+HTTPRequestParser::Status HTTPRequestParser::parse(const char* buffer, std::size_t length)
+{
+	poco_assert_dbg (length >= _length);
+
+	if (length == 0) throw NoMessageException();
+
+	_pBuffer = buffer;
+	_length  = length;
+	while (_state != STATE_DONE)
+	{
+		const char* pEol = 0;
+		if (_scanned < length)
+			pEol = static_cast<const char*>(std::memchr(buffer + _scanned, '\n', length - _scanned));
+		if (!pEol)
+		{
+			_scanned = length;
+			if (_state == STATE_REQUEST_LINE)
+			{
+				if (length - _pos > MAX_METHOD_LENGTH + MAX_URI_LENGTH + MAX_VERSION_LENGTH + 4)
+					throw MessageException("HTTP request line too long");
+			}
+			else if (length - _pos > MAX_NAME_LENGTH + MAX_VALUE_LENGTH + 4)
+				throw MessageException("Field name or value too long/no CRLF found");
+			return PARSE_INCOMPLETE;
+		}
+
+		std::size_t eol = pEol - buffer;
+		if (_state == STATE_REQUEST_LINE)
+		{
+			parseRequestLine(_pos, eol);
+		}
+		else if (buffer[_pos] == '\r' || buffer[_pos] == '\n')
+		{
+			_state = STATE_DONE;
+		}
+		else
+		{
+			// A line starting with a space or tab continues
+			// the current field value, so we need to see the
+			// first character of the next line.
+			if (eol + 1 == length)
+			{
+				_scanned = eol;
+				return PARSE_INCOMPLETE;
+			}
+			if (buffer[eol + 1] == ' ' || buffer[eol + 1] == '\t')
+			{
+				_scanned = eol + 1;
+				continue;
+			}
+			parseField(_pos, eol);
+		}
+		_pos = eol + 1;
+		_scanned = _pos;
+	}
+	return PARSE_COMPLETE;
+}
+
+
+HTTPRequestParser::Status HTTPRequestParser::feed(const char* buffer, std::size_t length)
+{
+	_buffer.insert(_buffer.end(), buffer, buffer + length);
+	return parse(_buffer.empty() ? 0 : &_buffer[0], _buffer.size());
+}
+
+
+HTTPRequestParser::Slice HTTPRequestParser::remaining() const
+{
+	if (_state == STATE_DONE)
+		return Slice(_pBuffer + _pos, _length - _pos);
+	else
+		return Slice();
+}
+
+
+HTTPRequestParser::Slice HTTPRequestParser::find(const char* name) const
+{
+	for (std::vector<Field>::const_iterator it = _fields.begin(); it != _fields.end(); ++it)
+	{
+		if (slice(it->name).equalsIgnoreCase(name)) return slice(it->value);
+	}
+	return Slice();
+}
+
+
+void HTTPRequestParser::apply(HTTPRequest& request) const
+{
+	poco_assert (_state == STATE_DONE);
+
+	request.setMethod(method().toString());
+	request.setURI(uri().toString());
+	request.setVersion(version().toString());
+
+	std::string name;
+	std::string value;
+	for (std::vector<Field>::const_iterator it = _fields.begin(); it != _fields.end(); ++it)
+	{
+		Slice n = slice(it->name);
+		Slice v = slice(it->value);
+		name.assign(n.data(), n.size());
+		if (it->folded)
+		{
+			value.clear();
+			for (const char* p = v.data(); p != v.data() + v.size(); ++p)
+			{
+				if (*p != '\r' && *p != '\n') value += *p;
+			}
+		}
+		else value.assign(v.data(), v.size());
+
+		if (value.find("=?") != std::string::npos)
+			request.add(name, MessageHeader::decodeWord(value));
+		else
+			request.add(name, value);
+	}
+}
+
+
+void HTTPRequestParser::parseRequestLine(std::size_t begin, std::size_t end)
+{
+	const char* p = _pBuffer + begin;
+	const char* e = _pBuffer + end;
+
+	while (p != e && Poco::Ascii::isSpace(*p)) ++p;
+	if (p == e) return; // empty lines before the request line are ignored
+
+	const char* pMethod = p;
+	while (p != e && !Poco::Ascii::isSpace(*p)) ++p;
+	if (p == e || p - pMethod > MAX_METHOD_LENGTH) throw MessageException("HTTP request method invalid or too long");
+	_method.offset = pMethod - _pBuffer;
+	_method.length = p - pMethod;
+
+	while (p != e && Poco::Ascii::isSpace(*p)) ++p;
+	const char* pURI = p;
+	while (p != e && !Poco::Ascii::isSpace(*p)) ++p;
+	if (p == e || p == pURI || p - pURI > MAX_URI_LENGTH) throw MessageException("HTTP request URI invalid or too long");
+	_uri.offset = pURI - _pBuffer;
+	_uri.length = p - pURI;
+
+	while (p != e && Poco::Ascii::isSpace(*p)) ++p;
+	const char* pVersion = p;
+	while (p != e && !Poco::Ascii::isSpace(*p)) ++p;
+	if (p == pVersion || p - pVersion > MAX_VERSION_LENGTH) throw MessageException("Invalid HTTP version string");
+	_version.offset = pVersion - _pBuffer;
+	_version.length = p - pVersion;
+
+	_state = STATE_FIELDS;
+}
+
+
+void HTTPRequestParser::parseField(std::size_t begin, std::size_t end)
+{
+	const char* p = _pBuffer + begin;
+	const char* e = _pBuffer + end;
+
+	const char* pName = p;
+	while (p != e && *p != ':' && p - pName < MAX_NAME_LENGTH) ++p;
+	if (p == e) return; // ignore invalid header lines
+	if (*p != ':') throw MessageException("Field name too long/no colon found");
+	if (_fieldLimit > 0 && _fields.size() == static_cast<std::size_t>(_fieldLimit))
+		throw MessageException("Too many header fields");
+
+	Field field;
+	field.name.offset = pName - _pBuffer;
+	field.name.length = p - pName;
+	++p;
+	while (p != e && Poco::Ascii::isSpace(*p) && *p != '\r' && *p != '\n') ++p;
+	const char* pValue = p;
+	while (e != pValue && Poco::Ascii::isSpace(*(e - 1))) --e;
+	if (e - pValue > MAX_VALUE_LENGTH) throw MessageException("Field value too long/no CRLF found");
+	field.value.offset = pValue - _pBuffer;
+	field.value.length = e - pValue;
+	field.folded = std::memchr(pValue, '\n', e - pValue) != 0;
+	_fields.push_back(field);
+}
+
+
+} } // namespace Poco::Net
@@ -16,12 +16,16 @@
 #include "Poco/Net/HTTPServerSession.h"
 #include "Poco/Net/HTTPServerRequestImpl.h"
 #include "Poco/Net/HTTPServerResponseImpl.h"
+#include "Poco/Net/HTTP2ServerConnection.h"
 #include "Poco/Net/HTTPRequestHandler.h"
 #include "Poco/Net/HTTPRequestHandlerFactory.h"
 #include "Poco/Net/NetException.h"
+#include "Poco/Net/ServerMetrics.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/Timestamp.h"
+#include "Poco/Clock.h"
 #include "Poco/Delegate.h"
+#include "Poco/Buffer.h"
 #include <memory>
 
 
@@ -29,6 +33,80 @@ namespace Poco {
 namespace Net {
 
 
+namespace
+{
+	class ByteCounter
+		/// Adds the bytes sent and received by a
+		/// session to the ServerMetrics.
+	{
+	public:
+		ByteCounter(ServerMetrics* pMetrics, const HTTPSession& session):
+			_pMetrics(pMetrics),
+			_session(session),
+			_received(0),
+			_sent(0)
+		{
+		}
+
+		~ByteCounter()
+		{
+			update();
+		}
+
+		void update()
+		{
+			if (_pMetrics)
+			{
+				Poco::UInt64 received = _session.bytesReceived();
+				Poco::UInt64 sent = _session.bytesSent();
+				_pMetrics->bytesReceived().add(received - _received);
+				_pMetrics->bytesSent().add(sent - _sent);
+				_received = received;
+				_sent = sent;
+			}
+		}
+
+	private:
+		ServerMetrics* _pMetrics;
+		const HTTPSession& _session;
+		Poco::UInt64 _received;
+		Poco::UInt64 _sent;
+	};
+
+	class WriteTimer
+		/// Records the time from start() until the WriteTimer
+		/// is destroyed, which happens after the response
+		/// has been destroyed and thus completely sent.
+	{
+	public:
+		WriteTimer(ServerMetrics* pMetrics):
+			_pMetrics(pMetrics),
+			_started(false)
+		{
+		}
+
+		~WriteTimer()
+		{
+			if (_started) _pMetrics->writeTime().record(static_cast<Poco::UInt64>(_start.elapsed()));
+		}
+
+		void start()
+		{
+			if (_pMetrics)
+			{
+				_start.update();
+				_started = true;
+			}
+		}
+
+	private:
+		ServerMetrics* _pMetrics;
+		Poco::Clock _start;
+		bool _started;
+	};
+}
+
+
 HTTPServerConnection::HTTPServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory):
 	TCPServerConnection(socket),
 	_pParams(pParams),
@@ -58,16 +136,37 @@ void HTTPServerConnection::run()
 {
 	std::string server = _pParams->getSoftwareVersion();
 	HTTPServerSession session(socket(), _pParams);
-	while (!_stopped && session.hasMoreRequests())
+	ServerMetrics::Ptr pMetrics = _pParams->getMetrics();
+	ByteCounter byteCounter(pMetrics, session);
+	std::unique_ptr<HTTP2ServerConnection> pHTTP2;
+	if (_pParams->getHTTP2Enabled() && socket().secure() && socket().getALPNProtocol() == "h2")
+	{
+		pHTTP2.reset(new HTTP2ServerConnection(socket(), _pParams, _pFactory));
+	}
+	bool firstRequest = true;
+	while (!pHTTP2 && !_stopped && session.hasMoreRequests())
 	{
 		try
 		{
 			Poco::FastMutex::ScopedLock lock(_mutex);
 			if (!_stopped)
 			{
+				WriteTimer writeTimer(pMetrics);
 				HTTPServerResponseImpl response(session);
 				HTTPServerRequestImpl request(response, session, _pParams);
-			
+				if (_pParams->getHTTP2Enabled() && firstRequest)
+				{
+					pHTTP2 = switchToHTTP2(session, request, response);
+					if (pHTTP2) break;
+				}
+				if (pMetrics)
+				{
+					pMetrics->parseTime().record(static_cast<Poco::UInt64>(session.requestStarted().elapsed()));
+					pMetrics->requests().add();
+					if (!firstRequest) pMetrics->keepAliveRequests().add();
+				}
+				firstRequest = false;
+
 				Poco::Timestamp now;
 				response.setDate(now);
 				response.setVersion(request.getVersion());
@@ -81,9 +180,19 @@ void HTTPServerConnection::run()
 					{
 						if (request.getExpectContinue() && response.getStatus() == HTTPResponse::HTTP_OK)
 							response.sendContinue();
-					
+
+						// If the client has pipelined further requests, the response
+						// is held back so that it can be sent together with the
+						// responses to these requests. Requests with a body are not
+						// coalesced, as their handlers may stream their responses.
+						session.setWriteCoalescing(session.buffered() > 0 && !hasBody(request));
+						Poco::Clock handlerStart;
 						pHandler->handleRequest(request, response);
+						if (pMetrics) pMetrics->handlerTime().record(static_cast<Poco::UInt64>(handlerStart.elapsed()));
+						writeTimer.start();
 						session.setKeepAlive(_pParams->getKeepAlive() && response.getKeepAlive() && session.canKeepAlive());
+						session.setWriteCoalescing(false);
+						if (session.buffered() == 0 || !session.getKeepAlive()) session.flush();
 					}
 					else sendErrorResponse(session, HTTPResponse::HTTP_NOT_IMPLEMENTED);
 				}
@@ -102,6 +211,7 @@ void HTTPServerConnection::run()
 					throw;
 				}
 			}
+			byteCounter.update();
 		}
 		catch (NoMessageException&)
 		{
@@ -120,11 +230,54 @@ void HTTPServerConnection::run()
 			else throw;
 		}
 	}
+	if (pHTTP2) pHTTP2->run();
+}
+
+
+std::unique_ptr<HTTP2ServerConnection> HTTPServerConnection::switchToHTTP2(HTTPServerSession& session, HTTPServerRequestImpl& request, HTTPServerResponseImpl& response)
+{
+	std::unique_ptr<HTTP2ServerConnection> pHTTP2;
+	if (HTTP2ServerConnection::isPreface(request))
+	{
+		// The request line and the empty line following it are the
+		// start of the connection preface, which HTTP2ServerConnection
+		// must receive in full.
+		pHTTP2.reset(new HTTP2ServerConnection(socket(), _pParams, _pFactory));
+		Poco::Buffer<char> buffer(0);
+		session.drainBuffer(buffer);
+		std::string received("PRI * HTTP/2.0\r\n\r\n");
+		received.append(buffer.begin(), buffer.size());
+		pHTTP2->setReceived(received.data(), received.size());
+	}
+	else if (HTTP2ServerConnection::isUpgrade(request) && !socket().secure() && !hasBody(request))
+	{
+		pHTTP2.reset(new HTTP2ServerConnection(socket(), _pParams, _pFactory));
+		if (pHTTP2->upgrade(request))
+		{
+			response.setVersion(HTTPMessage::HTTP_1_1);
+			response.setStatusAndReason(HTTPResponse::HTTP_SWITCHING_PROTOCOLS);
+			response.set("Upgrade", "h2c");
+			response.set("Connection", "Upgrade");
+			response.send().flush();
+			Poco::Buffer<char> buffer(0);
+			session.drainBuffer(buffer);
+			pHTTP2->setReceived(buffer.begin(), buffer.size());
+		}
+		else pHTTP2.reset();
+	}
+	return pHTTP2;
+}
+
+
+bool HTTPServerConnection::hasBody(const HTTPServerRequest& request)
+{
+	return request.getChunkedTransferEncoding() || request.getContentLength() > 0;
 }
 
 
 void HTTPServerConnection::sendErrorResponse(HTTPServerSession& session, HTTPResponse::HTTPStatus status)
 {
+	session.setWriteCoalescing(false);
 	HTTPServerResponseImpl response(session);
 	response.setVersion(HTTPMessage::HTTP_1_1);
 	response.setStatusAndReason(status);
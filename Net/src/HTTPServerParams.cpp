@@ -13,6 +13,7 @@
 
 
 #include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPBufferAllocator.h"
 
 
 namespace Poco {
@@ -23,7 +24,10 @@ HTTPServerParams::HTTPServerParams():
 	_timeout(60000000),
 	_keepAlive(true),
 	_maxKeepAliveRequests(0),
-	_keepAliveTimeout(15000000)
+	_keepAliveTimeout(15000000),
+	_bufferSize(HTTPBufferAllocator::BUFFER_SIZE),
+	_http2Enabled(false),
+	_http2MaxConcurrentStreams(100)
 {
 }
 
@@ -68,6 +72,26 @@ void HTTPServerParams::setMaxKeepAliveRequests(int maxKeepAliveRequests)
 	poco_assert (maxKeepAliveRequests >= 0);
 	_maxKeepAliveRequests = maxKeepAliveRequests;
 }
+
+
+void HTTPServerParams::setBufferSize(int size)
+{
+	poco_assert (size > 0);
+	_bufferSize = size;
+}
+
+
+void HTTPServerParams::setHTTP2Enabled(bool enabled)
+{
+	_http2Enabled = enabled;
+}
+
+
+void HTTPServerParams::setHTTP2MaxConcurrentStreams(int maxStreams)
+{
+	poco_assert (maxStreams > 0);
+	_http2MaxConcurrentStreams = maxStreams;
+}
 	
 
 } } // namespace Poco::Net
@@ -22,6 +22,8 @@
 #include "Poco/File.h"
 #include "Poco/Timestamp.h"
 #include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/String.h"
 #include "Poco/StreamCopier.h"
 #include "Poco/CountingStream.h"
 #include "Poco/Exception.h"
@@ -33,6 +35,7 @@
 using Poco::File;
 using Poco::Timestamp;
 using Poco::NumberFormatter;
+using Poco::NumberParser;
 using Poco::StreamCopier;
 using Poco::OpenFileException;
 using Poco::DateTimeFormatter;
@@ -105,6 +108,60 @@ std::ostream& HTTPServerResponseImpl::send()
 }
 
 
+namespace
+{
+	enum RangeResult
+	{
+		RANGE_NONE,
+		RANGE_SATISFIABLE,
+		RANGE_UNSATISFIABLE
+	};
+
+	RangeResult parseRange(const std::string& range, File::FileSize length, File::FileSize& first, File::FileSize& last)
+		/// Parses a Range header containing a single byte range.
+		/// Multiple ranges, and anything not understood, are
+		/// ignored, so the complete file is sent (RFC 7233, 3.1).
+	{
+#if defined(POCO_HAVE_INT64)
+		static const std::string BYTES("bytes=");
+
+		if (range.size() <= BYTES.size() || Poco::icompare(range, 0, BYTES.size(), BYTES) != 0) return RANGE_NONE;
+		std::string spec = Poco::trim(range.substr(BYTES.size()));
+		if (spec.find(',') != std::string::npos) return RANGE_NONE;
+		std::string::size_type pos = spec.find('-');
+		if (pos == std::string::npos) return RANGE_NONE;
+		std::string from = Poco::trim(spec.substr(0, pos));
+		std::string to = Poco::trim(spec.substr(pos + 1));
+
+		Poco::UInt64 value;
+		if (from.empty())
+		{
+			// suffix range: the last n bytes
+			if (!NumberParser::tryParseUnsigned64(to, value)) return RANGE_NONE;
+			if (value == 0 || length == 0) return RANGE_UNSATISFIABLE;
+			first = value >= length ? 0 : length - value;
+			last  = length - 1;
+		}
+		else
+		{
+			if (!NumberParser::tryParseUnsigned64(from, value)) return RANGE_NONE;
+			if (value >= length) return RANGE_UNSATISFIABLE;
+			first = value;
+			last  = length - 1;
+			if (!to.empty())
+			{
+				if (!NumberParser::tryParseUnsigned64(to, value) || value < first) return RANGE_NONE;
+				if (value < last) last = value;
+			}
+		}
+		return RANGE_SATISFIABLE;
+#else
+		return RANGE_NONE;
+#endif
+	}
+}
+
+
 void HTTPServerResponseImpl::sendFile(const std::string& path, const std::string& mediaType)
 {
 	poco_assert (!_pStream);
@@ -112,23 +169,67 @@ void HTTPServerResponseImpl::sendFile(const std::string& path, const std::string
 	File f(path);
 	Timestamp dateTime    = f.getLastModified();
 	File::FileSize length = f.getSize();
-	set("Last-Modified", DateTimeFormatter::format(dateTime, DateTimeFormat::HTTP_FORMAT));
+	std::string lastModified = DateTimeFormatter::format(dateTime, DateTimeFormat::HTTP_FORMAT);
+	set("Last-Modified", lastModified);
+	set("Accept-Ranges", "bytes");
+	setContentType(mediaType);
+	setChunkedTransferEncoding(false);
+
+	File::FileSize offset = 0;
+	File::FileSize count  = length;
+	if (_pRequest && getStatus() == HTTP_OK && _pRequest->has("Range"))
+	{
+		// If-Range with a validator other than the current
+		// Last-Modified date means the full file must be sent.
+		const std::string& ifRange = _pRequest->get("If-Range", lastModified);
+		File::FileSize first;
+		File::FileSize last;
+		RangeResult result = ifRange == lastModified ? parseRange(_pRequest->get("Range"), length, first, last) : RANGE_NONE;
+		if (result == RANGE_SATISFIABLE)
+		{
+			setStatusAndReason(HTTP_PARTIAL_CONTENT);
+			set("Content-Range", "bytes " + NumberFormatter::format(first) + "-" + NumberFormatter::format(last) + "/" + NumberFormatter::format(length));
+			offset = first;
+			count  = last - first + 1;
+		}
+		else if (result == RANGE_UNSATISFIABLE)
+		{
+			setStatusAndReason(HTTP_REQUESTED_RANGE_NOT_SATISFIABLE);
+			set("Content-Range", "bytes */" + NumberFormatter::format(length));
+			count = 0;
+		}
+	}
 #if defined(POCO_HAVE_INT64)	
-	setContentLength64(length);
+	setContentLength64(count);
 #else
-	setContentLength(static_cast<int>(length));
+	setContentLength(static_cast<int>(count));
 #endif
-	setContentType(mediaType);
-	setChunkedTransferEncoding(false);
 
 	Poco::FileInputStream istr(path);
 	if (istr.good())
 	{
 		_pStream = new HTTPHeaderOutputStream(_session);
 		write(*_pStream);
-		if (_pRequest && _pRequest->getMethod() != HTTPRequest::HTTP_HEAD)
+		if (_pRequest && _pRequest->getMethod() != HTTPRequest::HTTP_HEAD && count > 0)
 		{
-			StreamCopier::copyStream(istr, *_pStream);
+			// The header must be on the wire before the socket sends
+			// the file content directly, bypassing the stream buffer.
+			// StreamSocket::sendFile() falls back to copying for sockets
+			// that must process the data, like a SecureStreamSocket
+			// not using kernel TLS.
+			// sendFile() may send less than requested, e.g. if
+			// a system call is interrupted.
+			_pStream->flush();
+			std::streamsize remaining = static_cast<std::streamsize>(count);
+			std::streamoff  position  = static_cast<std::streamoff>(offset);
+			while (remaining > 0)
+			{
+				std::streamsize n = _session.sendFile(istr, position, remaining);
+				// the file has been truncated since its size was determined
+				if (n <= 0) throw ReadFileException("Cannot send complete file", path);
+				remaining -= n;
+				position  += n;
+			}
 		}
 	}
 	else throw OpenFileException(path);
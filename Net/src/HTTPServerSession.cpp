@@ -13,6 +13,9 @@
 
 
 #include "Poco/Net/HTTPServerSession.h"
+#include "Poco/Net/HTTPBufferAllocator.h"
+#include "Poco/Net/NetException.h"
+#include <cstring>
 
 
 namespace Poco {
@@ -26,6 +29,7 @@ HTTPServerSession::HTTPServerSession(const StreamSocket& socket, HTTPServerParam
 	_maxKeepAliveRequests(pParams->getMaxKeepAliveRequests())
 {
 	setTimeout(pParams->getTimeout());
+	setBufferSize(pParams->getBufferSize());
 	this->socket().setReceiveTimeout(pParams->getTimeout());
 }
 
@@ -43,7 +47,7 @@ bool HTTPServerSession::hasMoreRequests()
 	{
 		_firstRequest = false;
 		--_maxKeepAliveRequests;
-		return socket().poll(getTimeout(), Socket::SELECT_READ);
+		return buffered() > 0 || socket().poll(getTimeout(), Socket::SELECT_READ);
 	}
 	else if (_maxKeepAliveRequests != 0 && getKeepAlive())
 	{
@@ -55,6 +59,101 @@ bool HTTPServerSession::hasMoreRequests()
 }
 
 
+const HTTPRequestParser& HTTPServerSession::receiveRequest(int fieldLimit)
+{
+	_parser.reset();
+	_parser.setFieldLimit(fieldLimit);
+
+	if (_pCurrent == _pEnd) refill();
+	_requestStarted.update();
+	if (_parser.parse(_pCurrent, _pEnd - _pCurrent) == HTTPRequestParser::PARSE_COMPLETE)
+	{
+		_pCurrent += _parser.consumed();
+		return _parser;
+	}
+
+	// The header is incomplete. Move the partial header to the
+	// start of the buffer and append the following data.
+	std::size_t n = _pEnd - _pCurrent;
+	if (_pCurrent != _pBuffer)
+	{
+		std::memmove(_pBuffer, _pCurrent, n);
+		_pCurrent = _pBuffer;
+		_pEnd = _pBuffer + n;
+	}
+	char* pBufferEnd = _pBuffer + getBufferSize();
+	while (_pEnd < pBufferEnd)
+	{
+		int rc = receive(_pEnd, static_cast<int>(pBufferEnd - _pEnd));
+		if (rc <= 0) throw MessageException("Incomplete HTTP request header");
+		_pEnd += rc;
+		if (_parser.parse(_pCurrent, _pEnd - _pCurrent) == HTTPRequestParser::PARSE_COMPLETE)
+		{
+			_pCurrent += _parser.consumed();
+			return _parser;
+		}
+	}
+
+	// The header does not fit into the buffer, so the parser
+	// has to collect it in its own buffer.
+	_parser.feed(_pCurrent, _pEnd - _pCurrent);
+	for (;;)
+	{
+		int rc = receive(_pBuffer, getBufferSize());
+		if (rc <= 0) throw MessageException("Incomplete HTTP request header");
+		if (_parser.feed(_pBuffer, rc) == HTTPRequestParser::PARSE_COMPLETE)
+		{
+			// anything after the header is at most one buffer full
+			HTTPRequestParser::Slice rest = _parser.remaining();
+			std::memcpy(_pBuffer, rest.data(), rest.size());
+			_pCurrent = _pBuffer;
+			_pEnd = _pBuffer + rest.size();
+			return _parser;
+		}
+	}
+}
+
+
+int HTTPServerSession::receiveAvailable()
+{
+	if (!_pBuffer)
+	{
+		_pBuffer = HTTPBufferAllocator::allocate(getBufferSize());
+		_pCurrent = _pEnd = _pBuffer;
+	}
+	else if (_pCurrent != _pBuffer)
+	{
+		std::size_t n = _pEnd - _pCurrent;
+		std::memmove(_pBuffer, _pCurrent, n);
+		_pCurrent = _pBuffer;
+		_pEnd = _pBuffer + n;
+	}
+	int space = static_cast<int>(_pBuffer + getBufferSize() - _pEnd);
+	poco_assert (space > 0);
+
+	int rc = receive(_pEnd, space);
+	if (rc > 0) _pEnd += rc;
+	return rc;
+}
+
+
+bool HTTPServerSession::requestBuffered()
+{
+	if (_pCurrent == _pEnd) return false;
+	if (_pCurrent == _pBuffer && _pEnd == _pBuffer + getBufferSize()) return true;
+
+	_parser.reset();
+	try
+	{
+		return _parser.parse(_pCurrent, _pEnd - _pCurrent) == HTTPRequestParser::PARSE_COMPLETE;
+	}
+	catch (MessageException&)
+	{
+		return true;
+	}
+}
+
+
 SocketAddress HTTPServerSession::clientAddress()
 {
 	return socket().peerAddress();
@@ -15,6 +15,7 @@
 #include "Poco/Net/HTTPSession.h"
 #include "Poco/Net/HTTPBufferAllocator.h"
 #include "Poco/Net/NetException.h"
+#include <algorithm>
 #include <cstring>
 
 
@@ -29,11 +30,15 @@ HTTPSession::HTTPSession():
 	_pBuffer(0),
 	_pCurrent(0),
 	_pEnd(0),
+	_bufferSize(HTTPBufferAllocator::BUFFER_SIZE),
 	_keepAlive(false),
 	_connectionTimeout(HTTP_DEFAULT_CONNECTION_TIMEOUT),
 	_receiveTimeout(HTTP_DEFAULT_TIMEOUT),
 	_sendTimeout(HTTP_DEFAULT_TIMEOUT),
-	_pException(0)
+	_pException(0),
+	_coalesce(false),
+	_bytesReceived(0),
+	_bytesSent(0)
 {
 }
 
@@ -43,11 +48,15 @@ HTTPSession::HTTPSession(const StreamSocket& socket):
 	_pBuffer(0),
 	_pCurrent(0),
 	_pEnd(0),
+	_bufferSize(HTTPBufferAllocator::BUFFER_SIZE),
 	_keepAlive(false),
 	_connectionTimeout(HTTP_DEFAULT_CONNECTION_TIMEOUT),
 	_receiveTimeout(HTTP_DEFAULT_TIMEOUT),
 	_sendTimeout(HTTP_DEFAULT_TIMEOUT),
-	_pException(0)
+	_pException(0),
+	_coalesce(false),
+	_bytesReceived(0),
+	_bytesSent(0)
 {
 }
 
@@ -57,11 +66,15 @@ HTTPSession::HTTPSession(const StreamSocket& socket, bool keepAlive):
 	_pBuffer(0),
 	_pCurrent(0),
 	_pEnd(0),
+	_bufferSize(HTTPBufferAllocator::BUFFER_SIZE),
 	_keepAlive(keepAlive),
 	_connectionTimeout(HTTP_DEFAULT_CONNECTION_TIMEOUT),
 	_receiveTimeout(HTTP_DEFAULT_TIMEOUT),
 	_sendTimeout(HTTP_DEFAULT_TIMEOUT),
-	_pException(0)
+	_pException(0),
+	_coalesce(false),
+	_bytesReceived(0),
+	_bytesSent(0)
 {
 }
 
@@ -70,13 +83,20 @@ HTTPSession::~HTTPSession()
 {
 	try
 	{
-		if (_pBuffer) HTTPBufferAllocator::deallocate(_pBuffer, HTTPBufferAllocator::BUFFER_SIZE);
+		if (_pBuffer) HTTPBufferAllocator::deallocate(_pBuffer, _bufferSize);
 	}
 	catch (...)
 	{
 		poco_unexpected();
 	}
 	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+	}
+	try
 	{
 		close();
 	}
@@ -146,9 +166,68 @@ int HTTPSession::read(char* buffer, std::streamsize length)
 
 int HTTPSession::write(const char* buffer, std::streamsize length)
 {
+	if (!_coalesce && _writeBuffer.empty())
+	{
+		try
+		{
+			int rc = _socket.sendBytes(buffer, (int) length);
+			if (rc > 0) _bytesSent += rc;
+			return rc;
+		}
+		catch (Poco::Exception& exc)
+		{
+			setException(exc);
+			throw;
+		}
+	}
+	SocketBuf buf = Socket::makeBuffer(buffer, static_cast<std::size_t>(length));
+	return write(&buf, 1);
+}
+
+
+int HTTPSession::write(const SocketBufVec& buffers)
+{
+	return write(buffers.empty() ? 0 : &buffers[0], buffers.size());
+}
+
+
+int HTTPSession::write(const SocketBuf* pBuffers, std::size_t count)
+{
+	std::size_t length = 0;
+	for (std::size_t i = 0; i < count; i++)
+	{
+		length += Socket::bufferSize(pBuffers[i]);
+	}
+	if (_coalesce || !_writeBuffer.empty())
+	{
+		if (_writeBuffer.size() + length <= MAX_WRITE_BUFFER_SIZE)
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				_writeBuffer.append(Socket::bufferData(pBuffers[i]), Socket::bufferSize(pBuffers[i]));
+			}
+			if (!_coalesce) flush();
+			return static_cast<int>(length);
+		}
+	}
+
+	// send any collected data together with the new data
+	SocketBufVec buffers;
+	buffers.reserve(count + 1);
+	if (!_writeBuffer.empty())
+		buffers.push_back(Socket::makeBuffer(_writeBuffer.data(), _writeBuffer.size()));
+	buffers.insert(buffers.end(), pBuffers, pBuffers + count);
 	try
 	{
-		return _socket.sendBytes(buffer, (int) length);
+		int rc = _socket.sendBytes(buffers);
+		if (rc > 0)
+		{
+			_bytesSent += rc;
+			std::size_t pending = std::min(_writeBuffer.size(), static_cast<std::size_t>(rc));
+			_writeBuffer.erase(0, pending);
+			rc -= static_cast<int>(pending);
+		}
+		return rc;
 	}
 	catch (Poco::Exception& exc)
 	{
@@ -160,9 +239,13 @@ int HTTPSession::write(const char* buffer, std::streamsize length)
 
 int HTTPSession::receive(char* buffer, int length)
 {
+	// the peer may wait for our response before sending more
+	if (!_writeBuffer.empty()) flush();
 	try
 	{
-		return _socket.receiveBytes(buffer, length);
+		int rc = _socket.receiveBytes(buffer, length);
+		if (rc > 0) _bytesReceived += rc;
+		return rc;
 	}
 	catch (Poco::Exception& exc)
 	{
@@ -176,10 +259,10 @@ void HTTPSession::refill()
 {
 	if (!_pBuffer)
 	{
-		_pBuffer = HTTPBufferAllocator::allocate(HTTPBufferAllocator::BUFFER_SIZE);
+		_pBuffer = HTTPBufferAllocator::allocate(_bufferSize);
 	}
 	_pCurrent = _pEnd = _pBuffer;
-	int n = receive(_pBuffer, HTTPBufferAllocator::BUFFER_SIZE);
+	int n = receive(_pBuffer, _bufferSize);
 	_pEnd += n;
 }
 
@@ -236,8 +319,76 @@ void HTTPSession::clearException()
 }
 
 
+void HTTPSession::setWriteCoalescing(bool coalesce)
+{
+	_coalesce = coalesce;
+}
+
+
+void HTTPSession::flush()
+{
+	if (!_writeBuffer.empty())
+	{
+		std::string buffer;
+		buffer.swap(_writeBuffer);
+		try
+		{
+			int rc = _socket.sendBytes(buffer.data(), static_cast<int>(buffer.size()));
+			if (rc > 0) _bytesSent += rc;
+		}
+		catch (Poco::Exception& exc)
+		{
+			setException(exc);
+			throw;
+		}
+		// keep the buffer's memory for the next batch
+		buffer.clear();
+		_writeBuffer.swap(buffer);
+	}
+}
+
+
+void HTTPSession::setBufferSize(int size)
+{
+	poco_assert (size > 0);
+
+	if (size == _bufferSize) return;
+	if (_pBuffer)
+	{
+		int n = buffered();
+		if (n > size) throw Poco::IllegalStateException("Buffered data does not fit into new buffer");
+		char* pBuffer = HTTPBufferAllocator::allocate(size);
+		std::memcpy(pBuffer, _pCurrent, n);
+		HTTPBufferAllocator::deallocate(_pBuffer, _bufferSize);
+		_pBuffer = pBuffer;
+		_pCurrent = pBuffer;
+		_pEnd = pBuffer + n;
+	}
+	_bufferSize = size;
+}
+
+
+std::streamsize HTTPSession::sendFile(Poco::FileInputStream& fileInputStream, std::streamoff offset, std::streamsize count)
+{
+	flush();
+	try
+	{
+		std::streamsize n = _socket.sendFile(fileInputStream, offset, count);
+		if (n > 0) _bytesSent += n;
+		return n;
+	}
+	catch (Poco::Exception& exc)
+	{
+		setException(exc);
+		throw;
+	}
+}
+
+
 StreamSocket HTTPSession::detachSocket()
 {
+	flush();
+
 	StreamSocket oldSocket(_socket);
 	StreamSocket newSocket;
 	_socket = newSocket;
@@ -59,6 +59,14 @@ HTTPStreamFactory::HTTPStreamFactory(const std::string& proxyHost, Poco::UInt16
 }
 
 
+HTTPStreamFactory::HTTPStreamFactory(HTTPClientSessionPool::Ptr pPool):
+	_pPool(pPool),
+	_proxyPort(HTTPSession::HTTP_PORT)
+{
+	poco_check_ptr (pPool);
+}
+
+
 HTTPStreamFactory::~HTTPStreamFactory()
 {
 }
@@ -83,24 +91,7 @@ std::istream* HTTPStreamFactory::open(const URI& uri)
 		{
 			if (!pSession)
 			{
-				pSession = new HTTPClientSession(resolvedURI.getHost(), resolvedURI.getPort());
-			
-				if (proxyUri.empty())
-				{
-					if (!_proxyHost.empty())
-					{
-						pSession->setProxy(_proxyHost, _proxyPort);
-						pSession->setProxyCredentials(_proxyUsername, _proxyPassword);
-					}
-				}
-				else
-				{
-					pSession->setProxy(proxyUri.getHost(), proxyUri.getPort());
-					if (!_proxyUsername.empty())
-					{
-						pSession->setProxyCredentials(_proxyUsername, _proxyPassword);
-					}
-				}
+				pSession = createSession(resolvedURI, proxyUri);
 			}
 						
 			std::string path = resolvedURI.getPathAndQuery();
@@ -137,7 +128,10 @@ std::istream* HTTPStreamFactory::open(const URI& uri)
 			}
 			else if (res.getStatus() == HTTPResponse::HTTP_OK)
 			{
-				return new HTTPResponseStream(rs, pSession);
+				if (_pPool && _pPool->owns(pSession))
+					return new HTTPResponseStream(rs, pSession, _pPool);
+				else
+					return new HTTPResponseStream(rs, pSession);
 			}
 			else if (res.getStatus() == HTTPResponse::HTTP_USE_PROXY && !retry)
 			{
@@ -147,7 +141,7 @@ std::istream* HTTPStreamFactory::open(const URI& uri)
 				// single request via the proxy. 305 responses MUST only be generated by origin servers.
 				// only use for one single request!
 				proxyUri.resolve(res.get("Location"));
-				delete pSession;
+				deleteSession(pSession);
 				pSession = 0;
 				retry = true; // only allow useproxy once
 			}
@@ -165,18 +159,62 @@ std::istream* HTTPStreamFactory::open(const URI& uri)
 	}
 	catch (...)
 	{
-		delete pSession;
+		if (pSession) deleteSession(pSession);
 		throw;
 	}
 }
 
 
+HTTPClientSession* HTTPStreamFactory::createSession(const URI& uri, const URI& proxyUri)
+{
+	if (_pPool && proxyUri.empty())
+	{
+		return _pPool->acquire(uri.getScheme(), uri.getHost(), uri.getPort());
+	}
+
+	HTTPClientSession* pSession = new HTTPClientSession(uri.getHost(), uri.getPort());
+	if (proxyUri.empty())
+	{
+		if (!_proxyHost.empty())
+		{
+			pSession->setProxy(_proxyHost, _proxyPort);
+			pSession->setProxyCredentials(_proxyUsername, _proxyPassword);
+		}
+	}
+	else
+	{
+		pSession->setProxy(proxyUri.getHost(), proxyUri.getPort());
+		if (!_proxyUsername.empty())
+		{
+			pSession->setProxyCredentials(_proxyUsername, _proxyPassword);
+		}
+	}
+	return pSession;
+}
+
+
+void HTTPStreamFactory::deleteSession(HTTPClientSession* pSession)
+{
+	// Sessions for a proxy given in a 305 response are not pooled.
+	if (_pPool && _pPool->owns(pSession))
+		_pPool->discard(pSession);
+	else
+		delete pSession;
+}
+
+
 void HTTPStreamFactory::registerFactory()
 {
 	URIStreamOpener::defaultOpener().registerStreamFactory("http", new HTTPStreamFactory);
 }
 
 
+void HTTPStreamFactory::registerFactory(HTTPClientSessionPool::Ptr pPool)
+{
+	URIStreamOpener::defaultOpener().registerStreamFactory("http", new HTTPStreamFactory(pPool));
+}
+
+
 void HTTPStreamFactory::unregisterFactory()
 {
 	URIStreamOpener::defaultOpener().unregisterStreamFactory("http");
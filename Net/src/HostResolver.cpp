@@ -0,0 +1,39 @@
+//
+// HostResolver.cpp
+//
+// Library: Net
+// Package: NetCore
+// Module:  HostResolver
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HostResolver.h"
+#include "Poco/Net/DNS.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+HostResolver::HostResolver()
+{
+}
+
+
+HostResolver::~HostResolver()
+{
+}
+
+
+HostEntry HostResolver::resolve(const std::string& hostname)
+{
+	return DNS::hostByName(hostname);
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,537 @@
+//
+// IOUring.cpp
+//
+// Library: Net
+// Package: Sockets
+// Module:  IOUring
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/IOUring.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocketImpl.h"
+#include "Poco/Net/SocketImpl.h"
+#include "Poco/Exception.h"
+#include "Poco/Error.h"
+
+
+#if defined(POCO_HAVE_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#if !defined(__NR_io_uring_setup) || !defined(IORING_FEAT_EXT_ARG)
+#undef POCO_HAVE_IO_URING
+#endif
+#endif
+
+
+namespace Poco {
+namespace Net {
+
+
+#if defined(POCO_HAVE_IO_URING)
+
+
+namespace
+{
+	int ioUringSetup(unsigned entries, struct io_uring_params* pParams)
+	{
+		return static_cast<int>(::syscall(__NR_io_uring_setup, entries, pParams));
+	}
+
+	int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, const void* pArg, std::size_t argSize)
+	{
+		return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, pArg, argSize));
+	}
+
+	int ioUringRegister(int fd, unsigned opcode, const void* pArg, unsigned nrArgs)
+	{
+		return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, pArg, nrArgs));
+	}
+
+	bool hasRequiredFeatures(const struct io_uring_params& params)
+	{
+		return (params.features & IORING_FEAT_SINGLE_MMAP) && (params.features & IORING_FEAT_EXT_ARG);
+	}
+
+	bool probe()
+	{
+		struct io_uring_params params;
+		std::memset(&params, 0, sizeof(params));
+		int fd = ioUringSetup(2, &params);
+		if (fd < 0) return false;
+		::close(fd);
+		return hasRequiredFeatures(params);
+	}
+}
+
+
+IOUring::IOUring(unsigned entries):
+	_fd(-1),
+	_pRing(0),
+	_ringSize(0),
+	_pEntries(0),
+	_entriesSize(0),
+	_pSQHead(0),
+	_pSQTail(0),
+	_pSQMask(0),
+	_pSQArray(0),
+	_pCQHead(0),
+	_pCQTail(0),
+	_pCQMask(0),
+	_pCQEntries(0),
+	_sqEntries(0),
+	_sqLocalTail(0),
+	_sqSubmitted(0),
+	_buffersRegistered(false)
+{
+	struct io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+	_fd = ioUringSetup(entries, &params);
+	if (_fd < 0)
+		throw Poco::NotImplementedException("io_uring", Poco::Error::getMessage(errno));
+	if (!hasRequiredFeatures(params))
+	{
+		::close(_fd);
+		throw Poco::NotImplementedException("io_uring", "kernel does not support required features");
+	}
+
+	std::size_t sqRingSize = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+	std::size_t cqRingSize = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+	_ringSize = sqRingSize > cqRingSize ? sqRingSize : cqRingSize;
+	_pRing = ::mmap(0, _ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+	if (_pRing == MAP_FAILED)
+	{
+		int err = errno;
+		::close(_fd);
+		SocketImpl::error(err);
+	}
+	_entriesSize = params.sq_entries*sizeof(struct io_uring_sqe);
+	_pEntries = ::mmap(0, _entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+	if (_pEntries == MAP_FAILED)
+	{
+		int err = errno;
+		::munmap(_pRing, _ringSize);
+		::close(_fd);
+		SocketImpl::error(err);
+	}
+
+	char* pRing = static_cast<char*>(_pRing);
+	_pSQHead    = reinterpret_cast<unsigned*>(pRing + params.sq_off.head);
+	_pSQTail    = reinterpret_cast<unsigned*>(pRing + params.sq_off.tail);
+	_pSQMask    = reinterpret_cast<unsigned*>(pRing + params.sq_off.ring_mask);
+	_pSQArray   = reinterpret_cast<unsigned*>(pRing + params.sq_off.array);
+	_pCQHead    = reinterpret_cast<unsigned*>(pRing + params.cq_off.head);
+	_pCQTail    = reinterpret_cast<unsigned*>(pRing + params.cq_off.tail);
+	_pCQMask    = reinterpret_cast<unsigned*>(pRing + params.cq_off.ring_mask);
+	_pCQEntries = pRing + params.cq_off.cqes;
+	_sqEntries  = params.sq_entries;
+	_sqLocalTail = _sqSubmitted = *_pSQTail;
+}
+
+
+IOUring::~IOUring()
+{
+	::munmap(_pEntries, _entriesSize);
+	::munmap(_pRing, _ringSize);
+	::close(_fd);
+}
+
+
+bool IOUring::available()
+{
+	static const bool avail = probe();
+	return avail;
+}
+
+
+void IOUring::registerBuffers(const BufferVec& buffers)
+{
+	if (_buffersRegistered) unregisterBuffers();
+	if (buffers.empty()) return;
+
+	std::vector<struct iovec> iov(buffers.size());
+	for (std::size_t i = 0; i < buffers.size(); i++)
+	{
+		iov[i].iov_base = buffers[i].pData;
+		iov[i].iov_len  = buffers[i].length;
+	}
+	if (ioUringRegister(_fd, IORING_REGISTER_BUFFERS, &iov[0], static_cast<unsigned>(iov.size())) < 0)
+		SocketImpl::error(errno);
+	_buffers = buffers;
+	_buffersRegistered = true;
+}
+
+
+void IOUring::unregisterBuffers()
+{
+	if (_buffersRegistered)
+	{
+		if (ioUringRegister(_fd, IORING_UNREGISTER_BUFFERS, 0, 0) < 0)
+			SocketImpl::error(errno);
+		_buffers.clear();
+		_buffersRegistered = false;
+	}
+}
+
+
+void IOUring::prepareReceive(const Socket& socket, void* buffer, int length, Poco::UInt64 userData, int flags)
+{
+	struct io_uring_sqe* pEntry = static_cast<struct io_uring_sqe*>(nextEntry());
+	pEntry->opcode    = IORING_OP_RECV;
+	pEntry->fd        = socket.impl()->sockfd();
+	pEntry->addr      = reinterpret_cast<Poco::UInt64>(buffer);
+	pEntry->len       = length;
+	pEntry->msg_flags = flags;
+	pEntry->user_data = userData;
+}
+
+
+void IOUring::prepareSend(const Socket& socket, const void* buffer, int length, Poco::UInt64 userData, int flags)
+{
+	struct io_uring_sqe* pEntry = static_cast<struct io_uring_sqe*>(nextEntry());
+	pEntry->opcode    = IORING_OP_SEND;
+	pEntry->fd        = socket.impl()->sockfd();
+	pEntry->addr      = reinterpret_cast<Poco::UInt64>(buffer);
+	pEntry->len       = length;
+	pEntry->msg_flags = flags | MSG_NOSIGNAL;
+	pEntry->user_data = userData;
+}
+
+
+void IOUring::prepareReceiveFixed(const Socket& socket, int bufferIndex, std::size_t offset, int length, Poco::UInt64 userData)
+{
+	poco_assert (_buffersRegistered);
+
+	struct io_uring_sqe* pEntry = static_cast<struct io_uring_sqe*>(nextEntry());
+	pEntry->opcode    = IORING_OP_READ_FIXED;
+	pEntry->fd        = socket.impl()->sockfd();
+	pEntry->addr      = reinterpret_cast<Poco::UInt64>(_buffers[bufferIndex].pData) + offset;
+	pEntry->len       = length;
+	pEntry->buf_index = static_cast<Poco::UInt16>(bufferIndex);
+	pEntry->user_data = userData;
+}
+
+
+void IOUring::prepareSendFixed(const Socket& socket, int bufferIndex, std::size_t offset, int length, Poco::UInt64 userData)
+{
+	poco_assert (_buffersRegistered);
+
+	struct io_uring_sqe* pEntry = static_cast<struct io_uring_sqe*>(nextEntry());
+	pEntry->opcode    = IORING_OP_WRITE_FIXED;
+	pEntry->fd        = socket.impl()->sockfd();
+	pEntry->addr      = reinterpret_cast<Poco::UInt64>(_buffers[bufferIndex].pData) + offset;
+	pEntry->len       = length;
+	pEntry->buf_index = static_cast<Poco::UInt16>(bufferIndex);
+	pEntry->user_data = userData;
+}
+
+
+void IOUring::prepareAccept(const ServerSocket& socket, Poco::UInt64 userData)
+{
+	struct io_uring_sqe* pEntry = static_cast<struct io_uring_sqe*>(nextEntry());
+	pEntry->opcode    = IORING_OP_ACCEPT;
+	pEntry->fd        = socket.impl()->sockfd();
+	pEntry->user_data = userData;
+}
+
+
+void IOUring::preparePoll(poco_socket_t fd, int mode, Poco::UInt64 userData, bool multiShot)
+{
+	struct io_uring_sqe* pEntry = static_cast<struct io_uring_sqe*>(nextEntry());
+	pEntry->opcode = IORING_OP_POLL_ADD;
+	pEntry->fd     = fd;
+	Poco::UInt32 events = 0;
+	if (mode & Socket::SELECT_READ)
+		events |= POLLIN;
+	if (mode & Socket::SELECT_WRITE)
+		events |= POLLOUT;
+	if (mode & Socket::SELECT_ERROR)
+		events |= POLLERR;
+	pEntry->poll32_events = events;
+	if (multiShot)
+		pEntry->len = IORING_POLL_ADD_MULTI;
+	pEntry->user_data = userData;
+}
+
+
+void IOUring::prepareRemovePoll(Poco::UInt64 pollUserData, Poco::UInt64 userData)
+{
+	struct io_uring_sqe* pEntry = static_cast<struct io_uring_sqe*>(nextEntry());
+	pEntry->opcode    = IORING_OP_POLL_REMOVE;
+	pEntry->fd        = -1;
+	pEntry->addr      = pollUserData;
+	pEntry->user_data = userData;
+}
+
+
+int IOUring::submit()
+{
+	unsigned toSubmit = _sqLocalTail - _sqSubmitted;
+	if (toSubmit == 0) return 0;
+	return enter(toSubmit, 0, 0, 0);
+}
+
+
+int IOUring::submitAndWait(int minCompletions, const Poco::Timespan& timeout)
+{
+	return enter(_sqLocalTail - _sqSubmitted, static_cast<unsigned>(minCompletions), IORING_ENTER_GETEVENTS, &timeout);
+}
+
+
+int IOUring::wait(int minCompletions, const Poco::Timespan& timeout)
+{
+	return enter(0, static_cast<unsigned>(minCompletions), IORING_ENTER_GETEVENTS, &timeout) >= 0 ? 1 : 0;
+}
+
+
+int IOUring::completions(Completion* pCompletions, int maxCompletions)
+{
+	unsigned head = *_pCQHead;
+	unsigned tail = __atomic_load_n(_pCQTail, __ATOMIC_ACQUIRE);
+	unsigned mask = *_pCQMask;
+	const struct io_uring_cqe* pCQEntries = static_cast<const struct io_uring_cqe*>(_pCQEntries);
+	int n = 0;
+	while (head != tail && n < maxCompletions)
+	{
+		const struct io_uring_cqe& entry = pCQEntries[head & mask];
+		pCompletions[n].userData = entry.user_data;
+		pCompletions[n].result   = entry.res;
+		pCompletions[n].flags    = entry.flags;
+		++head;
+		++n;
+	}
+	__atomic_store_n(_pCQHead, head, __ATOMIC_RELEASE);
+	return n;
+}
+
+
+StreamSocket IOUring::acceptedSocket(const Completion& completion)
+{
+	if (completion.result < 0) SocketImpl::error(-completion.result);
+	return StreamSocket(new StreamSocketImpl(completion.result));
+}
+
+
+int IOUring::pollMode(int pollEvents)
+{
+	int mode = 0;
+	if (pollEvents & POLLIN)
+		mode |= Socket::SELECT_READ;
+	if (pollEvents & POLLOUT)
+		mode |= Socket::SELECT_WRITE;
+	if (pollEvents & POLLERR)
+		mode |= Socket::SELECT_ERROR;
+	return mode;
+}
+
+
+void* IOUring::nextEntry()
+{
+	if (_sqLocalTail - __atomic_load_n(_pSQHead, __ATOMIC_ACQUIRE) >= _sqEntries)
+	{
+		submit();
+		if (_sqLocalTail - __atomic_load_n(_pSQHead, __ATOMIC_ACQUIRE) >= _sqEntries)
+			throw Poco::IOException("io_uring submission queue full");
+	}
+	unsigned index = _sqLocalTail & *_pSQMask;
+	struct io_uring_sqe* pEntry = static_cast<struct io_uring_sqe*>(_pEntries) + index;
+	std::memset(pEntry, 0, sizeof(struct io_uring_sqe));
+	_pSQArray[index] = index;
+	++_sqLocalTail;
+	return pEntry;
+}
+
+
+int IOUring::enter(unsigned toSubmit, unsigned minComplete, unsigned flags, const Poco::Timespan* pTimeout)
+{
+	if (toSubmit > 0)
+		__atomic_store_n(_pSQTail, _sqLocalTail, __ATOMIC_RELEASE);
+
+	struct __kernel_timespec ts;
+	struct io_uring_getevents_arg arg;
+	std::memset(&arg, 0, sizeof(arg));
+	if (pTimeout)
+	{
+		ts.tv_sec  = pTimeout->totalSeconds();
+		ts.tv_nsec = static_cast<long long>(pTimeout->useconds())*1000;
+		arg.sigmask_sz = _NSIG/8;
+		arg.ts = reinterpret_cast<Poco::UInt64>(&ts);
+		flags |= IORING_ENTER_EXT_ARG;
+	}
+
+	int rc;
+	do
+	{
+		rc = ioUringEnter(_fd, toSubmit, minComplete, flags, pTimeout ? &arg : 0, pTimeout ? sizeof(arg) : 0);
+	}
+	while (rc < 0 && errno == EINTR && toSubmit > 0);
+	if (rc < 0)
+	{
+		int err = errno;
+		// ETIME: timeout expired, EINTR: interrupted while waiting,
+		// EBUSY/EAGAIN: completion queue must be drained first.
+		if (err == ETIME || err == EINTR || err == EBUSY || err == EAGAIN)
+			return toSubmit > 0 ? 0 : -1;
+		SocketImpl::error(err);
+	}
+	if (toSubmit > 0)
+		_sqSubmitted += rc;
+	return rc;
+}
+
+
+#else
+
+
+IOUring::IOUring(unsigned entries):
+	_fd(-1),
+	_pRing(0),
+	_ringSize(0),
+	_pEntries(0),
+	_entriesSize(0),
+	_pSQHead(0),
+	_pSQTail(0),
+	_pSQMask(0),
+	_pSQArray(0),
+	_pCQHead(0),
+	_pCQTail(0),
+	_pCQMask(0),
+	_pCQEntries(0),
+	_sqEntries(0),
+	_sqLocalTail(0),
+	_sqSubmitted(0),
+	_buffersRegistered(false)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+IOUring::~IOUring()
+{
+}
+
+
+bool IOUring::available()
+{
+	return false;
+}
+
+
+void IOUring::registerBuffers(const BufferVec&)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+void IOUring::unregisterBuffers()
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+void IOUring::prepareReceive(const Socket&, void*, int, Poco::UInt64, int)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+void IOUring::prepareSend(const Socket&, const void*, int, Poco::UInt64, int)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+void IOUring::prepareReceiveFixed(const Socket&, int, std::size_t, int, Poco::UInt64)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+void IOUring::prepareSendFixed(const Socket&, int, std::size_t, int, Poco::UInt64)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+void IOUring::prepareAccept(const ServerSocket&, Poco::UInt64)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+void IOUring::preparePoll(poco_socket_t, int, Poco::UInt64, bool)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+void IOUring::prepareRemovePoll(Poco::UInt64, Poco::UInt64)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+int IOUring::submit()
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+int IOUring::submitAndWait(int, const Poco::Timespan&)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+int IOUring::wait(int, const Poco::Timespan&)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+int IOUring::completions(Completion*, int)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+StreamSocket IOUring::acceptedSocket(const Completion&)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+int IOUring::pollMode(int)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+void* IOUring::nextEntry()
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+int IOUring::enter(unsigned, unsigned, unsigned, const Poco::Timespan*)
+{
+	throw Poco::NotImplementedException("io_uring");
+}
+
+
+#endif // POCO_HAVE_IO_URING
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,70 @@
+//
+// MetricsCounter.cpp
+//
+// Library: Net
+// Package: TCPServer
+// Module:  MetricsCounter
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/MetricsCounter.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	std::atomic<unsigned> nextStripe(0);
+	thread_local unsigned threadStripe = MetricsCounter::STRIPES;
+}
+
+
+MetricsCounter::MetricsCounter()
+{
+	reset();
+}
+
+
+MetricsCounter::~MetricsCounter()
+{
+}
+
+
+Poco::UInt64 MetricsCounter::value() const
+{
+	Poco::UInt64 sum = 0;
+	for (int i = 0; i < STRIPES; i++)
+	{
+		sum += _cells[i].value.load(std::memory_order_relaxed);
+	}
+	return sum;
+}
+
+
+void MetricsCounter::reset()
+{
+	for (int i = 0; i < STRIPES; i++)
+	{
+		_cells[i].value.store(0, std::memory_order_relaxed);
+	}
+}
+
+
+unsigned MetricsCounter::stripe()
+{
+	if (threadStripe == STRIPES)
+	{
+		threadStripe = nextStripe.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+	}
+	return threadStripe;
+}
+
+
+} } // namespace Poco::Net
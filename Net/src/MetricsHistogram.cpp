@@ -0,0 +1,179 @@
+//
+// MetricsHistogram.cpp
+//
+// Library: Net
+// Package: TCPServer
+// Module:  MetricsHistogram
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/MetricsHistogram.h"
+#include "Poco/Net/MetricsCounter.h"
+#include <cmath>
+#include <limits>
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	inline int highestBit(Poco::UInt64 value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return 63 - __builtin_clzll(value);
+#else
+		int bit = 0;
+		while (value >>= 1) bit++;
+		return bit;
+#endif
+	}
+}
+
+
+//
+// MetricsHistogram::Snapshot
+//
+
+
+MetricsHistogram::Snapshot::Snapshot():
+	_buckets(BUCKETS, 0),
+	_count(0),
+	_sum(0),
+	_min(0),
+	_max(0)
+{
+}
+
+
+MetricsHistogram::Snapshot::~Snapshot()
+{
+}
+
+
+double MetricsHistogram::Snapshot::mean() const
+{
+	return _count > 0 ? double(_sum)/double(_count) : 0.0;
+}
+
+
+Poco::UInt64 MetricsHistogram::Snapshot::percentile(double percent) const
+{
+	if (_count == 0) return 0;
+
+	Poco::UInt64 rank = static_cast<Poco::UInt64>(std::ceil(percent*_count/100.0));
+	if (rank < 1) rank = 1;
+	if (rank > _count) rank = _count;
+
+	Poco::UInt64 seen = 0;
+	for (int i = 0; i < BUCKETS; i++)
+	{
+		seen += _buckets[i];
+		if (seen >= rank)
+		{
+			Poco::UInt64 limit = bucketLimit(i);
+			return limit < _max ? limit : _max;
+		}
+	}
+	return _max;
+}
+
+
+//
+// MetricsHistogram
+//
+
+
+MetricsHistogram::MetricsHistogram()
+{
+	reset();
+}
+
+
+MetricsHistogram::~MetricsHistogram()
+{
+}
+
+
+void MetricsHistogram::record(Poco::UInt64 value)
+{
+	Stripe& stripe = _stripes[MetricsCounter::stripe() % STRIPES];
+	stripe.buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	stripe.sum.fetch_add(value, std::memory_order_relaxed);
+
+	Poco::UInt64 min = _min.load(std::memory_order_relaxed);
+	while (value < min && !_min.compare_exchange_weak(min, value, std::memory_order_relaxed))
+	{
+	}
+	Poco::UInt64 max = _max.load(std::memory_order_relaxed);
+	while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+
+MetricsHistogram::Snapshot MetricsHistogram::snapshot() const
+{
+	Snapshot snap;
+	for (int s = 0; s < STRIPES; s++)
+	{
+		const Stripe& stripe = _stripes[s];
+		for (int i = 0; i < BUCKETS; i++)
+		{
+			Poco::UInt64 n = stripe.buckets[i].load(std::memory_order_relaxed);
+			snap._buckets[i] += n;
+			snap._count += n;
+		}
+		snap._sum += stripe.sum.load(std::memory_order_relaxed);
+	}
+	snap._min = _min.load(std::memory_order_relaxed);
+	snap._max = _max.load(std::memory_order_relaxed);
+	return snap;
+}
+
+
+void MetricsHistogram::reset()
+{
+	for (int s = 0; s < STRIPES; s++)
+	{
+		Stripe& stripe = _stripes[s];
+		for (int i = 0; i < BUCKETS; i++)
+		{
+			stripe.buckets[i].store(0, std::memory_order_relaxed);
+		}
+		stripe.sum.store(0, std::memory_order_relaxed);
+	}
+	_min.store(std::numeric_limits<Poco::UInt64>::max(), std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+}
+
+
+int MetricsHistogram::bucketIndex(Poco::UInt64 value)
+{
+	if (value < SUB_BUCKETS) return static_cast<int>(value);
+
+	const Poco::UInt64 maxValue = (Poco::UInt64(1) << MAX_VALUE_BITS) - 1;
+	if (value > maxValue) value = maxValue;
+
+	int shift = highestBit(value) - SUB_BUCKET_BITS;
+	return (shift + 1)*SUB_BUCKETS + static_cast<int>((value >> shift) - SUB_BUCKETS);
+}
+
+
+Poco::UInt64 MetricsHistogram::bucketLimit(int index)
+{
+	if (index < SUB_BUCKETS) return static_cast<Poco::UInt64>(index);
+
+	int shift = (index >> SUB_BUCKET_BITS) - 1;
+	Poco::UInt64 lower = (Poco::UInt64(SUB_BUCKETS + (index & (SUB_BUCKETS - 1)))) << shift;
+	return lower + (Poco::UInt64(1) << shift) - 1;
+}
+
+
+} } // namespace Poco::Net
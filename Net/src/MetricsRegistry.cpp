@@ -0,0 +1,158 @@
+//
+// MetricsRegistry.cpp
+//
+// Library: Net
+// Package: TCPServer
+// Module:  MetricsRegistry
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/MetricsRegistry.h"
+#include "Poco/Exception.h"
+#include "Poco/Ascii.h"
+#include <sstream>
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	bool isValidName(const std::string& name)
+	{
+		if (name.empty()) return false;
+		for (std::string::const_iterator it = name.begin(); it != name.end(); ++it)
+		{
+			char c = *it;
+			if (!Poco::Ascii::isAlpha(c) && c != '_' && c != ':' && (it == name.begin() || !Poco::Ascii::isDigit(c)))
+				return false;
+		}
+		return true;
+	}
+
+	const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+}
+
+
+const std::string MetricsRegistry::CONTENT_TYPE("text/plain; version=0.0.4");
+
+
+MetricsRegistry::MetricsRegistry()
+{
+}
+
+
+MetricsRegistry::~MetricsRegistry()
+{
+}
+
+
+MetricsCounter& MetricsRegistry::counter(const std::string& name, const std::string& help)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	Metric& metric = find(name, help);
+	if (metric.pHistogram) throw Poco::InvalidArgumentException("Metric is a histogram", name);
+	if (!metric.pCounter) metric.pCounter.reset(new MetricsCounter);
+	return *metric.pCounter;
+}
+
+
+MetricsHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	Metric& metric = find(name, help);
+	if (metric.pCounter) throw Poco::InvalidArgumentException("Metric is a counter", name);
+	if (!metric.pHistogram) metric.pHistogram.reset(new MetricsHistogram);
+	return *metric.pHistogram;
+}
+
+
+void MetricsRegistry::write(std::ostream& ostr) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	for (std::vector<std::unique_ptr<Metric>>::const_iterator it = _metrics.begin(); it != _metrics.end(); ++it)
+	{
+		const Metric& metric = **it;
+		if (metric.pCounter)
+		{
+			writeHeader(ostr, metric, "counter");
+			ostr << metric.name << ' ' << metric.pCounter->value() << '\n';
+		}
+		else if (metric.pHistogram)
+		{
+			MetricsHistogram::Snapshot snap = metric.pHistogram->snapshot();
+			writeHeader(ostr, metric, "summary");
+			for (std::size_t i = 0; i < sizeof(QUANTILES)/sizeof(QUANTILES[0]); i++)
+			{
+				ostr << metric.name << "{quantile=\"" << QUANTILES[i] << "\"} " << snap.percentile(QUANTILES[i]*100) << '\n';
+			}
+			ostr << metric.name << "_sum " << snap.sum() << '\n';
+			ostr << metric.name << "_count " << snap.count() << '\n';
+		}
+	}
+}
+
+
+std::string MetricsRegistry::toString() const
+{
+	std::ostringstream ostr;
+	write(ostr);
+	return ostr.str();
+}
+
+
+void MetricsRegistry::reset()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	for (std::vector<std::unique_ptr<Metric>>::iterator it = _metrics.begin(); it != _metrics.end(); ++it)
+	{
+		if ((*it)->pCounter) (*it)->pCounter->reset();
+		if ((*it)->pHistogram) (*it)->pHistogram->reset();
+	}
+}
+
+
+MetricsRegistry::Metric& MetricsRegistry::find(const std::string& name, const std::string& help)
+{
+	for (std::vector<std::unique_ptr<Metric>>::iterator it = _metrics.begin(); it != _metrics.end(); ++it)
+	{
+		if ((*it)->name == name) return **it;
+	}
+	if (!isValidName(name)) throw Poco::InvalidArgumentException("Invalid metric name", name);
+
+	std::unique_ptr<Metric> pMetric(new Metric);
+	pMetric->name = name;
+	pMetric->help = help;
+	_metrics.push_back(std::move(pMetric));
+	return *_metrics.back();
+}
+
+
+void MetricsRegistry::writeHeader(std::ostream& ostr, const Metric& metric, const char* type)
+{
+	if (!metric.help.empty())
+	{
+		ostr << "# HELP " << metric.name << ' ';
+		for (std::string::const_iterator it = metric.help.begin(); it != metric.help.end(); ++it)
+		{
+			if (*it == '\\') ostr << "\\\\";
+			else if (*it == '\n') ostr << "\\n";
+			else ostr << *it;
+		}
+		ostr << '\n';
+	}
+	ostr << "# TYPE " << metric.name << ' ' << type << '\n';
+}
+
+
+} } // namespace Poco::Net
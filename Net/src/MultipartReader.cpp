@@ -16,6 +16,7 @@
 #include "Poco/Net/MessageHeader.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/Ascii.h"
+#include <cstring>
 
 
 using Poco::BufferedStreamBuf;
@@ -25,85 +26,281 @@ namespace Poco {
 namespace Net {
 
 
+//
+// MultipartSourceBuf
+//
+
+
+MultipartSourceBuf::MultipartSourceBuf(std::istream& istr, std::size_t bufferSize):
+	_istr(istr),
+	_buffer(bufferSize),
+	_eof(false)
+{
+	poco_assert (bufferSize > 0);
+
+	setg(_buffer.begin(), _buffer.begin(), _buffer.begin());
+}
+
+
+MultipartSourceBuf::~MultipartSourceBuf()
+{
+}
+
+
+std::size_t MultipartSourceBuf::fill()
+{
+	std::size_t n = available();
+	if (n > 0 && gptr() != _buffer.begin())
+		std::memmove(_buffer.begin(), gptr(), n);
+	setg(_buffer.begin(), _buffer.begin(), _buffer.begin() + n);
+
+	std::streamsize space = static_cast<std::streamsize>(_buffer.capacity() - n);
+	if (_eof || space == 0) return 0;
+
+	// Only read what the stream has already buffered (after
+	// waiting for at least one character), so that parts
+	// arriving slowly (e.g., multipart/x-mixed-replace) are
+	// not held back until the buffer is full.
+	std::streambuf& buf = *_istr.rdbuf();
+	if (traits_type::eq_int_type(buf.sgetc(), traits_type::eof()))
+	{
+		_eof = true;
+		return 0;
+	}
+	char* pEnd = _buffer.begin() + n;
+	std::streamsize rd = 0;
+	while (rd < space)
+	{
+		std::streamsize k = buf.in_avail();
+		if (k <= 0) break;
+		if (k > space - rd) k = space - rd;
+		k = buf.sgetn(pEnd + rd, k);
+		if (k <= 0) break;
+		rd += k;
+	}
+	if (rd == 0)
+	{
+		rd = buf.sgetn(pEnd, space);
+		if (rd <= 0)
+		{
+			_eof = true;
+			return 0;
+		}
+	}
+	setg(_buffer.begin(), _buffer.begin(), _buffer.begin() + n + rd);
+	return static_cast<std::size_t>(rd);
+}
+
+
+MultipartSourceBuf::int_type MultipartSourceBuf::underflow()
+{
+	if (gptr() == egptr()) fill();
+	if (gptr() == egptr()) return traits_type::eof();
+	return traits_type::to_int_type(*gptr());
+}
+
+
 //
 // MultipartStreamBuf
 //
 
 
+MultipartStreamBuf::MultipartStreamBuf(MultipartSourceBuf& source, const std::string& boundary):
+	BufferedStreamBuf(STREAM_BUFFER_SIZE, std::ios::in),
+	_pSource(&source),
+	_ownSource(false),
+	_boundary(boundary),
+	_endOfPart(false),
+	_lastPart(false)
+{
+	init();
+}
+
+
 MultipartStreamBuf::MultipartStreamBuf(std::istream& istr, const std::string& boundary):
 	BufferedStreamBuf(STREAM_BUFFER_SIZE, std::ios::in),
-	_istr(istr),
+	_pSource(dynamic_cast<MultipartSourceBuf*>(istr.rdbuf())),
+	_ownSource(false),
 	_boundary(boundary),
+	_endOfPart(false),
 	_lastPart(false)
 {
-	poco_assert (!boundary.empty() && boundary.length() < STREAM_BUFFER_SIZE - 6);
+	if (!_pSource)
+	{
+		_pSource = new MultipartSourceBuf(istr);
+		_ownSource = true;
+	}
+	init();
 }
 
 
 MultipartStreamBuf::~MultipartStreamBuf()
 {
+	if (_ownSource) delete _pSource;
 }
 
 
-int MultipartStreamBuf::readFromDevice(char* buffer, std::streamsize length)
+void MultipartStreamBuf::init()
 {
-	poco_assert_dbg (length >= _boundary.length() + 6);
+	poco_assert (!_boundary.empty() && _boundary.length() < STREAM_BUFFER_SIZE - 6);
 
-	static const int eof = std::char_traits<char>::eof();
-	std::streambuf& buf = *_istr.rdbuf();
+	// A boundary is only recognized at the beginning of a line.
+	// The CR preceding the LF (if any) is part of the boundary, too.
+	_pattern = "\n--";
+	_pattern.append(_boundary);
 
-	int n  = 0;
-	int ch = buf.sbumpc();
-	if (ch == eof) return -1;
-	*buffer++ = (char) ch; ++n;
-	if (ch == '\n' || (ch == '\r' && buf.sgetc() == '\n'))
+	poco_assert (_pattern.length() + 2 < _pSource->capacity());
+
+	std::size_t patternLength = _pattern.length();
+	for (int i = 0; i < 256; i++)
 	{
-		if (ch == '\r')
+		_skip[i] = patternLength;
+	}
+	for (std::size_t i = 0; i < patternLength - 1; i++)
+	{
+		_skip[static_cast<unsigned char>(_pattern[i])] = patternLength - 1 - i;
+	}
+}
+
+
+std::size_t MultipartStreamBuf::find(const char* data, std::size_t begin, std::size_t end) const
+{
+	std::size_t patternLength = _pattern.length();
+	const char* pattern = _pattern.data();
+	char last = pattern[patternLength - 1];
+	std::size_t pos = begin;
+	while (pos + patternLength <= end)
+	{
+		char ch = data[pos + patternLength - 1];
+		if (ch == last && std::memcmp(data + pos, pattern, patternLength - 1) == 0)
+			return pos;
+		pos += _skip[static_cast<unsigned char>(ch)];
+	}
+	return std::string::npos;
+}
+
+
+int MultipartStreamBuf::readFromDevice(char* buffer, std::streamsize length)
+{
+	if (_endOfPart) return 0;
+
+	std::size_t patternLength = _pattern.length();
+	for (;;)
+	{
+		const char* data = _pSource->data();
+		std::size_t avail = _pSource->available();
+		bool eof = _pSource->eof();
+		if (avail == 0)
 		{
-			ch = buf.sbumpc(); // '\n'
-			*buffer++ = (char) ch; ++n;
+			if (!eof && _pSource->fill() > 0) continue;
+			return -1;
 		}
-		ch = buf.sgetc();
-		if (ch == '\r' || ch == '\n') return n;
-		*buffer++ = (char) buf.sbumpc(); ++n;
-		if (ch == '-' && buf.sgetc() == '-')
+
+		// Only the data required for the request is searched.
+		// A boundary may begin within the last patternLength
+		// bytes of the window, so these are not returned unless
+		// the end of the stream has been reached.
+		std::size_t window = static_cast<std::size_t>(length) + patternLength;
+		if (window > avail) window = avail;
+		std::size_t begin = 0;
+		for (;;)
 		{
-			ch = buf.sbumpc(); // '-'
-			*buffer++ = (char) ch; ++n;
-			std::string::const_iterator it  = _boundary.begin();
-			std::string::const_iterator end = _boundary.end();
-			ch = buf.sbumpc();
-			*buffer++ = (char) ch; ++n;
-			while (it != end && ch == *it)
-			{
-				++it;
-				ch = buf.sbumpc();
-				*buffer++ = (char) ch; ++n;
-			}
-			if (it == end)
+			std::size_t pos = find(data, begin, window);
+			if (pos == std::string::npos) break;
+
+			std::size_t n = pos;
+			if (n > 0 && data[n - 1] == '\r') --n;
+			std::size_t tail = pos + patternLength;
+			if (tail + 2 > avail && !eof)
 			{
-				if (ch == '\n' || (ch == '\r' && buf.sgetc() == '\n'))
-				{
-					if (ch == '\r')
-					{
-						buf.sbumpc(); // '\n'
-					}
-					return 0;
-				}
-				else if (ch == '-' && buf.sgetc() == '-')
+				// Not enough data to decide whether this is a boundary,
+				// so return the data preceding it, or read more data.
+				if (n > 0)
 				{
-					buf.sbumpc(); // '-'
-					_lastPart = true;
-					return 0;
+					std::memcpy(buffer, data, n);
+					_pSource->consume(n);
+					return static_cast<int>(n);
 				}
+				if (_pSource->fill() == 0) eof = true;
+				data  = _pSource->data();
+				avail = _pSource->available();
+				window = static_cast<std::size_t>(length) + patternLength;
+				if (window > avail) window = avail;
+				continue;
+			}
+			std::size_t end = 0;
+			if (tail < avail && data[tail] == '\n')
+			{
+				end = tail + 1;
 			}
+			else if (tail + 1 < avail && data[tail] == '\r' && data[tail + 1] == '\n')
+			{
+				end = tail + 2;
+			}
+			else if (tail + 1 < avail && data[tail] == '-' && data[tail + 1] == '-')
+			{
+				end = tail + 2;
+				_lastPart = true;
+			}
+			if (end == 0)
+			{
+				// Not followed by a line break or "--", so not a boundary.
+				begin = pos + 1;
+				continue;
+			}
+			// As the window extends patternLength bytes beyond the
+			// requested length, the data preceding the boundary
+			// always fits into the buffer.
+			std::memcpy(buffer, data, n);
+			_pSource->consume(end);
+			_endOfPart = true;
+			return static_cast<int>(n);
 		}
+
+		std::size_t n;
+		if (eof && window == avail)
+			n = window;
+		else
+			n = window > patternLength ? window - patternLength : 0;
+		if (n > static_cast<std::size_t>(length)) n = static_cast<std::size_t>(length);
+		if (n > 0)
+		{
+			std::memcpy(buffer, data, n);
+			_pSource->consume(n);
+			return static_cast<int>(n);
+		}
+		_pSource->fill();
 	}
-	ch = buf.sgetc();
-	while (ch != eof && ch != '\r' && ch != '\n' && n < length)
+}
+
+
+std::streamsize MultipartStreamBuf::xsgetn(char* buffer, std::streamsize length)
+{
+	// Large reads bypass the stream buffer and copy directly
+	// from the source buffer into the caller's buffer.
+	std::streamsize n = 0;
+	while (n < length)
 	{
-		*buffer++ = (char) buf.sbumpc(); ++n;
-		ch = buf.sgetc();
+		std::streamsize buffered = static_cast<std::streamsize>(egptr() - gptr());
+		if (buffered > 0)
+		{
+			std::streamsize k = length - n < buffered ? length - n : buffered;
+			std::memcpy(buffer + n, gptr(), static_cast<std::size_t>(k));
+			gbump(static_cast<int>(k));
+			n += k;
+		}
+		else if (length - n >= STREAM_BUFFER_SIZE)
+		{
+			std::streamsize k = length - n;
+			if (k > static_cast<std::streamsize>(_pSource->capacity())) k = static_cast<std::streamsize>(_pSource->capacity());
+			int rd = readFromDevice(buffer + n, k);
+			if (rd <= 0) break;
+			n += rd;
+		}
+		else if (traits_type::eq_int_type(underflow(), traits_type::eof()))
+		{
+			break;
+		}
 	}
 	return n;
 }
@@ -174,14 +371,16 @@ MultipartInputStream::~MultipartInputStream()
 
 
 MultipartReader::MultipartReader(std::istream& istr):
-	_istr(istr),
+	_source(istr),
+	_input(&_source),
 	_pMPI(0)
 {
 }
 
 
 MultipartReader::MultipartReader(std::istream& istr, const std::string& boundary):
-	_istr(istr),
+	_source(istr),
+	_input(&_source),
 	_boundary(boundary),
 	_pMPI(0)
 {
@@ -209,13 +408,13 @@ void MultipartReader::nextPart(MessageHeader& messageHeader)
 	}
 	parseHeader(messageHeader);
 	delete _pMPI;
-	_pMPI = new MultipartInputStream(_istr, _boundary);
+	_pMPI = new MultipartInputStream(_input, _boundary);
 }
 
 
 bool MultipartReader::hasNextPart()
 {
-	return (!_pMPI || !_pMPI->lastPart()) && _istr.good();
+	return (!_pMPI || !_pMPI->lastPart()) && _input.good();
 }
 
 
@@ -253,24 +452,24 @@ void MultipartReader::findFirstBoundary()
 void MultipartReader::guessBoundary()
 {
 	static const int eof = std::char_traits<char>::eof();
-	int ch = _istr.get();
+	int ch = _input.get();
 	while (Poco::Ascii::isSpace(ch))
-		ch = _istr.get();
-	if (ch == '-' && _istr.peek() == '-')
+		ch = _input.get();
+	if (ch == '-' && _input.peek() == '-')
 	{
-		_istr.get();
-		ch = _istr.peek();
+		_input.get();
+		ch = _input.peek();
 		while (ch != eof && ch != '\r' && ch != '\n' && _boundary.size() < 128) // Note: should be no longer than 70 chars acc. to RFC 2046
 		{
-			_boundary += (char) _istr.get();
-			ch = _istr.peek();
+			_boundary += (char) _input.get();
+			ch = _input.peek();
 		}
 		if (ch != '\r' && ch != '\n')
 			throw MultipartException("Invalid boundary line found");
 		if (ch == '\r' || ch == '\n')
-			_istr.get();
-		if (_istr.peek() == '\n')
-			_istr.get();
+			_input.get();
+		if (_input.peek() == '\n')
+			_input.get();
 	}
 	else throw MultipartException("No boundary line found");
 }
@@ -279,9 +478,9 @@ void MultipartReader::guessBoundary()
 void MultipartReader::parseHeader(MessageHeader& messageHeader)
 {
 	messageHeader.clear();
-	messageHeader.read(_istr);
-	int ch = _istr.get();
-	if (ch == '\r' && _istr.peek() == '\n') _istr.get();
+	messageHeader.read(_input);
+	int ch = _input.get();
+	if (ch == '\r' && _input.peek() == '\n') _input.get();
 }
 
 
@@ -291,18 +490,18 @@ bool MultipartReader::readLine(std::string& line, std::string::size_type n)
 	static const int maxLength = 1024;
 
 	line.clear();
-	int ch = _istr.peek();
+	int ch = _input.peek();
 	int length = 0;
 	while (ch != eof && ch != '\r' && ch != '\n' && length < maxLength)
 	{
-		ch = (char) _istr.get();
+		ch = (char) _input.get();
 		if (line.length() < n) 
 			line += static_cast<char>(ch);
-		ch = _istr.peek();
+		ch = _input.peek();
 		length++;
 	}
-	if (ch != eof) _istr.get();
-	if (ch == '\r' && _istr.peek() == '\n') _istr.get();
+	if (ch != eof) _input.get();
+	if (ch == '\r' && _input.peek() == '\n') _input.get();
 	return ch != eof && length < maxLength;
 }
 
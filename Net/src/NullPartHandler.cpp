@@ -14,12 +14,7 @@
 
 #include "Poco/Net/NullPartHandler.h"
 #include "Poco/Net/MessageHeader.h"
-#include "Poco/NullStream.h"
-#include "Poco/StreamCopier.h"
-
-
-using Poco::NullOutputStream;
-using Poco::StreamCopier;
+#include <limits>
 
 
 namespace Poco {
@@ -38,8 +33,7 @@ NullPartHandler::~NullPartHandler()
 
 void NullPartHandler::handlePart(const MessageHeader& /*header*/, std::istream& stream)
 {
-	NullOutputStream ostr;
-	StreamCopier::copyStream(stream, ostr);
+	stream.ignore(std::numeric_limits<std::streamsize>::max());
 }
 
 
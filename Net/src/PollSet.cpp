@@ -18,6 +18,7 @@
 #include "Poco/Net/PollSet.h"
 #include "Poco/Net/SocketImpl.h"
 #include "Poco/Mutex.h"
+#include "Poco/Exception.h"
 #include <set>
 
 
@@ -33,7 +34,10 @@
 
 
 #if defined(POCO_HAVE_FD_EPOLL)
+#include "Poco/Net/IOUring.h"
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <atomic>
 #elif defined(POCO_HAVE_FD_POLL)
 #ifndef _WIN32
 #include <poll.h>
@@ -49,53 +53,146 @@ namespace Net {
 
 
 //
-// Linux implementation using epoll
+// Linux implementations, selected at runtime
 //
 class PollSetImpl
 {
 public:
-	PollSetImpl():
+	virtual ~PollSetImpl()
+	{
+	}
+
+	virtual void add(const Socket& socket, int mode, void* pData) = 0;
+	virtual void remove(const Socket& socket) = 0;
+	virtual bool has(const Socket& socket) const = 0;
+	virtual bool empty() const = 0;
+	virtual void update(const Socket& socket, int mode) = 0;
+	virtual void clear() = 0;
+	virtual PollSet::SocketModeMap poll(const Poco::Timespan& timeout) = 0;
+	virtual int poll(const Poco::Timespan& timeout, PollSet::Event* pEvents, int maxEvents) = 0;
+	virtual void wakeUp() = 0;
+
+protected:
+	static void error()
+	{
+		SocketImpl::error();
+	}
+
+	static void error(int code)
+	{
+		SocketImpl::error(code);
+	}
+
+	static int lastError()
+	{
+		return SocketImpl::lastError();
+	}
+};
+
+
+class WakeUpEvent
+	/// An eventfd that is polled together with the sockets,
+	/// so that a thread waiting for events can be woken up.
+	/// Consecutive wake ups are coalesced until the event
+	/// has been reset by the waiting thread.
+{
+public:
+	WakeUpEvent():
+		_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+		_signalled(false)
+	{
+		if (_fd < 0) throw Poco::IOException("cannot create eventfd");
+	}
+
+	~WakeUpEvent()
+	{
+		::close(_fd);
+	}
+
+	int fd() const
+	{
+		return _fd;
+	}
+
+	void signal()
+	{
+		if (!_signalled.exchange(true))
+		{
+			Poco::UInt64 value = 1;
+			ssize_t rc;
+			do
+			{
+				rc = ::write(_fd, &value, sizeof(value));
+			}
+			while (rc < 0 && errno == EINTR);
+		}
+	}
+
+	void reset()
+	{
+		Poco::UInt64 value;
+		ssize_t rc;
+		do
+		{
+			rc = ::read(_fd, &value, sizeof(value));
+		}
+		while (rc < 0 && errno == EINTR);
+		_signalled = false;
+	}
+
+private:
+	WakeUpEvent(const WakeUpEvent&);
+	WakeUpEvent& operator = (const WakeUpEvent&);
+
+	int _fd;
+	std::atomic<bool> _signalled;
+};
+
+
+//
+// Linux implementation using epoll
+//
+class EPollSetImpl: public PollSetImpl
+{
+public:
+	EPollSetImpl():
 		_epollfd(-1),
 		_events(1024)
 	{
 		_epollfd = epoll_create(1);
 		if (_epollfd < 0)
 		{
-			SocketImpl::error();
+			error();
 		}
+		addWakeUpEvent();
 	}
 
-	~PollSetImpl()
+	~EPollSetImpl()
 	{
 		if (_epollfd >= 0)
 			::close(_epollfd);
 	}
 
-	void add(const Socket& socket, int mode)
+	void add(const Socket& socket, int mode, void* pData)
 	{
 		Poco::FastMutex::ScopedLock lock(_mutex);
 
 		SocketImpl* sockImpl = socket.impl();
 		poco_socket_t fd = sockImpl->sockfd();
 		struct epoll_event ev;
-		ev.events = 0;
-		if (mode & PollSet::POLL_READ)
-			ev.events |= EPOLLIN;
-		if (mode & PollSet::POLL_WRITE)
-			ev.events |= EPOLLOUT;
-		if (mode & PollSet::POLL_ERROR)
-			ev.events |= EPOLLERR;
-		ev.data.ptr = socket.impl();
+		ev.events = epollEvents(mode);
+		ev.data.ptr = pData ? pData : sockImpl;
 		int err = epoll_ctl(_epollfd, EPOLL_CTL_ADD, fd, &ev);
+		if (err && errno != EEXIST) error();
 
-		if (err)
-		{
-			if (errno == EEXIST) update(socket, mode);
-			else SocketImpl::error();
-		}
+		setData(sockImpl, pData);
+		SocketMap::iterator it = _socketMap.find(sockImpl);
+		if (it == _socketMap.end())
+			_socketMap[sockImpl] = SocketEntry(socket, pData);
+		else
+			it->second.pData = pData;
 
-		if (_socketMap.find(sockImpl) == _socketMap.end())
-			_socketMap[sockImpl] = socket;
+		if (err) updateImpl(socket, mode);
 	}
 
 	void remove(const Socket& socket)
@@ -107,8 +204,9 @@ public:
 		ev.events = 0;
 		ev.data.ptr = 0;
 		int err = epoll_ctl(_epollfd, EPOLL_CTL_DEL, fd, &ev);
-		if (err) SocketImpl::error();
+		if (err) error();
 
+		setData(socket.impl(), 0);
 		_socketMap.erase(socket.impl());
 	}
 
@@ -128,21 +226,9 @@ public:
 
 	void update(const Socket& socket, int mode)
 	{
-		poco_socket_t fd = socket.impl()->sockfd();
-		struct epoll_event ev;
-		ev.events = 0;
-		if (mode & PollSet::POLL_READ)
-			ev.events |= EPOLLIN;
-		if (mode & PollSet::POLL_WRITE)
-			ev.events |= EPOLLOUT;
-		if (mode & PollSet::POLL_ERROR)
-			ev.events |= EPOLLERR;
-		ev.data.ptr = socket.impl();
-		int err = epoll_ctl(_epollfd, EPOLL_CTL_MOD, fd, &ev);
-		if (err)
-		{
-			SocketImpl::error();
-		}
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		updateImpl(socket, mode);
 	}
 
 	void clear()
@@ -151,11 +237,13 @@ public:
 
 		::close(_epollfd);
 		_socketMap.clear();
+		_dataMap.clear();
 		_epollfd = epoll_create(1);
 		if (_epollfd < 0)
 		{
-			SocketImpl::error();
+			error();
 		}
+		addWakeUpEvent();
 	}
 
 	PollSet::SocketModeMap poll(const Poco::Timespan& timeout)
@@ -164,13 +252,72 @@ public:
 
 		if (_socketMap.empty()) return result;
 
+		int rc = wait(timeout, &_events[0], static_cast<int>(_events.size()));
+
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		for (int i = 0; i < rc; i++)
+		{
+			void* key = _events[i].data.ptr;
+			DataMap::const_iterator itd = _dataMap.find(key);
+			if (itd != _dataMap.end()) key = itd->second;
+			SocketMap::iterator it = _socketMap.find(key);
+			if (it != _socketMap.end())
+			{
+				result[it->second.socket] |= pollMode(_events[i].events);
+			}
+		}
+
+		return result;
+	}
+
+	int poll(const Poco::Timespan& timeout, PollSet::Event* pEvents, int maxEvents)
+	{
+		poco_check_ptr (pEvents);
+		poco_assert (maxEvents > 0);
+
+		if (maxEvents > static_cast<int>(_events.size())) maxEvents = static_cast<int>(_events.size());
+		int rc = wait(timeout, &_events[0], maxEvents);
+		for (int i = 0; i < rc; i++)
+		{
+			pEvents[i].pData = _events[i].data.ptr;
+			pEvents[i].mode  = pollMode(_events[i].events);
+		}
+		return rc;
+	}
+
+	void wakeUp()
+	{
+		_wakeUpEvent.signal();
+	}
+
+private:
+	struct SocketEntry
+	{
+		SocketEntry(): pData(0)
+		{
+		}
+
+		SocketEntry(const Socket& s, void* p): socket(s), pData(p)
+		{
+		}
+
+		Socket socket;
+		void*  pData;
+	};
+
+	typedef std::map<void*, SocketEntry> SocketMap;
+	typedef std::map<void*, void*>       DataMap;
+
+	int wait(const Poco::Timespan& timeout, struct epoll_event* pEvents, int maxEvents)
+	{
 		Poco::Timespan remainingTime(timeout);
 		int rc;
 		do
 		{
 			Poco::Timestamp start;
-			rc = epoll_wait(_epollfd, &_events[0], _events.size(), remainingTime.totalMilliseconds());
-			if (rc < 0 && SocketImpl::lastError() == POCO_EINTR)
+			rc = epoll_wait(_epollfd, pEvents, maxEvents, remainingTime.totalMilliseconds());
+			if (rc < 0 && lastError() == POCO_EINTR)
 			{
 				Poco::Timestamp end;
 				Poco::Timespan waited = end - start;
@@ -180,33 +327,438 @@ public:
 					remainingTime = 0;
 			}
 		}
-		while (rc < 0 && SocketImpl::lastError() == POCO_EINTR);
-		if (rc < 0) SocketImpl::error();
+		while (rc < 0 && lastError() == POCO_EINTR);
+		if (rc < 0) error();
+
+		// remove the wake up event from the ready events
+		int n = 0;
+		for (int i = 0; i < rc; i++)
+		{
+			if (pEvents[i].data.ptr == &_wakeUpEvent)
+				_wakeUpEvent.reset();
+			else
+				pEvents[n++] = pEvents[i];
+		}
+		return n;
+	}
+
+	void addWakeUpEvent()
+	{
+		struct epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.ptr = &_wakeUpEvent;
+		if (epoll_ctl(_epollfd, EPOLL_CTL_ADD, _wakeUpEvent.fd(), &ev)) error();
+	}
 
+	void updateImpl(const Socket& socket, int mode)
+	{
+		SocketImpl* sockImpl = socket.impl();
+		poco_socket_t fd = sockImpl->sockfd();
+		struct epoll_event ev;
+		ev.events = epollEvents(mode);
+		ev.data.ptr = sockImpl;
+		SocketMap::const_iterator it = _socketMap.find(sockImpl);
+		if (it != _socketMap.end() && it->second.pData)
+			ev.data.ptr = it->second.pData;
+		int err = epoll_ctl(_epollfd, EPOLL_CTL_MOD, fd, &ev);
+		if (err)
+		{
+			error();
+		}
+	}
+
+	void setData(SocketImpl* sockImpl, void* pData)
+	{
+		SocketMap::const_iterator it = _socketMap.find(sockImpl);
+		if (it != _socketMap.end() && it->second.pData)
+			_dataMap.erase(it->second.pData);
+		if (pData)
+			_dataMap[pData] = sockImpl;
+	}
+
+	static uint32_t epollEvents(int mode)
+	{
+		uint32_t events = 0;
+		if (mode & PollSet::POLL_READ)
+			events |= EPOLLIN;
+		if (mode & PollSet::POLL_WRITE)
+			events |= EPOLLOUT;
+		if (mode & PollSet::POLL_ERROR)
+			events |= EPOLLERR;
+		if (mode & PollSet::POLL_EDGE)
+			events |= EPOLLET;
+		if (mode & PollSet::POLL_ONESHOT)
+			events |= EPOLLONESHOT;
+		return events;
+	}
+
+	static int pollMode(uint32_t events)
+	{
+		int mode = 0;
+		if (events & EPOLLIN)
+			mode |= PollSet::POLL_READ;
+		if (events & EPOLLOUT)
+			mode |= PollSet::POLL_WRITE;
+		if (events & EPOLLERR)
+			mode |= PollSet::POLL_ERROR;
+		return mode;
+	}
+
+	mutable Poco::FastMutex         _mutex;
+	int                             _epollfd;
+	SocketMap                       _socketMap;
+	DataMap                         _dataMap;
+	std::vector<struct epoll_event> _events;
+	WakeUpEvent                     _wakeUpEvent;
+};
+
+
+//
+// Linux implementation using io_uring
+//
+class IOUringPollSetImpl: public PollSetImpl
+	/// Sockets are polled with IORING_OP_POLL_ADD operations.
+	/// Level-triggered polls are one-shot operations that are
+	/// re-armed in a single batch before the next wait, edge-triggered
+	/// polls use multi-shot operations where supported.
+	///
+	/// The user data of a poll operation consists of the index of
+	/// the socket's slot and the slot's generation, which is incremented
+	/// whenever the slot is released or its poll operation is replaced,
+	/// so that completions for stale operations are ignored.
+{
+public:
+	IOUringPollSetImpl():
+		_ring(RING_ENTRIES),
+		_completions(RING_ENTRIES),
+		_multiShot(true),
+		_waiting(false),
+		_wakeUpArmed(false)
+	{
+		_rearm.reserve(RING_ENTRIES);
+		_ready.reserve(RING_ENTRIES);
+	}
+
+	void add(const Socket& socket, int mode, void* pData)
+	{
 		Poco::FastMutex::ScopedLock lock(_mutex);
 
-		for (int i = 0; i < rc; i++)
+		IndexMap::iterator it = _index.find(socket.impl());
+		if (it != _index.end())
 		{
-			std::map<void*, Socket>::iterator it = _socketMap.find(_events[i].data.ptr);
-			if (it != _socketMap.end())
+			_slots[it->second].pData = pData;
+			replace(it->second, mode);
+		}
+		else
+		{
+			int index;
+			if (_freeSlots.empty())
 			{
-				if (_events[i].events & EPOLLIN)
-					result[it->second] |= PollSet::POLL_READ;
-				if (_events[i].events & EPOLLOUT)
-					result[it->second] |= PollSet::POLL_WRITE;
-				if (_events[i].events & EPOLLERR)
-					result[it->second] |= PollSet::POLL_ERROR;
+				index = static_cast<int>(_slots.size());
+				_slots.push_back(Slot());
 			}
+			else
+			{
+				index = _freeSlots.back();
+				_freeSlots.pop_back();
+			}
+			Slot& slot = _slots[index];
+			slot.socket = socket;
+			slot.pData  = pData;
+			slot.mode   = mode;
+			slot.used   = true;
+			_index[socket.impl()] = index;
+			arm(index);
+		}
+		if (_waiting) _ring.submit();
+	}
+
+	void remove(const Socket& socket)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		IndexMap::iterator it = _index.find(socket.impl());
+		if (it == _index.end()) error(ENOENT);
+
+		int index = it->second;
+		Slot& slot = _slots[index];
+		if (slot.armed) _ring.prepareRemovePoll(userData(index), REMOVE_USER_DATA);
+		release(index);
+		_index.erase(it);
+		// submit immediately, as the pending poll operation keeps the socket open
+		_ring.submit();
+	}
+
+	bool has(const Socket& socket) const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		SocketImpl* sockImpl = socket.impl();
+		return sockImpl && _index.find(sockImpl) != _index.end();
+	}
+
+	bool empty() const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		return _index.empty();
+	}
+
+	void update(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		IndexMap::iterator it = _index.find(socket.impl());
+		if (it == _index.end()) error(ENOENT);
+
+		replace(it->second, mode);
+		if (_waiting) _ring.submit();
+	}
+
+	void clear()
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		for (IndexMap::iterator it = _index.begin(); it != _index.end(); ++it)
+		{
+			if (_slots[it->second].armed) _ring.prepareRemovePoll(userData(it->second), REMOVE_USER_DATA);
+			release(it->second);
 		}
+		_index.clear();
+		_rearm.clear();
+		_ring.submit();
+	}
+
+	PollSet::SocketModeMap poll(const Poco::Timespan& timeout)
+	{
+		PollSet::SocketModeMap result;
 
+		int n = wait(timeout, static_cast<int>(_completions.size()));
+		for (int i = 0; i < n; i++)
+		{
+			result[_ready[i].socket] |= _ready[i].mode;
+		}
+		_ready.clear();
 		return result;
 	}
 
+	int poll(const Poco::Timespan& timeout, PollSet::Event* pEvents, int maxEvents)
+	{
+		poco_check_ptr (pEvents);
+		poco_assert (maxEvents > 0);
+
+		int n = wait(timeout, maxEvents);
+		for (int i = 0; i < n; i++)
+		{
+			pEvents[i].pData = _ready[i].pData ? _ready[i].pData : _ready[i].socket.impl();
+			pEvents[i].mode  = _ready[i].mode;
+		}
+		_ready.clear();
+		return n;
+	}
+
+	void wakeUp()
+	{
+		_wakeUpEvent.signal();
+	}
+
 private:
-	mutable Poco::FastMutex         _mutex;
-	int                             _epollfd;
-	std::map<void*, Socket>         _socketMap;
-	std::vector<struct epoll_event> _events;
+	struct Slot
+	{
+		Slot():
+			pData(0),
+			mode(0),
+			generation(0),
+			used(false),
+			armed(false)
+		{
+		}
+
+		Socket       socket;
+		void*        pData;
+		int          mode;
+		Poco::UInt32 generation;
+		bool         used;
+		bool         armed;
+	};
+
+	struct Ready
+		/// A ready socket, copied from its slot while the mutex is
+		/// held, as the slot may be released or reused by another
+		/// thread once the mutex has been unlocked.
+	{
+		Ready(const Slot& slot, int m):
+			socket(slot.socket),
+			pData(slot.pData),
+			mode(m)
+		{
+		}
+
+		Socket socket;
+		void*  pData;
+		int    mode;
+	};
+
+	typedef std::map<void*, int>                   IndexMap;
+	typedef std::vector<Slot>                      SlotVec;
+	typedef std::vector<Ready>                     ReadyVec;
+	typedef std::vector<IOUring::Completion>       CompletionVec;
+
+	enum
+	{
+		RING_ENTRIES = 1024
+	};
+
+	static const Poco::UInt64 REMOVE_USER_DATA = ~Poco::UInt64(0);
+	static const Poco::UInt64 WAKEUP_USER_DATA = ~Poco::UInt64(1);
+
+	Poco::UInt64 userData(int index) const
+	{
+		return (static_cast<Poco::UInt64>(_slots[index].generation) << 32) | static_cast<Poco::UInt32>(index);
+	}
+
+	void arm(int index)
+	{
+		Slot& slot = _slots[index];
+		int mode = slot.mode & (PollSet::POLL_READ | PollSet::POLL_WRITE | PollSet::POLL_ERROR);
+		bool multiShot = _multiShot && (slot.mode & PollSet::POLL_EDGE);
+		_ring.preparePoll(slot.socket.impl()->sockfd(), mode, userData(index), multiShot);
+		slot.armed = true;
+	}
+
+	void replace(int index, int mode)
+	{
+		Slot& slot = _slots[index];
+		if (slot.armed) _ring.prepareRemovePoll(userData(index), REMOVE_USER_DATA);
+		++slot.generation;
+		slot.mode = mode;
+		arm(index);
+	}
+
+	void release(int index)
+	{
+		Slot& slot = _slots[index];
+		slot.socket = Socket();
+		slot.pData  = 0;
+		slot.used   = false;
+		slot.armed  = false;
+		++slot.generation;
+		_freeSlots.push_back(index);
+	}
+
+	int wait(const Poco::Timespan& timeout, int maxEvents)
+		/// Waits until a socket is ready, wakeUp() is called or the
+		/// timeout expires. Completions of remove operations and of
+		/// stale poll operations are consumed without ending the wait.
+	{
+		Poco::Timespan remainingTime(timeout);
+		bool wokenUp = false;
+		do
+		{
+			Poco::Timestamp start;
+			if (!submitAndWait(remainingTime)) return 0;
+			if (collect(maxEvents, wokenUp) > 0 || wokenUp) break;
+			Poco::Timestamp end;
+			Poco::Timespan waited = end - start;
+			if (waited < remainingTime)
+				remainingTime -= waited;
+			else
+				remainingTime = 0;
+		}
+		while (remainingTime > 0);
+		return static_cast<int>(_ready.size());
+	}
+
+	bool submitAndWait(const Poco::Timespan& timeout)
+		/// Re-arms polls and submits pending operations, then waits
+		/// for a completion. Returns false if there is nothing to wait for.
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			for (std::vector<int>::const_iterator it = _rearm.begin(); it != _rearm.end(); ++it)
+			{
+				const Slot& slot = _slots[*it];
+				if (slot.used && !slot.armed) arm(*it);
+			}
+			_rearm.clear();
+			if (_index.empty())
+			{
+				_ready.clear();
+				return false;
+			}
+			if (!_wakeUpArmed)
+			{
+				_ring.preparePoll(_wakeUpEvent.fd(), PollSet::POLL_READ, WAKEUP_USER_DATA);
+				_wakeUpArmed = true;
+			}
+			_ring.submit();
+			_waiting = true;
+		}
+
+		// Wait without holding the mutex, so that sockets can be
+		// added and removed by other threads in the meantime.
+		_ring.wait(1, timeout);
+		return true;
+	}
+
+	int collect(int maxEvents, bool& wokenUp)
+		/// Processes the available completions and stores the
+		/// ready sockets in _ready. Sets wokenUp to true if
+		/// wakeUp() has been called.
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_waiting = false;
+		_ready.clear();
+		if (maxEvents > static_cast<int>(_completions.size())) maxEvents = static_cast<int>(_completions.size());
+		int n = _ring.completions(&_completions[0], maxEvents);
+		for (int i = 0; i < n; i++)
+		{
+			const IOUring::Completion& completion = _completions[i];
+			if (completion.userData == REMOVE_USER_DATA) continue;
+			if (completion.userData == WAKEUP_USER_DATA)
+			{
+				_wakeUpEvent.reset();
+				_wakeUpArmed = false;
+				wokenUp = true;
+				continue;
+			}
+
+			int index = static_cast<int>(completion.userData & 0xFFFFFFFF);
+			Poco::UInt32 generation = static_cast<Poco::UInt32>(completion.userData >> 32);
+			if (index >= static_cast<int>(_slots.size())) continue;
+			Slot& slot = _slots[index];
+			if (!slot.used || slot.generation != generation) continue;
+
+			if (!(completion.flags & IOUring::COMPLETION_MORE))
+			{
+				slot.armed = false;
+				if (!(slot.mode & PollSet::POLL_ONESHOT) || completion.result < 0)
+					_rearm.push_back(index);
+			}
+			if (completion.result < 0)
+			{
+				// multi-shot polls are not supported by older kernels
+				if (completion.result == -EINVAL) _multiShot = false;
+				continue;
+			}
+			int mode = IOUring::pollMode(completion.result);
+			if (mode) _ready.push_back(Ready(slot, mode));
+		}
+		return static_cast<int>(_ready.size());
+	}
+
+	mutable Poco::FastMutex _mutex;
+	IOUring                 _ring;
+	SlotVec                 _slots;
+	std::vector<int>        _freeSlots;
+	IndexMap                _index;
+	std::vector<int>        _rearm;
+	ReadyVec                _ready;
+	CompletionVec           _completions;
+	bool                    _multiShot;
+	bool                    _waiting;
+	WakeUpEvent             _wakeUpEvent;
+	bool                    _wakeUpArmed;
 };
 
 
@@ -219,7 +771,7 @@ private:
 class PollSetImpl
 {
 public:
-	void add(const Socket& socket, int mode)
+	void add(const Socket& socket, int mode, void* pData)
 	{
 		Poco::FastMutex::ScopedLock lock(_mutex);
 
@@ -227,6 +779,10 @@ public:
 		_addMap[fd] = mode;
 		_removeSet.erase(fd);
 		_socketMap[fd] = socket;
+		if (pData)
+			_dataMap[fd] = pData;
+		else
+			_dataMap.erase(fd);
 	}
 
 	void remove(const Socket& socket)
@@ -237,6 +793,7 @@ public:
 		_removeSet.insert(fd);
 		_addMap.erase(fd);
 		_socketMap.erase(fd);
+		_dataMap.erase(fd);
 	}
 
 	bool has(const Socket& socket) const
@@ -276,6 +833,7 @@ public:
 		Poco::FastMutex::ScopedLock lock(_mutex);
 
 		_socketMap.clear();
+		_dataMap.clear();
 		_addMap.clear();
 		_removeSet.clear();
 		_pollfds.clear();
@@ -371,9 +929,31 @@ public:
 		return result;
 	}
 
+	int poll(const Poco::Timespan& timeout, PollSet::Event* pEvents, int maxEvents)
+	{
+		PollSet::SocketModeMap sm = poll(timeout);
+
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		int n = 0;
+		for (PollSet::SocketModeMap::const_iterator it = sm.begin(); it != sm.end() && n < maxEvents; ++it, ++n)
+		{
+			std::map<poco_socket_t, void*>::const_iterator itd = _dataMap.find(it->first.impl()->sockfd());
+			pEvents[n].pData = itd != _dataMap.end() ? itd->second : it->first.impl();
+			pEvents[n].mode  = it->second;
+		}
+		return n;
+	}
+
+	void wakeUp()
+	{
+		// not supported; poll() returns when the timeout expires
+	}
+
 private:
 	mutable Poco::FastMutex         _mutex;
 	std::map<poco_socket_t, Socket> _socketMap;
+	std::map<poco_socket_t, void*>  _dataMap;
 	std::map<poco_socket_t, int>    _addMap;
 	std::set<poco_socket_t>         _removeSet;
 	std::vector<pollfd>             _pollfds;
@@ -389,16 +969,21 @@ private:
 class PollSetImpl
 {
 public:
-	void add(const Socket& socket, int mode)
+	void add(const Socket& socket, int mode, void* pData)
 	{
 		Poco::FastMutex::ScopedLock lock(_mutex);
 		_map[socket] = mode;
+		if (pData)
+			_dataMap[socket] = pData;
+		else
+			_dataMap.erase(socket);
 	}
 
 	void remove(const Socket& socket)
 	{
 		Poco::FastMutex::ScopedLock lock(_mutex);
 		_map.erase(socket);
+		_dataMap.erase(socket);
 	}
 
 	bool has(const Socket& socket) const
@@ -423,6 +1008,7 @@ public:
 	{
 		Poco::FastMutex::ScopedLock lock(_mutex);
 		_map.clear();
+		_dataMap.clear();
 	}
 
 	PollSet::SocketModeMap poll(const Poco::Timespan& timeout)
@@ -514,18 +1100,77 @@ public:
 		return result;
 	}
 
+	int poll(const Poco::Timespan& timeout, PollSet::Event* pEvents, int maxEvents)
+	{
+		PollSet::SocketModeMap sm = poll(timeout);
+
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		int n = 0;
+		for (PollSet::SocketModeMap::const_iterator it = sm.begin(); it != sm.end() && n < maxEvents; ++it, ++n)
+		{
+			std::map<Socket, void*>::const_iterator itd = _dataMap.find(it->first);
+			pEvents[n].pData = itd != _dataMap.end() ? itd->second : it->first.impl();
+			pEvents[n].mode  = it->second;
+		}
+		return n;
+	}
+
+	void wakeUp()
+	{
+		// not supported; poll() returns when the timeout expires
+	}
+
 private:
 	mutable Poco::FastMutex _mutex;
 	PollSet::SocketModeMap  _map;
+	std::map<Socket, void*> _dataMap;
 };
 
 
 #endif
 
 
+namespace
+{
+	PollSetImpl* createPollSetImpl(PollSet::Implementation& impl)
+	{
+#if defined(POCO_HAVE_FD_EPOLL)
+		if (impl == PollSet::PS_IO_URING && IOUring::available())
+		{
+			try
+			{
+				return new IOUringPollSetImpl;
+			}
+			catch (Poco::Exception&)
+			{
+				// fall back to epoll, e.g. if the ring cannot be
+				// created due to resource limits
+			}
+		}
+		impl = PollSet::PS_DEFAULT;
+		return new EPollSetImpl;
+#else
+		impl = PollSet::PS_DEFAULT;
+		return new PollSetImpl;
+#endif
+	}
+}
+
+
 PollSet::PollSet():
-	_pImpl(new PollSetImpl)
+	_pImpl(0),
+	_implementation(PS_DEFAULT)
+{
+	_pImpl = createPollSetImpl(_implementation);
+}
+
+
+PollSet::PollSet(Implementation impl):
+	_pImpl(0),
+	_implementation(impl)
 {
+	_pImpl = createPollSetImpl(_implementation);
 }
 
 
@@ -537,7 +1182,13 @@ PollSet::~PollSet()
 
 void PollSet::add(const Socket& socket, int mode)
 {
-	_pImpl->add(socket, mode);
+	_pImpl->add(socket, mode, 0);
+}
+
+
+void PollSet::add(const Socket& socket, int mode, void* pData)
+{
+	_pImpl->add(socket, mode, pData);
 }
 
 
@@ -577,4 +1228,16 @@ PollSet::SocketModeMap PollSet::poll(const Poco::Timespan& timeout)
 }
 
 
+int PollSet::poll(const Poco::Timespan& timeout, Event* pEvents, int maxEvents)
+{
+	return _pImpl->poll(timeout, pEvents, maxEvents);
+}
+
+
+void PollSet::wakeUp()
+{
+	_pImpl->wakeUp();
+}
+
+
 } } // namespace Poco::Net
@@ -15,6 +15,7 @@
 #include "Poco/Net/RemoteSyslogListener.h"
 #include "Poco/Net/RemoteSyslogChannel.h"
 #include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/DatagramBatch.h"
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/Runnable.h"
 #include "Poco/Notification.h"
@@ -24,7 +25,6 @@
 #include "Poco/DateTimeParser.h"
 #include "Poco/Message.h"
 #include "Poco/LoggingFactory.h"
-#include "Poco/Buffer.h"
 #include "Poco/Ascii.h"
 #include <cstddef>
 
@@ -84,7 +84,8 @@ public:
 	enum
 	{
 		WAITTIME_MILLISEC = 1000,
-		BUFFER_SIZE = 65536
+		BUFFER_SIZE = 65536,
+		BATCH_SIZE = 16
 	};
 	
 	RemoteUDPListener(Poco::NotificationQueue& queue, Poco::UInt16 port);
@@ -115,7 +116,7 @@ RemoteUDPListener::~RemoteUDPListener()
 
 void RemoteUDPListener::run()
 {
-	Poco::Buffer<char> buffer(BUFFER_SIZE);
+	Poco::Net::DatagramBatch batch(BATCH_SIZE, BUFFER_SIZE);
 	Poco::Timespan waitTime(WAITTIME_MILLISEC* 1000);
 	while (!_stopped)
 	{
@@ -123,11 +124,13 @@ void RemoteUDPListener::run()
 		{
 			if (_socket.poll(waitTime, Socket::SELECT_READ))
 			{
-				Poco::Net::SocketAddress sourceAddress;
-				int n = _socket.receiveFrom(buffer.begin(), BUFFER_SIZE, sourceAddress);
-				if (n > 0)
+				int n = _socket.receiveBatch(batch);
+				for (int i = 0; i < n; i++)
 				{
-					_queue.enqueueNotification(new MessageNotification(buffer.begin(), n, sourceAddress));
+					if (batch.length(i) > 0)
+					{
+						_queue.enqueueNotification(new MessageNotification(batch.data(i), batch.length(i), batch.address(i)));
+					}
 				}
 			}
 		}
@@ -0,0 +1,41 @@
+//
+// ServerMetrics.cpp
+//
+// Library: Net
+// Package: TCPServer
+// Module:  ServerMetrics
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/ServerMetrics.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+ServerMetrics::ServerMetrics(const std::string& prefix):
+	_connections(counter(prefix + "_connections_total", "Number of connections handled.")),
+	_queueTime(histogram(prefix + "_queue_time_microseconds", "Time from accepting a connection to dispatching it to a thread.")),
+	_requests(counter(prefix + "_requests_total", "Number of HTTP requests handled.")),
+	_keepAliveRequests(counter(prefix + "_keepalive_requests_total", "Number of HTTP requests on reused persistent connections.")),
+	_bytesReceived(counter(prefix + "_received_bytes_total", "Number of bytes received.")),
+	_bytesSent(counter(prefix + "_sent_bytes_total", "Number of bytes sent.")),
+	_parseTime(histogram(prefix + "_parse_time_microseconds", "Time for reading and parsing HTTP request headers.")),
+	_handlerTime(histogram(prefix + "_handler_time_microseconds", "Time spent in HTTP request handlers.")),
+	_writeTime(histogram(prefix + "_write_time_microseconds", "Time for completing HTTP responses after the handler returned."))
+{
+}
+
+
+ServerMetrics::~ServerMetrics()
+{
+}
+
+
+} } // namespace Poco::Net
@@ -15,9 +15,16 @@
 #include "Poco/Net/SocketImpl.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/Net/StreamSocketImpl.h"
+#include "Poco/Net/Socket.h"
+#include "Poco/Net/DatagramBatch.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/Timestamp.h"
+#include "Poco/FileStream.h"
+#include "Poco/Buffer.h"
 #include <string.h> // FD_SET needs memset on some platforms, so we can't use <cstring>
+#include <algorithm>
+#include <climits>
+#include <atomic>
 #if defined(POCO_HAVE_FD_EPOLL)
 #include <sys/epoll.h>
 #elif defined(POCO_HAVE_FD_POLL)
@@ -25,6 +32,14 @@
 #endif
 
 
+#if POCO_OS == POCO_OS_LINUX
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <netinet/udp.h>
+#endif
+
+
 #if defined(sun) || defined(__sun) || defined(__sun__)
 #include <unistd.h>
 #include <stropts.h>
@@ -47,6 +62,33 @@ namespace Poco {
 namespace Net {
 
 
+#if defined(POCO_HAVE_MMSG)
+
+
+namespace
+{
+	enum
+	{
+		MMSG_CHUNK = 64,
+			/// Maximum number of datagrams passed to a single
+			/// sendmmsg() or recvmmsg() call, and maximum
+			/// number of segments for UDP segmentation offload.
+		MAX_SEGMENTED_SIZE = 65507
+			/// Maximum total payload for UDP segmentation offload.
+	};
+
+#if defined(UDP_SEGMENT)
+	std::atomic<int> segmentationSupport(-1);
+		/// -1: unknown, 0: not supported, 1: supported.
+		/// This only depends on the kernel, so it is
+		/// determined once per process.
+#endif
+}
+
+
+#endif // POCO_HAVE_MMSG
+
+
 bool checkIsBrokenTimeout()
 {
 #if defined(POCO_BROKEN_TIMEOUTS)
@@ -347,6 +389,222 @@ int SocketImpl::receiveBytes(void* buffer, int length, int flags)
 }
 
 
+int SocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	if (_isBrokenTimeout)
+	{
+		if (_sndTimeout.totalMicroseconds() != 0)
+		{
+			if (!poll(_sndTimeout, SELECT_WRITE))
+				throw TimeoutException();
+		}
+	}
+
+	int rc;
+	do
+	{
+		if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+#if defined(POCO_OS_FAMILY_WINDOWS)
+		DWORD sent = 0;
+		rc = WSASend(_sockfd, const_cast<LPWSABUF>(buffers.empty() ? 0 : &buffers[0]), static_cast<DWORD>(buffers.size()), &sent, static_cast<DWORD>(flags), 0, 0);
+		if (rc == 0) rc = static_cast<int>(sent);
+#else
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = const_cast<struct iovec*>(buffers.empty() ? 0 : &buffers[0]);
+		msg.msg_iovlen = buffers.size();
+#if defined(IOV_MAX)
+		// buffers beyond IOV_MAX are left for the next call
+		if (msg.msg_iovlen > IOV_MAX) msg.msg_iovlen = IOV_MAX;
+#endif
+		rc = ::sendmsg(_sockfd, &msg, flags);
+#endif
+	}
+	while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+	if (rc < 0) error();
+	return rc;
+}
+
+
+int SocketImpl::receiveBytes(SocketBufVec& buffers, int flags)
+{
+	if (_isBrokenTimeout)
+	{
+		if (_recvTimeout.totalMicroseconds() != 0)
+		{
+			if (!poll(_recvTimeout, SELECT_READ))
+				throw TimeoutException();
+		}
+	}
+
+	int rc;
+	do
+	{
+		if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+#if defined(POCO_OS_FAMILY_WINDOWS)
+		DWORD received = 0;
+		DWORD dwFlags = static_cast<DWORD>(flags);
+		rc = WSARecv(_sockfd, buffers.empty() ? 0 : &buffers[0], static_cast<DWORD>(buffers.size()), &received, &dwFlags, 0, 0);
+		if (rc == 0) rc = static_cast<int>(received);
+#else
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = buffers.empty() ? 0 : &buffers[0];
+		msg.msg_iovlen = buffers.size();
+#if defined(IOV_MAX)
+		if (msg.msg_iovlen > IOV_MAX) msg.msg_iovlen = IOV_MAX;
+#endif
+		rc = ::recvmsg(_sockfd, &msg, flags);
+#endif
+	}
+	while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+	if (rc < 0)
+	{
+		int err = lastError();
+		if (err == POCO_EAGAIN && !_blocking)
+			;
+		else if (err == POCO_EAGAIN || err == POCO_ETIMEDOUT)
+			throw TimeoutException(err);
+		else
+			error(err);
+	}
+	return rc;
+}
+
+
+std::streamsize SocketImpl::sendFile(FileInputStream& fileInputStream, std::streamoff offset, std::streamsize count)
+{
+#if POCO_OS == POCO_OS_LINUX
+	if (_isBrokenTimeout) return sendFileCopy(fileInputStream, offset, count);
+
+	int fd = fileInputStream.nativeHandle();
+	struct stat st;
+	if (::fstat(fd, &st) != 0) return sendFileCopy(fileInputStream, offset, count);
+
+	// the kernel transfers at most 0x7ffff000 bytes per call
+	const std::streamsize maxChunk = 0x7ffff000;
+	std::streamsize sent = 0;
+	if (S_ISFIFO(st.st_mode))
+	{
+		if (offset != 0) throw InvalidArgumentException("Cannot send a pipe from an offset");
+
+		while (count == 0 || sent < count)
+		{
+			if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+			std::streamsize n = count == 0 ? maxChunk : std::min(count - sent, maxChunk);
+			ssize_t rc = ::splice(fd, NULL, _sockfd, NULL, static_cast<size_t>(n), SPLICE_F_MOVE | SPLICE_F_MORE);
+			if (rc < 0)
+			{
+				int err = lastError();
+				if (err == POCO_EINTR && _blocking) continue;
+				if (err == POCO_EAGAIN && !_blocking) break;
+				if (sent == 0 && (err == POCO_EINVAL || err == ENOSYS)) return sendFileCopy(fileInputStream, offset, count);
+				if (err == POCO_EAGAIN || err == POCO_ETIMEDOUT) throw TimeoutException(err);
+				error(err);
+			}
+			if (rc == 0) break;
+			sent += rc;
+		}
+	}
+	else if (S_ISREG(st.st_mode))
+	{
+		if (offset >= st.st_size) return 0;
+		if (count == 0 || count > st.st_size - offset) count = st.st_size - offset;
+
+		off_t off = offset;
+		while (sent < count)
+		{
+			if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+			ssize_t rc = ::sendfile(_sockfd, fd, &off, static_cast<size_t>(std::min(count - sent, maxChunk)));
+			if (rc < 0)
+			{
+				int err = lastError();
+				if (err == POCO_EINTR && _blocking) continue;
+				if (err == POCO_EAGAIN && !_blocking) break;
+				if (sent == 0 && (err == POCO_EINVAL || err == ENOSYS)) return sendFileCopy(fileInputStream, offset, count);
+				if (err == POCO_EAGAIN || err == POCO_ETIMEDOUT) throw TimeoutException(err);
+				error(err);
+			}
+			if (rc == 0) break; // file has been truncated
+			sent += rc;
+		}
+	}
+	else return sendFileCopy(fileInputStream, offset, count);
+	return sent;
+#else
+	return sendFileCopy(fileInputStream, offset, count);
+#endif
+}
+
+
+std::streamsize SocketImpl::sendFileCopy(FileInputStream& fileInputStream, std::streamoff offset, std::streamsize count)
+{
+	if (offset != 0)
+	{
+		fileInputStream.clear();
+		fileInputStream.seekg(offset, std::ios::beg);
+		if (!fileInputStream.good()) throw InvalidArgumentException("Cannot seek to file offset");
+	}
+
+	Poco::Buffer<char> buffer(8192);
+	std::streamsize sent = 0;
+	while ((count == 0 || sent < count) && fileInputStream.good())
+	{
+		std::streamsize n = static_cast<std::streamsize>(buffer.size());
+		if (count != 0 && count - sent < n) n = count - sent;
+		fileInputStream.read(buffer.begin(), n);
+		n = fileInputStream.gcount();
+		if (n == 0) break;
+		const char* p = buffer.begin();
+		while (n > 0)
+		{
+			int rc = sendBytes(p, static_cast<int>(n));
+			if (rc <= 0) throw IOException("Cannot send file contents");
+			p += rc;
+			n -= rc;
+			sent += rc;
+		}
+	}
+	return sent;
+}
+
+
+int SocketImpl::sendBytesCopy(const SocketBufVec& buffers, int flags)
+{
+	if (buffers.size() == 1)
+		return sendBytes(Socket::bufferData(buffers[0]), static_cast<int>(Socket::bufferSize(buffers[0])), flags);
+
+	Poco::Buffer<char> buffer(Socket::bufferSize(buffers));
+	char* p = buffer.begin();
+	for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+	{
+		memcpy(p, Socket::bufferData(*it), Socket::bufferSize(*it));
+		p += Socket::bufferSize(*it);
+	}
+	return sendBytes(buffer.begin(), static_cast<int>(buffer.size()), flags);
+}
+
+
+int SocketImpl::receiveBytesCopy(SocketBufVec& buffers, int flags)
+{
+	if (buffers.size() == 1)
+		return receiveBytes(Socket::bufferData(buffers[0]), static_cast<int>(Socket::bufferSize(buffers[0])), flags);
+
+	Poco::Buffer<char> buffer(Socket::bufferSize(buffers));
+	int rc = receiveBytes(buffer.begin(), static_cast<int>(buffer.size()), flags);
+	const char* p = buffer.begin();
+	std::size_t remaining = rc > 0 ? static_cast<std::size_t>(rc) : 0;
+	for (SocketBufVec::iterator it = buffers.begin(); it != buffers.end() && remaining > 0; ++it)
+	{
+		std::size_t n = std::min(remaining, Socket::bufferSize(*it));
+		memcpy(Socket::bufferData(*it), p, n);
+		p += n;
+		remaining -= n;
+	}
+	return rc;
+}
+
+
 int SocketImpl::sendTo(const void* buffer, int length, const SocketAddress& address, int flags)
 {
 	int rc;
@@ -404,6 +662,220 @@ int SocketImpl::receiveFrom(void* buffer, int length, SocketAddress& address, in
 }
 
 
+int SocketImpl::sendBatch(const DatagramBatch& batch, int flags)
+{
+	if (batch.empty()) return 0;
+	if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+
+	std::size_t sent = 0;
+#if defined(POCO_HAVE_MMSG)
+	struct iovec iov[MMSG_CHUNK];
+#if defined(UDP_SEGMENT)
+	// If all datagrams go to the same IP address and have the same size,
+	// except for a shorter last one, let the kernel do the splitting.
+	const std::size_t segmentSize = batch.length(0);
+	const poco_socklen_t addrLen = batch.addressLength(0);
+	bool segment = segmentationSupport != 0
+		&& batch.size() > 1 && batch.size() <= MMSG_CHUNK
+		&& segmentSize > 0 && segmentSize*batch.size() <= MAX_SEGMENTED_SIZE
+		&& addrLen > 0
+		&& (batch.addressBuffer(0)->sa_family == AF_INET || batch.addressBuffer(0)->sa_family == AF_INET6);
+	for (std::size_t i = 1; segment && i < batch.size(); i++)
+	{
+		segment = batch.addressLength(i) == addrLen
+			&& memcmp(batch.addressBuffer(i), batch.addressBuffer(0), addrLen) == 0
+			&& (batch.length(i) == segmentSize || (i == batch.size() - 1 && batch.length(i) > 0 && batch.length(i) < segmentSize));
+	}
+	if (segment && segmentationSupport < 0)
+	{
+		// kernels without UDP_SEGMENT silently ignore the control message
+		int value;
+		socklen_t len = sizeof(value);
+		segmentationSupport = ::getsockopt(_sockfd, IPPROTO_UDP, UDP_SEGMENT, &value, &len) == 0 ? 1 : 0;
+		segment = segmentationSupport == 1;
+	}
+	if (segment)
+	{
+		for (std::size_t i = 0; i < batch.size(); i++)
+		{
+			iov[i].iov_base = const_cast<char*>(batch.data(i));
+			iov[i].iov_len = batch.length(i);
+		}
+		char control[CMSG_SPACE(sizeof(Poco::UInt16))];
+		memset(control, 0, sizeof(control));
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_name = const_cast<struct sockaddr*>(batch.addressBuffer(0));
+		msg.msg_namelen = addrLen;
+		msg.msg_iov = iov;
+		msg.msg_iovlen = batch.size();
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		struct cmsghdr* pCmsg = CMSG_FIRSTHDR(&msg);
+		pCmsg->cmsg_level = IPPROTO_UDP;
+		pCmsg->cmsg_type = UDP_SEGMENT;
+		pCmsg->cmsg_len = CMSG_LEN(sizeof(Poco::UInt16));
+		Poco::UInt16 gsoSize = static_cast<Poco::UInt16>(segmentSize);
+		memcpy(CMSG_DATA(pCmsg), &gsoSize, sizeof(gsoSize));
+		int rc;
+		do
+		{
+			rc = ::sendmsg(_sockfd, &msg, flags);
+		}
+		while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+		if (rc >= 0) return static_cast<int>(batch.size());
+		int err = lastError();
+		// EIO means that the route's device cannot do checksum offload;
+		// in that case, and for anything the kernel rejects, use sendmmsg()
+		if (err != EIO && err != EINVAL && err != ENOPROTOOPT && err != EOPNOTSUPP)
+			error(err);
+	}
+#endif // UDP_SEGMENT
+	struct mmsghdr msgs[MMSG_CHUNK];
+	while (sent < batch.size())
+	{
+		std::size_t n = std::min<std::size_t>(batch.size() - sent, MMSG_CHUNK);
+		memset(msgs, 0, n*sizeof(struct mmsghdr));
+		for (std::size_t i = 0; i < n; i++)
+		{
+			iov[i].iov_base = const_cast<char*>(batch.data(sent + i));
+			iov[i].iov_len = batch.length(sent + i);
+			msgs[i].msg_hdr.msg_iov = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			if (batch.addressLength(sent + i) > 0)
+			{
+				msgs[i].msg_hdr.msg_name = const_cast<struct sockaddr*>(batch.addressBuffer(sent + i));
+				msgs[i].msg_hdr.msg_namelen = batch.addressLength(sent + i);
+			}
+		}
+		int rc;
+		do
+		{
+			if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+			rc = ::sendmmsg(_sockfd, msgs, static_cast<unsigned>(n), flags);
+		}
+		while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+		if (rc < 0)
+		{
+			if (sent > 0) break;
+			error();
+		}
+		sent += rc;
+	}
+#else
+	for (; sent < batch.size(); sent++)
+	{
+		const struct sockaddr* pSA = batch.addressLength(sent) > 0 ? batch.addressBuffer(sent) : 0;
+		int rc;
+		do
+		{
+			if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+#if defined(POCO_VXWORKS)
+			rc = ::sendto(_sockfd, (char*) batch.data(sent), static_cast<int>(batch.length(sent)), flags, (sockaddr*) pSA, batch.addressLength(sent));
+#else
+			rc = ::sendto(_sockfd, batch.data(sent), static_cast<int>(batch.length(sent)), flags, pSA, batch.addressLength(sent));
+#endif
+		}
+		while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+		if (rc < 0)
+		{
+			if (sent > 0) break;
+			error();
+		}
+	}
+#endif // POCO_HAVE_MMSG
+	return static_cast<int>(sent);
+}
+
+
+int SocketImpl::receiveBatch(DatagramBatch& batch, int flags)
+{
+	if (_isBrokenTimeout)
+	{
+		if (_recvTimeout.totalMicroseconds() != 0)
+		{
+			if (!poll(_recvTimeout, SELECT_READ))
+				throw TimeoutException();
+		}
+	}
+
+	batch.clear();
+	std::size_t received = 0;
+#if defined(POCO_HAVE_MMSG)
+	struct mmsghdr msgs[MMSG_CHUNK];
+	struct iovec iov[MMSG_CHUNK];
+	while (received < batch.capacity())
+	{
+		std::size_t n = std::min<std::size_t>(batch.capacity() - received, MMSG_CHUNK);
+		memset(msgs, 0, n*sizeof(struct mmsghdr));
+		for (std::size_t i = 0; i < n; i++)
+		{
+			iov[i].iov_base = batch.data(received + i);
+			iov[i].iov_len = batch.datagramSize();
+			msgs[i].msg_hdr.msg_iov = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_name = batch.addressBuffer(received + i);
+			msgs[i].msg_hdr.msg_namelen = SocketAddress::MAX_ADDRESS_LENGTH;
+		}
+		// only wait for the very first datagram
+		int chunkFlags = flags | (received == 0 ? MSG_WAITFORONE : MSG_DONTWAIT);
+		int rc;
+		do
+		{
+			if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+			rc = ::recvmmsg(_sockfd, msgs, static_cast<unsigned>(n), chunkFlags, 0);
+		}
+		while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+		if (rc < 0)
+		{
+			if (received > 0) break;
+			int err = lastError();
+			if (err == POCO_EAGAIN && !_blocking)
+				return -1;
+			else if (err == POCO_EAGAIN || err == POCO_ETIMEDOUT)
+				throw TimeoutException(err);
+			else
+				error(err);
+		}
+		for (int i = 0; i < rc; i++)
+		{
+			batch.setDatagram(received + i, msgs[i].msg_len, msgs[i].msg_hdr.msg_namelen);
+		}
+		received += rc;
+		batch.setSize(received);
+		if (static_cast<std::size_t>(rc) < n) break;
+	}
+#else
+	do
+	{
+		poco_socklen_t saLen = SocketAddress::MAX_ADDRESS_LENGTH;
+		int rc;
+		do
+		{
+			if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+			rc = ::recvfrom(_sockfd, batch.data(received), static_cast<int>(batch.datagramSize()), flags, batch.addressBuffer(received), &saLen);
+		}
+		while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+		if (rc < 0)
+		{
+			if (received > 0) break;
+			int err = lastError();
+			if (err == POCO_EAGAIN && !_blocking)
+				return -1;
+			else if (err == POCO_EAGAIN || err == POCO_ETIMEDOUT)
+				throw TimeoutException(err);
+			else
+				error(err);
+		}
+		batch.setDatagram(received, rc, saLen);
+		batch.setSize(++received);
+	}
+	while (received < batch.capacity() && poll(Poco::Timespan(0), SELECT_READ));
+#endif // POCO_HAVE_MMSG
+	return static_cast<int>(received);
+}
+
+
 void SocketImpl::sendUrgent(unsigned char data)
 {
 	if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
@@ -427,6 +899,12 @@ bool SocketImpl::secure() const
 }
 
 
+std::string SocketImpl::getALPNProtocol()
+{
+	return std::string();
+}
+
+
 bool SocketImpl::poll(const Poco::Timespan& timeout, int mode)
 {
 	poco_socket_t sockfd = _sockfd;
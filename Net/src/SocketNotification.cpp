@@ -80,6 +80,17 @@ TimeoutNotification::~TimeoutNotification()
 }
 
 
+DeadlineNotification::DeadlineNotification(SocketReactor* pReactor):
+	SocketNotification(pReactor)
+{
+}
+
+
+DeadlineNotification::~DeadlineNotification()
+{
+}
+
+
 IdleNotification::IdleNotification(SocketReactor* pReactor):
 	SocketNotification(pReactor)
 {
@@ -33,12 +33,15 @@ namespace Net {
 SocketReactor::SocketReactor():
 	_stop(false),
 	_timeout(DEFAULT_TIMEOUT),
+	_options(OPT_DEFAULT),
+	_pollFlags(0),
 	_pReadableNotification(new ReadableNotification(this)),
 	_pWritableNotification(new WritableNotification(this)),
 	_pErrorNotification(new ErrorNotification(this)),
 	_pTimeoutNotification(new TimeoutNotification(this)),
 	_pIdleNotification(new IdleNotification(this)),
 	_pShutdownNotification(new ShutdownNotification(this)),
+	_pDeadlineNotification(new DeadlineNotification(this)),
 	_pThread(0)
 {
 }
@@ -47,17 +50,46 @@ SocketReactor::SocketReactor():
 SocketReactor::SocketReactor(const Poco::Timespan& timeout):
 	_stop(false),
 	_timeout(timeout),
+	_options(OPT_DEFAULT),
+	_pollFlags(0),
 	_pReadableNotification(new ReadableNotification(this)),
 	_pWritableNotification(new WritableNotification(this)),
 	_pErrorNotification(new ErrorNotification(this)),
 	_pTimeoutNotification(new TimeoutNotification(this)),
 	_pIdleNotification(new IdleNotification(this)),
 	_pShutdownNotification(new ShutdownNotification(this)),
+	_pDeadlineNotification(new DeadlineNotification(this)),
 	_pThread(0)
 {
 }
 
 
+SocketReactor::SocketReactor(const Poco::Timespan& timeout, int options):
+	_stop(false),
+	_timeout(timeout),
+	_options(options),
+	_pollFlags(0),
+	_pollSet((options & OPT_IO_URING) ? PollSet::PS_IO_URING : PollSet::PS_DEFAULT),
+	_pReadableNotification(new ReadableNotification(this)),
+	_pWritableNotification(new WritableNotification(this)),
+	_pErrorNotification(new ErrorNotification(this)),
+	_pTimeoutNotification(new TimeoutNotification(this)),
+	_pIdleNotification(new IdleNotification(this)),
+	_pShutdownNotification(new ShutdownNotification(this)),
+	_pDeadlineNotification(new DeadlineNotification(this)),
+	_pThread(0)
+{
+	if (_options & (OPT_EDGE_TRIGGERED | OPT_ONESHOT))
+		_options |= OPT_FAST_DISPATCH;
+	if (_options & OPT_EDGE_TRIGGERED)
+		_pollFlags |= PollSet::POLL_EDGE;
+	if (_options & OPT_ONESHOT)
+		_pollFlags |= PollSet::POLL_ONESHOT;
+	if (_options & OPT_FAST_DISPATCH)
+		_events.resize(MAX_EVENTS);
+}
+
+
 SocketReactor::~SocketReactor()
 {
 }
@@ -66,6 +98,11 @@ SocketReactor::~SocketReactor()
 void SocketReactor::run()
 {
 	_pThread = Thread::current();
+	if (_options & OPT_FAST_DISPATCH)
+	{
+		runFast();
+		return;
+	}
 	while (!_stop)
 	{
 		try
@@ -73,14 +110,18 @@ void SocketReactor::run()
 			if (!hasSocketHandlers())
 			{
 				onIdle();
-				Timespan::TimeDiff ms = _timeout.totalMilliseconds();
+				bool deadline;
+				Timespan::TimeDiff ms = pollTimeout(deadline).totalMilliseconds();
 				poco_assert_dbg(ms <= std::numeric_limits<long>::max());
 				Thread::trySleep(static_cast<long>(ms));
+				dispatchDeadlines();
+				runTasks();
 			}
 			else
 			{
 				bool readable = false;
-				PollSet::SocketModeMap sm = _pollSet.poll(_timeout);
+				bool deadline = false;
+				PollSet::SocketModeMap sm = _pollSet.poll(pollTimeout(deadline));
 				if (sm.size() > 0)
 				{
 					onBusy();
@@ -97,7 +138,9 @@ void SocketReactor::run()
 						if (it->second & PollSet::POLL_ERROR) dispatch(it->first, _pErrorNotification);
 					}
 				}
-				if (!readable) onTimeout();
+				dispatchDeadlines();
+				// a wake up for posted tasks or a deadline is not a timeout
+				if (!runTasks() && !readable && !deadline) onTimeout();
 			}
 		}
 		catch (Exception& exc)
@@ -113,10 +156,101 @@ void SocketReactor::run()
 			ErrorHandler::handle();
 		}
 	}
+	runTasks();
 	onShutdown();
 }
 
 
+void SocketReactor::runFast()
+{
+	while (!_stop)
+	{
+		try
+		{
+			{
+				// Notifiers removed while the previous poll() was in progress
+				// may still have been reported by it, so they are kept alive
+				// until here. Clearing the vector does not release its storage.
+				ScopedLock lock(_mutex);
+				_removed.clear();
+			}
+			if (_pollSet.empty())
+			{
+				onIdle();
+				bool deadline;
+				Timespan::TimeDiff ms = pollTimeout(deadline).totalMilliseconds();
+				poco_assert_dbg(ms <= std::numeric_limits<long>::max());
+				Thread::trySleep(static_cast<long>(ms));
+				dispatchDeadlines();
+				runTasks();
+			}
+			else
+			{
+				bool readable = false;
+				bool deadline = false;
+				int n = _pollSet.poll(pollTimeout(deadline), &_events[0], static_cast<int>(_events.size()));
+				if (n > 0)
+				{
+					onBusy();
+					for (int i = 0; i < n; i++)
+					{
+						SocketNotifier* pNotifier = static_cast<SocketNotifier*>(_events[i].pData);
+						int mode = _events[i].mode;
+						if (mode & PollSet::POLL_READ)
+						{
+							dispatch(pNotifier, _pReadableNotification);
+							readable = true;
+						}
+						if (mode & PollSet::POLL_WRITE) dispatch(pNotifier, _pWritableNotification);
+						if (mode & PollSet::POLL_ERROR) dispatch(pNotifier, _pErrorNotification);
+						if (_pollFlags & PollSet::POLL_ONESHOT) rearm(pNotifier);
+					}
+				}
+				dispatchDeadlines();
+				// a wake up for posted tasks or a deadline is not a timeout
+				if (!runTasks() && !readable && !deadline) onTimeout();
+			}
+		}
+		catch (Exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (std::exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (...)
+		{
+			ErrorHandler::handle();
+		}
+	}
+	runTasks();
+	onShutdown();
+}
+
+
+void SocketReactor::rearm(SocketNotifier* pNotifier)
+{
+	ScopedLock lock(_mutex);
+
+	if (pNotifier->hasObservers())
+	{
+		int mode = pollMode(pNotifier);
+		if (mode) _pollSet.update(pNotifier->socket(), mode | _pollFlags);
+	}
+}
+
+
+int SocketReactor::pollMode(SocketNotifier* pNotifier)
+{
+	int mode = 0;
+	if (pNotifier->accepts(_pReadableNotification)) mode |= PollSet::POLL_READ;
+	if (pNotifier->accepts(_pWritableNotification)) mode |= PollSet::POLL_WRITE;
+	if (pNotifier->accepts(_pErrorNotification))    mode |= PollSet::POLL_ERROR;
+	return mode;
+}
+
+
 bool SocketReactor::hasSocketHandlers()
 {
 	ScopedLock lock(_mutex);
@@ -135,18 +269,88 @@ bool SocketReactor::hasSocketHandlers()
 }
 
 
+Poco::Timespan SocketReactor::pollTimeout(bool& deadline)
+{
+	ScopedLock lock(_mutex);
+
+	Poco::Timespan timeout = _deadlines.nextTimeout();
+	deadline = !(timeout < 0 || timeout > _timeout);
+	if (!deadline) return _timeout;
+
+	// round up, as the PollSet waits for whole milliseconds
+	return Poco::Timespan(((timeout.totalMicroseconds() + 999)/1000)*1000);
+}
+
+
+void SocketReactor::dispatchDeadlines()
+{
+	{
+		ScopedLock lock(_mutex);
+
+		_deadlines.advance(_expiredTimers);
+		for (TimerWheel::TimerVec::iterator it = _expiredTimers.begin(); it != _expiredTimers.end(); ++it)
+		{
+			_expired.push_back(NotifierPtr(static_cast<SocketNotifier*>((*it)->owner()), true));
+		}
+		_expiredTimers.clear();
+	}
+	for (NotifierVec::iterator it = _expired.begin(); it != _expired.end(); ++it)
+	{
+		dispatch(*it, _pDeadlineNotification);
+	}
+	_expired.clear();
+}
+
+
+bool SocketReactor::runTasks()
+{
+	bool ran = false;
+	Task task;
+	while (_tasks.pop(task))
+	{
+		ran = true;
+		try
+		{
+			task();
+		}
+		catch (Exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (std::exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (...)
+		{
+			ErrorHandler::handle();
+		}
+	}
+	return ran;
+}
+
+
 void SocketReactor::stop()
 {
 	_stop = true;
+	_pollSet.wakeUp();
 }
 
 
 void SocketReactor::wakeUp()
 {
+	_pollSet.wakeUp();
 	if (_pThread) _pThread->wakeUp();
 }
 
 
+void SocketReactor::post(const Task& task)
+{
+	_tasks.push(task);
+	wakeUp();
+}
+
+
 void SocketReactor::setTimeout(const Poco::Timespan& timeout)
 {
 	_timeout = timeout;
@@ -177,11 +381,14 @@ void SocketReactor::addEventHandler(const Socket& socket, const Poco::AbstractOb
 			pNotifier->addObserver(this, observer);
 	}
 
-	int mode = 0;
-	if (pNotifier->accepts(_pReadableNotification)) mode |= PollSet::POLL_READ;
-	if (pNotifier->accepts(_pWritableNotification)) mode |= PollSet::POLL_WRITE;
-	if (pNotifier->accepts(_pErrorNotification))    mode |= PollSet::POLL_ERROR;
-	if (mode) _pollSet.add(socket, mode);
+	int mode = pollMode(pNotifier);
+	if (mode)
+	{
+		if (_options & OPT_FAST_DISPATCH)
+			_pollSet.add(socket, mode | _pollFlags, pNotifier.get());
+		else
+			_pollSet.add(socket, mode);
+	}
 }
 
 
@@ -216,7 +423,10 @@ void SocketReactor::removeEventHandler(const Socket& socket, const Poco::Abstrac
 			if (pNotifier->hasObserver(observer) && pNotifier->countObservers() == 1)
 			{
 				_handlers.erase(it);
+				_deadlines.cancel(pNotifier->timer());
 				_pollSet.remove(socket);
+				if (_options & OPT_FAST_DISPATCH)
+					_removed.push_back(pNotifier);
 			}
 		}
 
@@ -234,6 +444,38 @@ bool SocketReactor::has(const Socket& socket) const
 }
 
 
+void SocketReactor::scheduleDeadline(const Socket& socket, const Poco::Timespan& timeout)
+{
+	{
+		ScopedLock lock(_mutex);
+
+		EventHandlerMap::iterator it = _handlers.find(socket);
+		if (it == _handlers.end()) throw Poco::NotFoundException("No event handler registered for socket");
+		_deadlines.schedule(it->second->timer(), timeout);
+	}
+	if (Thread::current() != _pThread) wakeUp();
+}
+
+
+void SocketReactor::cancelDeadline(const Socket& socket)
+{
+	ScopedLock lock(_mutex);
+
+	EventHandlerMap::iterator it = _handlers.find(socket);
+	if (it != _handlers.end())
+		_deadlines.cancel(it->second->timer());
+}
+
+
+bool SocketReactor::hasDeadline(const Socket& socket) const
+{
+	ScopedLock lock(_mutex);
+
+	EventHandlerMap::const_iterator it = _handlers.find(socket);
+	return it != _handlers.end() && it->second->timer().scheduled();
+}
+
+
 void SocketReactor::onTimeout()
 {
 	dispatch(_pTimeoutNotification);
@@ -289,6 +531,12 @@ void SocketReactor::dispatch(SocketNotification* pNotification)
 
 
 void SocketReactor::dispatch(NotifierPtr& pNotifier, SocketNotification* pNotification)
+{
+	dispatch(pNotifier.get(), pNotification);
+}
+
+
+void SocketReactor::dispatch(SocketNotifier* pNotifier, SocketNotification* pNotification)
 {
 	try
 	{
@@ -121,6 +121,12 @@ int StreamSocket::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+int StreamSocket::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	return impl()->sendBytes(buffers, flags);
+}
+
+
 int StreamSocket::sendBytes(FIFOBuffer& fifoBuf)
 {
 	ScopedLock<Mutex> l(fifoBuf.mutex());
@@ -137,6 +143,12 @@ int StreamSocket::receiveBytes(void* buffer, int length, int flags)
 }
 
 
+int StreamSocket::receiveBytes(SocketBufVec& buffers, int flags)
+{
+	return impl()->receiveBytes(buffers, flags);
+}
+
+
 int StreamSocket::receiveBytes(FIFOBuffer& fifoBuf)
 {
 	ScopedLock<Mutex> l(fifoBuf.mutex());
@@ -147,6 +159,18 @@ int StreamSocket::receiveBytes(FIFOBuffer& fifoBuf)
 }
 
 
+std::streamsize StreamSocket::sendFile(FileInputStream& fileInputStream, std::streamoff offset, std::streamsize count)
+{
+	return impl()->sendFile(fileInputStream, offset, count);
+}
+
+
+std::string StreamSocket::getALPNProtocol()
+{
+	return impl()->getALPNProtocol();
+}
+
+
 void StreamSocket::sendUrgent(unsigned char data)
 {
 	impl()->sendUrgent(data);
@@ -13,6 +13,7 @@
 
 
 #include "Poco/Net/StreamSocketImpl.h"
+#include "Poco/Net/Socket.h"
 #include "Poco/Exception.h"
 #include "Poco/Thread.h"
 
@@ -74,4 +75,34 @@ int StreamSocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+int StreamSocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	int sent = SocketImpl::sendBytes(buffers, flags);
+	std::size_t total = Socket::bufferSize(buffers);
+	if (sent < 0 || !getBlocking()) return sent;
+
+	SocketBufVec remaining;
+	while (static_cast<std::size_t>(sent) < total)
+	{
+		// skip what has been sent and continue with the rest
+		if (remaining.empty()) remaining = buffers;
+		SocketBufVec::iterator it = remaining.begin();
+		std::size_t n = static_cast<std::size_t>(sent) - (total - Socket::bufferSize(remaining));
+		while (it != remaining.end() && n >= Socket::bufferSize(*it))
+		{
+			n -= Socket::bufferSize(*it);
+			++it;
+		}
+		*it = Socket::makeBuffer(Socket::bufferData(*it) + n, Socket::bufferSize(*it) - n);
+		remaining.erase(remaining.begin(), it);
+
+		Poco::Thread::yield();
+		int rc = SocketImpl::sendBytes(remaining, flags);
+		poco_assert_dbg (rc >= 0);
+		sent += rc;
+	}
+	return sent;
+}
+
+
 } } // namespace Poco::Net
@@ -0,0 +1,136 @@
+//
+// StubResolver.cpp
+//
+// Library: Net
+// Package: NetCore
+// Module:  StubResolver
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/StubResolver.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/FileStream.h"
+#include "Poco/String.h"
+#include "Poco/StringTokenizer.h"
+#include <algorithm>
+
+
+namespace Poco {
+namespace Net {
+
+
+StubResolver::StubResolver()
+{
+}
+
+
+StubResolver::StubResolver(HostResolver::Ptr pFallback):
+	_pFallback(pFallback)
+{
+}
+
+
+StubResolver::~StubResolver()
+{
+}
+
+
+void StubResolver::addHost(const std::string& hostname, const IPAddress& address)
+{
+	addHost(hostname, address, HostEntry::AliasList());
+}
+
+
+void StubResolver::addHost(const std::string& hostname, const IPAddress& address, const HostEntry::AliasList& aliases)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	HostEntry::AliasList names(aliases);
+	names.insert(names.begin(), hostname);
+	for (HostEntry::AliasList::const_iterator it = names.begin(); it != names.end(); ++it)
+	{
+		Host& host = _hosts[Poco::toLower(*it)];
+		if (host.name.empty()) host.name = hostname;
+		for (HostEntry::AliasList::const_iterator itAlias = aliases.begin(); itAlias != aliases.end(); ++itAlias)
+		{
+			if (*itAlias != host.name && std::find(host.aliases.begin(), host.aliases.end(), *itAlias) == host.aliases.end())
+				host.aliases.push_back(*itAlias);
+		}
+		if (std::find(host.addresses.begin(), host.addresses.end(), address) == host.addresses.end())
+			host.addresses.push_back(address);
+	}
+}
+
+
+void StubResolver::removeHost(const std::string& hostname)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_hosts.erase(Poco::toLower(hostname));
+}
+
+
+void StubResolver::clear()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_hosts.clear();
+}
+
+
+void StubResolver::load(std::istream& istr)
+{
+	std::string line;
+	while (std::getline(istr, line))
+	{
+		std::string::size_type pos = line.find('#');
+		if (pos != std::string::npos) line.resize(pos);
+		Poco::StringTokenizer tok(line, " \t\r", Poco::StringTokenizer::TOK_IGNORE_EMPTY);
+		IPAddress address;
+		if (tok.count() >= 2 && IPAddress::tryParse(tok[0], address))
+		{
+			HostEntry::AliasList aliases(tok.begin() + 2, tok.end());
+			addHost(tok[1], address, aliases);
+		}
+	}
+}
+
+
+void StubResolver::load(const std::string& path)
+{
+	Poco::FileInputStream istr(path);
+	load(istr);
+}
+
+
+HostEntry StubResolver::resolve(const std::string& hostname)
+{
+	++_lookups;
+
+	IPAddress address;
+	if (IPAddress::tryParse(hostname, address))
+	{
+		return HostEntry(hostname, HostEntry::AddressList(1, address));
+	}
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		HostMap::const_iterator it = _hosts.find(Poco::toLower(hostname));
+		if (it != _hosts.end())
+		{
+			return HostEntry(it->second.name, it->second.addresses, it->second.aliases);
+		}
+	}
+	if (_pFallback)
+		return _pFallback->resolve(hostname);
+	else
+		throw HostNotFoundException(hostname);
+}
+
+
+} } // namespace Poco::Net
@@ -19,6 +19,8 @@
 #include "Poco/Timespan.h"
 #include "Poco/Exception.h"
 #include "Poco/ErrorHandler.h"
+#include "Poco/Environment.h"
+#include "Poco/NumberFormatter.h"
 
 
 using Poco::ErrorHandler;
@@ -38,48 +40,96 @@ TCPServerConnectionFilter::~TCPServerConnectionFilter()
 }
 
 
+//
+// TCPServer::Acceptor
+//
+
+
+class TCPServer::Acceptor: public Poco::Runnable
+	/// An additional listening socket with its own
+	/// acceptor thread and dispatcher.
+{
+public:
+	Acceptor(TCPServer& server, const ServerSocket& socket, TCPServerDispatcher* pDispatcher):
+		_server(server),
+		_socket(socket),
+		_pDispatcher(pDispatcher),
+		_thread(TCPServer::threadName(socket))
+	{
+	}
+
+	~Acceptor()
+	{
+		_pDispatcher->release();
+	}
+
+	void run()
+	{
+		_server.accept(_socket, _pDispatcher);
+	}
+
+	TCPServerDispatcher* dispatcher() const
+	{
+		return _pDispatcher;
+	}
+
+	Poco::Thread& thread()
+	{
+		return _thread;
+	}
+
+private:
+	TCPServer& _server;
+	ServerSocket _socket;
+	TCPServerDispatcher* _pDispatcher;
+	Poco::Thread _thread;
+};
+
+
 //
 // TCPServer
 //
 
 
 TCPServer::TCPServer(TCPServerConnectionFactory::Ptr pFactory, Poco::UInt16 portNumber, TCPServerParams::Ptr pParams):
-	_socket(ServerSocket(portNumber)),
+	_socket(createSocket(portNumber, pParams)),
+	_pDispatcher(0),
 	_thread(threadName(_socket)),
 	_stopped(true)
 {	
 	Poco::ThreadPool& pool = Poco::ThreadPool::defaultPool();
-	if (pParams)
+	if (pParams && !pParams->getThreadAffinity())
 	{
-		int toAdd = pParams->getMaxThreads() - pool.capacity();
+		int toAdd = pParams->getMaxThreads()*pParams->getAcceptors() - pool.capacity();
 		if (toAdd > 0) pool.addCapacity(toAdd);
 	}
-	_pDispatcher = new TCPServerDispatcher(pFactory, pool, pParams);
-	
+	init(pFactory, pool, pParams);
 }
 
 
 TCPServer::TCPServer(TCPServerConnectionFactory::Ptr pFactory, const ServerSocket& socket, TCPServerParams::Ptr pParams):
 	_socket(socket),
+	_pDispatcher(0),
 	_thread(threadName(socket)),
 	_stopped(true)
 {
 	Poco::ThreadPool& pool = Poco::ThreadPool::defaultPool();
-	if (pParams)
+	if (pParams && !pParams->getThreadAffinity())
 	{
-		int toAdd = pParams->getMaxThreads() - pool.capacity();
+		int toAdd = pParams->getMaxThreads()*pParams->getAcceptors() - pool.capacity();
 		if (toAdd > 0) pool.addCapacity(toAdd);
 	}
-	_pDispatcher = new TCPServerDispatcher(pFactory, pool, pParams);
+	init(pFactory, pool, pParams);
 }
 
 
 TCPServer::TCPServer(TCPServerConnectionFactory::Ptr pFactory, Poco::ThreadPool& threadPool, const ServerSocket& socket, TCPServerParams::Ptr pParams):
 	_socket(socket),
-	_pDispatcher(new TCPServerDispatcher(pFactory, threadPool, pParams)),
+	_pDispatcher(0),
 	_thread(threadName(socket)),
 	_stopped(true)
 {
+	init(pFactory, threadPool, pParams);
 }
 
 
@@ -89,6 +139,15 @@ TCPServer::~TCPServer()
 	{
 		stop();
 		_pDispatcher->release();
+		for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		{
+			delete *it;
+		}
+		// waits for connection threads still serving connections
+		for (ThreadPoolVec::iterator it = _threadPools.begin(); it != _threadPools.end(); ++it)
+		{
+			delete *it;
+		}
 	}
 	catch (...)
 	{
@@ -97,6 +156,37 @@ TCPServer::~TCPServer()
 }
 
 
+void TCPServer::init(TCPServerConnectionFactory::Ptr pFactory, Poco::ThreadPool& threadPool, TCPServerParams::Ptr pParams)
+{
+	int acceptors = pParams ? pParams->getAcceptors() : 1;
+	bool affinity = pParams && pParams->getThreadAffinity();
+
+	std::vector<ServerSocket> sockets;
+	for (int i = 1; i < acceptors; ++i)
+	{
+		sockets.push_back(createReusePortSocket());
+	}
+
+	int cpus = Poco::Environment::processorCount();
+	for (int i = 0; i < acceptors; ++i)
+	{
+		Poco::ThreadPool* pPool = &threadPool;
+		if (affinity)
+		{
+			int maxThreads = pParams->getMaxThreads() > 0 ? pParams->getMaxThreads() : threadPool.capacity();
+			pPool = new Poco::ThreadPool("TCPServer" + Poco::NumberFormatter::format(i), 1, maxThreads, 60, POCO_THREAD_STACK_SIZE, Poco::ThreadPool::TAP_CUSTOM);
+			_threadPools.push_back(pPool);
+		}
+		TCPServerDispatcher* pDispatcher = new TCPServerDispatcher(pFactory, *pPool, pParams);
+		if (affinity) pDispatcher->setAffinity(i % cpus);
+		if (i == 0)
+			_pDispatcher = pDispatcher;
+		else
+			_acceptors.push_back(new Acceptor(*this, sockets[i - 1], pDispatcher));
+	}
+}
+
+
 const TCPServerParams& TCPServer::params() const
 {
 	return _pDispatcher->params();
@@ -108,7 +198,14 @@ void TCPServer::start()
 	poco_assert (_stopped);
 
 	_stopped = false;
+	bool affinity = params().getThreadAffinity();
 	_thread.start(*this);
+	if (affinity) _thread.setAffinity(_pDispatcher->getAffinity());
+	for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		(*it)->thread().start(**it);
+		if (affinity) (*it)->thread().setAffinity((*it)->dispatcher()->getAffinity());
+	}
 }
 
 	
@@ -118,23 +215,37 @@ void TCPServer::stop()
 	{
 		_stopped = true;
 		_thread.join();
+		for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		{
+			(*it)->thread().join();
+		}
 		_pDispatcher->stop();
+		for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		{
+			(*it)->dispatcher()->stop();
+		}
 	}
 }
 
 
 void TCPServer::run()
+{
+	accept(_socket, _pDispatcher);
+}
+
+
+void TCPServer::accept(ServerSocket& socket, TCPServerDispatcher* pDispatcher)
 {
 	while (!_stopped)
 	{
 		Poco::Timespan timeout(250000);
 		try
 		{
-			if (_socket.poll(timeout, Socket::SELECT_READ))
+			if (socket.poll(timeout, Socket::SELECT_READ))
 			{
 				try
 				{
-					StreamSocket ss = _socket.acceptConnection();
+					StreamSocket ss = socket.acceptConnection();
 					
 					if (!_pConnectionFilter || _pConnectionFilter->accept(ss))
 					{
@@ -145,7 +256,7 @@ void TCPServer::run()
 						{
 							ss.setNoDelay(true);
 						}
-						_pDispatcher->enqueue(ss);
+						pDispatcher->enqueue(ss);
 					}
 				}
 				catch (Poco::Exception& exc)
@@ -175,43 +286,75 @@ void TCPServer::run()
 
 int TCPServer::currentThreads() const
 {
-	return _pDispatcher->currentThreads();
+	return total(&TCPServerDispatcher::currentThreads);
 }
 
 
 int TCPServer::maxThreads() const
 {
-	return _pDispatcher->maxThreads();
+	if (_threadPools.empty())
+		return _pDispatcher->maxThreads(); // all acceptors share one thread pool
+	else
+		return total(&TCPServerDispatcher::maxThreads);
 }
 
 	
 int TCPServer::totalConnections() const
 {
-	return _pDispatcher->totalConnections();
+	return total(&TCPServerDispatcher::totalConnections);
 }
 
 
 int TCPServer::currentConnections() const
 {
-	return _pDispatcher->currentConnections();
+	return total(&TCPServerDispatcher::currentConnections);
 }
 
 
 int TCPServer::maxConcurrentConnections() const
 {
-	return _pDispatcher->maxConcurrentConnections();
+	return total(&TCPServerDispatcher::maxConcurrentConnections);
 }
 
 	
 int TCPServer::queuedConnections() const
 {
-	return _pDispatcher->queuedConnections();
+	return total(&TCPServerDispatcher::queuedConnections);
 }
 
 
 int TCPServer::refusedConnections() const
 {
-	return _pDispatcher->refusedConnections();
+	return total(&TCPServerDispatcher::refusedConnections);
+}
+
+
+int TCPServer::stolenConnections() const
+{
+	return total(&TCPServerDispatcher::stolenConnections);
+}
+
+
+std::vector<int> TCPServer::queueDepths() const
+{
+	std::vector<int> depths = _pDispatcher->queueDepths();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		std::vector<int> more = (*it)->dispatcher()->queueDepths();
+		depths.insert(depths.end(), more.begin(), more.end());
+	}
+	return depths;
+}
+
+
+int TCPServer::total(int (TCPServerDispatcher::*pMethod)() const) const
+{
+	int result = (_pDispatcher->*pMethod)();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		result += ((*it)->dispatcher()->*pMethod)();
+	}
+	return result;
 }
 
 
@@ -223,6 +366,40 @@ void TCPServer::setConnectionFilter(const TCPServerConnectionFilter::Ptr& pConne
 }
 
 
+ServerSocket TCPServer::createSocket(Poco::UInt16 portNumber, TCPServerParams::Ptr pParams)
+{
+	if (pParams && pParams->getAcceptors() > 1)
+	{
+		ServerSocket socket;
+		socket.bind(portNumber, true, true);
+		socket.listen();
+		return socket;
+	}
+	else return ServerSocket(portNumber);
+}
+
+
+ServerSocket TCPServer::createReusePortSocket() const
+{
+	SocketAddress address = _socket.address();
+	ServerSocket socket;
+#if defined(POCO_HAVE_IPv6)
+	if (address.family() == SocketAddress::IPv6)
+	{
+		int ipV6Only = 0;
+		_socket.getOption(IPPROTO_IPV6, IPV6_V6ONLY, ipV6Only);
+		socket.bind6(address, true, true, ipV6Only != 0);
+	}
+	else
+#endif
+	{
+		socket.bind(address, true, true);
+	}
+	socket.listen();
+	return socket;
+}
+
+
 std::string TCPServer::threadName(const ServerSocket& socket)
 {
 #if _WIN32_WCE == 0x0800
@@ -17,7 +17,9 @@
 #include "Poco/Notification.h"
 #include "Poco/AutoPtr.h"
 #include "Poco/ErrorHandler.h"
+#include "Poco/Clock.h"
 #include <memory>
+#include <cstdint>
 
 
 using Poco::Notification;
@@ -46,8 +48,126 @@ public:
 		return _socket;
 	}
 
+	const Poco::Clock& queued() const
+	{
+		return _queued;
+	}
+
 private:
 	StreamSocket _socket;
+	Poco::Clock _queued;
+};
+
+
+struct TCPQueuedSocket
+	/// A socket in a WorkQueue, together with
+	/// the time it has been queued.
+{
+	explicit TCPQueuedSocket(const StreamSocket& s):
+		socket(s)
+	{
+	}
+
+	StreamSocket socket;
+	Poco::Clock queued;
+};
+
+
+class TCPServerDispatcher::WorkQueue
+	/// A bounded, lock-free multi-producer/multi-consumer
+	/// queue of sockets. Each slot carries a sequence number
+	/// that tells producers and consumers whether the slot
+	/// is free for writing or ready for reading.
+{
+public:
+	WorkQueue(std::size_t capacity):
+		_mask(capacity - 1),
+		_cells(new Cell[capacity]),
+		_enqueuePos(0),
+		_dequeuePos(0)
+	{
+		poco_assert ((capacity & _mask) == 0);
+
+		for (std::size_t i = 0; i < capacity; ++i)
+		{
+			_cells[i].sequence.store(i, std::memory_order_relaxed);
+			_cells[i].pSocket = 0;
+		}
+	}
+
+	~WorkQueue()
+	{
+		TCPQueuedSocket* pSocket;
+		while ((pSocket = pop())) delete pSocket;
+	}
+
+	bool push(TCPQueuedSocket* pSocket)
+	{
+		Cell* pCell;
+		std::size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			pCell = &_cells[pos & _mask];
+			std::size_t seq = pCell->sequence.load(std::memory_order_acquire);
+			std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+			if (diff == 0)
+			{
+				if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0) return false;
+			else pos = _enqueuePos.load(std::memory_order_relaxed);
+		}
+		pCell->pSocket = pSocket;
+		pCell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	TCPQueuedSocket* pop()
+	{
+		Cell* pCell;
+		std::size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			pCell = &_cells[pos & _mask];
+			std::size_t seq = pCell->sequence.load(std::memory_order_acquire);
+			std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+			if (diff == 0)
+			{
+				if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0) return 0;
+			else pos = _dequeuePos.load(std::memory_order_relaxed);
+		}
+		TCPQueuedSocket* pSocket = pCell->pSocket;
+		pCell->sequence.store(pos + _mask + 1, std::memory_order_release);
+		return pSocket;
+	}
+
+	int size() const
+	{
+		std::size_t enq = _enqueuePos.load(std::memory_order_relaxed);
+		std::size_t deq = _dequeuePos.load(std::memory_order_relaxed);
+		return enq > deq ? static_cast<int>(enq - deq) : 0;
+	}
+
+private:
+	WorkQueue();
+	WorkQueue(const WorkQueue&);
+	WorkQueue& operator = (const WorkQueue&);
+
+	struct Cell
+	{
+		std::atomic<std::size_t> sequence;
+		TCPQueuedSocket* pSocket;
+	};
+
+	const std::size_t _mask;
+	std::unique_ptr<Cell[]> _cells;
+	std::atomic<std::size_t> _enqueuePos;
+	char _pad[64];
+	std::atomic<std::size_t> _dequeuePos;
 };
 
 
@@ -61,20 +181,53 @@ TCPServerDispatcher::TCPServerDispatcher(TCPServerConnectionFactory::Ptr pFactor
 	_refusedConnections(0),
 	_stopped(false),
 	_pConnectionFactory(pFactory),
-	_threadPool(threadPool)
+	_threadPool(threadPool),
+	_activeQueueCount(0),
+	_nextQueue(0),
+	_queued(0),
+	_idleThreads(0),
+	_stolenConnections(0),
+	_cpu(-1)
 {
 	poco_check_ptr (pFactory);
 
 	if (!_pParams)
 		_pParams = new TCPServerParams;
+
+	_pMetrics = _pParams->getMetrics();
 	
 	if (_pParams->getMaxThreads() == 0)
 		_pParams->setMaxThreads(threadPool.capacity());
+
+	if (_pParams->getDispatchMode() == TCPServerParams::DISPATCH_WORK_STEALING)
+	{
+		// Size each queue so that a fair share of maxQueued fits,
+		// with some headroom for uneven distribution. If the chosen
+		// queue is full, enqueueWorkStealing() tries the others.
+		int workers = _pParams->getMaxThreads();
+		std::size_t share = 2*static_cast<std::size_t>(_pParams->getMaxQueued())/workers + 1;
+		std::size_t capacity = 16;
+		while (capacity < share) capacity <<= 1;
+		_workQueues.reserve(workers);
+		_freeQueues.reserve(workers);
+		_activeQueues.reset(new std::atomic<int>[workers]);
+		for (int i = 0; i < workers; ++i)
+		{
+			_workQueues.push_back(new WorkQueue(capacity));
+			// the first thread started gets queue 0
+			_freeQueues.push_back(workers - i - 1);
+			_activeQueues[i].store(0, std::memory_order_relaxed);
+		}
+	}
 }
 
 
 TCPServerDispatcher::~TCPServerDispatcher()
 {
+	for (WorkQueueVec::iterator it = _workQueues.begin(); it != _workQueues.end(); ++it)
+	{
+		delete *it;
+	}
 }
 
 
@@ -94,6 +247,15 @@ void TCPServerDispatcher::run()
 {
 	AutoPtr<TCPServerDispatcher> guard(this, false); // ensure _rc is decreased when function exits
 
+	if (_workQueues.empty())
+		runQueue();
+	else
+		runWorkStealing();
+}
+
+
+void TCPServerDispatcher::runQueue()
+{
 	int idleTime = (int) _pParams->getThreadIdleTime().totalMilliseconds();
 
 	for (;;)
@@ -108,11 +270,7 @@ void TCPServerDispatcher::run()
 					TCPConnectionNotification* pCNf = dynamic_cast<TCPConnectionNotification*>(pNf.get());
 					if (pCNf)
 					{
-						std::unique_ptr<TCPServerConnection> pConnection(_pConnectionFactory->createConnection(pCNf->socket()));
-						poco_check_ptr(pConnection.get());
-						beginConnection();
-						pConnection->start();
-						endConnection();
+						handleConnection(pCNf->socket(), pCNf->queued());
 					}
 				}
 			}
@@ -125,6 +283,110 @@ void TCPServerDispatcher::run()
 }
 
 
+void TCPServerDispatcher::runWorkStealing()
+{
+	long idleTime = static_cast<long>(_pParams->getThreadIdleTime().totalMilliseconds());
+	std::size_t nQueues = _workQueues.size();
+	int own;
+	{
+		// startThread() has reserved a queue for this thread
+		FastMutex::ScopedLock lock(_mutex);
+		poco_assert (!_startingQueues.empty());
+		own = _startingQueues.back();
+		_startingQueues.pop_back();
+	}
+
+	while (!_stopped)
+	{
+		TCPQueuedSocket* pSocket = _workQueues[own]->pop();
+		for (std::size_t i = 1; !pSocket && i < nQueues; ++i)
+		{
+			pSocket = _workQueues[(own + i) % nQueues]->pop();
+			if (pSocket) ++_stolenConnections;
+		}
+		if (pSocket)
+		{
+			std::unique_ptr<TCPQueuedSocket> pGuard(pSocket);
+			--_queued;
+			try
+			{
+				handleConnection(pSocket->socket, pSocket->queued);
+			}
+			catch (Poco::Exception &exc) { ErrorHandler::handle(exc); }
+			catch (std::exception &exc)  { ErrorHandler::handle(exc); }
+			catch (...)                  { ErrorHandler::handle();    }
+		}
+		else
+		{
+			// _idleThreads is incremented before _queued is checked, and
+			// enqueueWorkStealing() increments _queued before checking
+			// _idleThreads, so at least one side sees the other.
+			bool timedOut = false;
+			{
+				FastMutex::ScopedLock lock(_idleMutex);
+				++_idleThreads;
+				while (!_stopped && _queued == 0 && !timedOut)
+				{
+					timedOut = !_idleCondition.tryWait(_idleMutex, idleTime);
+				}
+				--_idleThreads;
+			}
+			if (timedOut && _queued == 0)
+			{
+				FastMutex::ScopedLock lock(_mutex);
+				if (_currentThreads > 1)
+				{
+					--_currentThreads;
+					deactivateWorkQueue(own);
+					return;
+				}
+			}
+		}
+	}
+	FastMutex::ScopedLock lock(_mutex);
+	deactivateWorkQueue(own);
+}
+
+
+void TCPServerDispatcher::activateWorkQueue(int queue)
+{
+	int n = _activeQueueCount.load(std::memory_order_relaxed);
+	_activeQueues[n].store(queue, std::memory_order_relaxed);
+	_activeQueueCount.store(n + 1, std::memory_order_release);
+}
+
+
+void TCPServerDispatcher::deactivateWorkQueue(int queue)
+{
+	int n = _activeQueueCount.load(std::memory_order_relaxed);
+	for (int i = 0; i < n; ++i)
+	{
+		if (_activeQueues[i].load(std::memory_order_relaxed) == queue)
+		{
+			_activeQueues[i].store(_activeQueues[n - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			_activeQueueCount.store(n - 1, std::memory_order_release);
+			break;
+		}
+	}
+	_freeQueues.push_back(queue);
+}
+
+
+void TCPServerDispatcher::handleConnection(const StreamSocket& socket, const Poco::Clock& queued)
+{
+	if (_pMetrics)
+	{
+		_pMetrics->queueTime().record(static_cast<Poco::UInt64>(queued.elapsed()));
+		_pMetrics->connections().add();
+	}
+	std::unique_ptr<TCPServerConnection> pConnection(_pConnectionFactory->createConnection(socket));
+	poco_check_ptr(pConnection.get());
+	beginConnection();
+	pConnection->start();
+	endConnection();
+}
+
+
 namespace
 {
 	static const std::string threadName("TCPServerConnection");
@@ -133,6 +395,12 @@ namespace
 	
 void TCPServerDispatcher::enqueue(const StreamSocket& socket)
 {
+	if (!_workQueues.empty())
+	{
+		enqueueWorkStealing(socket);
+		return;
+	}
+
 	FastMutex::ScopedLock lock(_mutex);
 
 	if (_queue.size() < _pParams->getMaxQueued())
@@ -140,20 +408,7 @@ void TCPServerDispatcher::enqueue(const StreamSocket& socket)
 		_queue.enqueueNotification(new TCPConnectionNotification(socket));
 		if (!_queue.hasIdleThreads() && _currentThreads < _pParams->getMaxThreads())
 		{
-			try
-			{
-				_threadPool.startWithPriority(_pParams->getThreadPriority(), *this, threadName);
-				++_currentThreads;
-				// Ensure this object lives at least until run() starts
-				// Small chance of leaking if threadpool is stopped before this
-				// work runs, but better than a dangling pointer and crash!
-				duplicate();
-			}
-			catch (Poco::Exception&)
-			{
-				// no problem here, connection is already queued
-				// and a new thread might be available later.
-			}
+			startThread();
 		}
 	}
 	else
@@ -163,11 +418,111 @@ void TCPServerDispatcher::enqueue(const StreamSocket& socket)
 }
 
 
+void TCPServerDispatcher::enqueueWorkStealing(const StreamSocket& socket)
+{
+	// Count the connection before publishing it in a queue, so a
+	// thread taking it from the queue never sees a negative count.
+	if (++_queued > _pParams->getMaxQueued())
+	{
+		--_queued;
+		++_refusedConnections;
+		return;
+	}
+
+	// Spread connections over the queues owned by running threads,
+	// so they do not pile up in queues that can only be emptied
+	// by stealing. Without a running thread, use the queue the
+	// next thread started will own. A thread exiting concurrently
+	// may leave a connection in its queue; it is then stolen by
+	// another thread or taken by the next thread owning the queue.
+	std::size_t nQueues = _workQueues.size();
+	int nActive = _activeQueueCount.load(std::memory_order_acquire);
+	std::size_t start = nActive > 0 ? static_cast<std::size_t>(_activeQueues[_nextQueue++ % nActive].load(std::memory_order_relaxed)) : 0;
+
+	std::unique_ptr<TCPQueuedSocket> pSocket(new TCPQueuedSocket(socket));
+	for (std::size_t i = 0; i < nQueues; ++i)
+	{
+		if (_workQueues[(start + i) % nQueues]->push(pSocket.get()))
+		{
+			pSocket.release();
+			break;
+		}
+	}
+	if (pSocket)
+	{
+		--_queued;
+		++_refusedConnections;
+		return;
+	}
+
+	if (_idleThreads > 0)
+	{
+		FastMutex::ScopedLock lock(_idleMutex);
+		_idleCondition.signal();
+	}
+	else if (_currentThreads < _pParams->getMaxThreads())
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		if (_currentThreads < _pParams->getMaxThreads())
+		{
+			startThread();
+		}
+	}
+}
+
+
+void TCPServerDispatcher::startThread()
+{
+	int queue = -1;
+	if (!_workQueues.empty())
+	{
+		// Threads that exited because the dispatcher has been
+		// stopped may still be counted in _currentThreads.
+		if (_freeQueues.empty()) return;
+		queue = _freeQueues.back();
+		_freeQueues.pop_back();
+		_startingQueues.push_back(queue);
+		activateWorkQueue(queue);
+	}
+	try
+	{
+		_threadPool.startWithPriority(_pParams->getThreadPriority(), *this, threadName, _cpu);
+		++_currentThreads;
+		// Ensure this object lives at least until run() starts
+		// Small chance of leaking if threadpool is stopped before this
+		// work runs, but better than a dangling pointer and crash!
+		duplicate();
+	}
+	catch (Poco::Exception&)
+	{
+		// no problem here, connection is already queued
+		// and a new thread might be available later.
+		if (queue >= 0)
+		{
+			_startingQueues.pop_back();
+			deactivateWorkQueue(queue);
+		}
+	}
+}
+
+
 void TCPServerDispatcher::stop()
 {
 	_stopped = true;
 	_queue.clear();
 	_queue.wakeUpAll();
+
+	for (WorkQueueVec::iterator it = _workQueues.begin(); it != _workQueues.end(); ++it)
+	{
+		TCPQueuedSocket* pSocket;
+		while ((pSocket = (*it)->pop()))
+		{
+			delete pSocket;
+			--_queued;
+		}
+	}
+	FastMutex::ScopedLock lock(_idleMutex);
+	_idleCondition.broadcast();
 }
 
 
@@ -204,7 +559,10 @@ int TCPServerDispatcher::maxConcurrentConnections() const
 
 int TCPServerDispatcher::queuedConnections() const
 {
-	return _queue.size();
+	if (_workQueues.empty())
+		return _queue.size();
+	else
+		return _queued;
 }
 
 
@@ -214,6 +572,24 @@ int TCPServerDispatcher::refusedConnections() const
 }
 
 
+int TCPServerDispatcher::stolenConnections() const
+{
+	return _stolenConnections;
+}
+
+
+std::vector<int> TCPServerDispatcher::queueDepths() const
+{
+	std::vector<int> depths;
+	depths.reserve(_workQueues.size());
+	for (WorkQueueVec::const_iterator it = _workQueues.begin(); it != _workQueues.end(); ++it)
+	{
+		depths.push_back((*it)->size());
+	}
+	return depths;
+}
+
+
 void TCPServerDispatcher::beginConnection()
 {
 	FastMutex::ScopedLock lock(_mutex);
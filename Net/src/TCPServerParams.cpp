@@ -23,7 +23,10 @@ TCPServerParams::TCPServerParams():
 	_threadIdleTime(10000000),
 	_maxThreads(0),
 	_maxQueued(64),
-	_threadPriority(Poco::Thread::PRIO_NORMAL)
+	_threadPriority(Poco::Thread::PRIO_NORMAL),
+	_dispatchMode(DISPATCH_QUEUE),
+	_acceptors(1),
+	_threadAffinity(false)
 {
 }
 
@@ -61,4 +64,30 @@ void TCPServerParams::setThreadPriority(Poco::Thread::Priority prio)
 }
 
 
+void TCPServerParams::setDispatchMode(DispatchMode mode)
+{
+	_dispatchMode = mode;
+}
+
+
+void TCPServerParams::setAcceptors(int count)
+{
+	poco_assert (count > 0);
+
+	_acceptors = count;
+}
+
+
+void TCPServerParams::setThreadAffinity(bool flag)
+{
+	_threadAffinity = flag;
+}
+
+
+void TCPServerParams::setMetrics(ServerMetrics::Ptr pMetrics)
+{
+	_pMetrics = pMetrics;
+}
+
+
 } } // namespace Poco::Net
@@ -0,0 +1,214 @@
+//
+// TimerWheel.cpp
+//
+// Library: Net
+// Package: Reactor
+// Module:  TimerWheel
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/TimerWheel.h"
+#include "Poco/Bugcheck.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+TimerWheel::Timer::Timer(void* pOwner):
+	_pOwner(pOwner),
+	_pPrev(0),
+	_pNext(0),
+	_expires(0)
+{
+}
+
+
+TimerWheel::Timer::~Timer()
+{
+}
+
+
+TimerWheel::TimerWheel(const Poco::Timespan& resolution):
+	_resolution(resolution),
+	_now(0),
+	_size(0)
+{
+	poco_assert (resolution.totalMicroseconds() > 0);
+
+	for (int level = 0; level < LEVELS; level++)
+	{
+		for (int slot = 0; slot < SLOTS; slot++)
+		{
+			Timer& head = _slots[level][slot];
+			head._pPrev = &head;
+			head._pNext = &head;
+		}
+	}
+}
+
+
+TimerWheel::~TimerWheel()
+{
+	clear();
+}
+
+
+void TimerWheel::schedule(Timer& timer, const Poco::Timespan& timeout)
+{
+	cancel(timer);
+
+	Poco::Timespan::TimeDiff res = _resolution.totalMicroseconds();
+	Poco::Timespan::TimeDiff expires = _start.elapsed() + (timeout.totalMicroseconds() > 0 ? timeout.totalMicroseconds() : 0);
+	timer._expires = static_cast<Poco::UInt64>((expires + res - 1)/res);
+	insert(timer, _now + 1);
+	++_size;
+}
+
+
+void TimerWheel::cancel(Timer& timer)
+{
+	if (timer.scheduled())
+	{
+		unlink(timer);
+		--_size;
+	}
+}
+
+
+void TimerWheel::clear()
+{
+	for (int level = 0; level < LEVELS; level++)
+	{
+		for (int slot = 0; slot < SLOTS; slot++)
+		{
+			Timer& head = _slots[level][slot];
+			while (head._pNext != &head)
+			{
+				unlink(*head._pNext);
+			}
+		}
+	}
+	_size = 0;
+}
+
+
+void TimerWheel::advance(TimerVec& expired)
+{
+	Poco::UInt64 target = ticks();
+	while (_now < target)
+	{
+		if (_size == 0)
+		{
+			_now = target;
+			break;
+		}
+		++_now;
+		for (int level = LEVELS - 1; level > 0; level--)
+		{
+			if ((_now & ((Poco::UInt64(1) << (SLOT_BITS*level)) - 1)) == 0)
+				cascade(level);
+		}
+		Timer& head = _slots[0][_now & (SLOTS - 1)];
+		while (head._pNext != &head)
+		{
+			Timer* pTimer = head._pNext;
+			unlink(*pTimer);
+			--_size;
+			expired.push_back(pTimer);
+		}
+	}
+}
+
+
+Poco::Timespan TimerWheel::nextTimeout() const
+{
+	if (_size == 0) return Poco::Timespan(-1);
+
+	Poco::UInt64 next = 0;
+	bool found = false;
+	for (int level = 0; level < LEVELS; level++)
+	{
+		// The slots of a level are processed in the order of
+		// their ticks, within the next rotation of the level.
+		int shift = SLOT_BITS*level;
+		Poco::UInt64 current = _now >> shift;
+		for (Poco::UInt64 k = current + 1; k <= current + SLOTS; k++)
+		{
+			const Timer& head = _slots[level][k & (SLOTS - 1)];
+			if (head._pNext != &head)
+			{
+				Poco::UInt64 tick = k << shift;
+				if (!found || tick < next) next = tick;
+				found = true;
+				break;
+			}
+		}
+	}
+	poco_assert_dbg (found);
+
+	Poco::Timespan::TimeDiff remaining = static_cast<Poco::Timespan::TimeDiff>(next)*_resolution.totalMicroseconds() - _start.elapsed();
+	return Poco::Timespan(remaining > 0 ? remaining : 0);
+}
+
+
+Poco::UInt64 TimerWheel::ticks() const
+{
+	return static_cast<Poco::UInt64>(_start.elapsed()/_resolution.totalMicroseconds());
+}
+
+
+void TimerWheel::insert(Timer& timer, Poco::UInt64 earliest)
+{
+	Poco::UInt64 expires = timer._expires > earliest ? timer._expires : earliest;
+	Poco::UInt64 delta = expires - _now;
+	int level = 0;
+	while (level < LEVELS - 1 && delta >= (Poco::UInt64(1) << (SLOT_BITS*(level + 1))))
+		++level;
+	Poco::UInt64 range = Poco::UInt64(1) << (SLOT_BITS*LEVELS);
+	if (delta >= range)
+	{
+		// beyond the range of the wheel; the timer will be
+		// rescheduled when its slot is cascaded
+		expires = _now + range - 1;
+	}
+	link(_slots[level][(expires >> (SLOT_BITS*level)) & (SLOTS - 1)], timer);
+}
+
+
+void TimerWheel::cascade(int level)
+{
+	Timer& head = _slots[level][(_now >> (SLOT_BITS*level)) & (SLOTS - 1)];
+	while (head._pNext != &head)
+	{
+		Timer* pTimer = head._pNext;
+		unlink(*pTimer);
+		insert(*pTimer, _now);
+	}
+}
+
+
+void TimerWheel::link(Timer& head, Timer& timer)
+{
+	timer._pPrev = head._pPrev;
+	timer._pNext = &head;
+	head._pPrev->_pNext = &timer;
+	head._pPrev = &timer;
+}
+
+
+void TimerWheel::unlink(Timer& timer)
+{
+	timer._pPrev->_pNext = timer._pNext;
+	timer._pNext->_pPrev = timer._pPrev;
+	timer._pPrev = 0;
+	timer._pNext = 0;
+}
+
+
+} } // namespace Poco::Net
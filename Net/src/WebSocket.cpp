@@ -45,6 +45,12 @@ WebSocket::WebSocket(HTTPServerRequest& request, HTTPServerResponse& response):
 }
 
 	
+WebSocket::WebSocket(HTTPServerRequest& request, HTTPServerResponse& response, const WebSocketDeflate::Params& deflateParams):
+	StreamSocket(accept(request, response, &deflateParams))
+{
+}
+
+
 WebSocket::WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response):
 	StreamSocket(connect(cs, request, response, _defaultCreds))
 {
@@ -57,6 +63,18 @@ WebSocket::WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse&
 }
 
 
+WebSocket::WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, const WebSocketDeflate::Params& deflateParams):
+	StreamSocket(connect(cs, request, response, _defaultCreds, &deflateParams))
+{
+}
+
+
+WebSocket::WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials, const WebSocketDeflate::Params& deflateParams):
+	StreamSocket(connect(cs, request, response, credentials, &deflateParams))
+{
+}
+
+
 WebSocket::WebSocket(const Socket& socket):
 	StreamSocket(socket)
 {
@@ -104,6 +122,13 @@ int WebSocket::sendFrame(const void* buffer, int length, int flags)
 }
 
 
+int WebSocket::sendFrame(const SocketBufVec& buffers, int flags)
+{
+	flags |= FRAME_OP_SETRAW;
+	return static_cast<WebSocketImpl*>(impl())->sendBytes(buffers, flags);
+}
+
+
 int WebSocket::receiveFrame(void* buffer, int length, int& flags)
 {
 	int n = static_cast<WebSocketImpl*>(impl())->receiveBytes(buffer, length, 0);
@@ -120,13 +145,35 @@ int WebSocket::receiveFrame(Poco::Buffer<char>& buffer, int& flags)
 }
 
 
+int WebSocket::receiveFrame(SocketBufVec& buffers, int& flags)
+{
+	int n = static_cast<WebSocketImpl*>(impl())->receiveBytes(buffers, 0);
+	flags = static_cast<WebSocketImpl*>(impl())->frameFlags();
+	return n;
+}
+
+
 WebSocket::Mode WebSocket::mode() const
 {
 	return static_cast<WebSocketImpl*>(impl())->mustMaskPayload() ? WS_CLIENT : WS_SERVER;
 }
 
 
-WebSocketImpl* WebSocket::accept(HTTPServerRequest& request, HTTPServerResponse& response)
+bool WebSocket::deflateEnabled() const
+{
+	return static_cast<WebSocketImpl*>(impl())->deflate() != 0;
+}
+
+
+const WebSocketDeflate::Params& WebSocket::deflateParams() const
+{
+	const WebSocketDeflate* pDeflate = static_cast<WebSocketImpl*>(impl())->deflate();
+	if (!pDeflate) throw IllegalStateException("permessage-deflate extension not enabled");
+	return pDeflate->params();
+}
+
+
+WebSocketImpl* WebSocket::accept(HTTPServerRequest& request, HTTPServerResponse& response, const WebSocketDeflate::Params* pDeflateParams)
 {
 	if (request.hasToken("Connection", "upgrade") && icompare(request.get("Upgrade", ""), "websocket") == 0)
 	{
@@ -137,21 +184,31 @@ WebSocketImpl* WebSocket::accept(HTTPServerRequest& request, HTTPServerResponse&
 		Poco::trimInPlace(key);
 		if (key.empty()) throw WebSocketException("Missing Sec-WebSocket-Key in handshake request", WS_ERR_HANDSHAKE_NO_KEY);
 		
+		WebSocketDeflate::Params deflateParams;
+		std::string extension;
+		bool deflate = pDeflateParams && WebSocketDeflate::accept(extensions(request), *pDeflateParams, deflateParams, extension);
+
 		response.setStatusAndReason(HTTPResponse::HTTP_SWITCHING_PROTOCOLS);
 		response.set("Upgrade", "websocket");
 		response.set("Connection", "Upgrade");
 		response.set("Sec-WebSocket-Accept", computeAccept(key));
+		if (deflate) response.set("Sec-WebSocket-Extensions", extension);
 		response.setContentLength(0);
 		response.send().flush();
 		
 		HTTPServerRequestImpl& requestImpl = static_cast<HTTPServerRequestImpl&>(request);
-		return new WebSocketImpl(static_cast<StreamSocketImpl*>(requestImpl.detachSocket().impl()), requestImpl.session(), false);
+		StreamSocket socket = requestImpl.detachSocket();
+		StreamSocketImpl* pSocketImpl = static_cast<StreamSocketImpl*>(socket.impl());
+		if (deflate)
+			return new WebSocketImpl(pSocketImpl, requestImpl.session(), false, deflateParams);
+		else
+			return new WebSocketImpl(pSocketImpl, requestImpl.session(), false);
 	}
 	else throw WebSocketException("No WebSocket handshake", WS_ERR_NO_HANDSHAKE);
 }
 
 
-WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials)
+WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials, const WebSocketDeflate::Params* pDeflateParams)
 {
 	if (!cs.getProxyHost().empty() && !cs.secure())
 	{
@@ -162,13 +219,20 @@ WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, H
 	request.set("Upgrade", "websocket");
 	request.set("Sec-WebSocket-Version", WEBSOCKET_VERSION);
 	request.set("Sec-WebSocket-Key", key);
+	if (pDeflateParams)
+	{
+		std::string offers = request.get("Sec-WebSocket-Extensions", "");
+		if (!offers.empty()) offers += ", ";
+		offers += WebSocketDeflate::offer(*pDeflateParams);
+		request.set("Sec-WebSocket-Extensions", offers);
+	}
 	request.setChunkedTransferEncoding(false);
 	cs.setKeepAlive(true);
 	cs.sendRequest(request);
 	std::istream& istr = cs.receiveResponse(response);
 	if (response.getStatus() == HTTPResponse::HTTP_SWITCHING_PROTOCOLS)
 	{
-		return completeHandshake(cs, response, key);
+		return completeHandshake(cs, response, key, pDeflateParams);
 	}
 	else if (response.getStatus() == HTTPResponse::HTTP_UNAUTHORIZED)
 	{
@@ -184,7 +248,7 @@ WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, H
 		cs.receiveResponse(response);
 		if (response.getStatus() == HTTPResponse::HTTP_SWITCHING_PROTOCOLS)
 		{
-			return completeHandshake(cs, response, key);
+			return completeHandshake(cs, response, key, pDeflateParams);
 		}
 		else if (response.getStatus() == HTTPResponse::HTTP_UNAUTHORIZED)
 		{
@@ -202,7 +266,7 @@ WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, H
 }
 
 
-WebSocketImpl* WebSocket::completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key)
+WebSocketImpl* WebSocket::completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key, const WebSocketDeflate::Params* pDeflateParams)
 {
 	std::string connection = response.get("Connection", "");
 	if (Poco::icompare(connection, "Upgrade") != 0)
@@ -213,7 +277,28 @@ WebSocketImpl* WebSocket::completeHandshake(HTTPClientSession& cs, HTTPResponse&
 	std::string accept = response.get("Sec-WebSocket-Accept", "");
 	if (accept != computeAccept(key))
 		throw WebSocketException("Invalid or missing Sec-WebSocket-Accept header in handshake response", WS_ERR_HANDSHAKE_ACCEPT);
-	return new WebSocketImpl(static_cast<StreamSocketImpl*>(cs.detachSocket().impl()), cs, true);
+	WebSocketDeflate::Params deflateParams;
+	bool deflate = pDeflateParams && WebSocketDeflate::confirm(extensions(response), *pDeflateParams, deflateParams);
+	StreamSocket socket = cs.detachSocket();
+	StreamSocketImpl* pSocketImpl = static_cast<StreamSocketImpl*>(socket.impl());
+	if (deflate)
+		return new WebSocketImpl(pSocketImpl, cs, true, deflateParams);
+	else
+		return new WebSocketImpl(pSocketImpl, cs, true);
+}
+
+
+std::string WebSocket::extensions(const MessageHeader& header)
+{
+	std::string result;
+	NameValueCollection::ConstIterator it = header.find("Sec-WebSocket-Extensions");
+	while (it != header.end() && icompare(it->first, "Sec-WebSocket-Extensions") == 0)
+	{
+		if (!result.empty()) result += ", ";
+		result += it->second;
+		++it;
+	}
+	return result;
 }
 
 
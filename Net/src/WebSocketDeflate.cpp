@@ -0,0 +1,485 @@
+//
+// WebSocketDeflate.cpp
+//
+// Library: Net
+// Package: WebSocket
+// Module:  WebSocketDeflate
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/WebSocketDeflate.h"
+#include "Poco/Net/WebSocket.h"
+#include "Poco/Net/Socket.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/DeflatingStream.h"
+#include "Poco/InflatingStream.h"
+#include "Poco/StringTokenizer.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/String.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	enum
+	{
+		MIN_WINDOW_BITS = 9, // zlib does not support 8 for raw deflate streams
+		MAX_WINDOW_BITS = 15
+	};
+
+	bool splitParam(const std::string& param, std::string& name, std::string& value)
+	{
+		std::string::size_type pos = param.find('=');
+		name = Poco::toLower(Poco::trim(param.substr(0, pos)));
+		if (pos == std::string::npos)
+		{
+			value.clear();
+			return false;
+		}
+		value = Poco::trim(param.substr(pos + 1));
+		if (value.size() >= 2 && value[0] == '"' && value[value.size() - 1] == '"')
+			value = value.substr(1, value.size() - 2);
+		return true;
+	}
+
+	int windowBits(const std::string& value)
+		/// Returns the window bits given in value,
+		/// or 0 if value is not valid.
+	{
+		int bits;
+		if (Poco::NumberParser::tryParse(value, bits) && bits >= 8 && bits <= MAX_WINDOW_BITS)
+			return bits;
+		else
+			return 0;
+	}
+}
+
+
+//
+// WebSocketDeflate::Params
+//
+
+
+WebSocketDeflate::Params::Params():
+	serverNoContextTakeover(false),
+	clientNoContextTakeover(false),
+	serverMaxWindowBits(MAX_WINDOW_BITS),
+	clientMaxWindowBits(MAX_WINDOW_BITS),
+	compressionLevel(-1),
+	minimumSize(64),
+	maxPayloadSize(DEFAULT_MAX_PAYLOAD_SIZE)
+{
+}
+
+
+//
+// WebSocketDeflate::SinkBuf
+//
+
+
+WebSocketDeflate::SinkBuf::SinkBuf():
+	_pBuffer(0),
+	_pBuffers(0),
+	_count(0),
+	_index(0),
+	_offset(0),
+	_limit(0),
+	_written(0),
+	_overflowed(false)
+{
+}
+
+
+void WebSocketDeflate::SinkBuf::setTarget(Poco::Buffer<char>& buffer, std::size_t limit)
+{
+	_pBuffer = &buffer;
+	_pBuffers = 0;
+	_count = _index = _offset = _written = 0;
+	_limit = limit;
+	_overflowed = false;
+}
+
+
+void WebSocketDeflate::SinkBuf::setTarget(const SocketBuf* pBuffers, std::size_t count)
+{
+	_pBuffer = 0;
+	_pBuffers = pBuffers;
+	_count = count;
+	_index = _offset = _written = 0;
+	_overflowed = false;
+}
+
+
+std::size_t WebSocketDeflate::SinkBuf::written() const
+{
+	return _written;
+}
+
+
+bool WebSocketDeflate::SinkBuf::overflowed() const
+{
+	return _overflowed;
+}
+
+
+WebSocketDeflate::SinkBuf::int_type WebSocketDeflate::SinkBuf::overflow(int_type c)
+{
+	if (c != traits_type::eof())
+	{
+		char ch = traits_type::to_char_type(c);
+		xsputn(&ch, 1);
+	}
+	return traits_type::not_eof(c);
+}
+
+
+std::streamsize WebSocketDeflate::SinkBuf::xsputn(const char* s, std::streamsize n)
+{
+	std::size_t length = static_cast<std::size_t>(n);
+	if (_pBuffer)
+	{
+		if (length > _limit - _written)
+		{
+			length = _limit - _written;
+			_overflowed = true;
+		}
+		std::size_t size = _pBuffer->size();
+		if (size + length > _pBuffer->capacity())
+		{
+			_pBuffer->setCapacity(std::max(2*_pBuffer->capacity(), size + length));
+		}
+		_pBuffer->resize(size + length);
+		std::memcpy(_pBuffer->begin() + size, s, length);
+		_written += length;
+		length = static_cast<std::size_t>(n) - length;
+	}
+	else
+	{
+		while (length > 0 && _index < _count)
+		{
+			std::size_t k = std::min(Socket::bufferSize(_pBuffers[_index]) - _offset, length);
+			std::memcpy(Socket::bufferData(_pBuffers[_index]) + _offset, s, k);
+			s += k;
+			length -= k;
+			_written += k;
+			_offset += k;
+			if (_offset == Socket::bufferSize(_pBuffers[_index]))
+			{
+				++_index;
+				_offset = 0;
+			}
+		}
+		if (length > 0) _overflowed = true;
+	}
+	// returning less than n makes the stream fail, which
+	// stops the inflater
+	return n - static_cast<std::streamsize>(length);
+}
+
+
+//
+// WebSocketDeflate
+//
+
+
+const std::string WebSocketDeflate::EXTENSION_NAME("permessage-deflate");
+
+
+WebSocketDeflate::WebSocketDeflate(const Params& params, bool server):
+	_params(params),
+	_deflateWindowBits(server ? params.serverMaxWindowBits : params.clientMaxWindowBits),
+	_deflateNoContextTakeover(server ? params.serverNoContextTakeover : params.clientNoContextTakeover),
+	_deflateSink(&_deflateBuf),
+	_pDeflater(0),
+	_inflateSink(&_inflateBuf),
+	_pInflater(0)
+{
+	poco_assert (_deflateWindowBits >= MIN_WINDOW_BITS && _deflateWindowBits <= MAX_WINDOW_BITS);
+}
+
+
+WebSocketDeflate::~WebSocketDeflate()
+{
+	// the deflater writes the end of the stream when destroyed,
+	// which must not end up in a caller's buffer
+	_deflateBuf.setTarget(0, 0);
+	_inflateBuf.setTarget(0, 0);
+	delete _pDeflater;
+	delete _pInflater;
+}
+
+
+void WebSocketDeflate::compress(const SocketBuf* pBuffers, std::size_t count, bool fin, Poco::Buffer<char>& compressed)
+{
+	compressed.resize(0);
+	_deflateBuf.setTarget(compressed, ~std::size_t(0));
+	if (!_pDeflater)
+	{
+		_pDeflater = new Poco::DeflatingOutputStream(_deflateSink, -_deflateWindowBits, _params.compressionLevel);
+	}
+	for (std::size_t i = 0; i < count; i++)
+	{
+		_pDeflater->write(Socket::bufferData(pBuffers[i]), Socket::bufferSize(pBuffers[i]));
+	}
+	// flushing the stream performs a Z_SYNC_FLUSH, so the
+	// compressed data ends with an empty stored block
+	_pDeflater->flush();
+	if (!_pDeflater->good()) throw IOException("Failed to compress WebSocket message");
+
+	if (fin)
+	{
+		static const char TRAILER[] = {'\x00', '\x00', '\xff', '\xff'};
+		std::size_t size = compressed.size();
+		if (size >= 4 && std::memcmp(compressed.begin() + size - 4, TRAILER, 4) == 0)
+		{
+			compressed.resize(size - 4);
+		}
+		if (_deflateNoContextTakeover)
+		{
+			_deflateBuf.setTarget(0, 0);
+			delete _pDeflater;
+			_pDeflater = 0;
+			_deflateSink.clear();
+		}
+	}
+}
+
+
+void WebSocketDeflate::decompress(const char* data, std::size_t length, bool fin, Poco::Buffer<char>& buffer)
+{
+	_inflateBuf.setTarget(buffer, _params.maxPayloadSize);
+	inflate(data, length, fin);
+}
+
+
+std::size_t WebSocketDeflate::decompress(const char* data, std::size_t length, bool fin, char* buffer, std::size_t size)
+{
+	SocketBuf target = Socket::makeBuffer(buffer, size);
+	return decompress(data, length, fin, &target, 1);
+}
+
+
+std::size_t WebSocketDeflate::decompress(const char* data, std::size_t length, bool fin, const SocketBuf* pBuffers, std::size_t count)
+{
+	_inflateBuf.setTarget(pBuffers, count);
+	inflate(data, length, fin);
+	return _inflateBuf.written();
+}
+
+
+void WebSocketDeflate::inflate(const char* data, std::size_t length, bool fin)
+{
+	static const char TRAILER[] = {'\x00', '\x00', '\xff', '\xff'};
+
+	// The peer may use any window size up to 15 bits, so there
+	// is no need to know the agreed size. Keeping the context
+	// is also fine if the peer does not use context takeover.
+	if (!_pInflater)
+	{
+		_pInflater = new Poco::InflatingOutputStream(_inflateSink, -MAX_WINDOW_BITS);
+	}
+	_pInflater->write(data, length);
+	if (fin) _pInflater->write(TRAILER, sizeof(TRAILER));
+	_pInflater->flush();
+	if (!_pInflater->good())
+	{
+		bool overflowed = _inflateBuf.overflowed();
+		_inflateBuf.setTarget(0, 0);
+		delete _pInflater;
+		_pInflater = 0;
+		_inflateSink.clear();
+		if (overflowed)
+			throw WebSocketException("Decompressed payload too big", WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+		else
+			throw WebSocketException("Invalid compressed payload received", WebSocket::WS_ERR_COMPRESSION);
+	}
+}
+
+
+std::string WebSocketDeflate::offer(const Params& params)
+{
+	validate(params);
+
+	std::string result(EXTENSION_NAME);
+	if (params.serverNoContextTakeover)
+	{
+		result += "; server_no_context_takeover";
+	}
+	if (params.clientNoContextTakeover)
+	{
+		result += "; client_no_context_takeover";
+	}
+	if (params.serverMaxWindowBits < MAX_WINDOW_BITS)
+	{
+		result += "; server_max_window_bits=";
+		NumberFormatter::append(result, params.serverMaxWindowBits);
+	}
+	result += "; client_max_window_bits";
+	if (params.clientMaxWindowBits < MAX_WINDOW_BITS)
+	{
+		result += '=';
+		NumberFormatter::append(result, params.clientMaxWindowBits);
+	}
+	return result;
+}
+
+
+bool WebSocketDeflate::accept(const std::string& extensions, const Params& params, Params& agreed, std::string& response)
+{
+	validate(params);
+
+	std::string name;
+	std::string value;
+	StringTokenizer offers(extensions, ",", StringTokenizer::TOK_TRIM | StringTokenizer::TOK_IGNORE_EMPTY);
+	for (StringTokenizer::Iterator it = offers.begin(); it != offers.end(); ++it)
+	{
+		StringTokenizer tokens(*it, ";", StringTokenizer::TOK_TRIM | StringTokenizer::TOK_IGNORE_EMPTY);
+		if (tokens.count() == 0 || icompare(tokens[0], EXTENSION_NAME) != 0) continue;
+
+		Params p(params);
+		bool serverWindowOffered = false;
+		bool clientWindowOffered = false;
+		bool valid = true;
+		for (std::size_t i = 1; valid && i < tokens.count(); i++)
+		{
+			bool hasValue = splitParam(tokens[i], name, value);
+			if (name == "server_no_context_takeover" && !hasValue)
+			{
+				p.serverNoContextTakeover = true;
+			}
+			else if (name == "client_no_context_takeover" && !hasValue)
+			{
+				p.clientNoContextTakeover = true;
+			}
+			else if (name == "server_max_window_bits" && hasValue)
+			{
+				int bits = windowBits(value);
+				if (bits >= MIN_WINDOW_BITS)
+				{
+					serverWindowOffered = true;
+					if (bits < p.serverMaxWindowBits) p.serverMaxWindowBits = bits;
+				}
+				else valid = false;
+			}
+			else if (name == "client_max_window_bits")
+			{
+				clientWindowOffered = true;
+				if (hasValue)
+				{
+					int bits = windowBits(value);
+					if (bits == 0)
+						valid = false;
+					else if (bits < p.clientMaxWindowBits)
+						p.clientMaxWindowBits = bits;
+				}
+			}
+			else valid = false;
+		}
+		if (!valid) continue;
+
+		// The client's window size can only be limited if the client allows it.
+		if (!clientWindowOffered) p.clientMaxWindowBits = MAX_WINDOW_BITS;
+
+		response = EXTENSION_NAME;
+		if (p.serverNoContextTakeover)
+		{
+			response += "; server_no_context_takeover";
+		}
+		if (p.clientNoContextTakeover)
+		{
+			response += "; client_no_context_takeover";
+		}
+		if (serverWindowOffered || p.serverMaxWindowBits < MAX_WINDOW_BITS)
+		{
+			response += "; server_max_window_bits=";
+			NumberFormatter::append(response, p.serverMaxWindowBits);
+		}
+		if (p.clientMaxWindowBits < MAX_WINDOW_BITS)
+		{
+			response += "; client_max_window_bits=";
+			NumberFormatter::append(response, p.clientMaxWindowBits);
+		}
+		agreed = p;
+		return true;
+	}
+	return false;
+}
+
+
+bool WebSocketDeflate::confirm(const std::string& extensions, const Params& params, Params& agreed)
+{
+	std::string name;
+	std::string value;
+	StringTokenizer responses(extensions, ",", StringTokenizer::TOK_TRIM | StringTokenizer::TOK_IGNORE_EMPTY);
+	for (StringTokenizer::Iterator it = responses.begin(); it != responses.end(); ++it)
+	{
+		StringTokenizer tokens(*it, ";", StringTokenizer::TOK_TRIM | StringTokenizer::TOK_IGNORE_EMPTY);
+		if (tokens.count() == 0 || icompare(tokens[0], EXTENSION_NAME) != 0) continue;
+
+		Params p(params);
+		p.serverNoContextTakeover = false;
+		p.serverMaxWindowBits = MAX_WINDOW_BITS;
+		bool serverWindowConfirmed = false;
+		for (std::size_t i = 1; i < tokens.count(); i++)
+		{
+			bool hasValue = splitParam(tokens[i], name, value);
+			if (name == "server_no_context_takeover" && !hasValue)
+			{
+				p.serverNoContextTakeover = true;
+			}
+			else if (name == "client_no_context_takeover" && !hasValue)
+			{
+				p.clientNoContextTakeover = true;
+			}
+			else if (name == "server_max_window_bits" && hasValue)
+			{
+				int bits = windowBits(value);
+				if (bits == 0 || bits > params.serverMaxWindowBits)
+					throw WebSocketException("Invalid server_max_window_bits in handshake response", WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+				p.serverMaxWindowBits = bits;
+				serverWindowConfirmed = true;
+			}
+			else if (name == "client_max_window_bits" && hasValue)
+			{
+				int bits = windowBits(value);
+				if (bits < MIN_WINDOW_BITS || bits > params.clientMaxWindowBits)
+					throw WebSocketException("Unsupported client_max_window_bits in handshake response", WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+				p.clientMaxWindowBits = bits;
+			}
+			else throw WebSocketException("Invalid permessage-deflate parameter in handshake response", tokens[i], WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+		}
+		if (params.serverNoContextTakeover && !p.serverNoContextTakeover)
+			throw WebSocketException("Missing server_no_context_takeover in handshake response", WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+		if (params.serverMaxWindowBits < MAX_WINDOW_BITS && !serverWindowConfirmed)
+			throw WebSocketException("Missing server_max_window_bits in handshake response", WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+
+		agreed = p;
+		return true;
+	}
+	return false;
+}
+
+
+void WebSocketDeflate::validate(const Params& params)
+{
+	if (params.serverMaxWindowBits < MIN_WINDOW_BITS || params.serverMaxWindowBits > MAX_WINDOW_BITS)
+		throw InvalidArgumentException("serverMaxWindowBits must be between 9 and 15");
+	if (params.clientMaxWindowBits < MIN_WINDOW_BITS || params.clientMaxWindowBits > MAX_WINDOW_BITS)
+		throw InvalidArgumentException("clientMaxWindowBits must be between 9 and 15");
+	if (params.compressionLevel < -1 || params.compressionLevel > 9)
+		throw InvalidArgumentException("compressionLevel must be between -1 and 9");
+}
+
+
+} } // namespace Poco::Net
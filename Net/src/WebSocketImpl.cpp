@@ -15,12 +15,14 @@
 #include "Poco/Net/WebSocketImpl.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/Net/WebSocket.h"
+#include "Poco/Net/Socket.h"
 #include "Poco/Net/HTTPSession.h"
 #include "Poco/Buffer.h"
 #include "Poco/BinaryWriter.h"
 #include "Poco/BinaryReader.h"
 #include "Poco/MemoryStream.h"
 #include "Poco/Format.h"
+#include <algorithm>
 #include <cstring>
 
 
@@ -34,7 +36,31 @@ WebSocketImpl::WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, HTTPSession& s
 	_buffer(0),
 	_bufferOffset(0),
 	_frameFlags(0),
-	_mustMaskPayload(mustMaskPayload)
+	_mustMaskPayload(mustMaskPayload),
+	_pDeflate(0),
+	_deflateBuffer(0),
+	_inflateBuffer(0),
+	_deflateMessage(false),
+	_inflateMessage(false)
+{
+	poco_check_ptr(pStreamSocketImpl);
+	_pStreamSocketImpl->duplicate();
+	session.drainBuffer(_buffer);
+}
+
+
+WebSocketImpl::WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, HTTPSession& session, bool mustMaskPayload, const WebSocketDeflate::Params& deflateParams):
+	StreamSocketImpl(pStreamSocketImpl->sockfd()),
+	_pStreamSocketImpl(pStreamSocketImpl),
+	_buffer(0),
+	_bufferOffset(0),
+	_frameFlags(0),
+	_mustMaskPayload(mustMaskPayload),
+	_pDeflate(new WebSocketDeflate(deflateParams, !mustMaskPayload)),
+	_deflateBuffer(0),
+	_inflateBuffer(0),
+	_deflateMessage(false),
+	_inflateMessage(false)
 {
 	poco_check_ptr(pStreamSocketImpl);
 	_pStreamSocketImpl->duplicate();
@@ -46,6 +72,7 @@ WebSocketImpl::~WebSocketImpl()
 {
 	try
 	{
+		delete _pDeflate;
 		_pStreamSocketImpl->release();
 		reset();
 	}
@@ -58,12 +85,71 @@ WebSocketImpl::~WebSocketImpl()
 
 int WebSocketImpl::sendBytes(const void* buffer, int length, int flags)
 {
-	Poco::Buffer<char> frame(length + MAX_HEADER_LENGTH);
-	Poco::MemoryOutputStream ostr(frame.begin(), frame.size());
-	Poco::BinaryWriter writer(ostr, Poco::BinaryWriter::NETWORK_BYTE_ORDER);
+	SocketBuf payload = Socket::makeBuffer(buffer, length);
+	return sendFrame(&payload, 1, flags);
+}
+
+
+int WebSocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	return sendFrame(buffers.empty() ? 0 : &buffers[0], buffers.size(), flags);
+}
+
+
+int WebSocketImpl::sendFrame(const SocketBuf* pPayload, std::size_t count, int flags)
+{
+	std::size_t length = 0;
+	for (std::size_t i = 0; i < count; i++)
+	{
+		length += Socket::bufferSize(pPayload[i]);
+	}
 
 	if (flags == 0) flags = WebSocket::FRAME_BINARY;
 	flags &= 0xff;
+
+	if (_pDeflate)
+	{
+		// Whether a message is compressed is decided by its first frame.
+		// Control frames can be sent between the fragments of a message,
+		// and are never compressed.
+		int opcode = flags & WebSocket::FRAME_OP_BITMASK;
+		if (opcode == WebSocket::FRAME_OP_TEXT || opcode == WebSocket::FRAME_OP_BINARY)
+		{
+			_deflateMessage = length >= _pDeflate->params().minimumSize && (flags & WebSocket::FRAME_FLAG_RSV1) == 0;
+			if (_deflateMessage) flags |= WebSocket::FRAME_FLAG_RSV1;
+		}
+		else if (opcode != WebSocket::FRAME_OP_CONT)
+		{
+			writeFrame(pPayload, count, flags);
+			return static_cast<int>(length);
+		}
+		if (_deflateMessage)
+		{
+			bool fin = (flags & WebSocket::FRAME_FLAG_FIN) != 0;
+			_pDeflate->compress(pPayload, count, fin, _deflateBuffer);
+			if (fin) _deflateMessage = false;
+			SocketBuf compressed = Socket::makeBuffer(_deflateBuffer.begin(), _deflateBuffer.size());
+			writeFrame(&compressed, 1, flags);
+			return static_cast<int>(length);
+		}
+	}
+	writeFrame(pPayload, count, flags);
+	return static_cast<int>(length);
+}
+
+
+void WebSocketImpl::writeFrame(const SocketBuf* pPayload, std::size_t count, int flags)
+{
+	std::size_t length = 0;
+	for (std::size_t i = 0; i < count; i++)
+	{
+		length += Socket::bufferSize(pPayload[i]);
+	}
+
+	char header[MAX_HEADER_LENGTH];
+	Poco::MemoryOutputStream ostr(header, sizeof(header));
+	Poco::BinaryWriter writer(ostr, Poco::BinaryWriter::NETWORK_BYTE_ORDER);
+
 	writer << static_cast<Poco::UInt8>(flags);
 	Poco::UInt8 lengthByte(0);
 	if (_mustMaskPayload)
@@ -87,22 +173,35 @@ int WebSocketImpl::sendBytes(const void* buffer, int length, int flags)
 	}
 	if (_mustMaskPayload)
 	{
+		// The masked payload must be copied anyway,
+		// so the frame is sent from a single buffer.
 		const Poco::UInt32 mask = _rnd.next();
 		const char* m = reinterpret_cast<const char*>(&mask);
-		const char* b = reinterpret_cast<const char*>(buffer);
 		writer.writeRaw(m, 4);
-		char* p = frame.begin() + ostr.charsWritten();
-		for (int i = 0; i < length; i++)
+		std::size_t headerLength = static_cast<std::size_t>(ostr.charsWritten());
+		Poco::Buffer<char> frame(headerLength + length);
+		std::memcpy(frame.begin(), header, headerLength);
+		char* p = frame.begin() + headerLength;
+		std::size_t k = 0;
+		for (std::size_t i = 0; i < count; i++)
 		{
-			p[i] = b[i] ^ m[i % 4];
+			const char* b = Socket::bufferData(pPayload[i]);
+			std::size_t n = Socket::bufferSize(pPayload[i]);
+			for (std::size_t j = 0; j < n; j++, k++)
+			{
+				p[k] = b[j] ^ m[k % 4];
+			}
 		}
+		_pStreamSocketImpl->sendBytes(frame.begin(), static_cast<int>(frame.size()));
 	}
 	else
 	{
-		std::memcpy(frame.begin() + ostr.charsWritten(), buffer, length);
+		SocketBufVec frame;
+		frame.reserve(count + 1);
+		frame.push_back(Socket::makeBuffer(header, static_cast<std::size_t>(ostr.charsWritten())));
+		frame.insert(frame.end(), pPayload, pPayload + count);
+		_pStreamSocketImpl->sendBytes(frame);
 	}
-	_pStreamSocketImpl->sendBytes(frame.begin(), length + static_cast<int>(ostr.charsWritten()));
-	return length;
 }
 
 
@@ -185,13 +284,101 @@ int WebSocketImpl::receivePayload(char *buffer, int payloadLength, char mask[4],
 }
 
 
+int WebSocketImpl::receivePayload(const SocketBufVec& buffers, int payloadLength, char mask[4], bool useMask)
+{
+	SocketBufVec remaining;
+	remaining.reserve(buffers.size());
+	int received = 0;
+	while (received < payloadLength)
+	{
+		// the part of the buffers not filled yet, limited to the payload length
+		remaining.clear();
+		std::size_t offset = received;
+		std::size_t rest = payloadLength - received;
+		for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end() && rest > 0; ++it)
+		{
+			std::size_t size = Socket::bufferSize(*it);
+			if (offset >= size)
+			{
+				offset -= size;
+				continue;
+			}
+			std::size_t n = std::min(size - offset, rest);
+			remaining.push_back(Socket::makeBuffer(Socket::bufferData(*it) + offset, n));
+			offset = 0;
+			rest -= n;
+		}
+		int n;
+		if (_bufferOffset < static_cast<int>(_buffer.size()))
+			n = receiveSomeBytes(Socket::bufferData(remaining[0]), static_cast<int>(Socket::bufferSize(remaining[0])));
+		else
+			n = _pStreamSocketImpl->receiveBytes(remaining);
+		if (n <= 0) throw WebSocketException("Incomplete frame received", WebSocket::WS_ERR_INCOMPLETE_FRAME);
+		received += n;
+	}
+
+	if (useMask)
+	{
+		int k = 0;
+		for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end() && k < payloadLength; ++it)
+		{
+			char* p = Socket::bufferData(*it);
+			std::size_t n = std::min(Socket::bufferSize(*it), static_cast<std::size_t>(payloadLength - k));
+			for (std::size_t i = 0; i < n; i++, k++)
+			{
+				p[i] ^= mask[k % 4];
+			}
+		}
+	}
+	return received;
+}
+
+
+bool WebSocketImpl::receiveCompressed()
+{
+	if (!_pDeflate) return false;
+
+	int opcode = _frameFlags & WebSocket::FRAME_OP_BITMASK;
+	if (opcode == WebSocket::FRAME_OP_TEXT || opcode == WebSocket::FRAME_OP_BINARY)
+	{
+		_inflateMessage = (_frameFlags & WebSocket::FRAME_FLAG_RSV1) != 0;
+		_frameFlags &= ~WebSocket::FRAME_FLAG_RSV1;
+	}
+	else if (opcode != WebSocket::FRAME_OP_CONT)
+	{
+		return false;
+	}
+	bool compressed = _inflateMessage;
+	if (_frameFlags & WebSocket::FRAME_FLAG_FIN) _inflateMessage = false;
+	return compressed;
+}
+
+
+void WebSocketImpl::receiveCompressedPayload(int payloadLength, char mask[4], bool useMask)
+{
+	_inflateBuffer.resize(payloadLength, false);
+	if (payloadLength > 0)
+	{
+		receivePayload(_inflateBuffer.begin(), payloadLength, mask, useMask);
+	}
+}
+
+
 int WebSocketImpl::receiveBytes(void* buffer, int length, int)
 {
 	char mask[4];
 	bool useMask;
 	int payloadLength = receiveHeader(mask, useMask);
-	if (payloadLength <= 0)
+	if (payloadLength < 0 || (payloadLength == 0 && _frameFlags == 0))
 		return payloadLength;
+	if (receiveCompressed())
+	{
+		receiveCompressedPayload(payloadLength, mask, useMask);
+		bool fin = (_frameFlags & WebSocket::FRAME_FLAG_FIN) != 0;
+		return static_cast<int>(_pDeflate->decompress(_inflateBuffer.begin(), _inflateBuffer.size(), fin, reinterpret_cast<char*>(buffer), length));
+	}
+	if (payloadLength == 0)
+		return 0;
 	if (payloadLength > length)
 		throw WebSocketException(Poco::format("Insufficient buffer for payload size %hu", payloadLength), WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
 	return receivePayload(reinterpret_cast<char*>(buffer), payloadLength, mask, useMask);
@@ -203,14 +390,45 @@ int WebSocketImpl::receiveBytes(Poco::Buffer<char>& buffer, int)
 	char mask[4];
 	bool useMask;
 	int payloadLength = receiveHeader(mask, useMask);
-	if (payloadLength <= 0)
+	if (payloadLength < 0 || (payloadLength == 0 && _frameFlags == 0))
 		return payloadLength;
+	if (receiveCompressed())
+	{
+		receiveCompressedPayload(payloadLength, mask, useMask);
+		bool fin = (_frameFlags & WebSocket::FRAME_FLAG_FIN) != 0;
+		std::size_t oldSize = buffer.size();
+		_pDeflate->decompress(_inflateBuffer.begin(), _inflateBuffer.size(), fin, buffer);
+		return static_cast<int>(buffer.size() - oldSize);
+	}
+	if (payloadLength == 0)
+		return 0;
 	int oldSize = static_cast<int>(buffer.size());
 	buffer.resize(oldSize + payloadLength);
 	return receivePayload(buffer.begin() + oldSize, payloadLength, mask, useMask);
 }
 
 
+int WebSocketImpl::receiveBytes(SocketBufVec& buffers, int)
+{
+	char mask[4];
+	bool useMask;
+	int payloadLength = receiveHeader(mask, useMask);
+	if (payloadLength < 0 || (payloadLength == 0 && _frameFlags == 0))
+		return payloadLength;
+	if (receiveCompressed())
+	{
+		receiveCompressedPayload(payloadLength, mask, useMask);
+		bool fin = (_frameFlags & WebSocket::FRAME_FLAG_FIN) != 0;
+		return static_cast<int>(_pDeflate->decompress(_inflateBuffer.begin(), _inflateBuffer.size(), fin, buffers.empty() ? 0 : &buffers[0], buffers.size()));
+	}
+	if (payloadLength == 0)
+		return 0;
+	if (static_cast<std::size_t>(payloadLength) > Socket::bufferSize(buffers))
+		throw WebSocketException(Poco::format("Insufficient buffer for payload size %d", payloadLength), WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+	return receivePayload(buffers, payloadLength, mask, useMask);
+}
+
+
 int WebSocketImpl::receiveNBytes(void* buffer, int bytes)
 {
 	int received = receiveSomeBytes(reinterpret_cast<char*>(buffer), bytes);
@@ -246,6 +464,12 @@ int WebSocketImpl::receiveSomeBytes(char* buffer, int bytes)
 }
 
 
+std::streamsize WebSocketImpl::sendFile(FileInputStream& /*fileInputStream*/, std::streamoff /*offset*/, std::streamsize /*count*/)
+{
+	throw Poco::InvalidAccessException("Cannot sendFile() on a WebSocketImpl");
+}
+
+
 SocketImpl* WebSocketImpl::acceptConnection(SocketAddress& /*clientAddr*/)
 {
 	throw Poco::InvalidAccessException("Cannot acceptConnection() on a WebSocketImpl");
@@ -0,0 +1,338 @@
+//
+// DNSCacheTest.cpp
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "DNSCacheTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/DNSCache.h"
+#include "Poco/Net/StubResolver.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Event.h"
+#include "Poco/Thread.h"
+#include <sstream>
+
+
+using Poco::Net::DNSCache;
+using Poco::Net::HostResolver;
+using Poco::Net::StubResolver;
+using Poco::Net::HostEntry;
+using Poco::Net::IPAddress;
+using Poco::Net::SocketAddress;
+using Poco::Net::HostNotFoundException;
+using Poco::AtomicCounter;
+using Poco::Event;
+using Poco::Thread;
+using Poco::Timespan;
+
+
+namespace
+{
+	class BlockingResolver: public HostResolver
+	{
+	public:
+		HostEntry resolve(const std::string& hostname)
+		{
+			++_lookups;
+			_started.set();
+			_release.wait();
+			return HostEntry(hostname, HostEntry::AddressList(1, IPAddress("10.0.0.1")));
+		}
+
+		void waitStarted()
+		{
+			_started.wait();
+		}
+
+		void unblock()
+		{
+			_release.set();
+		}
+
+		int lookups() const
+		{
+			return _lookups.value();
+		}
+
+	private:
+		Event _started;
+		Event _release;
+		AtomicCounter _lookups;
+	};
+}
+
+
+DNSCacheTest::DNSCacheTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+DNSCacheTest::~DNSCacheTest()
+{
+}
+
+
+void DNSCacheTest::testStubResolver()
+{
+	StubResolver::Ptr pStub = new StubResolver;
+	pStub->addHost("alpha.test", IPAddress("10.0.0.1"));
+	pStub->addHost("alpha.test", IPAddress("10.0.0.2"));
+
+	std::istringstream hosts(
+		"# test hosts\n"
+		"10.1.0.1\tbeta.test beta   # comment\n"
+		"::1 gamma.test\n"
+		"\n"
+		"invalid delta.test\n");
+	pStub->load(hosts);
+
+	HostEntry he = pStub->resolve("ALPHA.test");
+	assertTrue (he.name() == "alpha.test");
+	assertTrue (he.addresses().size() == 2);
+	assertTrue (he.addresses()[0] == IPAddress("10.0.0.1"));
+	assertTrue (he.addresses()[1] == IPAddress("10.0.0.2"));
+
+	he = pStub->resolve("beta");
+	assertTrue (he.name() == "beta.test");
+	assertTrue (he.aliases().size() == 1);
+	assertTrue (he.aliases()[0] == "beta");
+	assertTrue (he.addresses().size() == 1);
+	assertTrue (he.addresses()[0] == IPAddress("10.1.0.1"));
+
+	he = pStub->resolve("gamma.test");
+	assertTrue (he.addresses()[0] == IPAddress("::1"));
+
+	he = pStub->resolve("192.168.1.1");
+	assertTrue (he.addresses()[0] == IPAddress("192.168.1.1"));
+
+	try
+	{
+		pStub->resolve("delta.test");
+		fail("unknown host - must throw");
+	}
+	catch (HostNotFoundException&)
+	{
+	}
+
+	pStub->removeHost("alpha.test");
+	try
+	{
+		pStub->resolve("alpha.test");
+		fail("removed host - must throw");
+	}
+	catch (HostNotFoundException&)
+	{
+	}
+	assertTrue (pStub->lookups() == 6);
+
+	StubResolver::Ptr pOuter = new StubResolver(pStub);
+	pOuter->addHost("epsilon.test", IPAddress("10.2.0.1"));
+	assertTrue (pOuter->resolve("epsilon.test").addresses()[0] == IPAddress("10.2.0.1"));
+	assertTrue (pOuter->resolve("beta.test").addresses()[0] == IPAddress("10.1.0.1"));
+}
+
+
+void DNSCacheTest::testCache()
+{
+	StubResolver::Ptr pStub = new StubResolver;
+	pStub->addHost("alpha.test", IPAddress("10.0.0.1"));
+	DNSCache cache(pStub);
+
+	HostEntry he = cache.resolve("alpha.test");
+	assertTrue (he.addresses()[0] == IPAddress("10.0.0.1"));
+	he = cache.resolve("Alpha.Test");
+	assertTrue (he.addresses()[0] == IPAddress("10.0.0.1"));
+	assertTrue (pStub->lookups() == 1);
+	assertTrue (cache.size() == 1);
+
+	cache.remove("alpha.test");
+	cache.resolve("alpha.test");
+	assertTrue (pStub->lookups() == 2);
+
+	cache.setPositiveTTL(Timespan(0));
+	cache.clear();
+	cache.resolve("alpha.test");
+	cache.resolve("alpha.test");
+	assertTrue (pStub->lookups() == 4);
+	assertTrue (cache.size() == 0);
+
+	cache.setPositiveTTL(Timespan(60, 0));
+	cache.setMaxEntries(2);
+	pStub->addHost("beta.test", IPAddress("10.0.0.2"));
+	pStub->addHost("gamma.test", IPAddress("10.0.0.3"));
+	cache.resolve("alpha.test");
+	cache.resolve("beta.test");
+	cache.resolve("gamma.test");
+	assertTrue (cache.size() == 2);
+}
+
+
+void DNSCacheTest::testNegativeCache()
+{
+	StubResolver::Ptr pStub = new StubResolver;
+	DNSCache cache(pStub);
+
+	for (int i = 0; i < 2; i++)
+	{
+		try
+		{
+			cache.resolve("unknown.test");
+			fail("unknown host - must throw");
+		}
+		catch (HostNotFoundException&)
+		{
+		}
+	}
+	assertTrue (pStub->lookups() == 1);
+
+	pStub->addHost("unknown.test", IPAddress("10.0.0.1"));
+	try
+	{
+		cache.resolve("unknown.test");
+		fail("negative result still cached - must throw");
+	}
+	catch (HostNotFoundException&)
+	{
+	}
+
+	cache.setNegativeTTL(Timespan(0));
+	cache.clear();
+	assertTrue (cache.resolve("unknown.test").addresses()[0] == IPAddress("10.0.0.1"));
+}
+
+
+void DNSCacheTest::testExpiry()
+{
+	StubResolver::Ptr pStub = new StubResolver;
+	pStub->addHost("alpha.test", IPAddress("10.0.0.1"));
+	DNSCache cache(pStub);
+	cache.setPositiveTTL(Timespan(0, 100000));
+
+	cache.resolve("alpha.test");
+	cache.resolve("alpha.test");
+	assertTrue (pStub->lookups() == 1);
+	Thread::sleep(200);
+	cache.resolve("alpha.test");
+	assertTrue (pStub->lookups() == 2);
+}
+
+
+void DNSCacheTest::testResolveAsync()
+{
+	Poco::AutoPtr<BlockingResolver> pResolver = new BlockingResolver;
+	DNSCache cache(pResolver);
+
+	DNSCache::Result result1 = cache.resolveAsync("alpha.test");
+	pResolver->waitStarted();
+	DNSCache::Result result2 = cache.resolveAsync("ALPHA.test");
+	assertTrue (!result1.available());
+	assertTrue (!result2.available());
+
+	pResolver->unblock();
+	result1.wait();
+	result2.wait();
+	assertTrue (!result1.failed());
+	assertTrue (result1.data().addresses()[0] == IPAddress("10.0.0.1"));
+	assertTrue (result2.data().addresses()[0] == IPAddress("10.0.0.1"));
+	assertTrue (pResolver->lookups() == 1);
+
+	DNSCache::Result result3 = cache.resolveAsync("alpha.test");
+	assertTrue (result3.available());
+	assertTrue (result3.data().addresses()[0] == IPAddress("10.0.0.1"));
+	assertTrue (pResolver->lookups() == 1);
+
+	StubResolver::Ptr pStub = new StubResolver;
+	cache.setResolver(pStub);
+	DNSCache::Result result4 = cache.resolveAsync("unknown.test");
+	result4.wait();
+	assertTrue (result4.failed());
+	assertTrue (dynamic_cast<HostNotFoundException*>(result4.exception()) != 0);
+}
+
+
+void DNSCacheTest::testResolveAsyncCallback()
+{
+	StubResolver::Ptr pStub = new StubResolver;
+	pStub->addHost("alpha.test", IPAddress("10.0.0.1"));
+	DNSCache cache(pStub);
+
+	Event done;
+	IPAddress address;
+	Thread::TID tid = 0;
+	cache.resolveAsync("alpha.test", [&](const DNSCache::Result& result)
+	{
+		address = result.data().addresses()[0];
+		tid = Thread::currentTid();
+		done.set();
+	});
+	done.wait();
+	assertTrue (address == IPAddress("10.0.0.1"));
+	assertTrue (tid != Thread::currentTid());
+
+	// cached results are delivered immediately
+	bool called = false;
+	cache.resolveAsync("alpha.test", [&](const DNSCache::Result& result)
+	{
+		called = !result.failed();
+	});
+	assertTrue (called);
+
+	cache.resolveAsync("unknown.test", [&](const DNSCache::Result& result)
+	{
+		called = result.failed();
+		done.set();
+	});
+	done.wait();
+	assertTrue (called);
+}
+
+
+void DNSCacheTest::testSocketAddress()
+{
+	StubResolver::Ptr pStub = new StubResolver;
+	pStub->addHost("server.test", IPAddress("127.0.0.1"));
+	DNSCache::defaultCache().setResolver(pStub);
+	try
+	{
+		SocketAddress sa("server.test", 8080);
+	}
+	catch (Poco::Exception&)
+	{
+	}
+	DNSCache::defaultCache().setResolver(new HostResolver);
+	assertTrue (pStub->lookups() == 0);
+}
+
+
+void DNSCacheTest::setUp()
+{
+}
+
+
+void DNSCacheTest::tearDown()
+{
+}
+
+
+CppUnit::Test* DNSCacheTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("DNSCacheTest");
+
+	CppUnit_addTest(pSuite, DNSCacheTest, testStubResolver);
+	CppUnit_addTest(pSuite, DNSCacheTest, testCache);
+	CppUnit_addTest(pSuite, DNSCacheTest, testNegativeCache);
+	CppUnit_addTest(pSuite, DNSCacheTest, testExpiry);
+	CppUnit_addTest(pSuite, DNSCacheTest, testResolveAsync);
+	CppUnit_addTest(pSuite, DNSCacheTest, testResolveAsyncCallback);
+	CppUnit_addTest(pSuite, DNSCacheTest, testSocketAddress);
+
+	return pSuite;
+}
@@ -0,0 +1,44 @@
+//
+// DNSCacheTest.h
+//
+// Definition of the DNSCacheTest class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef DNSCacheTest_INCLUDED
+#define DNSCacheTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class DNSCacheTest: public CppUnit::TestCase
+{
+public:
+	DNSCacheTest(const std::string& name);
+	~DNSCacheTest();
+
+	void testStubResolver();
+	void testCache();
+	void testNegativeCache();
+	void testExpiry();
+	void testResolveAsync();
+	void testResolveAsyncCallback();
+	void testSocketAddress();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // DNSCacheTest_INCLUDED
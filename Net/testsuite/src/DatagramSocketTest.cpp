@@ -13,6 +13,7 @@
 #include "Poco/CppUnit/TestSuite.h"
 #include "UDPEchoServer.h"
 #include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/DatagramBatch.h"
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/Net/NetworkInterface.h"
 #include "Poco/Net/NetException.h"
@@ -21,7 +22,9 @@
 
 
 using Poco::Net::Socket;
+using Poco::Net::SocketBufVec;
 using Poco::Net::DatagramSocket;
+using Poco::Net::DatagramBatch;
 using Poco::Net::SocketAddress;
 using Poco::Net::IPAddress;
 #ifdef POCO_NET_HAS_INTERFACE
@@ -59,6 +62,117 @@ void DatagramSocketTest::testEcho()
 }
 
 
+void DatagramSocketTest::testEchoBuffers()
+{
+	UDPEchoServer echoServer;
+	DatagramSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+	SocketBufVec sendBufs;
+	sendBufs.push_back(Socket::makeBuffer("hello", 5));
+	sendBufs.push_back(Socket::makeBuffer(", world", 7));
+	int n = ss.sendBytes(sendBufs);
+	assertTrue (n == 12);
+
+	char buffer1[3];
+	char buffer2[256];
+	SocketBufVec recvBufs;
+	recvBufs.push_back(Socket::makeBuffer(buffer1, sizeof(buffer1)));
+	recvBufs.push_back(Socket::makeBuffer(buffer2, sizeof(buffer2)));
+	n = ss.receiveBytes(recvBufs);
+	assertTrue (n == 12);
+	assertTrue (std::string(buffer1, 3) == "hel");
+	assertTrue (std::string(buffer2, 9) == "lo, world");
+	ss.close();
+}
+
+
+void DatagramSocketTest::testBatch()
+{
+	DatagramSocket receiver(SocketAddress("127.0.0.1", 0));
+	DatagramSocket sender(SocketAddress("127.0.0.1", 0));
+	SocketAddress receiverAddress = receiver.address();
+
+	DatagramBatch sendBatch(4, 16);
+	sendBatch.add("a", 1, receiverAddress);
+	sendBatch.add("bb", 2, receiverAddress);
+	sendBatch.add("hello, world", 12, receiverAddress);
+	assertTrue (sendBatch.size() == 3);
+	try
+	{
+		sendBatch.add("0123456789abcdefg", 17, receiverAddress);
+		fail("datagram too large - must throw");
+	}
+	catch (InvalidArgumentException&)
+	{
+	}
+	int n = sender.sendBatch(sendBatch);
+	assertTrue (n == 3);
+
+	DatagramBatch recvBatch(8, 8);
+	n = receiver.receiveBatch(recvBatch);
+	assertTrue (n == 3);
+	assertTrue (recvBatch.size() == 3);
+	assertTrue (std::string(recvBatch.data(0), recvBatch.length(0)) == "a");
+	assertTrue (std::string(recvBatch.data(1), recvBatch.length(1)) == "bb");
+	assertTrue (std::string(recvBatch.data(2), recvBatch.length(2)) == "hello, w");
+	for (int i = 0; i < n; i++)
+	{
+		assertTrue (recvBatch.address(i) == sender.address());
+	}
+
+	receiver.setBlocking(false);
+	n = receiver.receiveBatch(recvBatch);
+	assertTrue (n < 0);
+	assertTrue (recvBatch.empty());
+	receiver.setBlocking(true);
+
+	sender.connect(receiverAddress);
+	sendBatch.clear();
+	sendBatch.add("peer", 4);
+	n = sender.sendBatch(sendBatch);
+	assertTrue (n == 1);
+	n = receiver.receiveBatch(recvBatch);
+	assertTrue (n == 1);
+	assertTrue (std::string(recvBatch.data(0), recvBatch.length(0)) == "peer");
+}
+
+
+void DatagramSocketTest::testBatchSegmented()
+{
+	DatagramSocket receiver(SocketAddress("127.0.0.1", 0));
+	DatagramSocket sender(SocketAddress::IPv4);
+	SocketAddress receiverAddress = receiver.address();
+
+	// equally sized datagrams to the same address may be sent
+	// with segmentation offload, but must still arrive separately
+	const int count = 20;
+	DatagramBatch sendBatch(count, 100);
+	std::string payload(100, ' ');
+	for (int i = 0; i < count; i++)
+	{
+		payload[0] = static_cast<char>('A' + i);
+		sendBatch.add(payload.data(), i == count - 1 ? 50 : 100, receiverAddress);
+	}
+	int n = sender.sendBatch(sendBatch);
+	assertTrue (n == count);
+
+	DatagramBatch recvBatch(2*count, 200);
+	int received = 0;
+	while (received < count)
+	{
+		n = receiver.receiveBatch(recvBatch);
+		assertTrue (n > 0);
+		for (int i = 0; i < n; i++)
+		{
+			assertTrue (recvBatch.data(i)[0] == 'A' + received);
+			assertTrue (recvBatch.length(i) == (received == count - 1 ? 50 : 100));
+			received++;
+		}
+	}
+	assertTrue (received == count);
+}
+
+
 void DatagramSocketTest::testSendToReceiveFrom()
 {
 	UDPEchoServer echoServer(SocketAddress("127.0.0.1", 0));
@@ -148,7 +262,10 @@ CppUnit::Test* DatagramSocketTest::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("DatagramSocketTest");
 
 	CppUnit_addTest(pSuite, DatagramSocketTest, testEcho);
+	CppUnit_addTest(pSuite, DatagramSocketTest, testEchoBuffers);
 	CppUnit_addTest(pSuite, DatagramSocketTest, testSendToReceiveFrom);
+	CppUnit_addTest(pSuite, DatagramSocketTest, testBatch);
+	CppUnit_addTest(pSuite, DatagramSocketTest, testBatchSegmented);
 	CppUnit_addTest(pSuite, DatagramSocketTest, testUnbound);
 #if (POCO_OS != POCO_OS_FREE_BSD) // works only with local net bcast and very randomly
 	CppUnit_addTest(pSuite, DatagramSocketTest, testBroadcast);
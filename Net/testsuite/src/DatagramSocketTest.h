@@ -25,7 +25,10 @@ public:
 	~DatagramSocketTest();
 
 	void testEcho();
+	void testEchoBuffers();
 	void testSendToReceiveFrom();
+	void testBatch();
+	void testBatchSegmented();
 	void testUnbound();
 	void testBroadcast();
 
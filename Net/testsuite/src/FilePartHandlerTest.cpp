@@ -0,0 +1,187 @@
+//
+// FilePartHandlerTest.cpp
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "FilePartHandlerTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/FilePartHandler.h"
+#include "Poco/Net/HTMLForm.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Exception.h"
+#include "Poco/File.h"
+#include <sstream>
+
+
+using Poco::Net::FilePartHandler;
+using Poco::Net::HTMLForm;
+using Poco::Net::HTTPRequest;
+using Poco::TemporaryFile;
+using Poco::FileInputStream;
+using Poco::StreamCopier;
+using Poco::File;
+
+
+namespace
+{
+	std::string makeForm(const std::string& data)
+	{
+		std::string form(
+			"--MIME_boundary_0123456789\r\n"
+			"Content-Disposition: form-data; name=\"field1\"\r\n"
+			"\r\n"
+			"value1\r\n"
+			"--MIME_boundary_0123456789\r\n"
+			"Content-Disposition: form-data; name=\"upload\"; filename=\"../data.bin\"\r\n"
+			"Content-Type: application/octet-stream\r\n"
+			"\r\n");
+		form.append(data);
+		form.append(
+			"\r\n--MIME_boundary_0123456789\r\n"
+			"Content-Disposition: form-data; name=\"text\"; filename=\"text.txt\"\r\n"
+			"Content-Type: text/plain\r\n"
+			"\r\n"
+			"This is a text file\r\n"
+			"--MIME_boundary_0123456789--\r\n");
+		return form;
+	}
+
+	std::string makeData()
+	{
+		std::string data;
+		for (int i = 0; data.size() < 200000; i++)
+		{
+			data += static_cast<char>(i % 256);
+		}
+		return data;
+	}
+
+	std::string readFile(const std::string& path)
+	{
+		FileInputStream istr(path);
+		std::string content;
+		StreamCopier::copyToString(istr, content);
+		return content;
+	}
+}
+
+
+FilePartHandlerTest::FilePartHandlerTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+FilePartHandlerTest::~FilePartHandlerTest()
+{
+}
+
+
+void FilePartHandlerTest::testTemporaryFiles()
+{
+	std::string data = makeData();
+	std::istringstream istr(makeForm(data));
+	HTTPRequest req("POST", "/upload");
+	req.setContentType(HTMLForm::ENCODING_MULTIPART + "; boundary=\"MIME_boundary_0123456789\"");
+	std::string path1;
+	std::string path2;
+	{
+		FilePartHandler handler;
+		HTMLForm form(req, istr, handler);
+		assertTrue (form.size() == 1);
+		assertTrue (form["field1"] == "value1");
+
+		assertTrue (handler.parts().size() == 2);
+		const FilePartHandler::Part& part1 = handler.parts()[0];
+		assertTrue (part1.name == "upload");
+		assertTrue (part1.filename == "../data.bin");
+		assertTrue (part1.contentType == "application/octet-stream");
+		assertTrue (part1.size == data.size());
+		assertTrue (readFile(part1.path) == data);
+		path1 = part1.path;
+
+		const FilePartHandler::Part& part2 = handler.parts()[1];
+		assertTrue (part2.name == "text");
+		assertTrue (part2.filename == "text.txt");
+		assertTrue (part2.contentType == "text/plain");
+		assertTrue (part2.size == 19);
+		assertTrue (readFile(part2.path) == "This is a text file");
+		path2 = part2.path;
+	}
+	assertTrue (!File(path1).exists());
+	assertTrue (!File(path2).exists());
+}
+
+
+void FilePartHandlerTest::testDirectory()
+{
+	TemporaryFile dir;
+	dir.createDirectories();
+
+	std::string data = makeData();
+	std::istringstream istr(makeForm(data));
+	HTTPRequest req("POST", "/upload");
+	req.setContentType(HTMLForm::ENCODING_MULTIPART + "; boundary=\"MIME_boundary_0123456789\"");
+	std::string path;
+	{
+		FilePartHandler handler(dir.path());
+		HTMLForm form(req, istr, handler);
+		assertTrue (handler.parts().size() == 2);
+		path = handler.parts()[0].path;
+		assertTrue (File(path).exists());
+		assertTrue (path.compare(0, dir.path().size(), dir.path()) == 0);
+	}
+	assertTrue (File(path).exists());
+	assertTrue (readFile(path) == data);
+}
+
+
+void FilePartHandlerTest::testMaxPartSize()
+{
+	std::string data = makeData();
+	std::istringstream istr(makeForm(data));
+	HTTPRequest req("POST", "/upload");
+	req.setContentType(HTMLForm::ENCODING_MULTIPART + "; boundary=\"MIME_boundary_0123456789\"");
+	FilePartHandler handler;
+	handler.setMaxPartSize(100000);
+	assertTrue (handler.getMaxPartSize() == 100000);
+	try
+	{
+		HTMLForm form(req, istr, handler);
+		fail("part too large - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+	assertTrue (handler.parts().empty());
+}
+
+
+void FilePartHandlerTest::setUp()
+{
+}
+
+
+void FilePartHandlerTest::tearDown()
+{
+}
+
+
+CppUnit::Test* FilePartHandlerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("FilePartHandlerTest");
+
+	CppUnit_addTest(pSuite, FilePartHandlerTest, testTemporaryFiles);
+	CppUnit_addTest(pSuite, FilePartHandlerTest, testDirectory);
+	CppUnit_addTest(pSuite, FilePartHandlerTest, testMaxPartSize);
+
+	return pSuite;
+}
@@ -0,0 +1,40 @@
+//
+// FilePartHandlerTest.h
+//
+// Definition of the FilePartHandlerTest class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef FilePartHandlerTest_INCLUDED
+#define FilePartHandlerTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class FilePartHandlerTest: public CppUnit::TestCase
+{
+public:
+	FilePartHandlerTest(const std::string& name);
+	~FilePartHandlerTest();
+
+	void testTemporaryFiles();
+	void testDirectory();
+	void testMaxPartSize();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // FilePartHandlerTest_INCLUDED
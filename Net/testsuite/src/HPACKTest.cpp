@@ -0,0 +1,377 @@
+//
+// HPACKTest.cpp
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HPACKTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/HPACKEncoder.h"
+#include "Poco/Net/HPACKDecoder.h"
+#include "Poco/Net/HPACKHuffman.h"
+#include "Poco/Net/NetException.h"
+
+
+using Poco::Net::HPACKEncoder;
+using Poco::Net::HPACKDecoder;
+using Poco::Net::HPACKHuffman;
+using Poco::Net::HPACKTable;
+using Poco::Net::HTTP2Exception;
+
+
+namespace
+{
+	std::string fromHex(const char* hex)
+	{
+		std::string result;
+		while (hex[0] && hex[1])
+		{
+			if (hex[0] == ' ')
+			{
+				++hex;
+				continue;
+			}
+			result += static_cast<char>(std::stoi(std::string(hex, 2), 0, 16));
+			hex += 2;
+		}
+		return result;
+	}
+}
+
+
+HPACKTest::HPACKTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HPACKTest::~HPACKTest()
+{
+}
+
+
+void HPACKTest::testInteger()
+{
+	// RFC 7541, C.1
+	std::string block;
+	HPACKEncoder::encodeInteger(10, 5, 0, block);
+	assertTrue (block == fromHex("0a"));
+	block.clear();
+	HPACKEncoder::encodeInteger(1337, 5, 0, block);
+	assertTrue (block == fromHex("1f 9a 0a"));
+	block.clear();
+	HPACKEncoder::encodeInteger(42, 8, 0, block);
+	assertTrue (block == fromHex("2a"));
+
+	const char* p = block.data();
+	assertTrue (HPACKDecoder::decodeInteger(p, block.data() + block.size(), 8) == 42);
+	assertTrue (p == block.data() + block.size());
+
+	block.clear();
+	HPACKEncoder::encodeInteger(0xFFFFFFFF, 7, 0x80, block);
+	p = block.data();
+	assertTrue (HPACKDecoder::decodeInteger(p, block.data() + block.size(), 7) == 0xFFFFFFFF);
+
+	block = fromHex("1f 9a");
+	p = block.data();
+	try
+	{
+		HPACKDecoder::decodeInteger(p, block.data() + block.size(), 5);
+		fail("truncated integer - must throw");
+	}
+	catch (HTTP2Exception&)
+	{
+	}
+}
+
+
+void HPACKTest::testHuffman()
+{
+	std::string encoded;
+	HPACKHuffman::encode("www.example.com", encoded);
+	assertTrue (encoded == fromHex("f1e3 c2e5 f23a 6ba0 ab90 f4ff"));
+	assertTrue (HPACKHuffman::encodedLength("www.example.com") == encoded.size());
+
+	std::string decoded;
+	HPACKHuffman::decode(encoded.data(), encoded.size(), decoded);
+	assertTrue (decoded == "www.example.com");
+
+	std::string all;
+	for (int i = 0; i < 256; i++) all += static_cast<char>(i);
+	encoded.clear();
+	HPACKHuffman::encode(all, encoded);
+	decoded.clear();
+	HPACKHuffman::decode(encoded.data(), encoded.size(), decoded);
+	assertTrue (decoded == all);
+
+	// padding longer than 7 bits
+	encoded = fromHex("ff ff");
+	decoded.clear();
+	try
+	{
+		HPACKHuffman::decode(encoded.data(), encoded.size(), decoded);
+		fail("invalid padding - must throw");
+	}
+	catch (HTTP2Exception&)
+	{
+	}
+}
+
+
+void HPACKTest::testDecodeLiteral()
+{
+	// RFC 7541, C.3
+	HPACKDecoder decoder;
+	HPACKTable::HeaderList headers;
+	std::string block = fromHex("8286 8441 0f77 7777 2e65 7861 6d70 6c65 2e63 6f6d");
+	decoder.decode(block.data(), block.size(), headers);
+	assertTrue (headers.size() == 4);
+	assertTrue (headers[0] == HPACKTable::Header(":method", "GET"));
+	assertTrue (headers[1] == HPACKTable::Header(":scheme", "http"));
+	assertTrue (headers[2] == HPACKTable::Header(":path", "/"));
+	assertTrue (headers[3] == HPACKTable::Header(":authority", "www.example.com"));
+	assertTrue (decoder.table().size() == 57);
+
+	headers.clear();
+	block = fromHex("8286 84be 5808 6e6f 2d63 6163 6865");
+	decoder.decode(block.data(), block.size(), headers);
+	assertTrue (headers.size() == 5);
+	assertTrue (headers[3] == HPACKTable::Header(":authority", "www.example.com"));
+	assertTrue (headers[4] == HPACKTable::Header("cache-control", "no-cache"));
+	assertTrue (decoder.table().size() == 110);
+
+	headers.clear();
+	block = fromHex("8287 85bf 400a 6375 7374 6f6d 2d6b 6579 0c63 7573 746f 6d2d 7661 6c75 65");
+	decoder.decode(block.data(), block.size(), headers);
+	assertTrue (headers.size() == 5);
+	assertTrue (headers[1] == HPACKTable::Header(":scheme", "https"));
+	assertTrue (headers[2] == HPACKTable::Header(":path", "/index.html"));
+	assertTrue (headers[3] == HPACKTable::Header(":authority", "www.example.com"));
+	assertTrue (headers[4] == HPACKTable::Header("custom-key", "custom-value"));
+	assertTrue (decoder.table().size() == 164);
+	assertTrue (decoder.table().count() == 3);
+}
+
+
+void HPACKTest::testDecodeHuffman()
+{
+	// RFC 7541, C.4
+	HPACKDecoder decoder;
+	HPACKTable::HeaderList headers;
+	std::string block = fromHex("8286 8441 8cf1 e3c2 e5f2 3a6b a0ab 90f4 ff");
+	decoder.decode(block.data(), block.size(), headers);
+	assertTrue (headers.size() == 4);
+	assertTrue (headers[3] == HPACKTable::Header(":authority", "www.example.com"));
+
+	headers.clear();
+	block = fromHex("8286 84be 5886 a8eb 1064 9cbf");
+	decoder.decode(block.data(), block.size(), headers);
+	assertTrue (headers.size() == 5);
+	assertTrue (headers[4] == HPACKTable::Header("cache-control", "no-cache"));
+
+	headers.clear();
+	block = fromHex("8287 85bf 4088 25a8 49e9 5ba9 7d7f 8925 a849 e95b b8e8 b4bf");
+	decoder.decode(block.data(), block.size(), headers);
+	assertTrue (headers.size() == 5);
+	assertTrue (headers[4] == HPACKTable::Header("custom-key", "custom-value"));
+	assertTrue (decoder.table().size() == 164);
+}
+
+
+void HPACKTest::testEncode()
+{
+	HPACKEncoder encoder;
+	HPACKDecoder decoder;
+
+	HPACKTable::HeaderList headers;
+	headers.push_back(HPACKTable::Header(":method", "GET"));
+	headers.push_back(HPACKTable::Header(":scheme", "http"));
+	headers.push_back(HPACKTable::Header(":path", "/"));
+	headers.push_back(HPACKTable::Header(":authority", "www.example.com"));
+	std::string block;
+	encoder.encode(headers, block);
+	assertTrue (block == fromHex("8286 8441 8cf1 e3c2 e5f2 3a6b a0ab 90f4 ff"));
+
+	HPACKTable::HeaderList decoded;
+	decoder.decode(block.data(), block.size(), decoded);
+	assertTrue (decoded == headers);
+
+	// the second time, all fields are found in the tables
+	std::string block2;
+	encoder.encode(headers, block2);
+	assertTrue (block2 == fromHex("8286 84be"));
+	decoded.clear();
+	decoder.decode(block2.data(), block2.size(), decoded);
+	assertTrue (decoded == headers);
+
+	headers.push_back(HPACKTable::Header("x-empty", ""));
+	headers.push_back(HPACKTable::Header("x-long", std::string(5000, 'a')));
+	block.clear();
+	encoder.encode(headers, block);
+	decoded.clear();
+	decoder.decode(block.data(), block.size(), decoded);
+	assertTrue (decoded == headers);
+}
+
+
+void HPACKTest::testEviction()
+{
+	HPACKTable table(100);
+	table.add("name1", "value1");
+	table.add("name2", "value2");
+	assertTrue (table.count() == 2);
+	assertTrue (table.size() == 2*43);
+	assertTrue (table.get(HPACKTable::STATIC_TABLE_SIZE + 1).first == "name2");
+	assertTrue (table.get(HPACKTable::STATIC_TABLE_SIZE + 2).first == "name1");
+
+	table.add("name3", "value3");
+	assertTrue (table.count() == 2);
+	assertTrue (table.get(HPACKTable::STATIC_TABLE_SIZE + 1).first == "name3");
+	assertTrue (table.get(HPACKTable::STATIC_TABLE_SIZE + 2).first == "name2");
+
+	bool exact = false;
+	assertTrue (table.find("name2", "value2", exact) == HPACKTable::STATIC_TABLE_SIZE + 2);
+	assertTrue (exact);
+	assertTrue (table.find("name2", "other", exact) == HPACKTable::STATIC_TABLE_SIZE + 2);
+	assertTrue (!exact);
+	assertTrue (table.find("name1", "value1", exact) == 0);
+	assertTrue (table.find(":method", "GET", exact) == 2);
+	assertTrue (exact);
+
+	// an entry larger than the table empties it
+	table.add("name4", std::string(100, 'x'));
+	assertTrue (table.count() == 0);
+	assertTrue (table.size() == 0);
+
+	try
+	{
+		table.get(HPACKTable::STATIC_TABLE_SIZE + 1);
+		fail("no such entry - must throw");
+	}
+	catch (HTTP2Exception&)
+	{
+	}
+}
+
+
+void HPACKTest::testTableSizeUpdate()
+{
+	HPACKEncoder encoder;
+	HPACKDecoder decoder;
+
+	HPACKTable::HeaderList headers;
+	headers.push_back(HPACKTable::Header("custom-key", "custom-value"));
+	std::string block;
+	encoder.encode(headers, block);
+	HPACKTable::HeaderList decoded;
+	decoder.decode(block.data(), block.size(), decoded);
+	assertTrue (decoder.table().count() == 1);
+
+	// the encoder signals the new size with the next block
+	encoder.setMaxTableSize(0);
+	block.clear();
+	encoder.encode(headers, block);
+	assertTrue (static_cast<unsigned char>(block[0]) == 0x20);
+	decoded.clear();
+	decoder.decode(block.data(), block.size(), decoded);
+	assertTrue (decoded == headers);
+	assertTrue (decoder.table().count() == 0);
+	assertTrue (decoder.table().maxSize() == 0);
+
+	// a size update exceeding the limit
+	block = fromHex("3fe2 1f");
+	decoded.clear();
+	try
+	{
+		decoder.decode(block.data(), block.size(), decoded);
+		fail("table size exceeds limit - must throw");
+	}
+	catch (HTTP2Exception&)
+	{
+	}
+}
+
+
+void HPACKTest::testInvalid()
+{
+	HPACKDecoder decoder;
+	HPACKTable::HeaderList headers;
+
+	// index 0
+	std::string block = fromHex("80");
+	try
+	{
+		decoder.decode(block.data(), block.size(), headers);
+		fail("invalid index - must throw");
+	}
+	catch (HTTP2Exception&)
+	{
+	}
+
+	// size update after a header field
+	block = fromHex("82 20");
+	try
+	{
+		decoder.decode(block.data(), block.size(), headers);
+		fail("misplaced size update - must throw");
+	}
+	catch (HTTP2Exception&)
+	{
+	}
+
+	// truncated string
+	block = fromHex("40 0a 61 62");
+	try
+	{
+		decoder.decode(block.data(), block.size(), headers);
+		fail("truncated string - must throw");
+	}
+	catch (HTTP2Exception&)
+	{
+	}
+
+	// header list too large
+	HPACKDecoder limited;
+	limited.setMaxHeaderListSize(50);
+	headers.clear();
+	block = fromHex("8286 8441 0f77 7777 2e65 7861 6d70 6c65 2e63 6f6d");
+	try
+	{
+		limited.decode(block.data(), block.size(), headers);
+		fail("header list too large - must throw");
+	}
+	catch (HTTP2Exception&)
+	{
+	}
+}
+
+
+void HPACKTest::setUp()
+{
+}
+
+
+void HPACKTest::tearDown()
+{
+}
+
+
+CppUnit::Test* HPACKTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HPACKTest");
+
+	CppUnit_addTest(pSuite, HPACKTest, testInteger);
+	CppUnit_addTest(pSuite, HPACKTest, testHuffman);
+	CppUnit_addTest(pSuite, HPACKTest, testDecodeLiteral);
+	CppUnit_addTest(pSuite, HPACKTest, testDecodeHuffman);
+	CppUnit_addTest(pSuite, HPACKTest, testEncode);
+	CppUnit_addTest(pSuite, HPACKTest, testEviction);
+	CppUnit_addTest(pSuite, HPACKTest, testTableSizeUpdate);
+	CppUnit_addTest(pSuite, HPACKTest, testInvalid);
+
+	return pSuite;
+}
@@ -0,0 +1,45 @@
+//
+// HPACKTest.h
+//
+// Definition of the HPACKTest class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef HPACKTest_INCLUDED
+#define HPACKTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class HPACKTest: public CppUnit::TestCase
+{
+public:
+	HPACKTest(const std::string& name);
+	~HPACKTest();
+
+	void testInteger();
+	void testHuffman();
+	void testDecodeLiteral();
+	void testDecodeHuffman();
+	void testEncode();
+	void testEviction();
+	void testTableSizeUpdate();
+	void testInvalid();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // HPACKTest_INCLUDED
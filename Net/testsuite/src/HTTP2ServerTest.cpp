@@ -0,0 +1,395 @@
+//
+// HTTP2ServerTest.cpp
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HTTP2ServerTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/HTTP2ClientSession.h"
+#include "Poco/Net/HTTP2Frame.h"
+#include "Poco/Net/HPACKDecoder.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
+#include <vector>
+
+
+using Poco::Net::HTTPServer;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPClientSession;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPResponse;
+using Poco::Net::HTTPMessage;
+using Poco::Net::HTTP2ClientSession;
+using Poco::Net::HTTP2Frame;
+using Poco::Net::HPACKDecoder;
+using Poco::Net::HPACKTable;
+using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::StreamCopier;
+
+
+namespace
+{
+	Poco::FastMutex requestLogMutex;
+	std::vector<std::string> requestLog;
+
+	class EchoBodyRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			if (request.getContentLength() != HTTPMessage::UNKNOWN_CONTENT_LENGTH)
+				response.setContentLength(request.getContentLength());
+			response.setContentType(request.getContentType());
+			response.set("X-Version", request.getVersion());
+			std::istream& istr = request.stream();
+			std::ostream& ostr = response.send();
+			StreamCopier::copyStream(istr, ostr);
+		}
+	};
+
+	class LogRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			{
+				Poco::FastMutex::ScopedLock lock(requestLogMutex);
+				requestLog.push_back(request.getURI());
+			}
+			if (request.getURI() == "/slow") Poco::Thread::sleep(300);
+			response.sendBuffer(request.getURI().data(), request.getURI().size());
+		}
+	};
+
+	class RequestHandlerFactory: public HTTPRequestHandlerFactory
+	{
+	public:
+		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+		{
+			if (request.getURI() == "/echoBody")
+				return new EchoBodyRequestHandler;
+			else if (request.getURI() != "/notImpl")
+				return new LogRequestHandler;
+			else
+				return 0;
+		}
+	};
+
+	HTTPServerParams* createParams()
+	{
+		HTTPServerParams* pParams = new HTTPServerParams;
+		pParams->setHTTP2Enabled(true);
+		return pParams;
+	}
+
+	bool receiveH2Response(StreamSocket& socket, std::string& buffer, HPACKTable::HeaderList& headers, std::string& body)
+		/// Receives frames until the end of stream 1, which
+		/// carries the response to an upgraded request.
+	{
+		HPACKDecoder decoder;
+		for (;;)
+		{
+			while (buffer.size() >= HTTP2Frame::HEADER_SIZE)
+			{
+				HTTP2Frame frame;
+				std::size_t length = frame.parseHeader(buffer.data());
+				if (buffer.size() < HTTP2Frame::HEADER_SIZE + length) break;
+				const char* payload = buffer.data() + HTTP2Frame::HEADER_SIZE;
+				bool end = (frame.flags() & HTTP2Frame::FLAG_END_STREAM) != 0;
+				if (frame.streamId() == 1 && frame.type() == HTTP2Frame::FRAME_HEADERS)
+					decoder.decode(payload, length, headers);
+				else if (frame.streamId() == 1 && frame.type() == HTTP2Frame::FRAME_DATA)
+					body.append(payload, length);
+				else if (frame.streamId() == 1 && frame.type() == HTTP2Frame::FRAME_RST_STREAM)
+					return false;
+				buffer.erase(0, HTTP2Frame::HEADER_SIZE + length);
+				if (frame.streamId() == 1 && end) return true;
+			}
+			char data[4096];
+			int n = socket.receiveBytes(data, sizeof(data));
+			if (n <= 0) return false;
+			buffer.append(data, n);
+		}
+	}
+}
+
+
+HTTP2ServerTest::HTTP2ServerTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HTTP2ServerTest::~HTTP2ServerTest()
+{
+}
+
+
+void HTTP2ServerTest::testPriorKnowledge()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+
+	HTTP2ClientSession cs("127.0.0.1", svs.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_POST, "/echoBody");
+	request.setContentType("text/plain");
+	std::string body(5000, 'x');
+	Poco::UInt32 id = cs.sendRequest(request, body);
+	assertTrue (id == 1);
+
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(id, response, rbody);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (response.getVersion() == HTTPMessage::HTTP_2_0);
+	assertTrue (response.get("X-Version") == HTTPMessage::HTTP_2_0);
+	assertTrue (response.getContentType() == "text/plain");
+	assertTrue (response.getContentLength() == body.size());
+	assertTrue (rbody == body);
+
+	// a second request on the same connection
+	HTTPRequest request2(HTTPRequest::HTTP_GET, "/hello");
+	id = cs.sendRequest(request2);
+	assertTrue (id == 3);
+	cs.receiveResponse(id, response, rbody);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (rbody == "/hello");
+}
+
+
+void HTTP2ServerTest::testLargeBody()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+
+	// larger than the initial flow control windows
+	std::string body;
+	for (int i = 0; i < 300000; i++) body += static_cast<char>('a' + i % 26);
+
+	HTTP2ClientSession cs("127.0.0.1", svs.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_POST, "/echoBody");
+	Poco::UInt32 id = cs.sendRequest(request, body);
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(id, response, rbody);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (rbody == body);
+}
+
+
+void HTTP2ServerTest::testConcurrentStreams()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = createParams();
+	pParams->setHTTP2MaxConcurrentStreams(4);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	HTTP2ClientSession cs("127.0.0.1", svs.address().port());
+	std::vector<Poco::UInt32> ids;
+	for (int i = 0; i < 4; i++)
+	{
+		HTTPRequest request(HTTPRequest::HTTP_POST, "/echoBody");
+		ids.push_back(cs.sendRequest(request, std::string(40000 + i, 'a' + i)));
+	}
+	// receive the responses in reverse order
+	for (int i = 3; i >= 0; i--)
+	{
+		HTTPResponse response;
+		std::string rbody;
+		cs.receiveResponse(ids[i], response, rbody);
+		assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+		assertTrue (rbody == std::string(40000 + i, 'a' + i));
+	}
+
+	// more requests than the server allows concurrently
+	ids.clear();
+	for (int i = 0; i < 20; i++)
+	{
+		HTTPRequest request(HTTPRequest::HTTP_GET, "/r" + std::to_string(i));
+		ids.push_back(cs.sendRequest(request));
+	}
+	for (int i = 16; i < 20; i++)
+	{
+		HTTPResponse response;
+		std::string rbody;
+		cs.receiveResponse(ids[i], response, rbody);
+		assertTrue (rbody == "/r" + std::to_string(i));
+	}
+}
+
+
+void HTTP2ServerTest::testPriority()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+	{
+		Poco::FastMutex::ScopedLock lock(requestLogMutex);
+		requestLog.clear();
+	}
+
+	HTTP2ClientSession cs("127.0.0.1", svs.address().port());
+	std::vector<Poco::UInt32> ids;
+	HTTPRequest slow(HTTPRequest::HTTP_GET, "/slow");
+	ids.push_back(cs.sendRequest(slow));
+	Poco::Thread::sleep(100);
+
+	// sent while the server is busy with /slow
+	static const char* requests[][2] = {{"/u5", "u=5"}, {"/u1", "u=1"}, {"/u3", 0}, {"/u0", "u=0, i"}};
+	for (int i = 0; i < 4; i++)
+	{
+		HTTPRequest request(HTTPRequest::HTTP_GET, requests[i][0]);
+		if (requests[i][1]) request.set("Priority", requests[i][1]);
+		ids.push_back(cs.sendRequest(request));
+	}
+	for (std::size_t i = 0; i < ids.size(); i++)
+	{
+		HTTPResponse response;
+		std::string rbody;
+		cs.receiveResponse(ids[i], response, rbody);
+		assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	}
+
+	Poco::FastMutex::ScopedLock lock(requestLogMutex);
+	assertTrue (requestLog.size() == 5);
+	assertTrue (requestLog[0] == "/slow");
+	assertTrue (requestLog[1] == "/u0");
+	assertTrue (requestLog[2] == "/u1");
+	assertTrue (requestLog[3] == "/u3");
+	assertTrue (requestLog[4] == "/u5");
+}
+
+
+void HTTP2ServerTest::testNotImpl()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+
+	HTTP2ClientSession cs("127.0.0.1", svs.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/notImpl");
+	Poco::UInt32 id = cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(id, response, rbody);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_NOT_IMPLEMENTED);
+	assertTrue (rbody.empty());
+}
+
+
+void HTTP2ServerTest::testUpgrade()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", svs.address().port()));
+	std::string request(
+		"GET /hello HTTP/1.1\r\n"
+		"Host: localhost\r\n"
+		"Connection: Upgrade, HTTP2-Settings\r\n"
+		"Upgrade: h2c\r\n"
+		"HTTP2-Settings: AAMAAABkAAQAAP__\r\n"
+		"\r\n");
+	ss.sendBytes(request.data(), static_cast<int>(request.size()));
+
+	std::string buffer;
+	std::string::size_type pos;
+	while ((pos = buffer.find("\r\n\r\n")) == std::string::npos)
+	{
+		char data[1024];
+		int n = ss.receiveBytes(data, sizeof(data));
+		assertTrue (n > 0);
+		buffer.append(data, n);
+	}
+	assertTrue (buffer.compare(0, 12, "HTTP/1.1 101") == 0);
+	buffer.erase(0, pos + 4);
+
+	std::string preface(HTTP2Frame::PREFACE);
+	char settings[HTTP2Frame::HEADER_SIZE];
+	HTTP2Frame::formatHeader(settings, 0, HTTP2Frame::FRAME_SETTINGS, 0, 0);
+	preface.append(settings, sizeof(settings));
+	ss.sendBytes(preface.data(), static_cast<int>(preface.size()));
+
+	HPACKTable::HeaderList headers;
+	std::string body;
+	assertTrue (receiveH2Response(ss, buffer, headers, body));
+	assertTrue (!headers.empty());
+	assertTrue (headers[0] == HPACKTable::Header(":status", "200"));
+	assertTrue (body == "/hello");
+}
+
+
+void HTTP2ServerTest::testHTTP1()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+
+	// HTTP/1.1 clients are still served
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_POST, "/echoBody", HTTPMessage::HTTP_1_1);
+	std::string body(1000, 'x');
+	request.setContentLength(static_cast<int>(body.size()));
+	cs.sendRequest(request) << body;
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (response.get("X-Version") == HTTPMessage::HTTP_1_1);
+	assertTrue (rbody == body);
+}
+
+
+void HTTP2ServerTest::setUp()
+{
+}
+
+
+void HTTP2ServerTest::tearDown()
+{
+}
+
+
+CppUnit::Test* HTTP2ServerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTP2ServerTest");
+
+	CppUnit_addTest(pSuite, HTTP2ServerTest, testPriorKnowledge);
+	CppUnit_addTest(pSuite, HTTP2ServerTest, testLargeBody);
+	CppUnit_addTest(pSuite, HTTP2ServerTest, testConcurrentStreams);
+	CppUnit_addTest(pSuite, HTTP2ServerTest, testPriority);
+	CppUnit_addTest(pSuite, HTTP2ServerTest, testNotImpl);
+	CppUnit_addTest(pSuite, HTTP2ServerTest, testUpgrade);
+	CppUnit_addTest(pSuite, HTTP2ServerTest, testHTTP1);
+
+	return pSuite;
+}
@@ -0,0 +1,44 @@
+//
+// HTTP2ServerTest.h
+//
+// Definition of the HTTP2ServerTest class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef HTTP2ServerTest_INCLUDED
+#define HTTP2ServerTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class HTTP2ServerTest: public CppUnit::TestCase
+{
+public:
+	HTTP2ServerTest(const std::string& name);
+	~HTTP2ServerTest();
+
+	void testPriorKnowledge();
+	void testLargeBody();
+	void testConcurrentStreams();
+	void testPriority();
+	void testNotImpl();
+	void testUpgrade();
+	void testHTTP1();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // HTTP2ServerTest_INCLUDED
@@ -0,0 +1,342 @@
+//
+// HTTPClientSessionPoolTest.cpp
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HTTPClientSessionPoolTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/HTTPClientSessionPool.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPStreamFactory.h"
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/URI.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Exception.h"
+#include "Poco/Thread.h"
+#include <sstream>
+#include <memory>
+
+
+using Poco::Net::HTTPClientSessionPool;
+using Poco::Net::HTTPClientSession;
+using Poco::Net::HTTPStreamFactory;
+using Poco::Net::HTTPServer;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPResponse;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPMessage;
+using Poco::Net::ServerSocket;
+using Poco::URI;
+using Poco::StreamCopier;
+using Poco::Timespan;
+
+
+namespace
+{
+	class HelloRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			static const std::string body("Hello, world!");
+
+			response.setContentType("text/plain");
+			response.setContentLength(static_cast<int>(body.size()));
+			response.send() << body;
+		}
+	};
+
+	class HelloRequestHandlerFactory: public HTTPRequestHandlerFactory
+	{
+	public:
+		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+		{
+			return new HelloRequestHandler;
+		}
+	};
+
+	std::string get(HTTPClientSession& session)
+	{
+		HTTPRequest request(HTTPRequest::HTTP_GET, "/", HTTPMessage::HTTP_1_1);
+		session.sendRequest(request);
+		HTTPResponse response;
+		std::istream& rs = session.receiveResponse(response);
+		std::ostringstream ostr;
+		StreamCopier::copyStream(rs, ostr);
+		return ostr.str();
+	}
+
+	HTTPServerParams* createParams(bool keepAlive)
+	{
+		HTTPServerParams* pParams = new HTTPServerParams;
+		pParams->setKeepAlive(keepAlive);
+		return pParams;
+	}
+}
+
+
+HTTPClientSessionPoolTest::HTTPClientSessionPoolTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HTTPClientSessionPoolTest::~HTTPClientSessionPoolTest()
+{
+}
+
+
+void HTTPClientSessionPoolTest::testReuse()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new HelloRequestHandlerFactory, svs, createParams(true));
+	srv.start();
+
+	HTTPClientSessionPool pool;
+	HTTPClientSession* pSession = pool.acquire("http", "127.0.0.1", svs.address().port());
+	assertTrue (pool.leased() == 1);
+	assertTrue (pool.misses() == 1);
+	assertTrue (get(*pSession) == "Hello, world!");
+	pool.release(pSession);
+	assertTrue (pool.leased() == 0);
+	assertTrue (pool.idle() == 1);
+
+	HTTPClientSession* pSession2 = pool.acquire("http", "127.0.0.1", svs.address().port());
+	assertTrue (pSession2 == pSession);
+	assertTrue (pool.hits() == 1);
+	assertTrue (pool.idle() == 0);
+	assertTrue (get(*pSession2) == "Hello, world!");
+	pool.release(pSession2);
+
+	assertTrue (srv.totalConnections() == 1);
+	srv.stop();
+}
+
+
+void HTTPClientSessionPoolTest::testHosts()
+{
+	ServerSocket svs1(0);
+	HTTPServer srv1(new HelloRequestHandlerFactory, svs1, createParams(true));
+	srv1.start();
+	ServerSocket svs2(0);
+	HTTPServer srv2(new HelloRequestHandlerFactory, svs2, createParams(true));
+	srv2.start();
+
+	HTTPClientSessionPool pool;
+	HTTPClientSession* pSession1 = pool.acquire(URI("http://127.0.0.1:" + std::to_string(svs1.address().port()) + "/"));
+	assertTrue (get(*pSession1) == "Hello, world!");
+	pool.release(pSession1);
+
+	HTTPClientSession* pSession2 = pool.acquire(URI("http://127.0.0.1:" + std::to_string(svs2.address().port()) + "/"));
+	assertTrue (pSession2 != pSession1);
+	assertTrue (pool.misses() == 2);
+	assertTrue (get(*pSession2) == "Hello, world!");
+	pool.release(pSession2);
+	assertTrue (pool.idle() == 2);
+
+	srv1.stop();
+	srv2.stop();
+}
+
+
+void HTTPClientSessionPoolTest::testServerClose()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new HelloRequestHandlerFactory, svs, createParams(false));
+	srv.start();
+
+	HTTPClientSessionPool pool;
+	HTTPClientSession* pSession = pool.acquire("http", "127.0.0.1", svs.address().port());
+	assertTrue (get(*pSession) == "Hello, world!");
+	pool.release(pSession);
+
+	// the server has answered with Connection: close
+	pSession = pool.acquire("http", "127.0.0.1", svs.address().port());
+	assertTrue (pool.hits() == 0);
+	assertTrue (pool.misses() == 2);
+	assertTrue (get(*pSession) == "Hello, world!");
+	pool.release(pSession);
+
+	srv.stop();
+}
+
+
+void HTTPClientSessionPoolTest::testDiscard()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new HelloRequestHandlerFactory, svs, createParams(true));
+	srv.start();
+
+	HTTPClientSessionPool pool;
+	HTTPClientSession* pSession = pool.acquire("http", "127.0.0.1", svs.address().port());
+	assertTrue (get(*pSession) == "Hello, world!");
+	pool.discard(pSession);
+	assertTrue (pool.idle() == 0);
+	assertTrue (pool.leased() == 0);
+
+	HTTPClientSession session("127.0.0.1", svs.address().port());
+	try
+	{
+		pool.release(&session);
+		fail("not leased - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	srv.stop();
+}
+
+
+void HTTPClientSessionPoolTest::testMaxSessions()
+{
+	HTTPClientSessionPool pool(2, Timespan(30, 0), Timespan(0, 200000));
+	HTTPClientSession* pSession1 = pool.acquire("http", "127.0.0.1", 80);
+	HTTPClientSession* pSession2 = pool.acquire("http", "127.0.0.1", 80);
+	assertTrue (pool.leased() == 2);
+	try
+	{
+		pool.acquire("http", "127.0.0.1", 80);
+		fail("limit reached - must throw");
+	}
+	catch (Poco::TimeoutException&)
+	{
+	}
+	assertTrue (pool.waits() == 1);
+	assertTrue (pool.timeouts() == 1);
+
+	// other hosts are not affected
+	HTTPClientSession* pSession3 = pool.acquire("http", "127.0.0.1", 81);
+	pool.discard(pSession3);
+
+	class Releaser: public Poco::Runnable
+	{
+	public:
+		Releaser(HTTPClientSessionPool& pool, HTTPClientSession* pSession):
+			_pool(pool),
+			_pSession(pSession)
+		{
+		}
+
+		void run()
+		{
+			Poco::Thread::sleep(50);
+			_pool.discard(_pSession);
+		}
+
+	private:
+		HTTPClientSessionPool& _pool;
+		HTTPClientSession* _pSession;
+	};
+
+	Releaser releaser(pool, pSession1);
+	Poco::Thread thread;
+	thread.start(releaser);
+	pSession3 = pool.acquire("http", "127.0.0.1", 80);
+	thread.join();
+	assertTrue (pool.waits() == 2);
+	assertTrue (pool.timeouts() == 1);
+	assertTrue (pool.leased() == 2);
+
+	pool.discard(pSession2);
+	pool.discard(pSession3);
+}
+
+
+void HTTPClientSessionPoolTest::testIdleTimeout()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new HelloRequestHandlerFactory, svs, createParams(true));
+	srv.start();
+
+	HTTPClientSessionPool pool(4, Timespan(0, 100000));
+	HTTPClientSession* pSession = pool.acquire("http", "127.0.0.1", svs.address().port());
+	assertTrue (get(*pSession) == "Hello, world!");
+	pool.release(pSession);
+	assertTrue (pool.idle() == 1);
+	pool.purge();
+	assertTrue (pool.idle() == 1);
+
+	Poco::Thread::sleep(200);
+	pool.purge();
+	assertTrue (pool.idle() == 0);
+
+	srv.stop();
+}
+
+
+void HTTPClientSessionPoolTest::testStreamFactory()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new HelloRequestHandlerFactory, svs, createParams(true));
+	srv.start();
+
+	HTTPClientSessionPool::Ptr pPool = new HTTPClientSessionPool;
+	HTTPStreamFactory factory(pPool);
+	URI uri("http://127.0.0.1/");
+	uri.setPort(svs.address().port());
+	for (int i = 0; i < 3; ++i)
+	{
+		std::unique_ptr<std::istream> pStr(factory.open(uri));
+		std::ostringstream ostr;
+		StreamCopier::copyStream(*pStr.get(), ostr);
+		assertTrue (ostr.str() == "Hello, world!");
+		assertTrue (pPool->leased() == 1);
+	}
+	assertTrue (pPool->leased() == 0);
+	assertTrue (pPool->idle() == 1);
+	assertTrue (pPool->misses() == 1);
+	assertTrue (pPool->hits() == 2);
+
+	// a stream that has not been read to the end gives up its connection
+	{
+		std::unique_ptr<std::istream> pStr(factory.open(uri));
+	}
+	assertTrue (pPool->idle() == 0);
+	assertTrue (pPool->leased() == 0);
+
+	srv.stop();
+}
+
+
+void HTTPClientSessionPoolTest::setUp()
+{
+}
+
+
+void HTTPClientSessionPoolTest::tearDown()
+{
+}
+
+
+CppUnit::Test* HTTPClientSessionPoolTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPClientSessionPoolTest");
+
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testReuse);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testHosts);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testServerClose);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testDiscard);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testMaxSessions);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testIdleTimeout);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testStreamFactory);
+
+	return pSuite;
+}
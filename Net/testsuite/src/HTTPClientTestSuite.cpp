@@ -11,6 +11,7 @@
 #include "HTTPClientTestSuite.h"
 #include "HTTPClientSessionTest.h"
 #include "HTTPStreamFactoryTest.h"
+#include "HTTPClientSessionPoolTest.h"
 
 
 CppUnit::Test* HTTPClientTestSuite::suite()
@@ -19,6 +20,7 @@ CppUnit::Test* HTTPClientTestSuite::suite()
 
 	pSuite->addTest(HTTPClientSessionTest::suite());
 	pSuite->addTest(HTTPStreamFactoryTest::suite());
+	pSuite->addTest(HTTPClientSessionPoolTest::suite());
 
 	return pSuite;
 }
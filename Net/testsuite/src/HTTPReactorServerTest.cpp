@@ -0,0 +1,358 @@
+//
+// HTTPReactorServerTest.cpp
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HTTPReactorServerTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/HTTPReactorServer.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketStream.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Thread.h"
+#include <sstream>
+#include <vector>
+
+
+using Poco::Net::HTTPReactorServer;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPClientSession;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPResponse;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPMessage;
+using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketStream;
+using Poco::Net::SocketAddress;
+using Poco::StreamCopier;
+
+
+namespace
+{
+	class EchoBodyRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			if (request.getChunkedTransferEncoding())
+				response.setChunkedTransferEncoding(true);
+			else if (request.getContentLength() != HTTPMessage::UNKNOWN_CONTENT_LENGTH)
+				response.setContentLength(request.getContentLength());
+
+			response.setContentType(request.getContentType());
+
+			std::istream& istr = request.stream();
+			std::ostream& ostr = response.send();
+			StreamCopier::copyStream(istr, ostr);
+		}
+	};
+
+	class EchoHeaderRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			std::ostringstream osstr;
+			request.write(osstr);
+			int n = (int) osstr.str().length();
+			response.setContentLength(n);
+			std::ostream& ostr = response.send();
+			if (request.getMethod() != HTTPRequest::HTTP_HEAD)
+				request.write(ostr);
+		}
+	};
+
+	class RequestHandlerFactory: public HTTPRequestHandlerFactory
+	{
+	public:
+		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+		{
+			if (request.getURI() == "/echoBody")
+				return new EchoBodyRequestHandler;
+			else if (request.getURI() == "/echoHeader")
+				return new EchoHeaderRequestHandler;
+			else
+				return 0;
+		}
+	};
+}
+
+
+HTTPReactorServerTest::HTTPReactorServerTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HTTPReactorServerTest::~HTTPReactorServerTest()
+{
+}
+
+
+void HTTPReactorServerTest::testIdentityRequest()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(false);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams, 2);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	std::string body(5000, 'x');
+	HTTPRequest request("POST", "/echoBody");
+	request.setContentLength((int) body.length());
+	request.setContentType("text/plain");
+	cs.sendRequest(request) << body;
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assertTrue (response.getContentLength() == body.size());
+	assertTrue (response.getContentType() == "text/plain");
+	assertTrue (rbody == body);
+	assertTrue (!response.getKeepAlive());
+}
+
+
+void HTTPReactorServerTest::testChunkedRequestKeepAlive()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams, 2);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	cs.setKeepAlive(true);
+	std::string body(5000, 'x');
+	for (int i = 0; i < 5; ++i)
+	{
+		HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+		request.setContentType("text/plain");
+		request.setChunkedTransferEncoding(true);
+		cs.sendRequest(request) << body;
+		HTTPResponse response;
+		std::string rbody;
+		cs.receiveResponse(response) >> rbody;
+		assertTrue (response.getChunkedTransferEncoding());
+		assertTrue (response.getKeepAlive());
+		assertTrue (rbody == body);
+	}
+	assertTrue (srv.totalConnections() == 1);
+	assertTrue (srv.totalRequests() == 5);
+}
+
+
+void HTTPReactorServerTest::testMaxKeepAlive()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setMaxKeepAliveRequests(4);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams, 2);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("GET", "/echoHeader", HTTPMessage::HTTP_1_1);
+	for (int i = 0; i < 4; ++i)
+	{
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::ostringstream ostr;
+		StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+		assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+		assertTrue (response.getKeepAlive() == (i < 3));
+	}
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::ostringstream ostr;
+	StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (srv.totalConnections() == 2);
+}
+
+
+void HTTPReactorServerTest::testKeepAliveTimeout()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setKeepAliveTimeout(Poco::Timespan(1, 0));
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams, 1);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("GET", "/echoHeader", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::ostringstream ostr;
+	StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+	assertTrue (response.getKeepAlive());
+
+	Poco::Thread::sleep(500);
+	assertTrue (srv.currentConnections() == 1);
+	assertTrue (srv.idleConnections() == 1);
+
+	// the connection is closed by the reactor after the keep-alive timeout
+	int n = 0;
+	while (srv.currentConnections() > 0 && n++ < 50)
+	{
+		Poco::Thread::sleep(100);
+	}
+	assertTrue (srv.currentConnections() == 0);
+	assertTrue (srv.idleConnections() == 0);
+}
+
+
+void HTTPReactorServerTest::testNotImpl()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(false);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams, 1);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	HTTPRequest request("GET", "/notImpl");
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_NOT_IMPLEMENTED);
+	assertTrue (rbody.empty());
+}
+
+
+void HTTPReactorServerTest::testPipelining()
+{
+	ServerSocket svs(0);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, new HTTPServerParams, 1);
+	srv.start();
+
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", svs.address().port()));
+	SocketStream sstr(ss);
+
+	// the fourth request is sent in two parts, the second one
+	// while the connection is waiting in the reactor
+	std::string requests;
+	for (int i = 1; i <= 3; ++i)
+	{
+		requests += "GET /echoHeader HTTP/1.1\r\nHost: localhost\r\nX-Id: ";
+		requests += char('0' + i);
+		requests += "\r\n\r\n";
+	}
+	requests += "POST /echoBody HTTP/1.1\r\nHost: local";
+	ss.sendBytes(requests.data(), static_cast<int>(requests.size()));
+
+	for (int i = 1; i <= 3; ++i)
+	{
+		HTTPResponse response;
+		response.read(sstr);
+		assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+		assertTrue (response.getKeepAlive());
+		std::string body(static_cast<std::size_t>(response.getContentLength()), '\0');
+		sstr.read(&body[0], body.size());
+		std::string id("X-Id: ");
+		id += char('0' + i);
+		assertTrue (body.find(id) != std::string::npos);
+	}
+
+	std::string rest("host\r\nContent-Length: 5\r\n\r\nhello");
+	ss.sendBytes(rest.data(), static_cast<int>(rest.size()));
+	HTTPResponse response;
+	response.read(sstr);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	std::string body(static_cast<std::size_t>(response.getContentLength()), '\0');
+	sstr.read(&body[0], body.size());
+	assertTrue (body == "hello");
+}
+
+
+void HTTPReactorServerTest::testIdleConnections()
+{
+	const int connections = 200;
+
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setMaxThreads(2);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams, 2);
+	srv.start();
+
+	// far more persistent connections than worker threads
+	std::vector<HTTPClientSession*> sessions;
+	for (int i = 0; i < connections; ++i)
+	{
+		HTTPClientSession* pSession = new HTTPClientSession("127.0.0.1", svs.address().port());
+		pSession->setKeepAlive(true);
+		sessions.push_back(pSession);
+	}
+	for (int round = 0; round < 2; ++round)
+	{
+		for (std::vector<HTTPClientSession*>::iterator it = sessions.begin(); it != sessions.end(); ++it)
+		{
+			HTTPRequest request("GET", "/echoHeader", HTTPMessage::HTTP_1_1);
+			(*it)->sendRequest(request);
+			HTTPResponse response;
+			std::ostringstream ostr;
+			StreamCopier::copyStream((*it)->receiveResponse(response), ostr);
+			assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+			assertTrue (response.getKeepAlive());
+		}
+	}
+	assertTrue (srv.totalConnections() == connections);
+	assertTrue (srv.currentConnections() == connections);
+	assertTrue (srv.totalRequests() == 2*connections);
+
+	for (std::vector<HTTPClientSession*>::iterator it = sessions.begin(); it != sessions.end(); ++it)
+	{
+		delete *it;
+	}
+	srv.stop();
+	assertTrue (srv.currentConnections() == 0);
+}
+
+
+void HTTPReactorServerTest::setUp()
+{
+}
+
+
+void HTTPReactorServerTest::tearDown()
+{
+}
+
+
+CppUnit::Test* HTTPReactorServerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPReactorServerTest");
+
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testIdentityRequest);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testChunkedRequestKeepAlive);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testMaxKeepAlive);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testKeepAliveTimeout);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testNotImpl);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testPipelining);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testIdleConnections);
+
+	return pSuite;
+}
@@ -0,0 +1,278 @@
+//
+// HTTPRequestParserTest.cpp
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HTTPRequestParserTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/HTTPRequestParser.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/NetException.h"
+#include <sstream>
+
+
+using Poco::Net::HTTPRequestParser;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPMessage;
+using Poco::Net::MessageException;
+using Poco::Net::NoMessageException;
+
+
+HTTPRequestParserTest::HTTPRequestParserTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HTTPRequestParserTest::~HTTPRequestParserTest()
+{
+}
+
+
+void HTTPRequestParserTest::testParse()
+{
+	std::string s("GET /index.html?q=1 HTTP/1.1\r\nHost: localhost\r\nConnection:Keep-Alive  \r\nX-Empty:\r\n\r\nbody");
+	HTTPRequestParser parser;
+	assertTrue (parser.parse(s.data(), s.size()) == HTTPRequestParser::PARSE_COMPLETE);
+	assertTrue (parser.consumed() == s.size() - 4);
+	assertTrue (parser.remaining().toString() == "body");
+	assertTrue (parser.method().equals("GET"));
+	assertTrue (parser.uri().toString() == "/index.html?q=1");
+	assertTrue (parser.version().equals("HTTP/1.1"));
+	assertTrue (parser.fields() == 3);
+	assertTrue (parser.name(0).equals("Host"));
+	assertTrue (parser.value(0).equals("localhost"));
+	assertTrue (parser.name(1).equals("Connection"));
+	assertTrue (parser.value(1).equals("Keep-Alive"));
+	assertTrue (parser.value(2).empty());
+	assertTrue (parser.find("connection").equals("Keep-Alive"));
+	assertTrue (parser.has("x-empty"));
+	assertTrue (!parser.has("Content-Length"));
+	assertTrue (parser.find("Content-Length").empty());
+
+	// the slices refer to the buffer
+	assertTrue (parser.uri().data() == s.data() + 4);
+}
+
+
+void HTTPRequestParserTest::testApply()
+{
+	std::string s("POST /test.cgi HTTP/1.0\nContent-Length: 100\nContent-Type: text/plain\nSubject: =?ISO-8859-1?Q?Hello?=\n\n");
+	HTTPRequestParser parser;
+	assertTrue (parser.parse(s.data(), s.size()) == HTTPRequestParser::PARSE_COMPLETE);
+	assertTrue (parser.consumed() == s.size());
+
+	HTTPRequest request;
+	parser.apply(request);
+
+	std::istringstream istr(s);
+	HTTPRequest expected;
+	expected.read(istr);
+
+	assertTrue (request.getMethod() == HTTPRequest::HTTP_POST);
+	assertTrue (request.getURI() == expected.getURI());
+	assertTrue (request.getVersion() == HTTPMessage::HTTP_1_0);
+	assertTrue (request.size() == expected.size());
+	assertTrue (request.getContentLength() == 100);
+	assertTrue (request.getContentType() == "text/plain");
+	assertTrue (request["Subject"] == expected["Subject"]);
+	assertTrue (request["Subject"] == "Hello");
+}
+
+
+void HTTPRequestParserTest::testFolding()
+{
+	std::string s("GET / HTTP/1.1\r\nX-Folded: one\r\n two\r\n\tthree\r\nHost: localhost\r\n\r\n");
+	HTTPRequestParser parser;
+	assertTrue (parser.parse(s.data(), s.size()) == HTTPRequestParser::PARSE_COMPLETE);
+	assertTrue (parser.fields() == 2);
+	assertTrue (parser.value(0).equals("one\r\n two\r\n\tthree"));
+
+	HTTPRequest request;
+	parser.apply(request);
+
+	std::istringstream istr(s);
+	HTTPRequest expected;
+	expected.read(istr);
+	assertTrue (request["X-Folded"] == expected["X-Folded"]);
+	assertTrue (request["X-Folded"] == "one two\tthree");
+	assertTrue (request.getHost() == "localhost");
+}
+
+
+void HTTPRequestParserTest::testResume()
+{
+	std::string s("GET /index.html HTTP/1.1\r\nHost: localhost\r\nX-Folded: one\r\n two\r\nUser-Agent: Poco\r\n\r\nGET ");
+	HTTPRequestParser parser;
+	std::string::size_type n = 1;
+	for (; n < s.size(); ++n)
+	{
+		// every call gets a new buffer, to make sure the parser
+		// does not keep pointers into old buffers
+		std::string buffer(s, 0, n);
+		if (parser.parse(buffer.data(), buffer.size()) == HTTPRequestParser::PARSE_COMPLETE)
+		{
+			assertTrue (parser.method().equals("GET"));
+			assertTrue (parser.uri().equals("/index.html"));
+			assertTrue (parser.fields() == 3);
+			assertTrue (parser.find("User-Agent").equals("Poco"));
+			assertTrue (parser.find("X-Folded").equals("one\r\n two"));
+			break;
+		}
+		assertTrue (parser.status() == HTTPRequestParser::PARSE_INCOMPLETE);
+	}
+	assertTrue (n == s.size() - 4);
+	assertTrue (parser.consumed() == n);
+
+	parser.reset();
+	assertTrue (parser.status() == HTTPRequestParser::PARSE_INCOMPLETE);
+	assertTrue (parser.fields() == 0);
+}
+
+
+void HTTPRequestParserTest::testFeed()
+{
+	std::string s("GET /index.html HTTP/1.1\r\nHost: localhost\r\n\r\nbody");
+	HTTPRequestParser parser;
+	std::string::size_type pos = 0;
+	HTTPRequestParser::Status status = HTTPRequestParser::PARSE_INCOMPLETE;
+	while (status == HTTPRequestParser::PARSE_INCOMPLETE)
+	{
+		status = parser.feed(s.data() + pos, 3);
+		pos += 3;
+	}
+	assertTrue (parser.consumed() == s.size() - 4);
+	assertTrue (parser.find("Host").equals("localhost"));
+	assertTrue (parser.remaining().toString() == std::string(s, parser.consumed(), pos - parser.consumed()));
+}
+
+
+void HTTPRequestParserTest::testLeadingEmptyLines()
+{
+	std::string s("\r\n\r\nOPTIONS * HTTP/1.1\r\n\r\n");
+	HTTPRequestParser parser;
+	assertTrue (parser.parse(s.data(), s.size()) == HTTPRequestParser::PARSE_COMPLETE);
+	assertTrue (parser.method().equals("OPTIONS"));
+	assertTrue (parser.uri().equals("*"));
+	assertTrue (parser.fields() == 0);
+	assertTrue (parser.consumed() == s.size());
+}
+
+
+void HTTPRequestParserTest::testInvalid()
+{
+	HTTPRequestParser parser;
+	try
+	{
+		parser.parse("", 0);
+		fail("no data - must throw");
+	}
+	catch (NoMessageException&)
+	{
+	}
+
+	std::string s1("GET\r\n\r\n");
+	parser.reset();
+	try
+	{
+		parser.parse(s1.data(), s1.size());
+		fail("no URI - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+
+	std::string s2("GET / HTTP/1.1x\r\n\r\n");
+	parser.reset();
+	try
+	{
+		parser.parse(s2.data(), s2.size());
+		fail("invalid version - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+
+	std::string s3("GET /");
+	s3.append(20000, 'x');
+	parser.reset();
+	try
+	{
+		parser.parse(s3.data(), s3.size());
+		fail("URI too long - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+
+	std::string s4("GET / HTTP/1.1\r\nX-Long: ");
+	s4.append(10000, 'x');
+	s4.append("\r\n\r\n");
+	parser.reset();
+	try
+	{
+		parser.parse(s4.data(), s4.size());
+		fail("value too long - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+
+	// lines without a colon are ignored, like MessageHeader::read() does
+	std::string s5("GET / HTTP/1.1\r\nnocolon\r\nHost: localhost\r\n\r\n");
+	parser.reset();
+	assertTrue (parser.parse(s5.data(), s5.size()) == HTTPRequestParser::PARSE_COMPLETE);
+	assertTrue (parser.fields() == 1);
+}
+
+
+void HTTPRequestParserTest::testFieldLimit()
+{
+	std::string s("GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\nC: 3\r\n\r\n");
+	HTTPRequestParser parser;
+	parser.setFieldLimit(3);
+	assertTrue (parser.parse(s.data(), s.size()) == HTTPRequestParser::PARSE_COMPLETE);
+
+	parser.reset();
+	parser.setFieldLimit(2);
+	try
+	{
+		parser.parse(s.data(), s.size());
+		fail("too many fields - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+}
+
+
+void HTTPRequestParserTest::setUp()
+{
+}
+
+
+void HTTPRequestParserTest::tearDown()
+{
+}
+
+
+CppUnit::Test* HTTPRequestParserTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPRequestParserTest");
+
+	CppUnit_addTest(pSuite, HTTPRequestParserTest, testParse);
+	CppUnit_addTest(pSuite, HTTPRequestParserTest, testApply);
+	CppUnit_addTest(pSuite, HTTPRequestParserTest, testFolding);
+	CppUnit_addTest(pSuite, HTTPRequestParserTest, testResume);
+	CppUnit_addTest(pSuite, HTTPRequestParserTest, testFeed);
+	CppUnit_addTest(pSuite, HTTPRequestParserTest, testLeadingEmptyLines);
+	CppUnit_addTest(pSuite, HTTPRequestParserTest, testInvalid);
+	CppUnit_addTest(pSuite, HTTPRequestParserTest, testFieldLimit);
+
+	return pSuite;
+}
@@ -0,0 +1,45 @@
+//
+// HTTPRequestParserTest.h
+//
+// Definition of the HTTPRequestParserTest class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef HTTPRequestParserTest_INCLUDED
+#define HTTPRequestParserTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class HTTPRequestParserTest: public CppUnit::TestCase
+{
+public:
+	HTTPRequestParserTest(const std::string& name);
+	~HTTPRequestParserTest();
+
+	void testParse();
+	void testApply();
+	void testFolding();
+	void testResume();
+	void testFeed();
+	void testLeadingEmptyLines();
+	void testInvalid();
+	void testFieldLimit();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // HTTPRequestParserTest_INCLUDED
@@ -20,8 +20,13 @@
 #include "Poco/Net/HTTPServerRequest.h"
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/ServerMetrics.h"
 #include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketStream.h"
 #include "Poco/StreamCopier.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
 #include <sstream>
 
 
@@ -36,8 +41,15 @@ using Poco::Net::HTTPServerRequest;
 using Poco::Net::HTTPResponse;
 using Poco::Net::HTTPServerResponse;
 using Poco::Net::HTTPMessage;
+using Poco::Net::MetricsRegistry;
+using Poco::Net::ServerMetrics;
 using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketStream;
+using Poco::Net::SocketAddress;
 using Poco::StreamCopier;
+using Poco::TemporaryFile;
+using Poco::FileOutputStream;
 
 
 namespace
@@ -104,9 +116,51 @@ namespace
 		}
 	};
 	
+	class FileRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		FileRequestHandler(const std::string& path): _path(path)
+		{
+		}
+
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			response.sendFile(_path, "text/plain");
+		}
+
+	private:
+		std::string _path;
+	};
+	
+	class MetricsRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		MetricsRequestHandler(MetricsRegistry::Ptr pMetrics): _pMetrics(pMetrics)
+		{
+		}
+
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			response.setContentType(MetricsRegistry::CONTENT_TYPE);
+			response.setChunkedTransferEncoding(true);
+			_pMetrics->write(response.send());
+		}
+
+	private:
+		MetricsRegistry::Ptr _pMetrics;
+	};
+
 	class RequestHandlerFactory: public HTTPRequestHandlerFactory
 	{
 	public:
+		RequestHandlerFactory(const std::string& filePath = std::string()): _filePath(filePath)
+		{
+		}
+
+		RequestHandlerFactory(MetricsRegistry::Ptr pMetrics): _pMetrics(pMetrics)
+		{
+		}
+
 		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
 		{
 			if (request.getURI() == "/echoBody")
@@ -119,9 +173,17 @@ namespace
 				return new AuthRequestHandler();
 			else if (request.getURI() == "/buffer")
 				return new BufferRequestHandler();
+			else if (request.getURI() == "/file")
+				return new FileRequestHandler(_filePath);
+			else if (request.getURI() == "/metrics" && _pMetrics)
+				return new MetricsRequestHandler(_pMetrics);
 			else
 				return 0;
 		}
+
+	private:
+		std::string _filePath;
+		MetricsRegistry::Ptr _pMetrics;
 	};
 }
 
@@ -516,6 +578,249 @@ void HTTPServerTest::testBuffer()
 }
 
 
+void HTTPServerTest::testSendFile()
+{
+	TemporaryFile tf;
+	std::string data;
+	for (int i = 0; i < 10000; ++i) data += static_cast<char>('a' + i % 26);
+	{
+		FileOutputStream ostr(tf.path());
+		ostr << data;
+	}
+
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory(tf.path()), svs, pParams);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("GET", "/file", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::ostringstream ostr;
+	StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (response.getContentLength() == 10000);
+	assertTrue (response.get("Accept-Ranges") == "bytes");
+	assertTrue (ostr.str() == data);
+
+	request.set("Range", "bytes=100-199");
+	cs.sendRequest(request);
+	ostr.str("");
+	StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+	assertTrue (response.get("Content-Range") == "bytes 100-199/10000");
+	assertTrue (ostr.str() == data.substr(100, 100));
+
+	request.set("Range", "bytes=-10");
+	cs.sendRequest(request);
+	ostr.str("");
+	StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+	assertTrue (response.get("Content-Range") == "bytes 9990-9999/10000");
+	assertTrue (ostr.str() == data.substr(9990));
+
+	request.set("Range", "bytes=9000-20000");
+	cs.sendRequest(request);
+	ostr.str("");
+	StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+	assertTrue (response.get("Content-Range") == "bytes 9000-9999/10000");
+	assertTrue (ostr.str() == data.substr(9000));
+
+	request.set("Range", "bytes=20000-");
+	cs.sendRequest(request);
+	ostr.str("");
+	StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_REQUESTED_RANGE_NOT_SATISFIABLE);
+	assertTrue (response.get("Content-Range") == "bytes */10000");
+	assertTrue (ostr.str().empty());
+
+	// multiple ranges are not supported, the complete file is sent
+	request.set("Range", "bytes=0-9,20-29");
+	cs.sendRequest(request);
+	ostr.str("");
+	StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (ostr.str() == data);
+}
+
+
+void HTTPServerTest::testLargeHeader()
+{
+	HTTPServer srv(new RequestHandlerFactory, 0);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", srv.socket().address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+	// the request header does not fit into the session buffer
+	request.set("X-Large-1", std::string(3000, 'a'));
+	request.set("X-Large-2", std::string(3000, 'b'));
+	request.set("X-Folded", "one\r\n two");
+	std::string body(100, 'x');
+	request.setContentLength((int) body.length());
+	request.setContentType("text/plain");
+	cs.sendRequest(request) << body;
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (response.getKeepAlive());
+	assertTrue (rbody == body);
+
+	HTTPRequest request2("GET", "/echoHeader", HTTPMessage::HTTP_1_1);
+	request2.set("X-Large", std::string(6000, 'c'));
+	request2.set("X-Folded", "one\r\n two");
+	cs.sendRequest(request2);
+	std::ostringstream ostr;
+	StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+	rbody = ostr.str();
+	assertTrue (rbody.find("X-Large: " + std::string(6000, 'c') + "\r\n") != std::string::npos);
+	assertTrue (rbody.find("X-Folded: one two\r\n") != std::string::npos);
+
+	HTTPRequest request3("GET", "/echoHeader", HTTPMessage::HTTP_1_1);
+	request3.set("X-Too-Large", std::string(10000, 'd'));
+	cs.sendRequest(request3);
+	cs.receiveResponse(response);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_BAD_REQUEST);
+}
+
+
+void HTTPServerTest::testPipelining()
+{
+	HTTPServer srv(new RequestHandlerFactory, 0);
+	srv.start();
+
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", srv.socket().address().port()));
+	SocketStream sstr(ss);
+
+	// three complete requests and the beginning of a fourth one
+	std::string requests;
+	for (int i = 1; i <= 3; ++i)
+	{
+		requests += "GET /echoHeader HTTP/1.1\r\nHost: localhost\r\nX-Id: ";
+		requests += char('0' + i);
+		requests += "\r\n\r\n";
+	}
+	requests += "POST /echoBody HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n";
+	ss.sendBytes(requests.data(), static_cast<int>(requests.size()));
+
+	// the responses must be sent although the fourth request is incomplete
+	for (int i = 1; i <= 3; ++i)
+	{
+		HTTPResponse response;
+		response.read(sstr);
+		assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+		assertTrue (response.getKeepAlive());
+		std::string body(static_cast<std::size_t>(response.getContentLength()), '\0');
+		sstr.read(&body[0], body.size());
+		std::string id("X-Id: ");
+		id += char('0' + i);
+		assertTrue (body.find(id) != std::string::npos);
+	}
+
+	std::string rest("\r\nhello");
+	ss.sendBytes(rest.data(), static_cast<int>(rest.size()));
+	HTTPResponse response;
+	response.read(sstr);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	std::string body(static_cast<std::size_t>(response.getContentLength()), '\0');
+	sstr.read(&body[0], body.size());
+	assertTrue (body == "hello");
+}
+
+
+void HTTPServerTest::testBufferSize()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setBufferSize(65536);
+	assertTrue (pParams->getBufferSize() == 65536);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	cs.setKeepAlive(true);
+	cs.setBufferSize(16384);
+	assertTrue (cs.getBufferSize() == 16384);
+
+	std::string body(1000000, 'x');
+	HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+	request.setContentLength((int) body.length());
+	request.setContentType("text/plain");
+	cs.sendRequest(request) << body;
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assertTrue (response.getContentLength() == body.size());
+	assertTrue (response.getKeepAlive());
+	assertTrue (rbody == body);
+
+	body.assign(200000, 'y');
+	request.setContentLength(HTTPMessage::UNKNOWN_CONTENT_LENGTH);
+	request.setChunkedTransferEncoding(true);
+	request.setKeepAlive(false);
+	cs.sendRequest(request) << body;
+	cs.receiveResponse(response) >> rbody;
+	assertTrue (response.getChunkedTransferEncoding());
+	assertTrue (rbody == body);
+}
+
+
+void HTTPServerTest::testMetrics()
+{
+	ServerMetrics::Ptr pMetrics = new ServerMetrics("test");
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setMetrics(pMetrics);
+	HTTPServer srv(new RequestHandlerFactory(pMetrics), svs, pParams);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	cs.setKeepAlive(true);
+	std::string body(5000, 'x');
+	for (int i = 0; i < 2; ++i)
+	{
+		HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+		request.setContentLength((int) body.length());
+		request.setContentType("text/plain");
+		cs.sendRequest(request) << body;
+		HTTPResponse response;
+		std::string rbody;
+		cs.receiveResponse(response) >> rbody;
+		assertTrue (rbody == body);
+	}
+
+	// waiting for the next request on a kept-alive connection
+	// does not count as parse time
+	Poco::Thread::sleep(500);
+	HTTPRequest request("GET", "/metrics", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string text;
+	StreamCopier::copyToString(cs.receiveResponse(response), text);
+	assertTrue (response.getContentType() == MetricsRegistry::CONTENT_TYPE);
+
+	// the metrics of the two completed requests are included,
+	// the metrics request itself is counted, but still in progress
+	assertTrue (text.find("test_connections_total 1\n") != std::string::npos);
+	assertTrue (text.find("test_queue_time_microseconds_count 1\n") != std::string::npos);
+	assertTrue (text.find("test_requests_total 3\n") != std::string::npos);
+	assertTrue (text.find("test_keepalive_requests_total 2\n") != std::string::npos);
+	assertTrue (text.find("test_parse_time_microseconds_count 3\n") != std::string::npos);
+	assertTrue (pMetrics->parseTime().snapshot().sum() < 500000);
+	assertTrue (text.find("test_handler_time_microseconds_count 2\n") != std::string::npos);
+	assertTrue (text.find("test_write_time_microseconds_count 2\n") != std::string::npos);
+	assertTrue (pMetrics->bytesReceived().value() > 2*body.size());
+	assertTrue (pMetrics->bytesSent().value() > 2*body.size());
+}
+
+
 void HTTPServerTest::setUp()
 {
 }
@@ -544,6 +849,11 @@ CppUnit::Test* HTTPServerTest::suite()
 	CppUnit_addTest(pSuite, HTTPServerTest, testAuth);
 	CppUnit_addTest(pSuite, HTTPServerTest, testNotImpl);
 	CppUnit_addTest(pSuite, HTTPServerTest, testBuffer);
+	CppUnit_addTest(pSuite, HTTPServerTest, testSendFile);
+	CppUnit_addTest(pSuite, HTTPServerTest, testLargeHeader);
+	CppUnit_addTest(pSuite, HTTPServerTest, testPipelining);
+	CppUnit_addTest(pSuite, HTTPServerTest, testBufferSize);
+	CppUnit_addTest(pSuite, HTTPServerTest, testMetrics);
 
 	return pSuite;
 }
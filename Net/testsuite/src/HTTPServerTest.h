@@ -38,6 +38,11 @@ public:
 	void testAuth();
 	void testNotImpl();
 	void testBuffer();
+	void testSendFile();
+	void testLargeHeader();
+	void testPipelining();
+	void testBufferSize();
+	void testMetrics();
 
 	void setUp();
 	void tearDown();
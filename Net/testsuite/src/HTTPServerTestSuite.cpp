@@ -10,6 +10,8 @@
 
 #include "HTTPServerTestSuite.h"
 #include "HTTPServerTest.h"
+#include "HTTPReactorServerTest.h"
+#include "HTTP2ServerTest.h"
 
 
 CppUnit::Test* HTTPServerTestSuite::suite()
@@ -17,6 +19,8 @@ CppUnit::Test* HTTPServerTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPServerTestSuite");
 
 	pSuite->addTest(HTTPServerTest::suite());
+	pSuite->addTest(HTTPReactorServerTest::suite());
+	pSuite->addTest(HTTP2ServerTest::suite());
 
 	return pSuite;
 }
@@ -10,9 +10,11 @@
 
 #include "HTTPTestSuite.h"
 #include "HTTPRequestTest.h"
+#include "HTTPRequestParserTest.h"
 #include "HTTPResponseTest.h"
 #include "HTTPCookieTest.h"
 #include "HTTPCredentialsTest.h"
+#include "HPACKTest.h"
 
 
 CppUnit::Test* HTTPTestSuite::suite()
@@ -20,9 +22,11 @@ CppUnit::Test* HTTPTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPTestSuite");
 
 	pSuite->addTest(HTTPRequestTest::suite());
+	pSuite->addTest(HTTPRequestParserTest::suite());
 	pSuite->addTest(HTTPResponseTest::suite());
 	pSuite->addTest(HTTPCookieTest::suite());
 	pSuite->addTest(HTTPCredentialsTest::suite());
+	pSuite->addTest(HPACKTest::suite());
 
 	return pSuite;
 }
@@ -0,0 +1,273 @@
+//
+// IOUringTest.cpp
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "IOUringTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "EchoServer.h"
+#include "Poco/Net/IOUring.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/PollSet.h"
+#include "Poco/Clock.h"
+#include <iostream>
+
+
+using Poco::Net::IOUring;
+using Poco::Net::Socket;
+using Poco::Net::StreamSocket;
+using Poco::Net::ServerSocket;
+using Poco::Net::SocketAddress;
+using Poco::Net::PollSet;
+using Poco::Timespan;
+using Poco::Clock;
+
+
+namespace
+{
+	int waitFor(IOUring& ring, IOUring::Completion* pCompletions, int count)
+	{
+		int n = 0;
+		int attempts = 0;
+		while (n < count && attempts++ < 50)
+		{
+			ring.submitAndWait(1, Timespan(100000));
+			n += ring.completions(pCompletions + n, count - n);
+		}
+		return n;
+	}
+}
+
+
+IOUringTest::IOUringTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+IOUringTest::~IOUringTest()
+{
+}
+
+
+void IOUringTest::testSendReceive()
+{
+	if (skip()) return;
+
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+
+	IOUring ring;
+	char buffer[256];
+	ring.prepareSend(ss, "hello", 5, 1);
+	assertTrue (ring.pending() == 1);
+	ring.prepareReceive(ss, buffer, sizeof(buffer), 2);
+	assertTrue (ring.pending() == 2);
+
+	IOUring::Completion completions[2];
+	assertTrue (waitFor(ring, completions, 2) == 2);
+	assertTrue (ring.pending() == 0);
+	for (int i = 0; i < 2; i++)
+	{
+		if (completions[i].userData == 1)
+		{
+			assertTrue (completions[i].result == 5);
+		}
+		else
+		{
+			assertTrue (completions[i].userData == 2);
+			assertTrue (completions[i].result == 5);
+			assertTrue (std::string(buffer, 5) == "hello");
+		}
+	}
+	ss.close();
+}
+
+
+void IOUringTest::testAccept()
+{
+	if (skip()) return;
+
+	ServerSocket serv;
+	serv.bind(SocketAddress());
+	serv.listen();
+
+	IOUring ring;
+	ring.prepareAccept(serv, 42);
+	assertTrue (ring.submit() == 1);
+
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", serv.address().port()));
+
+	IOUring::Completion completion;
+	assertTrue (waitFor(ring, &completion, 1) == 1);
+	assertTrue (completion.userData == 42);
+	assertTrue (completion.result >= 0);
+	StreamSocket accepted = IOUring::acceptedSocket(completion);
+	assertTrue (accepted.peerAddress() == ss.address());
+
+	ss.sendBytes("hello", 5);
+	char buffer[256];
+	int n = accepted.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (n == 5);
+	assertTrue (std::string(buffer, n) == "hello");
+	ss.close();
+	accepted.close();
+}
+
+
+void IOUringTest::testFixedBuffers()
+{
+	if (skip()) return;
+
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+
+	char sendBuffer[64] = "hello, world";
+	char receiveBuffer[64];
+	IOUring::BufferVec buffers(2);
+	buffers[0].pData  = sendBuffer;
+	buffers[0].length = sizeof(sendBuffer);
+	buffers[1].pData  = receiveBuffer;
+	buffers[1].length = sizeof(receiveBuffer);
+
+	IOUring ring;
+	try
+	{
+		ring.registerBuffers(buffers);
+	}
+	catch (Poco::Exception&)
+	{
+		// registering buffers may fail due to RLIMIT_MEMLOCK
+		std::cout << "buffers could not be registered, skipping" << std::endl;
+		return;
+	}
+	ring.prepareSendFixed(ss, 0, 7, 5, 1);
+	IOUring::Completion completion;
+	assertTrue (waitFor(ring, &completion, 1) == 1);
+	assertTrue (completion.userData == 1);
+	assertTrue (completion.result == 5);
+
+	ring.prepareReceiveFixed(ss, 1, 10, 5, 2);
+	assertTrue (waitFor(ring, &completion, 1) == 1);
+	assertTrue (completion.userData == 2);
+	assertTrue (completion.result == 5);
+	assertTrue (std::string(receiveBuffer + 10, 5) == "world");
+
+	ring.unregisterBuffers();
+	ss.close();
+}
+
+
+void IOUringTest::testPoll()
+{
+	if (skip()) return;
+
+	EchoServer echoServer1;
+	EchoServer echoServer2;
+	StreamSocket ss1;
+	StreamSocket ss2;
+	ss1.connect(SocketAddress("127.0.0.1", echoServer1.port()));
+	ss2.connect(SocketAddress("127.0.0.1", echoServer2.port()));
+
+	int tag1 = 1;
+	int tag2 = 2;
+	PollSet ps(PollSet::PS_IO_URING);
+	assertTrue (ps.implementation() == PollSet::PS_IO_URING);
+	ps.add(ss1, PollSet::POLL_READ, &tag1);
+	ps.add(ss2, PollSet::POLL_READ, &tag2);
+	assertTrue (ps.has(ss1));
+	assertTrue (ps.has(ss2));
+
+	PollSet::Event events[4];
+	Timespan timeout(1000000);
+	assertTrue (ps.poll(Timespan(100000), events, 4) == 0);
+
+	ss2.sendBytes("HELLO", 5);
+	int n = ps.poll(timeout, events, 4);
+	assertTrue (n == 1);
+	assertTrue (events[0].pData == &tag2);
+	assertTrue (events[0].mode == PollSet::POLL_READ);
+
+	// level-triggered: still readable as long as data is pending
+	PollSet::SocketModeMap sm = ps.poll(timeout);
+	assertTrue (sm.find(ss2) != sm.end());
+	assertTrue (sm.find(ss2)->second == PollSet::POLL_READ);
+
+	char buffer[256];
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (n == 5);
+
+	ps.update(ss1, PollSet::POLL_READ | PollSet::POLL_WRITE);
+	n = ps.poll(timeout, events, 4);
+	assertTrue (n == 1);
+	assertTrue (events[0].pData == &tag1);
+	assertTrue (events[0].mode == PollSet::POLL_WRITE);
+	ps.update(ss1, PollSet::POLL_READ);
+
+	ps.remove(ss2);
+	assertTrue (!ps.has(ss2));
+
+	// completions of the remove operations must not end the wait
+	Clock clock;
+	assertTrue (ps.poll(Timespan(100000), events, 4) == 0);
+	assertTrue (clock.elapsed() >= 90000);
+
+	ss2.sendBytes("HELLO", 5);
+	ss1.sendBytes("hello", 5);
+	n = ps.poll(timeout, events, 4);
+	assertTrue (n == 1);
+	assertTrue (events[0].pData == &tag1);
+	n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (n == 5);
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (n == 5);
+
+	ps.clear();
+	assertTrue (ps.empty());
+	ss1.close();
+	ss2.close();
+}
+
+
+bool IOUringTest::skip()
+{
+	if (!IOUring::available())
+	{
+		std::cout << "io_uring not available, skipping" << std::endl;
+		return true;
+	}
+	return false;
+}
+
+
+void IOUringTest::setUp()
+{
+}
+
+
+void IOUringTest::tearDown()
+{
+}
+
+
+CppUnit::Test* IOUringTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("IOUringTest");
+
+	CppUnit_addTest(pSuite, IOUringTest, testSendReceive);
+	CppUnit_addTest(pSuite, IOUringTest, testAccept);
+	CppUnit_addTest(pSuite, IOUringTest, testFixedBuffers);
+	CppUnit_addTest(pSuite, IOUringTest, testPoll);
+
+	return pSuite;
+}
@@ -0,0 +1,42 @@
+//
+// IOUringTest.h
+//
+// Definition of the IOUringTest class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef IOUringTest_INCLUDED
+#define IOUringTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class IOUringTest: public CppUnit::TestCase
+{
+public:
+	IOUringTest(const std::string& name);
+	~IOUringTest();
+
+	void testSendReceive();
+	void testAccept();
+	void testFixedBuffers();
+	void testPoll();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+	bool skip();
+};
+
+
+#endif // IOUringTest_INCLUDED
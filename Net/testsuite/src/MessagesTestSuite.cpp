@@ -14,6 +14,7 @@
 #include "MediaTypeTest.h"
 #include "MultipartWriterTest.h"
 #include "MultipartReaderTest.h"
+#include "FilePartHandlerTest.h"
 #include "QuotedPrintableTest.h"
 
 
@@ -26,6 +27,7 @@ CppUnit::Test* MessagesTestSuite::suite()
 	pSuite->addTest(MediaTypeTest::suite());
 	pSuite->addTest(MultipartWriterTest::suite());
 	pSuite->addTest(MultipartReaderTest::suite());
+	pSuite->addTest(FilePartHandlerTest::suite());
 	pSuite->addTest(QuotedPrintableTest::suite());
 
 	return pSuite;
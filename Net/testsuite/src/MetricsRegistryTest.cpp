@@ -0,0 +1,338 @@
+//
+// MetricsRegistryTest.cpp
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "MetricsRegistryTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/MetricsRegistry.h"
+#include "Poco/Net/ServerMetrics.h"
+#include "Poco/Net/TCPServer.h"
+#include "Poco/Net/TCPServerConnection.h"
+#include "Poco/Net/TCPServerConnectionFactory.h"
+#include "Poco/Net/TCPServerParams.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/Exception.h"
+
+
+using Poco::Net::MetricsCounter;
+using Poco::Net::MetricsHistogram;
+using Poco::Net::MetricsRegistry;
+using Poco::Net::ServerMetrics;
+using Poco::Net::TCPServer;
+using Poco::Net::TCPServerConnection;
+using Poco::Net::TCPServerConnectionFactoryImpl;
+using Poco::Net::TCPServerParams;
+using Poco::Net::StreamSocket;
+using Poco::Net::ServerSocket;
+using Poco::Net::SocketAddress;
+using Poco::Thread;
+using Poco::UInt64;
+
+
+namespace
+{
+	class CounterRunnable: public Poco::Runnable
+	{
+	public:
+		CounterRunnable(MetricsCounter& counter, MetricsHistogram& histogram):
+			_counter(counter),
+			_histogram(histogram)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < 10000; i++)
+			{
+				_counter.add();
+				_histogram.record(i);
+			}
+		}
+
+	private:
+		MetricsCounter& _counter;
+		MetricsHistogram& _histogram;
+	};
+
+	class CloseConnection: public TCPServerConnection
+	{
+	public:
+		CloseConnection(const StreamSocket& s): TCPServerConnection(s)
+		{
+		}
+
+		void run()
+		{
+			char buffer[16];
+			socket().receiveBytes(buffer, sizeof(buffer));
+		}
+	};
+}
+
+
+MetricsRegistryTest::MetricsRegistryTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+MetricsRegistryTest::~MetricsRegistryTest()
+{
+}
+
+
+void MetricsRegistryTest::testCounter()
+{
+	MetricsCounter counter;
+	assertTrue (counter.value() == 0);
+	counter.add();
+	counter.add(41);
+	assertTrue (counter.value() == 42);
+	counter.reset();
+	assertTrue (counter.value() == 0);
+}
+
+
+void MetricsRegistryTest::testCounterThreads()
+{
+	MetricsCounter counter;
+	MetricsHistogram histogram;
+	CounterRunnable r(counter, histogram);
+	Thread t1;
+	Thread t2;
+	Thread t3;
+	Thread t4;
+	t1.start(r);
+	t2.start(r);
+	t3.start(r);
+	t4.start(r);
+	t1.join();
+	t2.join();
+	t3.join();
+	t4.join();
+
+	assertTrue (counter.value() == 40000);
+	MetricsHistogram::Snapshot snap = histogram.snapshot();
+	assertTrue (snap.count() == 40000);
+	assertTrue (snap.sum() == 4*(9999*10000/2));
+	assertTrue (snap.min() == 0);
+	assertTrue (snap.max() == 9999);
+}
+
+
+void MetricsRegistryTest::testBuckets()
+{
+	for (UInt64 v = 0; v < MetricsHistogram::SUB_BUCKETS; v++)
+	{
+		assertTrue (MetricsHistogram::bucketIndex(v) == static_cast<int>(v));
+		assertTrue (MetricsHistogram::bucketLimit(static_cast<int>(v)) == v);
+	}
+
+	// every value lies within its bucket, and the bucket is
+	// narrower than 1/SUB_BUCKETS of its lower bound
+	int lastIndex = 0;
+	for (UInt64 v = MetricsHistogram::SUB_BUCKETS; v < 100000; v += 7)
+	{
+		int index = MetricsHistogram::bucketIndex(v);
+		assertTrue (index >= lastIndex);
+		assertTrue (v <= MetricsHistogram::bucketLimit(index));
+		UInt64 lower = MetricsHistogram::bucketLimit(index - 1) + 1;
+		assertTrue (v >= lower);
+		assertTrue ((MetricsHistogram::bucketLimit(index) - lower + 1)*MetricsHistogram::SUB_BUCKETS <= lower);
+		lastIndex = index;
+	}
+
+	assertTrue (MetricsHistogram::bucketIndex(16) == 16);
+	assertTrue (MetricsHistogram::bucketIndex(31) == 31);
+	assertTrue (MetricsHistogram::bucketIndex(32) == 32);
+	assertTrue (MetricsHistogram::bucketIndex(33) == 32);
+	assertTrue (MetricsHistogram::bucketLimit(32) == 33);
+
+	const UInt64 maxValue = (UInt64(1) << MetricsHistogram::MAX_VALUE_BITS) - 1;
+	assertTrue (MetricsHistogram::bucketIndex(maxValue) == MetricsHistogram::BUCKETS - 1);
+	assertTrue (MetricsHistogram::bucketIndex(maxValue + 1) == MetricsHistogram::BUCKETS - 1);
+	assertTrue (MetricsHistogram::bucketIndex(~UInt64(0)) == MetricsHistogram::BUCKETS - 1);
+	assertTrue (MetricsHistogram::bucketLimit(MetricsHistogram::BUCKETS - 1) == maxValue);
+}
+
+
+void MetricsRegistryTest::testHistogram()
+{
+	MetricsHistogram histogram;
+	MetricsHistogram::Snapshot snap = histogram.snapshot();
+	assertTrue (snap.count() == 0);
+	assertTrue (snap.min() == 0);
+	assertTrue (snap.max() == 0);
+	assertTrue (snap.mean() == 0);
+	assertTrue (snap.percentile(50) == 0);
+
+	for (UInt64 v = 1; v <= 1000; v++)
+	{
+		histogram.record(v);
+	}
+	snap = histogram.snapshot();
+	assertTrue (snap.count() == 1000);
+	assertTrue (snap.sum() == 500500);
+	assertTrue (snap.min() == 1);
+	assertTrue (snap.max() == 1000);
+	assertEqualDelta (500.5, snap.mean(), 0.001);
+
+	UInt64 p50 = snap.percentile(50);
+	assertTrue (p50 >= 500 && p50 <= 500 + 500/MetricsHistogram::SUB_BUCKETS);
+	UInt64 p90 = snap.percentile(90);
+	assertTrue (p90 >= 900 && p90 <= 900 + 900/MetricsHistogram::SUB_BUCKETS);
+	UInt64 p99 = snap.percentile(99);
+	assertTrue (p99 >= 990 && p99 <= 1000);
+	assertTrue (snap.percentile(100) == 1000);
+	assertTrue (snap.percentile(0) <= 1);
+
+	histogram.reset();
+	snap = histogram.snapshot();
+	assertTrue (snap.count() == 0);
+	assertTrue (snap.max() == 0);
+}
+
+
+void MetricsRegistryTest::testRegistry()
+{
+	MetricsRegistry::Ptr pRegistry = new MetricsRegistry;
+	MetricsCounter& c1 = pRegistry->counter("requests_total", "Requests.");
+	MetricsCounter& c2 = pRegistry->counter("requests_total");
+	assertTrue (&c1 == &c2);
+	MetricsHistogram& h1 = pRegistry->histogram("latency_microseconds");
+	MetricsHistogram& h2 = pRegistry->histogram("latency_microseconds");
+	assertTrue (&h1 == &h2);
+
+	try
+	{
+		pRegistry->histogram("requests_total");
+		fail("counter registered - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	try
+	{
+		pRegistry->counter("latency_microseconds");
+		fail("histogram registered - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	try
+	{
+		pRegistry->counter("9lives");
+		fail("invalid name - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	try
+	{
+		pRegistry->counter("with space");
+		fail("invalid name - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	c1.add(5);
+	h1.record(10);
+	pRegistry->reset();
+	assertTrue (c1.value() == 0);
+	assertTrue (h1.snapshot().count() == 0);
+}
+
+
+void MetricsRegistryTest::testWrite()
+{
+	MetricsRegistry::Ptr pRegistry = new MetricsRegistry;
+	pRegistry->counter("app_requests_total", "Number of requests.\nPer server.").add(3);
+	MetricsHistogram& histogram = pRegistry->histogram("app_latency_microseconds");
+	histogram.record(10);
+	histogram.record(20);
+
+	std::string expected =
+		"# HELP app_requests_total Number of requests.\\nPer server.\n"
+		"# TYPE app_requests_total counter\n"
+		"app_requests_total 3\n"
+		"# TYPE app_latency_microseconds summary\n"
+		"app_latency_microseconds{quantile=\"0.5\"} 10\n"
+		"app_latency_microseconds{quantile=\"0.9\"} 20\n"
+		"app_latency_microseconds{quantile=\"0.99\"} 20\n"
+		"app_latency_microseconds{quantile=\"0.999\"} 20\n"
+		"app_latency_microseconds_sum 30\n"
+		"app_latency_microseconds_count 2\n";
+	assertEqual (expected, pRegistry->toString());
+}
+
+
+void MetricsRegistryTest::testServerMetrics()
+{
+	ServerMetrics::Ptr pMetrics = new ServerMetrics("test");
+	TCPServerParams::Ptr pParams = new TCPServerParams;
+	pParams->setMetrics(pMetrics);
+	assertTrue (pParams->getMetrics() == pMetrics);
+
+	ServerSocket svs(0);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<CloseConnection>(), svs, pParams);
+	srv.start();
+
+	for (int i = 0; i < 3; i++)
+	{
+		StreamSocket ss;
+		ss.connect(SocketAddress("127.0.0.1", srv.port()));
+		ss.sendBytes("x", 1);
+		ss.close();
+	}
+	for (int i = 0; i < 100 && pMetrics->connections().value() < 3; i++)
+	{
+		Thread::sleep(20);
+	}
+	assertTrue (pMetrics->connections().value() == 3);
+	assertTrue (pMetrics->queueTime().snapshot().count() == 3);
+	assertTrue (pMetrics->requests().value() == 0);
+
+	std::string text = pMetrics->toString();
+	assertTrue (text.find("# TYPE test_connections_total counter\ntest_connections_total 3\n") != std::string::npos);
+	assertTrue (text.find("test_queue_time_microseconds_count 3\n") != std::string::npos);
+	assertTrue (text.find("# TYPE test_write_time_microseconds summary\n") != std::string::npos);
+}
+
+
+void MetricsRegistryTest::setUp()
+{
+}
+
+
+void MetricsRegistryTest::tearDown()
+{
+}
+
+
+CppUnit::Test* MetricsRegistryTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("MetricsRegistryTest");
+
+	CppUnit_addTest(pSuite, MetricsRegistryTest, testCounter);
+	CppUnit_addTest(pSuite, MetricsRegistryTest, testCounterThreads);
+	CppUnit_addTest(pSuite, MetricsRegistryTest, testBuckets);
+	CppUnit_addTest(pSuite, MetricsRegistryTest, testHistogram);
+	CppUnit_addTest(pSuite, MetricsRegistryTest, testRegistry);
+	CppUnit_addTest(pSuite, MetricsRegistryTest, testWrite);
+	CppUnit_addTest(pSuite, MetricsRegistryTest, testServerMetrics);
+
+	return pSuite;
+}
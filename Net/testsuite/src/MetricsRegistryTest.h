@@ -0,0 +1,44 @@
+//
+// MetricsRegistryTest.h
+//
+// Definition of the MetricsRegistryTest class.
+//
+// Copyright (c) 2018, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef MetricsRegistryTest_INCLUDED
+#define MetricsRegistryTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class MetricsRegistryTest: public CppUnit::TestCase
+{
+public:
+	MetricsRegistryTest(const std::string& name);
+	~MetricsRegistryTest();
+
+	void testCounter();
+	void testCounterThreads();
+	void testBuckets();
+	void testHistogram();
+	void testRegistry();
+	void testWrite();
+	void testServerMetrics();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // MetricsRegistryTest_INCLUDED
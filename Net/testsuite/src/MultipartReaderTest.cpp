@@ -350,6 +350,94 @@ void MultipartReaderTest::testUnixLineEnds()
 }
 
 
+void MultipartReaderTest::testNearMissBoundary()
+{
+	std::string s("\r\n--MIME_boundary_01234567\r\n\r\n"
+		"--MIME_boundary_01234567\r\n"
+		"\r\n--MIME_boundary_0123456\r\n"
+		"\r\n--MIME_boundary_01234567X\r\n"
+		"\r\n--MIME_boundary_01234567-\r\n"
+		"\r\n--MIME_boundary_01234567\r"
+		"\r\n--MIME_boundary_01234567--\r\n");
+	std::istringstream istr(s);
+	MultipartReader r(istr, "MIME_boundary_01234567");
+	MessageHeader h;
+	r.nextPart(h);
+	std::istream& i = r.stream();
+	std::string part;
+	int ch = i.get();
+	while (ch >= 0)
+	{
+		part += (char) ch;
+		ch = i.get();
+	}
+	assertTrue (part == "--MIME_boundary_01234567\r\n"
+		"\r\n--MIME_boundary_0123456\r\n"
+		"\r\n--MIME_boundary_01234567X\r\n"
+		"\r\n--MIME_boundary_01234567-\r\n"
+		"\r\n--MIME_boundary_01234567\r");
+	assertTrue (!r.hasNextPart());
+}
+
+
+void MultipartReaderTest::testBoundaryAcrossBuffers()
+{
+	// Place the boundary following the first part at all
+	// positions around the end of the read-ahead buffer.
+	const std::string head("\r\n--MIME_boundary_01234567\r\nname1: value1\r\n\r\n");
+	const int bufferSize = Poco::Net::MultipartSourceBuf::BUFFER_SIZE;
+	for (int offset = -40; offset <= 4; offset++)
+	{
+		std::string part1(bufferSize - head.size() + offset, 'X');
+		if (!part1.empty()) part1[part1.size() - 1] = '\r';
+		std::string s(head);
+		s.append(part1);
+		s.append("\r\n--MIME_boundary_01234567\r\n\r\nthis is part 2\r\n--MIME_boundary_01234567--\r\n");
+		std::istringstream istr(s);
+		MultipartReader r(istr, "MIME_boundary_01234567");
+		MessageHeader h;
+		r.nextPart(h);
+		assertTrue (h["name1"] == "value1");
+		std::ostringstream ostr;
+		ostr << r.stream().rdbuf();
+		assertTrue (ostr.str() == part1);
+		assertTrue (r.hasNextPart());
+		r.nextPart(h);
+		std::string part2;
+		std::getline(r.stream(), part2, '\0');
+		assertTrue (part2 == "this is part 2");
+		assertTrue (!r.hasNextPart());
+	}
+}
+
+
+void MultipartReaderTest::testReadLargePart()
+{
+	std::string longPart;
+	for (int i = 0; longPart.size() < 1000000; i++)
+	{
+		longPart += static_cast<char>(i % 251);
+		if (i % 1000 == 0) longPart.append("\r\n--MIME_boundary_0123456\r\n");
+	}
+	std::string s("--MIME_boundary_01234567\r\n\r\n");
+	s.append(longPart);
+	s.append("\r\n--MIME_boundary_01234567--\r\n");
+	std::istringstream istr(s);
+	MultipartReader r(istr);
+	MessageHeader h;
+	r.nextPart(h);
+	assertTrue (r.boundary() == "MIME_boundary_01234567");
+	std::string part;
+	char buffer[100000];
+	while (r.stream().read(buffer, sizeof(buffer)) || r.stream().gcount() > 0)
+	{
+		part.append(buffer, static_cast<std::size_t>(r.stream().gcount()));
+	}
+	assertTrue (part == longPart);
+	assertTrue (!r.hasNextPart());
+}
+
+
 void MultipartReaderTest::setUp()
 {
 }
@@ -373,6 +461,9 @@ CppUnit::Test* MultipartReaderTest::suite()
 	CppUnit_addTest(pSuite, MultipartReaderTest, testBadBoundary);
 	CppUnit_addTest(pSuite, MultipartReaderTest, testRobustness);
 	CppUnit_addTest(pSuite, MultipartReaderTest, testUnixLineEnds);
+	CppUnit_addTest(pSuite, MultipartReaderTest, testNearMissBoundary);
+	CppUnit_addTest(pSuite, MultipartReaderTest, testBoundaryAcrossBuffers);
+	CppUnit_addTest(pSuite, MultipartReaderTest, testReadLargePart);
 
 	return pSuite;
 }
@@ -33,6 +33,9 @@ public:
 	void testBadBoundary();
 	void testRobustness();
 	void testUnixLineEnds();
+	void testNearMissBoundary();
+	void testBoundaryAcrossBuffers();
+	void testReadLargePart();
 
 	void setUp();
 	void tearDown();
@@ -125,6 +125,149 @@ void PollSetTest::testPoll()
 }
 
 
+void PollSetTest::testPollEvents()
+{
+	EchoServer echoServer1;
+	EchoServer echoServer2;
+	StreamSocket ss1;
+	StreamSocket ss2;
+
+	ss1.connect(SocketAddress("127.0.0.1", echoServer1.port()));
+	ss2.connect(SocketAddress("127.0.0.1", echoServer2.port()));
+
+	int tag1 = 1;
+	int tag2 = 2;
+	PollSet ps;
+	ps.add(ss1, PollSet::POLL_READ, &tag1);
+	ps.add(ss2, PollSet::POLL_READ, &tag2);
+	assertTrue(ps.has(ss1));
+	assertTrue(ps.has(ss2));
+
+	PollSet::Event events[4];
+	Timespan timeout(1000000);
+	Stopwatch sw;
+	sw.start();
+	assertTrue (ps.poll(timeout, events, 4) == 0);
+	assertTrue (sw.elapsed() >= 900000);
+
+	// user data must be retained by update()
+	ps.update(ss1, PollSet::POLL_READ | PollSet::POLL_WRITE);
+	int n = ps.poll(timeout, events, 4);
+	assertTrue (n == 1);
+	assertTrue (events[0].pData == &tag1);
+	assertTrue (events[0].mode == PollSet::POLL_WRITE);
+	ps.update(ss1, PollSet::POLL_READ);
+
+	ss2.sendBytes("HELLO", 5);
+	n = ps.poll(timeout, events, 4);
+	assertTrue (n == 1);
+	assertTrue (events[0].pData == &tag2);
+	assertTrue (events[0].mode == PollSet::POLL_READ);
+
+	// the map-based interface must still work for sockets with user data
+	PollSet::SocketModeMap sm = ps.poll(timeout);
+	assertTrue (sm.find(ss2) != sm.end());
+	assertTrue (sm.find(ss2)->second == PollSet::POLL_READ);
+
+	char buffer[256];
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (n == 5);
+
+	ps.remove(ss2);
+	assertTrue(!ps.has(ss2));
+	ss1.sendBytes("hello", 5);
+	n = ps.poll(timeout, events, 4);
+	assertTrue (n == 1);
+	assertTrue (events[0].pData == &tag1);
+	n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (n == 5);
+
+	ss1.close();
+	ss2.close();
+}
+
+
+void PollSetTest::testPollOneShot()
+{
+#if defined(POCO_HAVE_FD_EPOLL)
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+
+	int tag = 0;
+	PollSet ps;
+	ps.add(ss, PollSet::POLL_READ | PollSet::POLL_ONESHOT, &tag);
+
+	ss.sendBytes("hello", 5);
+	PollSet::Event events[1];
+	Timespan timeout(1000000);
+	int n = ps.poll(timeout, events, 1);
+	assertTrue (n == 1);
+	assertTrue (events[0].pData == &tag);
+
+	// data is still pending, but the socket is disabled until re-armed
+	n = ps.poll(Timespan(100000), events, 1);
+	assertTrue (n == 0);
+
+	ps.update(ss, PollSet::POLL_READ | PollSet::POLL_ONESHOT);
+	n = ps.poll(timeout, events, 1);
+	assertTrue (n == 1);
+	assertTrue (events[0].pData == &tag);
+
+	char buffer[256];
+	n = ss.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (n == 5);
+	ss.close();
+#endif
+}
+
+
+void PollSetTest::testWakeUp()
+{
+#if defined(POCO_HAVE_FD_EPOLL)
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+
+	PollSet::Implementation impls[] = { PollSet::PS_DEFAULT, PollSet::PS_IO_URING };
+	for (int i = 0; i < 2; i++)
+	{
+		PollSet ps(impls[i]);
+		ps.add(ss, PollSet::POLL_READ);
+
+		// a wake up before poll() makes the next poll() return immediately
+		ps.wakeUp();
+		ps.wakeUp();
+		PollSet::Event events[1];
+		Stopwatch sw;
+		sw.start();
+		int n = ps.poll(Timespan(5, 0), events, 1);
+		sw.stop();
+		assertTrue (n == 0);
+		assertTrue (sw.elapsed() < 1000000);
+
+		// the wake up has been consumed
+		n = ps.poll(Timespan(100000), events, 1);
+		assertTrue (n == 0);
+
+		ps.wakeUp();
+		PollSet::SocketModeMap sm = ps.poll(Timespan(5, 0));
+		assertTrue (sm.empty());
+
+		// sockets are still reported
+		ss.sendBytes("hello", 5);
+		ps.wakeUp();
+		n = 0;
+		while (n == 0) n = ps.poll(Timespan(1, 0), events, 1);
+		assertTrue (n == 1);
+		char buffer[256];
+		assertTrue (ss.receiveBytes(buffer, sizeof(buffer)) == 5);
+	}
+	ss.close();
+#endif
+}
+
+
 void PollSetTest::setUp()
 {
 }
@@ -140,6 +283,9 @@ CppUnit::Test* PollSetTest::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("PollSetTest");
 
 	CppUnit_addTest(pSuite, PollSetTest, testPoll);
+	CppUnit_addTest(pSuite, PollSetTest, testPollEvents);
+	CppUnit_addTest(pSuite, PollSetTest, testPollOneShot);
+	CppUnit_addTest(pSuite, PollSetTest, testWakeUp);
 
 	return pSuite;
 }
@@ -25,6 +25,9 @@ public:
 	~PollSetTest();
 
 	void testPoll();
+	void testPollEvents();
+	void testPollOneShot();
+	void testWakeUp();
 
 	void setUp();
 	void tearDown();
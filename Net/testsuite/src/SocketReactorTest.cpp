@@ -19,10 +19,15 @@
 #include "Poco/Net/StreamSocket.h"
 #include "Poco/Net/ServerSocket.h"
 #include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/DNSCache.h"
+#include "Poco/Net/StubResolver.h"
 #include "Poco/Observer.h"
 #include "Poco/Exception.h"
 #include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Clock.h"
 #include <sstream>
+#include <atomic>
 
 
 using Poco::Net::SocketReactor;
@@ -32,11 +37,17 @@ using Poco::Net::ParallelSocketAcceptor;
 using Poco::Net::StreamSocket;
 using Poco::Net::ServerSocket;
 using Poco::Net::SocketAddress;
+using Poco::Net::DNSCache;
+using Poco::Net::HostResolver;
+using Poco::Net::StubResolver;
+using Poco::Net::IPAddress;
 using Poco::Net::SocketNotification;
 using Poco::Net::ReadableNotification;
 using Poco::Net::WritableNotification;
+using Poco::Net::ErrorNotification;
 using Poco::Net::TimeoutNotification;
 using Poco::Net::ShutdownNotification;
+using Poco::Net::DeadlineNotification;
 using Poco::Observer;
 using Poco::IllegalStateException;
 using Poco::Thread;
@@ -300,6 +311,35 @@ namespace
 		bool _shutdown;
 	};
 
+	class ResolveFailConnector: public SocketConnector<ClientServiceHandler>
+	{
+	public:
+		ResolveFailConnector(const std::string& hostname, Poco::UInt16 port, SocketReactor& reactor):
+			SocketConnector<ClientServiceHandler>(hostname, port, reactor, false)
+		{
+			resolve();
+		}
+
+		~ResolveFailConnector()
+		{
+			cancel();
+		}
+
+		void onResolveError(const Poco::Exception& exc)
+		{
+			_failed.set();
+		}
+
+		bool failed(long milliseconds)
+		{
+			return _failed.tryWait(milliseconds);
+		}
+
+	private:
+		Poco::Event _failed;
+	};
+
+
 	class DataServiceHandler
 	{
 	public:
@@ -364,6 +404,193 @@ namespace
 	};
 
 	DataServiceHandler::Data DataServiceHandler::_data;
+
+	class DrainingEchoServiceHandler
+		/// Echo handler for edge-triggered reactors, which must
+		/// consume all available data on each notification.
+	{
+	public:
+		DrainingEchoServiceHandler(const StreamSocket& socket, SocketReactor& reactor):
+			_socket(socket),
+			_reactor(reactor)
+		{
+			_socket.setBlocking(false);
+			_reactor.addEventHandler(_socket, Observer<DrainingEchoServiceHandler, ReadableNotification>(*this, &DrainingEchoServiceHandler::onReadable));
+			_reactor.addEventHandler(_socket, Observer<DrainingEchoServiceHandler, ShutdownNotification>(*this, &DrainingEchoServiceHandler::onShutdown));
+		}
+
+		~DrainingEchoServiceHandler()
+		{
+			_reactor.removeEventHandler(_socket, Observer<DrainingEchoServiceHandler, ReadableNotification>(*this, &DrainingEchoServiceHandler::onReadable));
+			_reactor.removeEventHandler(_socket, Observer<DrainingEchoServiceHandler, ShutdownNotification>(*this, &DrainingEchoServiceHandler::onShutdown));
+		}
+
+		void onReadable(ReadableNotification* pNf)
+		{
+			pNf->release();
+			char buffer[8];
+			int n;
+			while ((n = _socket.receiveBytes(buffer, sizeof(buffer))) > 0)
+			{
+				_socket.setBlocking(true);
+				_socket.sendBytes(buffer, n);
+				_socket.setBlocking(false);
+			}
+			if (n == 0)
+			{
+				_socket.shutdownSend();
+				delete this;
+			}
+		}
+
+		void onShutdown(ShutdownNotification* pNf)
+		{
+			pNf->release();
+			delete this;
+		}
+
+	private:
+		StreamSocket   _socket;
+		SocketReactor& _reactor;
+	};
+
+	class IdleTimeoutServiceHandler
+		/// Echo handler that closes the connection if no data
+		/// has been received for IDLE_TIMEOUT milliseconds.
+	{
+	public:
+		enum
+		{
+			IDLE_TIMEOUT = 200
+		};
+
+		IdleTimeoutServiceHandler(const StreamSocket& socket, SocketReactor& reactor):
+			_socket(socket),
+			_reactor(reactor)
+		{
+			_reactor.addEventHandler(_socket, Observer<IdleTimeoutServiceHandler, ReadableNotification>(*this, &IdleTimeoutServiceHandler::onReadable));
+			_reactor.addEventHandler(_socket, Observer<IdleTimeoutServiceHandler, DeadlineNotification>(*this, &IdleTimeoutServiceHandler::onDeadline));
+			_reactor.addEventHandler(_socket, Observer<IdleTimeoutServiceHandler, ShutdownNotification>(*this, &IdleTimeoutServiceHandler::onShutdown));
+			_reactor.scheduleDeadline(_socket, Poco::Timespan(IDLE_TIMEOUT*1000));
+		}
+
+		~IdleTimeoutServiceHandler()
+		{
+			_reactor.removeEventHandler(_socket, Observer<IdleTimeoutServiceHandler, ReadableNotification>(*this, &IdleTimeoutServiceHandler::onReadable));
+			_reactor.removeEventHandler(_socket, Observer<IdleTimeoutServiceHandler, DeadlineNotification>(*this, &IdleTimeoutServiceHandler::onDeadline));
+			_reactor.removeEventHandler(_socket, Observer<IdleTimeoutServiceHandler, ShutdownNotification>(*this, &IdleTimeoutServiceHandler::onShutdown));
+		}
+
+		void onReadable(ReadableNotification* pNf)
+		{
+			pNf->release();
+			char buffer[8];
+			int n = _socket.receiveBytes(buffer, sizeof(buffer));
+			if (n > 0)
+			{
+				_socket.sendBytes(buffer, n);
+				_reactor.scheduleDeadline(_socket, Poco::Timespan(IDLE_TIMEOUT*1000));
+			}
+			else delete this;
+		}
+
+		void onDeadline(DeadlineNotification* pNf)
+		{
+			pNf->release();
+			++_deadlines;
+			_socket.shutdownSend();
+			delete this;
+		}
+
+		void onShutdown(ShutdownNotification* pNf)
+		{
+			pNf->release();
+			delete this;
+		}
+
+		static int deadlines()
+		{
+			return _deadlines;
+		}
+
+		static void resetDeadlines()
+		{
+			_deadlines = 0;
+		}
+
+	private:
+		StreamSocket            _socket;
+		SocketReactor&          _reactor;
+		static std::atomic<int> _deadlines;
+	};
+
+	std::atomic<int> IdleTimeoutServiceHandler::_deadlines(0);
+
+	class PeriodicDeadlineHandler
+		/// Reschedules the deadline of a socket whenever it expires
+		/// and counts the DeadlineNotifications and TimeoutNotifications
+		/// it receives. Observing ErrorNotification puts the socket
+		/// into the reactor's PollSet.
+	{
+	public:
+		enum
+		{
+			INTERVAL = 50
+		};
+
+		PeriodicDeadlineHandler(const StreamSocket& socket, SocketReactor& reactor):
+			_socket(socket),
+			_reactor(reactor),
+			_deadlines(0),
+			_timeouts(0)
+		{
+			_reactor.addEventHandler(_socket, Observer<PeriodicDeadlineHandler, DeadlineNotification>(*this, &PeriodicDeadlineHandler::onDeadline));
+			_reactor.addEventHandler(_socket, Observer<PeriodicDeadlineHandler, TimeoutNotification>(*this, &PeriodicDeadlineHandler::onTimeout));
+			_reactor.addEventHandler(_socket, Observer<PeriodicDeadlineHandler, ErrorNotification>(*this, &PeriodicDeadlineHandler::onError));
+			_reactor.scheduleDeadline(_socket, Poco::Timespan(INTERVAL*1000));
+		}
+
+		~PeriodicDeadlineHandler()
+		{
+			_reactor.removeEventHandler(_socket, Observer<PeriodicDeadlineHandler, DeadlineNotification>(*this, &PeriodicDeadlineHandler::onDeadline));
+			_reactor.removeEventHandler(_socket, Observer<PeriodicDeadlineHandler, TimeoutNotification>(*this, &PeriodicDeadlineHandler::onTimeout));
+			_reactor.removeEventHandler(_socket, Observer<PeriodicDeadlineHandler, ErrorNotification>(*this, &PeriodicDeadlineHandler::onError));
+		}
+
+		void onDeadline(DeadlineNotification* pNf)
+		{
+			pNf->release();
+			++_deadlines;
+			_reactor.scheduleDeadline(_socket, Poco::Timespan(INTERVAL*1000));
+		}
+
+		void onTimeout(TimeoutNotification* pNf)
+		{
+			pNf->release();
+			++_timeouts;
+		}
+
+		void onError(ErrorNotification* pNf)
+		{
+			pNf->release();
+		}
+
+		int deadlines() const
+		{
+			return _deadlines;
+		}
+
+		int timeouts() const
+		{
+			return _timeouts;
+		}
+
+	private:
+		StreamSocket   _socket;
+		SocketReactor& _reactor;
+		int            _deadlines;
+		int            _timeouts;
+	};
 }
 
 
@@ -471,6 +698,32 @@ void SocketReactorTest::testSocketConnectorTimeout()
 }
 
 
+void SocketReactorTest::testSocketConnectorHostName()
+{
+	StubResolver::Ptr pStub = new StubResolver;
+	pStub->addHost("echo.test", IPAddress("127.0.0.1"));
+	DNSCache::defaultCache().setResolver(pStub);
+
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor;
+	reactor.setTimeout(Poco::Timespan(0, 100000));
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	SocketConnector<ClientServiceHandler> connector("echo.test", ss.address().port(), reactor);
+	ClientServiceHandler::setOnce(true);
+	ClientServiceHandler::resetData();
+	reactor.run();
+	std::string data(ClientServiceHandler::data());
+	assertTrue (data.size() == 1024);
+	assertTrue (pStub->lookups() == 1);
+
+	ResolveFailConnector failConnector("unknown.test", 80, reactor);
+	assertTrue (failConnector.failed(5000));
+
+	DNSCache::defaultCache().setResolver(new HostResolver);
+}
+
+
 void SocketReactorTest::testDataCollection()
 {
 	SocketAddress ssa;
@@ -560,6 +813,259 @@ void SocketReactorTest::testDataCollection()
 }
 
 
+void SocketReactorTest::testSocketReactorFastDispatch()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor(Poco::Timespan(250000), SocketReactor::OPT_FAST_DISPATCH);
+	assertTrue (reactor.getOptions() == SocketReactor::OPT_FAST_DISPATCH);
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	SocketAddress sa("127.0.0.1", ss.address().port());
+	SocketConnector<ClientServiceHandler> connector1(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector2(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector3(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector4(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector5(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector6(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector7(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector8(sa, reactor);
+	ClientServiceHandler::setOnce(false);
+	ClientServiceHandler::resetData();
+	reactor.run();
+	std::string data(ClientServiceHandler::data());
+	assertTrue (data.size() == 8192);
+	assertTrue (!ClientServiceHandler::readableError());
+	assertTrue (!ClientServiceHandler::writableError());
+	assertTrue (!ClientServiceHandler::timeoutError());
+}
+
+
+void SocketReactorTest::testSocketReactorOneShot()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor(Poco::Timespan(250000), SocketReactor::OPT_ONESHOT);
+	assertTrue (reactor.getOptions() & SocketReactor::OPT_FAST_DISPATCH);
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	SocketAddress sa("127.0.0.1", ss.address().port());
+	SocketConnector<ClientServiceHandler> connector(sa, reactor);
+	ClientServiceHandler::setOnce(true);
+	ClientServiceHandler::resetData();
+	reactor.run();
+	std::string data(ClientServiceHandler::data());
+	assertTrue (data.size() == 1024);
+	assertTrue (!ClientServiceHandler::readableError());
+	assertTrue (!ClientServiceHandler::writableError());
+	assertTrue (!ClientServiceHandler::timeoutError());
+}
+
+
+void SocketReactorTest::testSocketReactorEdgeTriggered()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor(Poco::Timespan(250000), SocketReactor::OPT_EDGE_TRIGGERED);
+	SocketAcceptor<DrainingEchoServiceHandler> acceptor(ss, reactor);
+	Thread thread;
+	thread.start(reactor);
+
+	StreamSocket sock(SocketAddress("127.0.0.1", ss.address().port()));
+	std::string data(1024, 'x');
+	sock.sendBytes(data.data(), static_cast<int>(data.size()));
+	sock.shutdownSend();
+
+	std::string echo;
+	char buffer[256];
+	int n;
+	while ((n = sock.receiveBytes(buffer, sizeof(buffer))) > 0)
+	{
+		echo.append(buffer, n);
+	}
+	reactor.stop();
+	thread.join();
+
+	assertTrue (echo == data);
+}
+
+
+void SocketReactorTest::testSocketReactorIOUring()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor(Poco::Timespan(250000), SocketReactor::OPT_FAST_DISPATCH | SocketReactor::OPT_IO_URING);
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	SocketAddress sa("127.0.0.1", ss.address().port());
+	SocketConnector<ClientServiceHandler> connector1(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector2(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector3(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector4(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector5(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector6(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector7(sa, reactor);
+	SocketConnector<ClientServiceHandler> connector8(sa, reactor);
+	ClientServiceHandler::setOnce(false);
+	ClientServiceHandler::resetData();
+	reactor.run();
+	std::string data(ClientServiceHandler::data());
+	assertTrue (data.size() == 8192);
+	assertTrue (!ClientServiceHandler::readableError());
+	assertTrue (!ClientServiceHandler::writableError());
+	assertTrue (!ClientServiceHandler::timeoutError());
+}
+
+
+void SocketReactorTest::testSocketReactorDeadline()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor;
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	StreamSocket sock(SocketAddress("127.0.0.1", ss.address().port()));
+
+	try
+	{
+		reactor.scheduleDeadline(sock, Poco::Timespan(1, 0));
+		fail("no event handler - must throw");
+	}
+	catch (Poco::NotFoundException&)
+	{
+	}
+	assertTrue (!reactor.hasDeadline(ss));
+	reactor.scheduleDeadline(ss, Poco::Timespan(1, 0));
+	assertTrue (reactor.hasDeadline(ss));
+	reactor.cancelDeadline(ss);
+	assertTrue (!reactor.hasDeadline(ss));
+	reactor.scheduleDeadline(ss, Poco::Timespan(1, 0));
+	assertTrue (reactor.hasDeadline(ss));
+
+	testIdleTimeout(SocketReactor::OPT_DEFAULT);
+}
+
+
+void SocketReactorTest::testSocketReactorDeadlineFastDispatch()
+{
+	testIdleTimeout(SocketReactor::OPT_FAST_DISPATCH);
+}
+
+
+void SocketReactorTest::testIdleTimeout(int options)
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	// the reactor's timeout is much longer than the idle timeout,
+	// so the deadlines must determine the wait for socket events
+	SocketReactor reactor(Poco::Timespan(5, 0), options);
+	SocketAcceptor<IdleTimeoutServiceHandler> acceptor(ss, reactor);
+	IdleTimeoutServiceHandler::resetDeadlines();
+	Thread thread;
+	thread.start(reactor);
+
+	StreamSocket sock(SocketAddress("127.0.0.1", ss.address().port()));
+	char buffer[8];
+	for (int i = 0; i < 4; i++)
+	{
+		// activity within the idle timeout reschedules the deadline
+		Thread::sleep(IdleTimeoutServiceHandler::IDLE_TIMEOUT/2);
+		sock.sendBytes("x", 1);
+		assertTrue (sock.receiveBytes(buffer, sizeof(buffer)) == 1);
+	}
+	assertTrue (IdleTimeoutServiceHandler::deadlines() == 0);
+
+	Poco::Clock clock;
+	sock.setReceiveTimeout(Poco::Timespan(3, 0));
+	assertTrue (sock.receiveBytes(buffer, sizeof(buffer)) == 0);
+	Poco::Clock::ClockDiff elapsed = clock.elapsed()/1000;
+	assertTrue (elapsed >= IdleTimeoutServiceHandler::IDLE_TIMEOUT - 10);
+	assertTrue (elapsed < 2000);
+	assertTrue (IdleTimeoutServiceHandler::deadlines() == 1);
+
+	// waking up for a deadline does not dispatch a TimeoutNotification
+	// (the connection is not accepted, so the peer stays silent)
+	ServerSocket ss2(SocketAddress("127.0.0.1", 0));
+	StreamSocket sock2(SocketAddress("127.0.0.1", ss2.address().port()));
+	// the reactor is waiting for its own timeout, and must be woken
+	// up by scheduleDeadline() to notice the first deadline in time
+	PeriodicDeadlineHandler handler(sock2, reactor);
+	Thread::sleep(10*PeriodicDeadlineHandler::INTERVAL);
+
+	reactor.stop();
+	thread.join();
+	assertTrue (handler.deadlines() >= 3);
+	assertTrue (handler.timeouts() == 0);
+}
+
+
+void SocketReactorTest::testPost()
+{
+	testPostTask(SocketReactor::OPT_DEFAULT);
+	testPostTask(SocketReactor::OPT_FAST_DISPATCH);
+	testPostTask(SocketReactor::OPT_FAST_DISPATCH | SocketReactor::OPT_IO_URING);
+}
+
+
+void SocketReactorTest::testPostTask(int options)
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	// the reactor's timeout is much longer than the expected latency
+	SocketReactor reactor(Poco::Timespan(5, 0), options);
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	Thread thread;
+	thread.start(reactor);
+	Thread::sleep(100);
+
+	Poco::Event done;
+	Thread* pTaskThread = 0;
+	int count = 0;
+	Poco::Clock clock;
+	for (int i = 0; i < 10; i++)
+	{
+		reactor.post([&count]()
+		{
+			++count;
+		});
+	}
+	reactor.post([&]()
+	{
+		pTaskThread = Thread::current();
+		done.set();
+	});
+	assertTrue (done.tryWait(2000));
+	assertTrue (clock.elapsed() < 1000000);
+	assertTrue (pTaskThread == &thread);
+	assertTrue (count == 10);
+
+	// exceptions thrown by tasks do not stop the reactor
+	reactor.post([]()
+	{
+		throw Poco::IllegalStateException("task failed");
+	});
+	reactor.post([&]()
+	{
+		done.set();
+	});
+	assertTrue (done.tryWait(2000));
+
+	clock.update();
+	reactor.stop();
+	thread.join();
+	assertTrue (clock.elapsed() < 1000000);
+
+	// tasks posted while the reactor is not running are run with it
+	reactor.post([&count]()
+	{
+		++count;
+	});
+	reactor.post([&reactor]()
+	{
+		reactor.stop();
+	});
+	thread.start(reactor);
+	thread.join();
+	assertTrue (count == 11);
+}
+
+
 void SocketReactorTest::setUp()
 {
 	ClientServiceHandler::setCloseOnTimeout(false);
@@ -580,7 +1086,15 @@ CppUnit::Test* SocketReactorTest::suite()
 	CppUnit_addTest(pSuite, SocketReactorTest, testParallelSocketReactor);
 	CppUnit_addTest(pSuite, SocketReactorTest, testSocketConnectorFail);
 	CppUnit_addTest(pSuite, SocketReactorTest, testSocketConnectorTimeout);
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketConnectorHostName);
 	CppUnit_addTest(pSuite, SocketReactorTest, testDataCollection);
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketReactorFastDispatch);
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketReactorOneShot);
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketReactorEdgeTriggered);
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketReactorIOUring);
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketReactorDeadline);
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketReactorDeadlineFastDispatch);
+	CppUnit_addTest(pSuite, SocketReactorTest, testPost);
 
 	return pSuite;
 }
@@ -29,7 +29,15 @@ public:
 	void testParallelSocketReactor();
 	void testSocketConnectorFail();
 	void testSocketConnectorTimeout();
+	void testSocketConnectorHostName();
 	void testDataCollection();
+	void testSocketReactorFastDispatch();
+	void testSocketReactorOneShot();
+	void testSocketReactorEdgeTriggered();
+	void testSocketReactorIOUring();
+	void testSocketReactorDeadline();
+	void testSocketReactorDeadlineFastDispatch();
+	void testPost();
 
 	void setUp();
 	void tearDown();
@@ -37,6 +45,8 @@ public:
 	static CppUnit::Test* suite();
 
 private:
+	void testIdleTimeout(int options);
+	void testPostTask(int options);
 };
 
 
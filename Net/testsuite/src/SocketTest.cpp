@@ -22,10 +22,13 @@
 #include "Poco/FIFOBuffer.h"
 #include "Poco/Delegate.h"
 #include "Poco/File.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
 #include <iostream>
 
 
 using Poco::Net::Socket;
+using Poco::Net::SocketBufVec;
 using Poco::Net::StreamSocket;
 using Poco::Net::ServerSocket;
 using Poco::Net::SocketAddress;
@@ -37,6 +40,9 @@ using Poco::InvalidArgumentException;
 using Poco::Buffer;
 using Poco::FIFOBuffer;
 using Poco::delegate;
+using Poco::TemporaryFile;
+using Poco::FileInputStream;
+using Poco::FileOutputStream;
 
 
 SocketTest::SocketTest(const std::string& name): CppUnit::TestCase(name)
@@ -163,6 +169,96 @@ void SocketTest::testFIFOBuffer()
 }
 
 
+void SocketTest::testBuffers()
+{
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+
+	std::string header("header:");
+	std::string body("body");
+	SocketBufVec sendBufs;
+	sendBufs.push_back(Socket::makeBuffer(header.data(), header.size()));
+	sendBufs.push_back(Socket::makeBuffer(0, 0));
+	sendBufs.push_back(Socket::makeBuffer(body.data(), body.size()));
+	assertTrue (Socket::bufferSize(sendBufs) == 11);
+	int n = ss.sendBytes(sendBufs);
+	assertTrue (n == 11);
+
+	char buffer1[4];
+	char buffer2[256];
+	SocketBufVec recvBufs;
+	recvBufs.push_back(Socket::makeBuffer(buffer1, sizeof(buffer1)));
+	recvBufs.push_back(Socket::makeBuffer(buffer2, sizeof(buffer2)));
+	n = 0;
+	while (n < 11)
+	{
+		SocketBufVec rest;
+		if (n < 4)
+		{
+			rest.push_back(Socket::makeBuffer(buffer1 + n, sizeof(buffer1) - n));
+			rest.push_back(recvBufs[1]);
+		}
+		else rest.push_back(Socket::makeBuffer(buffer2 + n - 4, sizeof(buffer2) - (n - 4)));
+		int rc = ss.receiveBytes(rest);
+		assertTrue (rc > 0);
+		n += rc;
+	}
+	assertTrue (n == 11);
+	assertTrue (std::string(buffer1, 4) == "head");
+	assertTrue (std::string(buffer2, 7) == "er:body");
+
+	ss.close();
+}
+
+
+void SocketTest::testSendFile()
+{
+	TemporaryFile tf;
+	std::string data;
+	for (int i = 0; i < 20000; ++i) data += static_cast<char>('a' + i % 26);
+	{
+		FileOutputStream ostr(tf.path());
+		ostr << data;
+	}
+
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+
+	FileInputStream istr(tf.path());
+	std::streamsize n = ss.sendFile(istr, 100, 10000);
+	assertTrue (n == 10000);
+	std::string received;
+	char buffer[1024];
+	while (received.size() < 10000)
+	{
+		int rc = ss.receiveBytes(buffer, sizeof(buffer));
+		assertTrue (rc > 0);
+		received.append(buffer, rc);
+	}
+	assertTrue (received == data.substr(100, 10000));
+
+	// count 0 sends up to the end of the file
+	n = ss.sendFile(istr, 19000);
+	assertTrue (n == 1000);
+	received.clear();
+	while (received.size() < 1000)
+	{
+		int rc = ss.receiveBytes(buffer, sizeof(buffer));
+		assertTrue (rc > 0);
+		received.append(buffer, rc);
+	}
+	assertTrue (received == data.substr(19000));
+
+	// nothing to send beyond the end of the file
+	n = ss.sendFile(istr, 20000);
+	assertTrue (n == 0);
+
+	ss.close();
+}
+
+
 void SocketTest::testConnect()
 {
 	ServerSocket serv;
@@ -562,6 +658,8 @@ CppUnit::Test* SocketTest::suite()
 	CppUnit_addTest(pSuite, SocketTest, testPoll);
 	CppUnit_addTest(pSuite, SocketTest, testAvailable);
 	CppUnit_addTest(pSuite, SocketTest, testFIFOBuffer);
+	CppUnit_addTest(pSuite, SocketTest, testBuffers);
+	CppUnit_addTest(pSuite, SocketTest, testSendFile);
 	CppUnit_addTest(pSuite, SocketTest, testConnect);
 	CppUnit_addTest(pSuite, SocketTest, testConnectRefused);
 	CppUnit_addTest(pSuite, SocketTest, testConnectRefusedNB);
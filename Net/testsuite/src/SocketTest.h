@@ -28,6 +28,8 @@ public:
 	void testPoll();
 	void testAvailable();
 	void testFIFOBuffer();
+	void testBuffers();
+	void testSendFile();
 	void testConnect();
 	void testConnectRefused();
 	void testConnectRefusedNB();
@@ -277,6 +277,110 @@ void TCPServerTest::testFilter()
 }
 
 
+void TCPServerTest::testWorkStealing()
+{
+	ServerSocket svs(0);
+	TCPServerParams* pParams = new TCPServerParams;
+	pParams->setMaxThreads(2);
+	pParams->setMaxQueued(4);
+	pParams->setThreadIdleTime(100);
+	pParams->setDispatchMode(TCPServerParams::DISPATCH_WORK_STEALING);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs, pParams);
+	srv.start();
+	assertTrue (srv.currentThreads() == 0);
+	assertTrue (srv.queuedConnections() == 0);
+	assertTrue (srv.stolenConnections() == 0);
+	assertTrue (srv.queueDepths().size() == 2);
+
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	StreamSocket ss1(sa);
+	std::string data("hello, world");
+	ss1.sendBytes(data.data(), (int) data.size());
+	char buffer[256];
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (n > 0);
+	assertTrue (std::string(buffer, n) == data);
+
+	// With only one thread running, the second connection lands
+	// in the first thread's queue and must be stolen by the
+	// newly started second thread.
+	StreamSocket ss2(sa);
+	ss2.sendBytes(data.data(), (int) data.size());
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (n > 0);
+	assertTrue (std::string(buffer, n) == data);
+
+	assertTrue (srv.currentConnections() == 2);
+	assertTrue (srv.currentThreads() == 2);
+	assertTrue (srv.stolenConnections() == 1);
+
+	StreamSocket ss3(sa);
+	StreamSocket ss4(sa);
+	Thread::sleep(200);
+	assertTrue (srv.queuedConnections() == 2);
+	std::vector<int> depths = srv.queueDepths();
+	assertTrue (depths.size() == 2);
+	assertTrue (depths[0] == 1);
+	assertTrue (depths[1] == 1);
+
+	ss1.close();
+	ss2.close();
+	Thread::sleep(300);
+	assertTrue (srv.queuedConnections() == 0);
+	assertTrue (srv.totalConnections() == 4);
+	assertTrue (srv.stolenConnections() == 1);
+
+	ss3.close();
+	ss4.close();
+	Thread::sleep(300);
+	assertTrue (srv.currentConnections() == 0);
+	assertTrue (srv.currentThreads() == 1);
+
+	// The remaining thread may own either queue; a new
+	// connection must go to its queue and not be stolen.
+	StreamSocket ss5(sa);
+	ss5.sendBytes(data.data(), (int) data.size());
+	n = ss5.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (n > 0);
+	assertTrue (std::string(buffer, n) == data);
+	assertTrue (srv.stolenConnections() == 1);
+	ss5.close();
+}
+
+
+void TCPServerTest::testMultiAcceptors()
+{
+	TCPServerParams* pParams = new TCPServerParams;
+	pParams->setMaxThreads(2);
+	pParams->setThreadIdleTime(100);
+	pParams->setAcceptors(3);
+	pParams->setThreadAffinity(true);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), 0, pParams);
+	srv.start();
+	assertTrue (srv.currentThreads() == 0);
+	assertTrue (srv.maxThreads() == 6);
+	assertTrue (srv.totalConnections() == 0);
+
+	SocketAddress sa("127.0.0.1", srv.port());
+	std::string data("hello, world");
+	for (int i = 0; i < 10; ++i)
+	{
+		StreamSocket ss(sa);
+		ss.sendBytes(data.data(), (int) data.size());
+		char buffer[256];
+		int n = ss.receiveBytes(buffer, sizeof(buffer));
+		assertTrue (n > 0);
+		assertTrue (std::string(buffer, n) == data);
+		ss.close();
+	}
+	Thread::sleep(300);
+	assertTrue (srv.totalConnections() == 10);
+	assertTrue (srv.currentConnections() == 0);
+	assertTrue (srv.queuedConnections() == 0);
+	srv.stop();
+}
+
+
 void TCPServerTest::setUp()
 {
 }
@@ -296,6 +400,8 @@ CppUnit::Test* TCPServerTest::suite()
 	CppUnit_addTest(pSuite, TCPServerTest, testMultiConnections);
 	CppUnit_addTest(pSuite, TCPServerTest, testThreadCapacity);
 	CppUnit_addTest(pSuite, TCPServerTest, testFilter);
+	CppUnit_addTest(pSuite, TCPServerTest, testWorkStealing);
+	CppUnit_addTest(pSuite, TCPServerTest, testMultiAcceptors);
 
 	return pSuite;
 }
@@ -29,6 +29,8 @@ public:
 	void testMultiConnections();
 	void testThreadCapacity();
 	void testFilter();
+	void testWorkStealing();
+	void testMultiAcceptors();
 
 	void setUp();
 	void tearDown();
@@ -10,6 +10,7 @@
 
 #include "TCPServerTestSuite.h"
 #include "TCPServerTest.h"
+#include "MetricsRegistryTest.h"
 
 
 CppUnit::Test* TCPServerTestSuite::suite()
@@ -17,6 +18,7 @@ CppUnit::Test* TCPServerTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("TCPServerTestSuite");
 
 	pSuite->addTest(TCPServerTest::suite());
+	pSuite->addTest(MetricsRegistryTest::suite());
 
 	return pSuite;
 }
@@ -33,7 +33,11 @@ using Poco::Net::HTTPServerRequest;
 using Poco::Net::HTTPServerResponse;
 using Poco::Net::SocketStream;
 using Poco::Net::WebSocket;
+using Poco::Net::WebSocketDeflate;
 using Poco::Net::WebSocketException;
+using Poco::Net::Socket;
+using Poco::Net::SocketBuf;
+using Poco::Net::SocketBufVec;
 
 
 namespace
@@ -41,7 +45,9 @@ namespace
 	class WebSocketRequestHandler: public Poco::Net::HTTPRequestHandler
 	{
 	public:
-		WebSocketRequestHandler(std::size_t bufSize = 1024): _bufSize(bufSize)
+		WebSocketRequestHandler(std::size_t bufSize = 1024, const WebSocketDeflate::Params* pDeflateParams = 0):
+			_bufSize(bufSize),
+			_pDeflateParams(pDeflateParams)
 		{
 		}
 
@@ -49,7 +55,7 @@ namespace
 		{
 			try
 			{
-				WebSocket ws(request, response);
+				WebSocket ws = _pDeflateParams ? WebSocket(request, response, *_pDeflateParams) : WebSocket(request, response);
 				Poco::Buffer<char> buffer(_bufSize);
 				int flags;
 				int n;
@@ -82,22 +88,26 @@ namespace
 
 	private:
 		std::size_t _bufSize;
+		const WebSocketDeflate::Params* _pDeflateParams;
 	};
 	
 	class WebSocketRequestHandlerFactory: public Poco::Net::HTTPRequestHandlerFactory
 	{
 	public:
-		WebSocketRequestHandlerFactory(std::size_t bufSize = 1024): _bufSize(bufSize)
+		WebSocketRequestHandlerFactory(std::size_t bufSize = 1024, const WebSocketDeflate::Params* pDeflateParams = 0):
+			_bufSize(bufSize),
+			_pDeflateParams(pDeflateParams)
 		{
 		}
 
 		Poco::Net::HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
 		{
-			return new WebSocketRequestHandler(_bufSize);
+			return new WebSocketRequestHandler(_bufSize, _pDeflateParams);
 		}
 
 	private:
 		std::size_t _bufSize;
+		const WebSocketDeflate::Params* _pDeflateParams;
 	};
 }
 
@@ -270,6 +280,344 @@ void WebSocketTest::testWebSocketLargeInOneFrame()
 }
 
 
+void WebSocketTest::testWebSocketBuffers()
+{
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory, ss, new Poco::Net::HTTPServerParams);
+	server.start();
+
+	Poco::Thread::sleep(200);
+
+	HTTPClientSession cs("127.0.0.1", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/ws", HTTPRequest::HTTP_1_1);
+	HTTPResponse response;
+	WebSocket ws(cs, request, response);
+
+	std::string header("{\"type\":\"quote\",");
+	std::string body("\"bid\":1.2345,\"ask\":1.2346}");
+	SocketBufVec sendBufs;
+	sendBufs.push_back(Socket::makeBuffer(header.data(), header.size()));
+	sendBufs.push_back(Socket::makeBuffer(body.data(), body.size()));
+	int n = ws.sendFrame(sendBufs);
+	assertTrue (n == header.size() + body.size());
+
+	char buffer1[8];
+	char buffer2[256];
+	SocketBufVec recvBufs;
+	recvBufs.push_back(Socket::makeBuffer(buffer1, sizeof(buffer1)));
+	recvBufs.push_back(Socket::makeBuffer(buffer2, sizeof(buffer2)));
+	int flags;
+	n = ws.receiveFrame(recvBufs, flags);
+	assertTrue (n == header.size() + body.size());
+	assertTrue (flags == WebSocket::FRAME_TEXT);
+	assertTrue (std::string(buffer1, sizeof(buffer1)) + std::string(buffer2, n - sizeof(buffer1)) == header + body);
+
+	char small[4];
+	SocketBufVec smallBufs(1, Socket::makeBuffer(small, sizeof(small)));
+	ws.sendFrame(sendBufs);
+	try
+	{
+		ws.receiveFrame(smallBufs, flags);
+		fail("payload too big - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assertTrue (exc.code() == WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+	}
+
+	server.stop();
+}
+
+
+void WebSocketTest::testWebSocketDeflate()
+{
+	WebSocketDeflate::Params serverParams;
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory(256000, &serverParams), ss, new Poco::Net::HTTPServerParams);
+	server.start();
+
+	Poco::Thread::sleep(200);
+
+	HTTPClientSession cs("127.0.0.1", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/ws", HTTPRequest::HTTP_1_1);
+	HTTPResponse response;
+	WebSocket ws(cs, request, response, WebSocketDeflate::Params());
+	assertTrue (ws.deflateEnabled());
+	assertTrue (response.get("Sec-WebSocket-Extensions") == "permessage-deflate");
+	assertTrue (!ws.deflateParams().serverNoContextTakeover);
+	assertTrue (!ws.deflateParams().clientNoContextTakeover);
+
+	std::string payload;
+	for (int i = 0; i < 5000; i++)
+	{
+		payload += "{\"symbol\":\"POCO\",\"bid\":1.2345,\"ask\":1.2346},";
+	}
+
+	Poco::Buffer<char> buffer(0);
+	int flags;
+	for (int i = 0; i < 3; i++)
+	{
+		int n = ws.sendFrame(payload.data(), static_cast<int>(payload.size()));
+		assertTrue (n == payload.size());
+		buffer.resize(0);
+		n = ws.receiveFrame(buffer, flags);
+		assertTrue (n == payload.size());
+		assertTrue (flags == WebSocket::FRAME_TEXT);
+		assertTrue (payload.compare(0, payload.size(), buffer.begin(), n) == 0);
+	}
+
+	// smaller than minimumSize, sent uncompressed
+	std::string hello("Hello");
+	ws.sendFrame(hello.data(), static_cast<int>(hello.size()));
+	char small[256];
+	int n = ws.receiveFrame(small, sizeof(small), flags);
+	assertTrue (n == hello.size());
+	assertTrue (flags == WebSocket::FRAME_TEXT);
+	assertTrue (hello.compare(0, hello.size(), small, n) == 0);
+
+	// fragmented message
+	std::string part1(payload, 0, 1000);
+	std::string part2(payload, 1000, 2000);
+	ws.sendFrame(part1.data(), static_cast<int>(part1.size()), WebSocket::FRAME_OP_TEXT);
+	ws.sendFrame(part2.data(), static_cast<int>(part2.size()), WebSocket::FRAME_FLAG_FIN | WebSocket::FRAME_OP_CONT);
+	buffer.resize(0);
+	n = ws.receiveFrame(buffer, flags);
+	assertTrue (flags == WebSocket::FRAME_OP_TEXT);
+	n += ws.receiveFrame(buffer, flags);
+	assertTrue (flags == (WebSocket::FRAME_FLAG_FIN | WebSocket::FRAME_OP_CONT));
+	assertTrue (n == 3000);
+	assertTrue (part1 + part2 == std::string(buffer.begin(), n));
+
+	// receive into buffers
+	SocketBufVec sendBufs;
+	sendBufs.push_back(Socket::makeBuffer(payload.data(), 100));
+	sendBufs.push_back(Socket::makeBuffer(payload.data() + 100, 900));
+	ws.sendFrame(sendBufs, WebSocket::FRAME_BINARY);
+	Poco::Buffer<char> buffer1(10);
+	Poco::Buffer<char> buffer2(2000);
+	SocketBufVec recvBufs;
+	recvBufs.push_back(Socket::makeBuffer(buffer1.begin(), buffer1.size()));
+	recvBufs.push_back(Socket::makeBuffer(buffer2.begin(), buffer2.size()));
+	n = ws.receiveFrame(recvBufs, flags);
+	assertTrue (n == 1000);
+	assertTrue (flags == WebSocket::FRAME_BINARY);
+	assertTrue (payload.compare(0, 10, buffer1.begin(), 10) == 0);
+	assertTrue (payload.compare(10, 990, buffer2.begin(), 990) == 0);
+
+	// decompressed payload too big for buffer
+	ws.sendFrame(payload.data(), static_cast<int>(payload.size()));
+	try
+	{
+		ws.receiveFrame(small, sizeof(small), flags);
+		fail("payload too big - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assertTrue (exc.code() == WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+	}
+
+	server.stop();
+}
+
+
+void WebSocketTest::testWebSocketDeflateParams()
+{
+	WebSocketDeflate::Params serverParams;
+	serverParams.serverMaxWindowBits = 12;
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory(256000, &serverParams), ss, new Poco::Net::HTTPServerParams);
+	server.start();
+
+	Poco::Thread::sleep(200);
+
+	HTTPClientSession cs("127.0.0.1", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/ws", HTTPRequest::HTTP_1_1);
+	HTTPResponse response;
+	WebSocketDeflate::Params clientParams;
+	clientParams.serverNoContextTakeover = true;
+	clientParams.clientNoContextTakeover = true;
+	clientParams.clientMaxWindowBits = 10;
+	WebSocket ws(cs, request, response, clientParams);
+	assertTrue (request.get("Sec-WebSocket-Extensions") == "permessage-deflate; server_no_context_takeover; client_no_context_takeover; client_max_window_bits=10");
+	assertTrue (ws.deflateEnabled());
+	assertTrue (ws.deflateParams().serverNoContextTakeover);
+	assertTrue (ws.deflateParams().clientNoContextTakeover);
+	assertTrue (ws.deflateParams().serverMaxWindowBits == 12);
+	assertTrue (ws.deflateParams().clientMaxWindowBits == 10);
+
+	std::string payload;
+	for (int i = 0; i < 1000; i++)
+	{
+		payload += "{\"symbol\":\"POCO\",\"bid\":1.2345,\"ask\":1.2346},";
+	}
+	Poco::Buffer<char> buffer(0);
+	int flags;
+	for (int i = 0; i < 3; i++)
+	{
+		ws.sendFrame(payload.data(), static_cast<int>(payload.size()));
+		buffer.resize(0);
+		int n = ws.receiveFrame(buffer, flags);
+		assertTrue (n == payload.size());
+		assertTrue (payload.compare(0, payload.size(), buffer.begin(), n) == 0);
+	}
+	server.stop();
+
+	// server does not support the extension
+	Poco::Net::ServerSocket ss2(0);
+	Poco::Net::HTTPServer server2(new WebSocketRequestHandlerFactory, ss2, new Poco::Net::HTTPServerParams);
+	server2.start();
+
+	Poco::Thread::sleep(200);
+
+	HTTPClientSession cs2("127.0.0.1", ss2.address().port());
+	HTTPRequest request2(HTTPRequest::HTTP_GET, "/ws", HTTPRequest::HTTP_1_1);
+	HTTPResponse response2;
+	WebSocket ws2(cs2, request2, response2, clientParams);
+	assertTrue (!ws2.deflateEnabled());
+	payload.assign(200, 'x');
+	ws2.sendFrame(payload.data(), static_cast<int>(payload.size()));
+	char small[256];
+	int n = ws2.receiveFrame(small, sizeof(small), flags);
+	assertTrue (n == payload.size());
+	server2.stop();
+}
+
+
+void WebSocketTest::testDeflateNegotiation()
+{
+	WebSocketDeflate::Params params;
+	WebSocketDeflate::Params agreed;
+	std::string response;
+
+	assertTrue (WebSocketDeflate::offer(params) == "permessage-deflate; client_max_window_bits");
+
+	assertTrue (WebSocketDeflate::accept("permessage-deflate; client_max_window_bits", params, agreed, response));
+	assertTrue (response == "permessage-deflate");
+	assertTrue (agreed.serverMaxWindowBits == 15 && agreed.clientMaxWindowBits == 15);
+
+	// first acceptable offer is used
+	assertTrue (WebSocketDeflate::accept("x-webkit-deflate-frame, permessage-deflate; server_max_window_bits=8, permessage-deflate; server_max_window_bits=10; client_max_window_bits", params, agreed, response));
+	assertTrue (response == "permessage-deflate; server_max_window_bits=10");
+	assertTrue (agreed.serverMaxWindowBits == 10);
+
+	// client window size can only be limited if client allows it
+	params.clientMaxWindowBits = 11;
+	assertTrue (WebSocketDeflate::accept("permessage-deflate", params, agreed, response));
+	assertTrue (response == "permessage-deflate");
+	assertTrue (agreed.clientMaxWindowBits == 15);
+	assertTrue (WebSocketDeflate::accept("permessage-deflate; client_max_window_bits=13; server_no_context_takeover", params, agreed, response));
+	assertTrue (response == "permessage-deflate; server_no_context_takeover; client_max_window_bits=11");
+	assertTrue (agreed.serverNoContextTakeover && agreed.clientMaxWindowBits == 11);
+
+	assertTrue (!WebSocketDeflate::accept("permessage-deflate; unknown_param", params, agreed, response));
+	assertTrue (!WebSocketDeflate::accept("permessage-deflate; client_max_window_bits=16", params, agreed, response));
+	assertTrue (!WebSocketDeflate::accept("", params, agreed, response));
+
+	WebSocketDeflate::Params offered;
+	offered.clientMaxWindowBits = 12;
+	assertTrue (WebSocketDeflate::confirm("permessage-deflate; client_max_window_bits=10; server_max_window_bits=9", offered, agreed));
+	assertTrue (agreed.clientMaxWindowBits == 10 && agreed.serverMaxWindowBits == 9);
+	assertTrue (!WebSocketDeflate::confirm("", offered, agreed));
+	try
+	{
+		WebSocketDeflate::confirm("permessage-deflate; client_max_window_bits=13", offered, agreed);
+		fail("window larger than offered - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assertTrue (exc.code() == WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+	}
+	offered.serverNoContextTakeover = true;
+	try
+	{
+		WebSocketDeflate::confirm("permessage-deflate", offered, agreed);
+		fail("server_no_context_takeover missing - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assertTrue (exc.code() == WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+	}
+}
+
+
+void WebSocketTest::testDeflate()
+{
+	std::string payload;
+	for (int i = 0; i < 2000; i++)
+	{
+		payload += "{\"symbol\":\"POCO\",\"bid\":1.2345,\"ask\":1.2346},";
+	}
+	SocketBuf buf = Socket::makeBuffer(payload.data(), payload.size());
+
+	WebSocketDeflate::Params params;
+	WebSocketDeflate server(params, true);
+	WebSocketDeflate client(params, false);
+	Poco::Buffer<char> compressed(0);
+	Poco::Buffer<char> decompressed(0);
+
+	server.compress(&buf, 1, true, compressed);
+	std::size_t firstSize = compressed.size();
+	assertTrue (firstSize < payload.size()/10);
+	client.decompress(compressed.begin(), compressed.size(), true, decompressed);
+	assertTrue (std::string(decompressed.begin(), decompressed.size()) == payload);
+
+	// with context takeover, the second message refers to the first one
+	server.compress(&buf, 1, true, compressed);
+	assertTrue (compressed.size() < firstSize);
+	decompressed.resize(0);
+	client.decompress(compressed.begin(), compressed.size(), true, decompressed);
+	assertTrue (std::string(decompressed.begin(), decompressed.size()) == payload);
+
+	params.serverNoContextTakeover = true;
+	WebSocketDeflate server2(params, true);
+	WebSocketDeflate client2(params, false);
+	for (int i = 0; i < 2; i++)
+	{
+		server2.compress(&buf, 1, true, compressed);
+		assertTrue (compressed.size() == firstSize);
+		std::string result(payload.size(), '\0');
+		std::size_t n = client2.decompress(compressed.begin(), compressed.size(), true, &result[0], result.size());
+		assertTrue (n == payload.size());
+		assertTrue (result == payload);
+	}
+
+	const char garbage[] = "\xff\xff\xff\xff\xff\xff";
+	try
+	{
+		client2.decompress(garbage, sizeof(garbage), true, decompressed);
+		fail("invalid data - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assertTrue (exc.code() == WebSocket::WS_ERR_COMPRESSION);
+	}
+
+	// a small frame that decompresses to more than maxPayloadSize
+	std::string zeros(4*1024*1024, '\0');
+	SocketBuf zerosBuf = Socket::makeBuffer(zeros.data(), zeros.size());
+	server2.compress(&zerosBuf, 1, true, compressed);
+	assertTrue (compressed.size() < 8192);
+	params.maxPayloadSize = 256*1024;
+	WebSocketDeflate client3(params, false);
+	decompressed.resize(0);
+	try
+	{
+		client3.decompress(compressed.begin(), compressed.size(), true, decompressed);
+		fail("payload too big - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assertTrue (exc.code() == WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+	}
+	assertTrue (decompressed.size() <= params.maxPayloadSize);
+
+	server2.compress(&buf, 1, true, compressed);
+	decompressed.resize(0);
+	client3.decompress(compressed.begin(), compressed.size(), true, decompressed);
+	assertTrue (std::string(decompressed.begin(), decompressed.size()) == payload);
+}
+
+
 void WebSocketTest::setUp()
 {
 }
@@ -287,6 +635,11 @@ CppUnit::Test* WebSocketTest::suite()
 	CppUnit_addTest(pSuite, WebSocketTest, testWebSocket);
 	CppUnit_addTest(pSuite, WebSocketTest, testWebSocketLarge);
 	CppUnit_addTest(pSuite, WebSocketTest, testWebSocketLargeInOneFrame);
+	CppUnit_addTest(pSuite, WebSocketTest, testWebSocketBuffers);
+	CppUnit_addTest(pSuite, WebSocketTest, testWebSocketDeflate);
+	CppUnit_addTest(pSuite, WebSocketTest, testWebSocketDeflateParams);
+	CppUnit_addTest(pSuite, WebSocketTest, testDeflateNegotiation);
+	CppUnit_addTest(pSuite, WebSocketTest, testDeflate);
 
 	return pSuite;
 }
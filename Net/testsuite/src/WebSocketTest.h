@@ -27,6 +27,11 @@ public:
 	void testWebSocket();
 	void testWebSocketLarge();
 	void testWebSocketLargeInOneFrame();
+	void testWebSocketBuffers();
+	void testWebSocketDeflate();
+	void testWebSocketDeflateParams();
+	void testDeflateNegotiation();
+	void testDeflate();
 
 	void setUp();
 	void tearDown();
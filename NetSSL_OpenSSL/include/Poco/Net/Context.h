@@ -20,12 +20,16 @@
 
 #include "Poco/Net/NetSSL.h"
 #include "Poco/Net/SocketDefs.h"
+#include "Poco/Net/Session.h"
 #include "Poco/Crypto/X509Certificate.h"
 #include "Poco/Crypto/RSAKey.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
 #include <openssl/ssl.h>
 #include <cstdlib>
+#include <map>
+#include <vector>
 
 
 namespace Poco {
@@ -54,7 +58,9 @@ public:
 		TLSV1_1_CLIENT_USE, /// Context is used by a client requiring TLSv1.1 (OpenSSL 1.0.0 or newer).
 		TLSV1_1_SERVER_USE, /// Context is used by a server requiring TLSv1.1 (OpenSSL 1.0.0 or newer).
 		TLSV1_2_CLIENT_USE, /// Context is used by a client requiring TLSv1.2 (OpenSSL 1.0.1 or newer).
-		TLSV1_2_SERVER_USE  /// Context is used by a server requiring TLSv1.2 (OpenSSL 1.0.1 or newer).
+		TLSV1_2_SERVER_USE, /// Context is used by a server requiring TLSv1.2 (OpenSSL 1.0.1 or newer).
+		TLSV1_3_CLIENT_USE, /// Context is used by a client requiring TLSv1.3 (OpenSSL 1.1.1 or newer).
+		TLSV1_3_SERVER_USE  /// Context is used by a server requiring TLSv1.3 (OpenSSL 1.1.1 or newer).
 	};
 	
 	enum VerificationMode
@@ -100,7 +106,8 @@ public:
 		PROTO_SSLV3   = 0x02,
 		PROTO_TLSV1   = 0x04,
 		PROTO_TLSV1_1 = 0x08,
-		PROTO_TLSV1_2 = 0x10
+		PROTO_TLSV1_2 = 0x10,
+		PROTO_TLSV1_3 = 0x20
 	};
 	
 	struct NetSSL_API Params
@@ -259,6 +266,16 @@ public:
 		/// To enable session caching on the server side, use the
 		/// two-argument version of this method to specify
 		/// a session ID context.
+		///
+		/// On the client side, the Context keeps the sessions
+		/// (including TLSv1.3 session tickets, which the server may
+		/// send at any time after the handshake) negotiated by its
+		/// connections, keyed by the peer host name (or address)
+		/// and port. A SecureSocketImpl connecting to the same peer
+		/// automatically resumes the cached session, unless a
+		/// session has been set explicitly with useSession().
+		/// HTTPSClientSession therefore resumes sessions across
+		/// connections without further configuration.
 
 	void enableSessionCache(bool flag, const std::string& sessionIdContext);
 		/// Enables or disables SSL/TLS session caching on the server.
@@ -281,19 +298,16 @@ public:
 		/// Returns true iff the session cache is enabled.
 		
 	void setSessionCacheSize(std::size_t size);
-		/// Sets the maximum size of the server session cache, in number of
-		/// sessions. The default size (according to OpenSSL documentation)
+		/// Sets the maximum size of the session cache, in number of
+		/// sessions (on the client side, in number of peers).
+		/// The default size (according to OpenSSL documentation)
 		/// is 1024*20, which may be too large for many applications,
 		/// especially on embedded platforms with limited memory.
 		///
 		/// Specifying a size of 0 will set an unlimited cache size.
-		///
-		/// This method may only be called on SERVER_USE Context objects.
 		
 	std::size_t getSessionCacheSize() const;
-		/// Returns the current maximum size of the server session cache.
-		///
-		/// This method may only be called on SERVER_USE Context objects.
+		/// Returns the current maximum size of the session cache.
 		
 	void setSessionTimeout(long seconds);
 		/// Sets the timeout (in seconds) of cached sessions on the server.
@@ -308,9 +322,97 @@ public:
 		/// This method may only be called on SERVER_USE Context objects.
 
 	void flushSessionCache();
-		/// Flushes the SSL session cache on the server.
+		/// Flushes the SSL session cache.
+		///
+		/// On the server, expired sessions are removed from the cache.
+		/// On the client, all cached sessions are removed.
+
+	Session::Ptr findClientSession(const std::string& peer);
+		/// Returns the cached client session for the given peer
+		/// ("host:port"), or null if the cache contains no resumable
+		/// session for the peer.
+		///
+		/// As TLSv1.3 sessions should only be resumed once, such
+		/// sessions are removed from the cache. The server usually
+		/// sends a new session ticket with every resumption.
+		///
+		/// Used by SecureSocketImpl if session caching is enabled.
+
+	void addClientSession(const std::string& peer, Session::Ptr pSession);
+		/// Adds the given session to the client session cache,
+		/// replacing the session cached for the given peer, if any.
+
+	void removeClientSession(const std::string& peer);
+		/// Removes the session cached for the given peer
+		/// from the client session cache.
+
+	std::size_t clientSessionCount() const;
+		/// Returns the number of sessions in the client session cache.
+
+	void setSessionTicketCount(std::size_t count);
+		/// Sets the number of TLSv1.3 session tickets the server
+		/// sends to a client after a full handshake. After a resumed
+		/// handshake, the server sends a single ticket. The default
+		/// (according to OpenSSL documentation) is 2.
+		///
+		/// Session tickets are not kept in the session cache on
+		/// the server (unless stateless session resumption has been
+		/// disabled), so clients can resume sessions even if the
+		/// server session cache is disabled.
+		///
+		/// Specifying 0 disables TLSv1.3 session tickets.
+		///
+		/// Requires OpenSSL 1.1.1 or newer, otherwise throws a
+		/// Poco::NotImplementedException.
+		///
+		/// This method may only be called on SERVER_USE Context objects.
+
+	std::size_t getSessionTicketCount() const;
+		/// Returns the number of TLSv1.3 session tickets the server
+		/// sends to a client after a full handshake.
 		///
 		/// This method may only be called on SERVER_USE Context objects.
+
+	void enableKernelTLS(bool flag = true);
+		/// Enables or disables kernel TLS (kTLS) offload.
+		///
+		/// If enabled, and if supported by OpenSSL (3.0 or newer, built
+		/// with kTLS support), the operating system and the negotiated
+		/// cipher, the encryption (and decryption) of application data is
+		/// handed to the kernel after the handshake. This allows
+		/// SecureStreamSocket::sendFile() to send files without
+		/// copying them to user space.
+		///
+		/// If kTLS is not available, the connection falls back to
+		/// encryption in user space, so enabling kTLS is always safe.
+		/// Use SecureStreamSocket::kernelTLSSend() to find out whether
+		/// kTLS is actually used by a connection.
+		///
+		/// The default is disabled kTLS offload.
+
+	bool kernelTLSEnabled() const;
+		/// Returns true iff kTLS offload has been enabled and
+		/// OpenSSL supports kTLS.
+
+	void setALPNProtocols(const std::vector<std::string>& protocols);
+		/// Sets the application protocols for Application-Layer
+		/// Protocol Negotiation (ALPN, RFC 7301), in order of
+		/// preference (e.g., "h2", "http/1.1").
+		///
+		/// A client offers the protocols to the server. A server
+		/// selects the first of its protocols offered by the client.
+		/// If the client offers none of them, or no protocols are
+		/// offered at all, no protocol is negotiated, and the
+		/// handshake continues without ALPN.
+		///
+		/// The negotiated protocol is returned by
+		/// SecureStreamSocket::getALPNProtocol().
+		///
+		/// Requires OpenSSL 1.0.2 or newer, otherwise throws a
+		/// Poco::NotImplementedException.
+
+	const std::vector<std::string>& getALPNProtocols() const;
+		/// Returns the application protocols for ALPN.
 				
 	void enableExtendedCertificateVerification(bool flag = true);
 		/// Enable or disable the automatic post-connection
@@ -356,10 +458,30 @@ private:
 	void createSSLContext();
 		/// Create a SSL_CTX object according to Context configuration.
 
+	void purgeClientSessions();
+		/// Removes expired sessions from the client session cache,
+		/// as well as the oldest one if the cache is still full.
+
+	static bool isResumable(SSL_SESSION* pSession);
+		/// Returns true iff the given session can be resumed.
+
+	static int onNewClientSession(SSL* pSSL, SSL_SESSION* pSession);
+		/// Adds a new client session to the client session cache
+		/// of the Context the SSL object belongs to.
+
+	static int onALPNSelect(SSL* pSSL, const unsigned char** pOut, unsigned char* pOutLen, const unsigned char* pIn, unsigned int inLen, void* pArg);
+		/// Selects the application protocol on the server side.
+
+	typedef std::map<std::string, Session::Ptr> ClientSessionMap;
+
 	Usage _usage;
 	VerificationMode _mode;
 	SSL_CTX* _pSSLContext;
 	bool _extendedCertificateVerification;
+	ClientSessionMap _clientSessions;
+	mutable Poco::FastMutex _clientSessionMutex;
+	std::vector<std::string> _alpnProtocols;
+	std::string _alpnWire;
 };
 
 
@@ -372,12 +494,19 @@ inline Context::Usage Context::usage() const
 }
 
 
+inline const std::vector<std::string>& Context::getALPNProtocols() const
+{
+	return _alpnProtocols;
+}
+
+
 inline bool Context::isForServerUse() const
 {
 	return _usage == SERVER_USE
 		|| _usage == TLSV1_SERVER_USE
 		|| _usage == TLSV1_1_SERVER_USE
-		|| _usage == TLSV1_2_SERVER_USE;
+		|| _usage == TLSV1_2_SERVER_USE
+		|| _usage == TLSV1_3_SERVER_USE;
 }
 
 
@@ -67,7 +67,9 @@ class NetSSL_API HTTPSClientSession: public HTTPClientSession
 	/// If session caching has been enabled for the Context object passed
 	/// to the HTTPSClientSession, the HTTPSClientSession class will
 	/// attempt to reuse a previously obtained Session object in
-	/// case of a reconnect.
+	/// case of a reconnect. Furthermore, new HTTPSClientSession objects
+	/// using the same Context resume the sessions cached by the Context
+	/// for the same host and port (see Context::enableSessionCache()).
 {
 public:
 	enum
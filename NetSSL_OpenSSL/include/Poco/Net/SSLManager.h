@@ -87,13 +87,17 @@ class NetSSL_API SSLManager
 	///            </invalidCertificateHandler>
 	///            <cacheSessions>true|false</cacheSessions>
 	///            <sessionIdContext>someString</sessionIdContext> <!-- server only -->
-	///            <sessionCacheSize>0..n</sessionCacheSize>       <!-- server only -->
+	///            <sessionCacheSize>0..n</sessionCacheSize>
 	///            <sessionTimeout>0..n</sessionTimeout>           <!-- server only -->
+	///            <sessionTickets>0..n</sessionTickets>           <!-- server only -->
+	///            <kernelTLS>true|false</kernelTLS>
+	///            <alpnProtocols>h2,http/1.1</alpnProtocols>
 	///            <extendedVerification>true|false</extendedVerification>
 	///            <requireTLSv1>true|false</requireTLSv1>
 	///            <requireTLSv1_1>true|false</requireTLSv1_1>
 	///            <requireTLSv1_2>true|false</requireTLSv1_2>
-	///            <disableProtocols>sslv2,sslv3,tlsv1,tlsv1_1,tlsv1_2</disableProtocols>
+	///            <requireTLSv1_3>true|false</requireTLSv1_3>
+	///            <disableProtocols>sslv2,sslv3,tlsv1,tlsv1_1,tlsv1_2,tlsv1_3</disableProtocols>
 	///            <dhParamsFile>dh.pem</dhParamsFile>
 	///            <ecdhCurve>prime256v1</ecdhCurve>
 	///          </server|client>
@@ -133,18 +137,25 @@ class NetSSL_API SSLManager
 	///      for a server to enable session caching. Should be specified even if session caching
 	///      is disabled to avoid problems with clients that request session caching (e.g. Firefox 3.6).
 	///      If not specified, defaults to ${application.name}.
-	///    - sessionCacheSize (integer): Sets the maximum size of the server session cache, in number of
+	///    - sessionCacheSize (integer): Sets the maximum size of the session cache, in number of
 	///      sessions. The default size (according to OpenSSL documentation) is 1024*20, which may be too
 	///      large for many applications, especially on embedded platforms with limited memory.
 	///      Specifying a size of 0 will set an unlimited cache size.
 	///    - sessionTimeout (integer):  Sets the timeout (in seconds) of cached sessions on the server.
+	///    - sessionTickets (integer): Sets the number of TLSv1.3 session tickets sent by the server
+	///      after a full handshake (requires OpenSSL 1.1.1 or newer).
+	///    - kernelTLS (boolean): Enables or disables kernel TLS offload, if supported by OpenSSL
+	///      and the operating system.
+	///    - alpnProtocols (string): A comma-separated list of application protocols for
+	///      ALPN, in order of preference (e.g., "h2,http/1.1"). See Context::setALPNProtocols().
 	///    - extendedVerification (boolean): Enable or disable the automatic post-connection
 	///      extended certificate verification.
 	///    - requireTLSv1 (boolean): Require a TLSv1 connection.
 	///    - requireTLSv1_1 (boolean): Require a TLSv1.1 connection.
 	///    - requireTLSv1_2 (boolean): Require a TLSv1.2 connection.
+	///    - requireTLSv1_3 (boolean): Require a TLSv1.3 connection.
 	///    - disableProtocols (string): A comma-separated list of protocols that should be
-	///      disabled. Valid protocol names are sslv2, sslv3, tlsv1, tlsv1_1, tlsv1_2.
+	///      disabled. Valid protocol names are sslv2, sslv3, tlsv1, tlsv1_1, tlsv1_2, tlsv1_3.
 	///    - dhParamsFile (string): Specifies a file containing Diffie-Hellman parameters.
 	///      If not specified or empty, the default parameters are used.
 	///    - ecdhCurve (string): Specifies the name of the curve to use for ECDH, based
@@ -329,10 +340,14 @@ private:
 	static const std::string CFG_SESSION_ID_CONTEXT;
 	static const std::string CFG_SESSION_CACHE_SIZE;
 	static const std::string CFG_SESSION_TIMEOUT;
+	static const std::string CFG_SESSION_TICKETS;
+	static const std::string CFG_KERNEL_TLS;
+	static const std::string CFG_ALPN_PROTOCOLS;
 	static const std::string CFG_EXTENDED_VERIFICATION;
 	static const std::string CFG_REQUIRE_TLSV1;
 	static const std::string CFG_REQUIRE_TLSV1_1;
 	static const std::string CFG_REQUIRE_TLSV1_2;
+	static const std::string CFG_REQUIRE_TLSV1_3;
 	static const std::string CFG_DISABLE_PROTOCOLS;
 	static const std::string CFG_DH_PARAMS_FILE;
 	static const std::string CFG_ECDH_CURVE;
@@ -179,6 +179,29 @@ public:
 	bool sessionWasReused();
 		/// Returns true iff a reused session was negotiated during
 		/// the handshake.
+
+	bool kernelTLSSend() const;
+		/// Returns true iff the handshake has been completed and
+		/// the encryption of sent data has been offloaded to the
+		/// kernel (kTLS). See Context::enableKernelTLS().
+
+	std::string getALPNProtocol();
+		/// Returns the application protocol negotiated with ALPN
+		/// (see Context::setALPNProtocols()), or an empty string
+		/// if no protocol has been negotiated.
+		///
+		/// Completes the handshake, if it has not been done yet.
+
+	std::streamsize sendFile(FileInputStream& fileInputStream, std::streamoff offset, std::streamsize count);
+		/// Sends the contents of the given file through the socket,
+		/// using SSL_sendfile(), which lets the kernel read and
+		/// encrypt the file data without copying it to user space.
+		///
+		/// Returns the number of bytes sent, which may be less than
+		/// count if the socket is non-blocking. Returns -1 if the
+		/// file cannot be sent this way, because kTLS is not used for
+		/// sending or the file is not a regular file. The caller must
+		/// then send the file with sendBytes().
 		
 protected:
 	void acceptSSL();
@@ -195,6 +218,11 @@ protected:
 		/// Returns true iff the given host name is the local host
 		/// (either "localhost" or "127.0.0.1").
 
+	std::string sessionPeer(const SocketAddress& address) const;
+		/// Returns the key ("host:port") of the client session
+		/// cache for the given peer address, using the peer host
+		/// name, if set, instead of the IP address.
+
 	bool mustRetry(int rc);
 		/// Returns true if the last operation should be retried,
 		/// otherwise false.
@@ -230,6 +258,7 @@ private:
 	Context::Ptr _pContext;
 	bool _needHandshake;
 	std::string _peerHostName;
+	std::string _sessionPeer;
 	Session::Ptr _pSession;
 	
 	friend class SecureStreamSocketImpl;
@@ -254,6 +254,13 @@ public:
 	bool sessionWasReused();
 		/// Returns true iff a reused session was negotiated during
 		/// the handshake.
+
+	bool kernelTLSSend() const;
+		/// Returns true iff the encryption of sent data has been
+		/// offloaded to the kernel (kTLS), in which case sendFile()
+		/// sends files without copying them to user space.
+		///
+		/// See Context::enableKernelTLS().
 		
 	void abort();
 		/// Aborts the SSL connection by closing the underlying
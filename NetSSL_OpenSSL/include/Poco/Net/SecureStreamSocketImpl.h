@@ -104,6 +104,36 @@ public:
 		/// in buffer. Up to length bytes are received.
 		///
 		/// Returns the number of bytes received.
+
+	int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket. Since the data must be encrypted, the
+		/// buffers are copied into a single buffer, which is
+		/// sent with sendBytes(). Any specified flags are ignored.
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+
+	int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives data from the socket and stores it
+		/// in the given buffers, filling one after the other.
+		///
+		/// Returns the number of bytes received.
+
+	std::streamsize sendFile(FileInputStream& fileInputStream, std::streamoff offset = 0, std::streamsize count = 0);
+		/// Sends the contents of the given file through the socket.
+		///
+		/// If the encryption of sent data has been offloaded to the
+		/// kernel (see Context::enableKernelTLS()), a regular file
+		/// is encrypted and sent by the kernel, without being copied
+		/// to user space. Otherwise, since the data must be encrypted,
+		/// the file is read and sent with sendBytes().
+
+	std::string getALPNProtocol();
+		/// Returns the application protocol negotiated with ALPN,
+		/// or an empty string if no protocol has been negotiated.
+		///
+		/// Completes the handshake, if it has not been done yet.
 	
 	int sendTo(const void* buffer, int length, const SocketAddress& address, int flags = 0);
 		/// Not supported by a SecureStreamSocket.
@@ -213,6 +243,10 @@ public:
 	bool sessionWasReused();
 		/// Returns true iff a reused session was negotiated during
 		/// the handshake.
+
+	bool kernelTLSSend() const;
+		/// Returns true iff the encryption of sent data has
+		/// been offloaded to the kernel (kTLS).
 		
 protected:
 	void acceptSSL();
@@ -281,6 +315,18 @@ inline bool SecureStreamSocketImpl::sessionWasReused()
 }
 
 
+inline bool SecureStreamSocketImpl::kernelTLSSend() const
+{
+	return _impl.kernelTLSSend();
+}
+
+
+inline std::string SecureStreamSocketImpl::getALPNProtocol()
+{
+	return _impl.getALPNProtocol();
+}
+
+
 inline int SecureStreamSocketImpl::lastError()
 {
 	return SocketImpl::lastError();
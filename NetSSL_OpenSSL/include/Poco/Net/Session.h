@@ -61,6 +61,7 @@ private:
 	SSL_SESSION* _pSession;
 	
 	friend class SecureSocketImpl;
+	friend class Context;
 };
 
 
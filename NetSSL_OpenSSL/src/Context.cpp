@@ -241,11 +241,25 @@ void Context::enableSessionCache(bool flag)
 {
 	if (flag)
 	{
-		SSL_CTX_set_session_cache_mode(_pSSLContext, isForServerUse() ? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_CLIENT);
+		if (isForServerUse())
+		{
+			SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_SERVER);
+		}
+		else
+		{
+			// Client sessions are kept in our own cache, keyed by peer,
+			// as OpenSSL's internal cache cannot be searched by peer.
+			SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+			SSL_CTX_sess_set_new_cb(_pSSLContext, &Context::onNewClientSession);
+		}
 	}
 	else
 	{
 		SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_OFF);
+		SSL_CTX_sess_set_new_cb(_pSSLContext, 0);
+
+		Poco::FastMutex::ScopedLock lock(_clientSessionMutex);
+		_clientSessions.clear();
 	}
 }
 
@@ -278,16 +292,15 @@ bool Context::sessionCacheEnabled() const
 
 void Context::setSessionCacheSize(std::size_t size)
 {
-	poco_assert (isForServerUse());
-	
 	SSL_CTX_sess_set_cache_size(_pSSLContext, static_cast<long>(size));
+
+	Poco::FastMutex::ScopedLock lock(_clientSessionMutex);
+	while (size > 0 && _clientSessions.size() > size) purgeClientSessions();
 }
 
 	
 std::size_t Context::getSessionCacheSize() const
 {
-	poco_assert (isForServerUse());
-	
 	return static_cast<std::size_t>(SSL_CTX_sess_get_cache_size(_pSSLContext));
 }
 
@@ -309,11 +322,144 @@ long Context::getSessionTimeout() const
 
 
 void Context::flushSessionCache()
+{
+	if (isForServerUse())
+	{
+		Poco::Timestamp now;
+		SSL_CTX_flush_sessions(_pSSLContext, static_cast<long>(now.epochTime()));
+	}
+	else
+	{
+		Poco::FastMutex::ScopedLock lock(_clientSessionMutex);
+		_clientSessions.clear();
+	}
+}
+
+
+Session::Ptr Context::findClientSession(const std::string& peer)
+{
+	Poco::FastMutex::ScopedLock lock(_clientSessionMutex);
+
+	ClientSessionMap::iterator it = _clientSessions.find(peer);
+	if (it == _clientSessions.end()) return 0;
+
+	Session::Ptr pSession = it->second;
+	bool resumable = isResumable(pSession->sslSession());
+#if defined(TLS1_3_VERSION)
+	if (!resumable || SSL_SESSION_get_protocol_version(pSession->sslSession()) == TLS1_3_VERSION)
+#else
+	if (!resumable)
+#endif
+	{
+		_clientSessions.erase(it);
+	}
+	return resumable ? pSession : Session::Ptr();
+}
+
+
+void Context::addClientSession(const std::string& peer, Session::Ptr pSession)
+{
+	poco_check_ptr (pSession);
+
+	Poco::FastMutex::ScopedLock lock(_clientSessionMutex);
+
+	std::size_t maxSize = static_cast<std::size_t>(SSL_CTX_sess_get_cache_size(_pSSLContext));
+	if (maxSize > 0 && _clientSessions.size() >= maxSize && _clientSessions.find(peer) == _clientSessions.end())
+	{
+		purgeClientSessions();
+	}
+	_clientSessions[peer] = pSession;
+}
+
+
+void Context::removeClientSession(const std::string& peer)
+{
+	Poco::FastMutex::ScopedLock lock(_clientSessionMutex);
+
+	_clientSessions.erase(peer);
+}
+
+
+std::size_t Context::clientSessionCount() const
+{
+	Poco::FastMutex::ScopedLock lock(_clientSessionMutex);
+
+	return _clientSessions.size();
+}
+
+
+void Context::setSessionTicketCount(std::size_t count)
 {
 	poco_assert (isForServerUse());
 
-	Poco::Timestamp now;
-	SSL_CTX_flush_sessions(_pSSLContext, static_cast<long>(now.epochTime()));
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	if (SSL_CTX_set_num_tickets(_pSSLContext, count) != 1)
+		throw SSLContextException("Cannot set number of session tickets");
+#else
+	throw Poco::NotImplementedException("TLSv1.3 session tickets require OpenSSL 1.1.1 or newer");
+#endif
+}
+
+
+std::size_t Context::getSessionTicketCount() const
+{
+	poco_assert (isForServerUse());
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	return SSL_CTX_get_num_tickets(_pSSLContext);
+#else
+	return 0;
+#endif
+}
+
+
+void Context::enableKernelTLS(bool flag)
+{
+#if defined(SSL_OP_ENABLE_KTLS)
+	if (flag)
+		SSL_CTX_set_options(_pSSLContext, SSL_OP_ENABLE_KTLS);
+	else
+		SSL_CTX_clear_options(_pSSLContext, SSL_OP_ENABLE_KTLS);
+#endif
+}
+
+
+bool Context::kernelTLSEnabled() const
+{
+#if defined(SSL_OP_ENABLE_KTLS)
+	return (SSL_CTX_get_options(_pSSLContext) & SSL_OP_ENABLE_KTLS) != 0;
+#else
+	return false;
+#endif
+}
+
+
+void Context::setALPNProtocols(const std::vector<std::string>& protocols)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+	std::string wire;
+	for (std::vector<std::string>::const_iterator it = protocols.begin(); it != protocols.end(); ++it)
+	{
+		if (it->empty() || it->size() > 255)
+			throw Poco::InvalidArgumentException("Invalid ALPN protocol name", *it);
+		wire += static_cast<char>(it->size());
+		wire += *it;
+	}
+	if (isForServerUse())
+	{
+		SSL_CTX_set_alpn_select_cb(_pSSLContext, wire.empty() ? 0 : &Context::onALPNSelect, this);
+	}
+	else
+	{
+		// note: unlike most OpenSSL functions, this one returns 0 on success
+		if (SSL_CTX_set_alpn_protos(_pSSLContext, reinterpret_cast<const unsigned char*>(wire.data()), static_cast<unsigned>(wire.size())) != 0)
+			throw SSLContextException("Cannot set ALPN protocols");
+	}
+	_alpnProtocols = protocols;
+	_alpnWire = wire;
+#else
+	throw Poco::NotImplementedException("ALPN requires OpenSSL 1.0.2 or newer");
+#endif
 }
 
 
@@ -361,6 +507,12 @@ void Context::disableProtocols(int protocols)
 	{
 #if defined(SSL_OP_NO_TLSv1_2)
 		SSL_CTX_set_options(_pSSLContext, SSL_OP_NO_TLSv1_2);
+#endif
+	}
+	if (protocols & PROTO_TLSV1_3)
+	{
+#if defined(SSL_OP_NO_TLSv1_3)
+		SSL_CTX_set_options(_pSSLContext, SSL_OP_NO_TLSv1_3);
 #endif
 	}
 }
@@ -425,6 +577,16 @@ void Context::createSSLContext()
         case TLSV1_2_SERVER_USE:
             _pSSLContext = SSL_CTX_new(TLSv1_2_server_method());
             break;
+#endif
+#if defined(SSL_OP_NO_TLSv1_3) && !defined(OPENSSL_NO_TLS1_3)
+		case TLSV1_3_CLIENT_USE:
+			_pSSLContext = SSL_CTX_new(TLS_client_method());
+			if (_pSSLContext) SSL_CTX_set_min_proto_version(_pSSLContext, TLS1_3_VERSION);
+			break;
+		case TLSV1_3_SERVER_USE:
+			_pSSLContext = SSL_CTX_new(TLS_server_method());
+			if (_pSSLContext) SSL_CTX_set_min_proto_version(_pSSLContext, TLS1_3_VERSION);
+			break;
 #endif
 		default:
 			throw Poco::InvalidArgumentException("Invalid or unsupported usage");
@@ -436,6 +598,7 @@ void Context::createSSLContext()
 		throw SSLException("Cannot create SSL_CTX object", ERR_error_string(err, 0));
 	}
 
+	SSL_CTX_set_app_data(_pSSLContext, this);
 	SSL_CTX_set_default_passwd_cb(_pSSLContext, &SSLManager::privateKeyPassphraseCallback);
 	Utility::clearErrorStack();
 	SSL_CTX_set_options(_pSSLContext, SSL_OP_ALL);
@@ -573,4 +736,77 @@ void Context::initECDH(const std::string& curve)
 }
 
 
+void Context::purgeClientSessions()
+{
+	ClientSessionMap::iterator itOldest = _clientSessions.end();
+	ClientSessionMap::iterator it = _clientSessions.begin();
+	while (it != _clientSessions.end())
+	{
+		if (!isResumable(it->second->sslSession()))
+		{
+			_clientSessions.erase(it++);
+		}
+		else
+		{
+			if (itOldest == _clientSessions.end() || SSL_SESSION_get_time(it->second->sslSession()) < SSL_SESSION_get_time(itOldest->second->sslSession()))
+				itOldest = it;
+			++it;
+		}
+	}
+	std::size_t maxSize = static_cast<std::size_t>(SSL_CTX_sess_get_cache_size(_pSSLContext));
+	if (itOldest != _clientSessions.end() && maxSize > 0 && _clientSessions.size() >= maxSize)
+	{
+		_clientSessions.erase(itOldest);
+	}
+}
+
+
+bool Context::isResumable(SSL_SESSION* pSession)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	if (!SSL_SESSION_is_resumable(pSession)) return false;
+#endif
+	Poco::Timestamp now;
+	return SSL_SESSION_get_time(pSession) + SSL_SESSION_get_timeout(pSession) > static_cast<long>(now.epochTime());
+}
+
+
+int Context::onALPNSelect(SSL* pSSL, const unsigned char** pOut, unsigned char* pOutLen, const unsigned char* pIn, unsigned int inLen, void* pArg)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+	Context* pContext = reinterpret_cast<Context*>(pArg);
+	unsigned char* pSelected = 0;
+	if (SSL_select_next_proto(&pSelected, pOutLen,
+			reinterpret_cast<const unsigned char*>(pContext->_alpnWire.data()), static_cast<unsigned>(pContext->_alpnWire.size()),
+			pIn, inLen) == OPENSSL_NPN_NEGOTIATED)
+	{
+		*pOut = pSelected;
+		return SSL_TLSEXT_ERR_OK;
+	}
+#endif
+	return SSL_TLSEXT_ERR_NOACK;
+}
+
+
+int Context::onNewClientSession(SSL* pSSL, SSL_SESSION* pSession)
+{
+	// The SecureSocketImpl sets the peer ("host:port") as application
+	// data of its SSL object if client session caching is enabled.
+	Context* pContext = reinterpret_cast<Context*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(pSSL)));
+	const std::string* pPeer = reinterpret_cast<const std::string*>(SSL_get_app_data(pSSL));
+	if (!pContext || !pPeer || pPeer->empty() || !isResumable(pSession)) return 0;
+
+	// From here on, the Session owns the reference passed to us.
+	Session::Ptr pClientSession = new Session(pSession);
+	try
+	{
+		pContext->addClientSession(*pPeer, pClientSession);
+	}
+	catch (...)
+	{
+	}
+	return 1;
+}
+
+
 } } // namespace Poco::Net
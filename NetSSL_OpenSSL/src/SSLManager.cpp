@@ -53,10 +53,14 @@ const std::string SSLManager::CFG_CACHE_SESSIONS("cacheSessions");
 const std::string SSLManager::CFG_SESSION_ID_CONTEXT("sessionIdContext");
 const std::string SSLManager::CFG_SESSION_CACHE_SIZE("sessionCacheSize");
 const std::string SSLManager::CFG_SESSION_TIMEOUT("sessionTimeout");
+const std::string SSLManager::CFG_SESSION_TICKETS("sessionTickets");
+const std::string SSLManager::CFG_KERNEL_TLS("kernelTLS");
+const std::string SSLManager::CFG_ALPN_PROTOCOLS("alpnProtocols");
 const std::string SSLManager::CFG_EXTENDED_VERIFICATION("extendedVerification");
 const std::string SSLManager::CFG_REQUIRE_TLSV1("requireTLSv1");
 const std::string SSLManager::CFG_REQUIRE_TLSV1_1("requireTLSv1_1");
 const std::string SSLManager::CFG_REQUIRE_TLSV1_2("requireTLSv1_2");
+const std::string SSLManager::CFG_REQUIRE_TLSV1_3("requireTLSv1_3");
 const std::string SSLManager::CFG_DISABLE_PROTOCOLS("disableProtocols");
 const std::string SSLManager::CFG_DH_PARAMS_FILE("dhParamsFile");
 const std::string SSLManager::CFG_ECDH_CURVE("ecdhCurve");
@@ -278,6 +282,7 @@ void SSLManager::initDefaultContext(bool server)
 	bool requireTLSv1 = config.getBool(prefix + CFG_REQUIRE_TLSV1, false);
 	bool requireTLSv1_1 = config.getBool(prefix + CFG_REQUIRE_TLSV1_1, false);
 	bool requireTLSv1_2 = config.getBool(prefix + CFG_REQUIRE_TLSV1_2, false);
+	bool requireTLSv1_3 = config.getBool(prefix + CFG_REQUIRE_TLSV1_3, false);
 
 	params.dhParamsFile = config.getString(prefix + CFG_DH_PARAMS_FILE, "");
 	params.ecdhCurve    = config.getString(prefix + CFG_ECDH_CURVE, "");
@@ -286,7 +291,9 @@ void SSLManager::initDefaultContext(bool server)
 	
 	if (server)
 	{
-		if (requireTLSv1_2)
+		if (requireTLSv1_3)
+			usage = Context::TLSV1_3_SERVER_USE;
+		else if (requireTLSv1_2)
 			usage = Context::TLSV1_2_SERVER_USE;
 		else if (requireTLSv1_1)
 			usage = Context::TLSV1_1_SERVER_USE;
@@ -298,7 +305,9 @@ void SSLManager::initDefaultContext(bool server)
 	}
 	else
 	{
-		if (requireTLSv1_2)
+		if (requireTLSv1_3)
+			usage = Context::TLSV1_3_CLIENT_USE;
+		else if (requireTLSv1_2)
 			usage = Context::TLSV1_2_CLIENT_USE;
 		else if (requireTLSv1_1)
 			usage = Context::TLSV1_1_CLIENT_USE;
@@ -324,6 +333,8 @@ void SSLManager::initDefaultContext(bool server)
 			disabledProtocols |= Context::PROTO_TLSV1_1;
 		else if (*it == "tlsv1_2")
 			disabledProtocols |= Context::PROTO_TLSV1_2;
+		else if (*it == "tlsv1_3")
+			disabledProtocols |= Context::PROTO_TLSV1_3;
 	}
 	if (server)
 		_ptrDefaultServerContext->disableProtocols(disabledProtocols);
@@ -345,10 +356,35 @@ void SSLManager::initDefaultContext(bool server)
 			int timeout = config.getInt(prefix + CFG_SESSION_TIMEOUT);
 			_ptrDefaultServerContext->setSessionTimeout(timeout);
 		}
+		if (config.hasProperty(prefix + CFG_SESSION_TICKETS))
+		{
+			int tickets = config.getInt(prefix + CFG_SESSION_TICKETS);
+			_ptrDefaultServerContext->setSessionTicketCount(tickets);
+		}
 	}
 	else
 	{
 		_ptrDefaultClientContext->enableSessionCache(cacheSessions);
+		if (config.hasProperty(prefix + CFG_SESSION_CACHE_SIZE))
+		{
+			int cacheSize = config.getInt(prefix + CFG_SESSION_CACHE_SIZE);
+			_ptrDefaultClientContext->setSessionCacheSize(cacheSize);
+		}
+	}
+	bool kernelTLS = config.getBool(prefix + CFG_KERNEL_TLS, false);
+	if (server)
+		_ptrDefaultServerContext->enableKernelTLS(kernelTLS);
+	else
+		_ptrDefaultClientContext->enableKernelTLS(kernelTLS);
+	std::string alpnProtocolsList = config.getString(prefix + CFG_ALPN_PROTOCOLS, "");
+	if (!alpnProtocolsList.empty())
+	{
+		Poco::StringTokenizer alpnTok(alpnProtocolsList, ";,", Poco::StringTokenizer::TOK_TRIM | Poco::StringTokenizer::TOK_IGNORE_EMPTY);
+		std::vector<std::string> alpnProtocols(alpnTok.begin(), alpnTok.end());
+		if (server)
+			_ptrDefaultServerContext->setALPNProtocols(alpnProtocols);
+		else
+			_ptrDefaultClientContext->setALPNProtocols(alpnProtocols);
 	}
 	bool extendedVerification = config.getBool(prefix + CFG_EXTENDED_VERIFICATION, false);
 	if (server)
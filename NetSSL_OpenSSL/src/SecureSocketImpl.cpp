@@ -26,8 +26,14 @@
 #include "Poco/NumberFormatter.h"
 #include "Poco/NumberParser.h"
 #include "Poco/Format.h"
+#include "Poco/FileStream.h"
 #include <openssl/x509v3.h>
 #include <openssl/err.h>
+#include <algorithm>
+#if defined(SSL_OP_ENABLE_KTLS) && defined(POCO_OS_FAMILY_UNIX)
+#include <sys/stat.h>
+#define POCO_NETSSL_HAVE_KTLS 1
+#endif
 
 
 using Poco::IOException;
@@ -108,6 +114,7 @@ void SecureSocketImpl::connect(const SocketAddress& address, bool performHandsha
 	poco_assert (!_pSSL);
 
 	_pSocket->connect(address);
+	_sessionPeer = sessionPeer(address);
 	connectSSL(performHandshake);
 }
 
@@ -119,6 +126,7 @@ void SecureSocketImpl::connect(const SocketAddress& address, const Poco::Timespa
 	poco_assert (!_pSSL);
 
 	_pSocket->connect(address, timeout);
+	_sessionPeer = sessionPeer(address);
 	Poco::Timespan receiveTimeout = _pSocket->getReceiveTimeout();
 	Poco::Timespan sendTimeout = _pSocket->getSendTimeout();
 	_pSocket->setReceiveTimeout(timeout);
@@ -136,6 +144,7 @@ void SecureSocketImpl::connectNB(const SocketAddress& address)
 	poco_assert (!_pSSL);
 
 	_pSocket->connectNB(address);
+	_sessionPeer = sessionPeer(address);
 	connectSSL(false);
 }
 
@@ -164,9 +173,35 @@ void SecureSocketImpl::connectSSL(bool performHandshake)
 	}
 #endif
 
-	if (_pSession)
+	Session::Ptr pSession = _pSession;
+	if (_pContext->sessionCacheEnabled())
 	{
-		SSL_set_session(_pSSL, _pSession->sslSession());
+		// The Context's new session callback uses the peer
+		// to add new sessions to the client session cache.
+		if (_sessionPeer.empty())
+		{
+			try
+			{
+				_sessionPeer = sessionPeer(_pSocket->peerAddress());
+			}
+			catch (Poco::Exception&)
+			{
+			}
+		}
+		SSL_set_app_data(_pSSL, &_sessionPeer);
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+		if (!_sessionPeer.empty() && (!pSession || !SSL_SESSION_is_resumable(pSession->sslSession())))
+#else
+		if (!_sessionPeer.empty() && !pSession)
+#endif
+		{
+			Session::Ptr pCachedSession = _pContext->findClientSession(_sessionPeer);
+			if (pCachedSession) pSession = pCachedSession;
+		}
+	}
+	if (pSession)
+	{
+		SSL_set_session(_pSSL, pSession->sslSession());
 	}
 
 	try
@@ -406,6 +441,15 @@ X509* SecureSocketImpl::peerCertificate() const
 }
 
 
+std::string SecureSocketImpl::sessionPeer(const SocketAddress& address) const
+{
+	std::string peer(_peerHostName.empty() ? address.host().toString() : _peerHostName);
+	peer += ':';
+	NumberFormatter::append(peer, address.port());
+	return peer;
+}
+
+
 bool SecureSocketImpl::mustRetry(int rc)
 {
 	if (rc <= 0)
@@ -519,6 +563,7 @@ void SecureSocketImpl::reset()
 		SSL_free(_pSSL);
 		_pSSL = 0;
 	}
+	_sessionPeer.clear();
 }
 
 
@@ -562,4 +607,68 @@ bool SecureSocketImpl::sessionWasReused()
 }
 
 
+bool SecureSocketImpl::kernelTLSSend() const
+{
+#if defined(POCO_NETSSL_HAVE_KTLS)
+	return _pSSL && !_needHandshake && BIO_get_ktls_send(SSL_get_wbio(_pSSL));
+#else
+	return false;
+#endif
+}
+
+
+std::string SecureSocketImpl::getALPNProtocol()
+{
+	std::string protocol;
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+	if (!_pSSL) return protocol;
+	if (_needHandshake) completeHandshake();
+
+	const unsigned char* pData = 0;
+	unsigned length = 0;
+	SSL_get0_alpn_selected(_pSSL, &pData, &length);
+	if (pData) protocol.assign(reinterpret_cast<const char*>(pData), length);
+#endif
+	return protocol;
+}
+
+
+std::streamsize SecureSocketImpl::sendFile(FileInputStream& fileInputStream, std::streamoff offset, std::streamsize count)
+{
+#if defined(POCO_NETSSL_HAVE_KTLS)
+	if (!kernelTLSSend()) return -1;
+
+	int fd = fileInputStream.nativeHandle();
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) return -1;
+	if (offset >= st.st_size) return 0;
+	if (count == 0 || count > st.st_size - offset) count = st.st_size - offset;
+
+	// SSL_sendfile() returns an int-sized result
+	const std::streamsize maxChunk = 0x7ffff000;
+	std::streamsize sent = 0;
+	while (sent < count)
+	{
+		std::size_t n = static_cast<std::size_t>(std::min(count - sent, maxChunk));
+		int rc;
+		do
+		{
+			rc = static_cast<int>(SSL_sendfile(_pSSL, fd, static_cast<off_t>(offset + sent), n, 0));
+		}
+		while (mustRetry(rc));
+		if (rc <= 0)
+		{
+			rc = handleError(rc);
+			if (rc == 0) throw SSLConnectionUnexpectedlyClosedException();
+			break; // non-blocking socket would block
+		}
+		sent += rc;
+	}
+	return sent;
+#else
+	return -1;
+#endif
+}
+
+
 } } // namespace Poco::Net
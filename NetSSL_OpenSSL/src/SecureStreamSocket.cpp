@@ -278,6 +278,12 @@ bool SecureStreamSocket::sessionWasReused()
 }
 
 
+bool SecureStreamSocket::kernelTLSSend() const
+{
+	return static_cast<SecureStreamSocketImpl*>(impl())->kernelTLSSend();
+}
+
+
 void SecureStreamSocket::abort()
 {
 	static_cast<SecureStreamSocketImpl*>(impl())->abort();
@@ -128,6 +128,26 @@ int SecureStreamSocketImpl::receiveBytes(void* buffer, int length, int flags)
 }
 
 
+int SecureStreamSocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	return sendBytesCopy(buffers, flags);
+}
+
+
+int SecureStreamSocketImpl::receiveBytes(SocketBufVec& buffers, int flags)
+{
+	return receiveBytesCopy(buffers, flags);
+}
+
+
+std::streamsize SecureStreamSocketImpl::sendFile(FileInputStream& fileInputStream, std::streamoff offset, std::streamsize count)
+{
+	std::streamsize sent = _impl.sendFile(fileInputStream, offset, count);
+	if (sent < 0) sent = sendFileCopy(fileInputStream, offset, count);
+	return sent;
+}
+
+
 int SecureStreamSocketImpl::sendTo(const void* /*buffer*/, int /*length*/, const SocketAddress& /*address*/, int /*flags*/)
 {
 	throw Poco::InvalidAccessException("Cannot sendTo() on a SecureStreamSocketImpl");
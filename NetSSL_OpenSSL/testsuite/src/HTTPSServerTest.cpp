@@ -20,8 +20,15 @@
 #include "Poco/Net/HTTPServerRequest.h"
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/HTTP2ClientSession.h"
 #include "Poco/Net/SecureServerSocket.h"
+#include "Poco/Net/SecureStreamSocket.h"
+#include "Poco/Net/Context.h"
+#include "Poco/Util/Application.h"
+#include "Poco/Util/AbstractConfiguration.h"
 #include "Poco/StreamCopier.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
 #include <sstream>
 
 
@@ -35,8 +42,15 @@ using Poco::Net::HTTPServerRequest;
 using Poco::Net::HTTPResponse;
 using Poco::Net::HTTPServerResponse;
 using Poco::Net::HTTPMessage;
+using Poco::Net::HTTP2ClientSession;
 using Poco::Net::SecureServerSocket;
+using Poco::Net::SecureStreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::Net::Context;
+using Poco::Util::Application;
 using Poco::StreamCopier;
+using Poco::TemporaryFile;
+using Poco::FileOutputStream;
 
 
 namespace
@@ -93,6 +107,40 @@ namespace
 		}
 	};
 	
+	class FileRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		FileRequestHandler(const std::string& path):
+			_path(path)
+		{
+		}
+
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			response.sendFile(_path, "application/octet-stream");
+		}
+
+	private:
+		std::string _path;
+	};
+
+	class FileRequestHandlerFactory: public HTTPRequestHandlerFactory
+	{
+	public:
+		FileRequestHandlerFactory(const std::string& path):
+			_path(path)
+		{
+		}
+
+		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+		{
+			return new FileRequestHandler(_path);
+		}
+
+	private:
+		std::string _path;
+	};
+
 	class RequestHandlerFactory: public HTTPRequestHandlerFactory
 	{
 	public:
@@ -322,6 +370,120 @@ void HTTPSServerTest::testNotImpl()
 }
 
 
+void HTTPSServerTest::testSendFile()
+{
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE,
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pServerContext->enableKernelTLS(true);
+
+	TemporaryFile file;
+	std::string data;
+	for (int i = 0; i < 100000; i++) data += static_cast<char>('a' + i % 26);
+	{
+		FileOutputStream ostr(file.path());
+		ostr << data;
+	}
+
+	SecureServerSocket svs(0, 64, pServerContext);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new FileRequestHandlerFactory(file.path()), svs, pParams);
+	srv.start();
+
+	// the file is encrypted by the kernel if kTLS is available,
+	// otherwise it's copied; the result must be the same
+	HTTPSClientSession cs("127.0.0.1", svs.address().port());
+	HTTPRequest request("GET", "/file");
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::ostringstream ostr;
+	StreamCopier::copyStream(cs.receiveResponse(response), ostr);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (response.getContentLength() == data.size());
+	assertTrue (ostr.str() == data);
+
+	HTTPRequest rangeRequest("GET", "/file");
+	rangeRequest.set("Range", "bytes=1000-60999");
+	cs.sendRequest(rangeRequest);
+	HTTPResponse rangeResponse;
+	std::ostringstream rangeStr;
+	StreamCopier::copyStream(cs.receiveResponse(rangeResponse), rangeStr);
+	assertTrue (rangeResponse.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+	assertTrue (rangeStr.str() == data.substr(1000, 60000));
+}
+
+
+void HTTPSServerTest::testHTTP2()
+{
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE,
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	std::vector<std::string> serverProtocols;
+	serverProtocols.push_back("h2");
+	serverProtocols.push_back("http/1.1");
+	pServerContext->setALPNProtocols(serverProtocols);
+
+	SecureServerSocket svs(0, 64, pServerContext);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setHTTP2Enabled(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	Context::Ptr pClientContext = new Context(
+		Context::CLIENT_USE,
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.caConfig"),
+		Context::VERIFY_RELAXED,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	std::vector<std::string> clientProtocols;
+	clientProtocols.push_back("h2");
+	pClientContext->setALPNProtocols(clientProtocols);
+
+	SecureStreamSocket socket(SocketAddress("127.0.0.1", svs.address().port()), pClientContext);
+	assertTrue (socket.getALPNProtocol() == "h2");
+
+	HTTP2ClientSession cs(socket);
+	std::string body(100000, 'x');
+	HTTPRequest request("POST", "/echoBody");
+	request.setContentType("text/plain");
+	Poco::UInt32 id = cs.sendRequest(request, body);
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(id, response, rbody);
+	assertTrue (response.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (response.getVersion() == HTTPMessage::HTTP_2_0);
+	assertTrue (response.getContentType() == "text/plain");
+	assertTrue (rbody == body);
+
+	// a client without ALPN uses HTTP/1.1
+	HTTPSClientSession cs1("127.0.0.1", svs.address().port());
+	HTTPRequest request1("POST", "/echoBody");
+	request1.setContentLength((int) body.length());
+	cs1.sendRequest(request1) << body;
+	HTTPResponse response1;
+	std::string rbody1;
+	cs1.receiveResponse(response1) >> rbody1;
+	assertTrue (response1.getStatus() == HTTPResponse::HTTP_OK);
+	assertTrue (rbody1 == body);
+}
+
+
 void HTTPSServerTest::setUp()
 {
 }
@@ -344,6 +506,8 @@ CppUnit::Test* HTTPSServerTest::suite()
 	CppUnit_addTest(pSuite, HTTPSServerTest, testRedirect);
 	CppUnit_addTest(pSuite, HTTPSServerTest, testAuth);
 	CppUnit_addTest(pSuite, HTTPSServerTest, testNotImpl);
+	CppUnit_addTest(pSuite, HTTPSServerTest, testSendFile);
+	CppUnit_addTest(pSuite, HTTPSServerTest, testHTTP2);
 
 	return pSuite;
 }
@@ -32,6 +32,8 @@ public:
 	void testRedirect();
 	void testAuth();
 	void testNotImpl();
+	void testSendFile();
+	void testHTTP2();
 
 	void setUp();
 	void tearDown();
@@ -23,6 +23,7 @@
 #include "Poco/Util/Application.h"
 #include "Poco/Util/AbstractConfiguration.h"
 #include "Poco/Thread.h"
+#include "Poco/NumberFormatter.h"
 #include <iostream>
 
 
@@ -381,6 +382,128 @@ void TCPServerTest::testReuseSession()
 }
 
 
+void TCPServerTest::testSessionCache()
+{
+	// ensure OpenSSL machinery is fully setup
+	Context::Ptr pDefaultServerContext = SSLManager::instance().defaultServerContext();
+	Context::Ptr pDefaultClientContext = SSLManager::instance().defaultClientContext();
+
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE,
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+
+	SecureServerSocket svs(0, 64, pServerContext);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	Context::Ptr pClientContext = new Context(
+		Context::CLIENT_USE,
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.caConfig"),
+		Context::VERIFY_RELAXED,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pClientContext->enableSessionCache(true);
+	assertTrue (pClientContext->clientSessionCount() == 0);
+
+	// sessions (or session tickets) are cached by the Context
+	// and resumed without calling useSession()
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	std::string data("hello, world");
+	char buffer[256];
+	SecureStreamSocket ss1(sa, pClientContext);
+	assertTrue (!ss1.sessionWasReused());
+	ss1.sendBytes(data.data(), (int) data.size());
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (std::string(buffer, n) == data);
+	ss1.close();
+	assertTrue (pClientContext->clientSessionCount() == 1);
+	std::string peer("127.0.0.1:" + Poco::NumberFormatter::format(sa.port()));
+
+	SecureStreamSocket ss2(sa, pClientContext);
+	assertTrue (ss2.sessionWasReused());
+	ss2.sendBytes(data.data(), (int) data.size());
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (std::string(buffer, n) == data);
+	ss2.close();
+	assertTrue (pClientContext->clientSessionCount() == 1);
+
+	pClientContext->removeClientSession(peer);
+	assertTrue (pClientContext->clientSessionCount() == 0);
+
+	SecureStreamSocket ss3(sa, pClientContext);
+	assertTrue (!ss3.sessionWasReused());
+	ss3.sendBytes(data.data(), (int) data.size());
+	n = ss3.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (std::string(buffer, n) == data);
+	ss3.close();
+	assertTrue (pClientContext->clientSessionCount() == 1);
+
+	pClientContext->flushSessionCache();
+	assertTrue (pClientContext->clientSessionCount() == 0);
+}
+
+
+void TCPServerTest::testSessionTickets()
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	// ensure OpenSSL machinery is fully setup
+	Context::Ptr pDefaultServerContext = SSLManager::instance().defaultServerContext();
+	Context::Ptr pDefaultClientContext = SSLManager::instance().defaultClientContext();
+
+	Context::Ptr pServerContext = new Context(
+		Context::TLSV1_3_SERVER_USE,
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pServerContext->setSessionTicketCount(0);
+	assertTrue (pServerContext->getSessionTicketCount() == 0);
+
+	SecureServerSocket svs(0, 64, pServerContext);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	Context::Ptr pClientContext = new Context(
+		Context::CLIENT_USE,
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.caConfig"),
+		Context::VERIFY_RELAXED,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pClientContext->enableSessionCache(true);
+
+	// without session tickets, TLSv1.3 sessions cannot be resumed
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	std::string data("hello, world");
+	char buffer[256];
+	SecureStreamSocket ss1(sa, pClientContext);
+	ss1.sendBytes(data.data(), (int) data.size());
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assertTrue (std::string(buffer, n) == data);
+	ss1.close();
+	assertTrue (pClientContext->clientSessionCount() == 0);
+
+	SecureStreamSocket ss2(sa, pClientContext);
+	assertTrue (!ss2.sessionWasReused());
+	ss2.close();
+#endif
+}
+
+
 void TCPServerTest::setUp()
 {
 }
@@ -400,6 +523,8 @@ CppUnit::Test* TCPServerTest::suite()
 	CppUnit_addTest(pSuite, TCPServerTest, testMultiConnections);
 	CppUnit_addTest(pSuite, TCPServerTest, testReuseSocket);
 	CppUnit_addTest(pSuite, TCPServerTest, testReuseSession);
+	CppUnit_addTest(pSuite, TCPServerTest, testSessionCache);
+	CppUnit_addTest(pSuite, TCPServerTest, testSessionTickets);
 
 	return pSuite;
 }
@@ -29,6 +29,8 @@ public:
 	void testMultiConnections();
 	void testReuseSocket();
 	void testReuseSession();
+	void testSessionCache();
+	void testSessionTickets();
 
 	void setUp();
 	void tearDown();
@@ -87,6 +87,28 @@ public:
 		/// in buffer. Up to length bytes are received.
 		///
 		/// Returns the number of bytes received.
+
+	int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket. Since the data must be encrypted, the
+		/// buffers are copied into a single buffer, which is
+		/// sent with sendBytes(). Any specified flags are ignored.
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+
+	int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives data from the socket and stores it
+		/// in the given buffers, filling one after the other.
+		///
+		/// Returns the number of bytes received.
+
+	std::streamsize sendFile(FileInputStream& fileInputStream, std::streamoff offset = 0, std::streamsize count = 0);
+		/// Sends the contents of the given file through the socket.
+		///
+		/// Since the data must be encrypted, the file is always
+		/// read and sent with sendBytes(), never transferred
+		/// by the kernel.
 	
 	int sendTo(const void* buffer, int length, const SocketAddress& address, int flags = 0);
 		/// Not supported by a SecureStreamSocket.